@@ -0,0 +1,640 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/libdhcp++.h>
+#include <dhcp/option4_addrlst.h>
+#include <dhcp/pkt4.h>
+#include <dhcp4/dhcp4_srv.h>
+#include <dhcp4/json_config_parser.h>
+#include <dhcp4/parser_context.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/option_block_cache.h>
+#include <exceptions/exceptions.h>
+#include <hooks/callout_handle.h>
+#include <hooks/hooks_manager.h>
+#include <hooks/server_hooks.h>
+#include <log/logger_support.h>
+#include <util/benchmarks/benchmark_report.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the in-process benchmark of the DHCPv4 server packet
+/// pipeline. It configures a server with a memfile lease database, feeds
+/// synthetic relayed DHCPDISCOVER, DHCPREQUEST and renewing DHCPREQUEST
+/// messages directly to @c Dhcpv4Srv::processPacketAndSendResponse, without
+/// sockets, and reports the latency percentiles and the packets per second
+/// of each phase and, optionally, of each stage of the processing. The
+/// option block cache can be cleared before each query to measure the
+/// responses built without it.
+
+namespace {
+
+const char* const BENCHMARK_NAME = "kea-dhcp4-benchmark";
+
+/// @brief The address of the server.
+const IOAddress SERVER_ADDRESS("10.255.255.1");
+
+/// @brief The phases of the benchmark in the order they run.
+const char* const PHASES[] = { "discover", "request", "renew" };
+
+/// @brief The hook points used to split the processing in stages.
+const char* const PROBE_HOOKS[] = {
+    "buffer4_receive", "pkt4_receive", "subnet4_select", "lease4_select",
+    "lease4_renew", "leases4_committed", "pkt4_send", "buffer4_send"
+};
+
+/// @brief Parameters of the benchmark.
+struct Parameters {
+    /// @brief Constructor.
+    Parameters()
+        : config_file_(), clients_(10000), subnets_(1), reservations_(0),
+          classes_(0), hooks_(), phases_(), probes_(false),
+          no_option_cache_(false), json_(false) {
+    }
+
+    /// @brief The configuration file or empty to generate the configuration.
+    string config_file_;
+
+    /// @brief The number of clients.
+    size_t clients_;
+
+    /// @brief The number of generated subnets.
+    size_t subnets_;
+
+    /// @brief The number of clients with a generated host reservation.
+    size_t reservations_;
+
+    /// @brief The number of generated client classes.
+    size_t classes_;
+
+    /// @brief The hook libraries added to the generated configuration.
+    vector<string> hooks_;
+
+    /// @brief The reported phases (all when empty).
+    vector<string> phases_;
+
+    /// @brief Whether the stages are measured.
+    bool probes_;
+
+    /// @brief Whether the option block cache is cleared before each query.
+    bool no_option_cache_;
+
+    /// @brief Whether the report is printed in JSON.
+    bool json_;
+};
+
+/// @brief Prints the usage and exits.
+///
+/// Note: This function never returns. It terminates the process.
+void
+usage() {
+    cerr << "Usage: " << BENCHMARK_NAME
+         << " [-c cfgfile] [-n clients] [-s subnets] [-r reservations]"
+         << " [-C classes] [-H library]... [-p phase[,phase]...] [-S] [-O] [-j]"
+         << endl;
+    cerr << "  -c file: use the configuration file instead of generating one;"
+         << endl
+         << "           the clients are relayed from the first address of"
+         << " each subnet" << endl;
+    cerr << "  -n number: number of clients (default 10000)" << endl;
+    cerr << "  -s number: number of generated subnets (default 1)" << endl;
+    cerr << "  -r number: number of clients with a generated host reservation"
+         << " (default 0)" << endl;
+    cerr << "  -C number: number of generated client classes, at most 256"
+         << " (default 0)" << endl;
+    cerr << "  -H file: hook library to add to the generated configuration"
+         << endl;
+    cerr << "  -p phases: comma separated phases to report among discover,"
+         << " request and renew (default all)" << endl;
+    cerr << "  -S: measure the stages between the hook points" << endl;
+    cerr << "  -O: clear the option block cache before each query" << endl;
+    cerr << "  -j: print the report in JSON" << endl;
+    exit(EXIT_FAILURE);
+}
+
+/// @brief Parses a number argument.
+///
+/// @param arg the argument.
+/// @return the number.
+size_t
+parseNumber(const char* arg) {
+    try {
+        return (boost::lexical_cast<size_t>(arg));
+    } catch (const boost::bad_lexical_cast&) {
+        cerr << "invalid number: " << arg << endl;
+        usage();
+    }
+}
+
+/// @brief Parses the command line.
+///
+/// @param argc the number of arguments.
+/// @param argv the arguments.
+/// @return the parameters.
+Parameters
+parseCommandLine(int argc, char* argv[]) {
+    Parameters params;
+    int ch;
+    while ((ch = getopt(argc, argv, "c:n:s:r:C:H:p:SOj")) != -1) {
+        switch (ch) {
+        case 'c':
+            params.config_file_ = optarg;
+            break;
+
+        case 'n':
+            params.clients_ = parseNumber(optarg);
+            break;
+
+        case 's':
+            params.subnets_ = parseNumber(optarg);
+            break;
+
+        case 'r':
+            params.reservations_ = parseNumber(optarg);
+            break;
+
+        case 'C':
+            params.classes_ = parseNumber(optarg);
+            break;
+
+        case 'H':
+            params.hooks_.push_back(optarg);
+            break;
+
+        case 'p': {
+            istringstream phases(optarg);
+            string phase;
+            while (getline(phases, phase, ',')) {
+                if (find(begin(PHASES), end(PHASES), phase) == end(PHASES)) {
+                    cerr << "unknown phase: " << phase << endl;
+                    usage();
+                }
+                params.phases_.push_back(phase);
+            }
+            break;
+        }
+
+        case 'S':
+            params.probes_ = true;
+            break;
+
+        case 'O':
+            params.no_option_cache_ = true;
+            break;
+
+        case 'j':
+            params.json_ = true;
+            break;
+
+        default:
+            usage();
+        }
+    }
+    if (argc > optind) {
+        usage();
+    }
+    if ((params.clients_ == 0) || (params.subnets_ == 0) ||
+        (params.reservations_ > params.clients_) || (params.classes_ > 256)) {
+        usage();
+    }
+    if (params.phases_.empty()) {
+        params.phases_.assign(begin(PHASES), end(PHASES));
+    }
+    return (params);
+}
+
+/// @brief Returns the prefix length of the generated subnets.
+///
+/// The subnets are carved from 10.0.0.0/8. A subnet holds a pool in
+/// its first half for its clients and the reservations in its second half.
+///
+/// @param params the parameters.
+/// @return the prefix length.
+uint8_t
+getPrefixLength(const Parameters& params) {
+    size_t per_subnet = (params.clients_ + params.subnets_ - 1) / params.subnets_;
+    uint8_t len = 30;
+    while ((len > 8) && ((uint64_t(1) << (32 - len)) / 2 < per_subnet + 16)) {
+        --len;
+    }
+    if ((uint64_t(params.subnets_) << (32 - len)) > (uint64_t(1) << 24)) {
+        isc_throw(BadValue, "too many clients and subnets for 10.0.0.0/8");
+    }
+    return (len);
+}
+
+/// @brief Returns the hardware address of a client.
+///
+/// The last byte is the class of the client.
+///
+/// @param params the parameters.
+/// @param client the index of the client.
+/// @return the hardware address.
+vector<uint8_t>
+getHWAddr(const Parameters& params, size_t client) {
+    uint8_t cclass = (params.classes_ ? client % params.classes_ : 0);
+    return (vector<uint8_t>{ 0x02, static_cast<uint8_t>(client >> 24),
+                             static_cast<uint8_t>(client >> 16),
+                             static_cast<uint8_t>(client >> 8),
+                             static_cast<uint8_t>(client), cclass });
+}
+
+/// @brief Returns the generated configuration.
+///
+/// @param params the parameters.
+/// @return the configuration in JSON.
+string
+makeConfig(const Parameters& params) {
+    uint8_t len = getPrefixLength(params);
+    uint32_t size = 1 << (32 - len);
+    ostringstream s;
+    s << "{ \"Dhcp4\": {" << endl
+      << "  \"interfaces-config\": { \"interfaces\": [ ], \"re-detect\": false },"
+      << endl
+      << "  \"lease-database\": { \"type\": \"memfile\", \"persist\": false,"
+      << " \"lfc-interval\": 0 }," << endl
+      << "  \"multi-threading\": { \"enable-multi-threading\": false }," << endl
+      << "  \"valid-lifetime\": 4000," << endl
+      << "  \"option-data\": [" << endl
+      << "    { \"name\": \"dhcp-server-identifier\", \"data\": \""
+      << SERVER_ADDRESS << "\" }," << endl
+      << "    { \"name\": \"domain-name-servers\","
+      << " \"data\": \"10.255.255.53, 10.255.255.54\" }" << endl
+      << "  ]," << endl;
+    if (params.classes_) {
+        s << "  \"client-classes\": [";
+        for (size_t i = 0; i < params.classes_; ++i) {
+            s << (i ? "," : "") << endl
+              << "    { \"name\": \"bench-" << i << "\","
+              << " \"test\": \"substring(pkt4.mac, 5, 1) == 0x"
+              << hex << setw(2) << setfill('0') << i << dec << setfill(' ') << "\","
+              << " \"option-data\": [ { \"name\": \"ntp-servers\","
+              << " \"data\": \"10.255." << (i / 256) << "." << (i % 256) << "\" } ] }";
+        }
+        s << " ]," << endl;
+    }
+    if (!params.hooks_.empty()) {
+        s << "  \"hooks-libraries\": [";
+        for (size_t i = 0; i < params.hooks_.size(); ++i) {
+            s << (i ? ", " : " ") << "{ \"library\": "
+              << BenchmarkReport::quote(params.hooks_[i]) << " }";
+        }
+        s << " ]," << endl;
+    }
+    s << "  \"subnet4\": [";
+    for (size_t i = 0; i < params.subnets_; ++i) {
+        uint32_t base = (10 << 24) + i * size;
+        s << (i ? "," : "") << endl
+          << "    { \"id\": " << (i + 1) << ", \"subnet\": \""
+          << IOAddress(base) << "/" << static_cast<unsigned>(len) << "\","
+          << " \"pools\": [ { \"pool\": \"" << IOAddress(base + 2) << " - "
+          << IOAddress(base + size / 2 - 1) << "\" } ]," << endl
+          << "      \"option-data\": [ { \"name\": \"routers\", \"data\": \""
+          << IOAddress(base + 1) << "\" },"
+          << " { \"name\": \"domain-name\", \"data\": \"subnet" << i
+          << ".example.org\" } ]," << endl
+          << "      \"reservations\": [";
+        bool first = true;
+        for (size_t client = i; client < params.reservations_;
+             client += params.subnets_) {
+            vector<uint8_t> hwaddr = getHWAddr(params, client);
+            s << (first ? " " : ", ") << "{ \"hw-address\": \""
+              << HWAddr(hwaddr, HTYPE_ETHER).toText(false) << "\","
+              << " \"ip-address\": \""
+              << IOAddress(base + size / 2 + client / params.subnets_) << "\" }";
+            first = false;
+        }
+        s << " ] }";
+    }
+    s << " ]" << endl << "} }" << endl;
+    return (s.str());
+}
+
+/// @brief Configures the server.
+///
+/// @param srv the server.
+/// @param params the parameters.
+void
+configure(Dhcpv4Srv& srv, const Parameters& params) {
+    Parser4Context parser;
+    ElementPtr json;
+    if (params.config_file_.empty()) {
+        json = parser.parseString(makeConfig(params), Parser4Context::PARSER_DHCP4);
+    } else {
+        json = parser.parseFile(params.config_file_, Parser4Context::PARSER_DHCP4);
+    }
+    if (!json || (json->getType() != Element::map) || !json->get("Dhcp4")) {
+        isc_throw(BadValue, "the configuration has no Dhcp4 entry");
+    }
+    ConstElementPtr answer = configureDhcp4Server(srv, json->get("Dhcp4"));
+    int rcode;
+    ConstElementPtr comment = parseAnswer(rcode, answer);
+    if (rcode != CONTROL_RESULT_SUCCESS) {
+        isc_throw(BadValue, "configuration failed: "
+                  << (comment ? comment->stringValue() : "no details"));
+    }
+    CfgDbAccessPtr cfg_db = CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    cfg_db->setAppendedParameters("universe=4");
+    cfg_db->createManagers();
+    CfgMgr::instance().commit();
+    LibDHCP::commitRuntimeOptionDefs();
+}
+
+/// @brief Server sending the responses nowhere.
+class BenchmarkDhcpv4Srv : public Dhcpv4Srv {
+public:
+    /// @brief Constructor.
+    ///
+    /// Port 0 does not open sockets.
+    BenchmarkDhcpv4Srv() : Dhcpv4Srv(0, 0, false, false), response_() {
+    }
+
+    /// @brief Keeps the response instead of sending it.
+    ///
+    /// @param pkt the response.
+    virtual void sendPacket(const Pkt4Ptr& pkt) {
+        response_ = pkt;
+    }
+
+    /// @brief The last response.
+    Pkt4Ptr response_;
+};
+
+/// @brief A time mark at a hook point.
+struct ProbeMark {
+    /// @brief The index of the hook point.
+    int hook_;
+
+    /// @brief The time.
+    chrono::steady_clock::time_point time_;
+};
+
+/// @brief The time marks of the packet being processed.
+vector<ProbeMark> probe_marks;
+
+/// @brief Callout recording a time mark.
+///
+/// @param handle the callout handle.
+/// @return 0.
+int
+probe(CalloutHandle& handle) {
+    probe_marks.push_back({ handle.getCurrentHook(), chrono::steady_clock::now() });
+    return (0);
+}
+
+/// @brief Registers the probe at all the hook points.
+void
+registerProbes() {
+    probe_marks.reserve(2 * sizeof(PROBE_HOOKS) / sizeof(PROBE_HOOKS[0]));
+    for (auto const& hook : PROBE_HOOKS) {
+        HooksManager::preCalloutsLibraryHandle().registerCallout(hook, probe);
+    }
+}
+
+/// @brief State of a client.
+struct Client {
+    /// @brief The hardware address.
+    HWAddrPtr hwaddr_;
+
+    /// @brief The relay address.
+    IOAddress giaddr_;
+
+    /// @brief The offered or acknowledged address.
+    IOAddress address_;
+
+    /// @brief The server identifier from the offer.
+    OptionPtr server_id_;
+};
+
+/// @brief Returns the on-wire format of a query of a client.
+///
+/// @param client the client.
+/// @param type the message type.
+/// @param transid the transaction id.
+/// @return the query.
+vector<uint8_t>
+makeQuery(const Client& client, uint8_t type, uint32_t transid) {
+    Pkt4Ptr query(new Pkt4(type, transid));
+    query->setHWAddr(client.hwaddr_);
+    query->setGiaddr(client.giaddr_);
+    query->setHops(1);
+    vector<uint8_t> client_id = { HTYPE_ETHER };
+    client_id.insert(client_id.end(), client.hwaddr_->hwaddr_.begin(),
+                     client.hwaddr_->hwaddr_.end());
+    query->addOption(OptionPtr(new Option(Option::V4, DHO_DHCP_CLIENT_IDENTIFIER,
+                                          client_id)));
+    query->addOption(OptionPtr(new Option(Option::V4, DHO_DHCP_PARAMETER_REQUEST_LIST,
+                                          OptionBuffer {
+                                              DHO_SUBNET_MASK, DHO_ROUTERS,
+                                              DHO_DOMAIN_NAME_SERVERS,
+                                              DHO_DOMAIN_NAME, DHO_NTP_SERVERS })));
+    if ((type == DHCPREQUEST) && client.server_id_) {
+        // Selecting: the client requests the offered address.
+        query->addOption(client.server_id_);
+        query->addOption(OptionPtr(new Option4AddrLst(DHO_DHCP_REQUESTED_ADDRESS,
+                                                      client.address_)));
+    } else if (type == DHCPREQUEST) {
+        // Renewing: the client uses its address.
+        query->setCiaddr(client.address_);
+    }
+    query->pack();
+    const uint8_t* data = static_cast<const uint8_t*>(query->getBuffer().getData());
+    return (vector<uint8_t>(data, data + query->getBuffer().getLength()));
+}
+
+/// @brief Runs a phase.
+///
+/// @param srv the server.
+/// @param clients the clients.
+/// @param type the message type of the queries.
+/// @param name the name of the phase.
+/// @param report the report or null when the phase is not reported.
+/// @param option_cache the option block cache to clear before each query
+/// or null.
+void
+runPhase(BenchmarkDhcpv4Srv& srv, vector<Client>& clients, uint8_t type,
+         const string& name, BenchmarkReport* report,
+         const OptionBlockCachePtr& option_cache) {
+    vector<vector<uint8_t>> queries;
+    queries.reserve(clients.size());
+    for (size_t i = 0; i < clients.size(); ++i) {
+        queries.push_back(makeQuery(clients[i], type, i + 1));
+    }
+
+    LatencyStats total;
+    vector<string> stage_names;
+    map<string, LatencyStats> stages;
+    size_t responses = 0;
+    auto phase_start = chrono::steady_clock::now();
+    for (size_t i = 0; i < clients.size(); ++i) {
+        srv.response_.reset();
+        probe_marks.clear();
+        if (option_cache) {
+            option_cache->clear();
+        }
+        auto start = chrono::steady_clock::now();
+        Pkt4Ptr query(new Pkt4(&queries[i][0], queries[i].size()));
+        query->setRemoteAddr(clients[i].giaddr_);
+        query->setLocalAddr(SERVER_ADDRESS);
+        query->setRemotePort(DHCP4_SERVER_PORT);
+        query->setLocalPort(DHCP4_SERVER_PORT);
+        query->setIface("eth0");
+        query->setIndex(1);
+        srv.processPacketAndSendResponseNoThrow(query);
+        auto end = chrono::steady_clock::now();
+        total.add(end - start);
+
+        // Split the processing at the hook points.
+        auto previous = start;
+        for (auto const& mark : probe_marks) {
+            string stage = ServerHooks::getServerHooks().getName(mark.hook_);
+            if (stages.count(stage) == 0) {
+                stage_names.push_back(stage);
+            }
+            stages[stage].add(mark.time_ - previous);
+            previous = mark.time_;
+        }
+        if (!probe_marks.empty()) {
+            if (stages.count("end") == 0) {
+                stage_names.push_back("end");
+            }
+            stages["end"].add(end - previous);
+        }
+
+        Pkt4Ptr response = srv.response_;
+        if (!response) {
+            continue;
+        }
+        uint8_t expected = (type == DHCPDISCOVER ? DHCPOFFER : DHCPACK);
+        if (response->getType() != expected) {
+            continue;
+        }
+        ++responses;
+        clients[i].address_ = response->getYiaddr();
+        clients[i].server_id_ = (type == DHCPDISCOVER ?
+                                 response->getOption(DHO_DHCP_SERVER_IDENTIFIER) :
+                                 OptionPtr());
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() -
+                                              phase_start).count();
+
+    if (report) {
+        report->addParameter(name + "-responses", to_string(responses));
+        report->addResult(name + "/total", total, clients.size() / elapsed);
+        for (auto const& stage : stage_names) {
+            report->addResult(name + "/" + stage, stages[stage]);
+        }
+    }
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    Parameters params = parseCommandLine(argc, argv);
+
+    try {
+        isc::log::initLogger(BENCHMARK_NAME, isc::log::ERROR,
+                             isc::log::MAX_DEBUG_LEVEL, NULL, false);
+        CfgMgr::instance().setFamily(AF_INET);
+
+        BenchmarkDhcpv4Srv srv;
+        configure(srv, params);
+        if (params.probes_) {
+            registerProbes();
+        }
+
+        // Relay the clients from the first address of the subnets.
+        auto subnets = CfgMgr::instance().getCurrentCfg()->getCfgSubnets4()->getAll();
+        if (subnets->empty()) {
+            isc_throw(BadValue, "the configuration has no subnet");
+        }
+        vector<IOAddress> relays;
+        for (auto const& subnet : *subnets) {
+            relays.push_back(IOAddress(subnet->get().first.toUint32() + 1));
+        }
+        vector<Client> clients;
+        clients.reserve(params.clients_);
+        for (size_t i = 0; i < params.clients_; ++i) {
+            Client client = {
+                HWAddrPtr(new HWAddr(getHWAddr(params, i), HTYPE_ETHER)),
+                relays[i % relays.size()], IOAddress::IPV4_ZERO_ADDRESS(),
+                OptionPtr()
+            };
+            clients.push_back(client);
+        }
+
+        BenchmarkReport report("kea-dhcp4 packet pipeline");
+        report.addParameter("configuration", params.config_file_.empty() ?
+                            "generated" : params.config_file_);
+        report.addParameter("clients", to_string(params.clients_));
+        report.addParameter("subnets", to_string(subnets->size()));
+        if (params.config_file_.empty()) {
+            report.addParameter("reservations", to_string(params.reservations_));
+            report.addParameter("classes", to_string(params.classes_));
+            report.addParameter("hooks-libraries", to_string(params.hooks_.size()));
+        }
+        report.addParameter("stages", params.probes_ ? "yes" : "no");
+        report.addParameter("option-block-cache",
+                            params.no_option_cache_ ? "no" : "yes");
+#ifdef ENABLE_PACKET_ARENA
+        report.addParameter("packet-arena", "yes");
+#else
+        report.addParameter("packet-arena", "no");
+#endif
+
+        // Run the phases up to the last reported one.
+        size_t last = 0;
+        for (size_t i = 0; i < sizeof(PHASES) / sizeof(PHASES[0]); ++i) {
+            if (find(params.phases_.begin(), params.phases_.end(), PHASES[i]) !=
+                params.phases_.end()) {
+                last = i;
+            }
+        }
+        const uint8_t types[] = { DHCPDISCOVER, DHCPREQUEST, DHCPREQUEST };
+        OptionBlockCachePtr option_cache;
+        if (params.no_option_cache_) {
+            option_cache = CfgMgr::instance().getCurrentCfg()->getOptionBlockCache();
+        }
+        for (size_t i = 0; i <= last; ++i) {
+            bool reported = (find(params.phases_.begin(), params.phases_.end(),
+                                  PHASES[i]) != params.phases_.end());
+            runPhase(srv, clients, types[i], PHASES[i], reported ? &report : 0,
+                     option_cache);
+        }
+
+        report.print(cout, params.json_ ? BenchmarkReport::JSON :
+                     BenchmarkReport::TEXT);
+
+        HooksManager::prepareUnloadLibraries();
+        static_cast<void>(HooksManager::unloadLibraries());
+    } catch (const std::exception& ex) {
+        cerr << BENCHMARK_NAME << ": " << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+    return (EXIT_SUCCESS);
+}
@@ -96,6 +96,11 @@ using namespace std;
   PORT "port"
   PERSIST "persist"
   LFC_INTERVAL "lfc-interval"
+  COMPACT "compact"
+  WRITE_QUEUE_SIZE "write-queue-size"
+  WRITE_MAX_DELAY "write-max-delay"
+  WRITE_SYNC "write-sync"
+  FORMAT "format"
   READONLY "readonly"
   CONNECT_TIMEOUT "connect-timeout"
   READ_TIMEOUT "read-timeout"
@@ -1099,6 +1104,11 @@ database_map_param: database_type
                   | name
                   | persist
                   | lfc_interval
+                  | compact
+                  | write_queue_size
+                  | write_max_delay
+                  | write_sync
+                  | format
                   | readonly
                   | connect_timeout
                   | read_timeout
@@ -1179,6 +1189,39 @@ lfc_interval: LFC_INTERVAL COLON INTEGER {
     ctx.stack_.back()->set("lfc-interval", n);
 };
 
+compact: COMPACT COLON BOOLEAN {
+    ctx.unique("compact", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("compact", n);
+};
+
+write_queue_size: WRITE_QUEUE_SIZE COLON INTEGER {
+    ctx.unique("write-queue-size", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-queue-size", n);
+};
+
+write_max_delay: WRITE_MAX_DELAY COLON INTEGER {
+    ctx.unique("write-max-delay", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-max-delay", n);
+};
+
+write_sync: WRITE_SYNC COLON BOOLEAN {
+    ctx.unique("write-sync", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-sync", n);
+};
+
+format: FORMAT {
+    ctx.unique("format", ctx.loc2pos(@1));
+    ctx.enter(ctx.NO_KEYWORD);
+} COLON STRING {
+    ElementPtr format(new StringElement($4, ctx.loc2pos(@4)));
+    ctx.stack_.back()->set("format", format);
+    ctx.leave();
+};
+
 readonly: READONLY COLON BOOLEAN {
     ctx.unique("readonly", ctx.loc2pos(@1));
     ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
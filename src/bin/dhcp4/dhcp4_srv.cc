@@ -65,6 +65,7 @@
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/ncr_generator.h>
 #include <dhcpsrv/network_state.h>
+#include <dhcpsrv/option_block_cache.h>
 #include <dhcpsrv/packet_fuzzer.h>
 #include <dhcpsrv/pool.h>
 #include <dhcpsrv/resource_handler.h>
@@ -75,6 +76,7 @@
 #include <dhcpsrv/subnet_selector.h>
 #include <dhcpsrv/utils.h>
 #include <eval/evaluate.h>
+#include <eval/extraction_cache.h>
 #include <eval/token.h>
 #include <exceptions/exceptions.h>
 #include <hooks/callout_handle.h>
@@ -90,6 +92,7 @@
 #include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 #include <util/optional.h>
+#include <util/packet_arena.h>
 #include <util/readwrite_mutex.h>
 #include <util/thread_pool.h>
 #include <util/triplet.h>
@@ -146,7 +149,11 @@ struct Dhcp4Hooks {
     int hook_index_lease4_offer_;           ///< index for "lease4_offer" hook point
     int hook_index_lease4_server_decline_;  ///< index for "lease4_server_decline" hook point
 
-    /// Constructor that registers hook points for DHCPv4 engine
+    int arg_index_query4_;                  ///< index for "query4" argument
+    int arg_index_response4_;               ///< index for "response4" argument
+    int arg_index_subnet4_;                 ///< index for "subnet4" argument
+
+    /// Constructor that registers hook points and arguments for DHCPv4 engine
     Dhcp4Hooks() {
         hook_index_buffer4_receive_         = HooksManager::registerHook("buffer4_receive");
         hook_index_pkt4_receive_            = HooksManager::registerHook("pkt4_receive");
@@ -160,6 +167,10 @@ struct Dhcp4Hooks {
         hook_index_ddns4_update_            = HooksManager::registerHook("ddns4_update");
         hook_index_lease4_offer_            = HooksManager::registerHook("lease4_offer");
         hook_index_lease4_server_decline_   = HooksManager::registerHook("lease4_server_decline");
+
+        arg_index_query4_                   = HooksManager::registerArgument("query4");
+        arg_index_response4_                = HooksManager::registerArgument("response4");
+        arg_index_subnet4_                  = HooksManager::registerArgument("subnet4");
     }
 };
 
@@ -191,6 +202,123 @@ std::set<std::string> dhcp4_statistics = {
     "v4-lease-reuses",
 };
 
+/// Structure that holds the counters of the statistics updated for every
+/// packet: they are resolved once so the packet processing does not look
+/// the statistics up by name nor take the Statistics Manager lock.
+struct Dhcp4Counters {
+    StatCounterPtr pkt4_received_;          ///< "pkt4-received" counter
+    StatCounterPtr pkt4_discover_received_; ///< "pkt4-discover-received" counter
+    StatCounterPtr pkt4_offer_received_;    ///< "pkt4-offer-received" counter
+    StatCounterPtr pkt4_request_received_;  ///< "pkt4-request-received" counter
+    StatCounterPtr pkt4_ack_received_;      ///< "pkt4-ack-received" counter
+    StatCounterPtr pkt4_nak_received_;      ///< "pkt4-nak-received" counter
+    StatCounterPtr pkt4_release_received_;  ///< "pkt4-release-received" counter
+    StatCounterPtr pkt4_decline_received_;  ///< "pkt4-decline-received" counter
+    StatCounterPtr pkt4_inform_received_;   ///< "pkt4-inform-received" counter
+    StatCounterPtr pkt4_unknown_received_;  ///< "pkt4-unknown-received" counter
+    StatCounterPtr pkt4_sent_;              ///< "pkt4-sent" counter
+    StatCounterPtr pkt4_offer_sent_;        ///< "pkt4-offer-sent" counter
+    StatCounterPtr pkt4_ack_sent_;          ///< "pkt4-ack-sent" counter
+    StatCounterPtr pkt4_nak_sent_;          ///< "pkt4-nak-sent" counter
+
+    /// Constructor that resolves the counters
+    Dhcp4Counters() {
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        pkt4_received_          = stats_mgr.getCounter("pkt4-received");
+        pkt4_discover_received_ = stats_mgr.getCounter("pkt4-discover-received");
+        pkt4_offer_received_    = stats_mgr.getCounter("pkt4-offer-received");
+        pkt4_request_received_  = stats_mgr.getCounter("pkt4-request-received");
+        pkt4_ack_received_      = stats_mgr.getCounter("pkt4-ack-received");
+        pkt4_nak_received_      = stats_mgr.getCounter("pkt4-nak-received");
+        pkt4_release_received_  = stats_mgr.getCounter("pkt4-release-received");
+        pkt4_decline_received_  = stats_mgr.getCounter("pkt4-decline-received");
+        pkt4_inform_received_   = stats_mgr.getCounter("pkt4-inform-received");
+        pkt4_unknown_received_  = stats_mgr.getCounter("pkt4-unknown-received");
+        pkt4_sent_              = stats_mgr.getCounter("pkt4-sent");
+        pkt4_offer_sent_        = stats_mgr.getCounter("pkt4-offer-sent");
+        pkt4_ack_sent_          = stats_mgr.getCounter("pkt4-ack-sent");
+        pkt4_nak_sent_          = stats_mgr.getCounter("pkt4-nak-sent");
+    }
+};
+
+/// @brief Selects the configured options to return for requested options.
+///
+/// @param co_list The list of configured options.
+/// @param cclasses The client classes.
+/// @param requested The codes from the parameter request list.
+/// @return the selected options with their on-wire format and the codes
+/// of the requested options which are not cancelled.
+ConstOptionBlockPtr
+selectRequestedOptions(const CfgOptionList& co_list,
+                       const ClientClasses& cclasses,
+                       const OptionBuffer& requested) {
+    set<uint8_t> requested_opts;
+
+    // Get the list of options that client requested.
+    for (uint16_t code : requested) {
+        static_cast<void>(requested_opts.insert(code));
+    }
+
+    std::set<uint8_t> cancelled_opts;
+
+    // Iterate on the configured option list to add persistent and
+    // cancelled options.
+    for (auto const& copts : co_list) {
+        const OptionContainerPtr& opts = copts->getAll(DHCP4_OPTION_SPACE);
+        if (!opts) {
+            continue;
+        }
+        // Get persistent options.
+        const OptionContainerPersistIndex& pidx = opts->get<2>();
+        const OptionContainerPersistRange& prange = pidx.equal_range(true);
+        BOOST_FOREACH(auto const& desc, prange) {
+            // Add the persistent option code to requested options.
+            if (desc.option_) {
+                uint8_t code = static_cast<uint8_t>(desc.option_->getType());
+                static_cast<void>(requested_opts.insert(code));
+            }
+        }
+        // Get cancelled options.
+        const OptionContainerCancelIndex& cidx = opts->get<5>();
+        const OptionContainerCancelRange& crange = cidx.equal_range(true);
+        BOOST_FOREACH(auto const& desc, crange) {
+            // Add the cancelled option code to cancelled options.
+            if (desc.option_) {
+                uint8_t code = static_cast<uint8_t>(desc.option_->getType());
+                static_cast<void>(cancelled_opts.insert(code));
+            }
+        }
+    }
+
+    boost::shared_ptr<OptionBlock> block(new OptionBlock());
+    boost::shared_ptr<PackedOptionCollection> options(new PackedOptionCollection());
+
+    // For each requested option code get the first instance of the option
+    // to be returned to the client.
+    for (uint8_t opt : requested_opts) {
+        if (cancelled_opts.count(opt) > 0) {
+            continue;
+        }
+        block->requested_.set(opt);
+        // Skip special cases: DHO_VIVSO_SUBOPTIONS.
+        if (opt == DHO_VIVSO_SUBOPTIONS) {
+            continue;
+        }
+        // Iterate on the configured option list
+        for (auto const& copts : co_list) {
+            OptionDescriptor desc = copts->get(DHCP4_OPTION_SPACE, opt);
+            // Got it: add it and jump to the outer loop
+            if (desc.option_ && desc.allowedForClientClasses(cclasses)) {
+                options->push_back(OptionBlockCache::makePackedOption(desc.option_));
+                break;
+            }
+        }
+    }
+
+    block->options_ = options;
+    return (block);
+}
+
 } // end of anonymous namespace
 
 // Declare a Hooks object. As this is outside any function or method, it
@@ -199,6 +327,9 @@ std::set<std::string> dhcp4_statistics = {
 // module is called.
 Dhcp4Hooks Hooks;
 
+// Declare the packet statistic counters.
+Dhcp4Counters Counters;
+
 namespace isc {
 namespace dhcp {
 
@@ -520,7 +651,7 @@ Dhcpv4Exchange::setHostIdentifiers(AllocEngine::ClientContext4Ptr context) {
                 ScopedCalloutHandleState callout_handle_state(callout_handle);
 
                 // Pass incoming packet as argument
-                callout_handle->setArgument("query4", context->query_);
+                callout_handle->setArgument(Hooks.arg_index_query4_, context->query_);
                 callout_handle->setArgument("id_type", type);
                 callout_handle->setArgument("id_value", id);
 
@@ -637,7 +768,11 @@ void Dhcpv4Exchange::evaluateClasses(const Pkt4Ptr& pkt, bool depend_on_known) {
     // Note getClientClassDictionary() cannot be null
     const ClientClassDictionaryPtr& dict =
         CfgMgr::instance().getCurrentCfg()->getClientClassDictionary();
-    const ClientClassDefListPtr& defs_ptr = dict->getClasses();
+    // Only the classes with a match expression: the template subclass
+    // definitions are skipped.
+    const ClientClassDefListPtr& defs_ptr = dict->getEvaluatedClasses();
+    // Extract the data shared by the expressions once.
+    ExtractionCache cache;
     for (auto const& it : *defs_ptr) {
         // Note second cannot be null
         const ExpressionPtr& expr_ptr = it->getMatchExpr();
@@ -663,7 +798,7 @@ Dhcpv4Srv::Dhcpv4Srv(uint16_t server_port, uint16_t client_port,
                      const bool use_bcast, const bool direct_response_desired)
     : io_service_(new IOService()), server_port_(server_port),
       client_port_(client_port), shutdown_(true),
-      alloc_engine_(), use_bcast_(use_bcast),
+      alloc_engine_(), use_bcast_(use_bcast), lazy_unpack_(false),
       network_state_(new NetworkState()),
       cb_control_(new CBControlDHCPv4()),
       test_send_responses_to_source_(false) {
@@ -804,8 +939,8 @@ Dhcpv4Srv::selectSubnet(const Pkt4Ptr& query, bool& drop,
         ScopedEnableOptionsCopy<Pkt4> query4_options_copy(query);
 
         // Set new arguments
-        callout_handle->setArgument("query4", query);
-        callout_handle->setArgument("subnet4", subnet);
+        callout_handle->setArgument(Hooks.arg_index_query4_, query);
+        callout_handle->setArgument(Hooks.arg_index_subnet4_, subnet);
         callout_handle->setArgument("subnet4collection",
                                     cfgmgr.getCurrentCfg()->
                                     getCfgSubnets4()->getAll());
@@ -882,7 +1017,7 @@ Dhcpv4Srv::selectSubnet(const Pkt4Ptr& query, bool& drop,
         }
 
         // Use whatever subnet was specified by the callout
-        callout_handle->getArgument("subnet4", subnet);
+        callout_handle->getArgument(Hooks.arg_index_subnet4_, subnet);
     }
 
     if (subnet) {
@@ -972,8 +1107,8 @@ Dhcpv4Srv::selectSubnet4o6(const Pkt4Ptr& query, bool& drop,
         ScopedEnableOptionsCopy<Pkt4> query4_options_copy(query);
 
         // Set new arguments
-        callout_handle->setArgument("query4", query);
-        callout_handle->setArgument("subnet4", subnet);
+        callout_handle->setArgument(Hooks.arg_index_query4_, query);
+        callout_handle->setArgument(Hooks.arg_index_subnet4_, subnet);
         callout_handle->setArgument("subnet4collection",
                                     cfgmgr.getCurrentCfg()->
                                     getCfgSubnets4()->getAll());
@@ -1050,7 +1185,7 @@ Dhcpv4Srv::selectSubnet4o6(const Pkt4Ptr& query, bool& drop,
         }
 
         // Use whatever subnet was specified by the callout
-        callout_handle->getArgument("subnet4", subnet);
+        callout_handle->getArgument(Hooks.arg_index_subnet4_, subnet);
     }
 
     if (subnet) {
@@ -1313,6 +1448,10 @@ Dhcpv4Srv::processPacketAndSendResponseNoThrow(Pkt4Ptr query) {
 
 void
 Dhcpv4Srv::processPacketAndSendResponse(Pkt4Ptr query) {
+#ifdef ENABLE_PACKET_ARENA
+    // Allocate the objects created by the processing from a packet arena.
+    PacketArenaScope arena;
+#endif
     Pkt4Ptr rsp = processPacket(query);
     if (!rsp) {
         return;
@@ -1334,8 +1473,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
     // failures in unpacking will cause the packet to be dropped. We
     // will increase type specific statistic further down the road.
     // See processStatsReceived().
-    isc::stats::StatsMgr::instance().addValue("pkt4-received",
-                                              static_cast<int64_t>(1));
+    Counters.pkt4_received_->add();
 
     bool skip_unpack = false;
 
@@ -1354,7 +1492,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
         ScopedEnableOptionsCopy<Pkt4> query4_options_copy(query);
 
         // Pass incoming packet as argument
-        callout_handle->setArgument("query4", query);
+        callout_handle->setArgument(Hooks.arg_index_query4_, query);
 
         // Call callouts
         HooksManager::callCallouts(Hooks.hook_index_buffer4_receive_,
@@ -1385,7 +1523,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
             skip_unpack = true;
         }
 
-        callout_handle->getArgument("query4", query);
+        callout_handle->getArgument(Hooks.arg_index_query4_, query);
     }
 
     // Unpack the packet information unless the buffer4_receive callouts
@@ -1396,6 +1534,9 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
                 .arg(query->getRemoteAddr().toText())
                 .arg(query->getLocalAddr().toText())
                 .arg(query->getIface());
+            if (lazy_unpack_) {
+                query->setLazyUnpack(true);
+            }
             query->unpack();
         } catch (const SkipRemainingOptionsError& e) {
             // An option failed to unpack but we are to attempt to process it
@@ -1482,7 +1623,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
         ScopedEnableOptionsCopy<Pkt4> query4_options_copy(query);
 
         // Pass incoming packet as argument
-        callout_handle->setArgument("query4", query);
+        callout_handle->setArgument(Hooks.arg_index_query4_, query);
 
         // Call callouts
         HooksManager::callCallouts(Hooks.hook_index_pkt4_receive_,
@@ -1499,7 +1640,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
             return (Pkt4Ptr());
         }
 
-        callout_handle->getArgument("query4", query);
+        callout_handle->getArgument(Hooks.arg_index_query4_, query);
     }
 
     // Check the DROP special class.
@@ -1518,6 +1659,10 @@ Dhcpv4Srv::processPacket(Pkt4Ptr query, bool allow_answer_park) {
 void
 Dhcpv4Srv::processDhcp4QueryAndSendResponse(Pkt4Ptr query,
                                             bool allow_answer_park) {
+#ifdef ENABLE_PACKET_ARENA
+    // Allocate the objects created by the processing from a packet arena.
+    PacketArenaScope arena;
+#endif
     try {
         Pkt4Ptr rsp = processDhcp4Query(query, allow_answer_park);
         if (!rsp) {
@@ -1736,7 +1881,7 @@ Dhcpv4Srv::processLocalizedQuery4(AllocEngine::ClientContext4Ptr& ctx,
             ScopedEnableOptionsCopy<Pkt4> query4_options_copy(query);
 
             // Also pass the corresponding query packet as argument
-            callout_handle->setArgument("query4", query);
+            callout_handle->setArgument(Hooks.arg_index_query4_, query);
 
             Lease4CollectionPtr new_leases(new Lease4Collection());
             // Filter out the new lease if it was reused so not committed.
@@ -1911,13 +2056,13 @@ Dhcpv4Srv::processPacketPktSend(hooks::CalloutHandlePtr& callout_handle,
         ScopedEnableOptionsCopy<Pkt4> query_resp_options_copy(query, rsp);
 
         // Pass incoming packet as argument
-        callout_handle->setArgument("query4", query);
+        callout_handle->setArgument(Hooks.arg_index_query4_, query);
 
         // Set our response
-        callout_handle->setArgument("response4", rsp);
+        callout_handle->setArgument(Hooks.arg_index_response4_, rsp);
 
         // Pass in the selected subnet.
-        callout_handle->setArgument("subnet4", subnet);
+        callout_handle->setArgument(Hooks.arg_index_subnet4_, subnet);
 
         // Call all installed callouts
         HooksManager::callCallouts(Hooks.hook_index_pkt4_send_,
@@ -1980,7 +2125,7 @@ Dhcpv4Srv::processPacketBufferSend(CalloutHandlePtr& callout_handle,
             ScopedEnableOptionsCopy<Pkt4> resp4_options_copy(rsp);
 
             // Pass incoming packet as argument
-            callout_handle->setArgument("response4", rsp);
+            callout_handle->setArgument(Hooks.arg_index_response4_, rsp);
 
             // Call callouts
             HooksManager::callCallouts(Hooks.hook_index_buffer4_send_,
@@ -1997,7 +2142,7 @@ Dhcpv4Srv::processPacketBufferSend(CalloutHandlePtr& callout_handle,
                 return;
             }
 
-            callout_handle->getArgument("response4", rsp);
+            callout_handle->getArgument(Hooks.arg_index_response4_, rsp);
         }
 
         LOG_INFO(packet4_logger, DHCP4_PACKET_SEND)
@@ -2169,80 +2314,42 @@ Dhcpv4Srv::appendRequestedOptions(Dhcpv4Exchange& ex) {
 
     Pkt4Ptr query = ex.getQuery();
     Pkt4Ptr resp = ex.getResponse();
-    set<uint8_t> requested_opts;
+    const auto& cclasses = query->getClasses();
 
     // try to get the 'Parameter Request List' option which holds the
     // codes of requested options.
     OptionUint8ArrayPtr option_prl = boost::dynamic_pointer_cast<
         OptionUint8Array>(query->getOption(DHO_DHCP_PARAMETER_REQUEST_LIST));
-
-    // Get the list of options that client requested.
-    if (option_prl) {
-        for (uint16_t code : option_prl->getValues()) {
-            static_cast<void>(requested_opts.insert(code));
-        }
+    static const OptionBuffer no_requested_opts;
+    const OptionBuffer& requested = (option_prl ? option_prl->getValues() :
+                                     no_requested_opts);
+
+    // The selected options depend only on the configured option list,
+    // the client classes and the parameter request list, so they are
+    // cached with their on-wire format. Host specific options are not
+    // cached as the hosts may be fetched from a database for each query.
+    ConstOptionBlockPtr block;
+    OptionBlockCachePtr cache;
+    string key;
+    const ConstHostPtr& host = ex.getContext()->currentHost();
+    if (!host || host->getCfgOption4()->empty()) {
+        cache = CfgMgr::instance().getCurrentCfg()->getOptionBlockCache();
+        key = OptionBlockCache::makeKey(co_list, cclasses, requested);
+        block = cache->get(key);
     }
-
-    std::set<uint8_t> cancelled_opts;
-    const auto& cclasses = query->getClasses();
-
-    // Iterate on the configured option list to add persistent and
-    // cancelled options.
-    for (auto const& copts : co_list) {
-        const OptionContainerPtr& opts = copts->getAll(DHCP4_OPTION_SPACE);
-        if (!opts) {
-            continue;
-        }
-        // Get persistent options.
-        const OptionContainerPersistIndex& pidx = opts->get<2>();
-        const OptionContainerPersistRange& prange = pidx.equal_range(true);
-        BOOST_FOREACH(auto const& desc, prange) {
-            // Add the persistent option code to requested options.
-            if (desc.option_) {
-                uint8_t code = static_cast<uint8_t>(desc.option_->getType());
-                static_cast<void>(requested_opts.insert(code));
-            }
-        }
-        // Get cancelled options.
-        const OptionContainerCancelIndex& cidx = opts->get<5>();
-        const OptionContainerCancelRange& crange = cidx.equal_range(true);
-        BOOST_FOREACH(auto const& desc, crange) {
-            // Add the cancelled option code to cancelled options.
-            if (desc.option_) {
-                uint8_t code = static_cast<uint8_t>(desc.option_->getType());
-                static_cast<void>(cancelled_opts.insert(code));
-            }
+    if (!block) {
+        block = selectRequestedOptions(co_list, cclasses, requested);
+        if (cache) {
+            cache->add(key, co_list, block);
         }
     }
 
-    // For each requested option code get the first instance of the option
-    // to be returned to the client.
-    for (uint8_t opt : requested_opts) {
-        if (cancelled_opts.count(opt) > 0) {
-            continue;
-        }
-        // Skip special cases: DHO_VIVSO_SUBOPTIONS.
-        if (opt == DHO_VIVSO_SUBOPTIONS) {
-            continue;
-        }
-        // Add nothing when it is already there.
-        if (!resp->getOption(opt)) {
-            // Iterate on the configured option list
-            for (auto const& copts : co_list) {
-                OptionDescriptor desc = copts->get(DHCP4_OPTION_SPACE, opt);
-                // Got it: add it and jump to the outer loop
-                if (desc.option_ && desc.allowedForClientClasses(cclasses)) {
-                    resp->addOption(desc.option_);
-                    break;
-                }
-            }
-        }
-    }
+    // Add the selected options, nothing when it is already there.
+    static_cast<void>(resp->addPackedOptions(block->options_));
 
     // Special cases for vendor class and options which are identified
     // by the code/type and the vendor/enterprise id vs. the code/type only.
-    if ((requested_opts.count(DHO_VIVCO_SUBOPTIONS) > 0) &&
-        (cancelled_opts.count(DHO_VIVCO_SUBOPTIONS) == 0)) {
+    if (block->requested_[DHO_VIVCO_SUBOPTIONS]) {
         // Keep vendor ids which are already in the response to insert
         // VIVCO options at most once per vendor.
         set<uint32_t> vendor_ids;
@@ -2279,8 +2386,7 @@ Dhcpv4Srv::appendRequestedOptions(Dhcpv4Exchange& ex) {
         }
     }
 
-    if ((requested_opts.count(DHO_VIVSO_SUBOPTIONS) > 0) &&
-        (cancelled_opts.count(DHO_VIVSO_SUBOPTIONS) == 0)) {
+    if (block->requested_[DHO_VIVSO_SUBOPTIONS]) {
         // Keep vendor ids which are already in the response to insert
         // VIVSO options at most once per vendor.
         set<uint32_t> vendor_ids;
@@ -2604,9 +2710,9 @@ Dhcpv4Srv::processClientName(Dhcpv4Exchange& ex) {
 
             // Setup the callout arguments.
             ConstSubnet4Ptr subnet = ex.getContext()->subnet_;
-            callout_handle->setArgument("query4", query);
-            callout_handle->setArgument("response4", resp);
-            callout_handle->setArgument("subnet4", subnet);
+            callout_handle->setArgument(Hooks.arg_index_query4_, query);
+            callout_handle->setArgument(Hooks.arg_index_response4_, resp);
+            callout_handle->setArgument(Hooks.arg_index_subnet4_, subnet);
             callout_handle->setArgument("hostname", hostname);
             callout_handle->setArgument("fwd-update", fqdn_fwd);
             callout_handle->setArgument("rev-update", fqdn_rev);
@@ -4024,7 +4130,7 @@ Dhcpv4Srv::processRelease(Pkt4Ptr& release, AllocEngine::ClientContext4Ptr& cont
             ScopedEnableOptionsCopy<Pkt4> query4_options_copy(release);
 
             // Pass the original packet
-            callout_handle->setArgument("query4", release);
+            callout_handle->setArgument(Hooks.arg_index_query4_, release);
 
             // Pass the lease to be updated
             callout_handle->setArgument("lease4", lease);
@@ -4219,7 +4325,7 @@ Dhcpv4Srv::declineLease(const Lease4Ptr& lease, const Pkt4Ptr& decline,
         ScopedEnableOptionsCopy<Pkt4> query4_options_copy(decline);
 
         // Pass the original packet
-        callout_handle->setArgument("query4", decline);
+        callout_handle->setArgument(Hooks.arg_index_query4_, decline);
 
         // Pass the lease to be updated
         callout_handle->setArgument("lease4", lease);
@@ -4404,7 +4510,7 @@ Dhcpv4Srv::serverDecline(hooks::CalloutHandlePtr& callout_handle, Pkt4Ptr& query
         ScopedCalloutHandleState callout_handle_state(callout_handle);
 
         // Pass in the original DHCPDISCOVER
-        callout_handle->setArgument("query4", query);
+        callout_handle->setArgument(Hooks.arg_index_query4_, query);
 
         // Pass in the declined lease.
         callout_handle->setArgument("lease4", lease);
@@ -4939,6 +5045,8 @@ void Dhcpv4Srv::evaluateAdditionalClasses(Dhcpv4Exchange& ex) {
     // Note getClientClassDictionary() cannot be null
     const ClientClassDictionaryPtr& dict =
         CfgMgr::instance().getCurrentCfg()->getClientClassDictionary();
+    // Extract the data shared by the expressions once.
+    ExtractionCache cache;
     for (auto const& cclass : classes) {
         const ClientClassDefPtr class_def = dict->findClass(cclass);
         if (!class_def) {
@@ -4960,7 +5068,9 @@ void Dhcpv4Srv::evaluateAdditionalClasses(Dhcpv4Exchange& ex) {
         // Evaluate the expression which can return false (no match),
         // true (match) or raise an exception (error)
         try {
-            bool status = evaluateBool(*expr_ptr, *query);
+            auto const& compiled_expr = class_def->getCompiledMatchExpr();
+            bool status = (compiled_expr ? compiled_expr->evaluateBool(*query) :
+                           evaluateBool(*expr_ptr, *query));
             LOG_DEBUG(dhcp4_logger, DBG_DHCP4_DETAIL, DHCP4_ADDITIONAL_CLASS_EVAL_RESULT)
                 .arg(query->getLabel())
                 .arg(cclass)
@@ -5121,35 +5231,37 @@ void Dhcpv4Srv::processStatsReceived(const Pkt4Ptr& query) {
     // Note that we're not bumping pkt4-received statistic as it was
     // increased early in the packet reception code.
 
-    string stat_name = "pkt4-unknown-received";
+    // Use a raw pointer: copying the shared pointer would make the
+    // threads compete on its reference count.
+    StatCounter* counter = Counters.pkt4_unknown_received_.get();
     try {
         switch (query->getType()) {
         case DHCPDISCOVER:
-            stat_name = "pkt4-discover-received";
+            counter = Counters.pkt4_discover_received_.get();
             break;
         case DHCPOFFER:
             // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-offer-received";
+            counter = Counters.pkt4_offer_received_.get();
             break;
         case DHCPREQUEST:
-            stat_name = "pkt4-request-received";
+            counter = Counters.pkt4_request_received_.get();
             break;
         case DHCPACK:
             // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-ack-received";
+            counter = Counters.pkt4_ack_received_.get();
             break;
         case DHCPNAK:
             // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-nak-received";
+            counter = Counters.pkt4_nak_received_.get();
             break;
         case DHCPRELEASE:
-            stat_name = "pkt4-release-received";
+            counter = Counters.pkt4_release_received_.get();
         break;
         case DHCPDECLINE:
-            stat_name = "pkt4-decline-received";
+            counter = Counters.pkt4_decline_received_.get();
             break;
         case DHCPINFORM:
-            stat_name = "pkt4-inform-received";
+            counter = Counters.pkt4_inform_received_.get();
             break;
         default:
             ; // do nothing
@@ -5162,34 +5274,28 @@ void Dhcpv4Srv::processStatsReceived(const Pkt4Ptr& query) {
         // name of pkt4-unknown-received.
     }
 
-    isc::stats::StatsMgr::instance().addValue(stat_name,
-                                              static_cast<int64_t>(1));
+    counter->add();
 }
 
 void Dhcpv4Srv::processStatsSent(const Pkt4Ptr& response) {
     // Increase generic counter for sent packets.
-    isc::stats::StatsMgr::instance().addValue("pkt4-sent",
-                                              static_cast<int64_t>(1));
+    Counters.pkt4_sent_->add();
 
     // Increase packet type specific counter for packets sent.
-    string stat_name;
     switch (response->getType()) {
     case DHCPOFFER:
-        stat_name = "pkt4-offer-sent";
+        Counters.pkt4_offer_sent_->add();
         break;
     case DHCPACK:
-        stat_name = "pkt4-ack-sent";
+        Counters.pkt4_ack_sent_->add();
         break;
     case DHCPNAK:
-        stat_name = "pkt4-nak-sent";
+        Counters.pkt4_nak_sent_->add();
         break;
     default:
         // That should never happen
         return;
     }
-
-    isc::stats::StatsMgr::instance().addValue(stat_name,
-                                              static_cast<int64_t>(1));
 }
 
 int Dhcpv4Srv::getHookIndexBuffer4Receive() {
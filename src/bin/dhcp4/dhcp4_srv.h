@@ -510,6 +510,23 @@ public:
         return (test_send_responses_to_source_);
     }
 
+    /// @brief Returns whether the options of the queries are unpacked lazily.
+    ///
+    /// @return true if the options are unpacked lazily.
+    bool getLazyUnpack() const {
+        return (lazy_unpack_);
+    }
+
+    /// @brief Enables or disables the lazy unpacking of the query options.
+    ///
+    /// Set from the "lazy-option-unpack" parameter of "dhcp-queue-control"
+    /// (see @ref Pkt4::setLazyUnpack).
+    ///
+    /// @param lazy_unpack new value of the flag.
+    void setLazyUnpack(bool lazy_unpack) {
+        lazy_unpack_ = lazy_unpack;
+    }
+
     /// @brief Initialize client context (first part).
     ///
     /// @param query The query message.
@@ -1281,6 +1298,9 @@ protected:
     /// Should broadcast be enabled on sockets (if true).
     bool use_bcast_;
 
+    /// Should the options of the queries be unpacked lazily (if true).
+    bool lazy_unpack_;
+
     /// @brief Holds information about disabled DHCP service and/or
     /// disabled subnet/network scopes.
     NetworkStatePtr network_state_;
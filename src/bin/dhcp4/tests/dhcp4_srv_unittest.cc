@@ -4298,6 +4298,67 @@ TEST_F(Dhcpv4SrvTest, neverSend) {
     ASSERT_FALSE(response->getOption(DHO_ARP_CACHE_TIMEOUT));
 }
 
+// Checks that the options selected for the responses are cached.
+TEST_F(Dhcpv4SrvTest, optionBlockCache) {
+    IfaceMgrTestConfig test_config(true);
+
+    ASSERT_NO_THROW(configure(CONFIGS[2]));
+    OptionBlockCachePtr cache =
+        CfgMgr::instance().getCurrentCfg()->getOptionBlockCache();
+    ASSERT_TRUE(cache);
+    EXPECT_EQ(0, cache->size());
+
+    // Create a packet with enough to select the subnet and go through
+    // the DISCOVER processing
+    Pkt4Ptr query(new Pkt4(DHCPDISCOVER, 1234));
+    query->setRemoteAddr(IOAddress("192.0.2.1"));
+    OptionPtr clientid = generateClientId();
+    query->addOption(clientid);
+    query->setIface("eth1");
+    query->setIndex(ETH1_INDEX);
+
+    // Create and add a PRL option.
+    OptionUint8ArrayPtr prl(new OptionUint8Array(Option::V4,
+                                                 DHO_DHCP_PARAMETER_REQUEST_LIST));
+    prl->addValue(DHO_DEFAULT_IP_TTL);
+    query->addOption(prl);
+
+    // The first response fills the cache, the second uses it.
+    for (unsigned i = 0; i < 2; ++i) {
+        Pkt4Ptr response = srv_.processDiscover(query);
+        checkResponse(response, DHCPOFFER, 1234);
+        EXPECT_EQ(1, cache->size());
+
+        // The options are sent from their on-wire format.
+        ASSERT_NO_THROW(response->pack());
+        const OutputBuffer& buf = response->getBuffer();
+        Pkt4Ptr received(new Pkt4(buf.getData(), buf.getLength()));
+        ASSERT_NO_THROW(received->unpack());
+        OptionPtr opt = received->getOption(DHO_DEFAULT_IP_TTL);
+        ASSERT_TRUE(opt);
+        EXPECT_EQ("0xFF", opt->toHexString());
+        opt = received->getOption(DHO_IP_FORWARDING);
+        ASSERT_TRUE(opt);
+        EXPECT_EQ(1, opt->len() - opt->getHeaderLen());
+    }
+
+    // Another PRL gives another entry.
+    query->delOption(DHO_DHCP_PARAMETER_REQUEST_LIST);
+    prl->addValue(DHO_ARP_CACHE_TIMEOUT);
+    query->addOption(prl);
+    Pkt4Ptr response = srv_.processDiscover(query);
+    checkResponse(response, DHCPOFFER, 1234);
+    EXPECT_EQ(2, cache->size());
+
+    // The cache is not shared with the next configuration.
+    ASSERT_NO_THROW(configure(CONFIGS[3]));
+    EXPECT_EQ(0, CfgMgr::instance().getCurrentCfg()->getOptionBlockCache()->size());
+    response = srv_.processDiscover(query);
+    checkResponse(response, DHCPOFFER, 1234);
+    EXPECT_FALSE(response->getOption(DHO_IP_FORWARDING));
+    EXPECT_EQ(1, CfgMgr::instance().getCurrentCfg()->getOptionBlockCache()->size());
+}
+
 // Checks if relay IP address specified in the relay-info structure in
 // subnet4 is being used properly.
 TEST_F(Dhcpv4SrvTest, relayOverride) {
@@ -5026,6 +5087,66 @@ TEST_F(Dhcpv4SrvTest, statisticsUnknownRcvd) {
     EXPECT_EQ(1, drop_stat->getInteger().first);
 }
 
+// Test checks that a query is processed when its options are unpacked
+// lazily.
+TEST_F(Dhcpv4SrvTest, lazyUnpack) {
+    IfaceMgrTestConfig test_config(true);
+    NakedDhcpv4Srv srv(0);
+    configure(CONFIGS[0]);
+    EXPECT_FALSE(srv.getLazyUnpack());
+    srv.setLazyUnpack(true);
+
+    Pkt4Ptr dis = PktCaptures::captureRelayedDiscover();
+    srv.fakeReceive(dis);
+    srv.run();
+    EXPECT_TRUE(dis->isLazyUnpack());
+
+    // The server sent an offer which echoes the relay agent options.
+    ASSERT_EQ(1, srv.fake_sent_.size());
+    Pkt4Ptr offer = srv.fake_sent_.front();
+    ASSERT_TRUE(offer);
+    EXPECT_EQ(DHCPOFFER, offer->getType());
+    OptionPtr rai_query = dis->getOption(DHO_DHCP_AGENT_OPTIONS);
+    ASSERT_TRUE(rai_query);
+    OptionPtr rai_response = offer->getOption(DHO_DHCP_AGENT_OPTIONS);
+    ASSERT_TRUE(rai_response);
+    EXPECT_TRUE(rai_response->equals(rai_query));
+}
+
+// Test checks that a query with a malformed option is dropped when its
+// options are unpacked lazily.
+TEST_F(Dhcpv4SrvTest, lazyUnpackMalformed) {
+    IfaceMgrTestConfig test_config(true);
+    NakedDhcpv4Srv srv(0);
+    configure(CONFIGS[0]);
+    srv.setLazyUnpack(true);
+
+    // Add a requested address option of 3 bytes and go through the
+    // unpack/tweak/pack cycle as pretendReceivingPkt does.
+    Pkt4Ptr dis = PktCaptures::captureRelayedDiscover();
+    dis->unpack();
+    dis->delOption(DHO_DHCP_REQUESTED_ADDRESS);
+    OptionBuffer data(3, 1);
+    dis->addOption(OptionPtr(new Option(Option::V4, DHO_DHCP_REQUESTED_ADDRESS,
+                                        data)));
+    dis->pack();
+    dis->data_.resize(dis->getBuffer().getLength());
+    memcpy(&dis->data_[0], dis->getBuffer().getData(),
+           dis->getBuffer().getLength());
+    dis->options_.clear();
+
+    srv.fakeReceive(dis);
+    srv.run();
+
+    // The query was dropped when it was unpacked.
+    EXPECT_TRUE(srv.fake_sent_.empty());
+    using namespace isc::stats;
+    ObservationPtr parse_failed =
+        StatsMgr::instance().getObservation("pkt4-parse-failed");
+    ASSERT_TRUE(parse_failed);
+    EXPECT_EQ(1, parse_failed->getInteger().first);
+}
+
 // This test verifies that the server is able to handle an empty client-id
 // in incoming client message.
 TEST_F(Dhcpv4SrvTest, emptyClientId) {
@@ -335,6 +335,23 @@ TEST(ParserTest, globalParameters) {
     EXPECT_NO_THROW(parser.checkKeywords(parser.GLOBAL4_PARAMETERS, json));
 }
 
+// Checks that the memfile specific parameters are accepted in the lease
+// database map.
+TEST(ParserTest, memfileParameters) {
+    string txt =
+        "{ \"Dhcp4\": {\n"
+        "    \"lease-database\": {\n"
+        "        \"type\": \"memfile\",\n"
+        "        \"compact\": true,\n"
+        "        \"format\": \"binary\",\n"
+        "        \"write-queue-size\": 1024,\n"
+        "        \"write-max-delay\": 100,\n"
+        "        \"write-sync\": true\n"
+        "    }\n"
+        "} }\n";
+    testParser(txt, Parser4Context::PARSER_DHCP4);
+}
+
 // Basic test that checks if it's possible to specify outbound-interface.
 TEST(ParserTest, outboundIface) {
     std::string fname = string(CFG_EXAMPLES) + "/" + "advanced.json";
@@ -614,6 +631,26 @@ TEST(ParserTest, errors) {
               "<string>:2.20-24: syntax error, unexpected boolean, "
               "expecting integer");
 
+    // bad memfile parameter type
+    testError("{ \"Dhcp4\":{\n"
+              "  \"lease-database\":{\n"
+              "  \"compact\":\"yes\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:3.13-17: syntax error, unexpected constant string, "
+              "expecting boolean");
+    testError("{ \"Dhcp4\":{\n"
+              "  \"lease-database\":{\n"
+              "  \"write-queue-size\":true }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:3.22-25: syntax error, unexpected boolean, "
+              "expecting integer");
+    testError("{ \"Dhcp4\":{\n"
+              "  \"lease-database\":{\n"
+              "  \"format\":1 }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:3.12: syntax error, unexpected integer, "
+              "expecting constant string");
+
     // unknown keyword
     testError("{ \"Dhcp4\":{\n"
               " \"valid_lifetime\":600 }}\n",
@@ -0,0 +1,595 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/duid.h>
+#include <dhcp/libdhcp++.h>
+#include <dhcp/option6_ia.h>
+#include <dhcp/option6_iaaddr.h>
+#include <dhcp/option_int_array.h>
+#include <dhcp/pkt6.h>
+#include <dhcp6/dhcp6_srv.h>
+#include <dhcp6/json_config_parser.h>
+#include <dhcp6/parser_context.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <exceptions/exceptions.h>
+#include <hooks/callout_handle.h>
+#include <hooks/hooks_manager.h>
+#include <hooks/server_hooks.h>
+#include <log/logger_support.h>
+#include <util/benchmarks/benchmark_report.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the in-process benchmark of the DHCPv6 server packet
+/// pipeline. It configures a server with a memfile lease database, feeds
+/// synthetic relayed Solicit, Request and Renew messages directly to
+/// @c Dhcpv6Srv::processPacketAndSendResponse, without sockets, and
+/// reports the latency percentiles and the packets per second of each
+/// phase and, optionally, of each stage of the processing.
+
+namespace {
+
+const char* const BENCHMARK_NAME = "kea-dhcp6-benchmark";
+
+/// @brief The address of the server.
+const IOAddress SERVER_ADDRESS("2001:db8:ffff::1");
+
+/// @brief The phases of the benchmark in the order they run.
+const char* const PHASES[] = { "solicit", "request", "renew" };
+
+/// @brief The hook points used to split the processing in stages.
+const char* const PROBE_HOOKS[] = {
+    "buffer6_receive", "pkt6_receive", "subnet6_select", "lease6_select",
+    "lease6_renew", "leases6_committed", "pkt6_send", "buffer6_send"
+};
+
+/// @brief Parameters of the benchmark.
+struct Parameters {
+    /// @brief Constructor.
+    Parameters()
+        : config_file_(), clients_(10000), subnets_(1), reservations_(0),
+          classes_(0), hooks_(), phases_(), probes_(false), json_(false) {
+    }
+
+    /// @brief The configuration file or empty to generate the configuration.
+    string config_file_;
+
+    /// @brief The number of clients.
+    size_t clients_;
+
+    /// @brief The number of generated subnets.
+    size_t subnets_;
+
+    /// @brief The number of clients with a generated host reservation.
+    size_t reservations_;
+
+    /// @brief The number of generated client classes.
+    size_t classes_;
+
+    /// @brief The hook libraries added to the generated configuration.
+    vector<string> hooks_;
+
+    /// @brief The reported phases (all when empty).
+    vector<string> phases_;
+
+    /// @brief Whether the stages are measured.
+    bool probes_;
+
+    /// @brief Whether the report is printed in JSON.
+    bool json_;
+};
+
+/// @brief Prints the usage and exits.
+///
+/// Note: This function never returns. It terminates the process.
+void
+usage() {
+    cerr << "Usage: " << BENCHMARK_NAME
+         << " [-c cfgfile] [-n clients] [-s subnets] [-r reservations]"
+         << " [-C classes] [-H library]... [-p phase[,phase]...] [-S] [-j]"
+         << endl;
+    cerr << "  -c file: use the configuration file instead of generating one;"
+         << endl
+         << "           the clients are relayed from the first address of"
+         << " each subnet" << endl;
+    cerr << "  -n number: number of clients (default 10000)" << endl;
+    cerr << "  -s number: number of generated subnets (default 1)" << endl;
+    cerr << "  -r number: number of clients with a generated host reservation"
+         << " (default 0)" << endl;
+    cerr << "  -C number: number of generated client classes, at most 256"
+         << " (default 0)" << endl;
+    cerr << "  -H file: hook library to add to the generated configuration"
+         << endl;
+    cerr << "  -p phases: comma separated phases to report among solicit,"
+         << " request and renew (default all)" << endl;
+    cerr << "  -S: measure the stages between the hook points" << endl;
+    cerr << "  -j: print the report in JSON" << endl;
+    exit(EXIT_FAILURE);
+}
+
+/// @brief Parses a number argument.
+///
+/// @param arg the argument.
+/// @return the number.
+size_t
+parseNumber(const char* arg) {
+    try {
+        return (boost::lexical_cast<size_t>(arg));
+    } catch (const boost::bad_lexical_cast&) {
+        cerr << "invalid number: " << arg << endl;
+        usage();
+    }
+}
+
+/// @brief Parses the command line.
+///
+/// @param argc the number of arguments.
+/// @param argv the arguments.
+/// @return the parameters.
+Parameters
+parseCommandLine(int argc, char* argv[]) {
+    Parameters params;
+    int ch;
+    while ((ch = getopt(argc, argv, "c:n:s:r:C:H:p:Sj")) != -1) {
+        switch (ch) {
+        case 'c':
+            params.config_file_ = optarg;
+            break;
+
+        case 'n':
+            params.clients_ = parseNumber(optarg);
+            break;
+
+        case 's':
+            params.subnets_ = parseNumber(optarg);
+            break;
+
+        case 'r':
+            params.reservations_ = parseNumber(optarg);
+            break;
+
+        case 'C':
+            params.classes_ = parseNumber(optarg);
+            break;
+
+        case 'H':
+            params.hooks_.push_back(optarg);
+            break;
+
+        case 'p': {
+            istringstream phases(optarg);
+            string phase;
+            while (getline(phases, phase, ',')) {
+                if (find(begin(PHASES), end(PHASES), phase) == end(PHASES)) {
+                    cerr << "unknown phase: " << phase << endl;
+                    usage();
+                }
+                params.phases_.push_back(phase);
+            }
+            break;
+        }
+
+        case 'S':
+            params.probes_ = true;
+            break;
+
+        case 'j':
+            params.json_ = true;
+            break;
+
+        default:
+            usage();
+        }
+    }
+    if (argc > optind) {
+        usage();
+    }
+    if ((params.clients_ == 0) || (params.subnets_ == 0) ||
+        (params.reservations_ > params.clients_) || (params.classes_ > 256)) {
+        usage();
+    }
+    if (params.phases_.empty()) {
+        params.phases_.assign(begin(PHASES), end(PHASES));
+    }
+    return (params);
+}
+
+/// @brief Returns the DUID of a client.
+///
+/// The DUID is a DUID-LL with a hardware address which last byte is
+/// the class of the client.
+///
+/// @param params the parameters.
+/// @param client the index of the client.
+/// @return the DUID.
+vector<uint8_t>
+getDuid(const Parameters& params, size_t client) {
+    uint8_t cclass = (params.classes_ ? client % params.classes_ : 0);
+    return (vector<uint8_t>{ 0x00, 0x03, 0x00, HTYPE_ETHER,
+                             0x02, static_cast<uint8_t>(client >> 24),
+                             static_cast<uint8_t>(client >> 16),
+                             static_cast<uint8_t>(client >> 8),
+                             static_cast<uint8_t>(client), cclass });
+}
+
+/// @brief Returns the generated configuration.
+///
+/// The subnets are 2001:db8:<index>::/64 with a pool in their first
+/// /80 and the reservations in their second /80.
+///
+/// @param params the parameters.
+/// @return the configuration in JSON.
+string
+makeConfig(const Parameters& params) {
+    if (params.subnets_ > 0xffff) {
+        isc_throw(BadValue, "too many subnets");
+    }
+    ostringstream s;
+    s << "{ \"Dhcp6\": {" << endl
+      << "  \"interfaces-config\": { \"interfaces\": [ ], \"re-detect\": false },"
+      << endl
+      << "  \"lease-database\": { \"type\": \"memfile\", \"persist\": false,"
+      << " \"lfc-interval\": 0 }," << endl
+      << "  \"multi-threading\": { \"enable-multi-threading\": false }," << endl
+      << "  \"preferred-lifetime\": 3000," << endl
+      << "  \"valid-lifetime\": 4000," << endl
+      << "  \"option-data\": [" << endl
+      << "    { \"name\": \"dns-servers\","
+      << " \"data\": \"2001:db8:ffff::53, 2001:db8:ffff::54\" }" << endl
+      << "  ]," << endl;
+    if (params.classes_) {
+        s << "  \"client-classes\": [";
+        for (size_t i = 0; i < params.classes_; ++i) {
+            s << (i ? "," : "") << endl
+              << "    { \"name\": \"bench-" << i << "\","
+              << " \"test\": \"substring(option[1].hex, 9, 1) == 0x"
+              << hex << setw(2) << setfill('0') << i << setfill(' ') << "\","
+              << " \"option-data\": [ { \"name\": \"sntp-servers\","
+              << " \"data\": \"2001:db8:fffe::" << i << dec << "\" } ] }";
+        }
+        s << " ]," << endl;
+    }
+    if (!params.hooks_.empty()) {
+        s << "  \"hooks-libraries\": [";
+        for (size_t i = 0; i < params.hooks_.size(); ++i) {
+            s << (i ? ", " : " ") << "{ \"library\": "
+              << BenchmarkReport::quote(params.hooks_[i]) << " }";
+        }
+        s << " ]," << endl;
+    }
+    s << "  \"subnet6\": [";
+    for (size_t i = 0; i < params.subnets_; ++i) {
+        s << (i ? "," : "") << endl << hex
+          << "    { \"id\": " << dec << (i + 1) << hex
+          << ", \"subnet\": \"2001:db8:" << i << "::/64\","
+          << " \"pools\": [ { \"pool\": \"2001:db8:" << i << "::/80\" } ],"
+          << endl
+          << "      \"option-data\": [ { \"name\": \"domain-search\","
+          << " \"data\": \"subnet" << i << ".example.org\" } ]," << endl
+          << "      \"reservations\": [";
+        bool first = true;
+        for (size_t client = i; client < params.reservations_;
+             client += params.subnets_) {
+            size_t host = client / params.subnets_ + 1;
+            s << (first ? " " : ", ") << "{ \"duid\": \""
+              << DUID(getDuid(params, client)).toText() << "\","
+              << " \"ip-addresses\": [ \"2001:db8:" << i << ":0:1::"
+              << (host >> 16) << ":" << (host & 0xffff) << "\" ] }";
+            first = false;
+        }
+        s << " ] }" << dec;
+    }
+    s << " ]" << endl << "} }" << endl;
+    return (s.str());
+}
+
+/// @brief Configures the server.
+///
+/// @param srv the server.
+/// @param params the parameters.
+void
+configure(Dhcpv6Srv& srv, const Parameters& params) {
+    Parser6Context parser;
+    ElementPtr json;
+    if (params.config_file_.empty()) {
+        json = parser.parseString(makeConfig(params), Parser6Context::PARSER_DHCP6);
+    } else {
+        json = parser.parseFile(params.config_file_, Parser6Context::PARSER_DHCP6);
+    }
+    if (!json || (json->getType() != Element::map) || !json->get("Dhcp6")) {
+        isc_throw(BadValue, "the configuration has no Dhcp6 entry");
+    }
+    ConstElementPtr answer = configureDhcp6Server(srv, json->get("Dhcp6"));
+    int rcode;
+    ConstElementPtr comment = parseAnswer(rcode, answer);
+    if (rcode != CONTROL_RESULT_SUCCESS) {
+        isc_throw(BadValue, "configuration failed: "
+                  << (comment ? comment->stringValue() : "no details"));
+    }
+    CfgDbAccessPtr cfg_db = CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    cfg_db->setAppendedParameters("universe=6");
+    cfg_db->createManagers();
+    CfgMgr::instance().commit();
+    LibDHCP::commitRuntimeOptionDefs();
+}
+
+/// @brief Server sending the responses nowhere.
+class BenchmarkDhcpv6Srv : public Dhcpv6Srv {
+public:
+    /// @brief Constructor.
+    ///
+    /// Port 0 does not open sockets.
+    BenchmarkDhcpv6Srv() : Dhcpv6Srv(0, 0), response_() {
+    }
+
+    /// @brief Keeps the response instead of sending it.
+    ///
+    /// @param pkt the response.
+    virtual void sendPacket(const Pkt6Ptr& pkt) {
+        response_ = pkt;
+    }
+
+    /// @brief The last response.
+    Pkt6Ptr response_;
+};
+
+/// @brief A time mark at a hook point.
+struct ProbeMark {
+    /// @brief The index of the hook point.
+    int hook_;
+
+    /// @brief The time.
+    chrono::steady_clock::time_point time_;
+};
+
+/// @brief The time marks of the packet being processed.
+vector<ProbeMark> probe_marks;
+
+/// @brief Callout recording a time mark.
+///
+/// @param handle the callout handle.
+/// @return 0.
+int
+probe(CalloutHandle& handle) {
+    probe_marks.push_back({ handle.getCurrentHook(), chrono::steady_clock::now() });
+    return (0);
+}
+
+/// @brief Registers the probe at all the hook points.
+void
+registerProbes() {
+    probe_marks.reserve(2 * sizeof(PROBE_HOOKS) / sizeof(PROBE_HOOKS[0]));
+    for (auto const& hook : PROBE_HOOKS) {
+        HooksManager::preCalloutsLibraryHandle().registerCallout(hook, probe);
+    }
+}
+
+/// @brief State of a client.
+struct Client {
+    /// @brief The client identifier option.
+    OptionPtr client_id_;
+
+    /// @brief The link address of the relay.
+    IOAddress linkaddr_;
+
+    /// @brief The IA_NA from the last response.
+    OptionPtr ia_;
+
+    /// @brief The server identifier from the last response.
+    OptionPtr server_id_;
+};
+
+/// @brief Returns the on-wire format of a query of a client.
+///
+/// @param client the client.
+/// @param type the message type.
+/// @param transid the transaction id.
+/// @return the query.
+vector<uint8_t>
+makeQuery(const Client& client, uint8_t type, uint32_t transid) {
+    Pkt6Ptr query(new Pkt6(type, transid));
+    query->addOption(client.client_id_);
+    OptionUint16ArrayPtr oro(new OptionUint16Array(Option::V6, D6O_ORO));
+    oro->addValue(D6O_NAME_SERVERS);
+    oro->addValue(D6O_DOMAIN_SEARCH);
+    oro->addValue(D6O_SNTP_SERVERS);
+    query->addOption(oro);
+    if ((type != DHCPV6_SOLICIT) && client.ia_ && client.server_id_) {
+        // Request or renew the address from the last response.
+        query->addOption(client.server_id_);
+        query->addOption(client.ia_);
+    } else {
+        query->addOption(OptionPtr(new Option6IA(D6O_IA_NA, 1)));
+    }
+    Pkt6::RelayInfo relay;
+    relay.msg_type_ = DHCPV6_RELAY_FORW;
+    relay.hop_count_ = 0;
+    relay.linkaddr_ = client.linkaddr_;
+    relay.peeraddr_ = IOAddress("fe80::1");
+    query->addRelayInfo(relay);
+    query->pack();
+    const uint8_t* data = static_cast<const uint8_t*>(query->getBuffer().getData());
+    return (vector<uint8_t>(data, data + query->getBuffer().getLength()));
+}
+
+/// @brief Runs a phase.
+///
+/// @param srv the server.
+/// @param clients the clients.
+/// @param type the message type of the queries.
+/// @param name the name of the phase.
+/// @param report the report or null when the phase is not reported.
+void
+runPhase(BenchmarkDhcpv6Srv& srv, vector<Client>& clients, uint8_t type,
+         const string& name, BenchmarkReport* report) {
+    vector<vector<uint8_t>> queries;
+    queries.reserve(clients.size());
+    for (size_t i = 0; i < clients.size(); ++i) {
+        queries.push_back(makeQuery(clients[i], type, i + 1));
+    }
+
+    LatencyStats total;
+    vector<string> stage_names;
+    map<string, LatencyStats> stages;
+    size_t responses = 0;
+    auto phase_start = chrono::steady_clock::now();
+    for (size_t i = 0; i < clients.size(); ++i) {
+        srv.response_.reset();
+        probe_marks.clear();
+        auto start = chrono::steady_clock::now();
+        Pkt6Ptr query(new Pkt6(&queries[i][0], queries[i].size()));
+        query->setRemoteAddr(clients[i].linkaddr_);
+        query->setLocalAddr(SERVER_ADDRESS);
+        query->setRemotePort(DHCP6_SERVER_PORT);
+        query->setLocalPort(DHCP6_SERVER_PORT);
+        query->setIface("eth0");
+        query->setIndex(1);
+        srv.processPacketAndSendResponseNoThrow(query);
+        auto end = chrono::steady_clock::now();
+        total.add(end - start);
+
+        // Split the processing at the hook points.
+        auto previous = start;
+        for (auto const& mark : probe_marks) {
+            string stage = ServerHooks::getServerHooks().getName(mark.hook_);
+            if (stages.count(stage) == 0) {
+                stage_names.push_back(stage);
+            }
+            stages[stage].add(mark.time_ - previous);
+            previous = mark.time_;
+        }
+        if (!probe_marks.empty()) {
+            if (stages.count("end") == 0) {
+                stage_names.push_back("end");
+            }
+            stages["end"].add(end - previous);
+        }
+
+        Pkt6Ptr response = srv.response_;
+        if (!response) {
+            continue;
+        }
+        uint8_t expected = (type == DHCPV6_SOLICIT ? DHCPV6_ADVERTISE :
+                            DHCPV6_REPLY);
+        if (response->getType() != expected) {
+            continue;
+        }
+        ++responses;
+        clients[i].ia_ = response->getOption(D6O_IA_NA);
+        clients[i].server_id_ = response->getOption(D6O_SERVERID);
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() -
+                                              phase_start).count();
+
+    if (report) {
+        report->addParameter(name + "-responses", to_string(responses));
+        report->addResult(name + "/total", total, clients.size() / elapsed);
+        for (auto const& stage : stage_names) {
+            report->addResult(name + "/" + stage, stages[stage]);
+        }
+    }
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    Parameters params = parseCommandLine(argc, argv);
+
+    try {
+        isc::log::initLogger(BENCHMARK_NAME, isc::log::ERROR,
+                             isc::log::MAX_DEBUG_LEVEL, NULL, false);
+        CfgMgr::instance().setFamily(AF_INET6);
+
+        BenchmarkDhcpv6Srv srv;
+        configure(srv, params);
+        if (params.probes_) {
+            registerProbes();
+        }
+
+        // Relay the clients from the first address of the subnets.
+        auto subnets = CfgMgr::instance().getCurrentCfg()->getCfgSubnets6()->getAll();
+        if (subnets->empty()) {
+            isc_throw(BadValue, "the configuration has no subnet");
+        }
+        vector<IOAddress> relays;
+        for (auto const& subnet : *subnets) {
+            relays.push_back(IOAddress::increase(subnet->get().first));
+        }
+        vector<Client> clients;
+        clients.reserve(params.clients_);
+        for (size_t i = 0; i < params.clients_; ++i) {
+            Client client = {
+                OptionPtr(new Option(Option::V6, D6O_CLIENTID, getDuid(params, i))),
+                relays[i % relays.size()], OptionPtr(), OptionPtr()
+            };
+            clients.push_back(client);
+        }
+
+        BenchmarkReport report("kea-dhcp6 packet pipeline");
+        report.addParameter("configuration", params.config_file_.empty() ?
+                            "generated" : params.config_file_);
+        report.addParameter("clients", to_string(params.clients_));
+        report.addParameter("subnets", to_string(subnets->size()));
+        if (params.config_file_.empty()) {
+            report.addParameter("reservations", to_string(params.reservations_));
+            report.addParameter("classes", to_string(params.classes_));
+            report.addParameter("hooks-libraries", to_string(params.hooks_.size()));
+        }
+        report.addParameter("stages", params.probes_ ? "yes" : "no");
+#ifdef ENABLE_PACKET_ARENA
+        report.addParameter("packet-arena", "yes");
+#else
+        report.addParameter("packet-arena", "no");
+#endif
+
+        // Run the phases up to the last reported one.
+        size_t last = 0;
+        for (size_t i = 0; i < sizeof(PHASES) / sizeof(PHASES[0]); ++i) {
+            if (find(params.phases_.begin(), params.phases_.end(), PHASES[i]) !=
+                params.phases_.end()) {
+                last = i;
+            }
+        }
+        const uint8_t types[] = { DHCPV6_SOLICIT, DHCPV6_REQUEST, DHCPV6_RENEW };
+        for (size_t i = 0; i <= last; ++i) {
+            bool reported = (find(params.phases_.begin(), params.phases_.end(),
+                                  PHASES[i]) != params.phases_.end());
+            runPhase(srv, clients, types[i], PHASES[i], reported ? &report : 0);
+        }
+
+        report.print(cout, params.json_ ? BenchmarkReport::JSON :
+                     BenchmarkReport::TEXT);
+
+        HooksManager::prepareUnloadLibraries();
+        static_cast<void>(HooksManager::unloadLibraries());
+    } catch (const std::exception& ex) {
+        cerr << BENCHMARK_NAME << ": " << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+    return (EXIT_SUCCESS);
+}
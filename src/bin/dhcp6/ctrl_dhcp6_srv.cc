@@ -14,6 +14,7 @@
 #include <config/http_command_mgr.h>
 #include <config/unix_command_mgr.h>
 #include <cryptolink/crypto_hash.h>
+#include <database/database_connection.h>
 #include <dhcp/libdhcp++.h>
 #include <dhcp6/ctrl_dhcp6_srv.h>
 #include <dhcp6/dhcp6_log.h>
@@ -1140,9 +1141,37 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
 
     // Initialize the allocators. If the user selected a Free Lease Queue Allocator
     // for any of the subnets, the server will now populate free leases to the queue.
-    // It may take a while!
+    // It may take a while! The free leases of different subnets are populated in
+    // parallel when multi-threading is enabled, and the free leases of the pools
+    // which did not change are taken from the current configuration when the
+    // lease database did not change.
     try {
-        CfgMgr::instance().getStagingCfg()->getCfgSubnets6()->initAllocatorsAfterConfigure();
+        auto staging_cfg = CfgMgr::instance().getStagingCfg();
+        auto current_cfg = CfgMgr::instance().getCurrentCfg();
+        bool enabled = false;
+        uint32_t thread_count = 0;
+        uint32_t queue_size = 0;
+        CfgMultiThreading::extract(staging_cfg->getDHCPMultiThreading(),
+                                   enabled, thread_count, queue_size);
+        if (!enabled) {
+            thread_count = 0;
+        } else if (!thread_count) {
+            thread_count = MultiThreadingMgr::detectThreadCount();
+        }
+        ConstCfgSubnets6Ptr previous;
+        auto access = staging_cfg->getCfgDbAccess()->getLeaseDbAccessString();
+        if (access == current_cfg->getCfgDbAccess()->getLeaseDbAccessString()) {
+            // The leases of a memfile backend which does not persist them
+            // are lost when the lease manager is recreated.
+            auto parameters = DatabaseConnection::parse(access);
+            auto persist = parameters.find("persist");
+            if ((parameters["type"] != "memfile") ||
+                (persist == parameters.end()) || (persist->second != "false")) {
+                previous = current_cfg->getCfgSubnets6();
+            }
+        }
+        staging_cfg->getCfgSubnets6()->initAllocatorsAfterConfigure(thread_count,
+                                                                      previous);
 
     } catch (const std::exception& ex) {
         err << "Error initializing the lease allocators: "
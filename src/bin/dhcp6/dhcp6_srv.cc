@@ -72,6 +72,7 @@
 #include <dhcpsrv/subnet_selector.h>
 #include <dhcpsrv/utils.h>
 #include <eval/evaluate.h>
+#include <eval/extraction_cache.h>
 #include <eval/token.h>
 #include <exceptions/exceptions.h>
 #include <hooks/callout_handle.h>
@@ -88,6 +89,7 @@
 #include <util/buffer.h>
 #include <util/multi_threading_mgr.h>
 #include <util/optional.h>
+#include <util/packet_arena.h>
 #include <util/pointer_util.h>
 #include <util/readwrite_mutex.h>
 #include <util/thread_pool.h>
@@ -146,7 +148,11 @@ struct Dhcp6Hooks {
     int hook_index_host6_identifier_; ///< index for "host6_identifier" hook point
     int hook_index_ddns6_update_;     ///< index for "ddns6_update" hook point
 
-    /// Constructor that registers hook points for DHCPv6 engine
+    int arg_index_query6_;            ///< index for "query6" argument
+    int arg_index_response6_;         ///< index for "response6" argument
+    int arg_index_subnet6_;           ///< index for "subnet6" argument
+
+    /// Constructor that registers hook points and arguments for DHCPv6 engine
     Dhcp6Hooks() {
         hook_index_buffer6_receive_   = HooksManager::registerHook("buffer6_receive");
         hook_index_pkt6_receive_      = HooksManager::registerHook("pkt6_receive");
@@ -158,6 +164,10 @@ struct Dhcp6Hooks {
         hook_index_lease6_decline_    = HooksManager::registerHook("lease6_decline");
         hook_index_host6_identifier_  = HooksManager::registerHook("host6_identifier");
         hook_index_ddns6_update_      = HooksManager::registerHook("ddns6_update");
+
+        arg_index_query6_             = HooksManager::registerArgument("query6");
+        arg_index_response6_          = HooksManager::registerArgument("response6");
+        arg_index_subnet6_            = HooksManager::registerArgument("subnet6");
     }
 };
 
@@ -167,6 +177,58 @@ struct Dhcp6Hooks {
 // module is called.
 Dhcp6Hooks Hooks;
 
+/// Structure that holds the counters of the statistics updated for every
+/// packet: they are resolved once so the packet processing does not look
+/// the statistics up by name nor take the Statistics Manager lock.
+struct Dhcp6Counters {
+    StatCounterPtr pkt6_received_;                 ///< "pkt6-received" counter
+    StatCounterPtr pkt6_solicit_received_;         ///< "pkt6-solicit-received" counter
+    StatCounterPtr pkt6_advertise_received_;       ///< "pkt6-advertise-received" counter
+    StatCounterPtr pkt6_request_received_;         ///< "pkt6-request-received" counter
+    StatCounterPtr pkt6_confirm_received_;         ///< "pkt6-confirm-received" counter
+    StatCounterPtr pkt6_renew_received_;           ///< "pkt6-renew-received" counter
+    StatCounterPtr pkt6_rebind_received_;          ///< "pkt6-rebind-received" counter
+    StatCounterPtr pkt6_reply_received_;           ///< "pkt6-reply-received" counter
+    StatCounterPtr pkt6_release_received_;         ///< "pkt6-release-received" counter
+    StatCounterPtr pkt6_decline_received_;         ///< "pkt6-decline-received" counter
+    StatCounterPtr pkt6_reconfigure_received_;     ///< "pkt6-reconfigure-received" counter
+    StatCounterPtr pkt6_infrequest_received_;      ///< "pkt6-infrequest-received" counter
+    StatCounterPtr pkt6_dhcpv4_query_received_;    ///< "pkt6-dhcpv4-query-received" counter
+    StatCounterPtr pkt6_dhcpv4_response_received_; ///< "pkt6-dhcpv4-response-received" counter
+    StatCounterPtr pkt6_unknown_received_;         ///< "pkt6-unknown-received" counter
+    StatCounterPtr pkt6_sent_;                     ///< "pkt6-sent" counter
+    StatCounterPtr pkt6_advertise_sent_;           ///< "pkt6-advertise-sent" counter
+    StatCounterPtr pkt6_reply_sent_;               ///< "pkt6-reply-sent" counter
+    StatCounterPtr pkt6_dhcpv4_response_sent_;     ///< "pkt6-dhcpv4-response-sent" counter
+
+    /// Constructor that resolves the counters
+    Dhcp6Counters() {
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        pkt6_received_                 = stats_mgr.getCounter("pkt6-received");
+        pkt6_solicit_received_         = stats_mgr.getCounter("pkt6-solicit-received");
+        pkt6_advertise_received_       = stats_mgr.getCounter("pkt6-advertise-received");
+        pkt6_request_received_         = stats_mgr.getCounter("pkt6-request-received");
+        pkt6_confirm_received_         = stats_mgr.getCounter("pkt6-confirm-received");
+        pkt6_renew_received_           = stats_mgr.getCounter("pkt6-renew-received");
+        pkt6_rebind_received_          = stats_mgr.getCounter("pkt6-rebind-received");
+        pkt6_reply_received_           = stats_mgr.getCounter("pkt6-reply-received");
+        pkt6_release_received_         = stats_mgr.getCounter("pkt6-release-received");
+        pkt6_decline_received_         = stats_mgr.getCounter("pkt6-decline-received");
+        pkt6_reconfigure_received_     = stats_mgr.getCounter("pkt6-reconfigure-received");
+        pkt6_infrequest_received_      = stats_mgr.getCounter("pkt6-infrequest-received");
+        pkt6_dhcpv4_query_received_    = stats_mgr.getCounter("pkt6-dhcpv4-query-received");
+        pkt6_dhcpv4_response_received_ = stats_mgr.getCounter("pkt6-dhcpv4-response-received");
+        pkt6_unknown_received_         = stats_mgr.getCounter("pkt6-unknown-received");
+        pkt6_sent_                     = stats_mgr.getCounter("pkt6-sent");
+        pkt6_advertise_sent_           = stats_mgr.getCounter("pkt6-advertise-sent");
+        pkt6_reply_sent_               = stats_mgr.getCounter("pkt6-reply-sent");
+        pkt6_dhcpv4_response_sent_     = stats_mgr.getCounter("pkt6-dhcpv4-response-sent");
+    }
+};
+
+// Declare the packet statistic counters.
+Dhcp6Counters Counters;
+
 /// @brief Creates instance of the Status Code option.
 ///
 /// This variant of the function is used when the Status Code option
@@ -442,7 +504,7 @@ Dhcpv6Srv::setHostIdentifiers(AllocEngine::ClientContext6& ctx) {
                 ScopedCalloutHandleState callout_handle_state(callout_handle);
 
                 // Pass incoming packet as argument
-                callout_handle->setArgument("query6", ctx.query_);
+                callout_handle->setArgument(Hooks.arg_index_query6_, ctx.query_);
                 callout_handle->setArgument("id_type", type);
                 callout_handle->setArgument("id_value", id);
 
@@ -727,7 +789,7 @@ Dhcpv6Srv::runOne() {
             // any failures in unpacking will cause the packet to be dropped.
             // we will increase type specific packets further down the road.
             // See processStatsReceived().
-            StatsMgr::instance().addValue("pkt6-received", static_cast<int64_t>(1));
+            Counters.pkt6_received_->add();
         }
 
         // We used to log that the wait was interrupted, but this is no longer
@@ -791,6 +853,10 @@ Dhcpv6Srv::processPacketAndSendResponseNoThrow(Pkt6Ptr query) {
 
 void
 Dhcpv6Srv::processPacketAndSendResponse(Pkt6Ptr query) {
+#ifdef ENABLE_PACKET_ARENA
+    // Allocate the objects created by the processing from a packet arena.
+    PacketArenaScope arena;
+#endif
     Pkt6Ptr rsp = processPacket(query);
     if (!rsp) {
         return;
@@ -824,7 +890,7 @@ Dhcpv6Srv::processPacket(Pkt6Ptr query) {
         ScopedEnableOptionsCopy<Pkt6> query6_options_copy(query);
 
         // Pass incoming packet as argument
-        callout_handle->setArgument("query6", query);
+        callout_handle->setArgument(Hooks.arg_index_query6_, query);
 
         // Call callouts
         HooksManager::callCallouts(Hooks.hook_index_buffer6_receive_, *callout_handle);
@@ -858,7 +924,7 @@ Dhcpv6Srv::processPacket(Pkt6Ptr query) {
             return (Pkt6Ptr());
         }
 
-        callout_handle->getArgument("query6", query);
+        callout_handle->getArgument(Hooks.arg_index_query6_, query);
         if (!query) {
             // Please use the status instead of resetting query!
             return (Pkt6Ptr());
@@ -956,7 +1022,7 @@ Dhcpv6Srv::processPacket(Pkt6Ptr query) {
         ScopedEnableOptionsCopy<Pkt6> query6_options_copy(query);
 
         // Pass incoming packet as argument
-        callout_handle->setArgument("query6", query);
+        callout_handle->setArgument(Hooks.arg_index_query6_, query);
 
         // Call callouts
         HooksManager::callCallouts(Hooks.hook_index_pkt6_receive_, *callout_handle);
@@ -976,7 +1042,7 @@ Dhcpv6Srv::processPacket(Pkt6Ptr query) {
             return (Pkt6Ptr());
         }
 
-        callout_handle->getArgument("query6", query);
+        callout_handle->getArgument(Hooks.arg_index_query6_, query);
         if (!query) {
             // Please use the status instead of resetting query!
             return (Pkt6Ptr());
@@ -1003,6 +1069,10 @@ Dhcpv6Srv::processPacket(Pkt6Ptr query) {
 
 void
 Dhcpv6Srv::processDhcp6QueryAndSendResponse(Pkt6Ptr query) {
+#ifdef ENABLE_PACKET_ARENA
+    // Allocate the objects created by the processing from a packet arena.
+    PacketArenaScope arena;
+#endif
     try {
         Pkt6Ptr rsp = processDhcp6Query(query);
         if (!rsp) {
@@ -1245,7 +1315,7 @@ Dhcpv6Srv::processLocalizedQuery6(AllocEngine::ClientContext6& ctx) {
         ScopedEnableOptionsCopy<Pkt6> query6_options_copy(query);
 
         // Also pass the corresponding query packet as argument
-        callout_handle->setArgument("query6", query);
+        callout_handle->setArgument(Hooks.arg_index_query6_, query);
 
         Lease6CollectionPtr new_leases(new Lease6Collection());
         if (!ctx.new_leases_.empty()) {
@@ -1412,13 +1482,13 @@ Dhcpv6Srv::processPacketPktSend(hooks::CalloutHandlePtr& callout_handle,
         ScopedEnableOptionsCopy<Pkt6> query_resp_options_copy(query, rsp);
 
         // Pass incoming packet as argument
-        callout_handle->setArgument("query6", query);
+        callout_handle->setArgument(Hooks.arg_index_query6_, query);
 
         // Set our response
-        callout_handle->setArgument("response6", rsp);
+        callout_handle->setArgument(Hooks.arg_index_response6_, rsp);
 
         // Pass the selected subnet as an argument.
-        callout_handle->setArgument("subnet6", subnet);
+        callout_handle->setArgument(Hooks.arg_index_subnet6_, subnet);
 
         // Call all installed callouts
         HooksManager::callCallouts(Hooks.hook_index_pkt6_send_, *callout_handle);
@@ -1481,7 +1551,7 @@ Dhcpv6Srv::processPacketBufferSend(CalloutHandlePtr& callout_handle,
             ScopedEnableOptionsCopy<Pkt6> response6_options_copy(rsp);
 
             // Pass incoming packet as argument
-            callout_handle->setArgument("response6", rsp);
+            callout_handle->setArgument(Hooks.arg_index_response6_, rsp);
 
             // Call callouts
             HooksManager::callCallouts(Hooks.hook_index_buffer6_send_,
@@ -1498,7 +1568,7 @@ Dhcpv6Srv::processPacketBufferSend(CalloutHandlePtr& callout_handle,
                 return;
             }
 
-            callout_handle->getArgument("response6", rsp);
+            callout_handle->getArgument(Hooks.arg_index_response6_, rsp);
         }
 
         LOG_INFO(packet6_logger, DHCP6_PACKET_SEND)
@@ -2104,8 +2174,8 @@ Dhcpv6Srv::selectSubnet(const Pkt6Ptr& question, bool& drop) {
         ScopedEnableOptionsCopy<Pkt6> query6_options_copy(question);
 
         // Set new arguments
-        callout_handle->setArgument("query6", question);
-        callout_handle->setArgument("subnet6", subnet);
+        callout_handle->setArgument(Hooks.arg_index_query6_, question);
+        callout_handle->setArgument(Hooks.arg_index_subnet6_, subnet);
 
         // We pass pointer to const collection for performance reasons.
         // Otherwise we would get a non-trivial performance penalty each
@@ -2184,7 +2254,7 @@ Dhcpv6Srv::selectSubnet(const Pkt6Ptr& question, bool& drop) {
         }
 
         // Use whatever subnet was specified by the callout
-        callout_handle->getArgument("subnet6", subnet);
+        callout_handle->getArgument(Hooks.arg_index_subnet6_, subnet);
     }
 
     if (subnet) {
@@ -2343,9 +2413,9 @@ Dhcpv6Srv::processClientFqdn(const Pkt6Ptr& question, const Pkt6Ptr& answer,
 
         // Setup the callout arguments.
         ConstSubnet6Ptr subnet = ctx.subnet_;
-        callout_handle->setArgument("query6", question);
-        callout_handle->setArgument("response6", answer);
-        callout_handle->setArgument("subnet6", subnet);
+        callout_handle->setArgument(Hooks.arg_index_query6_, question);
+        callout_handle->setArgument(Hooks.arg_index_response6_, answer);
+        callout_handle->setArgument(Hooks.arg_index_subnet6_, subnet);
         callout_handle->setArgument("hostname", ctx.hostname_);
         callout_handle->setArgument("fwd-update", ctx.fwd_dns_update_);
         callout_handle->setArgument("rev-update", ctx.rev_dns_update_);
@@ -3435,7 +3505,7 @@ Dhcpv6Srv::releaseIA_NA(const DuidPtr& duid, const Pkt6Ptr& query,
         callout_handle->deleteAllArguments();
 
         // Pass the original packet
-        callout_handle->setArgument("query6", query);
+        callout_handle->setArgument(Hooks.arg_index_query6_, query);
 
         // Pass the lease to be updated
         callout_handle->setArgument("lease6", lease);
@@ -3646,7 +3716,7 @@ Dhcpv6Srv::releaseIA_PD(const DuidPtr& duid, const Pkt6Ptr& query,
         ScopedEnableOptionsCopy<Pkt6> query6_options_copy(query);
 
         // Pass the original packet
-        callout_handle->setArgument("query6", query);
+        callout_handle->setArgument(Hooks.arg_index_query6_, query);
 
         // Pass the lease to be updated
         callout_handle->setArgument("lease6", lease);
@@ -4309,7 +4379,7 @@ Dhcpv6Srv::declineLease(const Pkt6Ptr& decline, const Lease6Ptr lease,
         ScopedEnableOptionsCopy<Pkt6> query6_options_copy(decline);
 
         // Pass the original packet
-        callout_handle->setArgument("query6", decline);
+        callout_handle->setArgument(Hooks.arg_index_query6_, decline);
 
         // Pass the lease to be updated
         callout_handle->setArgument("lease6", lease);
@@ -4488,7 +4558,11 @@ void Dhcpv6Srv::evaluateClasses(const Pkt6Ptr& pkt, bool depend_on_known) {
     // Note getClientClassDictionary() cannot be null
     const ClientClassDictionaryPtr& dict =
         CfgMgr::instance().getCurrentCfg()->getClientClassDictionary();
-    const ClientClassDefListPtr& defs_ptr = dict->getClasses();
+    // Only the classes with a match expression: the template subclass
+    // definitions are skipped.
+    const ClientClassDefListPtr& defs_ptr = dict->getEvaluatedClasses();
+    // Extract the data shared by the expressions once.
+    ExtractionCache cache;
     for (auto const& it : *defs_ptr) {
         // Note second cannot be null
         const ExpressionPtr& expr_ptr = it->getMatchExpr();
@@ -4594,6 +4668,8 @@ Dhcpv6Srv::evaluateAdditionalClasses(const Pkt6Ptr& pkt, AllocEngine::ClientCont
     // Note getClientClassDictionary() cannot be null
     const ClientClassDictionaryPtr& dict =
         CfgMgr::instance().getCurrentCfg()->getClientClassDictionary();
+    // Extract the data shared by the expressions once.
+    ExtractionCache cache;
     for (auto const& cclass : classes) {
         const ClientClassDefPtr class_def = dict->findClass(cclass);
         if (!class_def) {
@@ -4615,7 +4691,9 @@ Dhcpv6Srv::evaluateAdditionalClasses(const Pkt6Ptr& pkt, AllocEngine::ClientCont
         // Evaluate the expression which can return false (no match),
         // true (match) or raise an exception (error)
         try {
-            bool status = evaluateBool(*expr_ptr, *pkt);
+            auto const& compiled_expr = class_def->getCompiledMatchExpr();
+            bool status = (compiled_expr ? compiled_expr->evaluateBool(*pkt) :
+                           evaluateBool(*expr_ptr, *pkt));
             LOG_DEBUG(dhcp6_logger, DBG_DHCP6_DETAIL, DHCP6_ADDITIONAL_CLASS_EVAL_RESULT)
                 .arg(pkt->getLabel())
                 .arg(cclass)
@@ -4873,79 +4951,78 @@ void Dhcpv6Srv::processStatsReceived(const Pkt6Ptr& query) {
     // Note that we're not bumping pkt6-received statistic as it was
     // increased early in the packet reception code.
 
-    string stat_name = "pkt6-unknown-received";
+    // Use a raw pointer: copying the shared pointer would make the
+    // threads compete on its reference count.
+    StatCounter* counter = Counters.pkt6_unknown_received_.get();
     switch (query->getType()) {
     case DHCPV6_SOLICIT:
-        stat_name = "pkt6-solicit-received";
+        counter = Counters.pkt6_solicit_received_.get();
         break;
     case DHCPV6_ADVERTISE:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-advertise-received";
+        counter = Counters.pkt6_advertise_received_.get();
         break;
     case DHCPV6_REQUEST:
-        stat_name = "pkt6-request-received";
+        counter = Counters.pkt6_request_received_.get();
         break;
     case DHCPV6_CONFIRM:
-        stat_name = "pkt6-confirm-received";
+        counter = Counters.pkt6_confirm_received_.get();
         break;
     case DHCPV6_RENEW:
-        stat_name = "pkt6-renew-received";
+        counter = Counters.pkt6_renew_received_.get();
         break;
     case DHCPV6_REBIND:
-        stat_name = "pkt6-rebind-received";
+        counter = Counters.pkt6_rebind_received_.get();
         break;
     case DHCPV6_REPLY:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-reply-received";
+        counter = Counters.pkt6_reply_received_.get();
         break;
     case DHCPV6_RELEASE:
-        stat_name = "pkt6-release-received";
+        counter = Counters.pkt6_release_received_.get();
         break;
     case DHCPV6_DECLINE:
-        stat_name = "pkt6-decline-received";
+        counter = Counters.pkt6_decline_received_.get();
         break;
     case DHCPV6_RECONFIGURE:
-        stat_name = "pkt6-reconfigure-received";
+        counter = Counters.pkt6_reconfigure_received_.get();
         break;
     case DHCPV6_INFORMATION_REQUEST:
-        stat_name = "pkt6-infrequest-received";
+        counter = Counters.pkt6_infrequest_received_.get();
         break;
     case DHCPV6_DHCPV4_QUERY:
-        stat_name = "pkt6-dhcpv4-query-received";
+        counter = Counters.pkt6_dhcpv4_query_received_.get();
         break;
     case DHCPV6_DHCPV4_RESPONSE:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-dhcpv4-response-received";
+        counter = Counters.pkt6_dhcpv4_response_received_.get();
         break;
     default:
             ; // do nothing
     }
 
-    StatsMgr::instance().addValue(stat_name, static_cast<int64_t>(1));
+    counter->add();
 }
 
 void Dhcpv6Srv::processStatsSent(const Pkt6Ptr& response) {
     // Increase generic counter for sent packets.
-    StatsMgr::instance().addValue("pkt6-sent", static_cast<int64_t>(1));
+    Counters.pkt6_sent_->add();
 
     // Increase packet type specific counter for packets sent.
-    string stat_name;
     switch (response->getType()) {
     case DHCPV6_ADVERTISE:
-        stat_name = "pkt6-advertise-sent";
+        Counters.pkt6_advertise_sent_->add();
         break;
     case DHCPV6_REPLY:
-        stat_name = "pkt6-reply-sent";
+        Counters.pkt6_reply_sent_->add();
         break;
     case DHCPV6_DHCPV4_RESPONSE:
-        stat_name = "pkt6-dhcpv4-response-sent";
+        Counters.pkt6_dhcpv4_response_sent_->add();
         break;
     default:
         // That should never happen
         return;
     }
-
-    StatsMgr::instance().addValue(stat_name, static_cast<int64_t>(1));
 }
 
 int Dhcpv6Srv::getHookIndexBuffer6Send() {
@@ -344,6 +344,23 @@ TEST(ParserTest, globalParameters) {
     EXPECT_NO_THROW(parser.checkKeywords(parser.GLOBAL6_PARAMETERS, json));
 }
 
+// Checks that the memfile specific parameters are accepted in the lease
+// database map.
+TEST(ParserTest, memfileParameters) {
+    string txt =
+        "{ \"Dhcp6\": {\n"
+        "    \"lease-database\": {\n"
+        "        \"type\": \"memfile\",\n"
+        "        \"compact\": true,\n"
+        "        \"format\": \"binary\",\n"
+        "        \"write-queue-size\": 1024,\n"
+        "        \"write-max-delay\": 100,\n"
+        "        \"write-sync\": true\n"
+        "    }\n"
+        "} }\n";
+    testParser(txt, Parser6Context::PARSER_DHCP6);
+}
+
 /// @brief Tests error conditions in Dhcp6Parser
 ///
 /// @param txt text to be parsed
@@ -604,6 +621,26 @@ TEST(ParserTest, errors) {
               "<string>:2.24-28: syntax error, unexpected boolean, "
               "expecting integer");
 
+    // bad memfile parameter type
+    testError("{ \"Dhcp6\":{\n"
+              "  \"lease-database\":{\n"
+              "  \"compact\":\"yes\" }}}\n",
+              Parser6Context::PARSER_DHCP6,
+              "<string>:3.13-17: syntax error, unexpected constant string, "
+              "expecting boolean");
+    testError("{ \"Dhcp6\":{\n"
+              "  \"lease-database\":{\n"
+              "  \"write-queue-size\":true }}}\n",
+              Parser6Context::PARSER_DHCP6,
+              "<string>:3.22-25: syntax error, unexpected boolean, "
+              "expecting integer");
+    testError("{ \"Dhcp6\":{\n"
+              "  \"lease-database\":{\n"
+              "  \"format\":1 }}}\n",
+              Parser6Context::PARSER_DHCP6,
+              "<string>:3.12: syntax error, unexpected integer, "
+              "expecting constant string");
+
     // unknown keyword
     testError("{ \"Dhcp6\":{\n"
               " \"preferred_lifetime\":600 }}\n",
@@ -17,6 +17,7 @@
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_file_loader.h>
+#include <dhcpsrv/lease_journal.h>
 #include <log/logger_manager.h>
 #include <log/logger_name.h>
 #include <process/cfgrpt/config_report.h>
@@ -345,33 +346,43 @@ LFCController::processLeases() const {
     StorageType storage;
 
     // If a previous file exists read the entries into storage
-    LeaseFileType lf_prev(getPreviousFile());
-    if (lf_prev.exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(lf_prev, storage,
+    boost::shared_ptr<LeaseFileType> lf_prev =
+        createLeaseFile<LeaseFileType>(getPreviousFile(), LEASE_FILE_CSV);
+    if (lf_prev->exists()) {
+        LeaseFileLoader::load<LeaseObjectType>(*lf_prev, storage,
                                                MAX_LEASE_ERRORS);
     }
 
     // Follow that with the copy of the current lease file
-    LeaseFileType lf_copy(getCopyFile());
-    if (lf_copy.exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(lf_copy, storage,
+    boost::shared_ptr<LeaseFileType> lf_copy =
+        createLeaseFile<LeaseFileType>(getCopyFile(), LEASE_FILE_CSV);
+    if (lf_copy->exists()) {
+        LeaseFileLoader::load<LeaseObjectType>(*lf_copy, storage,
                                                MAX_LEASE_ERRORS);
     }
 
-    // Write the result out to the output file
-    LeaseFileType lf_output(getOutputFile());
-    LeaseFileLoader::write<LeaseObjectType>(lf_output, storage);
+    // Write the result out to the output file in the format of the
+    // server lease file, i.e. of its copy. A stale output file is removed
+    // so it does not select the format.
+    LeaseFileFormat format =
+        getLeaseFileFormat(getCopyFile(),
+                           getLeaseFileFormat(getPreviousFile(),
+                                              LEASE_FILE_CSV));
+    static_cast<void>(remove(getOutputFile().c_str()));
+    boost::shared_ptr<LeaseFileType> lf_output =
+        createLeaseFile<LeaseFileType>(getOutputFile(), format);
+    LeaseFileLoader::write<LeaseObjectType>(*lf_output, storage);
 
     // If desired log the stats
     LOG_INFO(lfc_logger, LFC_READ_STATS)
-      .arg(lf_prev.getReadLeases() + lf_copy.getReadLeases())
-      .arg(lf_prev.getReads() + lf_copy.getReads())
-      .arg(lf_prev.getReadErrs() + lf_copy.getReadErrs());
+      .arg(lf_prev->getReadLeases() + lf_copy->getReadLeases())
+      .arg(lf_prev->getReads() + lf_copy->getReads())
+      .arg(lf_prev->getReadErrs() + lf_copy->getReadErrs());
 
     LOG_INFO(lfc_logger, LFC_WRITE_STATS)
-      .arg(lf_output.getWriteLeases())
-      .arg(lf_output.getWrites())
-      .arg(lf_output.getWriteErrs());
+      .arg(lf_output->getWriteLeases())
+      .arg(lf_output->getWrites())
+      .arg(lf_output->getWriteErrs());
 
     // Once we've finished the output file move it to the complete file
     if (rename(getOutputFile().c_str(), getFinishFile().c_str()) != 0) {
@@ -23,6 +23,7 @@ unordered_set<string> CommandCreator::ha_commands4_ = {
     "list-commands", "status-get",
     "dhcp-disable", "dhcp-enable",
     "ha-reset", "ha-heartbeat",
+    "lease4-bulk-apply",
     "lease4-update", "lease4-del",
     "lease4-get-all", "lease4-get-page",
     "ha-maintenance-notify", "ha-sync-complete-notify"
@@ -89,6 +90,40 @@ CommandCreator::createHeartbeat(const std::string& server_name,
     return (command);
 }
 
+ConstElementPtr
+CommandCreator::createLease4BulkApply(const Lease4CollectionPtr& leases,
+                                      const Lease4CollectionPtr& deleted_leases) {
+    ElementPtr leases_list = Element::createList();
+    ElementPtr deleted_leases_list = Element::createList();
+    for (auto const& lease : *deleted_leases) {
+        ElementPtr lease_as_json = lease->toElement();
+        insertLeaseExpireTime(lease_as_json);
+        // If the deleted lease is in the released state it means that it
+        // should be preserved in the database. Such a lease should be
+        // updated by the partner rather than deleted.
+        if (lease->state_ == Lease4::STATE_RELEASED) {
+            leases_list->add(lease_as_json);
+        } else {
+            deleted_leases_list->add(lease_as_json);
+        }
+    }
+
+    for (auto const& lease : *leases) {
+        ElementPtr lease_as_json = lease->toElement();
+        insertLeaseExpireTime(lease_as_json);
+        leases_list->add(lease_as_json);
+    }
+
+    ElementPtr args = Element::createMap();
+    args->set("deleted-leases", deleted_leases_list);
+    args->set("leases", leases_list);
+    args->set("origin", Element::create("ha-partner"));
+
+    ConstElementPtr command = config::createCommand("lease4-bulk-apply", args);
+    insertService(command, HAServerType::DHCPv4);
+    return (command);
+}
+
 ConstElementPtr
 CommandCreator::createLease4Update(const Lease4& lease4) {
     ElementPtr lease_as_json = lease4.toElement();
@@ -119,7 +154,8 @@ CommandCreator::createLease4GetAll() {
 
 ConstElementPtr
 CommandCreator::createLease4GetPage(const Lease4Ptr& last_lease4,
-                                    const uint32_t limit) {
+                                    const uint32_t limit,
+                                    const bool binary) {
     // Zero value is not allowed.
     if (limit == 0) {
         isc_throw(BadValue, "limit value for lease4-get-page command must not be 0");
@@ -135,6 +171,11 @@ CommandCreator::createLease4GetPage(const Lease4Ptr& last_lease4,
     ElementPtr args = Element::createMap();
     args->set("from", from_element);
     args->set("limit", limit_element);
+    // Partners not supporting the binary format ignore this parameter
+    // and return the list of lease maps.
+    if (binary) {
+        args->set("format", Element::create("binary"));
+    }
 
     // Create the command.
     ConstElementPtr command = config::createCommand("lease4-get-page", args);
@@ -234,7 +275,8 @@ CommandCreator::createLease6GetAll() {
 
 ConstElementPtr
 CommandCreator::createLease6GetPage(const Lease6Ptr& last_lease6,
-                                    const uint32_t limit) {
+                                    const uint32_t limit,
+                                    const bool binary) {
     // Zero value is not allowed.
     if (limit == 0) {
         isc_throw(BadValue, "limit value for lease6-get-page command must not be 0");
@@ -250,6 +292,11 @@ CommandCreator::createLease6GetPage(const Lease6Ptr& last_lease6,
     ElementPtr args = Element::createMap();
     args->set("from", from_element);
     args->set("limit", limit_element);
+    // Partners not supporting the binary format ignore this parameter
+    // and return the list of lease maps.
+    if (binary) {
+        args->set("format", Element::create("binary"));
+    }
 
     // Create the command.
     ConstElementPtr command = config::createCommand("lease6-get-page", args);
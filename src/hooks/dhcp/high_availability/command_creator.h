@@ -67,6 +67,20 @@ public:
     createHeartbeat(const std::string& server_name,
                     const HAServerType& server_type);
 
+    /// @brief Creates lease4-bulk-apply command.
+    ///
+    /// The deleted leases in the released state are sent as updated leases
+    /// because they are preserved in the database.
+    ///
+    /// @param leases Pointer to the collection of leases to be created
+    /// or/and updated.
+    /// @param deleted_leases Pointer to the collection of leases to be
+    /// deleted.
+    /// @return Pointer to the JSON representation of the command.
+    static data::ConstElementPtr
+    createLease4BulkApply(const dhcp::Lease4CollectionPtr& leases,
+                          const dhcp::Lease4CollectionPtr& deleted_leases);
+
     /// @brief Creates lease4-update command.
     ///
     /// It adds "force-create" parameter to the lease information to force
@@ -103,10 +117,13 @@ public:
     /// to fetch the first page, the @c lease4 parameter should be set to
     /// null.
     /// @param limit Limit of leases on the page.
+    /// @param binary Boolean flag indicating if the leases should be
+    /// returned in a lease stream rather than in a list of lease maps.
     /// @return Pointer to the JSON representation of the command.
     static data::ConstElementPtr
     createLease4GetPage(const dhcp::Lease4Ptr& lease4,
-                        const uint32_t limit);
+                        const uint32_t limit,
+                        const bool binary = false);
 
     /// @brief Creates lease6-bulk-apply command.
     ///
@@ -165,10 +182,13 @@ public:
     /// to fetch the first page, the @c lease6 parameter should be set to
     /// null.
     /// @param limit Limit of leases on the page.
+    /// @param binary Boolean flag indicating if the leases should be
+    /// returned in a lease stream rather than in a list of lease maps.
     /// @return Pointer to the JSON representation of the command.
     static data::ConstElementPtr
     createLease6GetPage(const dhcp::Lease6Ptr& lease6,
-                        const uint32_t limit);
+                        const uint32_t limit,
+                        const bool binary = false);
 
     /// @brief Creates ha-maintenance-notify command.
     ///
@@ -165,7 +165,8 @@ HAConfig::StateMachineConfig::getStateConfig(const int state) {
 HAConfig::HAConfig()
     : this_server_name_(), ha_mode_(HOT_STANDBY), send_lease_updates_(true),
       sync_leases_(true), sync_timeout_(60000), sync_page_limit_(10000),
-      delayed_updates_limit_(0), heartbeat_delay_(10000), max_response_delay_(60000),
+      sync_binary_(true), delayed_updates_limit_(0), lease_update_batch_size_(0),
+      lease_update_batch_delay_(5), heartbeat_delay_(10000), max_response_delay_(60000),
       max_ack_delay_(10000), max_unacked_clients_(10), max_rejected_lease_updates_(10),
       wait_backup_ack_(false), enable_multi_threading_(false),
       http_dedicated_listener_(false), http_listener_threads_(0), http_client_threads_(0),
@@ -470,6 +471,12 @@ HAConfig::validate() {
         }
     }
 
+    // The batched lease updates must be sent after some delay.
+    if ((lease_update_batch_size_ > 0) && (lease_update_batch_delay_ == 0)) {
+        isc_throw(HAConfigValidationError, "'lease-update-batch-delay' must be"
+                  " greater than 0 when 'lease-update-batch-size' is set");
+    }
+
     // We get it from staging because applying the DHCP multi-threading configuration
     // occurs after library loading during the (re)configuration process.
     auto mcfg = CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading();
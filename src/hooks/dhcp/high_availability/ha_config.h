@@ -449,6 +449,24 @@ public:
         sync_page_limit_ = sync_page_limit;
     }
 
+    /// @brief Checks if the leases are fetched from the partner in the
+    /// binary format during database synchronization.
+    ///
+    /// @return true if the leases are fetched in lease streams, false if
+    /// they are fetched in lists of lease maps.
+    bool getSyncBinary() const {
+        return (sync_binary_);
+    }
+
+    /// @brief Sets the format of the leases fetched from the partner
+    /// during database synchronization.
+    ///
+    /// @param sync_binary true to fetch the leases in lease streams,
+    /// false to fetch them in lists of lease maps.
+    void setSyncBinary(const bool sync_binary) {
+        sync_binary_ = sync_binary;
+    }
+
     /// @brief Returns the maximum number of lease updates which can be held
     /// unsent in the communication-recovery state.
     ///
@@ -492,6 +510,53 @@ public:
         return (delayed_updates_limit_ > 0);
     }
 
+    /// @brief Returns the maximum number of leases sent in a batched lease
+    /// update.
+    ///
+    /// If this value is greater than 0 the lease updates resulting from
+    /// different DHCP queries are coalesced and sent to a peer in a single
+    /// @c lease4-bulk-apply or @c lease6-bulk-apply command. The batch is
+    /// sent when it holds this number of leases or when the batch delay
+    /// elapses, whichever comes first. A value of 0 disables the batching.
+    ///
+    /// @return Maximum number of leases in a batch.
+    uint32_t getLeaseUpdateBatchSize() const {
+        return (lease_update_batch_size_);
+    }
+
+    /// @brief Sets the maximum number of leases sent in a batched lease
+    /// update.
+    ///
+    /// @param lease_update_batch_size new batch size. A value of 0 disables
+    /// the batching.
+    void setLeaseUpdateBatchSize(const uint32_t lease_update_batch_size) {
+        lease_update_batch_size_ = lease_update_batch_size;
+    }
+
+    /// @brief Convenience function checking if the lease updates are batched.
+    ///
+    /// @return true if lease-update-batch-size is greater than 0, false
+    /// otherwise.
+    bool amBatchingLeaseUpdates() const {
+        return (lease_update_batch_size_ > 0);
+    }
+
+    /// @brief Returns the maximum time in milliseconds a lease update waits
+    /// in a batch before it is sent.
+    ///
+    /// @return Batch delay in milliseconds.
+    uint32_t getLeaseUpdateBatchDelay() const {
+        return (lease_update_batch_delay_);
+    }
+
+    /// @brief Sets the maximum time in milliseconds a lease update waits
+    /// in a batch before it is sent.
+    ///
+    /// @param lease_update_batch_delay new batch delay in milliseconds.
+    void setLeaseUpdateBatchDelay(const uint32_t lease_update_batch_delay) {
+        lease_update_batch_delay_ = lease_update_batch_delay;
+    }
+
     /// @brief Returns heartbeat delay in milliseconds.
     ///
     /// This value indicates the delay in sending a heartbeat command after
@@ -823,8 +888,14 @@ public:
     uint32_t sync_timeout_;                   ///< Timeout for syncing lease database (ms)
     uint32_t sync_page_limit_;                ///< Page size limit while
                                               ///< synchronizing leases.
+    bool sync_binary_;                        ///< Fetch leases in the binary
+                                              ///< format while synchronizing.
     uint32_t delayed_updates_limit_;          ///< Maximum number of lease updates held
                                               ///< for later send in communication-recovery.
+    uint32_t lease_update_batch_size_;        ///< Maximum number of leases in
+                                              ///< a batched lease update.
+    uint32_t lease_update_batch_delay_;       ///< Maximum lease update batching
+                                              ///< delay in milliseconds.
     uint32_t heartbeat_delay_;                ///< Heartbeat delay in milliseconds.
     uint32_t max_response_delay_;             ///< Max delay in response to heartbeats.
     uint32_t max_ack_delay_;                  ///< Maximum DHCP message ack delay.
@@ -29,6 +29,8 @@ const SimpleDefaults HA_CONFIG_LB_DEFAULTS = {
 const SimpleDefaults HA_CONFIG_DEFAULTS = {
     { "delayed-updates-limit",      Element::integer, "0" },
     { "heartbeat-delay",            Element::integer, "10000" },
+    { "lease-update-batch-delay",   Element::integer, "5" },
+    { "lease-update-batch-size",    Element::integer, "0" },
     { "max-ack-delay",              Element::integer, "10000" },
     { "max-response-delay",         Element::integer, "60000" },
     { "max-unacked-clients",        Element::integer, "10" },
@@ -36,6 +38,7 @@ const SimpleDefaults HA_CONFIG_DEFAULTS = {
     { "require-client-certs",       Element::boolean, "true" },
     { "restrict-commands",          Element::boolean, "false" },
     { "send-lease-updates",         Element::boolean, "true" },
+    { "sync-format",                Element::string,  "binary" },
     { "sync-leases",                Element::boolean, "true" },
     { "sync-timeout",               Element::integer, "60000" },
     { "sync-page-limit",            Element::integer, "10000" },
@@ -179,10 +182,26 @@ HAConfigParser::parseOne(const HAConfigMapperPtr& config_storage,
     uint32_t sync_page_limit = getAndValidateInteger<uint32_t>(config, "sync-page-limit");
     rel_config->setSyncPageLimit(sync_page_limit);
 
+    // Get 'sync-format'.
+    std::string sync_format = getString(config, "sync-format");
+    if ((sync_format != "binary") && (sync_format != "json")) {
+        isc_throw(ConfigError, "'sync-format' value '" << sync_format
+                  << "' is neither 'binary' nor 'json'");
+    }
+    rel_config->setSyncBinary(sync_format == "binary");
+
     // Get 'delayed-updates-limit'.
     uint32_t delayed_updates_limit = getAndValidateInteger<uint32_t>(config, "delayed-updates-limit");
     rel_config->setDelayedUpdatesLimit(delayed_updates_limit);
 
+    // Get 'lease-update-batch-size'.
+    uint32_t lease_update_batch_size = getAndValidateInteger<uint32_t>(config, "lease-update-batch-size");
+    rel_config->setLeaseUpdateBatchSize(lease_update_batch_size);
+
+    // Get 'lease-update-batch-delay'.
+    uint32_t lease_update_batch_delay = getAndValidateInteger<uint32_t>(config, "lease-update-batch-delay");
+    rel_config->setLeaseUpdateBatchDelay(lease_update_batch_delay);
+
     // Get 'heartbeat-delay'.
     uint16_t heartbeat_delay = getAndValidateInteger<uint16_t>(config, "heartbeat-delay");
     rel_config->setHeartbeatDelay(heartbeat_delay);
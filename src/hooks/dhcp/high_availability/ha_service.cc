@@ -16,6 +16,7 @@
 #include <config/timeouts.h>
 #include <dhcp/iface_mgr.h>
 #include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <exceptions/exceptions.h>
@@ -23,6 +24,8 @@
 #include <http/response_json.h>
 #include <http/post_request_json.h>
 #include <util/boost_time_utils.h>
+#include <util/buffer.h>
+#include <util/encode/encode.h>
 #include <util/multi_threading_mgr.h>
 #include <util/stopwatch.h>
 #include <boost/pointer_cast.hpp>
@@ -80,6 +83,7 @@ HAService::HAService(const unsigned int id, const IOServicePtr& io_service,
       server_type_(server_type), client_(), listener_(), communication_state_(),
       query_filter_(config), lease_sync_filter_(server_type, config), mutex_(),
       pending_requests_(), lease_update_backlog_(config->getDelayedUpdatesLimit()),
+      batch_mutex_(), lease_update_batches_(),
       sync_complete_notified_(false) {
 
     if (server_type == HAServerType::DHCPv4) {
@@ -145,6 +149,14 @@ HAService::HAService(const unsigned int id, const IOServicePtr& io_service,
 }
 
 HAService::~HAService() {
+    // Cancel the timers of the lease update batches.
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        for (auto const& batch : lease_update_batches_) {
+            batch.second->timer_->cancel();
+        }
+    }
+
     // Stop client and/or listener.
     stopClientAndListener();
 
@@ -1250,25 +1262,32 @@ HAService::asyncSendLeaseUpdates(const dhcp::Pkt4Ptr& query,
             continue;
         }
 
-        // Lease updates for deleted leases.
-        for (auto const& l : *deleted_leases) {
-            // If a released lease is preserved in the database send the lease
-            // update to the partner. Otherwise, delete the lease.
-            if (l->state_ == Lease4::STATE_RELEASED) {
+        if (config_->amBatchingLeaseUpdates()) {
+            // Coalesce the lease updates with the updates for other queries
+            // and send them in one lease4-bulk-apply command.
+            batchLeaseUpdates(query, conf, leases, deleted_leases, parking_lot);
+
+        } else {
+            // Lease updates for deleted leases.
+            for (auto const& l : *deleted_leases) {
+                // If a released lease is preserved in the database send the lease
+                // update to the partner. Otherwise, delete the lease.
+                if (l->state_ == Lease4::STATE_RELEASED) {
+                    asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Update(*l),
+                                         parking_lot);
+                } else {
+                    asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Delete(*l),
+                                         parking_lot);
+                }
+            }
+
+            // Lease updates for new allocations and updated leases.
+            for (auto const& l : *leases) {
                 asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Update(*l),
                                      parking_lot);
-            } else {
-                asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Delete(*l),
-                                     parking_lot);
             }
         }
 
-        // Lease updates for new allocations and updated leases.
-        for (auto const& l : *leases) {
-            asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Update(*l),
-                                 parking_lot);
-        }
-
         // If we're contacting a backup server from which we don't expect a
         // response prior to responding to the DHCP client we don't count
         // it.
@@ -1349,9 +1368,15 @@ HAService::asyncSendLeaseUpdates(const dhcp::Pkt6Ptr& query,
             ++sent_num;
         }
 
-        // Send new/updated leases and deleted leases in one command.
-        asyncSendLeaseUpdate(query, conf, CommandCreator::createLease6BulkApply(leases, deleted_leases),
-                             parking_lot);
+        if (config_->amBatchingLeaseUpdates()) {
+            // Coalesce the lease updates with the updates for other queries.
+            batchLeaseUpdates(query, conf, leases, deleted_leases, parking_lot);
+
+        } else {
+            // Send new/updated leases and deleted leases in one command.
+            asyncSendLeaseUpdate(query, conf, CommandCreator::createLease6BulkApply(leases, deleted_leases),
+                                 parking_lot);
+        }
     }
 
     return (sent_num);
@@ -1509,51 +1534,289 @@ HAService::asyncSendLeaseUpdate(const QueryPtrType& query,
                 }
             }
 
-            // We don't care about the result of the lease update to the backup server.
-            // It is a best effort update.
-            if (config->getRole() != HAConfig::PeerConfig::BACKUP) {
-                // If the lease update was unsuccessful we may need to set the partner
+            finishLeaseUpdate(query, config, parking_lot, lease_update_success,
+                              lease_update_conflict);
+        },
+        HttpClient::RequestTimeout(TIMEOUT_DEFAULT_HTTP_CLIENT_REQUEST),
+        std::bind(&HAService::clientConnectHandler, this, ph::_1, ph::_2),
+        std::bind(&HAService::clientHandshakeHandler, this, ph::_1),
+        std::bind(&HAService::clientCloseHandler, this, ph::_1)
+    );
+
+    // The number of pending requests is the number of requests for which we
+    // expect an acknowledgment prior to responding to the DHCP clients. If
+    // we're configured to wait for the acks from the backups or it is not
+    // a backup increase the number of pending requests.
+    if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
+        // Request scheduled, so update the request counters for the query.
+        updatePendingRequest(query);
+    }
+}
+
+template<typename QueryPtrType>
+void
+HAService::finishLeaseUpdate(QueryPtrType& query,
+                             const HAConfig::PeerConfigPtr& config,
+                             const ParkingLotHandlePtr& parking_lot,
+                             const bool lease_update_success,
+                             const bool lease_update_conflict) {
+    // We don't care about the result of the lease update to the backup server.
+    // It is a best effort update.
+    if (config->getRole() != HAConfig::PeerConfig::BACKUP) {
+        // If the lease update was unsuccessful we may need to set the partner
+        // state as unavailable.
+        if (!lease_update_success) {
+            // Do not set it as unavailable if it was a conflict because the
+            // partner actually responded.
+            if (!lease_update_conflict) {
+                // If we were unable to communicate with the partner we set partner's
                 // state as unavailable.
-                if (!lease_update_success) {
-                    // Do not set it as unavailable if it was a conflict because the
-                    // partner actually responded.
-                    if (!lease_update_conflict) {
-                        // If we were unable to communicate with the partner we set partner's
-                        // state as unavailable.
-                        communication_state_->setPartnerUnavailable();
-                    }
-                } else {
-                    // Lease update successful and we may need to clear some previously
-                    // rejected lease updates.
-                    communication_state_->reportSuccessfulLeaseUpdate(query);
+                communication_state_->setPartnerUnavailable();
+            }
+        } else {
+            // Lease update successful and we may need to clear some previously
+            // rejected lease updates.
+            communication_state_->reportSuccessfulLeaseUpdate(query);
+        }
+    }
+
+    // It is possible to configure the server to not wait for a response from
+    // the backup server before we unpark the packet and respond to the client.
+    // Here we check if we're dealing with such situation.
+    if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
+        // We're expecting a response from the backup server or it is not
+        // a backup server and the lease update was unsuccessful. In such
+        // case the DHCP exchange fails.
+        if (!lease_update_success) {
+            if (parking_lot) {
+                parking_lot->drop(query);
+            }
+        }
+    } else {
+        // This was a response from the backup server and we're configured to
+        // not wait for their acknowledgments, so there is nothing more to do.
+        return;
+    }
+
+    if (leaseUpdateComplete(query, parking_lot)) {
+        // If we have finished sending the lease updates we need to run the
+        // state machine until the state machine finds that additional events
+        // are required, such as next heartbeat or a lease update. The runModel()
+        // may transition to another state, schedule asynchronous tasks etc.
+        // Then it returns control to the DHCP server.
+        runModel(HA_LEASE_UPDATES_COMPLETE_EVT);
+    }
+}
+
+template<typename QueryPtrType, typename LeaseCollectionPtrType>
+void
+HAService::batchLeaseUpdates(const QueryPtrType& query,
+                             const HAConfig::PeerConfigPtr& config,
+                             const LeaseCollectionPtrType& leases,
+                             const LeaseCollectionPtrType& deleted_leases,
+                             const ParkingLotHandlePtr& parking_lot) {
+    LeaseUpdateBatchEntryPtr entry(new LeaseUpdateBatchEntry());
+    entry->query_ = query;
+    entry->parking_lot_ = parking_lot;
+    entry->leases_.assign(leases->begin(), leases->end());
+    entry->deleted_leases_.assign(deleted_leases->begin(), deleted_leases->end());
+
+    // The number of pending requests is the number of requests for which we
+    // expect an acknowledgment prior to responding to the DHCP clients. The
+    // counter must be updated before the batch is sent.
+    if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
+        updatePendingRequest(query);
+    }
+
+    bool send_now = false;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        auto& batch = lease_update_batches_[config->getName()];
+        if (!batch) {
+            batch.reset(new LeaseUpdateBatch());
+            batch->timer_.reset(new IntervalTimer(io_service_));
+        }
+        batch->entries_.push_back(entry);
+        batch->lease_count_ += entry->leases_.size() + entry->deleted_leases_.size();
+        if (batch->lease_count_ >= config_->getLeaseUpdateBatchSize()) {
+            // The batch is full. Send it right away.
+            send_now = true;
+
+        } else if (batch->entries_.size() == 1) {
+            // This is the first entry in the batch. The batch must be sent
+            // when the configured delay elapses, even if it isn't full.
+            batch->timer_->setup(std::bind(&HAService::sendLeaseUpdateBatch, this,
+                                           config),
+                                 config_->getLeaseUpdateBatchDelay(),
+                                 IntervalTimer::ONE_SHOT);
+        }
+    }
+
+    if (send_now) {
+        sendLeaseUpdateBatch(config);
+    }
+}
+
+void
+HAService::sendLeaseUpdateBatch(const HAConfig::PeerConfigPtr& config) {
+    LeaseUpdateBatchEntries entries;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        auto batch = lease_update_batches_.find(config->getName());
+        if (batch == lease_update_batches_.end()) {
+            return;
+        }
+        batch->second->timer_->cancel();
+        entries.swap(batch->second->entries_);
+        batch->second->lease_count_ = 0;
+    }
+    // The timer may fire after the batch has been sent because it was full.
+    if (entries.empty()) {
+        return;
+    }
+
+    if (server_type_ == HAServerType::DHCPv4) {
+        Lease4CollectionPtr leases(new Lease4Collection());
+        Lease4CollectionPtr deleted_leases(new Lease4Collection());
+        for (auto const& entry : entries) {
+            for (auto const& lease : entry->leases_) {
+                leases->push_back(boost::dynamic_pointer_cast<Lease4>(lease));
+            }
+            for (auto const& lease : entry->deleted_leases_) {
+                deleted_leases->push_back(boost::dynamic_pointer_cast<Lease4>(lease));
+            }
+        }
+        asyncSendLeaseUpdateBatch<Pkt4Ptr>(config, entries,
+                                           CommandCreator::createLease4BulkApply(leases,
+                                                                                 deleted_leases));
+    } else {
+        Lease6CollectionPtr leases(new Lease6Collection());
+        Lease6CollectionPtr deleted_leases(new Lease6Collection());
+        for (auto const& entry : entries) {
+            for (auto const& lease : entry->leases_) {
+                leases->push_back(boost::dynamic_pointer_cast<Lease6>(lease));
+            }
+            for (auto const& lease : entry->deleted_leases_) {
+                deleted_leases->push_back(boost::dynamic_pointer_cast<Lease6>(lease));
+            }
+        }
+        asyncSendLeaseUpdateBatch<Pkt6Ptr>(config, entries,
+                                           CommandCreator::createLease6BulkApply(leases,
+                                                                                 deleted_leases));
+    }
+}
+
+template<typename QueryPtrType>
+void
+HAService::asyncSendLeaseUpdateBatch(const HAConfig::PeerConfigPtr& config,
+                                     const LeaseUpdateBatchEntries& entries,
+                                     const ConstElementPtr& command) {
+    // Create HTTP/1.1 request including our command.
+    PostHttpRequestJsonPtr request = boost::make_shared<PostHttpRequestJson>
+        (HttpRequest::Method::HTTP_POST, "/", HttpVersion::HTTP_11(),
+         HostHttpHeader(config->getUrl().getStrippedHostname()));
+    config->addBasicAuthHttpHeader(request);
+    request->setBodyAsJson(command);
+    request->finalize();
+
+    // Response object should also be created because the HTTP client needs
+    // to know the type of the expected response.
+    HttpResponseJsonPtr response = boost::make_shared<HttpResponseJson>();
+
+    // Schedule asynchronous HTTP request.
+    client_->asyncSendRequest(config->getUrl(), config->getTlsContext(),
+                              request, response,
+        [this, entries, config]
+            (const boost::system::error_code& ec,
+             const HttpResponsePtr& response,
+             const std::string& error_str) {
+
+            // The errors are handled as in the asyncSendLeaseUpdate, except
+            // that the leases listed as failed in the response are attributed
+            // to the queries they belong to. A query whose own leases have
+            // been updated is not affected by the failures of other queries
+            // in the batch.
+            bool communication_error = !!ec || !error_str.empty();
+            std::string error_message = (ec ? ec.message() : error_str);
+            bool batch_conflict = false;
+            bool batch_error = false;
+            ConstElementPtr args;
+
+            if (!communication_error) {
+                try {
+                    int rcode = 0;
+                    args = verifyAsyncResponse(response, rcode, false);
+
+                } catch (const ConflictError& ex) {
+                    batch_conflict = true;
+                    error_message = ex.what();
+
+                } catch (const std::exception& ex) {
+                    batch_error = true;
+                    error_message = ex.what();
                 }
             }
 
-            // It is possible to configure the server to not wait for a response from
-            // the backup server before we unpark the packet and respond to the client.
-            // Here we check if we're dealing with such situation.
-            if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
-                // We're expecting a response from the backup server or it is not
-                // a backup server and the lease update was unsuccessful. In such
-                // case the DHCP exchange fails.
-                if (!lease_update_success) {
-                    if (parking_lot) {
-                        parking_lot->drop(query);
+            // Index the failed leases by type and address.
+            FailedLeaseIndex failed_leases;
+            FailedLeaseIndex failed_deleted_leases;
+            indexFailedLeases(args, "failed-leases", failed_leases);
+            indexFailedLeases(args, "failed-deleted-leases", failed_deleted_leases);
+
+            for (auto const& entry : entries) {
+                // The pending requests hold the queries so they can't be null
+                // unless this is a response from the backup server for which
+                // we don't wait.
+                QueryPtrType query = boost::dynamic_pointer_cast<
+                    typename QueryPtrType::element_type>(entry->query_.lock());
+                if (!query) {
+                    continue;
+                }
+
+                bool lease_update_success = true;
+                bool lease_update_conflict = false;
+
+                if (communication_error) {
+                    LOG_WARN(ha_logger, HA_LEASE_UPDATE_COMMUNICATIONS_FAILED)
+                        .arg(config_->getThisServerName())
+                        .arg(query->getLabel())
+                        .arg(config->getLogLabel())
+                        .arg(error_message);
+                    lease_update_success = false;
+
+                } else {
+                    try {
+                        if (batch_conflict) {
+                            isc_throw(ConflictError, error_message);
+                        } else if (batch_error) {
+                            isc_throw(CtrlChannelError, error_message);
+                        }
+                        checkLeaseUpdateBatchEntry(query, *entry, failed_leases,
+                                                   failed_deleted_leases);
+
+                    } catch (const ConflictError& ex) {
+                        lease_update_conflict = true;
+                        lease_update_success = false;
+                        communication_state_->reportRejectedLeaseUpdate(query);
+
+                        LOG_WARN(ha_logger, HA_LEASE_UPDATE_CONFLICT)
+                            .arg(config_->getThisServerName())
+                            .arg(query->getLabel())
+                            .arg(config->getLogLabel())
+                            .arg(ex.what());
+
+                    } catch (const std::exception& ex) {
+                        LOG_WARN(ha_logger, HA_LEASE_UPDATE_FAILED)
+                            .arg(config_->getThisServerName())
+                            .arg(query->getLabel())
+                            .arg(config->getLogLabel())
+                            .arg(ex.what());
+                        lease_update_success = false;
                     }
                 }
-            } else {
-                // This was a response from the backup server and we're configured to
-                // not wait for their acknowledgments, so there is nothing more to do.
-                return;
-            }
 
-            if (leaseUpdateComplete(query, parking_lot)) {
-                // If we have finished sending the lease updates we need to run the
-                // state machine until the state machine finds that additional events
-                // are required, such as next heartbeat or a lease update. The runModel()
-                // may transition to another state, schedule asynchronous tasks etc.
-                // Then it returns control to the DHCP server.
-                runModel(HA_LEASE_UPDATES_COMPLETE_EVT);
+                finishLeaseUpdate(query, config, entry->parking_lot_,
+                                  lease_update_success, lease_update_conflict);
             }
         },
         HttpClient::RequestTimeout(TIMEOUT_DEFAULT_HTTP_CLIENT_REQUEST),
@@ -1561,14 +1824,77 @@ HAService::asyncSendLeaseUpdate(const QueryPtrType& query,
         std::bind(&HAService::clientHandshakeHandler, this, ph::_1),
         std::bind(&HAService::clientCloseHandler, this, ph::_1)
     );
+}
 
-    // The number of pending requests is the number of requests for which we
-    // expect an acknowledgment prior to responding to the DHCP clients. If
-    // we're configured to wait for the acks from the backups or it is not
-    // a backup increase the number of pending requests.
-    if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
-        // Request scheduled, so update the request counters for the query.
-        updatePendingRequest(query);
+void
+HAService::indexFailedLeases(const ConstElementPtr& args,
+                             const std::string& param_name,
+                             FailedLeaseIndex& index) {
+    if (!args || (args->getType() != Element::map)) {
+        return;
+    }
+    auto failed = args->get(param_name);
+    if (!failed || (failed->getType() != Element::list)) {
+        return;
+    }
+    for (auto const& lease : failed->listValue()) {
+        if (lease->getType() != Element::map) {
+            continue;
+        }
+        auto ip_address = lease->get("ip-address");
+        auto lease_type = lease->get("type");
+        if (!ip_address || (ip_address->getType() != Element::string) ||
+            !lease_type || (lease_type->getType() != Element::string)) {
+            continue;
+        }
+        index[lease_type->stringValue() + " " + ip_address->stringValue()] = lease;
+    }
+}
+
+void
+HAService::checkLeaseUpdateBatchEntry(const PktPtr& query,
+                                      const LeaseUpdateBatchEntry& entry,
+                                      const FailedLeaseIndex& failed_leases,
+                                      const FailedLeaseIndex& failed_deleted_leases) const {
+    ElementPtr failed_leases_list = Element::createList();
+    ElementPtr failed_deleted_leases_list = Element::createList();
+
+    // The deleted leases in the released state are sent as updated leases
+    // so let's look for each lease in both lists.
+    auto find_failed = [&](const LeasePtr& lease) {
+        std::string key = Lease::typeToText(lease->getType()) + " " + lease->addr_.toText();
+        auto failed = failed_leases.find(key);
+        if (failed != failed_leases.end()) {
+            failed_leases_list->add(boost::const_pointer_cast<Element>(failed->second));
+        }
+        failed = failed_deleted_leases.find(key);
+        if (failed != failed_deleted_leases.end()) {
+            failed_deleted_leases_list->add(boost::const_pointer_cast<Element>(failed->second));
+        }
+    };
+    for (auto const& lease : entry.leases_) {
+        find_failed(lease);
+    }
+    for (auto const& lease : entry.deleted_leases_) {
+        find_failed(lease);
+    }
+
+    size_t failed_count = failed_leases_list->size() + failed_deleted_leases_list->size();
+    if (failed_count == 0) {
+        return;
+    }
+
+    ElementPtr args = Element::createMap();
+    args->set("failed-deleted-leases", failed_deleted_leases_list);
+    args->set("failed-leases", failed_leases_list);
+    logFailedLeaseUpdates(query, args);
+
+    // Each DHCPv4 lease used to be sent in a separate command, so a failure
+    // to update any of the leases fails the query. The lease6-bulk-apply
+    // fails only when none of the lease changes have been applied.
+    if ((server_type_ == HAServerType::DHCPv4) ||
+        (failed_count >= entry.leases_.size() + entry.deleted_leases_.size())) {
+        checkFailedLeases(args);
     }
 }
 
@@ -2163,11 +2489,13 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
     remote_config->addBasicAuthHttpHeader(request);
     if (server_type_ == HAServerType::DHCPv4) {
         request->setBodyAsJson(CommandCreator::createLease4GetPage(
-            boost::dynamic_pointer_cast<Lease4>(last_lease), config_->getSyncPageLimit()));
+            boost::dynamic_pointer_cast<Lease4>(last_lease), config_->getSyncPageLimit(),
+            config_->getSyncBinary()));
 
     } else {
         request->setBodyAsJson(CommandCreator::createLease6GetPage(
-            boost::dynamic_pointer_cast<Lease6>(last_lease), config_->getSyncPageLimit()));
+            boost::dynamic_pointer_cast<Lease6>(last_lease), config_->getSyncPageLimit(),
+            config_->getSyncBinary()));
     }
     request->finalize();
 
@@ -2216,114 +2544,136 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                                   "arguments in the received response must be a map");
                     }
 
+                    // Count actually applied leases.
+                    uint64_t applied_lease_count = 0;
+
+                    // Count received leases and remember the one with the
+                    // highest address which ends the page.
+                    size_t lease_count = 0;
+                    LeasePtr page_last_lease;
+
+                    // The partner returns the leases in a lease stream when
+                    // it supports the binary format. Otherwise, e.g. when it
+                    // runs an older version, it returns a list of leases.
+                    // The leases which can't be written in the stream are
+                    // returned in the list along with the stream.
+                    ConstElementPtr leases_binary = args->get("leases-binary");
                     ConstElementPtr leases = args->get("leases");
-                    if (!leases || (leases->getType() != Element::list)) {
+                    if (leases_binary) {
+                        if (leases_binary->getType() != Element::string) {
+                            isc_throw(CtrlChannelError,
+                                      "leases-binary argument in the server"
+                                      " response is not a string");
+                        }
+                        if (leases && (leases->getType() != Element::list)) {
+                            isc_throw(CtrlChannelError,
+                                      "leases argument in the server response"
+                                      " is not a list");
+                        }
+
+                    } else if (!leases || (leases->getType() != Element::list)) {
                         isc_throw(CtrlChannelError,
                                   "server response does not contain leases argument or this"
                                   " argument is not a list");
                     }
 
-                    // Iterate over the leases and update the database as appropriate.
-                    auto const& leases_element = leases->listValue();
-
-                    LOG_INFO(ha_logger, HA_LEASES_SYNC_LEASE_PAGE_RECEIVED)
-                        .arg(config_->getThisServerName())
-                        .arg(leases_element.size())
-                        .arg(remote_config->getLogLabel());
-
-                    // Count actually applied leases.
-                    uint64_t applied_lease_count = 0;
-                    for (auto l = leases_element.begin(); l != leases_element.end(); ++l) {
+                    if (leases_binary) {
+                        std::vector<uint8_t> binary;
                         try {
+                            encode::decodeBase64(leases_binary->stringValue(), binary);
+                        } catch (const std::exception& ex) {
+                            isc_throw(CtrlChannelError, "invalid leases-binary argument"
+                                      " in the server response: " << ex.what());
+                        }
 
-                            if (server_type_ == HAServerType::DHCPv4) {
-                                Lease4Ptr lease = Lease4::fromElement(*l);
-
-                                // If we're not on the last page and we're processing final lease on
-                                // this page, let's record the lease as input to the next
-                                // lease4-get-page command.
-                                if ((leases_element.size() >= config_->getSyncPageLimit()) &&
-                                    (l + 1 == leases_element.end())) {
-                                    last_lease = boost::dynamic_pointer_cast<Lease>(lease);
-                                }
-
-                                if (!lease_sync_filter_.shouldSync(lease)) {
-                                    continue;
+                        // Leases are decoded and applied one by one without
+                        // building the page of leases. A broken stream fails
+                        // the synchronization.
+                        InputBuffer buffer(binary.empty() ? 0 : &binary[0], binary.size());
+                        try {
+                            readLeaseStreamHeader(buffer);
+                        } catch (const std::exception& ex) {
+                            isc_throw(CtrlChannelError, "invalid leases-binary argument"
+                                      " in the server response: " << ex.what());
+                        }
+                        for (;;) {
+                            LeasePtr lease;
+                            try {
+                                if (server_type_ == HAServerType::DHCPv4) {
+                                    Lease4Ptr lease4;
+                                    if (!readLeaseStreamRecord(buffer, lease4)) {
+                                        break;
+                                    }
+                                    lease = lease4;
+                                } else {
+                                    Lease6Ptr lease6;
+                                    if (!readLeaseStreamRecord(buffer, lease6)) {
+                                        break;
+                                    }
+                                    lease = lease6;
                                 }
-
-                                // Check if there is such lease in the database already.
-                                Lease4Ptr existing_lease = LeaseMgrFactory::instance().getLease4(lease->addr_);
-                                if (!existing_lease) {
-                                    // There is no such lease, so let's add it.
-                                    LeaseMgrFactory::instance().addLease(lease);
-                                    ++applied_lease_count;
-
-                                } else if (existing_lease->cltt_ < lease->cltt_) {
-                                    // If the existing lease is older than the fetched lease, update
-                                    // the lease in our local database.
-                                    // Update lease current expiration time with value received from the
-                                    // database. Some database backends reject operations on the lease if
-                                    // the current expiration time value does not match what is stored.
-                                    Lease::syncCurrentExpirationTime(*existing_lease, *lease);
-                                    LeaseMgrFactory::instance().updateLease4(lease);
+                            } catch (const std::exception& ex) {
+                                isc_throw(CtrlChannelError, "invalid leases-binary argument"
+                                          " in the server response: " << ex.what());
+                            }
+                            ++lease_count;
+                            if (!page_last_lease || (page_last_lease->addr_ < lease->addr_)) {
+                                page_last_lease = lease;
+                            }
+                            try {
+                                if (syncLease(lease)) {
                                     ++applied_lease_count;
-
-                                } else {
-                                    LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE4_SKIP)
-                                        .arg(config_->getThisServerName())
-                                        .arg(lease->addr_.toText())
-                                        .arg(lease->subnet_id_);
                                 }
 
-                            } else {
-                                Lease6Ptr lease = Lease6::fromElement(*l);
+                            } catch (const std::exception& ex) {
+                                LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
+                                    .arg(config_->getThisServerName())
+                                    .arg(lease->toElement()->str())
+                                    .arg(ex.what());
+                            }
+                        }
+                    }
 
-                                // If we're not on the last page and we're processing final lease on
-                                // this page, let's record the lease as input to the next
-                                // lease6-get-page command.
-                                if ((leases_element.size() >= config_->getSyncPageLimit()) &&
-                                    (l + 1 == leases_element.end())) {
-                                    last_lease = boost::dynamic_pointer_cast<Lease>(lease);
+                    if (leases) {
+                        // Iterate over the leases and update the database as appropriate.
+                        for (auto const& l : leases->listValue()) {
+                            ++lease_count;
+                            try {
+                                LeasePtr lease;
+                                if (server_type_ == HAServerType::DHCPv4) {
+                                    lease = Lease4::fromElement(l);
+                                } else {
+                                    lease = Lease6::fromElement(l);
                                 }
 
-                                if (!lease_sync_filter_.shouldSync(lease)) {
-                                    continue;
+                                if (!page_last_lease || (page_last_lease->addr_ < lease->addr_)) {
+                                    page_last_lease = lease;
                                 }
 
-                                // Check if there is such lease in the database already.
-                                Lease6Ptr existing_lease = LeaseMgrFactory::instance().getLease6(lease->type_,
-                                                                                                 lease->addr_);
-                                if (!existing_lease) {
-                                    // There is no such lease, so let's add it.
-                                    LeaseMgrFactory::instance().addLease(lease);
+                                if (syncLease(lease)) {
                                     ++applied_lease_count;
-
-                                } else if (existing_lease->cltt_ < lease->cltt_) {
-                                    // If the existing lease is older than the fetched lease, update
-                                    // the lease in our local database.
-                                    // Update lease current expiration time with value received from the
-                                    // database. Some database backends reject operations on the lease if
-                                    // the current expiration time value does not match what is stored.
-                                    Lease::syncCurrentExpirationTime(*existing_lease, *lease);
-                                    LeaseMgrFactory::instance().updateLease6(lease);
-                                    ++applied_lease_count;
-
-                                } else {
-                                    LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE6_SKIP)
-                                        .arg(config_->getThisServerName())
-                                        .arg(lease->addr_.toText())
-                                        .arg(lease->subnet_id_);
                                 }
-                            }
 
-                        } catch (const std::exception& ex) {
-                            LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
-                                .arg(config_->getThisServerName())
-                                .arg((*l)->str())
-                                .arg(ex.what());
+                            } catch (const std::exception& ex) {
+                                LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
+                                    .arg(config_->getThisServerName())
+                                    .arg(l->str())
+                                    .arg(ex.what());
+                            }
                         }
                     }
 
+                    LOG_INFO(ha_logger, HA_LEASES_SYNC_LEASE_PAGE_RECEIVED)
+                        .arg(config_->getThisServerName())
+                        .arg(lease_count)
+                        .arg(remote_config->getLogLabel());
+
+                    // If we're not on the last page, let's record the last
+                    // lease as input to the next leaseX-get-page command.
+                    if (lease_count >= config_->getSyncPageLimit()) {
+                        last_lease = page_last_lease;
+                    }
+
                     LOG_INFO(ha_logger, HA_LEASES_SYNC_APPLIED_LEASES)
                         .arg(config_->getThisServerName())
                         .arg(applied_lease_count);
@@ -2365,6 +2715,70 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
 
 }
 
+bool
+HAService::syncLease(const LeasePtr& lease) {
+    if (server_type_ == HAServerType::DHCPv4) {
+        Lease4Ptr lease4 = boost::dynamic_pointer_cast<Lease4>(lease);
+        if (!lease4 || !lease_sync_filter_.shouldSync(lease4)) {
+            return (false);
+        }
+
+        // Check if there is such lease in the database already.
+        Lease4Ptr existing_lease = LeaseMgrFactory::instance().getLease4(lease4->addr_);
+        if (!existing_lease) {
+            // There is no such lease, so let's add it.
+            LeaseMgrFactory::instance().addLease(lease4);
+            return (true);
+
+        } else if (existing_lease->cltt_ < lease4->cltt_) {
+            // If the existing lease is older than the fetched lease, update
+            // the lease in our local database.
+            // Update lease current expiration time with value received from the
+            // database. Some database backends reject operations on the lease if
+            // the current expiration time value does not match what is stored.
+            Lease::syncCurrentExpirationTime(*existing_lease, *lease4);
+            LeaseMgrFactory::instance().updateLease4(lease4);
+            return (true);
+        }
+
+        LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE4_SKIP)
+            .arg(config_->getThisServerName())
+            .arg(lease4->addr_.toText())
+            .arg(lease4->subnet_id_);
+        return (false);
+    }
+
+    Lease6Ptr lease6 = boost::dynamic_pointer_cast<Lease6>(lease);
+    if (!lease6 || !lease_sync_filter_.shouldSync(lease6)) {
+        return (false);
+    }
+
+    // Check if there is such lease in the database already.
+    Lease6Ptr existing_lease = LeaseMgrFactory::instance().getLease6(lease6->type_,
+                                                                     lease6->addr_);
+    if (!existing_lease) {
+        // There is no such lease, so let's add it.
+        LeaseMgrFactory::instance().addLease(lease6);
+        return (true);
+
+    } else if (existing_lease->cltt_ < lease6->cltt_) {
+        // If the existing lease is older than the fetched lease, update
+        // the lease in our local database.
+        // Update lease current expiration time with value received from the
+        // database. Some database backends reject operations on the lease if
+        // the current expiration time value does not match what is stored.
+        Lease::syncCurrentExpirationTime(*existing_lease, *lease6);
+        LeaseMgrFactory::instance().updateLease6(lease6);
+        return (true);
+    }
+
+    LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE6_SKIP)
+        .arg(config_->getThisServerName())
+        .arg(lease6->addr_.toText())
+        .arg(lease6->subnet_id_);
+    return (false);
+}
+
 ConstElementPtr
 HAService::processSynchronize(const std::string& server_name,
                               const unsigned int max_period) {
@@ -3166,7 +3580,8 @@ HAService::processSyncCompleteNotify(const unsigned int origin_id) {
 }
 
 ConstElementPtr
-HAService::verifyAsyncResponse(const HttpResponsePtr& response, int& rcode) {
+HAService::verifyAsyncResponse(const HttpResponsePtr& response, int& rcode,
+                               const bool check_failed_leases) {
     // Set the return code to error in case of early throw.
     rcode = CONTROL_RESULT_ERROR;
     // The response must cast to JSON type.
@@ -3235,51 +3650,9 @@ HAService::verifyAsyncResponse(const HttpResponsePtr& response, int& rcode) {
         isc_throw(ConflictError, s.str());
 
     case CONTROL_RESULT_EMPTY:
-        // Handle the lease6-bulk-apply error cases.
-        if (args && (args->getType() == Element::map)) {
-            auto failed_leases = args->get("failed-leases");
-            if (!failed_leases || (failed_leases->getType() != Element::list)) {
-                // If there are no failed leases there is nothing to do.
-                break;
-            }
-            auto conflict = false;
-            ConstElementPtr conflict_error_message;
-            for (auto i = 0; i < failed_leases->size(); ++i) {
-                auto lease = failed_leases->get(i);
-                if (!lease || lease->getType() != Element::map) {
-                    continue;
-                }
-                auto result = lease->get("result");
-                if (!result || result->getType() != Element::integer) {
-                    continue;
-                }
-                auto error_message = lease->get("error-message");
-                // Error status code takes precedence over the conflict.
-                if (result->intValue() == CONTROL_RESULT_ERROR) {
-                    if (error_message && error_message->getType()) {
-                        s << error_message->stringValue() << " (";
-                    }
-                    s << "error code " << result->intValue() << ")";
-                    isc_throw(CtrlChannelError, s.str());
-                }
-                if (result->intValue() == CONTROL_RESULT_CONFLICT) {
-                    // Let's record the conflict but there may still be some
-                    // leases with an error status code, so do not throw the
-                    // conflict exception yet.
-                    conflict = true;
-                    conflict_error_message = error_message;
-                }
-            }
-            if (conflict) {
-                // There are no errors. There are only conflicts. Throw
-                // appropriate exception.
-                if (conflict_error_message &&
-                    (conflict_error_message->getType() == Element::string)) {
-                    s << conflict_error_message->stringValue() << " (";
-                }
-                s << "error code " << CONTROL_RESULT_CONFLICT << ")";
-                isc_throw(ConflictError, s.str());
-            }
+        // Handle the lease4-bulk-apply and lease6-bulk-apply error cases.
+        if (check_failed_leases) {
+            checkFailedLeases(args);
         }
         break;
     default:
@@ -3288,6 +3661,57 @@ HAService::verifyAsyncResponse(const HttpResponsePtr& response, int& rcode) {
     return (args);
 }
 
+void
+HAService::checkFailedLeases(const ConstElementPtr& args) {
+    if (!args || (args->getType() != Element::map)) {
+        return;
+    }
+    auto failed_leases = args->get("failed-leases");
+    if (!failed_leases || (failed_leases->getType() != Element::list)) {
+        // If there are no failed leases there is nothing to do.
+        return;
+    }
+    std::ostringstream s;
+    auto conflict = false;
+    ConstElementPtr conflict_error_message;
+    for (auto i = 0; i < failed_leases->size(); ++i) {
+        auto lease = failed_leases->get(i);
+        if (!lease || lease->getType() != Element::map) {
+            continue;
+        }
+        auto result = lease->get("result");
+        if (!result || result->getType() != Element::integer) {
+            continue;
+        }
+        auto error_message = lease->get("error-message");
+        // Error status code takes precedence over the conflict.
+        if (result->intValue() == CONTROL_RESULT_ERROR) {
+            if (error_message && error_message->getType()) {
+                s << error_message->stringValue() << " (";
+            }
+            s << "error code " << result->intValue() << ")";
+            isc_throw(CtrlChannelError, s.str());
+        }
+        if (result->intValue() == CONTROL_RESULT_CONFLICT) {
+            // Let's record the conflict but there may still be some
+            // leases with an error status code, so do not throw the
+            // conflict exception yet.
+            conflict = true;
+            conflict_error_message = error_message;
+        }
+    }
+    if (conflict) {
+        // There are no errors. There are only conflicts. Throw
+        // appropriate exception.
+        if (conflict_error_message &&
+            (conflict_error_message->getType() == Element::string)) {
+            s << conflict_error_message->stringValue() << " (";
+        }
+        s << "error code " << CONTROL_RESULT_CONFLICT << ")";
+        isc_throw(ConflictError, s.str());
+    }
+}
+
 bool
 HAService::clientConnectHandler(const boost::system::error_code& ec, int tcp_native_fd) {
 
@@ -14,6 +14,7 @@
 #include <lease_update_backlog.h>
 #include <query_filter.h>
 #include <asiolink/asio_wrapper.h>
+#include <asiolink/interval_timer.h>
 #include <asiolink/io_service.h>
 #include <asiolink/tls_socket.h>
 #include <cc/data.h>
@@ -28,9 +29,12 @@
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 #include <functional>
 #include <map>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace isc {
@@ -663,6 +667,151 @@ protected:
                               const data::ConstElementPtr& command,
                               const hooks::ParkingLotHandlePtr& parking_lot);
 
+    /// @brief Lease updates of a single DHCP query held in a batch.
+    struct LeaseUpdateBatchEntry {
+        /// @brief Pointer to the DHCP client's query.
+        boost::weak_ptr<dhcp::Pkt> query_;
+
+        /// @brief Parking lot where the query is parked.
+        hooks::ParkingLotHandlePtr parking_lot_;
+
+        /// @brief New or updated leases.
+        std::vector<dhcp::LeasePtr> leases_;
+
+        /// @brief Deleted leases.
+        std::vector<dhcp::LeasePtr> deleted_leases_;
+    };
+
+    /// @brief Pointer to the @c LeaseUpdateBatchEntry.
+    typedef boost::shared_ptr<LeaseUpdateBatchEntry> LeaseUpdateBatchEntryPtr;
+
+    /// @brief List of the lease update batch entries.
+    typedef std::vector<LeaseUpdateBatchEntryPtr> LeaseUpdateBatchEntries;
+
+    /// @brief Lease updates waiting to be sent to a peer.
+    struct LeaseUpdateBatch {
+        /// @brief Constructor.
+        LeaseUpdateBatch() : entries_(), lease_count_(0), timer_() {
+        }
+
+        /// @brief Lease updates of the DHCP queries in the batch.
+        LeaseUpdateBatchEntries entries_;
+
+        /// @brief Total number of leases in the batch.
+        size_t lease_count_;
+
+        /// @brief Timer sending the batch when the batch delay elapses.
+        asiolink::IntervalTimerPtr timer_;
+    };
+
+    /// @brief Pointer to the @c LeaseUpdateBatch.
+    typedef boost::shared_ptr<LeaseUpdateBatch> LeaseUpdateBatchPtr;
+
+    /// @brief Failed leases returned in the response to a bulk apply command
+    /// indexed by the lease type and address.
+    typedef std::unordered_map<std::string, data::ConstElementPtr> FailedLeaseIndex;
+
+    /// @brief Handles the result of the lease update sent to the peer.
+    ///
+    /// It updates the communication state, drops the parked query when the
+    /// lease update was unsuccessful and unparks the query when all lease
+    /// updates for the query have been completed.
+    ///
+    /// @param query Pointer to the DHCP client's query.
+    /// @param config Pointer to the configuration of the server to which the
+    /// lease update was sent.
+    /// @param parking_lot Parking lot where the query is parked.
+    /// @param lease_update_success Indicates if the lease update was successful.
+    /// @param lease_update_conflict Indicates if the lease update was rejected
+    /// by the peer with the conflict status code.
+    /// @tparam QueryPtrType Type of the pointer to the DHCP client's message,
+    /// i.e. Pkt4Ptr or Pkt6Ptr.
+    template<typename QueryPtrType>
+    void finishLeaseUpdate(QueryPtrType& query,
+                           const HAConfig::PeerConfigPtr& config,
+                           const hooks::ParkingLotHandlePtr& parking_lot,
+                           const bool lease_update_success,
+                           const bool lease_update_conflict);
+
+    /// @brief Appends the lease updates for a query to the peer's batch.
+    ///
+    /// The batch is sent in a single @c lease4-bulk-apply or
+    /// @c lease6-bulk-apply command when it holds @c lease-update-batch-size
+    /// leases or when @c lease-update-batch-delay elapses after the first
+    /// lease updates were appended to it, whichever comes first.
+    ///
+    /// @param query Pointer to the DHCP client's query.
+    /// @param config Pointer to the configuration of the server to which the
+    /// lease updates should be sent.
+    /// @param leases Pointer to the collection of new or updated leases.
+    /// @param deleted_leases Pointer to the collection of deleted leases.
+    /// @param parking_lot Parking lot where the query is parked.
+    /// @tparam QueryPtrType Type of the pointer to the DHCP client's message,
+    /// i.e. Pkt4Ptr or Pkt6Ptr.
+    /// @tparam LeaseCollectionPtrType Type of the pointer to the lease
+    /// collection, i.e. Lease4CollectionPtr or Lease6CollectionPtr.
+    template<typename QueryPtrType, typename LeaseCollectionPtrType>
+    void batchLeaseUpdates(const QueryPtrType& query,
+                           const HAConfig::PeerConfigPtr& config,
+                           const LeaseCollectionPtrType& leases,
+                           const LeaseCollectionPtrType& deleted_leases,
+                           const hooks::ParkingLotHandlePtr& parking_lot);
+
+    /// @brief Sends the lease updates batched for the peer.
+    ///
+    /// It does nothing if the batch is empty.
+    ///
+    /// @param config Pointer to the configuration of the peer.
+    void sendLeaseUpdateBatch(const HAConfig::PeerConfigPtr& config);
+
+    /// @brief Asynchronously sends the batched lease updates to the peer.
+    ///
+    /// When the response is received, the lease update for each query in
+    /// the batch is considered successful unless the communication failed,
+    /// the whole command failed, or the leases of this query are listed in
+    /// the response as failed (see @c checkLeaseUpdateBatchEntry).
+    ///
+    /// @param config Pointer to the configuration of the peer.
+    /// @param entries Lease updates of the queries in the batch.
+    /// @param command Pointer to the bulk apply command to be sent.
+    /// @tparam QueryPtrType Type of the pointer to the DHCP client's message,
+    /// i.e. Pkt4Ptr or Pkt6Ptr.
+    template<typename QueryPtrType>
+    void asyncSendLeaseUpdateBatch(const HAConfig::PeerConfigPtr& config,
+                                   const LeaseUpdateBatchEntries& entries,
+                                   const data::ConstElementPtr& command);
+
+    /// @brief Indexes the failed leases listed in the bulk apply response.
+    ///
+    /// @param args Arguments of the response. It may be null.
+    /// @param param_name Name of the list of the failed leases, i.e.
+    /// "failed-leases" or "failed-deleted-leases".
+    /// @param [out] index Index to which the failed leases are added.
+    static void indexFailedLeases(const data::ConstElementPtr& args,
+                                  const std::string& param_name,
+                                  FailedLeaseIndex& index);
+
+    /// @brief Checks if the lease updates for a query in the batch failed.
+    ///
+    /// It logs the failed lease updates of the query. In the DHCPv4 case,
+    /// the lease updates fail if any of the query's leases failed to be
+    /// created or updated. In the DHCPv6 case, they fail if none of the
+    /// query's lease changes has been applied, as for the non batched
+    /// @c lease6-bulk-apply.
+    ///
+    /// @param query Pointer to the DHCP client's query.
+    /// @param entry Lease updates of the query.
+    /// @param failed_leases Index of the leases which failed to be created
+    /// or updated.
+    /// @param failed_deleted_leases Index of the leases which failed to be
+    /// deleted.
+    /// @throw CtrlChannelError if the lease updates failed.
+    /// @throw ConflictError if the lease updates were rejected.
+    void checkLeaseUpdateBatchEntry(const dhcp::PktPtr& query,
+                                    const LeaseUpdateBatchEntry& entry,
+                                    const FailedLeaseIndex& failed_leases,
+                                    const FailedLeaseIndex& failed_deleted_leases) const;
+
     /// @brief Log failed lease updates.
     ///
     /// Logs failed lease updates included in the "failed-deleted-leases"
@@ -905,6 +1054,18 @@ protected:
                                  PostSyncCallback post_sync_action,
                                  const bool dhcp_disabled);
 
+    /// @brief Applies a lease fetched from the partner during synchronization.
+    ///
+    /// The lease is added to the local lease database when it does not
+    /// exist, or replaces the local lease when the local lease is older.
+    /// Leases not matching the lease synchronization filter are skipped.
+    ///
+    /// @param lease Pointer to the fetched lease.
+    /// @return true if the lease was added or updated, false if it was
+    /// skipped.
+    /// @throw any exception thrown by the lease manager.
+    bool syncLease(const dhcp::LeasePtr& lease);
+
 public:
 
     /// @brief Processes ha-sync command and returns a response.
@@ -1170,6 +1331,9 @@ protected:
     ///
     /// @param response pointer to the received response.
     /// @param [out] rcode result found in the response.
+    /// @param check_failed_leases indicates if the failed leases listed in
+    /// the response with the empty status code should be checked with
+    /// @c checkFailedLeases.
     /// @return Pointer to the response arguments.
     /// @throw CtrlChannelError if response is invalid or contains an error.
     /// @throw CommandUnsupportedError if sent command is unsupported.
@@ -1178,7 +1342,17 @@ protected:
     /// lease6-bulk-apply and there are leases with the conflict status
     /// codes listed in the response.
     data::ConstElementPtr verifyAsyncResponse(const http::HttpResponsePtr& response,
-                                              int& rcode);
+                                              int& rcode,
+                                              const bool check_failed_leases = true);
+
+    /// @brief Checks the failed leases listed in the bulk apply response.
+    ///
+    /// @param args Arguments of the response. It may be null.
+    /// @throw CtrlChannelError if any of the "failed-leases" has the error
+    /// status code.
+    /// @throw ConflictError if any of the "failed-leases" has the conflict
+    /// status code and none has the error status code.
+    static void checkFailedLeases(const data::ConstElementPtr& args);
 
     /// @brief HttpClient connect callback handler
     ///
@@ -1373,6 +1547,12 @@ protected:
     /// lease updates to the partner.
     LeaseUpdateBacklog lease_update_backlog_;
 
+    /// @brief Mutex to protect the lease update batches.
+    std::mutex batch_mutex_;
+
+    /// @brief Lease update batches indexed by the peer name.
+    std::map<std::string, LeaseUpdateBatchPtr> lease_update_batches_;
+
     /// @brief An indicator that a partner sent ha-sync-complete-notify command.
     ///
     /// This indicator is set when the partner finished synchronization. It blocks
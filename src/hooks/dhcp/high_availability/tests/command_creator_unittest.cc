@@ -248,6 +248,50 @@ TEST(CommandCreatorTest, createLease4Delete) {
     EXPECT_EQ(lease_as_json->str(), arguments->str());
 }
 
+// This test verifies that the lease4-bulk-apply command is correct.
+TEST(CommandCreatorTest, createLease4BulkApply) {
+    Lease4Ptr lease = createLease4();
+    Lease4Ptr deleted_lease = createLease4();
+    Lease4Ptr released_lease = createLease4();
+    released_lease->valid_lft_ = 0;
+    released_lease->state_ = Lease4::STATE_RELEASED;
+
+    Lease4CollectionPtr leases(new Lease4Collection());
+    Lease4CollectionPtr deleted_leases(new Lease4Collection());
+
+    leases->push_back(lease);
+    deleted_leases->push_back(deleted_lease);
+    deleted_leases->push_back(released_lease);
+
+    ConstElementPtr command = CommandCreator::createLease4BulkApply(leases, deleted_leases);
+    ConstElementPtr arguments;
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease4-bulk-apply",
+                                              "dhcp4", arguments));
+
+    ConstElementPtr origin = arguments->get("origin");
+    ASSERT_TRUE(origin);
+    ASSERT_EQ("ha-partner", origin->stringValue());
+
+    // Verify deleted-leases.
+    auto deleted_leases_json = arguments->get("deleted-leases");
+    ASSERT_TRUE(deleted_leases_json);
+    ASSERT_EQ(Element::list, deleted_leases_json->getType());
+    ASSERT_EQ(1, deleted_leases_json->size());
+    auto lease_as_json = deleted_leases_json->get(0);
+    EXPECT_EQ(leaseAsJson(deleted_lease)->str(), lease_as_json->str());
+
+    // Verify leases. The lease in the released state should be in the
+    // updated leases list.
+    auto leases_json = arguments->get("leases");
+    ASSERT_TRUE(leases_json);
+    ASSERT_EQ(Element::list, leases_json->getType());
+    ASSERT_EQ(2, leases_json->size());
+    lease_as_json = leases_json->get(0);
+    EXPECT_EQ(leaseAsJson(released_lease)->str(), lease_as_json->str());
+    lease_as_json = leases_json->get(1);
+    EXPECT_EQ(leaseAsJson(lease)->str(), lease_as_json->str());
+}
+
 // This test verifies that the lease4-get-all command is correct.
 TEST(CommandCreatorTest, createLease4GetAll) {
     ConstElementPtr command = CommandCreator::createLease4GetAll();
@@ -296,6 +340,27 @@ TEST(CommandCreatorTest, createLease4GetPageAddress) {
     EXPECT_EQ(15, limit->intValue());
 }
 
+// This test verifies that the lease4-get-page command requests the
+// binary format when asked to.
+TEST(CommandCreatorTest, createLease4GetPageBinary) {
+    Lease4Ptr lease4;
+    ConstElementPtr command = CommandCreator::createLease4GetPage(lease4, 10);
+    ConstElementPtr arguments;
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease4-get-page", "dhcp4",
+                                              arguments));
+    // The format is not set by default.
+    EXPECT_FALSE(arguments->get("format"));
+
+    command = CommandCreator::createLease4GetPage(lease4, 10, true);
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease4-get-page", "dhcp4",
+                                              arguments));
+
+    ConstElementPtr format = arguments->get("format");
+    ASSERT_TRUE(format);
+    ASSERT_EQ(Element::string, format->getType());
+    EXPECT_EQ("binary", format->stringValue());
+}
+
 // This test verifies that exception is thrown if limit is set to 0 while
 // creating lease4-get-page command.
 TEST(CommandCreatorTest, createLease4GetPageZeroLimit) {
@@ -553,6 +618,27 @@ TEST(CommandCreatorTest, createLease6GetPageAddress) {
     EXPECT_EQ(15, limit->intValue());
 }
 
+// This test verifies that the lease6-get-page command requests the
+// binary format when asked to.
+TEST(CommandCreatorTest, createLease6GetPageBinary) {
+    Lease6Ptr lease6;
+    ConstElementPtr command = CommandCreator::createLease6GetPage(lease6, 10);
+    ConstElementPtr arguments;
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease6-get-page", "dhcp6",
+                                              arguments));
+    // The format is not set by default.
+    EXPECT_FALSE(arguments->get("format"));
+
+    command = CommandCreator::createLease6GetPage(lease6, 10, true);
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease6-get-page", "dhcp6",
+                                              arguments));
+
+    ConstElementPtr format = arguments->get("format");
+    ASSERT_TRUE(format);
+    ASSERT_EQ(Element::string, format->getType());
+    EXPECT_EQ("binary", format->stringValue());
+}
+
 // This test verifies that exception is thrown if limit is set to 0 while
 // creating lease6-get-page command.
 TEST(CommandCreatorTest, createLease6GetPageZeroLimit) {
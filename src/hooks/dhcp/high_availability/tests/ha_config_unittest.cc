@@ -77,7 +77,10 @@ TEST_F(HAConfigTest, configureLoadBalancing) {
         "        \"sync-leases\": false,"
         "        \"sync-timeout\": 20000,"
         "        \"sync-page-limit\": 3,"
+        "        \"sync-format\": \"json\","
         "        \"delayed-updates-limit\": 111,"
+        "        \"lease-update-batch-size\": 50,"
+        "        \"lease-update-batch-delay\": 7,"
         "        \"heartbeat-delay\": 8,"
         "        \"max-response-delay\": 11,"
         "        \"max-ack-delay\": 5,"
@@ -134,8 +137,12 @@ TEST_F(HAConfigTest, configureLoadBalancing) {
     EXPECT_FALSE(impl->getConfig()->amSyncingLeases());
     EXPECT_EQ(20000, impl->getConfig()->getSyncTimeout());
     EXPECT_EQ(3, impl->getConfig()->getSyncPageLimit());
+    EXPECT_FALSE(impl->getConfig()->getSyncBinary());
     EXPECT_EQ(111, impl->getConfig()->getDelayedUpdatesLimit());
     EXPECT_TRUE(impl->getConfig()->amAllowingCommRecovery());
+    EXPECT_EQ(50, impl->getConfig()->getLeaseUpdateBatchSize());
+    EXPECT_EQ(7, impl->getConfig()->getLeaseUpdateBatchDelay());
+    EXPECT_TRUE(impl->getConfig()->amBatchingLeaseUpdates());
     EXPECT_EQ(8, impl->getConfig()->getHeartbeatDelay());
     EXPECT_EQ(11, impl->getConfig()->getMaxResponseDelay());
     EXPECT_EQ(5, impl->getConfig()->getMaxAckDelay());
@@ -261,8 +268,12 @@ TEST_F(HAConfigTest, configureHotStandby) {
     EXPECT_TRUE(impl->getConfig()->amSyncingLeases());
     EXPECT_EQ(60000, impl->getConfig()->getSyncTimeout());
     EXPECT_EQ(10000, impl->getConfig()->getSyncPageLimit());
+    EXPECT_TRUE(impl->getConfig()->getSyncBinary());
     EXPECT_EQ(0, impl->getConfig()->getDelayedUpdatesLimit());
     EXPECT_FALSE(impl->getConfig()->amAllowingCommRecovery());
+    EXPECT_EQ(0, impl->getConfig()->getLeaseUpdateBatchSize());
+    EXPECT_EQ(5, impl->getConfig()->getLeaseUpdateBatchDelay());
+    EXPECT_FALSE(impl->getConfig()->amBatchingLeaseUpdates());
     EXPECT_EQ(10000, impl->getConfig()->getHeartbeatDelay());
     EXPECT_EQ(10000, impl->getConfig()->getMaxAckDelay());
     EXPECT_EQ(10, impl->getConfig()->getMaxUnackedClients());
@@ -1367,6 +1378,63 @@ TEST_F(HAConfigTest, invalidUser) {
         "user 'foo:bar' must not contain a ':' in peer 'server2'");
 }
 
+// Test that the lease update batch delay must not be 0 when the lease
+// updates are batched.
+TEST_F(HAConfigTest, zeroLeaseUpdateBatchDelay) {
+    testInvalidConfig(
+        "["
+        "    {"
+        "        \"this-server-name\": \"server1\","
+        "        \"mode\": \"hot-standby\","
+        "        \"lease-update-batch-size\": 10,"
+        "        \"lease-update-batch-delay\": 0,"
+        "        \"peers\": ["
+        "            {"
+        "                \"name\": \"server1\","
+        "                \"url\": \"http://127.0.0.1:8080/\","
+        "                \"role\": \"primary\","
+        "                \"auto-failover\": false"
+        "            },"
+        "            {"
+        "                \"name\": \"server2\","
+        "                \"url\": \"http://127.0.0.1:8080/\","
+        "                \"role\": \"standby\","
+        "                \"auto-failover\": true"
+        "            }"
+        "        ]"
+        "    }"
+        "]",
+        "'lease-update-batch-delay' must be greater than 0 when"
+        " 'lease-update-batch-size' is set");
+}
+
+// Test that the lease synchronization format must be json or binary.
+TEST_F(HAConfigTest, invalidSyncFormat) {
+    testInvalidConfig(
+        "["
+        "    {"
+        "        \"this-server-name\": \"server1\","
+        "        \"mode\": \"hot-standby\","
+        "        \"sync-format\": \"csv\","
+        "        \"peers\": ["
+        "            {"
+        "                \"name\": \"server1\","
+        "                \"url\": \"http://127.0.0.1:8080/\","
+        "                \"role\": \"primary\","
+        "                \"auto-failover\": false"
+        "            },"
+        "            {"
+        "                \"name\": \"server2\","
+        "                \"url\": \"http://127.0.0.1:8080/\","
+        "                \"role\": \"standby\","
+        "                \"auto-failover\": true"
+        "            }"
+        "        ]"
+        "    }"
+        "]",
+        "'sync-format' value 'csv' is neither 'binary' nor 'json'");
+}
+
 // Test that setting delayed-updates-limit is not allowed in hot-standby mode.
 TEST_F(HAConfigTest, hotStandbyDelayedUpdatesLimit) {
     testInvalidConfig(
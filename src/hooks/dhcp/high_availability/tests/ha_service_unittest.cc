@@ -24,6 +24,7 @@
 #include <dhcp/pkt4.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/network_state.h>
@@ -37,6 +38,8 @@
 #include <http/response_creator.h>
 #include <http/response_creator_factory.h>
 #include <http/response_json.h>
+#include <util/buffer.h>
+#include <util/encode/encode.h>
 #include <util/multi_threading_mgr.h>
 #include <testutils/gtest_utils.h>
 #include <testutils/test_to_element.h>
@@ -677,6 +680,23 @@ public:
                                                        leases4_.begin() + last_index)));
     }
 
+    /// @brief Returns range of generated IPv4 leases in a base64 encoded
+    /// lease stream.
+    ///
+    /// @param first_index Index of the first lease to be returned.
+    /// @param last_index Index of the last lease to be returned.
+    ConstElementPtr getTestLeases4AsBinary(const size_t first_index,
+                                           const size_t last_index) const {
+        OutputBuffer buffer(0);
+        writeLeaseStreamHeader(buffer);
+        for (auto i = first_index; i < last_index; ++i) {
+            writeLeaseStreamRecord(buffer, *leases4_[i]);
+        }
+        std::vector<uint8_t> binary(buffer.getData(),
+                                    buffer.getData() + buffer.getLength());
+        return (Element::create(encode::encodeBase64(binary)));
+    }
+
     /// @brief Generates IPv6 leases to be used by the tests.
     void generateTestLeases6() {
         generateTestLeases(leases6_);
@@ -730,6 +750,29 @@ public:
         factory3_->getResponseCreator()->setArguments("lease4-get-page", response_arguments);
     }
 
+    /// @brief Configure server side to return IPv4 leases in 3-element
+    /// chunks in the binary format.
+    ///
+    /// @param last_in_list return the last lease of each chunk in the list
+    /// of leases along with the lease stream, as for a lease which can't
+    /// be written in the stream.
+    void createPagedSyncResponsesBinary4(bool last_in_list = false) {
+        for (size_t first = 0; first < leases4_.size(); first += 3) {
+            size_t last = std::min(first + 3, leases4_.size());
+            ElementPtr response_arguments = Element::createMap();
+            if (last_in_list) {
+                response_arguments->set("leases-binary", getTestLeases4AsBinary(first, last - 1));
+                response_arguments->set("leases", getTestLeases4AsJson(last - 1, last));
+            } else {
+                response_arguments->set("leases-binary", getTestLeases4AsBinary(first, last));
+            }
+            response_arguments->set("count", Element::create(static_cast<int64_t>(last - first)));
+            factory_->getResponseCreator()->setArguments("lease4-get-page", response_arguments);
+            factory2_->getResponseCreator()->setArguments("lease4-get-page", response_arguments);
+            factory3_->getResponseCreator()->setArguments("lease4-get-page", response_arguments);
+        }
+    }
+
     /// @brief Configure server side to return  IPv6 leases in 3-element
     /// chunks.
     ///
@@ -1216,6 +1259,94 @@ public:
         EXPECT_TRUE(soft_delete_request3);
     }
 
+    /// @brief Tests that DHCPv4 lease updates for different queries are sent
+    /// in a single lease4-bulk-apply command when batching is enabled.
+    ///
+    /// @param fail_second indicates if the partner should return the lease
+    /// of the second query as failed.
+    void testSendBatchedUpdates(const bool fail_second) {
+        // Start HTTP servers.
+        ASSERT_NO_THROW({
+                listener_->start();
+                listener2_->start();
+                listener3_->start();
+        });
+
+        if (fail_second) {
+            ElementPtr failed_lease = Element::createMap();
+            failed_lease->set("ip-address", Element::create("192.1.2.4"));
+            failed_lease->set("type", Element::create("V4"));
+            failed_lease->set("result", Element::create(CONTROL_RESULT_ERROR));
+            failed_lease->set("error-message", Element::create("database error"));
+            ElementPtr failed_leases = Element::createList();
+            failed_leases->add(failed_lease);
+            ElementPtr arguments = Element::createMap();
+            arguments->set("failed-leases", failed_leases);
+            factory2_->getResponseCreator()->setArguments("lease4-bulk-apply", arguments);
+        }
+
+        // Create HA configuration for 3 servers. This server is
+        // server 1. The batch is sent after 100ms unless it holds
+        // 10 leases.
+        HAConfigPtr config_storage = createValidConfiguration();
+        config_storage->setLeaseUpdateBatchSize(10);
+        config_storage->setLeaseUpdateBatchDelay(100);
+        setBasicAuth(config_storage);
+        createSTService(network_state_, config_storage);
+        service_->transition(HA_LOAD_BALANCING_ST, HAService::NOP_EVT);
+
+        ParkingLotPtr parking_lot(new ParkingLot());
+        ParkingLotHandlePtr parking_lot_handle(new ParkingLotHandle(parking_lot));
+        HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+        Lease4CollectionPtr deleted_leases4(new Lease4Collection());
+
+        // Schedule lease updates for two queries.
+        std::vector<Pkt4Ptr> queries;
+        std::vector<bool> unpark_called(2, false);
+        for (auto i = 0; i < 2; ++i) {
+            Pkt4Ptr query(new Pkt4(DHCPREQUEST, 1234 + i));
+            Lease4CollectionPtr leases4(new Lease4Collection());
+            Lease4Ptr lease4(new Lease4(IOAddress(0xC0010203 + i), hwaddr,
+                                        static_cast<const uint8_t*>(0), 0,
+                                        60, 0, 1));
+            leases4->push_back(lease4);
+            EXPECT_EQ(1, service_->asyncSendLeaseUpdates(query, leases4, deleted_leases4,
+                                                         parking_lot_handle));
+            // One pending request to the partner for each query.
+            EXPECT_EQ(1, service_->getPendingRequest(query));
+            ASSERT_NO_THROW(parking_lot->park(query, [&unpark_called, i] {
+                unpark_called[i] = true;
+            }));
+            ASSERT_NO_THROW(parking_lot->reference(query));
+            queries.push_back(query);
+        }
+
+        // Nothing has been sent yet.
+        EXPECT_TRUE(factory2_->getResponseCreator()->getReceivedRequests().empty());
+
+        // Send the batch and wait for the responses.
+        ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [this]() {
+            return (service_->pendingRequestSize() == 0);
+        }));
+
+        // The first query should always be unparked.
+        EXPECT_TRUE(unpark_called[0]);
+        // The second query should be dropped if its lease update failed.
+        EXPECT_NE(fail_second, unpark_called[1]);
+
+        // The server 2 should have received one command including both leases.
+        EXPECT_EQ(1, factory2_->getResponseCreator()->getReceivedRequests().size());
+        EXPECT_TRUE(factory2_->getResponseCreator()->findRequest("lease4-bulk-apply",
+                                                                 "192.1.2.3",
+                                                                 "192.1.2.4"));
+
+        // The backup server should have received the same command.
+        EXPECT_EQ(1, factory3_->getResponseCreator()->getReceivedRequests().size());
+        EXPECT_TRUE(factory3_->getResponseCreator()->findRequest("lease4-bulk-apply",
+                                                                 "192.1.2.3",
+                                                                 "192.1.2.4"));
+    }
+
     /// @brief Tests that DHCPv4 lease updates are queued when the server is in the
     /// communication-recovery state and later sent before transitioning back to
     /// the load-balancing state.
@@ -2764,6 +2895,30 @@ TEST_F(HAServiceTest, sendSuccessfulUpdatesSoftDeleteMultiThreading) {
     testSendSuccessfulUpdatesSoftDelete();
 }
 
+// Test that lease updates for different queries are batched.
+TEST_F(HAServiceTest, sendBatchedUpdates) {
+    testSendBatchedUpdates(false);
+}
+
+// Test that lease updates for different queries are batched.
+TEST_F(HAServiceTest, sendBatchedUpdatesMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+    testSendBatchedUpdates(false);
+}
+
+// Test that a lease update failure for a query in the batch drops only
+// this query.
+TEST_F(HAServiceTest, sendBatchedUpdatesPartialFailure) {
+    testSendBatchedUpdates(true);
+}
+
+// Test that a lease update failure for a query in the batch drops only
+// this query.
+TEST_F(HAServiceTest, sendBatchedUpdatesPartialFailureMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+    testSendBatchedUpdates(true);
+}
+
 // Test scenario when lease updates are queued in the communication-recovery
 // state for later send.
 TEST_F(HAServiceTest, sendUpdatesCommunicationRecovery) {
@@ -3526,6 +3681,178 @@ TEST_F(HAServiceTest, asyncSyncLeases4) {
     }
 }
 
+// This test verifies that IPv4 leases fetched from the peer in the binary
+// format are inserted or updated in the local lease database.
+TEST_F(HAServiceTest, asyncSyncLeases4Binary) {
+    // Create lease manager.
+    ASSERT_NO_THROW(LeaseMgrFactory::create("universe=4 type=memfile persist=false"));
+
+    // Create IPv4 leases which will be fetched from the other server.
+    ASSERT_NO_THROW(generateTestLeases4());
+
+    for (size_t i = 0; i < leases4_.size(); ++i) {
+        // For every even lease index we add this lease to the database to exercise
+        // the scenario when a lease is already in the database and may be updated
+        // by the lease synchronization procedure.
+        if ((i % 2) == 0) {
+            Lease4Ptr lease_to_add(new Lease4(*leases4_[i]));
+            --lease_to_add->valid_lft_;
+            LeaseMgrFactory::instance().addLease(lease_to_add);
+        }
+    }
+
+    // The first lease is newer on the partner and should be updated.
+    ++leases4_[0]->cltt_;
+
+    // The third lease is older on the partner and should be skipped.
+    --leases4_[2]->cltt_;
+
+    // Create HA configuration.
+    HAConfigPtr config_storage = createValidConfiguration();
+    setBasicAuth(config_storage);
+
+    // The servers return the leases in lease streams, in 3-element chunks.
+    createPagedSyncResponsesBinary4();
+
+    // Start the servers.
+    ASSERT_NO_THROW({
+        listener_->start();
+        listener2_->start();
+        listener3_->start();
+    });
+
+    TestHAService service(1, io_service_, network_state_, config_storage);
+    // Setting the heartbeat delay to 0 disables the recurring heartbeat.
+    // We just want to synchronize leases and not send the heartbeat.
+    config_storage->setHeartbeatDelay(0);
+
+    // Start fetching leases asynchronously.
+    ASSERT_NO_THROW(service.asyncSyncLeases());
+
+    // Run IO service to actually perform the transaction.
+    ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [this]() {
+        // Stop running the IO service when the last lease is in the
+        // lease database.
+        return (static_cast<bool>(LeaseMgrFactory::instance().getLease4(leases4_.back()->addr_)));
+    }));
+
+    // The leases were requested in the binary format.
+    EXPECT_TRUE(factory2_->getResponseCreator()->findRequest("lease4-get-page",
+                                                             "\"format\": \"binary\""));
+
+    // Check if all leases have been stored in the local database.
+    for (size_t i = 0; i < leases4_.size(); ++i) {
+        Lease4Ptr existing_lease = LeaseMgrFactory::instance().getLease4(leases4_[i]->addr_);
+        ASSERT_TRUE(existing_lease) << "lease " << leases4_[i]->addr_.toText()
+                                    << " not in the lease database";
+        if (i == 2) {
+            // The stale lease was not updated.
+            EXPECT_LT(leases4_[i]->cltt_, existing_lease->cltt_);
+            EXPECT_NE(leases4_[i]->valid_lft_, existing_lease->valid_lft_);
+
+        } else {
+            EXPECT_EQ(leases4_[i]->cltt_, existing_lease->cltt_);
+            if ((i != 0) && (i % 2) == 0) {
+                EXPECT_EQ(leases4_[i]->valid_lft_ - 1, existing_lease->valid_lft_);
+            } else {
+                EXPECT_EQ(leases4_[i]->valid_lft_, existing_lease->valid_lft_);
+            }
+        }
+    }
+}
+
+// This test verifies that the leases returned in the list along with the
+// lease stream are applied and end the pages.
+TEST_F(HAServiceTest, asyncSyncLeases4BinaryWithList) {
+    // Create lease manager.
+    ASSERT_NO_THROW(LeaseMgrFactory::create("universe=4 type=memfile persist=false"));
+
+    // Create IPv4 leases which will be fetched from the other server.
+    ASSERT_NO_THROW(generateTestLeases4());
+
+    // Create HA configuration.
+    HAConfigPtr config_storage = createValidConfiguration();
+    setBasicAuth(config_storage);
+
+    // The last lease of each 3-element chunk is in the list.
+    createPagedSyncResponsesBinary4(true);
+
+    // Start the servers.
+    ASSERT_NO_THROW({
+        listener_->start();
+        listener2_->start();
+        listener3_->start();
+    });
+
+    TestHAService service(1, io_service_, network_state_, config_storage);
+    // Setting the heartbeat delay to 0 disables the recurring heartbeat.
+    // We just want to synchronize leases and not send the heartbeat.
+    config_storage->setHeartbeatDelay(0);
+
+    // Start fetching leases asynchronously.
+    ASSERT_NO_THROW(service.asyncSyncLeases());
+
+    // Run IO service to actually perform the transaction.
+    ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [this]() {
+        // Stop running the IO service when the last lease is in the
+        // lease database.
+        return (static_cast<bool>(LeaseMgrFactory::instance().getLease4(leases4_.back()->addr_)));
+    }));
+
+    // Check if all leases have been stored in the local database.
+    for (auto const& lease : leases4_) {
+        EXPECT_TRUE(LeaseMgrFactory::instance().getLease4(lease->addr_))
+            << "lease " << lease->addr_.toText() << " not in the lease database";
+    }
+}
+
+// This test verifies that a lease stream in an unsupported version fails
+// the synchronization.
+TEST_F(HAServiceTest, asyncSyncLeases4BinaryVersion) {
+    // Create lease manager.
+    ASSERT_NO_THROW(LeaseMgrFactory::create("universe=4 type=memfile persist=false"));
+
+    // Create IPv4 leases which will be fetched from the other server.
+    ASSERT_NO_THROW(generateTestLeases4());
+
+    // Create HA configuration.
+    HAConfigPtr config_storage = createValidConfiguration();
+    // Setting the heartbeat delay to 0 disables the recurring heartbeat.
+    // We just want to synchronize leases and not send the heartbeat.
+    config_storage->setHeartbeatDelay(0);
+
+    // The servers return the leases in a stream of a later version.
+    OutputBuffer buffer(0);
+    buffer.writeUint8(LeaseJournal4::FORMAT_VERSION + 1);
+    writeLeaseStreamRecord(buffer, *leases4_[0]);
+    std::vector<uint8_t> binary(buffer.getData(),
+                                buffer.getData() + buffer.getLength());
+    ElementPtr response_arguments = Element::createMap();
+    response_arguments->set("leases-binary",
+                            Element::create(encode::encodeBase64(binary)));
+    response_arguments->set("count", Element::create(1));
+    factory2_->getResponseCreator()->setArguments(response_arguments);
+    factory3_->getResponseCreator()->setArguments(response_arguments);
+
+    // Start the servers.
+    ASSERT_NO_THROW({
+        listener_->start();
+        listener2_->start();
+        listener3_->start();
+    });
+
+    TestHAService service(1, io_service_, network_state_, config_storage);
+
+    // Start fetching leases asynchronously.
+    ASSERT_NO_THROW(service.asyncSyncLeases());
+
+    // Run IO service to actually perform the transaction.
+    ASSERT_NO_THROW(runIOService(1000));
+
+    // The lease was not applied.
+    EXPECT_FALSE(LeaseMgrFactory::instance().getLease4(leases4_[0]->addr_));
+}
+
 // This test verifies that IPv4 leases can be fetched from the peer and inserted
 // or updated in the local lease database.
 TEST_F(HAServiceTest, asyncSyncLeases4Authorized) {
@@ -13,6 +13,7 @@
 #include <database/db_exceptions.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/dhcpsrv_exceptions.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/ncr_generator.h>
@@ -136,6 +137,18 @@ public:
     int
     leaseAddHandler(CalloutHandle& handle);
 
+    /// @brief lease4-bulk-apply command handler
+    ///
+    /// Provides the implementation for the
+    /// @ref isc::lease_cmds::LeaseCmds::lease4BulkApplyHandler.
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// add command JSON text in the "command" argument
+    ///
+    /// @return 0 upon success, non-zero otherwise
+    int
+    lease4BulkApplyHandler(CalloutHandle& handle);
+
     /// @brief lease6-bulk-apply command handler
     ///
     /// Provides the implementation for the
@@ -181,7 +194,11 @@ public:
     /// starts from the first address following the address specified by
     /// the caller. If the first page should be returned the IPv4
     /// zero address, IPv6 zero address or the keyword "start" should
-    /// be provided instead of the last address.
+    /// be provided instead of the last address. The optional "format"
+    /// parameter set to "binary" returns the leases as a base64 encoded
+    /// lease stream (see @c writeLeaseStreamRecord) in "leases-binary"
+    /// instead of a list of lease maps in "leases". The leases which can't
+    /// be written in the stream are still returned in "leases".
     ///
     /// @param handle Callout context - which is expected to contain the
     /// get commands JSON text in the "command" argument.
@@ -369,6 +386,22 @@ public:
     /// @throw InvalidOperation if the query type is unknown.
     Lease6Ptr getIPv6LeaseForDelete(const Parameters& parameters) const;
 
+    /// @brief Convenience function fetching an IPv4 lease to be deleted.
+    ///
+    /// If the query type is of the address type and the lease does not
+    /// exist, a lease holding only the address is returned. If the query
+    /// type is HW address or client identifier, this function tries to
+    /// find the lease in the subnet and returns null if it does not exist.
+    ///
+    /// @param parameters parameters extracted from the command.
+    ///
+    /// @return Lease to be deleted or null.
+    ///
+    /// @throw InvalidParameter if the query type is DUID or the identifier
+    /// is missing.
+    /// @throw InvalidOperation if the query type is unknown.
+    Lease4Ptr getIPv4LeaseForDelete(const Parameters& parameters) const;
+
     /// @brief Returns a map holding brief information about a lease which
     /// failed to be deleted, updated or added.
     ///
@@ -1444,16 +1477,49 @@ LeaseCmdsImpl::leaseGetPageHandler(CalloutHandle& handle) {
         // Retrieve the desired page size.
         size_t page_limit_value = static_cast<size_t>(page_limit->intValue());
 
+        // The optional 'format' selects how the leases are returned: as
+        // a list of lease maps (json) or as a lease stream (binary).
+        bool binary = false;
+        ConstElementPtr format = cmd_args_->get("format");
+        if (format) {
+            if (format->getType() != Element::string) {
+                isc_throw(BadValue, "'format' parameter must be a string");
+            }
+            if (format->stringValue() == "binary") {
+                binary = true;
+            } else if (format->stringValue() != "json") {
+                isc_throw(BadValue, "'format' parameter value '"
+                          << format->stringValue() << "' is neither 'json'"
+                          " nor 'binary'");
+            }
+        }
+
         ElementPtr leases_json = Element::createList();
+        OutputBuffer leases_binary(0);
+        if (binary) {
+            writeLeaseStreamHeader(leases_binary);
+        }
+        size_t count = 0;
 
         if (v4) {
             // Get page of IPv4 leases.
             Lease4Collection leases =
                 LeaseMgrFactory::instance().getLeases4(*from_address,
                                                        LeasePageSize(page_limit_value));
+            count = leases.size();
 
-            // Convert leases into JSON list.
+            // Convert leases into JSON list or lease stream.
             for (auto const& lease : leases) {
+                if (binary) {
+                    try {
+                        writeLeaseStreamRecord(leases_binary, *lease);
+                        continue;
+                    } catch (const std::exception&) {
+                        // The lease can't be encoded, e.g. it has no
+                        // identifier: return it in the list so the page
+                        // remains complete.
+                    }
+                }
                 ElementPtr lease_json = lease->toElement();
                 leases_json->add(lease_json);
             }
@@ -1463,8 +1529,20 @@ LeaseCmdsImpl::leaseGetPageHandler(CalloutHandle& handle) {
             Lease6Collection leases =
                 LeaseMgrFactory::instance().getLeases6(*from_address,
                                                        LeasePageSize(page_limit_value));
-            // Convert leases into JSON list.
+            count = leases.size();
+
+            // Convert leases into JSON list or lease stream.
             for (auto const& lease : leases) {
+                if (binary) {
+                    try {
+                        writeLeaseStreamRecord(leases_binary, *lease);
+                        continue;
+                    } catch (const std::exception&) {
+                        // The lease can't be encoded, e.g. it has no
+                        // identifier: return it in the list so the page
+                        // remains complete.
+                    }
+                }
                 ElementPtr lease_json = lease->toElement();
                 leases_json->add(lease_json);
             }
@@ -1472,18 +1550,26 @@ LeaseCmdsImpl::leaseGetPageHandler(CalloutHandle& handle) {
 
         // Prepare textual status.
         std::ostringstream s;
-        s << leases_json->size()
+        s << count
           << " IPv" << (v4 ? "4" : "6")
           << " lease(s) found.";
         ElementPtr args = Element::createMap();
 
-        // Put gathered data into arguments map.
-        args->set("leases", leases_json);
-        args->set("count", Element::create(static_cast<int64_t>(leases_json->size())));
+        // Put gathered data into arguments map. The leases which are not
+        // in the lease stream are in the list.
+        if (binary) {
+            const uint8_t* data = leases_binary.getData();
+            std::vector<uint8_t> binary_data(data, data + leases_binary.getLength());
+            args->set("leases-binary", Element::create(encode::encodeBase64(binary_data)));
+        }
+        if (!binary || !leases_json->empty()) {
+            args->set("leases", leases_json);
+        }
+        args->set("count", Element::create(static_cast<int64_t>(count)));
 
         // Create the response.
         ConstElementPtr response =
-            createAnswer(leases_json->size() > 0 ?
+            createAnswer(count > 0 ?
                          CONTROL_RESULT_SUCCESS :
                          CONTROL_RESULT_EMPTY,
                          s.str(), args);
@@ -1796,6 +1882,216 @@ LeaseCmdsImpl::lease4DelHandler(CalloutHandle& handle) {
     return (0);
 }
 
+int
+LeaseCmdsImpl::lease4BulkApplyHandler(CalloutHandle& handle) {
+    try {
+        extractCommand(handle);
+
+        // Arguments are mandatory.
+        if (!cmd_args_ || (cmd_args_->getType() != Element::map)) {
+            isc_throw(BadValue, "Command arguments missing or a not a map.");
+        }
+
+        // At least one of the 'deleted-leases' or 'leases' must be present.
+        auto deleted_leases = cmd_args_->get("deleted-leases");
+        auto leases = cmd_args_->get("leases");
+
+        if (!deleted_leases && !leases) {
+            isc_throw(BadValue, "neither 'deleted-leases' nor 'leases' parameter"
+                      " specified");
+        }
+
+        // Make sure that 'deleted-leases' is a list, if present.
+        if (deleted_leases && (deleted_leases->getType() != Element::list)) {
+            isc_throw(BadValue, "the 'deleted-leases' parameter must be a list");
+        }
+
+        // Make sure that 'leases' is a list, if present.
+        if (leases && (leases->getType() != Element::list)) {
+            isc_throw(BadValue, "the 'leases' parameter must be a list");
+        }
+
+        // Parse deleted leases without deleting them from the database
+        // yet. If any of the deleted leases or new leases appears to be
+        // malformed we can easily rollback.
+        std::list<std::pair<Parameters, Lease4Ptr> > parsed_deleted_list;
+        if (deleted_leases) {
+            auto leases_list = deleted_leases->listValue();
+
+            // Iterate over leases to be deleted.
+            for (auto const& lease_params : leases_list) {
+                // Parsing the lease may throw and it means that the lease
+                // information is malformed.
+                Parameters p = getParameters(false, lease_params);
+                auto lease = getIPv4LeaseForDelete(p);
+                parsed_deleted_list.push_back(std::make_pair(p, lease));
+            }
+        }
+
+        // Parse new/updated leases without affecting the database to detect
+        // any errors that should cause an error response.
+        std::list<Lease4Ptr> parsed_leases_list;
+        if (leases) {
+            ConstSrvConfigPtr config = CfgMgr::instance().getCurrentCfg();
+
+            // Iterate over all leases.
+            auto leases_list = leases->listValue();
+            for (auto const& lease_params : leases_list) {
+
+                Lease4Parser parser;
+                bool force_update;
+
+                // If parsing the lease fails we throw, as it indicates that the
+                // command is malformed.
+                Lease4Ptr lease4 = parser.parse(config, lease_params, force_update);
+                parsed_leases_list.push_back(lease4);
+            }
+        }
+
+        // Count successful deletions and updates.
+        size_t success_count = 0;
+
+        ElementPtr failed_deleted_list;
+        if (!parsed_deleted_list.empty()) {
+
+            // Iterate over leases to be deleted.
+            for (auto const& lease_params_pair : parsed_deleted_list) {
+
+                // This part is outside of the try-catch because an exception
+                // indicates that the command is malformed.
+                Parameters p = lease_params_pair.first;
+                auto lease = lease_params_pair.second;
+
+                try {
+                    if (lease) {
+                        // This may throw if the lease couldn't be deleted for
+                        // any reason, but we still want to proceed with other
+                        // leases.
+                        if (LeaseMgrFactory::instance().deleteLease(lease)) {
+                            ++success_count;
+                            LeaseCmdsImpl::updateStatsOnDelete(lease);
+
+                        } else {
+                            // Lazy creation of the list of leases which failed to delete.
+                            if (!failed_deleted_list) {
+                                failed_deleted_list = Element::createList();
+                            }
+
+                            // If the lease doesn't exist we also want to put it
+                            // on the list of leases which failed to delete. That
+                            // corresponds to the lease4-del command which returns
+                            // an error when the lease doesn't exist.
+                            failed_deleted_list->add(createFailedLeaseMap(Lease::TYPE_V4,
+                                                                          lease->addr_,
+                                                                          DuidPtr(),
+                                                                          CONTROL_RESULT_EMPTY,
+                                                                          "lease not found"));
+                        }
+                    }
+
+                } catch (const std::exception& ex) {
+                    // Lazy creation of the list of leases which failed to delete.
+                    if (!failed_deleted_list) {
+                         failed_deleted_list = Element::createList();
+                    }
+                    failed_deleted_list->add(createFailedLeaseMap(Lease::TYPE_V4,
+                                                                  lease->addr_,
+                                                                  DuidPtr(),
+                                                                  CONTROL_RESULT_ERROR,
+                                                                  ex.what()));
+                }
+            }
+        }
+
+        // Process leases to be added or/and updated.
+        ElementPtr failed_leases_list;
+        if (!parsed_leases_list.empty()) {
+            // Iterate over all leases.
+            for (auto const& lease : parsed_leases_list) {
+
+                auto result = CONTROL_RESULT_SUCCESS;
+                std::ostringstream text;
+                try {
+                    if (!MultiThreadingMgr::instance().getMode()) {
+                        // Not multi-threading.
+                        addOrUpdate4(lease, true);
+                    } else {
+                        // Multi-threading, try to lock first to avoid a race.
+                        ResourceHandler4 resource_handler;
+                        if (resource_handler.tryLock4(lease->addr_)) {
+                            addOrUpdate4(lease, true);
+                        } else {
+                            isc_throw(LeaseCmdsConflict,
+                                      "ResourceBusy: IP address:" << lease->addr_
+                                      << " could not be updated.");
+                        }
+                    }
+
+                    ++success_count;
+                } catch (const LeaseCmdsConflict& ex) {
+                    result = CONTROL_RESULT_CONFLICT;
+                    text << ex.what();
+
+                } catch (const std::exception& ex) {
+                    result = CONTROL_RESULT_ERROR;
+                    text << ex.what();
+                }
+                // Handle an error.
+                if (result != CONTROL_RESULT_SUCCESS) {
+                    // Lazy creation of the list of leases which failed to add/update.
+                    if (!failed_leases_list) {
+                        failed_leases_list = Element::createList();
+                    }
+                    failed_leases_list->add(createFailedLeaseMap(Lease::TYPE_V4,
+                                                                 lease->addr_,
+                                                                 DuidPtr(),
+                                                                 result,
+                                                                 text.str()));
+                }
+            }
+        }
+
+        // Start preparing the response.
+        ElementPtr args;
+
+        if (failed_deleted_list || failed_leases_list) {
+            // If there are any failed leases, let's include them in the response.
+            args = Element::createMap();
+
+            // failed-deleted-leases
+            if (failed_deleted_list) {
+                args->set("failed-deleted-leases", failed_deleted_list);
+            }
+
+            // failed-leases
+            if (failed_leases_list) {
+                args->set("failed-leases", failed_leases_list);
+            }
+        }
+
+        // Send the success response and include failed leases.
+        std::ostringstream resp_text;
+        resp_text << "Bulk apply of " << success_count << " IPv4 leases completed.";
+        auto answer = createAnswer(success_count > 0 ? CONTROL_RESULT_SUCCESS :
+                                   CONTROL_RESULT_EMPTY, resp_text.str(), args);
+        setResponse(handle, answer);
+
+        LOG_DEBUG(lease_cmds_logger, LEASE_CMDS_DBG_COMMAND_DATA,
+                  LEASE_CMDS_BULK_APPLY4)
+            .arg(success_count);
+
+    } catch (const std::exception& ex) {
+        // Unable to parse the command and similar issues.
+        LOG_ERROR(lease_cmds_logger, LEASE_CMDS_BULK_APPLY4_FAILED)
+            .arg(cmd_args_ ? cmd_args_->str() : "<no args>")
+            .arg(ex.what());
+        setErrorResponse(handle, ex.what());
+        return (CONTROL_RESULT_ERROR);
+    }
+
+    return (0);
+}
+
 int
 LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
     try {
@@ -2508,6 +2804,56 @@ LeaseCmdsImpl::getIPv6LeaseForDelete(const Parameters& parameters) const {
     return (lease6);
 }
 
+Lease4Ptr
+LeaseCmdsImpl::getIPv4LeaseForDelete(const Parameters& parameters) const {
+    Lease4Ptr lease4;
+
+    switch (parameters.query_type) {
+    case Parameters::TYPE_ADDR: {
+        // If address was specified explicitly, let's use it as is.
+
+        // Let's see if there's such a lease at all.
+        lease4 = LeaseMgrFactory::instance().getLease4(parameters.addr);
+        if (!lease4) {
+            lease4.reset(new Lease4());
+            lease4->addr_ = parameters.addr;
+        }
+        break;
+    }
+    case Parameters::TYPE_HWADDR: {
+        if (!parameters.hwaddr) {
+            isc_throw(InvalidParameter, "Program error: Query by hw-address "
+                      "requires hwaddr to be specified");
+        }
+
+        // Let's see if there's such a lease at all.
+        lease4 = LeaseMgrFactory::instance().getLease4(*parameters.hwaddr,
+                                                       parameters.subnet_id);
+        break;
+    }
+    case Parameters::TYPE_CLIENT_ID: {
+        if (!parameters.client_id) {
+            isc_throw(InvalidParameter, "Program error: Query by client-id "
+                      "requires client-id to be specified");
+        }
+
+        // Let's see if there's such a lease at all.
+        lease4 = LeaseMgrFactory::instance().getLease4(*parameters.client_id,
+                                                       parameters.subnet_id);
+        break;
+    }
+    case Parameters::TYPE_DUID: {
+        isc_throw(InvalidParameter, "Delete by duid is not allowed in v4.");
+        break;
+    }
+    default:
+        isc_throw(InvalidOperation, "Unknown query type: "
+                  << static_cast<int>(parameters.query_type));
+    }
+
+    return (lease4);
+}
+
 IOAddress
 LeaseCmdsImpl::getAddressParam(ConstElementPtr params, const std::string name,
                                short family) const {
@@ -2703,6 +3049,11 @@ LeaseCmds::leaseAddHandler(CalloutHandle& handle) {
     return (impl_->leaseAddHandler(handle));
 }
 
+int
+LeaseCmds::lease4BulkApplyHandler(CalloutHandle& handle) {
+    return (impl_->lease4BulkApplyHandler(handle));
+}
+
 int
 LeaseCmds::lease6BulkApplyHandler(CalloutHandle& handle) {
     return (impl_->lease6BulkApplyHandler(handle));
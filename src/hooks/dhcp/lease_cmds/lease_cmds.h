@@ -81,6 +81,47 @@ public:
     int
     leaseAddHandler(hooks::CalloutHandle& handle);
 
+    /// @brief lease4-bulk-apply command handler
+    ///
+    /// This command conveys information about multiple IPv4 leases to be
+    /// added, updated or deleted. It is the IPv4 counterpart of the
+    /// lease6-bulk-apply command. High Availability uses it to send the
+    /// lease updates of many DHCP queries to a partner in a single request.
+    ///
+    /// @note Like lease6-bulk-apply, this command does not support
+    /// "update-ddns" and does not generate CHG_REMOVEs for deleted leases.
+    ///
+    /// Example structure of the command:
+    ///
+    /// {
+    ///     "command": "lease4-bulk-apply",
+    ///     "arguments": {
+    ///         "deleted-leases": [
+    ///             {
+    ///                 "ip-address": "192.0.2.1",
+    ///                 ...
+    ///             }
+    ///         ],
+    ///         "leases": [
+    ///             {
+    ///                 "subnet-id": 44,
+    ///                 "ip-address": "192.0.2.2",
+    ///                 "hw-address": "1a:1b:1c:1d:1e:1f",
+    ///                 ...
+    ///             }
+    ///         ]
+    ///     }
+    /// }
+    ///
+    /// The response has the same structure as the response to the
+    /// lease6-bulk-apply command.
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// add command JSON text in the "command" argument
+    /// @return result of the operation
+    int
+    lease4BulkApplyHandler(hooks::CalloutHandle& handle);
+
     /// @brief lease6-bulk-apply command handler
     ///
     /// This command conveys information about multiple leases to be added,
@@ -254,6 +295,13 @@ public:
     /// returned the IPv4 zero address, IPv6 zero address or the keyword
     /// "start" should be provided instead of the last address.
     ///
+    /// When the "format" parameter is set to "binary", the leases are
+    /// returned as a base64 encoded lease stream in the "leases-binary"
+    /// argument. It is much cheaper to produce and to parse than the
+    /// list of lease maps, and it is used by the HA lease synchronization.
+    /// The leases which can't be written in the stream, e.g. without
+    /// identifier, are returned in the "leases" list along with it.
+    ///
     /// @param handle Callout context - which is expected to contain the
     /// get commands JSON text in the "command" argument.
     /// @return 0 if the handler has been invoked successfully, 1 if an
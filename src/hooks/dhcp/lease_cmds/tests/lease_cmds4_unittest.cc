@@ -10,6 +10,7 @@
 #include <hooks/hooks_manager.h>
 #include <config/command_mgr.h>
 #include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/ncr_generator.h>
 #include <dhcpsrv/cfgmgr.h>
@@ -20,6 +21,7 @@
 #include <stats/stats_mgr.h>
 #include <testutils/user_context_utils.h>
 #include <testutils/multi_threading_utils.h>
+#include <util/encode/encode.h>
 
 #include <gtest/gtest.h>
 
@@ -237,6 +239,17 @@ public:
     /// @brief Check that multiple calls to lease4-get-page return all leases.
     void testLease4GetPaged();
 
+    /// @brief Check that lease4-get-page returns a lease stream in the
+    /// binary format.
+    void testLease4GetPagedBinary();
+
+    /// @brief Check that lease4-get-page returns the leases which can't
+    /// be written in the lease stream in the list.
+    void testLease4GetPagedBinaryNoIdentifier();
+
+    /// @brief Verifies that an invalid format is rejected.
+    void testLease4GetPagedInvalidFormat();
+
     /// @brief Verifies that first page of IPv4 leases can be retrieved by
     /// specifying zero IPv4 address.
     void testLease4GetPagedZeroAddress();
@@ -336,6 +349,18 @@ public:
     /// 'force-create' parameter is explicitly set to false.
     void testLease4UpdateDoNotForceCreate();
 
+    /// @brief This test verifies that it is possible to add two leases and
+    /// delete two leases as a result of the single lease4-bulk-apply command.
+    void testLease4BulkApply();
+
+    /// @brief This test verifies that deleting non existing leases with the
+    /// lease4-bulk-apply returns an 'empty' result.
+    void testLease4BulkApplyDeleteNonExiting();
+
+    /// @brief Check that changes for other leases are not applied by the
+    /// lease4-bulk-apply if one of the leases is malformed.
+    void testLease4BulkApplyRollback();
+
     /// @brief Check that a lease4 can be updated. We're adding a comment and an
     /// user context.
     void testLease4UpdateComment();
@@ -1624,6 +1649,171 @@ void Lease4CmdsTest::testLease4GetPaged() {
     EXPECT_EQ(1, lease_addresses.count("192.0.3.2"));
 }
 
+void Lease4CmdsTest::testLease4GetPagedBinary() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // Gather all returned addresses to verify that all were returned.
+    std::set<std::string> lease_addresses;
+
+    // Keyword start indicates that we want to retrieve the first page.
+    std::string last_address = "start";
+
+    // There are 4 leases in the database, so the first two pages should
+    // include leases and the 3 page should be empty.
+    for (auto i = 0; i < 3; ++i) {
+        // Query for a page of leases in the binary format.
+        string cmd =
+            "{\n"
+            "    \"command\": \"lease4-get-page\",\n"
+            "    \"arguments\": {"
+            "        \"from\": \"" + last_address + "\","
+            "        \"limit\": 2,"
+            "        \"format\": \"binary\""
+            "    }"
+            "}";
+
+        ConstElementPtr rsp;
+        if (i < 2) {
+            string exp_rsp = "2 IPv4 lease(s) found.";
+            rsp = testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+
+        } else {
+            string exp_rsp = "0 IPv4 lease(s) found.";
+            rsp = testCommand(cmd, CONTROL_RESULT_EMPTY, exp_rsp);
+        }
+        ASSERT_TRUE(rsp);
+
+        ConstElementPtr args = rsp->get("arguments");
+        ASSERT_TRUE(args);
+        ASSERT_EQ(Element::map, args->getType());
+        ConstElementPtr page_count = args->get("count");
+        ASSERT_TRUE(page_count);
+        ASSERT_EQ(Element::integer, page_count->getType());
+
+        // The leases are returned in a lease stream, not in a list.
+        EXPECT_FALSE(args->get("leases"));
+        ConstElementPtr leases = args->get("leases-binary");
+        ASSERT_TRUE(leases);
+        ASSERT_EQ(Element::string, leases->getType());
+
+        std::vector<uint8_t> binary;
+        ASSERT_NO_THROW(util::encode::decodeBase64(leases->stringValue(), binary));
+        util::InputBuffer buffer(binary.empty() ? 0 : &binary[0], binary.size());
+        ASSERT_NO_THROW(readLeaseStreamHeader(buffer));
+        Lease4Ptr lease;
+        int64_t count = 0;
+        while (readLeaseStreamRecord(buffer, lease)) {
+            ++count;
+            last_address = lease->addr_.toText();
+            lease_addresses.insert(last_address);
+
+            // The lease is the same as in the lease manager.
+            Lease4Ptr from_mgr = LeaseMgrFactory::instance().getLease4(lease->addr_);
+            ASSERT_TRUE(from_mgr);
+            EXPECT_TRUE(*lease == *from_mgr) << lease->toText();
+        }
+        EXPECT_EQ(page_count->intValue(), count);
+        EXPECT_EQ(i < 2 ? 2 : 0, count);
+    }
+
+    // Check if all addresses were returned.
+    EXPECT_EQ(1, lease_addresses.count("192.0.2.1"));
+    EXPECT_EQ(1, lease_addresses.count("192.0.2.2"));
+    EXPECT_EQ(1, lease_addresses.count("192.0.3.1"));
+    EXPECT_EQ(1, lease_addresses.count("192.0.3.2"));
+}
+
+void Lease4CmdsTest::testLease4GetPagedBinaryNoIdentifier() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // Add a lease with neither hardware address nor client identifier.
+    // It can't be written in a lease stream.
+    Lease4Ptr no_id = createLease4("192.0.2.3", 44, 0x0a, 0x43);
+    no_id->hwaddr_.reset(new HWAddr(std::vector<uint8_t>(), HTYPE_ETHER));
+    no_id->client_id_.reset();
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(no_id));
+
+    // Query for a page of leases in the binary format.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 10,"
+        "        \"format\": \"binary\""
+        "    }"
+        "}";
+
+    string exp_rsp = "5 IPv4 lease(s) found.";
+    ConstElementPtr rsp = testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+    ASSERT_TRUE(rsp);
+    ConstElementPtr args = rsp->get("arguments");
+    ASSERT_TRUE(args);
+    ConstElementPtr page_count = args->get("count");
+    ASSERT_TRUE(page_count);
+    EXPECT_EQ(5, page_count->intValue());
+
+    // The other leases are in the lease stream.
+    ConstElementPtr leases = args->get("leases-binary");
+    ASSERT_TRUE(leases);
+    ASSERT_EQ(Element::string, leases->getType());
+    std::vector<uint8_t> binary;
+    ASSERT_NO_THROW(util::encode::decodeBase64(leases->stringValue(), binary));
+    util::InputBuffer buffer(binary.empty() ? 0 : &binary[0], binary.size());
+    ASSERT_NO_THROW(readLeaseStreamHeader(buffer));
+    Lease4Ptr lease;
+    int64_t count = 0;
+    while (readLeaseStreamRecord(buffer, lease)) {
+        ++count;
+        EXPECT_NE("192.0.2.3", lease->addr_.toText());
+    }
+    EXPECT_EQ(4, count);
+
+    // The lease without identifier is in the list.
+    ConstElementPtr list = args->get("leases");
+    ASSERT_TRUE(list);
+    ASSERT_EQ(Element::list, list->getType());
+    ASSERT_EQ(1, list->size());
+    ConstElementPtr address = list->get(0)->get("ip-address");
+    ASSERT_TRUE(address);
+    EXPECT_EQ("192.0.2.3", address->stringValue());
+}
+
+void Lease4CmdsTest::testLease4GetPagedInvalidFormat() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // Query for a page of leases.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 2,"
+        "        \"format\": \"csv\""
+        "    }"
+        "}";
+
+    string exp_rsp = "'format' parameter value 'csv' is neither 'json' nor 'binary'";
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+
+    // The format must be a string.
+    cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 2,"
+        "        \"format\": 1"
+        "    }"
+        "}";
+
+    exp_rsp = "'format' parameter must be a string";
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+}
+
 void Lease4CmdsTest::testLease4GetPagedZeroAddress() {
     // Initialize lease manager (false = v4, true = add leases)
     initLeaseMgr(false, true);
@@ -2405,6 +2595,161 @@ void Lease4CmdsTest::testLease4UpdateDoNotForceCreate() {
     checkLease4Stats(88, 0, 0);
 }
 
+void Lease4CmdsTest::testLease4BulkApply() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    // Now send the command.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"deleted-leases\": ["
+        "            {"
+        "                \"ip-address\": \"192.0.2.1\""
+        "            },"
+        "            {"
+        "                \"ip-address\": \"192.0.2.2\""
+        "            }"
+        "        ],"
+        "        \"leases\": ["
+        "            {"
+        "                \"subnet-id\": 44,\n"
+        "                \"ip-address\": \"192.0.2.123\",\n"
+        "                \"hw-address\": \"1a:1b:1c:1d:1e:1f\"\n"
+        "            },"
+        "            {"
+        "                \"subnet-id\": 88,\n"
+        "                \"ip-address\": \"192.0.3.123\",\n"
+        "                \"hw-address\": \"2a:2b:2c:2d:2e:2f\"\n"
+        "            }"
+        "        ]"
+        "    }"
+        "}";
+    string exp_rsp = "Bulk apply of 4 IPv4 leases completed.";
+
+    // The status expected is success.
+    testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+
+    checkLease4Stats(44, 1, 0);
+
+    checkLease4Stats(88, 3, 0);
+
+    //  Check that the leases we inserted are stored.
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.123")));
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.3.123")));
+
+    // Check that the leases we deleted are gone,
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.1")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.2")));
+}
+
+void Lease4CmdsTest::testLease4BulkApplyDeleteNonExiting() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    // Now send the command.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"deleted-leases\": ["
+        "            {"
+        "                \"ip-address\": \"192.0.2.123\""
+        "            },"
+        "            {"
+        "                \"ip-address\": \"192.0.2.234\""
+        "            }"
+        "        ]"
+        "    }"
+        "}";
+    string exp_rsp = "Bulk apply of 0 IPv4 leases completed.";
+
+    // The status expected is empty.
+    auto resp = testCommand(cmd, CONTROL_RESULT_EMPTY, exp_rsp);
+    ASSERT_TRUE(resp);
+    ASSERT_EQ(Element::map, resp->getType());
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    auto args = resp->get("arguments");
+    ASSERT_TRUE(args);
+    ASSERT_EQ(Element::map, args->getType());
+
+    auto failed_deleted_leases = args->get("failed-deleted-leases");
+    ASSERT_TRUE(failed_deleted_leases);
+    ASSERT_EQ(Element::list, failed_deleted_leases->getType());
+    ASSERT_EQ(2, failed_deleted_leases->size());
+
+    {
+        SCOPED_TRACE("lease address 192.0.2.123");
+        checkFailedLease(failed_deleted_leases, "V4", "192.0.2.123",
+                         CONTROL_RESULT_EMPTY, "lease not found");
+    }
+
+    {
+        SCOPED_TRACE("lease address 192.0.2.234");
+        checkFailedLease(failed_deleted_leases, "V4", "192.0.2.234",
+                         CONTROL_RESULT_EMPTY, "lease not found");
+    }
+}
+
+void Lease4CmdsTest::testLease4BulkApplyRollback() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    // Now send the command.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"deleted-leases\": ["
+        "            {"
+        "                \"ip-address\": \"192.0.2.1\""
+        "            }"
+        "        ],"
+        "        \"leases\": ["
+        "            {"
+        "                \"subnet-id\": 44,\n"
+        "                \"ip-address\": \"192.0.2.123\","
+        "                \"hw-address\": \"1a:1b:1c:1d:1e:1f\""
+        "            },"
+        "            {"
+        "                \"subnet-id\": -1,"
+        "                \"ip-address\": \"192.0.3.123\","
+        "                \"hw-address\": \"2a:2b:2c:2d:2e:2f\""
+        "            }"
+        "        ]"
+        "    }"
+        "}";
+    string exp_rsp = "out of range value (-1) specified for parameter 'subnet-id' (<string>:4:57)";
+
+    // The status expected is an error.
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.1")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.123")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.3.123")));
+}
+
 void Lease4CmdsTest::testLease4UpdateComment() {
     // Initialize lease manager (false = v4, true = add leases)
     initLeaseMgr(false, true);
@@ -3743,6 +4088,33 @@ TEST_F(Lease4CmdsTest, lease4GetPagedMultiThreading) {
     testLease4GetPaged();
 }
 
+TEST_F(Lease4CmdsTest, lease4GetPagedBinary) {
+    testLease4GetPagedBinary();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedBinaryMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4GetPagedBinary();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedBinaryNoIdentifier) {
+    testLease4GetPagedBinaryNoIdentifier();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedBinaryNoIdentifierMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4GetPagedBinaryNoIdentifier();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedInvalidFormat) {
+    testLease4GetPagedInvalidFormat();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedInvalidFormatMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4GetPagedInvalidFormat();
+}
+
 TEST_F(Lease4CmdsTest, lease4GetPagedZeroAddress) {
     testLease4GetPagedZeroAddress();
 }
@@ -3986,6 +4358,33 @@ TEST_F(Lease4CmdsTest, lease4UpdateDoNotForceCreateMultiThreading) {
     testLease4UpdateDoNotForceCreate();
 }
 
+TEST_F(Lease4CmdsTest, lease4BulkApply) {
+    testLease4BulkApply();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4BulkApply();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyDeleteNonExiting) {
+    testLease4BulkApplyDeleteNonExiting();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyDeleteNonExitingMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4BulkApplyDeleteNonExiting();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyRollback) {
+    testLease4BulkApplyRollback();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyRollbackMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4BulkApplyRollback();
+}
+
 TEST_F(Lease4CmdsTest, lease4DelMissingParams) {
     testLease4DelMissingParams();
 }
@@ -10,6 +10,7 @@
 #include <hooks/hooks_manager.h>
 #include <config/command_mgr.h>
 #include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/ncr_generator.h>
 #include <dhcpsrv/cfgmgr.h>
@@ -20,6 +21,7 @@
 #include <stats/stats_mgr.h>
 #include <testutils/user_context_utils.h>
 #include <testutils/multi_threading_utils.h>
+#include <util/encode/encode.h>
 
 #include <gtest/gtest.h>
 
@@ -248,6 +250,10 @@ public:
     /// @brief Check that multiple calls to lease6-get-page return all leases.
     void testLease6GetPaged();
 
+    /// @brief Check that lease6-get-page returns a lease stream in the
+    /// binary format.
+    void testLease6GetPagedBinary();
+
     /// @brief Verifies that first page of IPv6 leases can be retrieved by
     /// specifying zero IPv6 address.
     void testLease6GetPagedZeroAddress();
@@ -1797,6 +1803,81 @@ void Lease6CmdsTest::testLease6GetPaged() {
     EXPECT_EQ(1, lease_addresses.count("2001:db8:2::2"));
 }
 
+void Lease6CmdsTest::testLease6GetPagedBinary() {
+    // Initialize lease manager (true = v6, true = add leases)
+    initLeaseMgr(true, true);
+
+    // Gather all returned addresses to verify that all were returned.
+    std::set<std::string> lease_addresses;
+
+    // Keyword start indicates that we want to retrieve the first page.
+    std::string last_address = "start";
+
+    // There are 4 leases in the database, so the first two pages should
+    // include leases and the 3 page should be empty.
+    for (auto i = 0; i < 3; ++i) {
+        // Query for a page of leases in the binary format.
+        string cmd =
+            "{\n"
+            "    \"command\": \"lease6-get-page\",\n"
+            "    \"arguments\": {"
+            "        \"from\": \"" + last_address + "\","
+            "        \"limit\": 2,"
+            "        \"format\": \"binary\""
+            "    }"
+            "}";
+
+        ConstElementPtr rsp;
+        if (i < 2) {
+            string exp_rsp = "2 IPv6 lease(s) found.";
+            rsp = testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+
+        } else {
+            string exp_rsp = "0 IPv6 lease(s) found.";
+            rsp = testCommand(cmd, CONTROL_RESULT_EMPTY, exp_rsp);
+        }
+        ASSERT_TRUE(rsp);
+
+        ConstElementPtr args = rsp->get("arguments");
+        ASSERT_TRUE(args);
+        ASSERT_EQ(Element::map, args->getType());
+        ConstElementPtr page_count = args->get("count");
+        ASSERT_TRUE(page_count);
+        ASSERT_EQ(Element::integer, page_count->getType());
+
+        // The leases are returned in a lease stream, not in a list.
+        EXPECT_FALSE(args->get("leases"));
+        ConstElementPtr leases = args->get("leases-binary");
+        ASSERT_TRUE(leases);
+        ASSERT_EQ(Element::string, leases->getType());
+
+        std::vector<uint8_t> binary;
+        ASSERT_NO_THROW(util::encode::decodeBase64(leases->stringValue(), binary));
+        util::InputBuffer buffer(binary.empty() ? 0 : &binary[0], binary.size());
+        ASSERT_NO_THROW(readLeaseStreamHeader(buffer));
+        Lease6Ptr lease;
+        int64_t count = 0;
+        while (readLeaseStreamRecord(buffer, lease)) {
+            ++count;
+            last_address = lease->addr_.toText();
+            lease_addresses.insert(last_address);
+
+            // The lease is the same as in the lease manager.
+            Lease6Ptr from_mgr = LeaseMgrFactory::instance().getLease6(lease->type_, lease->addr_);
+            ASSERT_TRUE(from_mgr);
+            EXPECT_TRUE(*lease == *from_mgr) << lease->toText();
+        }
+        EXPECT_EQ(page_count->intValue(), count);
+        EXPECT_EQ(i < 2 ? 2 : 0, count);
+    }
+
+    // Check if all addresses were returned.
+    EXPECT_EQ(1, lease_addresses.count("2001:db8:1::1"));
+    EXPECT_EQ(1, lease_addresses.count("2001:db8:1::2"));
+    EXPECT_EQ(1, lease_addresses.count("2001:db8:2::1"));
+    EXPECT_EQ(1, lease_addresses.count("2001:db8:2::2"));
+}
+
 void Lease6CmdsTest::testLease6GetPagedZeroAddress() {
     // Initialize lease manager (true = v6, true = add leases)
     initLeaseMgr(true, true);
@@ -4488,6 +4569,15 @@ TEST_F(Lease6CmdsTest, lease6GetPagedMultiThreading) {
     testLease6GetPaged();
 }
 
+TEST_F(Lease6CmdsTest, lease6GetPagedBinary) {
+    testLease6GetPagedBinary();
+}
+
+TEST_F(Lease6CmdsTest, lease6GetPagedBinaryMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease6GetPagedBinary();
+}
+
 TEST_F(Lease6CmdsTest, lease6GetPagedZeroAddress) {
     testLease6GetPagedZeroAddress();
 }
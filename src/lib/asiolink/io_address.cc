@@ -184,8 +184,11 @@ hash_value(const IOAddress& address) {
         boost::hash<uint32_t> hasher;
         return (hasher(address.toUint32()));
     } else {
-        boost::hash<std::vector<uint8_t> > hasher;
-        return (hasher(address.toBytes()));
+        // Hash the bytes in place: same value as hashing the toBytes()
+        // vector, without allocating it.
+        ip::address_v6::bytes_type bytes =
+            address.asio_address_.to_v6().to_bytes();
+        return (boost::hash_range(bytes.begin(), bytes.end()));
     }
 }
 
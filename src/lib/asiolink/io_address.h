@@ -293,6 +293,9 @@ public:
 
     //@}
 
+    /// \brief Hash the IOAddress (declared below).
+    friend size_t hash_value(const IOAddress& address);
+
 private:
     boost::asio::ip::address asio_address_;
 };
@@ -0,0 +1,118 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/data.h>
+#include <util/benchmarks/micro_benchmark.h>
+
+#include <sstream>
+
+using namespace isc;
+using namespace isc::data;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the microbenchmarks of the libkea-cc JSON parser.
+
+namespace {
+
+/// @brief Returns a lease update command like the ones sent by HA.
+///
+/// @param gen the data generator.
+/// @return the command in JSON.
+string
+makeCommand(DataGenerator& gen) {
+    ostringstream s;
+    s << "{ \"command\": \"lease4-update\", \"service\": [ \"dhcp4\" ],"
+      << " \"arguments\": { \"ip-address\": \"10.0." << gen.uniform(0, 255)
+      << "." << gen.uniform(1, 254) << "\", \"hw-address\": \"";
+    for (auto const& byte : gen.bytes(6)) {
+        s << hex << (byte >> 4) << (byte & 0xf) << dec << ":";
+    }
+    s.seekp(-1, ios_base::cur);
+    s << "\", \"subnet-id\": " << gen.uniform(1, 100)
+      << ", \"valid-lft\": 4000, \"expire\": " << gen.uniform(1700000000, 1800000000)
+      << ", \"fqdn-fwd\": false, \"fqdn-rev\": false, \"hostname\": \""
+      << gen.name(12) << ".example.org\", \"state\": 0,"
+      << " \"user-context\": { \"origin\": \"ha-partner\" } } }";
+    return (s.str());
+}
+
+/// @brief Returns a DHCPv4 server configuration.
+///
+/// @param gen the data generator.
+/// @param subnets the number of subnets.
+/// @return the configuration in JSON.
+string
+makeConfig(DataGenerator& gen, size_t subnets) {
+    ostringstream s;
+    s << "{ \"Dhcp4\": {" << endl
+      << "# Generated configuration." << endl
+      << "  \"interfaces-config\": { \"interfaces\": [ \"eth0\" ] }," << endl
+      << "  \"valid-lifetime\": 4000," << endl
+      << "  \"subnet4\": [";
+    for (size_t i = 0; i < subnets; ++i) {
+        s << (i ? "," : "") << endl
+          << "    { \"id\": " << (i + 1) << ", \"subnet\": \"10." << (i / 256)
+          << "." << (i % 256) << ".0/24\"," << endl
+          << "      \"pools\": [ { \"pool\": \"10." << (i / 256) << "."
+          << (i % 256) << ".10 - 10." << (i / 256) << "." << (i % 256)
+          << ".200\" } ]," << endl
+          << "      \"option-data\": [ { \"name\": \"routers\", \"data\": \"10."
+          << (i / 256) << "." << (i % 256) << ".1\" }, { \"name\": \"domain-name\","
+          << " \"data\": \"" << gen.name(8) << ".example.org\" } ]," << endl
+          << "      \"reservations\": [";
+        for (size_t j = 0; j < 4; ++j) {
+            s << (j ? ", " : " ") << "{ \"hw-address\": \"";
+            for (auto const& byte : gen.bytes(6)) {
+                s << hex << (byte >> 4) << (byte & 0xf) << dec << ":";
+            }
+            s.seekp(-1, ios_base::cur);
+            s << "\", \"ip-address\": \"10." << (i / 256) << "." << (i % 256)
+              << "." << (220 + j) << "\" }";
+        }
+        s << " ] }";
+    }
+    s << " ]" << endl << "} }" << endl;
+    return (s.str());
+}
+
+/// @brief Adds the cases of the JSON parser.
+///
+/// @param bench the benchmark.
+void
+addFromJSONCases(MicroBenchmark& bench) {
+    bench.add("Element/fromJSON-command", [](DataGenerator& gen) {
+        string json = makeCommand(gen);
+        return ([json]() {
+            MicroBenchmark::keep(Element::fromJSON(json)->getType());
+        });
+    });
+
+    bench.add("Element/fromJSON-config-10-subnets", [](DataGenerator& gen) {
+        string json = makeConfig(gen, 10);
+        return ([json]() {
+            MicroBenchmark::keep(Element::fromJSON(json, true)->getType());
+        });
+    });
+
+    bench.add("Element/fromJSON-config-1000-subnets", [](DataGenerator& gen) {
+        string json = makeConfig(gen, 1000);
+        return ([json]() {
+            MicroBenchmark::keep(Element::fromJSON(json, true)->getType());
+        });
+    });
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    MicroBenchmark bench("libkea-cc");
+    addFromJSONCases(bench);
+    return (bench.run(argc, argv));
+}
@@ -48,6 +48,8 @@ DbAccessParser::parse(std::string& access_string,
     DatabaseConnection::ParameterMap values_copy = values_;
 
     int64_t lfc_interval = 0;
+    int64_t write_queue_size = 0;
+    int64_t write_max_delay = 0;
     int64_t connect_timeout = 0;
     int64_t read_timeout = 0;
     int64_t write_timeout = 0;
@@ -61,6 +63,8 @@ DbAccessParser::parse(std::string& access_string,
     for (auto const& param : database_config->mapValue()) {
         try {
             if ((param.first == "persist") ||
+                (param.first == "compact") ||
+                (param.first == "write-sync") ||
                 (param.first == "readonly") ||
                 (param.first == "retry-on-startup")) {
                 values_copy[param.first] = (param.second->boolValue() ?
@@ -71,6 +75,16 @@ DbAccessParser::parse(std::string& access_string,
                 values_copy[param.first] =
                     boost::lexical_cast<std::string>(lfc_interval);
 
+            } else if (param.first == "write-queue-size") {
+                write_queue_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_queue_size);
+
+            } else if (param.first == "write-max-delay") {
+                write_max_delay = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_max_delay);
+
             } else if (param.first == "connect-timeout") {
                 connect_timeout = param.second->intValue();
                 values_copy[param.first] =
@@ -167,6 +181,25 @@ DbAccessParser::parse(std::string& access_string,
                   << " (" << value->getPosition() << ")");
     }
 
+    // Check that the lease file writer parameters are within a reasonable
+    // range.
+    if ((write_queue_size < 0) ||
+        (write_queue_size > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-queue-size");
+        isc_throw(DbConfigError, "write-queue-size value: " << write_queue_size
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+    if ((write_max_delay < 0) ||
+        (write_max_delay > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-max-delay");
+        isc_throw(DbConfigError, "write-max-delay value: " << write_max_delay
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
     // d. Check that the timeouts are within a reasonable range.
     if ((connect_timeout < 0) ||
         (connect_timeout > std::numeric_limits<uint32_t>::max())) {
@@ -78,8 +78,9 @@ public:
             }
 
             // Add the keyword and value - make sure that they are quoted.
-            // The parameters which are not quoted are persist, readonly and
-            // lfc-interval as they are boolean and integer respectively.
+            // The parameters which are not quoted are persist, compact,
+            // readonly and lfc-interval as they are boolean and integer
+            // respectively.
             result += quote + keyval[i] + quote + colon + space;
             if (!quoteValue(std::string(keyval[i]))) {
                 result += keyval[i + 1];
@@ -165,6 +166,10 @@ private:
     /// @return true if the value of the parameter should be quoted.
      bool quoteValue(const std::string& parameter) const {
          return ((parameter != "persist") && (parameter != "lfc-interval") &&
+                 (parameter != "compact") &&
+                 (parameter != "write-queue-size") &&
+                 (parameter != "write-max-delay") &&
+                 (parameter != "write-sync") &&
                  (parameter != "connect-timeout") &&
                  (parameter != "read-timeout") &&
                  (parameter != "write-timeout") &&
@@ -305,6 +310,85 @@ TEST_F(DbAccessParserTest, persistV6Memfile) {
                       config);
 }
 
+// Check that the parser accepts the compact parameter.
+TEST_F(DbAccessParserTest, compactMemfile) {
+    const char* config[] = {"type", "memfile",
+                            "persist", "true",
+                            "compact", "true",
+                            "name", "/opt/var/lib/kea/kea-leases4.csv",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+
+    checkAccessString("Valid memfile", parser.getDbAccessParameters(),
+                      config);
+}
+
+// Check that the parser accepts the lease file format parameter.
+TEST_F(DbAccessParserTest, formatMemfile) {
+    const char* config[] = {"type", "memfile",
+                            "persist", "true",
+                            "format", "binary",
+                            "name", "/opt/var/lib/kea/kea-leases4.csv",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+
+    checkAccessString("Valid memfile", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser accepts the lease file writer
+// parameters.
+TEST_F(DbAccessParserTest, writerMemfile) {
+    const char* config[] = {"type", "memfile",
+                            "persist", "true",
+                            "name", "/opt/var/lib/kea/kea-leases4.csv",
+                            "write-queue-size", "64",
+                            "write-max-delay", "100",
+                            "write-sync", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+
+    checkAccessString("Valid memfile", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects the out of range values of
+// the lease file writer parameters.
+TEST_F(DbAccessParserTest, invalidWriterMemfile) {
+    const char* negative[] = {"type", "memfile",
+                              "name", "/opt/var/lib/kea/kea-leases4.csv",
+                              "write-queue-size", "-1",
+                              NULL};
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(negative))),
+                 DbConfigError);
+
+    const char* large[] = {"type", "memfile",
+                           "name", "/opt/var/lib/kea/kea-leases4.csv",
+                           "write-max-delay", "4294967296",
+                           NULL};
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(large))),
+                 DbConfigError);
+}
+
 // This test checks that the parser accepts the valid value of the
 // lfc-interval parameter.
 TEST_F(DbAccessParserTest, validLFCInterval) {
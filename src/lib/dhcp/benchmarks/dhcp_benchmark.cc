@@ -0,0 +1,266 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/classify.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/hwaddr.h>
+#include <dhcp/libdhcp++.h>
+#include <dhcp/option.h>
+#include <dhcp/option4_addrlst.h>
+#include <dhcp/option_int.h>
+#include <dhcp/option_string.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/std_option_defs.h>
+#include <util/benchmarks/micro_benchmark.h>
+#include <util/packet_arena.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <list>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::util;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the microbenchmarks of the libkea-dhcp++ option
+/// and packet parsing, of the client class checks and of the packet
+/// arena.
+
+namespace {
+
+/// @brief The number of generated queries.
+const size_t QUERIES = 1000;
+
+/// @brief Returns the options of a DHCPDISCOVER.
+///
+/// @param gen the data generator.
+/// @param relayed whether the query carries a relay agent information.
+/// @return the options.
+OptionCollection
+makeOptions(DataGenerator& gen, bool relayed) {
+    OptionCollection options;
+    options.insert(make_pair(DHO_DHCP_MESSAGE_TYPE,
+                             OptionPtr(new Option(Option::V4, DHO_DHCP_MESSAGE_TYPE,
+                                                  OptionBuffer(1, DHCPDISCOVER)))));
+    options.insert(make_pair(DHO_DHCP_CLIENT_IDENTIFIER,
+                             OptionPtr(new Option(Option::V4, DHO_DHCP_CLIENT_IDENTIFIER,
+                                                  gen.bytes(7)))));
+    options.insert(make_pair(DHO_DHCP_PARAMETER_REQUEST_LIST,
+                             OptionPtr(new Option(Option::V4, DHO_DHCP_PARAMETER_REQUEST_LIST,
+                                                  OptionBuffer {
+                                                      DHO_SUBNET_MASK, DHO_ROUTERS,
+                                                      DHO_DOMAIN_NAME_SERVERS,
+                                                      DHO_DOMAIN_NAME, DHO_HOST_NAME,
+                                                      DHO_BROADCAST_ADDRESS,
+                                                      DHO_NTP_SERVERS,
+                                                      DHO_DOMAIN_SEARCH,
+                                                      DHO_CLASSLESS_STATIC_ROUTE,
+                                                      DHO_VENDOR_ENCAPSULATED_OPTIONS }))));
+    options.insert(make_pair(DHO_DHCP_MAX_MESSAGE_SIZE,
+                             OptionPtr(new OptionUint16(Option::V4,
+                                                        DHO_DHCP_MAX_MESSAGE_SIZE,
+                                                        1500))));
+    options.insert(make_pair(DHO_HOST_NAME,
+                             OptionPtr(new OptionString(Option::V4, DHO_HOST_NAME,
+                                                        gen.name(12)))));
+    options.insert(make_pair(DHO_VENDOR_CLASS_IDENTIFIER,
+                             OptionPtr(new OptionString(Option::V4,
+                                                        DHO_VENDOR_CLASS_IDENTIFIER,
+                                                        "MSFT 5.0"))));
+    if (relayed) {
+        OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+        rai->addOption(OptionPtr(new Option(Option::V4, RAI_OPTION_AGENT_CIRCUIT_ID,
+                                            gen.bytes(6))));
+        rai->addOption(OptionPtr(new Option(Option::V4, RAI_OPTION_REMOTE_ID,
+                                            gen.bytes(8))));
+        options.insert(make_pair(DHO_DHCP_AGENT_OPTIONS, rai));
+    }
+    return (options);
+}
+
+/// @brief Returns packed options.
+///
+/// @param gen the data generator.
+/// @param relayed whether the queries carry a relay agent information.
+/// @return the option buffers.
+vector<OptionBuffer>
+makeOptionBuffers(DataGenerator& gen, bool relayed) {
+    vector<OptionBuffer> buffers;
+    for (size_t i = 0; i < QUERIES; ++i) {
+        OutputBuffer buf(0);
+        LibDHCP::packOptions4(buf, makeOptions(gen, relayed));
+        const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+        buffers.push_back(OptionBuffer(data, data + buf.getLength()));
+    }
+    return (buffers);
+}
+
+/// @brief Returns packed queries.
+///
+/// @param gen the data generator.
+/// @return the queries.
+vector<OptionBuffer>
+makeQueries(DataGenerator& gen) {
+    vector<OptionBuffer> queries;
+    for (size_t i = 0; i < QUERIES; ++i) {
+        Pkt4 query(DHCPDISCOVER, gen.next());
+        query.setHWAddr(HWAddrPtr(new HWAddr(gen.bytes(6), HTYPE_ETHER)));
+        query.setGiaddr(IOAddress("10.0.0.1"));
+        query.setHops(1);
+        for (auto const& option : makeOptions(gen, true)) {
+            if (option.first != DHO_DHCP_MESSAGE_TYPE) {
+                query.addOption(option.second);
+            }
+        }
+        query.pack();
+        const uint8_t* data = static_cast<const uint8_t*>(query.getBuffer().getData());
+        queries.push_back(OptionBuffer(data, data + query.getBuffer().getLength()));
+    }
+    return (queries);
+}
+
+/// @brief Adds the cases of the option parsing.
+///
+/// @param bench the benchmark.
+void
+addOptionCases(MicroBenchmark& bench) {
+    for (bool relayed : { false, true }) {
+        string name = string("LibDHCP/unpackOptions4-") +
+            (relayed ? "relayed" : "direct");
+        bench.add(name, [relayed](DataGenerator& gen) {
+            auto buffers = boost::make_shared<vector<OptionBuffer>>(
+                makeOptionBuffers(gen, relayed));
+            size_t i = 0;
+            return ([buffers, i]() mutable {
+                OptionCollection options;
+                list<uint16_t> deferred;
+                MicroBenchmark::keep(LibDHCP::unpackOptions4((*buffers)[i++ % QUERIES],
+                                                             DHCP4_OPTION_SPACE,
+                                                             options, deferred));
+            });
+        });
+    }
+
+    // Parses a query and looks for the options used by the server for
+    // every query, with all options unpacked or only these ones.
+    for (bool lazy : { false, true }) {
+        string name = string("Pkt4/unpack") + (lazy ? "-lazy" : "");
+        bench.add(name, [lazy](DataGenerator& gen) {
+            auto queries = boost::make_shared<vector<OptionBuffer>>(makeQueries(gen));
+            size_t i = 0;
+            return ([queries, i, lazy]() mutable {
+                const OptionBuffer& wire = (*queries)[i++ % QUERIES];
+                Pkt4 query(&wire[0], wire.size());
+                query.setLazyUnpack(lazy);
+                query.unpack();
+                MicroBenchmark::keep(query.getType());
+                MicroBenchmark::keep(static_cast<bool>(query.getOption(DHO_DHCP_AGENT_OPTIONS)));
+                MicroBenchmark::keep(static_cast<bool>(query.getOption(DHO_DHCP_CLIENT_IDENTIFIER)));
+                MicroBenchmark::keep(static_cast<bool>(query.getOption(DHO_DHCP_PARAMETER_REQUEST_LIST)));
+            });
+        });
+    }
+}
+
+/// @brief Adds the cases of the client class checks.
+///
+/// @param bench the benchmark.
+void
+addClassifyCases(MicroBenchmark& bench) {
+    // An operation checks the classes of a packet against the classes
+    // of 1000 pools, as the pool selection does.
+    bench.add("ClientClasses/intersects-pools", [](DataGenerator&) {
+        // 200 classes evaluated for a packet.
+        auto classes = boost::make_shared<ClientClasses>();
+        for (size_t i = 0; i < 200; ++i) {
+            string name = "perf-" + to_string(i);
+            ClientClasses::internClass(name);
+            classes->insert(name);
+        }
+        // 1000 pools restricted to 2 classes, one of them matching the
+        // packet only for the last pool.
+        auto pools = boost::make_shared<vector<ClientClasses>>(1000);
+        for (size_t i = 0; i < pools->size(); ++i) {
+            string name = "perf-pool-" + to_string(i);
+            ClientClasses::internClass(name);
+            (*pools)[i].insert(name);
+            if (i == pools->size() - 1) {
+                (*pools)[i].insert("perf-199");
+            }
+        }
+        return ([classes, pools]() {
+            size_t matches = 0;
+            for (auto const& pool : *pools) {
+                if (pool.intersects(*classes)) {
+                    ++matches;
+                }
+            }
+            MicroBenchmark::keep(matches);
+        });
+    });
+}
+
+/// @brief Adds the cases of the packet arena.
+///
+/// An operation unpacks a relayed DHCPDISCOVER, builds an offer with a
+/// few options and packs it, with the objects allocated on the heap or
+/// from a packet arena. Without --enable-packet-arena both cases allocate
+/// on the heap.
+///
+/// @param bench the benchmark.
+void
+addPacketArenaCases(MicroBenchmark& bench) {
+    for (bool arena : { false, true }) {
+        string name = string("PacketArena/discover-offer-") +
+            (arena ? "arena" : "heap");
+        bench.add(name, [arena](DataGenerator& gen) {
+            auto queries = boost::make_shared<vector<OptionBuffer>>(makeQueries(gen));
+            size_t i = 0;
+            return ([queries, arena, i]() mutable {
+                boost::scoped_ptr<PacketArenaScope> scope;
+                if (arena) {
+                    scope.reset(new PacketArenaScope());
+                }
+                const OptionBuffer& wire = (*queries)[i++ % QUERIES];
+                Pkt4Ptr query(new Pkt4(&wire[0], wire.size()));
+                query->unpack();
+                Pkt4Ptr response(new Pkt4(DHCPOFFER, query->getTransid()));
+                response->setYiaddr(IOAddress("192.0.2.1"));
+                response->addOption(OptionPtr(new Option4AddrLst(DHO_ROUTERS,
+                                                                 IOAddress("192.0.2.254"))));
+                response->addOption(OptionPtr(new OptionString(Option::V4, DHO_DOMAIN_NAME,
+                                                               "example.org")));
+                response->addOption(OptionPtr(new OptionUint32(Option::V4,
+                                                               DHO_DHCP_LEASE_TIME,
+                                                               3600)));
+                OptionPtr rai = query->getOption(DHO_DHCP_AGENT_OPTIONS);
+                if (rai) {
+                    response->addOption(rai);
+                }
+                response->pack();
+                MicroBenchmark::keep(response->getBuffer().getLength());
+            });
+        });
+    }
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    MicroBenchmark bench("libkea-dhcp++");
+    addOptionCases(bench);
+    addClassifyCases(bench);
+    addPacketArenaCases(bench);
+    return (bench.run(argc, argv));
+}
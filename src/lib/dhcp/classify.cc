@@ -14,16 +14,35 @@
 #include <boost/algorithm/string/constants.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <algorithm>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
+namespace {
+
+/// @brief Map of the interned class names to their identifiers.
+typedef std::unordered_map<isc::dhcp::ClientClass,
+                           isc::dhcp::ClientClassId> ClientClassIdMap;
+
+/// @brief Returns the map of the interned class names.
+///
+/// @return the map of the interned class names.
+ClientClassIdMap&
+getClassIds() {
+    static ClientClassIdMap class_ids;
+    return (class_ids);
+}
+
+}
+
 namespace isc {
 namespace dhcp {
 
 using namespace isc::data;
 
 ClientClasses::ClientClasses(const std::string& class_names)
-    : container_() {
+    : container_(), bits_(), uninterned_() {
     std::vector<std::string> split_text;
     boost::split(split_text, class_names, boost::is_any_of(","),
                  boost::algorithm::token_compress_off);
@@ -36,9 +55,21 @@ ClientClasses::ClientClasses(const std::string& class_names)
     }
 }
 
-ClientClasses::ClientClasses(const ClientClasses& other) {
-    for (auto const& cclass : other) {
-        insert(cclass);
+ClientClasses::ClientClasses(const ClientClasses& other)
+    : container_(other.container_), bits_(other.bits_),
+      uninterned_(other.uninterned_) {
+}
+
+void
+ClientClasses::insert(const ClientClass& class_name) {
+    if (!container_.push_back(class_name).second) {
+        return;
+    }
+    ClientClassId id;
+    if (getClassId(class_name, id)) {
+        setBit(id);
+    } else {
+        uninterned_.push_back(class_name);
     }
 }
 
@@ -46,9 +77,29 @@ void
 ClientClasses::erase(const ClientClass& class_name) {
     auto& idx = container_.get<ClassNameTag>();
     auto it = idx.find(class_name);
-    if (it != idx.end()) {
-        static_cast<void>(idx.erase(it));
+    if (it == idx.end()) {
+        return;
+    }
+    static_cast<void>(idx.erase(it));
+    // The class may have been interned after it was inserted so
+    // look for it in the uninterned classes first.
+    auto uit = std::find(uninterned_.begin(), uninterned_.end(), class_name);
+    if (uit != uninterned_.end()) {
+        static_cast<void>(uninterned_.erase(uit));
+        return;
+    }
+    ClientClassId id;
+    if (getClassId(class_name, id)) {
+        bits_[id / 64] &= ~(1ULL << (id % 64));
+    }
+}
+
+void
+ClientClasses::setBit(ClientClassId id) {
+    if (id / 64 >= bits_.size()) {
+        bits_.resize(id / 64 + 1, 0);
     }
+    bits_[id / 64] |= 1ULL << (id % 64);
 }
 
 bool
@@ -59,17 +110,23 @@ ClientClasses::contains(const ClientClass& x) const {
 
 bool
 ClientClasses::intersects(const ClientClasses& cclasses) const {
-    if (cclasses.size() > size()) {
-        for (const auto& cclass : *this) {
-            if (cclasses.contains(cclass)) {
-                return (true);
-            }
+    // Classes interned on both sides share a bit.
+    auto words = std::min(bits_.size(), cclasses.bits_.size());
+    for (size_t i = 0; i < words; ++i) {
+        if (bits_[i] & cclasses.bits_[i]) {
+            return (true);
         }
-    } else {
-        for (const auto& cclass : cclasses) {
-            if (contains(cclass)) {
-                return (true);
-            }
+    }
+
+    // The other classes are compared by name.
+    for (auto const& cclass : uninterned_) {
+        if (cclasses.contains(cclass)) {
+            return (true);
+        }
+    }
+    for (auto const& cclass : cclasses.uninterned_) {
+        if (contains(cclass)) {
+            return (true);
         }
     }
 
@@ -126,13 +183,42 @@ ClientClasses::equals(const ClientClasses& other) const {
 
 ClientClasses&
 ClientClasses::operator=(const ClientClasses& other) {
-    clear();
-    for (auto const& cclass : other) {
-        insert(cclass);
+    if (this != &other) {
+        container_ = other.container_;
+        bits_ = other.bits_;
+        uninterned_ = other.uninterned_;
     }
 
     return (*this);
 }
 
+ClientClassId
+ClientClasses::internClass(const ClientClass& class_name) {
+    auto& class_ids = getClassIds();
+    auto it = class_ids.find(class_name);
+    if (it != class_ids.end()) {
+        return (it->second);
+    }
+    auto id = static_cast<ClientClassId>(class_ids.size());
+    class_ids.emplace(class_name, id);
+    return (id);
+}
+
+bool
+ClientClasses::getClassId(const ClientClass& class_name, ClientClassId& id) {
+    auto const& class_ids = getClassIds();
+    auto it = class_ids.find(class_name);
+    if (it == class_ids.end()) {
+        return (false);
+    }
+    id = it->second;
+    return (true);
+}
+
+size_t
+ClientClasses::getInternedClassCount() {
+    return (getClassIds().size());
+}
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
@@ -17,7 +17,9 @@
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 /// @file   classify.h
 ///
@@ -42,6 +44,12 @@ namespace dhcp {
 /// @brief Defines a single class name.
 typedef std::string ClientClass;
 
+/// @brief Defines an interned class identifier.
+///
+/// Class names used in the configuration are mapped to dense integers
+/// so that the class membership can be represented as a bitset.
+typedef uint32_t ClientClassId;
+
 /// @brief Tag for the sequence index.
 struct ClassSequenceTag { };
 
@@ -106,6 +114,13 @@ typedef boost::multi_index_container<
 ///
 /// Both a list to iterate on it in insert order and unordered
 /// set of names for existence.
+///
+/// The class names interned at configuration time (see @ref internClass)
+/// are also held in a bitset indexed by their identifiers. It allows for
+/// checking if two containers intersect without hashing and comparing
+/// the class names. The names which have not been interned (e.g., the
+/// vendor classes or the spawned subclasses) are held in a separate list
+/// and are compared by name.
 class ClientClasses : public isc::data::CfgToElement {
 public:
 
@@ -114,7 +129,7 @@ public:
     typedef ClientClassContainer::iterator iterator;
 
     /// @brief Default constructor.
-    ClientClasses() : container_() {
+    ClientClasses() : container_(), bits_(), uninterned_() {
     }
 
     /// @brief Constructor from comma separated values.
@@ -155,10 +170,11 @@ public:
 
     /// @brief Insert an element.
     ///
+    /// If the class name has been interned its identifier is set in
+    /// the bitset. The class name is never interned by this function.
+    ///
     /// @param class_name The name of the class to insert
-    void insert(const ClientClass& class_name) {
-        static_cast<void>(container_.push_back(class_name));
-    }
+    void insert(const ClientClass& class_name);
 
     /// @brief Erase element by name.
     ///
@@ -225,6 +241,8 @@ public:
     /// @brief Clears containers.
     void clear() {
         container_.clear();
+        bits_.clear();
+        uninterned_.clear();
     }
 
     /// @brief Returns all class names as text
@@ -250,9 +268,50 @@ public:
     /// are invalid
     void fromElement(isc::data::ConstElementPtr list);
 
+    /// @brief Interns a class name.
+    ///
+    /// Assigns a dense identifier to the class name, unless it already
+    /// has one. The identifiers are never released so a class name keeps
+    /// its identifier for the process lifetime, even when the class is
+    /// removed by a reconfiguration.
+    ///
+    /// It should be called for the names of the configured classes and for
+    /// the class names in the client class restrictions of the subnets,
+    /// shared networks and pools. It must not be called during the packet
+    /// processing: as the rest of the configuration, the identifiers are
+    /// modified only when the packet processing threads are stopped.
+    ///
+    /// @param class_name The name of the class to intern.
+    /// @return The class identifier.
+    static ClientClassId internClass(const ClientClass& class_name);
+
+    /// @brief Returns the identifier of an interned class name.
+    ///
+    /// @param class_name The name of the class.
+    /// @param [out] id The class identifier.
+    /// @return true if the class name has been interned, false otherwise.
+    static bool getClassId(const ClientClass& class_name, ClientClassId& id);
+
+    /// @brief Returns the number of interned class names.
+    ///
+    /// @return the number of interned class names.
+    static size_t getInternedClassCount();
+
 private:
+    /// @brief Sets the bit of an interned class.
+    ///
+    /// @param id The class identifier.
+    void setBit(ClientClassId id);
+
     /// @brief container part
     ClientClassContainer container_;
+
+    /// @brief Bitset of the interned classes in the container.
+    std::vector<uint64_t> bits_;
+
+    /// @brief Classes in the container which were not interned when
+    /// they were inserted.
+    std::vector<ClientClass> uninterned_;
 };
 
 }
@@ -185,7 +185,9 @@ bool Iface::delSocket(const uint16_t sockfd) {
 IfaceMgr::IfaceMgr()
     : packet_filter_(new PktFilterInet()),
       packet_filter6_(new PktFilterInet6()),
-      test_mode_(false), allow_loopback_(false) {
+      test_mode_(false), allow_loopback_(false), packet_mmap_(false),
+      receiver_per_socket_(false),
+      next_socket_receiver_(0), receive_batch_size_(1), send_batch_size_(1) {
 
     // Ensure that PQMs have been created to guarantee we have
     // default packet queues in place.
@@ -291,17 +293,41 @@ void IfaceMgr::closeSockets() {
     stopDHCPReceiver();
 
     for (const IfacePtr& iface : ifaces_) {
+        // Let the packet filters release the state they keep per socket
+        // before the descriptors are closed and possibly reused.
+        for (const SocketInfo& sock : iface->getSockets()) {
+            if (sock.family_ == AF_INET) {
+                packet_filter_->releaseSocket(sock.sockfd_);
+            } else {
+                packet_filter6_->releaseSocket(sock.sockfd_);
+            }
+        }
         iface->closeSockets();
     }
 }
 
 void IfaceMgr::stopDHCPReceiver() {
-    if (isDHCPReceiverRunning()) {
+    if (dhcp_receiver_ && dhcp_receiver_->isRunning()) {
         dhcp_receiver_->stop();
     }
 
     dhcp_receiver_.reset();
 
+    for (auto const& receiver : socket_receivers_) {
+        if (receiver->thread_->isRunning()) {
+            receiver->thread_->stop();
+        }
+        if (receiver->queue4_) {
+            receiver->queue4_->clear();
+        }
+        if (receiver->queue6_) {
+            receiver->queue6_->clear();
+        }
+    }
+
+    socket_receivers_.clear();
+    next_socket_receiver_ = 0;
+
     if (getPacketQueue4()) {
         getPacketQueue4()->clear();
     }
@@ -315,6 +341,21 @@ IfaceMgr::~IfaceMgr() {
     closeSockets();
 }
 
+bool
+IfaceMgr::isDHCPReceiverRunning() const {
+    if (dhcp_receiver_ && dhcp_receiver_->isRunning()) {
+        return (true);
+    }
+
+    for (auto const& receiver : socket_receivers_) {
+        if (receiver->thread_->isRunning()) {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
 bool
 IfaceMgr::isDirectResponseSupported() const {
     return (packet_filter_->isDirectResponseSupported());
@@ -752,6 +793,11 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
             return;
         }
 
+        if (receiver_per_socket_) {
+            startDHCPSocketReceivers(AF_INET);
+            return;
+        }
+
         dhcp_receiver_.reset(new WatchedThread());
         dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP4Packets, this));
         break;
@@ -762,6 +808,11 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
             return;
         }
 
+        if (receiver_per_socket_) {
+            startDHCPSocketReceivers(AF_INET6);
+            return;
+        }
+
         dhcp_receiver_.reset(new WatchedThread());
         dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP6Packets, this));
         break;
@@ -771,6 +822,41 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
     }
 }
 
+void
+IfaceMgr::startDHCPSocketReceivers(const uint16_t family) {
+    data::ConstElementPtr parameters;
+    if (family == AF_INET) {
+        parameters = packet_queue_mgr4_->getPacketQueueParameters();
+    } else {
+        parameters = packet_queue_mgr6_->getPacketQueueParameters();
+    }
+
+    // Create all receivers and their queues first so a queue creation
+    // failure does not leave some threads running.
+    std::vector<SocketReceiverPtr> receivers;
+    for (const IfacePtr& iface : ifaces_) {
+        for (const SocketInfo& s : iface->getSockets()) {
+            if (s.family_ != family) {
+                continue;
+            }
+            SocketReceiverPtr receiver(new SocketReceiver(iface, s));
+            if (family == AF_INET) {
+                receiver->queue4_ = packet_queue_mgr4_->makePacketQueue(parameters);
+            } else {
+                receiver->queue6_ = packet_queue_mgr6_->makePacketQueue(parameters);
+            }
+            receivers.push_back(receiver);
+        }
+    }
+
+    socket_receivers_ = receivers;
+    next_socket_receiver_ = 0;
+    for (auto const& receiver : socket_receivers_) {
+        receiver->thread_->start(std::bind(&IfaceMgr::receiveDHCPSocketPackets,
+                                           this, receiver));
+    }
+}
+
 void
 IfaceMgr::addInterface(const IfacePtr& iface) {
     for (const IfacePtr& existing : ifaces_) {
@@ -1104,6 +1190,11 @@ IfaceMgr::send(const Pkt6Ptr& pkt) {
                   << pkt->getIface() << ") specified.");
     }
 
+    if (isSendBatching()) {
+        return (sendBatched(iface, getSocket(pkt), pkt, send_batches6_,
+                            packet_filter6_));
+    }
+
     // Assuming that packet filter is not null, because its modifier checks it.
     // The packet filter returns an int but in fact it either returns 0 or throws.
     return (packet_filter6_->send(*iface, getSocket(pkt), pkt) == 0);
@@ -1117,11 +1208,79 @@ IfaceMgr::send(const Pkt4Ptr& pkt) {
                   << pkt->getIface() << ") specified.");
     }
 
+    if (isSendBatching()) {
+        return (sendBatched(iface, getSocket(pkt).sockfd_, pkt, send_batches4_,
+                            packet_filter_));
+    }
+
     // Assuming that packet filter is not null, because its modifier checks it.
     // The packet filter returns an int but in fact it either returns 0 or throws.
     return (packet_filter_->send(*iface, getSocket(pkt).sockfd_, pkt) == 0);
 }
 
+bool
+IfaceMgr::isSendBatching() const {
+    return (send_batch_size_ > 1);
+}
+
+template <typename PktPtrType, typename FilterPtrType>
+bool
+IfaceMgr::sendBatched(const IfacePtr& iface, uint16_t sockfd,
+                      const PktPtrType& pkt,
+                      std::map<uint16_t, SendBatch<PktPtrType> >& batches,
+                      const FilterPtrType& filter) {
+    SendTicketPtr ticket(new SendTicket());
+    std::unique_lock<std::mutex> lock(send_batches_mutex_);
+    // The batches are never removed so the reference remains valid
+    // when the lock is released.
+    SendBatch<PktPtrType>& batch = batches[sockfd];
+    batch.pkts_.push_back(pkt);
+    batch.tickets_.push_back(ticket);
+
+    while (!ticket->done_) {
+        if (batch.sending_) {
+            // Another thread is sending through the socket: the packet
+            // will go with the next batch.
+            send_batches_cv_.wait(lock);
+            continue;
+        }
+
+        // Send the waiting packets, including this one when it is among
+        // the first ones.
+        batch.sending_ = true;
+        size_t count = std::min(batch.pkts_.size(), send_batch_size_);
+        std::vector<PktPtrType> pkts(batch.pkts_.begin(),
+                                     batch.pkts_.begin() + count);
+        std::vector<SendTicketPtr> tickets(batch.tickets_.begin(),
+                                           batch.tickets_.begin() + count);
+        batch.pkts_.erase(batch.pkts_.begin(), batch.pkts_.begin() + count);
+        batch.tickets_.erase(batch.tickets_.begin(),
+                             batch.tickets_.begin() + count);
+        lock.unlock();
+
+        std::vector<std::string> errors;
+        try {
+            filter->sendBatch(*iface, sockfd, pkts, errors);
+        } catch (const std::exception& ex) {
+            errors.assign(count, ex.what());
+        }
+        errors.resize(count);
+
+        lock.lock();
+        for (size_t i = 0; i < count; ++i) {
+            tickets[i]->error_ = errors[i];
+            tickets[i]->done_ = true;
+        }
+        batch.sending_ = false;
+        send_batches_cv_.notify_all();
+    }
+
+    if (!ticket->error_.empty()) {
+        isc_throw(SocketWriteError, ticket->error_);
+    }
+    return (true);
+}
+
 Pkt4Ptr IfaceMgr::receive4(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */) {
     if (isDHCPReceiverRunning()) {
         return (receive4Indirect(timeout_sec, timeout_usec));
@@ -1153,11 +1312,8 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
         }
     }
 
-    // Add Receiver ready watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, &sockets);
-
-    // Add Receiver error watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, &sockets);
+    // Add Receiver ready and error watch sockets
+    addReceiverFDsToSet(maxfd, &sockets);
 
     // Set timeout for our next select() call.  If there are
     // no DHCP packets to read, then we'll wait for a finite
@@ -1166,7 +1322,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
     // DHCP packets are waiting so we don't starve external
     // sockets under heavy DHCP load.
     struct timeval select_timeout;
-    if (getPacketQueue4()->empty()) {
+    if (receiverQueues4Empty()) {
         select_timeout.tv_sec = timeout_sec;
         select_timeout.tv_usec = timeout_usec;
     } else {
@@ -1179,7 +1335,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
 
     int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
 
-    if ((result == 0) && getPacketQueue4()->empty()) {
+    if ((result == 0) && receiverQueues4Empty()) {
         // nothing received and timeout has been reached
         return (Pkt4Ptr());
     } else if (result < 0) {
@@ -1205,11 +1361,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
     // We only check external sockets if select detected an event.
     if (result > 0) {
         // Check for receiver thread read errors.
-        if (dhcp_receiver_->isReady(WatchedThread::ERROR)) {
-            string msg = dhcp_receiver_->getLastError();
-            dhcp_receiver_->clearReady(WatchedThread::ERROR);
-            isc_throw(SocketReadError, msg);
-        }
+        checkReceiverErrors();
 
         // Let's find out which external socket has the data
         SocketCallbackInfo ex_sock;
@@ -1244,12 +1396,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
     }
 
     // If we're here it should only be because there are DHCP packets waiting.
-    Pkt4Ptr pkt = getPacketQueue4()->dequeuePacket();
-    if (!pkt) {
-        dhcp_receiver_->clearReady(WatchedThread::READY);
-    }
-
-    return (pkt);
+    return (dequeueReceivedPacket4());
 }
 
 Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */) {
@@ -1543,11 +1690,8 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
-    // Add Receiver ready watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, &sockets);
-
-    // Add Receiver error watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, &sockets);
+    // Add Receiver ready and error watch sockets
+    addReceiverFDsToSet(maxfd, &sockets);
 
     // Set timeout for our next select() call.  If there are
     // no DHCP packets to read, then we'll wait for a finite
@@ -1556,7 +1700,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
     // DHCP packets are waiting so we don't starve external
     // sockets under heavy DHCP load.
     struct timeval select_timeout;
-    if (getPacketQueue6()->empty()) {
+    if (receiverQueues6Empty()) {
         select_timeout.tv_sec = timeout_sec;
         select_timeout.tv_usec = timeout_usec;
     } else {
@@ -1569,7 +1713,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
 
     int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
 
-    if ((result == 0) && getPacketQueue6()->empty()) {
+    if ((result == 0) && receiverQueues6Empty()) {
         // nothing received and timeout has been reached
         return (Pkt6Ptr());
     } else if (result < 0) {
@@ -1595,11 +1739,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
     // We only check external sockets if select detected an event.
     if (result > 0) {
         // Check for receiver thread read errors.
-        if (dhcp_receiver_->isReady(WatchedThread::ERROR)) {
-            string msg = dhcp_receiver_->getLastError();
-            dhcp_receiver_->clearReady(WatchedThread::ERROR);
-            isc_throw(SocketReadError, msg);
-        }
+        checkReceiverErrors();
 
         // Let's find out which external socket has the data
         SocketCallbackInfo ex_sock;
@@ -1634,12 +1774,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
     }
 
     // If we're here it should only be because there are DHCP packets waiting.
-    Pkt6Ptr pkt = getPacketQueue6()->dequeuePacket();
-    if (!pkt) {
-        dhcp_receiver_->clearReady(WatchedThread::READY);
-    }
-
-    return (pkt);
+    return (dequeueReceivedPacket6());
 }
 
 void
@@ -1704,7 +1839,8 @@ IfaceMgr::receiveDHCP4Packets() {
         for (const IfacePtr& iface : ifaces_) {
             for (const SocketInfo& s : iface->getSockets()) {
                 if (FD_ISSET(s.sockfd_, &sockets)) {
-                    receiveDHCP4Packet(*iface, s);
+                    receiveDHCP4Packet(*iface, s, *dhcp_receiver_,
+                                       getPacketQueue4());
                     // Can take time so check one more time the watch socket.
                     if (dhcp_receiver_->shouldTerminate()) {
                         return;
@@ -1777,7 +1913,7 @@ IfaceMgr::receiveDHCP6Packets() {
         for (const IfacePtr& iface : ifaces_) {
             for (const SocketInfo& s : iface->getSockets()) {
                 if (FD_ISSET(s.sockfd_, &sockets)) {
-                    receiveDHCP6Packet(s);
+                    receiveDHCP6Packet(s, *dhcp_receiver_, getPacketQueue6());
                     // Can take time so check one more time the watch socket.
                     if (dhcp_receiver_->shouldTerminate()) {
                         return;
@@ -1789,44 +1925,51 @@ IfaceMgr::receiveDHCP6Packets() {
 }
 
 void
-IfaceMgr::receiveDHCP4Packet(Iface& iface, const SocketInfo& socket_info) {
-    int len;
-
-    int result = ioctl(socket_info.sockfd_, FIONREAD, &len);
-    if (result < 0) {
+IfaceMgr::receiveDHCP4Packet(Iface& iface, const SocketInfo& socket_info,
+                             WatchedThread& receiver,
+                             const PacketQueue4Ptr& queue) {
+    // The packet filter knows if it reads from the socket queue or from
+    // a memory-mapped ring.
+    try {
+        if (!packet_filter_->isReadable(socket_info)) {
+            // Nothing to read.
+            return;
+        }
+    } catch (const std::exception& ex) {
         // Signal the error to receive4.
-        dhcp_receiver_->setError(strerror(errno));
-        return;
-    }
-    if (len == 0) {
-        // Nothing to read.
+        receiver.setError(ex.what());
         return;
     }
 
-    Pkt4Ptr pkt;
+    std::vector<Pkt4Ptr> pkts;
 
     try {
-        pkt = packet_filter_->receive(iface, socket_info);
+        packet_filter_->receiveBatch(iface, socket_info, receive_batch_size_,
+                                     pkts);
     } catch (const std::exception& ex) {
-        dhcp_receiver_->setError(strerror(errno));
+        receiver.setError(strerror(errno));
     } catch (...) {
-        dhcp_receiver_->setError("packet filter receive() failed");
+        receiver.setError("packet filter receive() failed");
     }
 
-    if (pkt) {
-        getPacketQueue4()->enqueuePacket(pkt, socket_info);
-        dhcp_receiver_->markReady(WatchedThread::READY);
+    for (auto const& pkt : pkts) {
+        queue->enqueuePacket(pkt, socket_info);
+    }
+    if (!pkts.empty()) {
+        receiver.markReady(WatchedThread::READY);
     }
 }
 
 void
-IfaceMgr::receiveDHCP6Packet(const SocketInfo& socket_info) {
+IfaceMgr::receiveDHCP6Packet(const SocketInfo& socket_info,
+                             WatchedThread& receiver,
+                             const PacketQueue6Ptr& queue) {
     int len;
 
     int result = ioctl(socket_info.sockfd_, FIONREAD, &len);
     if (result < 0) {
         // Signal the error to receive6.
-        dhcp_receiver_->setError(strerror(errno));
+        receiver.setError(strerror(errno));
         return;
     }
     if (len == 0) {
@@ -1834,22 +1977,206 @@ IfaceMgr::receiveDHCP6Packet(const SocketInfo& socket_info) {
         return;
     }
 
-    Pkt6Ptr pkt;
+    std::vector<Pkt6Ptr> pkts;
 
     try {
-        pkt = packet_filter6_->receive(socket_info);
+        packet_filter6_->receiveBatch(socket_info, receive_batch_size_, pkts);
     } catch (const std::exception& ex) {
-        dhcp_receiver_->setError(ex.what());
+        receiver.setError(ex.what());
     } catch (...) {
-        dhcp_receiver_->setError("packet filter receive() failed");
+        receiver.setError("packet filter receive() failed");
     }
 
-    if (pkt) {
-        getPacketQueue6()->enqueuePacket(pkt, socket_info);
-        dhcp_receiver_->markReady(WatchedThread::READY);
+    for (auto const& pkt : pkts) {
+        queue->enqueuePacket(pkt, socket_info);
+    }
+    if (!pkts.empty()) {
+        receiver.markReady(WatchedThread::READY);
     }
 }
 
+void
+IfaceMgr::receiveDHCPSocketPackets(const SocketReceiverPtr& receiver) {
+    WatchedThread& thread = *receiver->thread_;
+    const SocketInfo& socket_info = receiver->socket_info_;
+    fd_set sockets;
+    int maxfd = 0;
+
+    FD_ZERO(&sockets);
+
+    // Add terminate watch socket.
+    addFDtoSet(thread.getWatchFd(WatchedThread::TERMINATE), maxfd, &sockets);
+
+    // Add the served socket.
+    addFDtoSet(socket_info.sockfd_, maxfd, &sockets);
+
+    for (;;) {
+        // Check the watch socket.
+        if (thread.shouldTerminate()) {
+            return;
+        }
+
+        fd_set rd_set;
+        FD_COPY(&sockets, &rd_set);
+
+        // zero out the errno to be safe.
+        errno = 0;
+
+        // Note we wait until something happen.
+        int result = select(maxfd + 1, &rd_set, 0, 0, 0);
+
+        // Re-check the watch socket.
+        if (thread.shouldTerminate()) {
+            return;
+        }
+
+        if (result == 0) {
+            // nothing received?
+            continue;
+        } else if (result < 0) {
+            // This thread should not get signals?
+            if (errno != EINTR) {
+                // Signal the error to receive4 or receive6.
+                thread.setError(strerror(errno));
+                // We need to sleep in case of the error condition to
+                // prevent the thread from tight looping when result
+                // gets negative.
+                sleep(1);
+            }
+            continue;
+        }
+
+        if (FD_ISSET(socket_info.sockfd_, &rd_set)) {
+            if (receiver->queue4_) {
+                receiveDHCP4Packet(*receiver->iface_, socket_info, thread,
+                                   receiver->queue4_);
+            } else {
+                receiveDHCP6Packet(socket_info, thread, receiver->queue6_);
+            }
+        }
+    }
+}
+
+void
+IfaceMgr::addReceiverFDsToSet(int& maxfd, fd_set* sockets) {
+    if (dhcp_receiver_) {
+        addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, sockets);
+        addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, sockets);
+    }
+
+    for (auto const& receiver : socket_receivers_) {
+        addFDtoSet(receiver->thread_->getWatchFd(WatchedThread::READY), maxfd, sockets);
+        addFDtoSet(receiver->thread_->getWatchFd(WatchedThread::ERROR), maxfd, sockets);
+    }
+}
+
+void
+IfaceMgr::checkReceiverErrors() {
+    if (dhcp_receiver_ && dhcp_receiver_->isReady(WatchedThread::ERROR)) {
+        string msg = dhcp_receiver_->getLastError();
+        dhcp_receiver_->clearReady(WatchedThread::ERROR);
+        isc_throw(SocketReadError, msg);
+    }
+
+    for (auto const& receiver : socket_receivers_) {
+        if (receiver->thread_->isReady(WatchedThread::ERROR)) {
+            string msg = receiver->thread_->getLastError();
+            receiver->thread_->clearReady(WatchedThread::ERROR);
+            isc_throw(SocketReadError, msg);
+        }
+    }
+}
+
+bool
+IfaceMgr::receiverQueues4Empty() const {
+    if (socket_receivers_.empty()) {
+        return (packet_queue_mgr4_->getPacketQueue()->empty());
+    }
+
+    for (auto const& receiver : socket_receivers_) {
+        if (receiver->queue4_ && !receiver->queue4_->empty()) {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+bool
+IfaceMgr::receiverQueues6Empty() const {
+    if (socket_receivers_.empty()) {
+        return (packet_queue_mgr6_->getPacketQueue()->empty());
+    }
+
+    for (auto const& receiver : socket_receivers_) {
+        if (receiver->queue6_ && !receiver->queue6_->empty()) {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+Pkt4Ptr
+IfaceMgr::dequeueReceivedPacket4() {
+    if (socket_receivers_.empty()) {
+        Pkt4Ptr pkt = getPacketQueue4()->dequeuePacket();
+        if (!pkt) {
+            dhcp_receiver_->clearReady(WatchedThread::READY);
+        }
+        return (pkt);
+    }
+
+    // Visit the queues starting from the one following the queue we
+    // dequeued from last time.
+    size_t count = socket_receivers_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const SocketReceiverPtr& receiver =
+            socket_receivers_[(next_socket_receiver_ + i) % count];
+        if (!receiver->queue4_) {
+            continue;
+        }
+        Pkt4Ptr pkt = receiver->queue4_->dequeuePacket();
+        if (pkt) {
+            next_socket_receiver_ = (next_socket_receiver_ + i + 1) % count;
+            return (pkt);
+        }
+        receiver->thread_->clearReady(WatchedThread::READY);
+    }
+
+    return (Pkt4Ptr());
+}
+
+Pkt6Ptr
+IfaceMgr::dequeueReceivedPacket6() {
+    if (socket_receivers_.empty()) {
+        Pkt6Ptr pkt = getPacketQueue6()->dequeuePacket();
+        if (!pkt) {
+            dhcp_receiver_->clearReady(WatchedThread::READY);
+        }
+        return (pkt);
+    }
+
+    // Visit the queues starting from the one following the queue we
+    // dequeued from last time.
+    size_t count = socket_receivers_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const SocketReceiverPtr& receiver =
+            socket_receivers_[(next_socket_receiver_ + i) % count];
+        if (!receiver->queue6_) {
+            continue;
+        }
+        Pkt6Ptr pkt = receiver->queue6_->dequeuePacket();
+        if (pkt) {
+            next_socket_receiver_ = (next_socket_receiver_ + i + 1) % count;
+            return (pkt);
+        }
+        receiver->thread_->clearReady(WatchedThread::READY);
+    }
+
+    return (Pkt6Ptr());
+}
+
 uint16_t
 IfaceMgr::getSocket(const isc::dhcp::Pkt6Ptr& pkt) {
     IfacePtr iface = getIface(pkt);
@@ -1947,15 +2274,46 @@ IfaceMgr::configureDHCPPacketQueue(uint16_t family, data::ConstElementPtr queue_
     }
 
     bool enable_queue = false;
+    receiver_per_socket_ = false;
+    int64_t receive_batch_size = 1;
+    int64_t send_batch_size = 1;
+    packet_mmap_ = false;
     if (queue_control) {
+        if (queue_control->contains("packet-mmap")) {
+            packet_mmap_ = data::SimpleParser::getBoolean(queue_control, "packet-mmap");
+        }
+
         try {
             enable_queue = data::SimpleParser::getBoolean(queue_control, "enable-queue");
         } catch (...) {
             // @todo - for now swallow not found errors.
             // if not present we assume default
         }
+
+        if (enable_queue && queue_control->contains("receiver-per-socket")) {
+            receiver_per_socket_ =
+                data::SimpleParser::getBoolean(queue_control, "receiver-per-socket");
+        }
+
+        if (enable_queue && queue_control->contains("receive-batch-size")) {
+            receive_batch_size = data::SimpleParser::getInteger(queue_control,
+                                                                "receive-batch-size");
+        }
+
+        if (enable_queue && queue_control->contains("send-batch-size")) {
+            send_batch_size = data::SimpleParser::getInteger(queue_control,
+                                                             "send-batch-size");
+        }
     }
 
+    if ((receive_batch_size <= 0) || (send_batch_size <= 0)) {
+        isc_throw(BadValue, "receive-batch-size and send-batch-size must be"
+                  " greater than 0");
+    }
+
+    receive_batch_size_ = static_cast<size_t>(receive_batch_size);
+    send_batch_size_ = static_cast<size_t>(send_batch_size);
+
     if (enable_queue) {
         // Try to create the queue as configured.
         if (family == AF_INET) {
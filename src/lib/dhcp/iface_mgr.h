@@ -28,8 +28,10 @@
 #include <boost/scoped_array.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <condition_variable>
 #include <functional>
 #include <list>
+#include <map>
 #include <vector>
 #include <mutex>
 
@@ -742,6 +744,24 @@ public:
         allow_loopback_ = allow_loopback;
     }
 
+    /// @brief Enables or disables the memory-mapped packet rings.
+    ///
+    /// When enabled, @c setMatchingPacketFilter selects a packet filter
+    /// reading and writing the raw sockets through memory-mapped rings,
+    /// if the OS supports them. It is disabled by default.
+    ///
+    /// @param packet_mmap true to use the rings.
+    void setPacketMmap(const bool packet_mmap) {
+        packet_mmap_ = packet_mmap;
+    }
+
+    /// @brief Checks if the memory-mapped packet rings are enabled.
+    ///
+    /// @return true if the rings are enabled, false otherwise.
+    bool isPacketMmap() const {
+        return (packet_mmap_);
+    }
+
     /// @brief Check if packet be sent directly to the client having no address.
     ///
     /// Checks if IfaceMgr can send DHCPv4 packet to the client
@@ -885,6 +905,12 @@ public:
     ///
     /// @param pkt packet to be sent
     ///
+    /// When send batching is enabled (see @c configureDHCPPacketQueue)
+    /// the packets sent concurrently through a socket are grouped: the
+    /// packet is added to the batch of its socket and the call returns
+    /// when the packet was sent, either by this thread with the other
+    /// waiting packets or by another thread sending the batch.
+    ///
     /// @throw isc::BadValue if invalid interface specified in the packet.
     /// @throw isc::dhcp::SocketWriteError if sendmsg() failed to send packet.
     /// @return true if sending was successful
@@ -898,6 +924,12 @@ public:
     ///
     /// @param pkt a packet to be sent
     ///
+    /// When send batching is enabled (see @c configureDHCPPacketQueue)
+    /// the packets sent concurrently through a socket are grouped: the
+    /// packet is added to the batch of its socket and the call returns
+    /// when the packet was sent, either by this thread with the other
+    /// waiting packets or by another thread sending the batch.
+    ///
     /// @throw isc::BadValue if invalid interface specified in the packet.
     /// @throw isc::dhcp::SocketWriteError if sendmsg() failed to send packet.
     /// @return true if sending was successful
@@ -1134,8 +1166,9 @@ public:
 
     /// @brief Closes all open sockets.
     ///
-    /// It calls @c stopDHCPReceiver to stop the receiver thread and then
-    /// it closes all open interface sockets.
+    /// It calls @c stopDHCPReceiver to stop the receiver thread, lets the
+    /// packet filters release the sockets and then it closes all open
+    /// interface sockets.
     ///
     /// Is used in destructor, but also from Dhcpv4Srv and Dhcpv6Srv classes.
     void closeSockets();
@@ -1229,6 +1262,8 @@ public:
     /// If there isn't, the PktFilterInet object will be set. If the
     /// argument is set to 'false', PktFilterInet object instance will
     /// be set as the Packet Filter regardless of the OS type.
+    /// On Linux, the filter supporting direct responses uses memory-mapped
+    /// rings when they are enabled with @c setPacketMmap.
     ///
     /// @param direct_response_desired specifies whether the Packet Filter
     /// object being set should support direct traffic to the host
@@ -1323,8 +1358,38 @@ public:
 
     /// @brief Returns true if there is a receiver exists and its
     /// thread is currently running.
-    bool isDHCPReceiverRunning() const {
-        return (dhcp_receiver_ != 0 && dhcp_receiver_->isRunning());
+    ///
+    /// In the per-socket receiver mode it returns true when at least
+    /// one socket receiver thread is running.
+    bool isDHCPReceiverRunning() const;
+
+    /// @brief Checks if each socket is served by its own receiver.
+    ///
+    /// @return true if the per-socket receiver mode has been enabled by
+    /// the last call to @c configureDHCPPacketQueue.
+    bool isDHCPReceiverPerSocket() const {
+        return (receiver_per_socket_);
+    }
+
+    /// @brief Returns the maximum number of packets a receiver reads
+    /// from a socket at once.
+    size_t getReceiveBatchSize() const {
+        return (receive_batch_size_);
+    }
+
+    /// @brief Returns the maximum number of packets sent at once.
+    ///
+    /// @return send batch size, 1 when send batching is disabled.
+    size_t getSendBatchSize() const {
+        return (send_batch_size_);
+    }
+
+    /// @brief Returns the number of running per-socket receivers.
+    ///
+    /// @return number of socket receivers, 0 when the per-socket
+    /// receiver mode is disabled or no receiver was started.
+    size_t getDHCPSocketReceiverCount() const {
+        return (socket_receivers_.size());
     }
 
     /// @brief Configures DHCP packet queue
@@ -1334,12 +1399,31 @@ public:
     /// destroyed. If the receiver thread is running when this function
     /// is invoked, it will throw.
     ///
+    /// When the optional "receiver-per-socket" boolean is true, the
+    /// receiver is started in the per-socket mode: each open socket
+    /// gets its own receiver thread and its own packet queue created
+    /// with the same parameters, instead of a single thread monitoring
+    /// all sockets.
+    ///
+    /// The optional "receive-batch-size" sets the maximum number of
+    /// packets a receiver reads from a socket with one packet filter
+    /// call and "send-batch-size" the maximum number of responses sent
+    /// through a socket with one packet filter call. Both default to 1
+    /// (no batching). They are ignored when queueing is disabled as the
+    /// packets are then received and sent one at a time by the server
+    /// threads.
+    ///
+    /// The optional "packet-mmap" enables the memory-mapped rings on the
+    /// raw sockets used for direct responses on Linux. It applies to the
+    /// packet filter set after this call and does not depend on queueing.
+    ///
     /// @param family indicates which receiver to start,
     /// (AF_INET or AF_INET6)
     /// @param queue_control configuration containing "dhcp-queue-control"
     /// content
     /// @return true if packet queueing has been enabled, false otherwise
     /// @throw InvalidOperation if the receiver thread is currently running.
+    /// @throw BadValue if a batch size is not a positive integer.
     bool configureDHCPPacketQueue(const uint16_t family,
                                   data::ConstElementPtr queue_control);
 
@@ -1561,7 +1645,11 @@ private:
     ///
     /// @param iface interface
     /// @param socket_info structure holding socket information
-    void receiveDHCP4Packet(Iface& iface, const SocketInfo& socket_info);
+    /// @param receiver receiver thread to signal
+    /// @param queue packet queue to add the packet to
+    void receiveDHCP4Packet(Iface& iface, const SocketInfo& socket_info,
+                            isc::util::WatchedThread& receiver,
+                            const PacketQueue4Ptr& queue);
 
     /// @brief DHCPv6 receiver method.
     ///
@@ -1583,7 +1671,163 @@ private:
     /// the read, the "error" watch socket is marked ready.
     ///
     /// @param socket_info structure holding socket information
-    void receiveDHCP6Packet(const SocketInfo& socket_info);
+    /// @param receiver receiver thread to signal
+    /// @param queue packet queue to add the packet to
+    void receiveDHCP6Packet(const SocketInfo& socket_info,
+                            isc::util::WatchedThread& receiver,
+                            const PacketQueue6Ptr& queue);
+
+    /// @brief DHCP receiver serving a single socket.
+    ///
+    /// Used in the per-socket receiver mode: the thread reads packets
+    /// from one socket only and adds them to its own queue, so sockets
+    /// are read in parallel instead of by one thread looping on select().
+    struct SocketReceiver {
+        /// @brief Constructor.
+        ///
+        /// @param iface interface the socket belongs to.
+        /// @param socket_info socket to read packets from.
+        SocketReceiver(const IfacePtr& iface, const SocketInfo& socket_info)
+            : iface_(iface), socket_info_(socket_info), queue4_(), queue6_(),
+              thread_(new isc::util::WatchedThread()) {
+        }
+
+        /// @brief Interface the socket belongs to.
+        IfacePtr iface_;
+
+        /// @brief Socket to read packets from.
+        SocketInfo socket_info_;
+
+        /// @brief DHCPv4 packet queue (null for DHCPv6).
+        PacketQueue4Ptr queue4_;
+
+        /// @brief DHCPv6 packet queue (null for DHCPv4).
+        PacketQueue6Ptr queue6_;
+
+        /// @brief Receiver thread.
+        isc::util::WatchedThreadPtr thread_;
+    };
+
+    /// @brief Type of pointers to socket receivers.
+    typedef boost::shared_ptr<SocketReceiver> SocketReceiverPtr;
+
+    /// @brief Starts one receiver per open socket of a given family.
+    ///
+    /// @param family indicates which receivers to start,
+    /// (AF_INET or AF_INET6)
+    void startDHCPSocketReceivers(const uint16_t family);
+
+    /// @brief Per-socket receiver method.
+    ///
+    /// Loops forever reading DHCP packets from the socket of the given
+    /// receiver and adds them to the receiver queue. It monitors the
+    /// "terminate" watch socket of the receiver thread, and exits if it
+    /// is marked ready.
+    ///
+    /// @param receiver the socket receiver.
+    void receiveDHCPSocketPackets(const SocketReceiverPtr& receiver);
+
+    /// @brief Adds the ready and error watch sockets of the running
+    /// receivers to a set.
+    ///
+    /// @param[out] maxfd maximum fd value in the set.
+    /// @param sockets pointer to the set of sockets
+    void addReceiverFDsToSet(int& maxfd, fd_set* sockets);
+
+    /// @brief Throws the last error reported by any of the receivers.
+    ///
+    /// @throw isc::dhcp::SocketReadError if a receiver reported an error.
+    void checkReceiverErrors();
+
+    /// @brief Checks if there is no queued DHCPv4 packet.
+    ///
+    /// @return true if all DHCPv4 receiver queues are empty.
+    bool receiverQueues4Empty() const;
+
+    /// @brief Checks if there is no queued DHCPv6 packet.
+    ///
+    /// @return true if all DHCPv6 receiver queues are empty.
+    bool receiverQueues6Empty() const;
+
+    /// @brief Completion status of a packet waiting in a send batch.
+    struct SendTicket {
+        /// @brief Constructor.
+        SendTicket() : done_(false), error_() {
+        }
+
+        /// @brief Indicates that the packet was sent (or failed).
+        bool done_;
+
+        /// @brief Send error message, empty on success.
+        std::string error_;
+    };
+
+    /// @brief Pointer to a send ticket.
+    typedef boost::shared_ptr<SendTicket> SendTicketPtr;
+
+    /// @brief Packets waiting to be sent through a socket.
+    ///
+    /// @tparam PktPtrType type of the pointer to the packets.
+    template <typename PktPtrType>
+    struct SendBatch {
+        /// @brief Constructor.
+        SendBatch() : pkts_(), tickets_(), sending_(false) {
+        }
+
+        /// @brief Packets to send.
+        std::vector<PktPtrType> pkts_;
+
+        /// @brief Tickets of the packets to send.
+        std::vector<SendTicketPtr> tickets_;
+
+        /// @brief Indicates that a thread is sending through the socket.
+        bool sending_;
+    };
+
+    /// @brief Sends a packet in the batch of its socket.
+    ///
+    /// The packet is queued in the batch of the socket. When no other
+    /// thread is sending through the socket, the calling thread sends
+    /// the queued packets, up to the send batch size, with a single
+    /// packet filter call. Otherwise it waits for the sending thread,
+    /// so the packets queued meanwhile form the next batch. The call
+    /// returns when the packet was sent or failed.
+    ///
+    /// @tparam PktPtrType type of the pointer to the packet.
+    /// @tparam FilterPtrType type of the pointer to the packet filter.
+    /// @param iface interface to send the packet through
+    /// @param sockfd socket descriptor
+    /// @param pkt packet to send
+    /// @param batches batches by socket descriptor
+    /// @param filter packet filter
+    /// @return true if sending was successful
+    /// @throw isc::dhcp::SocketWriteError if the packet could not be sent.
+    template <typename PktPtrType, typename FilterPtrType>
+    bool sendBatched(const IfacePtr& iface, uint16_t sockfd,
+                     const PktPtrType& pkt,
+                     std::map<uint16_t, SendBatch<PktPtrType> >& batches,
+                     const FilterPtrType& filter);
+
+    /// @brief Checks if packets are sent in batches.
+    ///
+    /// @return true if send batching is configured.
+    bool isSendBatching() const;
+
+    /// @brief Dequeues the next DHCPv4 packet from the receiver queues.
+    ///
+    /// In the per-socket receiver mode queues are visited in the
+    /// round-robin order so a busy socket can't starve the others.
+    ///
+    /// @return next packet or null if all queues are empty.
+    Pkt4Ptr dequeueReceivedPacket4();
+
+    /// @brief Dequeues the next DHCPv6 packet from the receiver queues.
+    ///
+    /// In the per-socket receiver mode queues are visited in the
+    /// round-robin order so a busy socket can't starve the others.
+    ///
+    /// @return next packet or null if all queues are empty.
+    Pkt6Ptr dequeueReceivedPacket6();
 
     /// @brief Deletes external socket with the callbacks_mutex_ taken
     ///
@@ -1631,8 +1875,38 @@ private:
     /// @brief Manager for DHCPv6 packet implementations and queues
     PacketQueueMgr6Ptr packet_queue_mgr6_;
 
+    /// @brief Use memory-mapped rings on the raw sockets.
+    bool packet_mmap_;
+
     /// @brief DHCP packet receiver.
     isc::util::WatchedThreadPtr dhcp_receiver_;
+
+    /// @brief Enables one receiver per socket instead of @c dhcp_receiver_.
+    bool receiver_per_socket_;
+
+    /// @brief Per-socket DHCP packet receivers.
+    std::vector<SocketReceiverPtr> socket_receivers_;
+
+    /// @brief Index of the socket receiver queue to dequeue from next.
+    size_t next_socket_receiver_;
+
+    /// @brief Maximum number of packets read from a socket at once.
+    size_t receive_batch_size_;
+
+    /// @brief Maximum number of packets sent through a socket at once.
+    size_t send_batch_size_;
+
+    /// @brief DHCPv4 packets waiting to be sent, by socket descriptor.
+    std::map<uint16_t, SendBatch<Pkt4Ptr> > send_batches4_;
+
+    /// @brief DHCPv6 packets waiting to be sent, by socket descriptor.
+    std::map<uint16_t, SendBatch<Pkt6Ptr> > send_batches6_;
+
+    /// @brief Mutex to protect send batches against concurrent access.
+    std::mutex send_batches_mutex_;
+
+    /// @brief Signals the end of the sending of a batch.
+    std::condition_variable send_batches_cv_;
 };
 
 }  // namespace isc::dhcp
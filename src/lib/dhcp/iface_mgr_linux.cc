@@ -541,7 +541,7 @@ void Iface::setFlags(uint64_t flags) {
 void
 IfaceMgr::setMatchingPacketFilter(const bool direct_response_desired) {
     if (direct_response_desired) {
-        setPacketFilter(PktFilterPtr(new PktFilterLPF()));
+        setPacketFilter(PktFilterPtr(new PktFilterLPF(packet_mmap_)));
 
     } else {
         setPacketFilter(PktFilterPtr(new PktFilterInet()));
@@ -590,6 +590,7 @@ IfaceMgr::openMulticastSocket(Iface& iface,
             // has failed. We have to close the socket we previously
             // bound to link-local address - this is everything or
             // nothing strategy.
+            packet_filter6_->releaseSocket(sock);
             iface.delSocket(sock);
             IFACEMGR_ERROR(SocketConfigError, error_handler, IfacePtr(),
                            "Failed to open multicast socket on"
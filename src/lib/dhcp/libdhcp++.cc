@@ -217,7 +217,13 @@ LibDHCP::getRuntimeOptionDef(const string& space, const string& name) {
 
 OptionDefContainerPtr
 LibDHCP::getRuntimeOptionDefs(const string& space) {
-    return (runtime_option_defs_.getValue().getItems(space));
+    // This is called for each unpacked option buffer: do not allocate
+    // an empty container when there is no definition for the space.
+    OptionDefContainerPtr defs = runtime_option_defs_.getValue().findItems(space);
+    if (!defs) {
+        return (null_option_def_container_);
+    }
+    return (defs);
 }
 
 void
@@ -1023,7 +1029,8 @@ LibDHCP::unpackVendorOptions4(const uint32_t vendor_id, const OptionBuffer& buf,
 
 void
 LibDHCP::packOptions4(OutputBuffer& buf, const OptionCollection& options,
-                      bool top, bool check) {
+                      bool top, bool check,
+                      const vector<ConstPackedOptionCollectionPtr>* packed) {
     OptionCollection agent;
     OptionPtr end;
 
@@ -1050,6 +1057,13 @@ LibDHCP::packOptions4(OutputBuffer& buf, const OptionCollection& options,
                 end = option.second;
                 break;
             default:
+                if (packed) {
+                    const OptionBuffer* wire = findPackedOption(option.second, *packed);
+                    if (wire) {
+                        buf.writeData(&(*wire)[0], wire->size());
+                        break;
+                    }
+                }
                 option.second->pack(buf, check);
                 break;
         }
@@ -1066,6 +1080,24 @@ LibDHCP::packOptions4(OutputBuffer& buf, const OptionCollection& options,
     }
 }
 
+const OptionBuffer*
+LibDHCP::findPackedOption(const OptionPtr& option,
+                          const vector<ConstPackedOptionCollectionPtr>& packed) {
+    for (auto const& options : packed) {
+        for (auto const& packed_option : *options) {
+            if (packed_option.option_ == option) {
+                // Long options must be split (RFC3396).
+                if (packed_option.wire_.empty() ||
+                    (packed_option.wire_.size() > 255)) {
+                    return (0);
+                }
+                return (&packed_option.wire_);
+            }
+        }
+    }
+    return (0);
+}
+
 bool
 LibDHCP::splitOptions4(OptionCollection& options,
                        ScopedOptionsCopyContainer& scoped_options,
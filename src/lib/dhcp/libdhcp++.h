@@ -137,7 +137,8 @@ public:
     ///
     /// @param space Option space name.
     ///
-    /// @return Pointer to the container holding option definitions or NULL.
+    /// @return Pointer to the container holding option definitions. The
+    /// container is empty when there is no definition for the space.
     static OptionDefContainerPtr getRuntimeOptionDefs(const std::string& space);
 
     /// @brief Returns last resort option definition by space and option code.
@@ -220,9 +221,26 @@ public:
     /// @param check indicates if the code should be more flexible with
     /// PAD and END options. If true, PAD and END options will not be parsed.
     /// This is useful for partial parsing and slightly broken packets.
+    /// @param packed collections of options with their on-wire format:
+    /// an option of these collections is written from its on-wire format
+    /// instead of being packed. It defaults to none.
     static void packOptions4(isc::util::OutputBuffer& buf,
                              const isc::dhcp::OptionCollection& options,
-                             bool top = false, bool check = true);
+                             bool top = false, bool check = true,
+                             const std::vector<ConstPackedOptionCollectionPtr>*
+                             packed = 0);
+
+    /// @brief Returns the on-wire format of an option.
+    ///
+    /// @param option The option.
+    /// @param packed Collections of options with their on-wire format.
+    /// @return pointer to the on-wire format of the option or null when
+    /// the option must be packed, i.e. it is not in the collections, its
+    /// on-wire format is empty or it is too long so the option must be
+    /// split.
+    static const OptionBuffer*
+    findPackedOption(const OptionPtr& option,
+                     const std::vector<ConstPackedOptionCollectionPtr>& packed);
 
     /// @brief Split long options in multiple options with the same option code
     /// (RFC3396).
@@ -8,6 +8,7 @@
 #define OPTION_H
 
 #include <util/buffer.h>
+#include <util/packet_arena.h>
 
 #include <boost/shared_ptr.hpp>
 
@@ -42,6 +43,25 @@ typedef std::multimap<unsigned int, OptionPtr> OptionCollection;
 /// A pointer to an OptionCollection
 typedef boost::shared_ptr<OptionCollection> OptionCollectionPtr;
 
+/// @brief An option with its on-wire format.
+///
+/// Allows for sending an option which does not change, e.g. an option
+/// from the configuration, without packing it for each packet.
+struct PackedOption {
+    /// @brief The option.
+    OptionPtr option_;
+
+    /// @brief The on-wire format of the option (including the option
+    /// code and length), empty when the option must be packed normally.
+    OptionBuffer wire_;
+};
+
+/// A collection of packed options
+typedef std::vector<PackedOption> PackedOptionCollection;
+
+/// A pointer to a constant PackedOptionCollection
+typedef boost::shared_ptr<const PackedOptionCollection> ConstPackedOptionCollectionPtr;
+
 /// @brief Exception thrown during option unpacking
 /// This exception is thrown when an error has occurred, unpacking
 /// an option from a packet and we wish to abandon any any further
@@ -78,7 +98,7 @@ public:
         isc::Exception(file, line, what) { }
 };
 
-class Option {
+class Option : public util::PacketArenaObject {
 public:
     /// length of the usual DHCPv4 option header (there are exceptions)
     const static size_t OPTION4_HDR_LEN = 2;
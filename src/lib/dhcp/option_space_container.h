@@ -73,6 +73,24 @@ public:
         return (items->second);
     }
 
+    /// @brief Find the items for the particular option space.
+    ///
+    /// Unlike @ref getItems, no container is created when there are no
+    /// items for the specified option space.
+    ///
+    /// @param option_space name or vendor-id of the option space.
+    ///
+    /// @return pointer to the container holding items or null pointer
+    /// when there are no items for the option space.
+    ItemsContainerPtr findItems(const Selector& option_space) const {
+        const typename OptionSpaceMap::const_iterator& items =
+            option_space_map_.find(option_space);
+        if (items == option_space_map_.end()) {
+            return (ItemsContainerPtr());
+        }
+        return (items->second);
+    }
+
     /// @brief Get a list of existing option spaces.
     ///
     /// @return a list of option spaces.
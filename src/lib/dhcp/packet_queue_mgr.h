@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2024 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -46,7 +46,7 @@ public:
 
     /// @brief Constructor.
     PacketQueueMgr()
-        : factories_(), packet_queue_() {
+        : factories_(), packet_queue_(), parameters_() {
     }
 
     /// @brief Registers new queue factory function for a given queue type.
@@ -106,6 +106,7 @@ public:
         // a queue instance outliving its library.
         if ((packet_queue_) && (packet_queue_->getQueueType() == queue_type)) {
             packet_queue_.reset();
+            parameters_.reset();
         }
 
         // Remove the factory.
@@ -131,6 +132,28 @@ public:
     /// supported.
     /// @throw Unexpected if the backend factory function returned NULL.
     void createPacketQueue(data::ConstElementPtr parameters) {
+        auto new_queue = makePacketQueue(parameters);
+
+        // Replace the existing queue with the new one.
+        packet_queue_ = new_queue;
+        parameters_ = parameters;
+    }
+
+    /// @brief Create a new packet queue instance without installing it.
+    ///
+    /// Invokes the factory registered for the "queue-type" found in the
+    /// parameters and returns the created queue. Unlike
+    /// @c createPacketQueue the current queue is left untouched. This
+    /// is used when more than one queue of the same type is needed,
+    /// e.g. when each socket is served by its own receiver.
+    ///
+    /// @param parameters queue configuration parameters.
+    /// @return pointer to the new queue.
+    /// @throw InvalidQueueParameter if parameters is not map that contains
+    /// "queue-type", InvalidQueueType if the queue type requested is not
+    /// supported.
+    /// @throw Unexpected if the backend factory function returned NULL.
+    PacketQueueTypePtr makePacketQueue(data::ConstElementPtr parameters) const {
         if (!parameters) {
             isc_throw(Unexpected, "createPacketQueue - queue parameters is null");
         }
@@ -160,8 +183,7 @@ public:
                       " factory returned NULL");
         }
 
-        // Replace the existing queue with the new one.
-        packet_queue_ = new_queue;
+        return (new_queue);
     }
 
     /// @brief Returns underlying packet queue.
@@ -169,10 +191,19 @@ public:
         return (packet_queue_);
     }
 
+    /// @brief Returns the parameters the current packet queue was
+    /// created with.
+    ///
+    /// @return queue parameters or null if there is no current queue.
+    data::ConstElementPtr getPacketQueueParameters() const {
+        return (parameters_);
+    }
+
     /// @brief Destroys the current packet queue.
     /// Any queued packets will be discarded.
     void destroyPacketQueue() {
         packet_queue_.reset();
+        parameters_.reset();
     }
 
 protected:
@@ -181,6 +212,9 @@ protected:
 
     /// @brief the current queue_ ?
     PacketQueueTypePtr packet_queue_;
+
+    /// @brief Parameters used to create the current queue.
+    data::ConstElementPtr parameters_;
 };
 
 } // end of namespace isc::dhcp
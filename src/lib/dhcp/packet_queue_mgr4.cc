@@ -1,4 +1,4 @@
-// Copyright (C) 2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2024 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,7 @@ namespace isc {
 namespace dhcp {
 
 const std::string PacketQueueMgr4::DEFAULT_QUEUE_TYPE4 = "kea-ring4";
+const std::string PacketQueueMgr4::LOCKFREE_QUEUE_TYPE4 = "kea-lockfree-ring4";
 
 PacketQueueMgr4::PacketQueueMgr4() {
     // Register default queue factory
@@ -30,6 +31,21 @@ PacketQueueMgr4::PacketQueueMgr4() {
             PacketQueue4Ptr queue(new PacketQueueRing4(DEFAULT_QUEUE_TYPE4, capacity));
             return (queue);
         });
+
+    // Register lock-free queue factory
+    registerPacketQueueFactory(LOCKFREE_QUEUE_TYPE4, [](data::ConstElementPtr parameters)
+                                          -> PacketQueue4Ptr {
+            size_t capacity;
+            try {
+                capacity = data::SimpleParser::getInteger(parameters, "capacity");
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, LOCKFREE_QUEUE_TYPE4 << " factory:"
+                          " 'capacity' parameter is missing/invalid: " << ex.what());
+            }
+
+            PacketQueue4Ptr queue(new PacketQueueLockFreeRing4(LOCKFREE_QUEUE_TYPE4, capacity));
+            return (queue);
+        });
 }
 
 } // end of isc::dhcp namespace
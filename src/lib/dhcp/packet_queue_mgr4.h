@@ -25,7 +25,11 @@ public:
     /// @brief Logical name of the pre-registered, default queue implementation
     static const std::string DEFAULT_QUEUE_TYPE4;
 
-    /// It registers a default factory for DHCPv4 queues. 
+    /// @brief Logical name of the pre-registered lock-free queue implementation
+    static const std::string LOCKFREE_QUEUE_TYPE4;
+
+    /// It registers a default factory and a lock-free factory for DHCPv4
+    /// queues.
     PacketQueueMgr4();
 
     /// @brief virtual Destructor
@@ -1,4 +1,4 @@
-// Copyright (C) 2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2024 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,7 @@ namespace isc {
 namespace dhcp {
 
 const std::string PacketQueueMgr6::DEFAULT_QUEUE_TYPE6 = "kea-ring6";
+const std::string PacketQueueMgr6::LOCKFREE_QUEUE_TYPE6 = "kea-lockfree-ring6";
 
 PacketQueueMgr6::PacketQueueMgr6() {
     // Register default queue factory
@@ -30,6 +31,21 @@ PacketQueueMgr6::PacketQueueMgr6() {
             PacketQueue6Ptr queue(new PacketQueueRing6(DEFAULT_QUEUE_TYPE6, capacity));
             return (queue);
         });
+
+    // Register lock-free queue factory
+    registerPacketQueueFactory(LOCKFREE_QUEUE_TYPE6, [](data::ConstElementPtr parameters)
+                                          -> PacketQueue6Ptr {
+            size_t capacity;
+            try {
+                capacity = data::SimpleParser::getInteger(parameters, "capacity");
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, LOCKFREE_QUEUE_TYPE6 << " factory:"
+                          " 'capacity' parameter is missing/invalid: " << ex.what());
+            }
+
+            PacketQueue6Ptr queue(new PacketQueueLockFreeRing6(LOCKFREE_QUEUE_TYPE6, capacity));
+            return (queue);
+        });
 }
 
 } // end of isc::dhcp namespace
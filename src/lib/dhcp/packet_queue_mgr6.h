@@ -25,6 +25,9 @@ public:
     /// @brief Logical name of the pre-registered, default queue implementation
     static const std::string DEFAULT_QUEUE_TYPE6;
 
+    /// @brief Logical name of the pre-registered lock-free queue implementation
+    static const std::string LOCKFREE_QUEUE_TYPE6;
+
     /// @brief constructor.
     ///
     /// It registers a default factory for DHCPv6 queues.
@@ -8,6 +8,7 @@
 #define PACKET_QUEUE_RING_H
 
 #include <dhcp/packet_queue.h>
+#include <util/mpmc_ring.h>
 
 #include <boost/circular_buffer.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -257,6 +258,127 @@ public:
     virtual ~PacketQueueRing6(){}
 };
 
+/// @brief Provides a lock-free ring-buffer implementation of the PacketQueue
+/// interface.
+///
+/// Like @c PacketQueueRing, the oldest packets are dropped when the queue
+/// is full, but producers and consumers do not lock: the packets are kept
+/// in an @c isc::util::MpmcRing. The capacity is fixed when the queue is
+/// created.
+///
+/// @tparam PacketTypePtr Type of packet the queue contains.
+/// This expected to be either isc::dhcp::Pkt4Ptr or isc::dhcp::Pkt6Ptr
+template<typename PacketTypePtr>
+class PacketQueueLockFreeRing : public PacketQueue<PacketTypePtr> {
+public:
+    /// @brief Minimum queue capacity permitted.
+    static const size_t MIN_RING_CAPACITY = 5;
+
+    /// @brief Constructor
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    ///
+    /// @throw BadValue if capacity is too low.
+    PacketQueueLockFreeRing(const std::string& queue_type, size_t capacity)
+        : PacketQueue<PacketTypePtr>(queue_type) {
+        if (capacity < MIN_RING_CAPACITY) {
+            isc_throw(BadValue, "Queue capacity of " << capacity
+                      << " is invalid.  It must be at least "
+                      << MIN_RING_CAPACITY);
+        }
+        queue_.reset(new util::MpmcRing<PacketTypePtr>(capacity));
+    }
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueueLockFreeRing(){};
+
+    /// @brief Adds a packet to the queue
+    ///
+    /// The oldest packet is dropped when the queue is full.
+    ///
+    /// @param packet packet to enqueue
+    /// @param source socket the packet came from
+    virtual void enqueuePacket(PacketTypePtr packet, const SocketInfo& /* source */) {
+        if (packet) {
+            queue_->pushDropOldest(packet);
+        }
+    }
+
+    /// @brief Dequeues the next packet from the queue
+    ///
+    /// @return A pointer to dequeued packet, or an empty pointer
+    /// if the queue is empty.
+    virtual PacketTypePtr dequeuePacket() {
+        PacketTypePtr packet;
+        queue_->tryPop(packet);
+        return (packet);
+    }
+
+    /// @brief Returns True if the queue is empty.
+    virtual bool empty() const {
+        return (queue_->empty());
+    }
+
+    /// @brief Returns the maximum number of packets allowed in the buffer.
+    virtual size_t getCapacity() const {
+        return (queue_->capacity());
+    }
+
+    /// @brief Returns the current number of packets in the buffer.
+    virtual size_t getSize() const {
+        return (queue_->size());
+    }
+
+    /// @brief Discards all packets currently in the buffer.
+    virtual void clear()  {
+        queue_->clear();
+    }
+
+    /// @brief Fetches pertinent information
+    virtual data::ElementPtr getInfo() const {
+       data::ElementPtr info = PacketQueue<PacketTypePtr>::getInfo();
+       info->set("capacity", data::Element::create(static_cast<int64_t>(getCapacity())));
+       info->set("size", data::Element::create(static_cast<int64_t>(getSize())));
+       return (info);
+    }
+
+private:
+
+    /// @brief Packet queue
+    boost::scoped_ptr<util::MpmcRing<PacketTypePtr>> queue_;
+};
+
+/// @brief DHCPv4 lock-free packet queue buffer implementation
+class PacketQueueLockFreeRing4 : public PacketQueueLockFreeRing<Pkt4Ptr> {
+public:
+    /// @brief Constructor
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    PacketQueueLockFreeRing4(const std::string& queue_type, size_t capacity)
+        : PacketQueueLockFreeRing(queue_type, capacity) {
+    };
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueueLockFreeRing4(){}
+};
+
+/// @brief DHCPv6 lock-free packet queue buffer implementation
+class PacketQueueLockFreeRing6 : public PacketQueueLockFreeRing<Pkt6Ptr> {
+public:
+    /// @brief Constructor
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    PacketQueueLockFreeRing6(const std::string& queue_type, size_t capacity)
+        : PacketQueueLockFreeRing(queue_type, capacity) {
+    };
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueueLockFreeRing6(){}
+};
+
 }  // namespace isc::dhcp
 }  // namespace isc
 
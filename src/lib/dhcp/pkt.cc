@@ -26,7 +26,8 @@ Pkt::Pkt(uint32_t transid, const isc::asiolink::IOAddress& local_addr,
          uint16_t remote_port)
     : transid_(transid), iface_(""), ifindex_(UNSET_IFINDEX), local_addr_(local_addr),
       remote_addr_(remote_addr), local_port_(local_port),
-      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false) {
+      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false),
+      lazy_options_(false) {
 }
 
 Pkt::Pkt(const uint8_t* buf, uint32_t len, const isc::asiolink::IOAddress& local_addr,
@@ -34,7 +35,8 @@ Pkt::Pkt(const uint8_t* buf, uint32_t len, const isc::asiolink::IOAddress& local
          uint16_t remote_port)
     : transid_(0), iface_(""), ifindex_(UNSET_IFINDEX), local_addr_(local_addr),
       remote_addr_(remote_addr), local_port_(local_port),
-      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false) {
+      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false),
+      lazy_options_(false) {
     if (len != 0) {
         if (buf == NULL) {
             isc_throw(InvalidParameter, "data buffer passed to Pkt is NULL");
@@ -44,8 +46,14 @@ Pkt::Pkt(const uint8_t* buf, uint32_t len, const isc::asiolink::IOAddress& local
     }
 }
 
+void
+Pkt::lazyUnpack(int) {
+    lazy_options_ = false;
+}
+
 OptionCollection
 Pkt::cloneOptions() {
+    checkLazyOptions(-1);
     OptionCollection options;
     for (auto const& option : options_) {
         options.emplace(std::make_pair(option.second->getType(), option.second->clone()));
@@ -55,11 +63,13 @@ Pkt::cloneOptions() {
 
 void
 Pkt::addOption(const OptionPtr& opt) {
+    checkLazyOptions(opt->getType());
     options_.insert(std::pair<int, OptionPtr>(opt->getType(), opt));
 }
 
 OptionPtr
 Pkt::getNonCopiedOption(const uint16_t type) const {
+    checkLazyOptions(type);
     auto const& x = options_.find(type);
     if (x != options_.end()) {
         return (x->second);
@@ -69,6 +79,7 @@ Pkt::getNonCopiedOption(const uint16_t type) const {
 
 OptionPtr
 Pkt::getOption(const uint16_t type) {
+    checkLazyOptions(type);
     auto const& x = options_.find(type);
     if (x != options_.end()) {
         if (copy_retrieved_options_) {
@@ -82,6 +93,7 @@ Pkt::getOption(const uint16_t type) {
 
 OptionCollection
 Pkt::getNonCopiedOptions(const uint16_t opt_type) const {
+    checkLazyOptions(opt_type);
     std::pair<OptionCollection::const_iterator,
               OptionCollection::const_iterator> range = options_.equal_range(opt_type);
     return (OptionCollection(range.first, range.second));
@@ -89,6 +101,7 @@ Pkt::getNonCopiedOptions(const uint16_t opt_type) const {
 
 OptionCollection
 Pkt::getOptions(const uint16_t opt_type) {
+    checkLazyOptions(opt_type);
     OptionCollection options_copy;
 
     std::pair<OptionCollection::iterator,
@@ -108,6 +121,7 @@ Pkt::getOptions(const uint16_t opt_type) {
 
 bool
 Pkt::delOption(uint16_t type) {
+    checkLazyOptions(type);
     auto const& x = options_.find(type);
     if (x != options_.end()) {
         options_.erase(x);
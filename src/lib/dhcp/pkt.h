@@ -9,6 +9,7 @@
 
 #include <asiolink/io_address.h>
 #include <util/buffer.h>
+#include <util/packet_arena.h>
 #include <dhcp/option.h>
 #include <dhcp/hwaddr.h>
 #include <dhcp/classify.h>
@@ -158,7 +159,8 @@ public:
 ///
 /// @note This is abstract class. Please instantiate derived classes
 /// such as @c Pkt4 or @c Pkt6.
-class Pkt : public hooks::CalloutHandleAssociate {
+class Pkt : public hooks::CalloutHandleAssociate,
+            public util::PacketArenaObject {
 protected:
 
     /// @brief Constructor.
@@ -444,6 +446,16 @@ protected:
 
 public:
 
+    /// @brief Unpacks the received options which are not unpacked yet.
+    ///
+    /// A packet may unpack its options lazily, i.e. on the first access
+    /// (see @ref Pkt4::setLazyUnpack).  The methods of this class take care
+    /// of it, but this method must be called before accessing the
+    /// @c options_ member directly.
+    void unpackLazyOptions() {
+        checkLazyOptions(-1);
+    }
+
     /// @brief Clones all options so that they can be safely modified.
     ///
     /// @return A container with option clones.
@@ -967,6 +979,32 @@ protected:
     /// @see the documentation for @ref Pkt::setCopyRetrievedOptions.
     bool copy_retrieved_options_;
 
+    /// @brief Indicates if some received options are not unpacked yet.
+    ///
+    /// Set by the derived classes which unpack options lazily.
+    bool lazy_options_;
+
+    /// @brief Unpacks the received options which are not unpacked yet.
+    ///
+    /// Called before an access to the options when @c lazy_options_ is
+    /// true.  The derived classes which unpack options lazily implement
+    /// it; the default implementation does nothing.
+    ///
+    /// @param type Code of the options to unpack or -1 for all options.
+    virtual void lazyUnpack(int type);
+
+    /// @brief Unpacks the options of a type if they are not unpacked yet.
+    ///
+    /// The options of the packet do not change (they are only made
+    /// available), so this can be called from const methods.
+    ///
+    /// @param type Code of the options to unpack or -1 for all options.
+    void checkLazyOptions(int type) const {
+        if (lazy_options_) {
+            const_cast<Pkt*>(this)->lazyUnpack(type);
+        }
+    }
+
     /// packet timestamp
     boost::posix_time::ptime timestamp_;
 
@@ -1062,7 +1100,9 @@ public:
     /// Creates a copy of the initial options on a packet.
     ///
     /// @param pkt Pointer to the packet.
-    ScopedPktOptionsCopy(PktType& pkt) : pkt_(pkt), options_(pkt.options_) {
+    ScopedPktOptionsCopy(PktType& pkt) : pkt_(pkt), options_() {
+        pkt_.unpackLazyOptions();
+        options_ = pkt_.options_;
         pkt_.options_ = pkt_.cloneOptions();
     }
 
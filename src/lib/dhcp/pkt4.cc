@@ -8,6 +8,8 @@
 #include <asiolink/io_address.h>
 #include <dhcp/dhcp4.h>
 #include <dhcp/libdhcp++.h>
+#include <dhcp/option_data_types.h>
+#include <dhcp/option_definition.h>
 #include <dhcp/option_int.h>
 #include <dhcp/pkt4.h>
 #include <exceptions/exceptions.h>
@@ -24,6 +26,128 @@ namespace {
 
 /// @brief Default address used in Pkt4 constructor
 const IOAddress DEFAULT_ADDRESS("0.0.0.0");
+
+/// @brief Sets the options with a known on-wire format aside.
+///
+/// These options are neither copied nor split when the packet is packed,
+/// so they are removed from the packet options for the scope of the object.
+class ScopedPackedOptionsSetAside {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param options The packet options.
+    /// @param packed Collections of options with their on-wire format.
+    ScopedPackedOptionsSetAside(OptionCollection& options,
+                                const vector<ConstPackedOptionCollectionPtr>& packed)
+        : options_(options), packed_() {
+        if (packed.empty()) {
+            return;
+        }
+        for (auto it = options_.begin(); it != options_.end(); ) {
+            if (LibDHCP::findPackedOption(it->second, packed)) {
+                packed_.insert(*it);
+                it = options_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Puts the options back.
+    ~ScopedPackedOptionsSetAside() {
+        restore(options_);
+    }
+
+    /// @brief Adds the options set aside to a collection.
+    ///
+    /// The options are added before the options with the same code, as
+    /// they were added to the packet first.
+    ///
+    /// @param options The collection.
+    void restore(OptionCollection& options) const {
+        for (auto const& option : packed_) {
+            options.insert(options.lower_bound(option.first), option);
+        }
+    }
+
+private:
+
+    /// @brief The packet options.
+    OptionCollection& options_;
+
+    /// @brief The options set aside.
+    OptionCollection packed_;
+};
+
+/// @brief Checks if received options can be unpacked on demand.
+///
+/// The options of a code can be unpacked lazily when their unpacking by
+/// @c LibDHCP::unpackOptions4 can't fail: the options without definition
+/// and the binary, string, empty and integer options which data has a
+/// valid size. The vendor options are never unpacked lazily because they
+/// are extended after the unpacking.
+///
+/// @param idx Index by code of the standard option definitions.
+/// @param runtime_idx Index by code of the runtime option definitions.
+/// @param type Option code.
+/// @param len Length of the fused data of the options.
+///
+/// @return true if the options can be unpacked on demand.
+bool
+canUnpackLazily(const OptionDefContainerTypeIndex& idx,
+                const OptionDefContainerTypeIndex& runtime_idx,
+                const uint8_t type, const size_t len) {
+    if ((type == DHO_VIVCO_SUBOPTIONS) || (type == DHO_VIVSO_SUBOPTIONS)) {
+        return (false);
+    }
+
+    // Look for the definition as LibDHCP::unpackOptions4 does.
+    OptionDefContainerTypeRange range = idx.equal_range(type);
+    size_t num_defs = std::distance(range.first, range.second);
+    if (num_defs == 0) {
+        range = runtime_idx.equal_range(type);
+        num_defs = std::distance(range.first, range.second);
+    }
+    if (num_defs == 0) {
+        // Generic option.
+        return (true);
+    }
+    if (num_defs > 1) {
+        return (false);
+    }
+
+    // The options with a special format have other types.
+    const OptionDefinitionPtr& def = *(range.first);
+    const OptionDataType data_type = def->getType();
+    switch (data_type) {
+    case OPT_BINARY_TYPE:
+    case OPT_STRING_TYPE:
+        return (true);
+
+    case OPT_EMPTY_TYPE:
+        return (def->getEncapsulatedSpace().empty());
+
+    case OPT_UINT8_TYPE:
+    case OPT_INT8_TYPE:
+    case OPT_UINT16_TYPE:
+    case OPT_INT16_TYPE:
+    case OPT_UINT32_TYPE:
+    case OPT_INT32_TYPE: {
+        const size_t data_len = OptionDataTypeUtil::getDataTypeLen(data_type);
+        if (def->getArrayType()) {
+            return ((len != 0) && (len % data_len == 0));
+        }
+        return ((len == data_len) && def->getEncapsulatedSpace().empty());
+    }
+
+    default:
+        return (false);
+    }
+}
+
 }
 
 namespace isc {
@@ -33,7 +157,7 @@ Pkt4::Pkt4(uint8_t msg_type, uint32_t transid)
     : Pkt(transid, DEFAULT_ADDRESS, DEFAULT_ADDRESS, DHCP4_SERVER_PORT, DHCP4_CLIENT_PORT),
       op_(DHCPTypeToBootpType(msg_type)), hwaddr_(new HWAddr()), hops_(0), secs_(0), flags_(0),
       ciaddr_(DEFAULT_ADDRESS), yiaddr_(DEFAULT_ADDRESS), siaddr_(DEFAULT_ADDRESS),
-      giaddr_(DEFAULT_ADDRESS) {
+      giaddr_(DEFAULT_ADDRESS), lazy_unpack_(false) {
     memset(sname_, 0, MAX_SNAME_LEN);
     memset(file_, 0, MAX_FILE_LEN);
 
@@ -44,7 +168,7 @@ Pkt4::Pkt4(const uint8_t* data, size_t len)
     : Pkt(data, len, DEFAULT_ADDRESS, DEFAULT_ADDRESS, DHCP4_SERVER_PORT, DHCP4_CLIENT_PORT),
       op_(BOOTREQUEST), hwaddr_(new HWAddr()), hops_(0), secs_(0), flags_(0),
       ciaddr_(DEFAULT_ADDRESS), yiaddr_(DEFAULT_ADDRESS), siaddr_(DEFAULT_ADDRESS),
-      giaddr_(DEFAULT_ADDRESS) {
+      giaddr_(DEFAULT_ADDRESS), lazy_unpack_(false) {
 
     if (len < DHCPV4_PKT_HDR_LEN) {
         isc_throw(OutOfRange, "Truncated DHCPv4 packet (len=" << len
@@ -59,6 +183,8 @@ size_t
 Pkt4::len() {
     size_t length = DHCPV4_PKT_HDR_LEN; // DHCPv4 header
 
+    unpackLazyOptions();
+
     // ... and sum of lengths of all options
     for (auto const& it : options_) {
         length += it.second->len();
@@ -73,6 +199,10 @@ Pkt4::pack() {
         isc_throw(InvalidOperation, "Can't build Pkt4 packet. HWAddr not set.");
     }
 
+    // The options with a known on-wire format are written from it: they
+    // are set aside so they are not copied nor split.
+    ScopedPackedOptionsSetAside packed_options(options_, packed_options_);
+
     // This object is necessary to restore the packet options after performing
     // splitOptions4 when function scope ends. It creates a container of option
     // clones which are split and packed.
@@ -133,10 +263,12 @@ Pkt4::pack() {
         // @ref OptionDefinition::optionFactory. At this stage the server should
         // not do anything useful with the options beside packing.
         LibDHCP::splitOptions4(options_, m_scoped_options.scoped_options_);
+        packed_options.restore(options_);
 
         // Call packOptions4() with parameter,"top", true. This invokes
         // logic to emit the message type option first.
-        LibDHCP::packOptions4(buffer_out_, options_, true);
+        LibDHCP::packOptions4(buffer_out_, options_, true, true,
+                              packed_options_.empty() ? 0 : &packed_options_);
 
         // add END option that indicates end of options
         // (End option is very simple, just a 255 octet)
@@ -196,6 +328,12 @@ Pkt4::unpack() {
         isc_throw(Unexpected, "Invalid or missing DHCP magic cookie");
     }
 
+    if (lazy_unpack_) {
+        // Only record where the options are: they are unpacked on demand.
+        indexOptions(buffer_in.getPosition());
+        return;
+    }
+
     size_t opts_len = buffer_in.getLength() - buffer_in.getPosition();
     vector<uint8_t> opts_buffer;
 
@@ -231,7 +369,230 @@ Pkt4::unpack() {
     // so we'll be able to log more detailed drop reason.
 }
 
+void
+Pkt4::indexOptions(size_t offset) {
+    lazy_option_list_.clear();
+    lazy_types_.reset();
+    const size_t size = data_.size();
+    while (offset < size) {
+        uint8_t opt_type = data_[offset++];
+        if (opt_type == DHO_END) {
+            break;
+        }
+        if (opt_type == DHO_PAD) {
+            continue;
+        }
+        if (offset + 1 > size) {
+            // Truncated option.
+            break;
+        }
+        uint8_t opt_len = data_[offset++];
+        if (offset + opt_len > size) {
+            // Truncated option.
+            break;
+        }
+        if ((opt_len == 0) && (opt_type == DHO_HOST_NAME)) {
+            // Dropped by LibDHCP::unpackOptions4 too.
+            continue;
+        }
+        LazyOption lazy = { opt_type, opt_len, offset };
+        lazy_option_list_.push_back(lazy);
+        offset += opt_len;
+        lazy_types_.set(opt_type);
+    }
+    lazy_options_ = lazy_types_.any();
+
+    // Find the options which unpacking may fail: they are unpacked now
+    // so the errors are reported here.
+    const OptionDefContainerPtr& option_defs =
+        LibDHCP::getOptionDefs(DHCP4_OPTION_SPACE);
+    const OptionDefContainerPtr& runtime_option_defs =
+        LibDHCP::getRuntimeOptionDefs(DHCP4_OPTION_SPACE);
+    std::bitset<256> eager;
+    std::bitset<256> deferred;
+    std::bitset<256> checked;
+    for (auto const& option : lazy_option_list_) {
+        const uint8_t type = option.type_;
+        if (checked[type]) {
+            continue;
+        }
+        checked.set(type);
+        // The server looks at the deferred options after the
+        // classification so they must be known now.
+        if (LibDHCP::shouldDeferOptionUnpack(DHCP4_OPTION_SPACE, type)) {
+            deferred.set(type);
+            continue;
+        }
+        size_t len = 0;
+        for (auto const& lazy : lazy_option_list_) {
+            if (lazy.type_ == type) {
+                len += lazy.len_;
+            }
+        }
+        if (!canUnpackLazily(option_defs->get<1>(),
+                             runtime_option_defs->get<1>(), type, len)) {
+            eager.set(type);
+        }
+    }
+
+    if (eager.any()) {
+        try {
+            unpackLazyTypes(eager);
+        } catch (...) {
+            // Unpack again the options in the packet order to fail at
+            // the same point as LibDHCP::unpackOptions4 on all options.
+            for (unsigned code = 0; code < eager.size(); ++code) {
+                if (eager[code]) {
+                    options_.erase(code);
+                }
+            }
+            lazy_types_ |= eager;
+            unpackInOrder(eager | deferred);
+            throw;
+        }
+    }
+    if (deferred.any()) {
+        unpackInOrder(deferred);
+    }
+
+    // The vendor options are never unpacked lazily.
+    LibDHCP::extendVendorOptions4(options_);
+}
+
+void
+Pkt4::unpackInOrder(const std::bitset<256>& types) {
+    // The options of a code are fused and unpacked at their last
+    // occurrence so walk the last occurrences in the packet order.
+    std::bitset<256> seen;
+    vector<size_t> lasts;
+    for (size_t i = lazy_option_list_.size(); i > 0; --i) {
+        const uint8_t type = lazy_option_list_[i - 1].type_;
+        if (types[type] && !seen[type]) {
+            seen.set(type);
+            lasts.push_back(i - 1);
+        }
+    }
+    for (auto last = lasts.rbegin(); last != lasts.rend(); ++last) {
+        const uint8_t type = lazy_option_list_[*last].type_;
+        if (LibDHCP::shouldDeferOptionUnpack(DHCP4_OPTION_SPACE, type)) {
+            if (find(deferred_options_.begin(), deferred_options_.end(),
+                     type) == deferred_options_.end()) {
+                deferred_options_.push_back(type);
+            }
+            continue;
+        }
+        try {
+            std::bitset<256> single;
+            single.set(type);
+            unpackLazyTypes(single);
+        } catch (...) {
+            // As with LibDHCP::unpackOptions4, the options after the
+            // failed one are not unpacked.
+            for (size_t i = *last + 1; i < lazy_option_list_.size(); ++i) {
+                lazy_types_.reset(lazy_option_list_[i].type_);
+            }
+            lazy_options_ = lazy_types_.any();
+            throw;
+        }
+    }
+}
+
+void
+Pkt4::lazyUnpack(int type) {
+    if (type < 0) {
+        unpackLazyTypes(lazy_types_);
+    } else if ((type < static_cast<int>(lazy_types_.size())) &&
+               lazy_types_[type]) {
+        unpackLazyOption(type);
+    }
+}
+
+void
+Pkt4::unpackLazyTypes(const std::bitset<256> types) {
+    // Clear first: options which fail to unpack are not present.
+    lazy_types_ &= ~types;
+    lazy_options_ = lazy_types_.any();
+
+    // Build the buffer of the options of these codes and unpack it as
+    // unpack() does.
+    OptionBuffer buf;
+    for (auto const& lazy : lazy_option_list_) {
+        if (types[lazy.type_]) {
+            buf.push_back(lazy.type_);
+            buf.push_back(lazy.len_);
+            buf.insert(buf.end(), data_.begin() + lazy.offset_,
+                       data_.begin() + lazy.offset_ + lazy.len_);
+        }
+    }
+    static_cast<void>(LibDHCP::unpackOptions4(buf, DHCP4_OPTION_SPACE, options_,
+                                              deferred_options_, false));
+}
+
+void
+Pkt4::unpackLazyOption(const uint8_t type) {
+    lazy_types_.reset(type);
+    lazy_options_ = lazy_types_.any();
+
+    // Fuse the data of the options of this code.
+    OptionBuffer buf;
+    for (auto const& lazy : lazy_option_list_) {
+        if (lazy.type_ == type) {
+            buf.insert(buf.end(), data_.begin() + lazy.offset_,
+                       data_.begin() + lazy.offset_ + lazy.len_);
+        }
+    }
+
+    // Create the option as LibDHCP::unpackOptions4 does: the options
+    // left for the first access have at most one definition and only
+    // fail to unpack with SkipThisOptionError.
+    OptionDefinitionPtr def;
+    if (!LibDHCP::shouldDeferOptionUnpack(DHCP4_OPTION_SPACE, type)) {
+        def = LibDHCP::getOptionDef(DHCP4_OPTION_SPACE, type);
+        if (!def) {
+            def = LibDHCP::getRuntimeOptionDef(DHCP4_OPTION_SPACE, type);
+        }
+    }
+    OptionPtr opt;
+    if (!def) {
+        opt.reset(new Option(Option::V4, type, buf));
+    } else {
+        try {
+            opt = def->optionFactory(Option::V4, type, buf);
+        } catch (const SkipThisOptionError&) {
+            // The option is not present.
+        }
+    }
+    if (opt) {
+        options_.insert(make_pair(type, opt));
+    }
+}
+
+bool
+Pkt4::getOptionData(const uint8_t type, isc::util::InputBuffer& data) const {
+    if (!lazy_types_[type]) {
+        return (false);
+    }
+    const LazyOption* found = 0;
+    for (auto const& lazy : lazy_option_list_) {
+        if (lazy.type_ == type) {
+            if (found) {
+                // Multiple instances are fused when unpacked.
+                return (false);
+            }
+            found = &lazy;
+        }
+    }
+    data = isc::util::InputBuffer(&data_[0] + found->offset_, found->len_);
+    return (true);
+}
+
 uint8_t Pkt4::getType() const {
+    // Read the type from the received data if it is not unpacked yet.
+    uint8_t type;
+    if (getOptionValue(DHO_DHCP_MESSAGE_TYPE, type)) {
+        return (type);
+    }
+
     OptionPtr generic = getNonCopiedOption(DHO_DHCP_MESSAGE_TYPE);
     if (!generic) {
         return (DHCP_NOTYPE);
@@ -437,6 +798,7 @@ Pkt4::toText() const {
 
     tmp << ", trans_id=0x" << hex << transid_ << dec;
 
+    checkLazyOptions(-1);
     if (!options_.empty()) {
         tmp << "," << endl << "options:";
         for (auto const& opt : options_) {
@@ -596,6 +958,21 @@ Pkt4::addOption(const OptionPtr& opt) {
     Pkt::addOption(opt);
 }
 
+size_t
+Pkt4::addPackedOptions(const ConstPackedOptionCollectionPtr& options) {
+    size_t added = 0;
+    for (auto const& packed : *options) {
+        if (!getNonCopiedOption(packed.option_->getType())) {
+            Pkt::addOption(packed.option_);
+            ++added;
+        }
+    }
+    if (added > 0) {
+        packed_options_.push_back(options);
+    }
+    return (added);
+}
+
 bool
 Pkt4::isRelayed() const {
     return (!giaddr_.isV4Zero() && !giaddr_.isV4Bcast());
@@ -16,6 +16,7 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <bitset>
 #include <iostream>
 #include <vector>
 #include <set>
@@ -342,6 +343,19 @@ public:
     virtual void
     addOption(const OptionPtr& opt);
 
+    /// @brief Add options with their on-wire format.
+    ///
+    /// Each option of the collection is added unless an option with the
+    /// same code is already present. The added options are written by
+    /// @ref pack from their on-wire format as long as they are in the
+    /// packet: an option which is replaced, e.g. by a copy returned by
+    /// @ref getOption when the retrieved options are copied, is packed
+    /// normally. The options must not be modified.
+    ///
+    /// @param options options with their on-wire format.
+    /// @return the number of added options.
+    size_t addPackedOptions(const ConstPackedOptionCollectionPtr& options);
+
     /// @brief Sets local HW address.
     ///
     /// Sets the source HW address for the outgoing packet or
@@ -406,6 +420,80 @@ public:
         return (false);
     }
 
+    /// @brief Enables or disables the lazy unpacking of the options.
+    ///
+    /// When enabled, @ref unpack records where the options are in the
+    /// received data and unpacks only the options which unpacking may
+    /// fail: the other options are unpacked on the first access to them
+    /// (e.g. by @ref getOption) and @ref getOptionData gives access to the
+    /// raw data of the options which are not unpacked yet. The server reads
+    /// only a few options of most received packets, so this avoids creating
+    /// the other ones.
+    ///
+    /// The errors in the options are reported by @ref unpack as when the
+    /// options are unpacked eagerly, so the malformed packets are dropped
+    /// at the same point. The received data (@c data_) must not be modified
+    /// while some options are not unpacked.
+    ///
+    /// @param lazy Indicates if the options should be unpacked lazily.
+    void setLazyUnpack(const bool lazy) {
+        lazy_unpack_ = lazy;
+    }
+
+    /// @brief Returns whether the options are unpacked lazily.
+    ///
+    /// @return true if the options are unpacked lazily.
+    bool isLazyUnpack() const {
+        return (lazy_unpack_);
+    }
+
+    /// @brief Returns the raw data of a received option.
+    ///
+    /// Gives access to the data of an option which is not unpacked yet,
+    /// without creating the option nor copying its data: the buffer reads
+    /// the received data, e.g. with readUint8() or readUint32().
+    ///
+    /// @param type Option code.
+    /// @param [out] data Buffer set to the option data.
+    ///
+    /// @return true if the option is present once and is not unpacked yet,
+    /// false otherwise (the option must be retrieved with @ref getOption).
+    bool getOptionData(const uint8_t type, isc::util::InputBuffer& data) const;
+
+    /// @brief Returns the integer value of a received option.
+    ///
+    /// Typed view of @ref getOptionData for the options which carry one
+    /// integer in network byte order, e.g. the message type or the maximum
+    /// message size.
+    ///
+    /// @tparam T Integer type: uint8_t, uint16_t or uint32_t.
+    /// @param type Option code.
+    /// @param [out] value Option value.
+    ///
+    /// @return true if the option is present once, is not unpacked yet and
+    /// its data has the size of the integer, false otherwise.
+    template<typename T>
+    bool getOptionValue(const uint8_t type, T& value) const {
+        isc::util::InputBuffer data(0, 0);
+        if (!getOptionData(type, data) || (data.getLength() != sizeof(T))) {
+            return (false);
+        }
+        switch (sizeof(T)) {
+        case 1:
+            value = static_cast<T>(data.readUint8());
+            break;
+        case 2:
+            value = static_cast<T>(data.readUint16());
+            break;
+        case 4:
+            value = static_cast<T>(data.readUint32());
+            break;
+        default:
+            return (false);
+        }
+        return (true);
+    }
+
 private:
 
     /// @brief Generic method that validates and sets HW address.
@@ -433,6 +521,57 @@ protected:
     uint8_t
     DHCPTypeToBootpType(uint8_t dhcpType);
 
+    /// @brief Unpacks the received options which are not unpacked yet.
+    ///
+    /// The options of a code are unpacked together (like in
+    /// @c LibDHCP::unpackOptions4, multiple instances are fused).
+    ///
+    /// @param type Code of the options to unpack or -1 for all options.
+    virtual void lazyUnpack(int type);
+
+    /// @brief Unpacks the received options of some codes.
+    ///
+    /// The options are unpacked together by @c LibDHCP::unpackOptions4.
+    ///
+    /// @param types Codes of the options to unpack (a copy, as it may be
+    /// @c lazy_types_).
+    void unpackLazyTypes(const std::bitset<256> types);
+
+    /// @brief Unpacks the received options of a code on demand.
+    ///
+    /// The options of a code are fused and the option is created from
+    /// its definition as @c LibDHCP::unpackOptions4 does, without the
+    /// cost of a full call for one option.
+    ///
+    /// @param type Option code.
+    void unpackLazyOption(const uint8_t type);
+
+    /// @brief Unpacks received options in the packet order.
+    ///
+    /// Used by @ref indexOptions to unpack the options as
+    /// @c LibDHCP::unpackOptions4 does: the options of a code are unpacked
+    /// at their last occurrence and the codes of the deferred options are
+    /// added to @c deferred_options_.  When an option fails to unpack,
+    /// the options after it are no longer present.
+    ///
+    /// @param types Codes of the options to unpack.
+    void unpackInOrder(const std::bitset<256>& types);
+
+    /// @brief Records where the options are in the received data.
+    ///
+    /// Used by @ref unpack in lazy mode.  Like @c LibDHCP::unpackOptions4,
+    /// it stops at the end option or a truncated option, and the options
+    /// of a code are handled at their last occurrence: the options which
+    /// unpacking may fail are unpacked then and the others are left for
+    /// the first access.  The codes of the options which unpacking is
+    /// deferred are added to @c deferred_options_.
+    ///
+    /// @param offset Offset of the options in the received data.
+    ///
+    /// @throw The exceptions of @c LibDHCP::unpackOptions4 and of
+    /// @c LibDHCP::extendVendorOptions4.
+    void indexOptions(size_t offset);
+
     /// @brief No-op
     ///
     /// This method returns hardware address generated from the IPv6 link-local
@@ -549,6 +688,30 @@ protected:
     uint8_t file_[MAX_FILE_LEN];
 
     // end of real DHCPv4 fields
+
+    /// @brief Location of a received option in the received data.
+    struct LazyOption {
+        /// @brief Option code.
+        uint8_t type_;
+
+        /// @brief Option data length.
+        uint8_t len_;
+
+        /// @brief Offset of the option data in @c data_.
+        size_t offset_;
+    };
+
+    /// @brief Indicates if the options are unpacked lazily.
+    bool lazy_unpack_;
+
+    /// @brief Received options in lazy mode, in the packet order.
+    std::vector<LazyOption> lazy_option_list_;
+
+    /// @brief Codes of the received options which are not unpacked yet.
+    std::bitset<256> lazy_types_;
+
+    /// @brief Options added with their on-wire format.
+    std::vector<ConstPackedOptionCollectionPtr> packed_options_;
 }; // Pkt4 class
 
 /// @brief A pointer to Pkt4 object.
@@ -8,9 +8,12 @@
 #include <dhcp/iface_mgr.h>
 #include <dhcp/pkt_filter.h>
 
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <fcntl.h>
 
+#include <cstring>
+
 namespace isc {
 namespace dhcp {
 
@@ -67,5 +70,48 @@ PktFilter::openFallbackSocket(const isc::asiolink::IOAddress& addr,
     return (sock);
 }
 
+bool
+PktFilter::isReadable(const SocketInfo& socket_info) {
+    int len;
+    if (ioctl(socket_info.sockfd_, FIONREAD, &len) < 0) {
+        isc_throw(SocketReadError, strerror(errno));
+    }
+    return (len > 0);
+}
+
+size_t
+PktFilter::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                        size_t max_count, std::vector<Pkt4Ptr>& pkts) {
+    if (max_count == 0) {
+        return (0);
+    }
+    Pkt4Ptr pkt = receive(iface, socket_info);
+    if (!pkt) {
+        return (0);
+    }
+    pkts.push_back(pkt);
+    return (1);
+}
+
+size_t
+PktFilter::sendBatch(const Iface& iface, uint16_t sockfd,
+                     const std::vector<Pkt4Ptr>& pkts,
+                     std::vector<std::string>& errors) {
+    errors.assign(pkts.size(), std::string());
+    size_t sent = 0;
+    for (size_t i = 0; i < pkts.size(); ++i) {
+        try {
+            if (send(iface, sockfd, pkts[i]) == 0) {
+                ++sent;
+            } else {
+                errors[i] = "pkt4 send failed";
+            }
+        } catch (const std::exception& ex) {
+            errors[i] = ex.what();
+        }
+    }
+    return (sent);
+}
+
 } // end of isc::dhcp namespace
 } // end of isc namespace
@@ -11,6 +11,9 @@
 #include <asiolink/io_address.h>
 #include <boost/shared_ptr.hpp>
 
+#include <string>
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -103,6 +106,20 @@ public:
     virtual Pkt4Ptr receive(Iface& iface,
                             const SocketInfo& socket_info) = 0;
 
+    /// @brief Checks if a packet can be received over specified socket.
+    ///
+    /// The receiver threads call this function when select() reports the
+    /// socket readable, before receiving packets. The default implementation
+    /// checks that data is queued on the socket with the FIONREAD ioctl.
+    /// Derived classes which do not read packets from the socket queue
+    /// should override it.
+    ///
+    /// @param socket_info structure holding socket information
+    ///
+    /// @return true if a packet can be received.
+    /// @throw isc::dhcp::SocketReadError if the check failed.
+    virtual bool isReadable(const SocketInfo& socket_info);
+
     /// @brief Send packet over specified socket.
     ///
     /// @param iface interface to be used to send packet
@@ -113,6 +130,55 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt) = 0;
 
+    /// @brief Receive up to a given number of packets over specified socket.
+    ///
+    /// This function is called when the socket is known to be readable.
+    /// It must not block waiting for more packets than are already
+    /// available. The default implementation receives a single packet
+    /// using @c receive. Derived classes which can read several datagrams
+    /// with one system call should override it.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param max_count maximum number of packets to receive.
+    /// @param [out] pkts vector the received packets are appended to.
+    ///
+    /// @return number of packets appended to @c pkts.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                size_t max_count, std::vector<Pkt4Ptr>& pkts);
+
+    /// @brief Send several packets over specified socket.
+    ///
+    /// The result of each packet is reported: a packet which can't be
+    /// sent does not prevent the next ones from being sent. The
+    /// @c RESPONSE_SENT event is added to the sent packets only. The
+    /// default implementation calls @c send for each packet. Derived
+    /// classes which can send several datagrams with one system call
+    /// should override it.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    /// @param [out] errors error message of each packet, empty for the
+    /// sent packets.
+    ///
+    /// @return number of sent packets.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts,
+                             std::vector<std::string>& errors);
+
+    /// @brief Releases the resources associated with a socket.
+    ///
+    /// @c IfaceMgr calls this function before closing a socket opened by
+    /// this filter, so the derived classes keeping a state per socket
+    /// descriptor can drop it before the descriptor is reused. The
+    /// default implementation does nothing.
+    ///
+    /// @param sockfd socket descriptor
+    virtual void releaseSocket(int sockfd) {
+        static_cast<void>(sockfd);
+    }
+
 protected:
 
     /// @brief Default implementation to open a fallback socket.
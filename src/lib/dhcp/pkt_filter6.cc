@@ -33,5 +33,39 @@ PktFilter6::joinMulticast(int sock, const std::string& ifname,
     return (true);
 }
 
+size_t
+PktFilter6::receiveBatch(const SocketInfo& socket_info, size_t max_count,
+                         std::vector<Pkt6Ptr>& pkts) {
+    if (max_count == 0) {
+        return (0);
+    }
+    Pkt6Ptr pkt = receive(socket_info);
+    if (!pkt) {
+        return (0);
+    }
+    pkts.push_back(pkt);
+    return (1);
+}
+
+size_t
+PktFilter6::sendBatch(const Iface& iface, uint16_t sockfd,
+                      const std::vector<Pkt6Ptr>& pkts,
+                      std::vector<std::string>& errors) {
+    errors.assign(pkts.size(), std::string());
+    size_t sent = 0;
+    for (size_t i = 0; i < pkts.size(); ++i) {
+        try {
+            if (send(iface, sockfd, pkts[i]) == 0) {
+                ++sent;
+            } else {
+                errors[i] = "pkt6 send failed";
+            }
+        } catch (const std::exception& ex) {
+            errors[i] = ex.what();
+        }
+    }
+    return (sent);
+}
+
 } // end of isc::dhcp namespace
 } // end of isc namespace
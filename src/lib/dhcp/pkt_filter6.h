@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015,2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2024 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,9 @@
 #include <asiolink/io_address.h>
 #include <dhcp/pkt6.h>
 
+#include <string>
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -115,6 +118,54 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt6Ptr& pkt) = 0;
 
+    /// @brief Receives up to a given number of DHCPv6 messages.
+    ///
+    /// This function is called when the socket is known to be readable.
+    /// It must not block waiting for more messages than are already
+    /// available. The default implementation receives a single message
+    /// using @c receive. Derived classes which can read several datagrams
+    /// with one system call should override it.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param max_count Maximum number of messages to receive.
+    /// @param [out] pkts Vector the received messages are appended to.
+    ///
+    /// @return Number of messages appended to @c pkts.
+    virtual size_t receiveBatch(const SocketInfo& socket_info,
+                                size_t max_count, std::vector<Pkt6Ptr>& pkts);
+
+    /// @brief Sends several DHCPv6 messages through a specified socket.
+    ///
+    /// The result of each message is reported: a message which can't be
+    /// sent does not prevent the next ones from being sent. The
+    /// @c RESPONSE_SENT event is added to the sent messages only. The
+    /// default implementation calls @c send for each message. Derived
+    /// classes which can send several datagrams with one system call
+    /// should override it.
+    ///
+    /// @param iface Interface to be used to send packets.
+    /// @param sockfd A socket descriptor
+    /// @param pkts Packets to be sent.
+    /// @param [out] errors Error message of each message, empty for the
+    /// sent messages.
+    ///
+    /// @return Number of sent messages.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt6Ptr>& pkts,
+                             std::vector<std::string>& errors);
+
+    /// @brief Releases the resources associated with a socket.
+    ///
+    /// @c IfaceMgr calls this function before closing a socket opened by
+    /// this filter, so the derived classes keeping a state per socket
+    /// descriptor can drop it before the descriptor is reused. The
+    /// default implementation does nothing.
+    ///
+    /// @param sockfd A socket descriptor.
+    virtual void releaseSocket(int sockfd) {
+        static_cast<void>(sockfd);
+    }
+
     /// @brief Joins IPv6 multicast group on a socket.
     ///
     /// This function joins the socket to the specified multicast group.
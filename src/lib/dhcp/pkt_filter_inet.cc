@@ -11,14 +11,286 @@
 #include <errno.h>
 #include <cstring>
 #include <fcntl.h>
+#include <sstream>
 
 using namespace isc::asiolink;
 
 namespace isc {
 namespace dhcp {
 
+namespace {
+
+/// @brief Creates a DHCPv4 packet from a received datagram.
+///
+/// @param iface interface the datagram was received on
+/// @param socket_info structure holding socket information
+/// @param buf buffer holding the datagram
+/// @param len length of the datagram
+/// @param from_addr address the datagram was sent from
+/// @param m message header filled by the receive call
+///
+/// @return created packet
+Pkt4Ptr
+makeReceivedPacket(Iface& iface, const SocketInfo& socket_info,
+                   const uint8_t* buf, size_t len,
+                   const struct sockaddr_in& from_addr, struct msghdr& m) {
+    // We have all data let's create Pkt4 object.
+    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(buf, len));
+
+    pkt->updateTimestamp();
+
+    unsigned int ifindex = iface.getIndex();
+
+    IOAddress from(htonl(from_addr.sin_addr.s_addr));
+    uint16_t from_port = htons(from_addr.sin_port);
+
+    // Set receiving interface based on information, which socket was used to
+    // receive data. OS-specific info (see os_receive4()) may be more reliable,
+    // so this value may be overwritten.
+    pkt->setIndex(ifindex);
+    pkt->setIface(iface.getName());
+    pkt->setRemoteAddr(from);
+    pkt->setRemotePort(from_port);
+    pkt->setLocalPort(socket_info.port_);
+
+// Linux systems support IP_PKTINFO option which is used to retrieve the
+// destination address of the received packet. On BSD systems IP_RECVDSTADDR
+// is used instead.
+#if defined (IP_PKTINFO) && defined (OS_LINUX)
+    struct in_pktinfo* pktinfo;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+
+    while (cmsg != NULL) {
+        if ((cmsg->cmsg_level == IPPROTO_IP) &&
+            (cmsg->cmsg_type == IP_PKTINFO)) {
+            pktinfo = reinterpret_cast<struct in_pktinfo*>(CMSG_DATA(cmsg));
+
+            pkt->setIndex(pktinfo->ipi_ifindex);
+            pkt->setLocalAddr(IOAddress(htonl(pktinfo->ipi_addr.s_addr)));
+
+            // This field is useful, when we are bound to unicast
+            // address e.g. 192.0.2.1 and the packet was sent to
+            // broadcast. This will return broadcast address, not
+            // the address we are bound to.
+
+            // XXX: Perhaps we should uncomment this:
+            // to_addr = pktinfo->ipi_spec_dst;
+#ifndef SO_TIMESTAMP
+            break;
+        }
+#else
+        } else if ((cmsg->cmsg_level == SOL_SOCKET) &&
+                   (cmsg->cmsg_type  == SCM_TIMESTAMP)) {
+
+            struct timeval cmsg_time;
+            memcpy(&cmsg_time, CMSG_DATA(cmsg), sizeof(cmsg_time));
+            pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, cmsg_time);
+        }
+#endif
+
+        cmsg = CMSG_NXTHDR(&m, cmsg);
+    }
+
+#elif defined (IP_RECVDSTADDR) && defined (OS_BSD)
+    struct in_addr* to_addr;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+
+    while (cmsg != NULL) {
+        if ((cmsg->cmsg_level == IPPROTO_IP) &&
+            (cmsg->cmsg_type == IP_RECVDSTADDR)) {
+            to_addr = reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg));
+            pkt->setLocalAddr(IOAddress(htonl(to_addr->s_addr)));
+#ifndef SO_TIMESTAMP
+            break;
+        }
+#else
+        } else if ((cmsg->cmsg_level == SOL_SOCKET) &&
+                   (cmsg->cmsg_type  == SCM_TIMESTAMP)) {
+
+            struct timeval cmsg_time;
+            memcpy(&cmsg_time, CMSG_DATA(cmsg), sizeof(cmsg_time));
+            pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, cmsg_time);
+        }
+#endif
+        cmsg = CMSG_NXTHDR(&m, cmsg);
+    }
+
+#endif
+    pkt->addPktEvent(PktEvent::BUFFER_READ);
+
+    return (pkt);
+}
+
+/// @brief Prepares the message header for sending a DHCPv4 packet.
+///
+/// @param pkt packet to be sent
+/// @param[out] to destination address storage
+/// @param[out] v data vector storage
+/// @param control_buf control message buffer
+/// @param control_buf_len length of the control message buffer
+/// @param[out] m message header to fill
+void
+prepareSendHeader(const Pkt4Ptr& pkt, sockaddr_in& to, struct iovec& v,
+                  uint8_t* control_buf, size_t control_buf_len,
+                  struct msghdr& m) {
+    memset(control_buf, 0, control_buf_len);
+
+    // Set the target address we're sending to.
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(pkt->getRemotePort());
+    to.sin_addr.s_addr = htonl(pkt->getRemoteAddr().toUint32());
+
+    // Initialize our message header structure.
+    memset(&m, 0, sizeof(m));
+    m.msg_name = &to;
+    m.msg_namelen = sizeof(to);
+
+    // Set the data buffer we're sending. (Using this wacky
+    // "scatter-gather" stuff... we only have a single chunk
+    // of data to send, so we declare a single vector entry.)
+    memset(&v, 0, sizeof(v));
+    // iov_base field is of void * type. We use it for packet
+    // transmission, so this buffer will not be modified.
+    v.iov_base = const_cast<void *>(pkt->getBuffer().getDataAsVoidPtr());
+    v.iov_len = pkt->getBuffer().getLength();
+    m.msg_iov = &v;
+    m.msg_iovlen = 1;
+
+// In the future the OS-specific code may be abstracted to a different
+// file but for now we keep it here because there is no code yet, which
+// is specific to non-Linux systems.
+#if defined (IP_PKTINFO) && defined (OS_LINUX)
+    // Setting the interface is a bit more involved.
+    //
+    // We have to create a "control message", and set that to
+    // define the IPv4 packet information. We set the source address
+    // to handle correctly interfaces with multiple addresses.
+    m.msg_control = control_buf;
+    m.msg_controllen = control_buf_len;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+    struct in_pktinfo* pktinfo =(struct in_pktinfo *)CMSG_DATA(cmsg);
+    memset(pktinfo, 0, sizeof(struct in_pktinfo));
+
+    // In some cases the index of the outbound interface is not set. This
+    // is a matter of configuration. When the server is configured to
+    // determine the outbound interface based on routing information,
+    // the index is left unset (negative).
+    if (pkt->indexSet()) {
+        pktinfo->ipi_ifindex = pkt->getIndex();
+    }
+
+    // When the DHCP server is using routing to determine the outbound
+    // interface, the local address is also left unset.
+    if (!pkt->getLocalAddr().isV4Zero()) {
+        pktinfo->ipi_spec_dst.s_addr = htonl(pkt->getLocalAddr().toUint32());
+    }
+
+    m.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
+#else
+    static_cast<void>(control_buf);
+    static_cast<void>(control_buf_len);
+#endif
+}
+
+#if defined (OS_LINUX)
+
+/// @brief Message headers and buffers of a batch of datagrams.
+struct MessageBatch {
+    /// @brief Constructor.
+    MessageBatch() : data_len_(0), data_(), control_(), addrs_(), iovs_(),
+                     msgs_() {
+    }
+
+    /// @brief Grows the buffers to hold a number of messages.
+    ///
+    /// The message headers point to the address, control and data
+    /// buffers of their message.
+    ///
+    /// @param count number of messages.
+    /// @param data_len length of the data buffer of a message or 0 when
+    /// the data is not held by the batch.
+    /// @param control_len length of the control buffer of a message.
+    void reserve(size_t count, size_t data_len, size_t control_len) {
+        if ((msgs_.size() >= count) && (data_len_ == data_len)) {
+            return;
+        }
+        data_len_ = data_len;
+        data_.resize(count * data_len);
+        control_.resize(count * control_len);
+        addrs_.resize(count);
+        iovs_.resize(count);
+        msgs_.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            struct msghdr& m = msgs_[i].msg_hdr;
+            memset(&m, 0, sizeof(m));
+            m.msg_name = &addrs_[i];
+            m.msg_namelen = sizeof(addrs_[i]);
+            if (data_len > 0) {
+                iovs_[i].iov_base = static_cast<void*>(&data_[i * data_len]);
+                iovs_[i].iov_len = data_len;
+            }
+            m.msg_iov = &iovs_[i];
+            m.msg_iovlen = 1;
+            m.msg_control = &control_[i * control_len];
+            m.msg_controllen = control_len;
+        }
+    }
+
+    /// @brief Length of the data buffer of a message.
+    size_t data_len_;
+
+    /// @brief Data buffers.
+    std::vector<uint8_t> data_;
+
+    /// @brief Control buffers.
+    std::vector<uint8_t> control_;
+
+    /// @brief Addresses.
+    std::vector<struct sockaddr_in> addrs_;
+
+    /// @brief Data vectors.
+    std::vector<struct iovec> iovs_;
+
+    /// @brief Message headers.
+    std::vector<struct mmsghdr> msgs_;
+};
+#endif
+
+} // end of anonymous namespace
+
 const size_t PktFilterInet::CONTROL_BUF_LEN = 512;
 
+/// @brief Message buffers of the batches of a socket.
+struct PktFilterInet::SocketBuffers {
+#if defined (OS_LINUX)
+    /// @brief Buffers of the received batches.
+    MessageBatch receive_;
+
+    /// @brief Buffers of the sent batches.
+    MessageBatch send_;
+#endif
+};
+
+PktFilterInet::SocketBuffersPtr
+PktFilterInet::getSocketBuffers(int sockfd) {
+    std::lock_guard<std::mutex> lock(socket_buffers_mutex_);
+    SocketBuffersPtr& buffers = socket_buffers_[sockfd];
+    if (!buffers) {
+        buffers.reset(new SocketBuffers());
+    }
+    return (buffers);
+}
+
+void
+PktFilterInet::releaseSocket(int sockfd) {
+    std::lock_guard<std::mutex> lock(socket_buffers_mutex_);
+    socket_buffers_.erase(sockfd);
+}
+
 bool
 PktFilterInet::isSocketReceivedTimeSupported() const {
 #ifdef SO_TIMESTAMP
@@ -115,6 +387,10 @@ PktFilterInet::openSocket(Iface& iface,
     }
 #endif
 
+    // A socket closed without being released may have left the buffers
+    // of its descriptor.
+    releaseSocket(sock);
+
     SocketInfo sock_desc(addr, port, sock);
     return (sock_desc);
 
@@ -158,156 +434,59 @@ PktFilterInet::receive(Iface& iface, const SocketInfo& socket_info) {
     }
 
     // We have all data let's create Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(buf, result));
-
-    pkt->updateTimestamp();
-
-    unsigned int ifindex = iface.getIndex();
-
-    IOAddress from(htonl(from_addr.sin_addr.s_addr));
-    uint16_t from_port = htons(from_addr.sin_port);
-
-    // Set receiving interface based on information, which socket was used to
-    // receive data. OS-specific info (see os_receive4()) may be more reliable,
-    // so this value may be overwritten.
-    pkt->setIndex(ifindex);
-    pkt->setIface(iface.getName());
-    pkt->setRemoteAddr(from);
-    pkt->setRemotePort(from_port);
-    pkt->setLocalPort(socket_info.port_);
-
-// Linux systems support IP_PKTINFO option which is used to retrieve the
-// destination address of the received packet. On BSD systems IP_RECVDSTADDR
-// is used instead.
-#if defined (IP_PKTINFO) && defined (OS_LINUX)
-    struct in_pktinfo* pktinfo;
-    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-
-    while (cmsg != NULL) {
-        if ((cmsg->cmsg_level == IPPROTO_IP) &&
-            (cmsg->cmsg_type == IP_PKTINFO)) {
-            pktinfo = reinterpret_cast<struct in_pktinfo*>(CMSG_DATA(cmsg));
-
-            pkt->setIndex(pktinfo->ipi_ifindex);
-            pkt->setLocalAddr(IOAddress(htonl(pktinfo->ipi_addr.s_addr)));
-
-            // This field is useful, when we are bound to unicast
-            // address e.g. 192.0.2.1 and the packet was sent to
-            // broadcast. This will return broadcast address, not
-            // the address we are bound to.
+    return (makeReceivedPacket(iface, socket_info, buf, result, from_addr, m));
+}
 
-            // XXX: Perhaps we should uncomment this:
-            // to_addr = pktinfo->ipi_spec_dst;
-#ifndef SO_TIMESTAMP
-            break;
-        }
-#else
-        } else if ((cmsg->cmsg_level == SOL_SOCKET) &&
-                   (cmsg->cmsg_type  == SCM_TIMESTAMP)) {
+size_t
+PktFilterInet::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                            size_t max_count, std::vector<Pkt4Ptr>& pkts) {
+#if defined (OS_LINUX)
+    if (max_count <= 1) {
+        return (PktFilter::receiveBatch(iface, socket_info, max_count, pkts));
+    }
 
-            struct timeval cmsg_time;
-            memcpy(&cmsg_time, CMSG_DATA(cmsg), sizeof(cmsg_time));
-            pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, cmsg_time);
-        }
-#endif
+    MessageBatch& batch = getSocketBuffers(socket_info.sockfd_)->receive_;
+    batch.reserve(max_count, IfaceMgr::RCVBUFSIZE, CONTROL_BUF_LEN);
 
-        cmsg = CMSG_NXTHDR(&m, cmsg);
+    // The kernel updates these lengths.
+    for (size_t i = 0; i < max_count; ++i) {
+        struct msghdr& m = batch.msgs_[i].msg_hdr;
+        m.msg_namelen = sizeof(batch.addrs_[i]);
+        m.msg_controllen = CONTROL_BUF_LEN;
+        m.msg_flags = 0;
     }
 
-#elif defined (IP_RECVDSTADDR) && defined (OS_BSD)
-    struct in_addr* to_addr;
-    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-
-    while (cmsg != NULL) {
-        if ((cmsg->cmsg_level == IPPROTO_IP) &&
-            (cmsg->cmsg_type == IP_RECVDSTADDR)) {
-            to_addr = reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg));
-            pkt->setLocalAddr(IOAddress(htonl(to_addr->s_addr)));
-#ifndef SO_TIMESTAMP
-            break;
+    // Do not wait for more datagrams than are already queued.
+    int result = recvmmsg(socket_info.sockfd_, &batch.msgs_[0], max_count,
+                          MSG_DONTWAIT, 0);
+    if (result < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return (0);
         }
-#else
-        } else if ((cmsg->cmsg_level == SOL_SOCKET) &&
-                   (cmsg->cmsg_type  == SCM_TIMESTAMP)) {
+        isc_throw(SocketReadError, "failed to receive UDP4 data");
+    }
 
-            struct timeval cmsg_time;
-            memcpy(&cmsg_time, CMSG_DATA(cmsg), sizeof(cmsg_time));
-            pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, cmsg_time);
-        }
-#endif
-        cmsg = CMSG_NXTHDR(&m, cmsg);
+    for (int i = 0; i < result; ++i) {
+        pkts.push_back(makeReceivedPacket(iface, socket_info,
+                                          &batch.data_[i * IfaceMgr::RCVBUFSIZE],
+                                          batch.msgs_[i].msg_len,
+                                          batch.addrs_[i],
+                                          batch.msgs_[i].msg_hdr));
     }
 
+    return (static_cast<size_t>(result));
+#else
+    return (PktFilter::receiveBatch(iface, socket_info, max_count, pkts));
 #endif
-    pkt->addPktEvent(PktEvent::BUFFER_READ);
-
-    return (pkt);
 }
 
 int
 PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
     uint8_t control_buf[CONTROL_BUF_LEN];
-    memset(&control_buf[0], 0, CONTROL_BUF_LEN);
-
-    // Set the target address we're sending to.
     sockaddr_in to;
-    memset(&to, 0, sizeof(to));
-    to.sin_family = AF_INET;
-    to.sin_port = htons(pkt->getRemotePort());
-    to.sin_addr.s_addr = htonl(pkt->getRemoteAddr().toUint32());
-
-    struct msghdr m;
-    // Initialize our message header structure.
-    memset(&m, 0, sizeof(m));
-    m.msg_name = &to;
-    m.msg_namelen = sizeof(to);
-
-    // Set the data buffer we're sending. (Using this wacky
-    // "scatter-gather" stuff... we only have a single chunk
-    // of data to send, so we declare a single vector entry.)
     struct iovec v;
-    memset(&v, 0, sizeof(v));
-    // iov_base field is of void * type. We use it for packet
-    // transmission, so this buffer will not be modified.
-    v.iov_base = const_cast<void *>(pkt->getBuffer().getDataAsVoidPtr());
-    v.iov_len = pkt->getBuffer().getLength();
-    m.msg_iov = &v;
-    m.msg_iovlen = 1;
-
-// In the future the OS-specific code may be abstracted to a different
-// file but for now we keep it here because there is no code yet, which
-// is specific to non-Linux systems.
-#if defined (IP_PKTINFO) && defined (OS_LINUX)
-    // Setting the interface is a bit more involved.
-    //
-    // We have to create a "control message", and set that to
-    // define the IPv4 packet information. We set the source address
-    // to handle correctly interfaces with multiple addresses.
-    m.msg_control = &control_buf[0];
-    m.msg_controllen = CONTROL_BUF_LEN;
-    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-    cmsg->cmsg_level = IPPROTO_IP;
-    cmsg->cmsg_type = IP_PKTINFO;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
-    struct in_pktinfo* pktinfo =(struct in_pktinfo *)CMSG_DATA(cmsg);
-    memset(pktinfo, 0, sizeof(struct in_pktinfo));
-
-    // In some cases the index of the outbound interface is not set. This
-    // is a matter of configuration. When the server is configured to
-    // determine the outbound interface based on routing information,
-    // the index is left unset (negative).
-    if (pkt->indexSet()) {
-        pktinfo->ipi_ifindex = pkt->getIndex();
-    }
-
-    // When the DHCP server is using routing to determine the outbound
-    // interface, the local address is also left unset.
-    if (!pkt->getLocalAddr().isV4Zero()) {
-        pktinfo->ipi_spec_dst.s_addr = htonl(pkt->getLocalAddr().toUint32());
-    }
-
-    m.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
-#endif
+    struct msghdr m;
+    prepareSendHeader(pkt, to, v, control_buf, CONTROL_BUF_LEN, m);
 
     pkt->updateTimestamp();
 
@@ -322,5 +501,62 @@ PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
     return (0);
 }
 
+size_t
+PktFilterInet::sendBatch(const Iface& iface, uint16_t sockfd,
+                         const std::vector<Pkt4Ptr>& pkts,
+                         std::vector<std::string>& errors) {
+#if defined (OS_LINUX)
+    if (pkts.size() <= 1) {
+        return (PktFilter::sendBatch(iface, sockfd, pkts, errors));
+    }
+
+    size_t count = pkts.size();
+    errors.assign(count, std::string());
+    MessageBatch& batch = getSocketBuffers(sockfd)->send_;
+    batch.reserve(count, 0, CONTROL_BUF_LEN);
+
+    for (size_t i = 0; i < count; ++i) {
+        prepareSendHeader(pkts[i], batch.addrs_[i], batch.iovs_[i],
+                          &batch.control_[i * CONTROL_BUF_LEN], CONTROL_BUF_LEN,
+                          batch.msgs_[i].msg_hdr);
+        pkts[i]->updateTimestamp();
+    }
+
+    // The kernel may send fewer datagrams than requested so loop
+    // until all of them are gone. When the first remaining datagram
+    // fails it is reported and skipped.
+    size_t sent = 0;
+    size_t next = 0;
+    while (next < count) {
+        int result = sendmmsg(sockfd, &batch.msgs_[next], count - next, 0);
+        if (result <= 0) {
+            if ((result < 0) && (errno == EINTR)) {
+                continue;
+            }
+            errors[next] = std::string("pkt4 send failed: sendmmsg() returned"
+                                       " with an error: ") + strerror(errno);
+            ++next;
+            continue;
+        }
+        for (int i = 0; i < result; ++i, ++next) {
+            if (batch.msgs_[next].msg_len != batch.iovs_[next].iov_len) {
+                std::ostringstream msg;
+                msg << "pkt4 send failed: sendmmsg() sent "
+                    << batch.msgs_[next].msg_len << " of "
+                    << batch.iovs_[next].iov_len << " bytes";
+                errors[next] = msg.str();
+                continue;
+            }
+            pkts[next]->addPktEvent(PktEvent::RESPONSE_SENT);
+            ++sent;
+        }
+    }
+
+    return (sent);
+#else
+    return (PktFilter::sendBatch(iface, sockfd, pkts, errors));
+#endif
+}
+
 } // end of isc::dhcp namespace
 } // end of isc namespace
@@ -9,6 +9,10 @@
 
 #include <dhcp/pkt_filter.h>
 #include <boost/scoped_array.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <mutex>
 
 namespace isc {
 namespace dhcp {
@@ -86,9 +90,74 @@ public:
     /// a DHCP message through the socket.
     virtual int send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt);
 
+    /// @brief Receive up to a given number of packets over specified socket.
+    ///
+    /// On Linux all datagrams already queued on the socket, up to
+    /// @c max_count, are read with a single recvmmsg() call. Other
+    /// systems receive a single packet.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param max_count maximum number of packets to receive.
+    /// @param [out] pkts vector the received packets are appended to.
+    ///
+    /// @return number of packets appended to @c pkts.
+    /// @throw isc::dhcp::SocketReadError if an error occurs during reception
+    /// of the packets.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                size_t max_count, std::vector<Pkt4Ptr>& pkts);
+
+    /// @brief Send several packets over specified socket.
+    ///
+    /// On Linux the packets are sent with sendmmsg(). A datagram the
+    /// kernel rejects is reported in @c errors and the next ones are
+    /// sent by another call. Other systems send them one by one.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    /// @param [out] errors error message of each packet, empty for the
+    /// sent packets.
+    ///
+    /// @return number of sent packets.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts,
+                             std::vector<std::string>& errors);
+
+    /// @brief Releases the message buffers of a socket.
+    ///
+    /// @param sockfd socket descriptor
+    virtual void releaseSocket(int sockfd);
+
 private:
+    /// @brief Message buffers of the batches of a socket.
+    struct SocketBuffers;
+
+    /// @brief Pointer to the message buffers of a socket.
+    typedef boost::shared_ptr<SocketBuffers> SocketBuffersPtr;
+
+    /// @brief Returns the message buffers of a socket.
+    ///
+    /// The buffers are allocated by the first batch of the socket and
+    /// reused by the next ones until the socket is released or a new
+    /// socket is opened with the same descriptor. A socket is read by a
+    /// single receiver thread and @c IfaceMgr sends one batch at a time
+    /// through a socket, so the receive and the send buffers of a socket
+    /// are not used concurrently.
+    ///
+    /// @param sockfd socket descriptor.
+    ///
+    /// @return pointer to the buffers.
+    SocketBuffersPtr getSocketBuffers(int sockfd);
+
     /// Length of the socket control buffer.
     static const size_t CONTROL_BUF_LEN;
+
+    /// @brief Message buffers by socket descriptor.
+    std::map<int, SocketBuffersPtr> socket_buffers_;
+
+    /// @brief Mutex to protect the buffers map against concurrent access.
+    std::mutex socket_buffers_mutex_;
 };
 
 } // namespace isc::dhcp
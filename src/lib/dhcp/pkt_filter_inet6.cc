@@ -15,13 +15,288 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 
+#include <cstring>
+#include <sstream>
+
 using namespace isc::asiolink;
 
 namespace isc {
 namespace dhcp {
 
+namespace {
+
+/// @brief Creates a DHCPv6 packet from a received datagram.
+///
+/// @param socket_info A structure holding socket information.
+/// @param buf Buffer holding the datagram.
+/// @param len Length of the datagram.
+/// @param from Address the datagram was sent from.
+/// @param m Message header filled by the receive call.
+///
+/// @return A pointer to the created packet or null if the datagram
+/// must be dropped.
+Pkt6Ptr
+makeReceivedPacket(const SocketInfo& socket_info, const uint8_t* buf,
+                   size_t len, const struct sockaddr_in6& from,
+                   struct msghdr& m) {
+#ifdef SO_TIMESTAMP
+    struct timeval so_rcv_timestamp;
+    memset(&so_rcv_timestamp, 0, sizeof(so_rcv_timestamp));
+#endif
+
+    struct in6_addr to_addr;
+    memset(&to_addr, 0, sizeof(to_addr));
+
+    unsigned int ifindex = UNSET_IFINDEX;
+    struct in6_pktinfo* pktinfo = NULL;
+
+    // We need to loop through the control messages we received and
+    // find the one with our destination address.
+    //
+    // We also keep a flag to see if we found it. If we
+    // didn't, then we consider this to be an error.
+    bool found_pktinfo = false;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+    while (cmsg != NULL) {
+        if ((cmsg->cmsg_level == IPPROTO_IPV6) &&
+            (cmsg->cmsg_type == IPV6_PKTINFO)) {
+            pktinfo = util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
+            to_addr = pktinfo->ipi6_addr;
+            ifindex = pktinfo->ipi6_ifindex;
+            found_pktinfo = true;
+#ifndef SO_TIMESTAMP
+            break;
+        }
+#else
+        } else if ((cmsg->cmsg_level == SOL_SOCKET) &&
+                   (cmsg->cmsg_type  == SCM_TIMESTAMP)) {
+            memcpy(&so_rcv_timestamp, CMSG_DATA(cmsg), sizeof(so_rcv_timestamp));
+        }
+#endif
+        cmsg = CMSG_NXTHDR(&m, cmsg);
+    }
+    if (!found_pktinfo) {
+        isc_throw(SocketReadError, "unable to find pktinfo");
+    }
+
+    // Filter out packets sent to global unicast address (not link local and
+    // not multicast) if the socket is set to listen multicast traffic and
+    // is bound to in6addr_any. The traffic sent to global unicast address is
+    // received via dedicated socket.
+    IOAddress local_addr = IOAddress::fromBytes(AF_INET6,
+                      reinterpret_cast<const uint8_t*>(&to_addr));
+    if ((socket_info.addr_ == IOAddress("::")) &&
+        !(local_addr.isV6Multicast() || local_addr.isV6LinkLocal())) {
+        return (Pkt6Ptr());
+    }
+
+    // Let's create a packet.
+    Pkt6Ptr pkt;
+    try {
+        pkt = Pkt6Ptr(new Pkt6(buf, len));
+    } catch (const std::exception& ex) {
+        isc_throw(SocketReadError, "failed to create new packet");
+    }
+
+    pkt->updateTimestamp();
+
+#ifdef SO_TIMESTAMP
+    pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, so_rcv_timestamp);
+#endif
+
+    pkt->addPktEvent(PktEvent::BUFFER_READ);
+
+    pkt->setLocalAddr(IOAddress::fromBytes(AF_INET6,
+                      reinterpret_cast<const uint8_t*>(&to_addr)));
+    pkt->setRemoteAddr(IOAddress::fromBytes(AF_INET6,
+                       reinterpret_cast<const uint8_t*>(&from.sin6_addr)));
+    pkt->setRemotePort(ntohs(from.sin6_port));
+    pkt->setIndex(ifindex);
+
+    IfacePtr received = IfaceMgr::instance().getIface(pkt->getIndex());
+    if (received) {
+        pkt->setIface(received->getName());
+    } else {
+        isc_throw(SocketReadError, "received packet over unknown interface"
+                  << "(ifindex=" << pkt->getIndex() << ")");
+    }
+
+    return (pkt);
+}
+
+/// @brief Prepares the message header for sending a DHCPv6 packet.
+///
+/// @param pkt Packet to be sent.
+/// @param[out] to Destination address storage.
+/// @param[out] v Data vector storage.
+/// @param control_buf Control message buffer.
+/// @param control_buf_len Length of the control message buffer.
+/// @param[out] m Message header to fill.
+void
+prepareSendHeader(const Pkt6Ptr& pkt, sockaddr_in6& to, struct iovec& v,
+                  uint8_t* control_buf, size_t control_buf_len,
+                  struct msghdr& m) {
+    memset(control_buf, 0, control_buf_len);
+
+    // Set the target address we're sending to.
+    memset(&to, 0, sizeof(to));
+    to.sin6_family = AF_INET6;
+    to.sin6_port = htons(pkt->getRemotePort());
+    memcpy(&to.sin6_addr,
+           &pkt->getRemoteAddr().toBytes()[0],
+           16);
+    to.sin6_scope_id = pkt->getIndex();
+
+    // Initialize our message header structure.
+    memset(&m, 0, sizeof(m));
+    m.msg_name = &to;
+    m.msg_namelen = sizeof(to);
+
+    // Set the data buffer we're sending. (Using this wacky
+    // "scatter-gather" stuff... we only have a single chunk
+    // of data to send, so we declare a single vector entry.)
+
+    // As v structure is a C-style is used for both sending and
+    // receiving data, it is shared between sending and receiving
+    // (sendmsg and recvmsg). It is also defined in system headers,
+    // so we have no control over its definition. To set iov_base
+    // (defined as void*) we must use const cast from void *.
+    // Otherwise C++ compiler would complain that we are trying
+    // to assign const void* to void*.
+    memset(&v, 0, sizeof(v));
+    v.iov_base = const_cast<void *>(pkt->getBuffer().getDataAsVoidPtr());
+    v.iov_len = pkt->getBuffer().getLength();
+    m.msg_iov = &v;
+    m.msg_iovlen = 1;
+
+    // Setting the interface is a bit more involved.
+    //
+    // We have to create a "control message", and set that to
+    // define the IPv6 packet information. We could set the
+    // source address if we wanted, but we can safely let the
+    // kernel decide what that should be.
+    m.msg_control = control_buf;
+    m.msg_controllen = control_buf_len;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&m);
+
+    // FIXME: Code below assumes that cmsg is not NULL, but
+    // CMSG_FIRSTHDR() is coded to return NULL as a possibility.  The
+    // following assertion should never fail, but if it did and you came
+    // here, fix the code. :)
+    isc_throw_assert(cmsg != NULL);
+
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+    struct in6_pktinfo *pktinfo =
+        util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
+    memset(pktinfo, 0, sizeof(struct in6_pktinfo));
+    pktinfo->ipi6_ifindex = pkt->getIndex();
+    // According to RFC3542, section 20.2, the msg_controllen field
+    // may be set using CMSG_SPACE (which includes padding) or
+    // using CMSG_LEN. Both forms appear to work fine on Linux, FreeBSD,
+    // NetBSD, but OpenBSD appears to have a bug, discussed here:
+    // https://marc.info/?l=openbsd-bugs&m=123485913417684&w=2
+    // which causes sendmsg to return EINVAL if the CMSG_LEN is
+    // used to set the msg_controllen value.
+    m.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
+}
+
+#if defined (OS_LINUX)
+
+/// @brief Message headers and buffers of a batch of datagrams.
+struct MessageBatch {
+    /// @brief Constructor.
+    MessageBatch() : data_len_(0), data_(), control_(), addrs_(), iovs_(),
+                     msgs_() {
+    }
+
+    /// @brief Grows the buffers to hold a number of messages.
+    ///
+    /// The message headers point to the address, control and data
+    /// buffers of their message.
+    ///
+    /// @param count number of messages.
+    /// @param data_len length of the data buffer of a message or 0 when
+    /// the data is not held by the batch.
+    /// @param control_len length of the control buffer of a message.
+    void reserve(size_t count, size_t data_len, size_t control_len) {
+        if ((msgs_.size() >= count) && (data_len_ == data_len)) {
+            return;
+        }
+        data_len_ = data_len;
+        data_.resize(count * data_len);
+        control_.resize(count * control_len);
+        addrs_.resize(count);
+        iovs_.resize(count);
+        msgs_.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            struct msghdr& m = msgs_[i].msg_hdr;
+            memset(&m, 0, sizeof(m));
+            m.msg_name = &addrs_[i];
+            m.msg_namelen = sizeof(addrs_[i]);
+            if (data_len > 0) {
+                iovs_[i].iov_base = static_cast<void*>(&data_[i * data_len]);
+                iovs_[i].iov_len = data_len;
+            }
+            m.msg_iov = &iovs_[i];
+            m.msg_iovlen = 1;
+            m.msg_control = &control_[i * control_len];
+            m.msg_controllen = control_len;
+        }
+    }
+
+    /// @brief Length of the data buffer of a message.
+    size_t data_len_;
+
+    /// @brief Data buffers.
+    std::vector<uint8_t> data_;
+
+    /// @brief Control buffers.
+    std::vector<uint8_t> control_;
+
+    /// @brief Addresses.
+    std::vector<struct sockaddr_in6> addrs_;
+
+    /// @brief Data vectors.
+    std::vector<struct iovec> iovs_;
+
+    /// @brief Message headers.
+    std::vector<struct mmsghdr> msgs_;
+};
+#endif
+
+} // end of anonymous namespace
+
 const size_t PktFilterInet6::CONTROL_BUF_LEN = 512;
 
+/// @brief Message buffers of the batches of a socket.
+struct PktFilterInet6::SocketBuffers {
+#if defined (OS_LINUX)
+    /// @brief Buffers of the received batches.
+    MessageBatch receive_;
+
+    /// @brief Buffers of the sent batches.
+    MessageBatch send_;
+#endif
+};
+
+PktFilterInet6::SocketBuffersPtr
+PktFilterInet6::getSocketBuffers(int sockfd) {
+    std::lock_guard<std::mutex> lock(socket_buffers_mutex_);
+    SocketBuffersPtr& buffers = socket_buffers_[sockfd];
+    if (!buffers) {
+        buffers.reset(new SocketBuffers());
+    }
+    return (buffers);
+}
+
+void
+PktFilterInet6::releaseSocket(int sockfd) {
+    std::lock_guard<std::mutex> lock(socket_buffers_mutex_);
+    socket_buffers_.erase(sockfd);
+}
+
 bool
 PktFilterInet6::isSocketReceivedTimeSupported() const {
 #ifdef SO_TIMESTAMP
@@ -155,6 +430,10 @@ PktFilterInet6::openSocket(const Iface& iface,
                   << " multicast group.");
     }
 
+    // A socket closed without being released may have left the buffers
+    // of its descriptor.
+    releaseSocket(sock);
+
     return (SocketInfo(addr, port, sock));
 }
 
@@ -167,11 +446,6 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     struct sockaddr_in6 from;
     memset(&from, 0, sizeof(from));
 
-#ifdef SO_TIMESTAMP
-    struct timeval so_rcv_timestamp;
-    memset(&so_rcv_timestamp, 0, sizeof(so_rcv_timestamp));
-#endif
-
     // Initialize our message header structure.
     struct msghdr m;
     memset(&m, 0, sizeof(m));
@@ -200,164 +474,69 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     m.msg_controllen = CONTROL_BUF_LEN;
 
     int result = recvmsg(socket_info.sockfd_, &m, 0);
-
-    struct in6_addr to_addr;
-    memset(&to_addr, 0, sizeof(to_addr));
-
-    unsigned int ifindex = UNSET_IFINDEX;
-    if (result >= 0) {
-        struct in6_pktinfo* pktinfo = NULL;
-
-
-        // If we did read successfully, then we need to loop
-        // through the control messages we received and
-        // find the one with our destination address.
-        //
-        // We also keep a flag to see if we found it. If we
-        // didn't, then we consider this to be an error.
-        bool found_pktinfo = false;
-        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-        while (cmsg != NULL) {
-            if ((cmsg->cmsg_level == IPPROTO_IPV6) &&
-                (cmsg->cmsg_type == IPV6_PKTINFO)) {
-                pktinfo = util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
-                to_addr = pktinfo->ipi6_addr;
-                ifindex = pktinfo->ipi6_ifindex;
-                found_pktinfo = true;
-#ifndef SO_TIMESTAMP
-                break;
-            }
-#else
-            } else if ((cmsg->cmsg_level == SOL_SOCKET) &&
-                       (cmsg->cmsg_type  == SCM_TIMESTAMP)) {
-                memcpy(&so_rcv_timestamp, CMSG_DATA(cmsg), sizeof(so_rcv_timestamp));
-            }
-#endif
-            cmsg = CMSG_NXTHDR(&m, cmsg);
-        }
-        if (!found_pktinfo) {
-            isc_throw(SocketReadError, "unable to find pktinfo");
-        }
-    } else {
+    if (result < 0) {
         isc_throw(SocketReadError, "failed to receive data");
     }
 
-    // Filter out packets sent to global unicast address (not link local and
-    // not multicast) if the socket is set to listen multicast traffic and
-    // is bound to in6addr_any. The traffic sent to global unicast address is
-    // received via dedicated socket.
-    IOAddress local_addr = IOAddress::fromBytes(AF_INET6,
-                      reinterpret_cast<const uint8_t*>(&to_addr));
-    if ((socket_info.addr_ == IOAddress("::")) &&
-        !(local_addr.isV6Multicast() || local_addr.isV6LinkLocal())) {
-        return (Pkt6Ptr());
-    }
+    return (makeReceivedPacket(socket_info, buf, result, from, m));
+}
 
-    // Let's create a packet.
-    Pkt6Ptr pkt;
-    try {
-        pkt = Pkt6Ptr(new Pkt6(buf, result));
-    } catch (const std::exception& ex) {
-        isc_throw(SocketReadError, "failed to create new packet");
+size_t
+PktFilterInet6::receiveBatch(const SocketInfo& socket_info, size_t max_count,
+                             std::vector<Pkt6Ptr>& pkts) {
+#if defined (OS_LINUX)
+    if (max_count <= 1) {
+        return (PktFilter6::receiveBatch(socket_info, max_count, pkts));
     }
 
-    pkt->updateTimestamp();
-
-#ifdef SO_TIMESTAMP
-    pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, so_rcv_timestamp);
-#endif
-
-    pkt->addPktEvent(PktEvent::BUFFER_READ);
+    MessageBatch& batch = getSocketBuffers(socket_info.sockfd_)->receive_;
+    batch.reserve(max_count, IfaceMgr::RCVBUFSIZE, CONTROL_BUF_LEN);
 
-    pkt->setLocalAddr(IOAddress::fromBytes(AF_INET6,
-                      reinterpret_cast<const uint8_t*>(&to_addr)));
-    pkt->setRemoteAddr(IOAddress::fromBytes(AF_INET6,
-                       reinterpret_cast<const uint8_t*>(&from.sin6_addr)));
-    pkt->setRemotePort(ntohs(from.sin6_port));
-    pkt->setIndex(ifindex);
+    // The kernel updates these lengths.
+    for (size_t i = 0; i < max_count; ++i) {
+        struct msghdr& m = batch.msgs_[i].msg_hdr;
+        m.msg_namelen = sizeof(batch.addrs_[i]);
+        m.msg_controllen = CONTROL_BUF_LEN;
+        m.msg_flags = 0;
+    }
 
-    IfacePtr received = IfaceMgr::instance().getIface(pkt->getIndex());
-    if (received) {
-        pkt->setIface(received->getName());
-    } else {
-        isc_throw(SocketReadError, "received packet over unknown interface"
-                  << "(ifindex=" << pkt->getIndex() << ")");
+    // Do not wait for more datagrams than are already queued.
+    int result = recvmmsg(socket_info.sockfd_, &batch.msgs_[0], max_count,
+                          MSG_DONTWAIT, 0);
+    if (result < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return (0);
+        }
+        isc_throw(SocketReadError, "failed to receive data");
     }
 
-    return (pkt);
+    size_t count = 0;
+    for (int i = 0; i < result; ++i) {
+        Pkt6Ptr pkt = makeReceivedPacket(socket_info,
+                                         &batch.data_[i * IfaceMgr::RCVBUFSIZE],
+                                         batch.msgs_[i].msg_len,
+                                         batch.addrs_[i],
+                                         batch.msgs_[i].msg_hdr);
+        // Dropped datagrams are not returned.
+        if (pkt) {
+            pkts.push_back(pkt);
+            ++count;
+        }
+    }
 
+    return (count);
+#else
+    return (PktFilter6::receiveBatch(socket_info, max_count, pkts));
+#endif
 }
 
 int
 PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     uint8_t control_buf[CONTROL_BUF_LEN];
-    memset(&control_buf[0], 0, CONTROL_BUF_LEN);
-
-    // Set the target address we're sending to.
     sockaddr_in6 to;
-    memset(&to, 0, sizeof(to));
-    to.sin6_family = AF_INET6;
-    to.sin6_port = htons(pkt->getRemotePort());
-    memcpy(&to.sin6_addr,
-           &pkt->getRemoteAddr().toBytes()[0],
-           16);
-    to.sin6_scope_id = pkt->getIndex();
-
-    // Initialize our message header structure.
-    struct msghdr m;
-    memset(&m, 0, sizeof(m));
-    m.msg_name = &to;
-    m.msg_namelen = sizeof(to);
-
-    // Set the data buffer we're sending. (Using this wacky
-    // "scatter-gather" stuff... we only have a single chunk
-    // of data to send, so we declare a single vector entry.)
-
-    // As v structure is a C-style is used for both sending and
-    // receiving data, it is shared between sending and receiving
-    // (sendmsg and recvmsg). It is also defined in system headers,
-    // so we have no control over its definition. To set iov_base
-    // (defined as void*) we must use const cast from void *.
-    // Otherwise C++ compiler would complain that we are trying
-    // to assign const void* to void*.
     struct iovec v;
-    memset(&v, 0, sizeof(v));
-    v.iov_base = const_cast<void *>(pkt->getBuffer().getDataAsVoidPtr());
-    v.iov_len = pkt->getBuffer().getLength();
-    m.msg_iov = &v;
-    m.msg_iovlen = 1;
-
-    // Setting the interface is a bit more involved.
-    //
-    // We have to create a "control message", and set that to
-    // define the IPv6 packet information. We could set the
-    // source address if we wanted, but we can safely let the
-    // kernel decide what that should be.
-    m.msg_control = &control_buf[0];
-    m.msg_controllen = CONTROL_BUF_LEN;
-    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&m);
-
-    // FIXME: Code below assumes that cmsg is not NULL, but
-    // CMSG_FIRSTHDR() is coded to return NULL as a possibility.  The
-    // following assertion should never fail, but if it did and you came
-    // here, fix the code. :)
-    isc_throw_assert(cmsg != NULL);
-
-    cmsg->cmsg_level = IPPROTO_IPV6;
-    cmsg->cmsg_type = IPV6_PKTINFO;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
-    struct in6_pktinfo *pktinfo =
-        util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
-    memset(pktinfo, 0, sizeof(struct in6_pktinfo));
-    pktinfo->ipi6_ifindex = pkt->getIndex();
-    // According to RFC3542, section 20.2, the msg_controllen field
-    // may be set using CMSG_SPACE (which includes padding) or
-    // using CMSG_LEN. Both forms appear to work fine on Linux, FreeBSD,
-    // NetBSD, but OpenBSD appears to have a bug, discussed here:
-    // https://marc.info/?l=openbsd-bugs&m=123485913417684&w=2
-    // which causes sendmsg to return EINVAL if the CMSG_LEN is
-    // used to set the msg_controllen value.
-    m.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
+    struct msghdr m;
+    prepareSendHeader(pkt, to, v, control_buf, CONTROL_BUF_LEN, m);
 
     pkt->updateTimestamp();
 
@@ -372,5 +551,62 @@ PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     return (0);
 }
 
+size_t
+PktFilterInet6::sendBatch(const Iface& iface, uint16_t sockfd,
+                          const std::vector<Pkt6Ptr>& pkts,
+                          std::vector<std::string>& errors) {
+#if defined (OS_LINUX)
+    if (pkts.size() <= 1) {
+        return (PktFilter6::sendBatch(iface, sockfd, pkts, errors));
+    }
+
+    size_t count = pkts.size();
+    errors.assign(count, std::string());
+    MessageBatch& batch = getSocketBuffers(sockfd)->send_;
+    batch.reserve(count, 0, CONTROL_BUF_LEN);
+
+    for (size_t i = 0; i < count; ++i) {
+        prepareSendHeader(pkts[i], batch.addrs_[i], batch.iovs_[i],
+                          &batch.control_[i * CONTROL_BUF_LEN], CONTROL_BUF_LEN,
+                          batch.msgs_[i].msg_hdr);
+        pkts[i]->updateTimestamp();
+    }
+
+    // The kernel may send fewer datagrams than requested so loop
+    // until all of them are gone. When the first remaining datagram
+    // fails it is reported and skipped.
+    size_t sent = 0;
+    size_t next = 0;
+    while (next < count) {
+        int result = sendmmsg(sockfd, &batch.msgs_[next], count - next, 0);
+        if (result <= 0) {
+            if ((result < 0) && (errno == EINTR)) {
+                continue;
+            }
+            errors[next] = std::string("pkt6 send failed: sendmmsg() returned"
+                                       " with an error: ") + strerror(errno);
+            ++next;
+            continue;
+        }
+        for (int i = 0; i < result; ++i, ++next) {
+            if (batch.msgs_[next].msg_len != batch.iovs_[next].iov_len) {
+                std::ostringstream msg;
+                msg << "pkt6 send failed: sendmmsg() sent "
+                    << batch.msgs_[next].msg_len << " of "
+                    << batch.iovs_[next].iov_len << " bytes";
+                errors[next] = msg.str();
+                continue;
+            }
+            pkts[next]->addPktEvent(PktEvent::RESPONSE_SENT);
+            ++sent;
+        }
+    }
+
+    return (sent);
+#else
+    return (PktFilter6::sendBatch(iface, sockfd, pkts, errors));
+#endif
+}
+
 }
 }
@@ -16,6 +16,7 @@
 #include <linux/filter.h>
 #include <linux/if_ether.h>
 #include <linux/if_packet.h>
+#include <sys/mman.h>
 
 namespace {
 
@@ -121,6 +122,150 @@ struct sock_filter dhcp_sock_filter [] = {
     BPF_STMT(BPF_RET + BPF_K, 0),
 };
 
+/// Size of the memory-mapped ring blocks. It must be a multiple of the
+/// page size.
+const unsigned int RING_BLOCK_SIZE = 1 << 16;
+
+/// Number of blocks in the RX ring.
+const unsigned int RX_RING_BLOCK_NR = 32;
+
+/// Number of blocks in the TX ring.
+const unsigned int TX_RING_BLOCK_NR = 4;
+
+/// Size of the ring frames, large enough for an Ethernet frame and
+/// the ring headers.
+const unsigned int RING_FRAME_SIZE = 1 << 11;
+
+/// Time in milliseconds after which the kernel releases a partially
+/// filled RX block to the server.
+const unsigned int RX_RING_BLOCK_TIMEOUT = 1;
+
+/// Offset of the frame data in a TX ring frame.
+const size_t TX_RING_DATA_OFFSET = TPACKET_ALIGN(sizeof(struct tpacket3_hdr));
+
+/// @brief Discards the data received over the fallback socket.
+///
+/// The data will be discarded but we don't want the socket buffer to
+/// bloat. We get the packets from the socket in loop but most of the time
+/// the loop will end after receiving one packet. The call to recv returns
+/// immediately when there is no data left on the socket because the
+/// socket is non-blocking.
+///
+/// @todo In the normal conditions, both the primary socket and the fallback
+/// socket are in sync as they are set to receive packets on the same
+/// address and port. The reception of packets on the fallback socket
+/// shouldn't cause significant lags in packet reception. If we find in the
+/// future that it does, the sort of threshold could be set for the maximum
+/// bytes received on the fallback socket in a single round. Further
+/// optimizations would include an asynchronous read from the fallback socket
+/// when the DHCP server is idle.
+///
+/// @param socket_info structure holding socket information
+void
+drainFallbackSocket(const SocketInfo& socket_info) {
+    uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
+    int datalen;
+    do {
+        datalen = recv(socket_info.fallbackfd_, raw_buf, sizeof(raw_buf), 0);
+    } while (datalen > 0);
+}
+
+/// @brief Creates a DHCPv4 packet from a received Ethernet frame.
+///
+/// The DHCP data is copied once, into the packet.
+///
+/// @param iface interface the frame was received over
+/// @param data pointer to the frame
+/// @param len length of the frame
+///
+/// @return received packet.
+Pkt4Ptr
+makeReceivedPacket(Iface& iface, const uint8_t* data, size_t len) {
+    isc::util::InputBuffer buf(data, len);
+
+    // @todo: This is awkward way to solve the chicken and egg problem
+    // whereby we don't know the offset where DHCP data start in the
+    // received buffer when we create the packet object. In general case,
+    // the IP header has variable length. The information about its length
+    // is stored in one of its fields. Therefore, we have to decode the
+    // packet to get the offset of the DHCP data. The dummy object is
+    // created so as we can pass it to the functions which decode IP stack
+    // and find actual offset of the DHCP data.
+    // Once we find the offset we can create another Pkt4 object from
+    // the reminder of the input buffer and set the IP addresses and
+    // ports from the dummy packet. We should consider doing it
+    // in some more elegant way.
+    Pkt4Ptr dummy_pkt = Pkt4Ptr(new Pkt4(DHCPDISCOVER, 0));
+
+    // Decode ethernet, ip and udp headers.
+    decodeEthernetHeader(buf, dummy_pkt);
+    decodeIpUdpHeader(buf, dummy_pkt);
+
+    // Decode DHCP data into the Pkt4 object.
+    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(data + buf.getPosition(),
+                                   buf.getLength() - buf.getPosition()));
+
+    // Set the appropriate packet members using data collected from
+    // the decoded headers.
+    pkt->setIndex(iface.getIndex());
+    pkt->setIface(iface.getName());
+    pkt->setLocalAddr(dummy_pkt->getLocalAddr());
+    pkt->setRemoteAddr(dummy_pkt->getRemoteAddr());
+    pkt->setLocalPort(dummy_pkt->getLocalPort());
+    pkt->setRemotePort(dummy_pkt->getRemotePort());
+    pkt->setLocalHWAddr(dummy_pkt->getLocalHWAddr());
+    pkt->setRemoteHWAddr(dummy_pkt->getRemoteHWAddr());
+
+    return (pkt);
+}
+
+/// @brief Writes the Ethernet frame carrying a DHCPv4 packet.
+///
+/// @param iface interface to be used to send packet
+/// @param pkt packet to be sent
+/// @param buf buffer the frame is written to
+void
+writeFrame(const Iface& iface, const Pkt4Ptr& pkt, isc::util::OutputBuffer& buf) {
+    // Some interfaces may have no HW address - e.g. loopback interface.
+    // For these interfaces the HW address length is 0. If this is the case,
+    // then we will rely on the functions which construct the IP/UDP headers
+    // to provide a default HW addres. Otherwise, create the HW address
+    // object using the HW address of the interface.
+    if (iface.getMacLen() > 0) {
+        HWAddrPtr hwaddr(new HWAddr(iface.getMac(), iface.getMacLen(),
+                                    iface.getHWType()));
+        pkt->setLocalHWAddr(hwaddr);
+    }
+
+
+    // Ethernet frame header.
+    // Note that we don't validate whether HW addresses in 'pkt'
+    // are valid because they are checked by the function called.
+    writeEthernetHeader(pkt, buf);
+
+    // IP and UDP header
+    writeIpUdpHeader(pkt, buf);
+
+    // DHCPv4 message
+    buf.writeData(pkt->getBuffer().getData(), pkt->getBuffer().getLength());
+}
+
+/// @brief Returns the link-layer address the frames are sent to.
+///
+/// @param iface interface to be used to send packets
+///
+/// @return the address structure.
+sockaddr_ll
+getSendAddress(const Iface& iface) {
+    sockaddr_ll sa;
+    memset(&sa, 0x0, sizeof(sa));
+    sa.sll_family = AF_PACKET;
+    sa.sll_ifindex = iface.getIndex();
+    sa.sll_protocol = htons(ETH_P_IP);
+    sa.sll_halen = 6;
+    return (sa);
+}
+
 }
 
 using namespace isc::util;
@@ -128,6 +273,298 @@ using namespace isc::util;
 namespace isc {
 namespace dhcp {
 
+/// The RX ring is made of blocks filled by the kernel with the received
+/// frames, the TX ring of fixed size frames written by the server. Both
+/// are mapped in a single memory region, the RX ring first.
+///
+/// A block or frame is owned by the kernel or by the server according to
+/// its status word, which is accessed with acquire and release semantics
+/// as it is shared with the kernel.
+struct PktFilterLPF::PacketRing {
+
+    /// @brief Constructor.
+    ///
+    /// Switches the socket to TPACKET_V3, sets the rings up and maps them.
+    /// The TX ring is optional as older kernels do not support it with
+    /// TPACKET_V3.
+    ///
+    /// @param sockfd socket descriptor.
+    ///
+    /// @throw SocketConfigError when the RX ring can't be set up.
+    explicit PacketRing(int sockfd)
+        : sockfd_(sockfd), map_(static_cast<uint8_t*>(MAP_FAILED)),
+          map_len_(0), rx_len_(0), block_idx_(0), next_pkt_(0),
+          pkts_left_(0), tx_(0), frame_nr_(0), frame_idx_(0) {
+        int version = TPACKET_V3;
+        if (setsockopt(sockfd, SOL_PACKET, PACKET_VERSION, &version,
+                       sizeof(version)) < 0) {
+            isc_throw(SocketConfigError, "TPACKET_V3 is not supported: "
+                      << strerror(errno));
+        }
+
+        struct tpacket_req3 req;
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size = RING_BLOCK_SIZE;
+        req.tp_block_nr = RX_RING_BLOCK_NR;
+        req.tp_frame_size = RING_FRAME_SIZE;
+        req.tp_frame_nr = RING_BLOCK_SIZE / RING_FRAME_SIZE * RX_RING_BLOCK_NR;
+        req.tp_retire_blk_tov = RX_RING_BLOCK_TIMEOUT;
+        if (setsockopt(sockfd, SOL_PACKET, PACKET_RX_RING, &req,
+                       sizeof(req)) < 0) {
+            isc_throw(SocketConfigError, "failed to set the RX ring up: "
+                      << strerror(errno));
+        }
+        rx_len_ = RING_BLOCK_SIZE * RX_RING_BLOCK_NR;
+
+        size_t tx_len = 0;
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size = RING_BLOCK_SIZE;
+        req.tp_block_nr = TX_RING_BLOCK_NR;
+        req.tp_frame_size = RING_FRAME_SIZE;
+        req.tp_frame_nr = RING_BLOCK_SIZE / RING_FRAME_SIZE * TX_RING_BLOCK_NR;
+        if (setsockopt(sockfd, SOL_PACKET, PACKET_TX_RING, &req,
+                       sizeof(req)) == 0) {
+            tx_len = RING_BLOCK_SIZE * TX_RING_BLOCK_NR;
+            frame_nr_ = req.tp_frame_nr;
+        }
+
+        map_len_ = rx_len_ + tx_len;
+        map_ = static_cast<uint8_t*>(mmap(0, map_len_, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED, sockfd, 0));
+        if (map_ == MAP_FAILED) {
+            const char* errmsg = strerror(errno);
+            // Remove the rings so the socket can be read without them.
+            memset(&req, 0, sizeof(req));
+            setsockopt(sockfd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+            if (tx_len > 0) {
+                setsockopt(sockfd, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req));
+            }
+            isc_throw(SocketConfigError, "failed to map the rings: " << errmsg);
+        }
+        if (tx_len > 0) {
+            tx_ = map_ + rx_len_;
+        }
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Unmaps the rings.
+    ~PacketRing() {
+        if (map_ != MAP_FAILED) {
+            munmap(map_, map_len_);
+        }
+    }
+
+    /// @brief Returns the descriptor of a RX block.
+    ///
+    /// @param idx block index.
+    ///
+    /// @return pointer to the block descriptor.
+    struct tpacket_block_desc* getBlock(size_t idx) const {
+        return (reinterpret_cast<struct tpacket_block_desc*>(map_ + idx * RING_BLOCK_SIZE));
+    }
+
+    /// @brief Returns the next received frame.
+    ///
+    /// The frame stays owned by the server until @c advance is called.
+    ///
+    /// @return pointer to the frame header or null when the ring is empty.
+    const struct tpacket3_hdr* peek() {
+        if (pkts_left_ == 0) {
+            struct tpacket_block_desc* block = getBlock(block_idx_);
+            uint32_t status = __atomic_load_n(&block->hdr.bh1.block_status,
+                                              __ATOMIC_ACQUIRE);
+            if ((status & TP_STATUS_USER) == 0) {
+                return (0);
+            }
+            pkts_left_ = block->hdr.bh1.num_pkts;
+            if (pkts_left_ == 0) {
+                releaseBlock();
+                return (0);
+            }
+            next_pkt_ = reinterpret_cast<uint8_t*>(block) +
+                block->hdr.bh1.offset_to_first_pkt;
+        }
+        return (reinterpret_cast<const struct tpacket3_hdr*>(next_pkt_));
+    }
+
+    /// @brief Moves past the frame returned by @c peek.
+    ///
+    /// The block is given back to the kernel after its last frame.
+    void advance() {
+        if (--pkts_left_ == 0) {
+            releaseBlock();
+        } else {
+            next_pkt_ += reinterpret_cast<const struct tpacket3_hdr*>(next_pkt_)->tp_next_offset;
+        }
+    }
+
+    /// @brief Gives the current block back to the kernel.
+    void releaseBlock() {
+        __atomic_store_n(&getBlock(block_idx_)->hdr.bh1.block_status,
+                         TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        block_idx_ = (block_idx_ + 1) % RX_RING_BLOCK_NR;
+        next_pkt_ = 0;
+        pkts_left_ = 0;
+    }
+
+    /// @brief Writes a frame in the TX ring.
+    ///
+    /// The caller must hold the TX mutex.
+    ///
+    /// @param buf buffer holding the frame.
+    ///
+    /// @return false when there is no free frame in the ring.
+    /// @throw SocketWriteError when the frame is too large.
+    bool putFrame(const OutputBuffer& buf) {
+        if (buf.getLength() > RING_FRAME_SIZE - TX_RING_DATA_OFFSET) {
+            isc_throw(SocketWriteError, "failed to send DHCPv4 packet: "
+                      << buf.getLength() << " bytes frame is too large");
+        }
+        uint8_t* frame = tx_ + frame_idx_ * RING_FRAME_SIZE;
+        struct tpacket3_hdr* hdr = reinterpret_cast<struct tpacket3_hdr*>(frame);
+        uint32_t status = __atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE);
+        if ((status != TP_STATUS_AVAILABLE) &&
+            ((status & TP_STATUS_WRONG_FORMAT) == 0)) {
+            return (false);
+        }
+        memcpy(frame + TX_RING_DATA_OFFSET, buf.getData(), buf.getLength());
+        hdr->tp_len = buf.getLength();
+        hdr->tp_next_offset = 0;
+        __atomic_store_n(&hdr->tp_status, TP_STATUS_SEND_REQUEST,
+                         __ATOMIC_RELEASE);
+        frame_idx_ = (frame_idx_ + 1) % frame_nr_;
+        return (true);
+    }
+
+    /// @brief Asks the kernel to send the frames written in the TX ring.
+    ///
+    /// The caller must hold the TX mutex.
+    ///
+    /// @param sa link-layer address the frames are sent to.
+    ///
+    /// @throw SocketWriteError when the kernel reports an error.
+    void flush(const sockaddr_ll& sa) {
+        if (sendto(sockfd_, 0, 0, 0, reinterpret_cast<const struct sockaddr*>(&sa),
+                   sizeof(sockaddr_ll)) < 0) {
+            isc_throw(SocketWriteError, "failed to send DHCPv4 packet, errno="
+                      << errno << " (check errno.h)");
+        }
+    }
+
+    /// @brief Writes a frame in the TX ring, flushing the ring when full.
+    ///
+    /// The caller must hold the TX mutex.
+    ///
+    /// @param buf buffer holding the frame.
+    /// @param sa link-layer address the frames are sent to.
+    ///
+    /// @throw SocketWriteError when the ring is still full after a flush.
+    void write(const OutputBuffer& buf, const sockaddr_ll& sa) {
+        if (!putFrame(buf)) {
+            flush(sa);
+            if (!putFrame(buf)) {
+                isc_throw(SocketWriteError, "failed to send DHCPv4 packet:"
+                          " the TX ring is full");
+            }
+        }
+    }
+
+    /// @brief Socket descriptor.
+    int sockfd_;
+
+    /// @brief Mapped memory region.
+    uint8_t* map_;
+
+    /// @brief Length of the mapped memory region.
+    size_t map_len_;
+
+    /// @brief Length of the RX ring.
+    size_t rx_len_;
+
+    /// @brief Index of the current RX block.
+    size_t block_idx_;
+
+    /// @brief Next frame in the current RX block.
+    uint8_t* next_pkt_;
+
+    /// @brief Number of frames left in the current RX block.
+    uint32_t pkts_left_;
+
+    /// @brief Start of the TX ring or null when there is no TX ring.
+    uint8_t* tx_;
+
+    /// @brief Number of frames in the TX ring.
+    size_t frame_nr_;
+
+    /// @brief Index of the next TX frame.
+    size_t frame_idx_;
+
+    /// @brief Mutex to serialize the writers of the TX ring.
+    std::mutex tx_mutex_;
+};
+
+PktFilterLPF::PktFilterLPF(bool use_ring)
+    : use_ring_(use_ring) {
+}
+
+PktFilterLPF::~PktFilterLPF() {
+}
+
+bool
+PktFilterLPF::hasRxRing(int sockfd) const {
+    return (static_cast<bool>(getRing(sockfd)));
+}
+
+bool
+PktFilterLPF::hasTxRing(int sockfd) const {
+    PacketRingPtr ring = getRing(sockfd);
+    return (ring && ring->tx_);
+}
+
+PktFilterLPF::PacketRingPtr
+PktFilterLPF::getRing(int sockfd) const {
+    if (!use_ring_) {
+        return (PacketRingPtr());
+    }
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    auto ring = rings_.find(sockfd);
+    if (ring == rings_.end()) {
+        return (PacketRingPtr());
+    }
+    return (ring->second);
+}
+
+void
+PktFilterLPF::releaseSocket(int sockfd) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.erase(sockfd);
+}
+
+void
+PktFilterLPF::setupRing(int sockfd) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+
+    // The sockets closed without being released (e.g. by Iface::delSocket)
+    // keep their rings, so they are released here. A descriptor being
+    // reused means its previous socket was closed.
+    for (auto ring = rings_.begin(); ring != rings_.end(); ) {
+        if ((ring->first == sockfd) ||
+            ((fcntl(ring->first, F_GETFD) < 0) && (errno == EBADF))) {
+            ring = rings_.erase(ring);
+        } else {
+            ++ring;
+        }
+    }
+
+    try {
+        rings_[sockfd].reset(new PacketRing(sockfd));
+    } catch (const SocketConfigError&) {
+        // Use the socket without rings.
+        rings_.erase(sockfd);
+    }
+}
+
 bool
 PktFilterLPF::isSocketReceivedTimeSupported() const {
 #ifdef SO_TIMESTAMP
@@ -197,6 +634,11 @@ PktFilterLPF::openSocket(Iface& iface,
     }
 #endif
 
+    // Set the memory-mapped rings up before frames are queued on the socket.
+    if (use_ring_) {
+        setupRing(sock);
+    }
+
     struct sockaddr_ll sa;
     memset(&sa, 0, sizeof(sockaddr_ll));
     sa.sll_family = AF_PACKET;
@@ -232,27 +674,18 @@ PktFilterLPF::openSocket(Iface& iface,
 
 Pkt4Ptr
 PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
-    uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
-    // First let's get some data from the fallback socket. The data will be
-    // discarded but we don't want the socket buffer to bloat. We get the
-    // packets from the socket in loop but most of the time the loop will
-    // end after receiving one packet. The call to recv returns immediately
-    // when there is no data left on the socket because the socket is
-    // non-blocking.
-    // @todo In the normal conditions, both the primary socket and the fallback
-    // socket are in sync as they are set to receive packets on the same
-    // address and port. The reception of packets on the fallback socket
-    // shouldn't cause significant lags in packet reception. If we find in the
-    // future that it does, the sort of threshold could be set for the maximum
-    // bytes received on the fallback socket in a single round. Further
-    // optimizations would include an asynchronous read from the fallback socket
-    // when the DHCP server is idle.
-    int datalen;
-    do {
-        datalen = recv(socket_info.fallbackfd_, raw_buf, sizeof(raw_buf), 0);
-    } while (datalen > 0);
+    // First let's get some data from the fallback socket.
+    drainFallbackSocket(socket_info);
+
+    // With a RX ring, the frames are read from the mapped memory.
+    PacketRingPtr ring = getRing(socket_info.sockfd_);
+    if (ring) {
+        return (receiveFromRing(iface, *ring));
+    }
 
 #ifndef SO_TIMESTAMP
+    uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
+
     // Now that we finished getting data from the fallback socket, we
     // have to get the data from the raw socket too.
     int data_len = read(socket_info.sockfd_, raw_buf, sizeof(raw_buf));
@@ -265,7 +698,7 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
         return Pkt4Ptr();
     }
 
-    InputBuffer buf(raw_buf, data_len);
+    Pkt4Ptr pkt = makeReceivedPacket(iface, raw_buf, data_len);
 #else
     const size_t CONTROL_BUF_LEN = 512;
     uint8_t msg_buf[IfaceMgr::RCVBUFSIZE];
@@ -297,46 +730,8 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
         isc_throw(SocketReadError, "Pkt4FilterLpf to receive UDP4 data");
     }
 
-    InputBuffer buf(msg_buf, result);
-#endif
+    Pkt4Ptr pkt = makeReceivedPacket(iface, msg_buf, result);
 
-    // @todo: This is awkward way to solve the chicken and egg problem
-    // whereby we don't know the offset where DHCP data start in the
-    // received buffer when we create the packet object. In general case,
-    // the IP header has variable length. The information about its length
-    // is stored in one of its fields. Therefore, we have to decode the
-    // packet to get the offset of the DHCP data. The dummy object is
-    // created so as we can pass it to the functions which decode IP stack
-    // and find actual offset of the DHCP data.
-    // Once we find the offset we can create another Pkt4 object from
-    // the reminder of the input buffer and set the IP addresses and
-    // ports from the dummy packet. We should consider doing it
-    // in some more elegant way.
-    Pkt4Ptr dummy_pkt = Pkt4Ptr(new Pkt4(DHCPDISCOVER, 0));
-
-    // Decode ethernet, ip and udp headers.
-    decodeEthernetHeader(buf, dummy_pkt);
-    decodeIpUdpHeader(buf, dummy_pkt);
-
-    // Read the DHCP data.
-    std::vector<uint8_t> dhcp_buf;
-    buf.readVector(dhcp_buf, buf.getLength() - buf.getPosition());
-
-    // Decode DHCP data into the Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(&dhcp_buf[0], dhcp_buf.size()));
-
-    // Set the appropriate packet members using data collected from
-    // the decoded headers.
-    pkt->setIndex(iface.getIndex());
-    pkt->setIface(iface.getName());
-    pkt->setLocalAddr(dummy_pkt->getLocalAddr());
-    pkt->setRemoteAddr(dummy_pkt->getRemoteAddr());
-    pkt->setLocalPort(dummy_pkt->getLocalPort());
-    pkt->setRemotePort(dummy_pkt->getRemotePort());
-    pkt->setLocalHWAddr(dummy_pkt->getLocalHWAddr());
-    pkt->setRemoteHWAddr(dummy_pkt->getRemoteHWAddr());
-
-#ifdef SO_TIMESTAMP
     struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
     while (cmsg != NULL) {
         if ((cmsg->cmsg_level == SOL_SOCKET) &&
@@ -358,42 +753,86 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     return (pkt);
 }
 
-int
-PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
+Pkt4Ptr
+PktFilterLPF::receiveFromRing(Iface& iface, PacketRing& ring) {
+    const struct tpacket3_hdr* hdr = ring.peek();
+    if (!hdr) {
+        return (Pkt4Ptr());
+    }
 
-    OutputBuffer buf(14);
+    // The frame is given back to the kernel even when it can't be decoded.
+    Pkt4Ptr pkt;
+    try {
+        pkt = makeReceivedPacket(iface,
+                                 reinterpret_cast<const uint8_t*>(hdr) + hdr->tp_mac,
+                                 hdr->tp_snaplen);
+    } catch (...) {
+        ring.advance();
+        throw;
+    }
 
-    // Some interfaces may have no HW address - e.g. loopback interface.
-    // For these interfaces the HW address length is 0. If this is the case,
-    // then we will rely on the functions which construct the IP/UDP headers
-    // to provide a default HW addres. Otherwise, create the HW address
-    // object using the HW address of the interface.
-    if (iface.getMacLen() > 0) {
-        HWAddrPtr hwaddr(new HWAddr(iface.getMac(), iface.getMacLen(),
-                                    iface.getHWType()));
-        pkt->setLocalHWAddr(hwaddr);
+    // The kernel time stamps the frames in the ring.
+    struct timeval ring_time;
+    ring_time.tv_sec = hdr->tp_sec;
+    ring_time.tv_usec = hdr->tp_nsec / 1000;
+    pkt->addPktEvent(PktEvent::SOCKET_RECEIVED, ring_time);
+    ring.advance();
+
+    // Set time packet was read from the buffer.
+    pkt->addPktEvent(PktEvent::BUFFER_READ);
+
+    return (pkt);
+}
+
+bool
+PktFilterLPF::isReadable(const SocketInfo& socket_info) {
+    if (getRing(socket_info.sockfd_)) {
+        return (true);
     }
+    return (PktFilter::isReadable(socket_info));
+}
 
+size_t
+PktFilterLPF::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                           size_t max_count, std::vector<Pkt4Ptr>& pkts) {
+    PacketRingPtr ring = getRing(socket_info.sockfd_);
+    if (!ring) {
+        return (PktFilter::receiveBatch(iface, socket_info, max_count, pkts));
+    }
 
-    // Ethernet frame header.
-    // Note that we don't validate whether HW addresses in 'pkt'
-    // are valid because they are checked by the function called.
-    writeEthernetHeader(pkt, buf);
+    drainFallbackSocket(socket_info);
 
-    // IP and UDP header
-    writeIpUdpHeader(pkt, buf);
+    size_t count = 0;
+    while (count < max_count) {
+        Pkt4Ptr pkt = receiveFromRing(iface, *ring);
+        if (!pkt) {
+            break;
+        }
+        pkts.push_back(pkt);
+        ++count;
+    }
+    return (count);
+}
 
-    // DHCPv4 message
-    buf.writeData(pkt->getBuffer().getData(), pkt->getBuffer().getLength());
+int
+PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
 
-    sockaddr_ll sa;
-    memset(&sa, 0x0, sizeof(sa));
-    sa.sll_family = AF_PACKET;
-    sa.sll_ifindex = iface.getIndex();
-    sa.sll_protocol = htons(ETH_P_IP);
-    sa.sll_halen = 6;
+    OutputBuffer buf(14);
+    writeFrame(iface, pkt, buf);
+
+    sockaddr_ll sa = getSendAddress(iface);
 
     pkt->addPktEvent(PktEvent::RESPONSE_SENT);
+
+    // With a TX ring, the frame is written in the mapped memory.
+    PacketRingPtr ring = getRing(sockfd);
+    if (ring && ring->tx_) {
+        std::lock_guard<std::mutex> lock(ring->tx_mutex_);
+        ring->write(buf, sa);
+        ring->flush(sa);
+        return (0);
+    }
+
     int result = sendto(sockfd, buf.getData(), buf.getLength(), 0,
                         reinterpret_cast<const struct sockaddr*>(&sa),
                         sizeof(sockaddr_ll));
@@ -406,5 +845,48 @@ PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
 
 }
 
+size_t
+PktFilterLPF::sendBatch(const Iface& iface, uint16_t sockfd,
+                        const std::vector<Pkt4Ptr>& pkts,
+                        std::vector<std::string>& errors) {
+    PacketRingPtr ring = getRing(sockfd);
+    if (!ring || !ring->tx_) {
+        return (PktFilter::sendBatch(iface, sockfd, pkts, errors));
+    }
+
+    // Write all frames in the ring and send them at once.
+    errors.assign(pkts.size(), std::string());
+    sockaddr_ll sa = getSendAddress(iface);
+    std::lock_guard<std::mutex> lock(ring->tx_mutex_);
+    for (size_t i = 0; i < pkts.size(); ++i) {
+        try {
+            OutputBuffer buf(14);
+            writeFrame(iface, pkts[i], buf);
+            ring->write(buf, sa);
+        } catch (const std::exception& ex) {
+            errors[i] = ex.what();
+        }
+    }
+    try {
+        ring->flush(sa);
+    } catch (const std::exception& ex) {
+        for (auto& error : errors) {
+            if (error.empty()) {
+                error = ex.what();
+            }
+        }
+        return (0);
+    }
+
+    size_t sent = 0;
+    for (size_t i = 0; i < pkts.size(); ++i) {
+        if (errors[i].empty()) {
+            pkts[i]->addPktEvent(PktEvent::RESPONSE_SENT);
+            ++sent;
+        }
+    }
+    return (sent);
+}
+
 } // end of isc::dhcp namespace
 } // end of isc namespace
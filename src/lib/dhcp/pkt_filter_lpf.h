@@ -11,6 +11,11 @@
 
 #include <util/buffer.h>
 
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <mutex>
+
 namespace isc {
 namespace dhcp {
 
@@ -20,9 +25,47 @@ namespace dhcp {
 /// sockets and Linux Packet Filtering. It is used by @c isc::dhcp::IfaceMgr
 /// to send DHCPv4 messages to the hosts which don't have an IPv4 address
 /// assigned yet.
+///
+/// Optionally, the raw sockets use memory-mapped TPACKET_V3 rings
+/// (PACKET_MMAP) shared with the kernel. Received frames are then read
+/// from the RX ring blocks without a system call per frame and copied only
+/// once into the @c Pkt4, and responses are written in the TX ring frames
+/// which are sent by a single system call. When the kernel does not support
+/// the rings, the socket is read and written as without them.
 class PktFilterLPF : public PktFilter {
 public:
 
+    /// @brief Constructor.
+    ///
+    /// @param use_ring Use memory-mapped rings on the sockets.
+    explicit PktFilterLPF(bool use_ring = false);
+
+    /// @brief Destructor.
+    ///
+    /// Unmaps the rings.
+    virtual ~PktFilterLPF();
+
+    /// @brief Check if the memory-mapped rings are used.
+    ///
+    /// @return true when the sockets are opened with rings.
+    bool isRingEnabled() const {
+        return (use_ring_);
+    }
+
+    /// @brief Check if the socket has a memory-mapped RX ring.
+    ///
+    /// @param sockfd socket descriptor.
+    ///
+    /// @return true when the socket is read from an RX ring.
+    bool hasRxRing(int sockfd) const;
+
+    /// @brief Check if the socket has a memory-mapped TX ring.
+    ///
+    /// @param sockfd socket descriptor.
+    ///
+    /// @return true when the socket is written through a TX ring.
+    bool hasTxRing(int sockfd) const;
+
     /// @brief Check if packet can be sent to the host without address directly.
     ///
     /// This class supports direct responses to the host without address.
@@ -64,6 +107,32 @@ public:
     /// @return Received packet
     virtual Pkt4Ptr receive(Iface& iface, const SocketInfo& socket_info);
 
+    /// @brief Checks if a packet can be received over specified socket.
+    ///
+    /// The frames of an RX ring are not queued on the socket so FIONREAD
+    /// reports nothing for them: when select() reports a socket with an
+    /// RX ring readable, the kernel released a block of the ring.
+    ///
+    /// @param socket_info structure holding socket information
+    ///
+    /// @return true if the socket has an RX ring or data is queued on it.
+    /// @throw isc::dhcp::SocketReadError if the check failed.
+    virtual bool isReadable(const SocketInfo& socket_info);
+
+    /// @brief Receive up to a number of packets over specified socket.
+    ///
+    /// With an RX ring, the packets are taken from the blocks released by
+    /// the kernel. Otherwise, a single packet is received.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param max_count maximum number of packets to receive
+    /// @param [out] pkts received packets are appended to this vector
+    ///
+    /// @return number of received packets.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                size_t max_count, std::vector<Pkt4Ptr>& pkts);
+
     /// @brief Send packet over specified socket.
     ///
     /// @param iface interface to be used to send packet
@@ -75,6 +144,66 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt);
 
+    /// @brief Send packets over specified socket.
+    ///
+    /// With a TX ring, all packets are written in the ring and sent by
+    /// one system call. Otherwise, they are sent one by one.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    /// @param [out] errors error message of each packet, empty for the
+    /// sent packets.
+    ///
+    /// @return number of sent packets.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts,
+                             std::vector<std::string>& errors);
+
+    /// @brief Releases the rings of a socket.
+    ///
+    /// @param sockfd socket descriptor
+    virtual void releaseSocket(int sockfd);
+
+private:
+
+    /// @brief Memory-mapped RX and TX rings of a socket.
+    struct PacketRing;
+
+    /// @brief Pointer to the rings of a socket.
+    typedef boost::shared_ptr<PacketRing> PacketRingPtr;
+
+    /// @brief Returns the rings of a socket.
+    ///
+    /// @param sockfd socket descriptor.
+    ///
+    /// @return pointer to the rings or null if the socket has none.
+    PacketRingPtr getRing(int sockfd) const;
+
+    /// @brief Sets the rings up on a new socket.
+    ///
+    /// Failures are not fatal: the socket is then used without rings.
+    /// The rings of the sockets which were closed since are released.
+    ///
+    /// @param sockfd socket descriptor.
+    void setupRing(int sockfd);
+
+    /// @brief Receives a packet from the RX ring.
+    ///
+    /// @param iface interface
+    /// @param ring rings of the socket
+    ///
+    /// @return received packet or null when the ring is empty.
+    Pkt4Ptr receiveFromRing(Iface& iface, PacketRing& ring);
+
+    /// @brief Indicates if the sockets use memory-mapped rings.
+    bool use_ring_;
+
+    /// @brief Rings by socket descriptor.
+    std::map<int, PacketRingPtr> rings_;
+
+    /// @brief Mutex to protect the rings map against concurrent access.
+    mutable std::mutex rings_mutex_;
 };
 
 } // namespace isc::dhcp
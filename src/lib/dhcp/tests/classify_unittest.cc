@@ -291,3 +291,83 @@ TEST(ClassifyTest, ClientClassesIntersects) {
     EXPECT_TRUE(classes1.intersects(classes2));
     EXPECT_TRUE(classes2.intersects(classes1));
 }
+
+// Check that the class names are interned into stable identifiers.
+TEST(ClassifyTest, InternClass) {
+    ClientClassId id;
+    EXPECT_FALSE(ClientClasses::getClassId("intern-one", id));
+
+    auto count = ClientClasses::getInternedClassCount();
+    auto id1 = ClientClasses::internClass("intern-one");
+    auto id2 = ClientClasses::internClass("intern-two");
+    EXPECT_NE(id1, id2);
+    EXPECT_EQ(count + 2, ClientClasses::getInternedClassCount());
+
+    // Interning the same name again returns the same identifier.
+    EXPECT_EQ(id1, ClientClasses::internClass("intern-one"));
+    EXPECT_EQ(count + 2, ClientClasses::getInternedClassCount());
+
+    ASSERT_TRUE(ClientClasses::getClassId("intern-two", id));
+    EXPECT_EQ(id2, id);
+
+    // Inserting a class name does not intern it.
+    ClientClasses classes;
+    classes.insert("intern-three");
+    EXPECT_FALSE(ClientClasses::getClassId("intern-three", id));
+    EXPECT_EQ(count + 2, ClientClasses::getInternedClassCount());
+}
+
+// Check that the intersection works with interned and not interned classes.
+TEST(ClassifyTest, ClientClassesIntersectsInterned) {
+    ClientClasses::internClass("intersect-one");
+    ClientClasses::internClass("intersect-two");
+
+    // A requirement with interned classes only.
+    ClientClasses required;
+    required.insert("intersect-one");
+    required.insert("intersect-two");
+
+    // Interned on both sides.
+    ClientClasses classes;
+    classes.insert("intersect-foo");
+    EXPECT_FALSE(required.intersects(classes));
+    EXPECT_FALSE(classes.intersects(required));
+    classes.insert("intersect-two");
+    EXPECT_TRUE(required.intersects(classes));
+    EXPECT_TRUE(classes.intersects(required));
+
+    // Not interned on both sides.
+    ClientClasses classes1("intersect-bar, intersect-baz");
+    ClientClasses classes2("intersect-baz");
+    EXPECT_TRUE(classes1.intersects(classes2));
+    EXPECT_TRUE(classes2.intersects(classes1));
+    EXPECT_FALSE(required.intersects(classes1));
+
+    // The class is interned after it was inserted in one container.
+    ClientClasses late("intersect-late");
+    ClientClasses::internClass("intersect-late");
+    ClientClasses late_required("intersect-late");
+    EXPECT_TRUE(late.intersects(late_required));
+    EXPECT_TRUE(late_required.intersects(late));
+
+    // Erased classes no longer intersect.
+    classes.erase("intersect-two");
+    EXPECT_FALSE(required.intersects(classes));
+    EXPECT_FALSE(classes.intersects(required));
+    late.erase("intersect-late");
+    EXPECT_FALSE(late.intersects(late_required));
+    EXPECT_FALSE(late_required.intersects(late));
+
+    // Copies keep the bitset.
+    classes.insert("intersect-one");
+    ClientClasses copy(classes);
+    EXPECT_TRUE(copy.intersects(required));
+    ClientClasses assigned;
+    assigned = classes;
+    EXPECT_TRUE(assigned.intersects(required));
+    EXPECT_TRUE(assigned == classes);
+
+    // Cleared containers do not intersect.
+    assigned.clear();
+    EXPECT_FALSE(assigned.intersects(required));
+}
@@ -12,6 +12,9 @@
 #include <dhcp/option.h>
 #include <dhcp/pkt6.h>
 #include <dhcp/pkt_filter.h>
+#if defined(OS_LINUX)
+#include <dhcp/pkt_filter_lpf.h>
+#endif
 #include <dhcp/testutils/iface_mgr_test_config.h>
 #include <dhcp/tests/pkt_filter6_test_utils.h>
 #include <dhcp/tests/packet_queue_testutils.h>
@@ -25,6 +28,7 @@
 #include <functional>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -191,9 +195,19 @@ public:
         return (0);
     }
 
+    /// @brief Records the released socket.
+    ///
+    /// @param sockfd socket descriptor
+    virtual void releaseSocket(int sockfd) {
+        released_sockets_.push_back(sockfd);
+    }
+
     /// Holds the information whether openSocket was called on this
     /// object after its creation.
     bool open_socket_called_;
+
+    /// Holds the descriptors of the released sockets.
+    std::vector<int> released_sockets_;
 };
 
 class NakedIfaceMgr: public IfaceMgr {
@@ -496,6 +510,13 @@ public:
         ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET6));
         ASSERT_TRUE(queue_enabled == ifacemgr->isDHCPReceiverRunning());
 
+        // In the per-socket mode there is one receiver per open socket.
+        if (queue_enabled && ifacemgr->isDHCPReceiverPerSocket()) {
+            EXPECT_EQ(2, ifacemgr->getDHCPSocketReceiverCount());
+        } else {
+            EXPECT_EQ(0, ifacemgr->getDHCPSocketReceiverCount());
+        }
+
         // If the thread is already running, trying to start it again should fail.
         if (queue_enabled) {
             ASSERT_THROW(ifacemgr->startDHCPReceiver(AF_INET6), InvalidOperation);
@@ -582,6 +603,13 @@ public:
         ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
         ASSERT_TRUE(queue_enabled == ifacemgr->isDHCPReceiverRunning());
 
+        // In the per-socket mode there is one receiver per open socket.
+        if (queue_enabled && ifacemgr->isDHCPReceiverPerSocket()) {
+            EXPECT_EQ(1, ifacemgr->getDHCPSocketReceiverCount());
+        } else {
+            EXPECT_EQ(0, ifacemgr->getDHCPSocketReceiverCount());
+        }
+
         // If the thread is already running, trying to start it again should fail.
         if (queue_enabled) {
             ASSERT_THROW(ifacemgr->startDHCPReceiver(AF_INET), InvalidOperation);
@@ -1590,6 +1618,15 @@ TEST_F(IfaceMgrTest, sendReceive6) {
     // Queuing enabled, indirection reception should work.
     queue_control = makeQueueConfig(PacketQueueMgr6::DEFAULT_QUEUE_TYPE6, 500, true);
     sendReceive6Test(queue_control, true);
+
+    // Per-socket receivers, indirect reception should work too.
+    queue_control->set("receiver-per-socket", data::Element::create(true));
+    sendReceive6Test(queue_control, true);
+
+    // Batched receive and send, the packet is sent by send itself.
+    queue_control->set("receive-batch-size", data::Element::create(8));
+    queue_control->set("send-batch-size", data::Element::create(8));
+    sendReceive6Test(queue_control, true);
 }
 
 // Verifies that basic DHCPv4 packet send and receive operates
@@ -1609,6 +1646,165 @@ TEST_F(IfaceMgrTest, sendReceive4) {
     // Queuing enabled, indirection reception should work.
     queue_control = makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
     sendReceive4Test(queue_control, true);
+
+    // Per-socket receivers, indirect reception should work too.
+    queue_control->set("receiver-per-socket", data::Element::create(true));
+    sendReceive4Test(queue_control, true);
+
+    // Batched receive and send, the packet is sent by send itself.
+    queue_control->set("receive-batch-size", data::Element::create(8));
+    queue_control->set("send-batch-size", data::Element::create(8));
+    sendReceive4Test(queue_control, true);
+}
+
+// Verifies that the batch sizes are read from the queue control and
+// that invalid values are rejected.
+TEST_F(IfaceMgrTest, configureBatchSizes) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // Default is no batching.
+    EXPECT_EQ(1, ifacemgr->getReceiveBatchSize());
+    EXPECT_EQ(1, ifacemgr->getSendBatchSize());
+
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("receive-batch-size", data::Element::create(16));
+    queue_control->set("send-batch-size", data::Element::create(4));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(16, ifacemgr->getReceiveBatchSize());
+    EXPECT_EQ(4, ifacemgr->getSendBatchSize());
+
+    // Batch sizes are ignored when the queue is disabled.
+    queue_control->set("enable-queue", data::Element::create(false));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(1, ifacemgr->getReceiveBatchSize());
+    EXPECT_EQ(1, ifacemgr->getSendBatchSize());
+
+    // Zero is not a valid batch size.
+    queue_control->set("enable-queue", data::Element::create(true));
+    queue_control->set("send-batch-size", data::Element::create(0));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 BadValue);
+}
+
+/// @brief Packet filter recording the batches it sends.
+class BatchPktFilter : public TestPktFilter {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param failed_transid transaction id of the packet failing to
+    /// be sent.
+    BatchPktFilter(uint32_t failed_transid)
+        : failed_transid_(failed_transid) {
+    }
+
+    /// @brief Pretends to send a batch of packets.
+    ///
+    /// It waits a bit so the other threads queue their packets, and
+    /// fails to send the packet with the failed transaction id.
+    virtual size_t sendBatch(const Iface&, uint16_t,
+                             const std::vector<Pkt4Ptr>& pkts,
+                             std::vector<std::string>& errors) {
+        usleep(20000);
+        errors.assign(pkts.size(), std::string());
+        size_t sent = 0;
+        for (size_t i = 0; i < pkts.size(); ++i) {
+            if (pkts[i]->getTransid() == failed_transid_) {
+                errors[i] = "test send error";
+            } else {
+                ++sent;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        batches_.push_back(pkts.size());
+        return (sent);
+    }
+
+    /// @brief Transaction id of the packet failing to be sent.
+    uint32_t failed_transid_;
+
+    /// @brief Protects the batch sizes.
+    std::mutex mutex_;
+
+    /// @brief Sizes of the sent batches.
+    std::vector<size_t> batches_;
+};
+
+// Verifies that the packets sent concurrently with send batching are
+// grouped, that send returns once its packet was sent and that a send
+// failure is reported to the sender of the failed packet only.
+TEST_F(IfaceMgrTest, sendBatched4) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    boost::shared_ptr<BatchPktFilter> filter(new BatchPktFilter(3));
+    ASSERT_NO_THROW(ifacemgr->setPacketFilter(filter));
+
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("send-batch-size", data::Element::create(4));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    ASSERT_NO_THROW(ifacemgr->openSocket(LOOPBACK_NAME, IOAddress("127.0.0.1"),
+                                         DHCP4_SERVER_PORT + 10000));
+
+    // Send packets from several threads. The result of a thread is 1
+    // when send returned true and 2 when it threw.
+    const size_t count = 8;
+    std::vector<int> results(count, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; ++i) {
+        threads.push_back(std::thread([&ifacemgr, &results, i]() {
+            Pkt4Ptr pkt(new Pkt4(DHCPOFFER, i + 1));
+            pkt->setIface(LOOPBACK_NAME);
+            pkt->setIndex(LOOPBACK_INDEX);
+            pkt->setLocalAddr(IOAddress("127.0.0.1"));
+            pkt->setRemoteAddr(IOAddress("127.0.0.1"));
+            try {
+                results[i] = (ifacemgr->send(pkt) ? 1 : 0);
+            } catch (const SocketWriteError&) {
+                results[i] = 2;
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(i + 1 == 3 ? 2 : 1, results[i]) << "packet " << i + 1;
+    }
+
+    // All packets went through the filter in batches of at most 4
+    // packets, and the packets queued while a batch was sent were
+    // grouped.
+    size_t total = 0;
+    for (auto const& batch : filter->batches_) {
+        EXPECT_GE(4, batch);
+        total += batch;
+    }
+    EXPECT_EQ(count, total);
+    EXPECT_GT(count, filter->batches_.size());
+
+    ifacemgr->closeSockets();
+}
+
+// Verifies that the memory-mapped rings are enabled from the queue control
+// even when queueing is disabled.
+TEST_F(IfaceMgrTest, configurePacketMmap) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // Disabled by default.
+    EXPECT_FALSE(ifacemgr->isPacketMmap());
+
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    queue_control->set("packet-mmap", data::Element::create(true));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_TRUE(ifacemgr->isPacketMmap());
+
+    // Reset when the parameter is not specified.
+    data::ConstElementPtr no_queue_control;
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, no_queue_control));
+    EXPECT_FALSE(ifacemgr->isPacketMmap());
 }
 
 // Verifies that it is possible to set custom packet filter object
@@ -1651,6 +1847,10 @@ TEST_F(IfaceMgrTest, setPacketFilter) {
     // So, let's close the open sockets and retry. Now it should succeed.
     iface_mgr->closeSockets();
     EXPECT_NO_THROW(iface_mgr->setPacketFilter(custom_packet_filter));
+
+    // The packet filter was told the socket was closed.
+    ASSERT_EQ(1, custom_packet_filter->released_sockets_.size());
+    EXPECT_EQ(255, custom_packet_filter->released_sockets_[0]);
 }
 
 // This test checks that the default packet filter for DHCPv6 can be replaced
@@ -1770,6 +1970,59 @@ TEST_F(IfaceMgrTest, checkPacketFilterRawSocket) {
     }
 }
 
+#if defined OS_LINUX
+
+// Verifies that the receiver thread reads the DHCPv4 packets from the
+// memory-mapped RX ring of a raw socket. FIONREAD reports no data on
+// such a socket so the receiver must not rely on it.
+TEST_F(IfaceMgrTest, receive4PacketMmapQueued) {
+    SKIP_IF(getuid() != 0);
+
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    boost::shared_ptr<PktFilterLPF> filter(new PktFilterLPF(true));
+    ASSERT_NO_THROW(ifacemgr->setPacketFilter(filter));
+
+    IOAddress lo_addr("127.0.0.1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   DHCP4_SERVER_PORT + 10000));
+    ASSERT_GE(socket1, 0);
+    ASSERT_TRUE(filter->hasRxRing(socket1));
+
+    // Receive the packets through the receiver thread.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("packet-mmap", data::Element::create(true));
+    ASSERT_TRUE(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
+    ASSERT_TRUE(ifacemgr->isDHCPReceiverRunning());
+
+    // Send a packet to the server port: the raw socket sees it on the
+    // loopback interface.
+    Pkt4Ptr send_pkt(new Pkt4(DHCPDISCOVER, 1234));
+    send_pkt->setLocalAddr(lo_addr);
+    send_pkt->setLocalPort(DHCP4_SERVER_PORT + 10000 + 1);
+    send_pkt->setRemotePort(DHCP4_SERVER_PORT + 10000);
+    send_pkt->setRemoteAddr(lo_addr);
+    send_pkt->setIndex(LOOPBACK_INDEX);
+    send_pkt->setIface(string(LOOPBACK_NAME));
+    ASSERT_NO_THROW(send_pkt->pack());
+    ASSERT_TRUE(ifacemgr->send(send_pkt));
+
+    // The kernel releases the ring block holding the frame after a
+    // timeout, the receiver thread must then queue the packet.
+    Pkt4Ptr rcv_pkt;
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(10));
+    ASSERT_TRUE(rcv_pkt);
+    ASSERT_NO_THROW(rcv_pkt->unpack());
+    EXPECT_EQ(send_pkt->getTransid(), rcv_pkt->getTransid());
+
+    ifacemgr->stopDHCPReceiver();
+    ifacemgr->closeSockets();
+}
+
+#endif
+
 #else
 
 // Note: This test will only run on non-Linux and non-BSD systems.
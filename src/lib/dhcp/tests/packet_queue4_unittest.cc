@@ -291,4 +291,46 @@ TEST(TestQueue4, eatPacketsTest) {
     EXPECT_EQ(2, q.getSize());
 }
 
+// Verifies queueing and dequeueing from the lock-free ring buffer
+// including dropping of the oldest packets.
+TEST(PacketQueueLockFreeRing4, enqueueDequeueTest) {
+    // The capacity must be at least MIN_RING_CAPACITY.
+    EXPECT_THROW(PacketQueueLockFreeRing4("kea-lockfree-ring4", 2), BadValue);
+
+    PacketQueue4Ptr q(new PacketQueueLockFreeRing4("kea-lockfree-ring4", 5));
+    EXPECT_TRUE(q->empty());
+    checkInfo(q, "{ \"capacity\": 5, \"queue-type\": \"kea-lockfree-ring4\", \"size\": 0 }");
+
+    // Enqueue seven packets.  The first two should be pushed off.
+    SocketInfo sock1(isc::asiolink::IOAddress("127.0.0.1"), 777, 10);
+    for (unsigned i = 1; i < 8; ++i) {
+        Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, 1000+i));
+        ASSERT_NO_THROW(q->enqueuePacket(pkt, sock1));
+    }
+    checkInfo(q, "{ \"capacity\": 5, \"queue-type\": \"kea-lockfree-ring4\", \"size\": 5 }");
+
+    // We should have transids 1003 to 1007.
+    Pkt4Ptr pkt;
+    for (unsigned i = 3; i < 8; ++i) {
+        ASSERT_NO_THROW(pkt = q->dequeuePacket());
+        ASSERT_TRUE(pkt);
+        EXPECT_EQ(1000 + i, pkt->getTransid());
+    }
+
+    // Queue should be empty and dequeuing should fail safely.
+    ASSERT_TRUE(q->empty());
+    ASSERT_NO_THROW(pkt = q->dequeuePacket());
+    ASSERT_FALSE(pkt);
+
+    // Enqueue three more packets then flush the buffer.
+    for (unsigned i = 0; i < 3; ++i) {
+        Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, 1000+i));
+        ASSERT_NO_THROW(q->enqueuePacket(pkt, sock1));
+    }
+    checkIntStat(q, "size", 3);
+    q->clear();
+    EXPECT_TRUE(q->empty());
+    checkIntStat(q, "size", 0);
+}
+
 } // end of anonymous namespace
@@ -112,6 +112,46 @@ TEST_F(PacketQueueMgr4Test, defaultQueue) {
                       << default_queue_type_ << "\", \"size\": 0 }");
 }
 
+// Verifies that DHCPv4 PQM provides a lock-free queue factory
+TEST_F(PacketQueueMgr4Test, lockFreeQueue) {
+    data::ConstElementPtr config =
+        makeQueueConfig(PacketQueueMgr4::LOCKFREE_QUEUE_TYPE4, 2000);
+    ASSERT_NO_THROW(mgr().createPacketQueue(config));
+    CHECK_QUEUE_INFO (mgr().getPacketQueue(), "{ \"capacity\": 2000, \"queue-type\": \""
+                      << PacketQueueMgr4::LOCKFREE_QUEUE_TYPE4 << "\", \"size\": 0 }");
+}
+
+// Verifies that additional queues can be made from the parameters of the
+// current queue without replacing it.
+TEST_F(PacketQueueMgr4Test, makePacketQueue) {
+    // No current queue so no parameters.
+    ASSERT_FALSE(mgr().getPacketQueueParameters());
+
+    data::ConstElementPtr config = makeQueueConfig(default_queue_type_, 2000);
+    ASSERT_NO_THROW(mgr().createPacketQueue(config));
+    PacketQueue4Ptr current = mgr().getPacketQueue();
+    ASSERT_TRUE(current);
+    ASSERT_TRUE(mgr().getPacketQueueParameters());
+    EXPECT_TRUE(config->equals(*mgr().getPacketQueueParameters()));
+
+    // Make another queue with the same parameters.
+    PacketQueue4Ptr other;
+    ASSERT_NO_THROW(other = mgr().makePacketQueue(mgr().getPacketQueueParameters()));
+    ASSERT_TRUE(other);
+    EXPECT_NE(current, other);
+    EXPECT_EQ(current, mgr().getPacketQueue());
+    CHECK_QUEUE_INFO (other, "{ \"capacity\": 2000, \"queue-type\": \""
+                      << default_queue_type_ << "\", \"size\": 0 }");
+
+    // Unknown types are rejected.
+    config = makeQueueConfig("custom-queue", 2000);
+    ASSERT_THROW(mgr().makePacketQueue(config), InvalidQueueType);
+
+    // Destroying the queue clears the parameters.
+    ASSERT_NO_THROW(mgr().destroyPacketQueue());
+    EXPECT_FALSE(mgr().getPacketQueueParameters());
+}
+
 // Verifies that PQM registry and creation of custom queue implementations.
 TEST_F(PacketQueueMgr4Test, customQueueType) {
 
@@ -101,6 +101,15 @@ TEST_F(PacketQueueMgr6Test, defaultQueue) {
                       << default_queue_type_ << "\", \"size\": 0 }");
 }
 
+// Verifies that DHCPv6 PQM provides a lock-free queue factory
+TEST_F(PacketQueueMgr6Test, lockFreeQueue) {
+    data::ConstElementPtr config =
+        makeQueueConfig(PacketQueueMgr6::LOCKFREE_QUEUE_TYPE6, 2000);
+    ASSERT_NO_THROW(mgr().createPacketQueue(config));
+    CHECK_QUEUE_INFO (mgr().getPacketQueue(), "{ \"capacity\": 2000, \"queue-type\": \""
+                      << PacketQueueMgr6::LOCKFREE_QUEUE_TYPE6 << "\", \"size\": 0 }");
+}
+
 // Verifies that PQM registry and creation of custom queue implementations.
 TEST_F(PacketQueueMgr6Test, customQueueType) {
 
@@ -1616,4 +1616,255 @@ TEST_F(Pkt4Test, PktEvents) {
               "total elapsed: 00:00:00.000150");
 }
 
+// This test verifies that the options are unpacked lazily.
+TEST_F(Pkt4Test, unpackOptionsLazy) {
+    vector<uint8_t> expectedFormat = generateTestPacket2();
+    expectedFormat.push_back(0x63);
+    expectedFormat.push_back(0x82);
+    expectedFormat.push_back(0x53);
+    expectedFormat.push_back(0x63);
+    for (size_t i = 0; i < sizeof(v4_opts); i++) {
+        expectedFormat.push_back(v4_opts[i]);
+    }
+
+    Pkt4Ptr pkt(new Pkt4(&expectedFormat[0], expectedFormat.size()));
+    EXPECT_FALSE(pkt->isLazyUnpack());
+    pkt->setLazyUnpack(true);
+    EXPECT_TRUE(pkt->isLazyUnpack());
+    ASSERT_NO_THROW(pkt->unpack());
+    EXPECT_TRUE(pkt->options_.empty());
+
+    // The raw data of the options is available before they are unpacked.
+    InputBuffer data(0, 0);
+    ASSERT_TRUE(pkt->getOptionData(60, data));
+    ASSERT_EQ(3, data.getLength());
+    EXPECT_EQ(20, data.readUint8());
+    EXPECT_EQ(0x1516, data.readUint16());
+    EXPECT_FALSE(pkt->getOptionData(61, data));
+
+    // The message type is read without unpacking the option.
+    EXPECT_EQ(DHCPOFFER, pkt->getType());
+    EXPECT_TRUE(pkt->options_.empty());
+
+    // Only the requested options are unpacked.
+    EXPECT_TRUE(pkt->getOption(60));
+    EXPECT_EQ(1, pkt->options_.size());
+    EXPECT_FALSE(pkt->getOptionData(60, data));
+    EXPECT_FALSE(pkt->getOption(61));
+    EXPECT_EQ(1, pkt->options_.size());
+
+    verifyParsedOptions(pkt);
+
+    // All the options are unpacked when required.
+    pkt->unpackLazyOptions();
+    EXPECT_EQ(6, pkt->options_.size());
+}
+
+// This test verifies that the lazy unpacking gives the same options as
+// the unpacking of all options.
+TEST_F(Pkt4Test, unpackLazyEquivalence) {
+    vector<Pkt4Ptr> captures = {
+        dhcp::test::PktCaptures::captureRelayedDiscover(),
+        dhcp::test::PktCaptures::captureRelayedDiscover2(),
+        dhcp::test::PktCaptures::discoverWithValidVIVSO(),
+        dhcp::test::PktCaptures::discoverGenexis()
+    };
+    for (auto const& capture : captures) {
+        Pkt4Ptr pkt(new Pkt4(&capture->data_[0], capture->data_.size()));
+        Pkt4Ptr lazy(new Pkt4(&capture->data_[0], capture->data_.size()));
+        lazy->setLazyUnpack(true);
+        ASSERT_NO_THROW_LOG(pkt->unpack());
+        ASSERT_NO_THROW_LOG(lazy->unpack());
+
+        // Deferred options are known after the unpack.
+        EXPECT_EQ(pkt->getDeferredOptions(), lazy->getDeferredOptions());
+
+        // Unpack one option first to check that the order of the options
+        // does not depend on the order of the accesses.
+        EXPECT_EQ(pkt->getType(), lazy->getType());
+        EXPECT_EQ(static_cast<bool>(pkt->getOption(DHO_DHCP_AGENT_OPTIONS)),
+                  static_cast<bool>(lazy->getOption(DHO_DHCP_AGENT_OPTIONS)));
+        EXPECT_EQ(pkt->toText(), lazy->toText());
+        EXPECT_EQ(pkt->getDeferredOptions(), lazy->getDeferredOptions());
+
+        // The options unpacked one by one are the same too.
+        Pkt4Ptr single(new Pkt4(&capture->data_[0], capture->data_.size()));
+        single->setLazyUnpack(true);
+        ASSERT_NO_THROW_LOG(single->unpack());
+        for (auto const& option : pkt->options_) {
+            OptionPtr opt = single->getOption(option.first);
+            ASSERT_TRUE(opt);
+            EXPECT_EQ(option.second->toText(), opt->toText());
+        }
+    }
+}
+
+/// @brief Unpacks a packet and returns how the unpacking ended.
+///
+/// @param pkt The packet.
+/// @return "skip" for a SkipRemainingOptionsError, "parse" for an
+/// OptionParseError, "error" for other errors and "ok" otherwise.
+string
+unpackResult(const Pkt4Ptr& pkt) {
+    try {
+        pkt->unpack();
+    } catch (const SkipRemainingOptionsError&) {
+        return ("skip");
+    } catch (const OptionParseError&) {
+        return ("parse");
+    } catch (const std::exception&) {
+        return ("error");
+    }
+    return ("ok");
+}
+
+// This test verifies that the errors in the options are reported by the
+// lazy unpacking as by the unpacking of all options.
+TEST_F(Pkt4Test, unpackLazyMalformed) {
+    vector<uint8_t> header = generateTestPacket2();
+    header.push_back(0x63);
+    header.push_back(0x82);
+    header.push_back(0x53);
+    header.push_back(0x63);
+
+    struct Scenario {
+        string expected_;
+        vector<uint8_t> options_;
+    };
+    vector<Scenario> scenarios = {
+        // Truncated vendor option: the vendor options are extended after
+        // all the other options.
+        { "skip", { 53, 1, 1, 125, 1, 0, 12, 2, 'a', 'b', 60, 1, 'x' } },
+        // Requested address of 3 bytes: the packet is dropped.
+        { "parse", { 53, 1, 1, 12, 2, 'a', 'b', 50, 3, 1, 2, 3, 60, 1, 'x' } },
+        // Truncated maximum message size.
+        { "parse", { 53, 1, 1, 57, 1, 2, 60, 1, 'x' } },
+        // Fused instances of the message type are unpacked eagerly.
+        { "ok", { 53, 1, 1, 60, 1, 'x', 53, 1, 3 } },
+        // Truncated option and empty host name are ignored.
+        { "ok", { 53, 1, 1, 12, 0, 60, 1, 'x', 55, 3, 1, 3 } },
+        // Deferred option after the failed one.
+        { "parse", { 53, 1, 1, 50, 1, 1, 43, 2, 1, 0 } }
+    };
+    for (auto const& scenario : scenarios) {
+        vector<uint8_t> data = header;
+        data.insert(data.end(), scenario.options_.begin(),
+                    scenario.options_.end());
+        Pkt4Ptr pkt(new Pkt4(&data[0], data.size()));
+        Pkt4Ptr lazy(new Pkt4(&data[0], data.size()));
+        lazy->setLazyUnpack(true);
+        EXPECT_EQ(scenario.expected_, unpackResult(pkt));
+        EXPECT_EQ(scenario.expected_, unpackResult(lazy));
+        EXPECT_EQ(pkt->getDeferredOptions(), lazy->getDeferredOptions());
+        EXPECT_EQ(pkt->toText(), lazy->toText());
+    }
+
+    // The truncated vendor option is not present.
+    Pkt4Ptr capture = dhcp::test::PktCaptures::discoverWithTruncatedVIVSO();
+    Pkt4Ptr pkt(new Pkt4(&capture->data_[0], capture->data_.size()));
+    pkt->setLazyUnpack(true);
+    EXPECT_THROW(pkt->unpack(), SkipRemainingOptionsError);
+    EXPECT_EQ(DHCPDISCOVER, pkt->getType());
+    EXPECT_FALSE(pkt->getOption(DHO_VIVSO_SUBOPTIONS));
+}
+
+// This test verifies the typed views of the options which are not
+// unpacked yet.
+TEST_F(Pkt4Test, getOptionValue) {
+    vector<uint8_t> data = generateTestPacket2();
+    const uint8_t options[] = {
+        0x63, 0x82, 0x53, 0x63,
+        53, 1, 3,                    // Message type
+        57, 2, 0x05, 0xdc,           // Maximum message size
+        51, 4, 0, 0, 0x0e, 0x10,     // Lease time
+        60, 3, 'x', 'y', 'z'         // Class id
+    };
+    data.insert(data.end(), options, options + sizeof(options));
+    Pkt4Ptr pkt(new Pkt4(&data[0], data.size()));
+    pkt->setLazyUnpack(true);
+    ASSERT_NO_THROW(pkt->unpack());
+
+    uint8_t type = 0;
+    EXPECT_TRUE(pkt->getOptionValue(DHO_DHCP_MESSAGE_TYPE, type));
+    EXPECT_EQ(DHCPREQUEST, type);
+    uint16_t size = 0;
+    EXPECT_TRUE(pkt->getOptionValue(DHO_DHCP_MAX_MESSAGE_SIZE, size));
+    EXPECT_EQ(1500, size);
+    uint32_t lifetime = 0;
+    EXPECT_TRUE(pkt->getOptionValue(DHO_DHCP_LEASE_TIME, lifetime));
+    EXPECT_EQ(3600, lifetime);
+
+    // The size must match.
+    EXPECT_FALSE(pkt->getOptionValue(DHO_DHCP_MAX_MESSAGE_SIZE, lifetime));
+    EXPECT_FALSE(pkt->getOptionValue(DHO_VENDOR_CLASS_IDENTIFIER, lifetime));
+
+    // Absent and unpacked options have no view.
+    EXPECT_FALSE(pkt->getOptionValue(DHO_DHCP_RENEWAL_TIME, lifetime));
+    EXPECT_TRUE(pkt->getOption(DHO_DHCP_LEASE_TIME));
+    EXPECT_FALSE(pkt->getOptionValue(DHO_DHCP_LEASE_TIME, lifetime));
+}
+
+// This test verifies that the options added with their on-wire format
+// are packed from it as long as they are in the packet.
+TEST_F(Pkt4Test, addPackedOptions) {
+    Pkt4Ptr pkt(new Pkt4(DHCPACK, 1234));
+    OptionPtr hostname(new OptionString(Option::V4, DHO_HOST_NAME, "host"));
+    pkt->addOption(hostname);
+
+    // The on-wire formats differ from the options so it is possible to
+    // check what is packed.
+    boost::shared_ptr<PackedOptionCollection> options(new PackedOptionCollection());
+    PackedOption packed;
+    packed.option_.reset(new OptionString(Option::V4, DHO_DOMAIN_NAME, "foo"));
+    packed.wire_ = { DHO_DOMAIN_NAME, 3, 'b', 'a', 'r' };
+    options->push_back(packed);
+    packed.option_.reset(new OptionString(Option::V4, DHO_HOST_NAME, "foo"));
+    packed.wire_ = { DHO_HOST_NAME, 3, 'b', 'a', 'r' };
+    options->push_back(packed);
+    packed.option_.reset(new OptionString(Option::V4, DHO_ROOT_PATH, "foo"));
+    packed.wire_.clear();
+    options->push_back(packed);
+    // A long option must be split.
+    string long_path(300, 'x');
+    packed.option_.reset(new OptionString(Option::V4, DHO_MERIT_DUMP, long_path));
+    packed.wire_.assign(302, 'y');
+    options->push_back(packed);
+
+    // The host name is already present.
+    EXPECT_EQ(3, pkt->addPackedOptions(options));
+    EXPECT_EQ(hostname, pkt->getOption(DHO_HOST_NAME));
+    ASSERT_TRUE(pkt->getOption(DHO_DOMAIN_NAME));
+    ASSERT_TRUE(pkt->getOption(DHO_ROOT_PATH));
+
+    ASSERT_NO_THROW(pkt->pack());
+    Pkt4Ptr received(new Pkt4(pkt->getBuffer().getData(),
+                              pkt->getBuffer().getLength()));
+    ASSERT_NO_THROW(received->unpack());
+    OptionPtr opt = received->getOption(DHO_DOMAIN_NAME);
+    ASSERT_TRUE(opt);
+    EXPECT_EQ("bar", opt->toString());
+    opt = received->getOption(DHO_HOST_NAME);
+    ASSERT_TRUE(opt);
+    EXPECT_EQ("host", opt->toString());
+    // An empty on-wire format means the option is packed.
+    opt = received->getOption(DHO_ROOT_PATH);
+    ASSERT_TRUE(opt);
+    EXPECT_EQ("foo", opt->toString());
+    opt = received->getOption(DHO_MERIT_DUMP);
+    ASSERT_TRUE(opt);
+    EXPECT_EQ(long_path, opt->toString());
+
+    // A replaced option is packed.
+    OptionPtr domain_name = pkt->getOption(DHO_DOMAIN_NAME)->clone();
+    pkt->delOption(DHO_DOMAIN_NAME);
+    pkt->addOption(domain_name);
+    ASSERT_NO_THROW(pkt->pack());
+    received.reset(new Pkt4(pkt->getBuffer().getData(),
+                            pkt->getBuffer().getLength()));
+    ASSERT_NO_THROW(received->unpack());
+    opt = received->getOption(DHO_DOMAIN_NAME);
+    ASSERT_TRUE(opt);
+    EXPECT_EQ("foo", opt->toString());
+}
+
 } // end of anonymous namespace
@@ -148,4 +148,50 @@ TEST_F(PktFilterInet6Test, receive) {
     testReceivedPktEvents(rcvd_pkt, pkt_filter.isSocketReceivedTimeSupported());
 }
 
+// This test verifies that a batch of DHCPv6 packets can be sent and
+// received through the socket opened with the PktFilterInet6.
+TEST_F(PktFilterInet6Test, sendReceiveBatch) {
+    // Packets will be sent over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("::1");
+
+    // Create an instance of the class which we are testing.
+    PktFilterInet6 pkt_filter;
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, true);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // Send two copies of the test message at once.
+    std::vector<Pkt6Ptr> pkts = { test_message_, test_message_ };
+    std::vector<std::string> errors;
+    size_t sent = 0;
+    ASSERT_NO_THROW(sent = pkt_filter.sendBatch(iface, sock_info_.sockfd_, pkts,
+                                                errors));
+    ASSERT_EQ(2, sent);
+    ASSERT_EQ(2, errors.size());
+    EXPECT_TRUE(errors[0].empty());
+    EXPECT_TRUE(errors[1].empty());
+
+    // Receive both of them, possibly in more than one batch.
+    std::vector<Pkt6Ptr> rcvd_pkts;
+    for (int i = 0; (i < 10) && (rcvd_pkts.size() < pkts.size()); ++i) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(sock_info_.sockfd_, &readfds);
+
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        ASSERT_GT(select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL, &timeout), 0);
+        ASSERT_NO_THROW(pkt_filter.receiveBatch(sock_info_, 4, rcvd_pkts));
+    }
+    ASSERT_EQ(pkts.size(), rcvd_pkts.size());
+
+    // Check that the received messages are correct.
+    for (auto const& rcvd_pkt : rcvd_pkts) {
+        ASSERT_TRUE(rcvd_pkt);
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+    }
+}
+
 } // anonymous namespace
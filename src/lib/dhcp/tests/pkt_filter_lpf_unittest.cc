@@ -237,4 +237,96 @@ TEST_F(PktFilterLPFTest, filterOutUnicast) {
     ASSERT_LE(result, 0);
 }
 
+// This test verifies that the DHCP packet is received from the memory-mapped
+// RX ring, whereby all IP stack headers are hand-crafted.
+TEST_F(PktFilterLPFTest, ringReceive) {
+    SKIP_IF(notRoot());
+
+    // Packet will be received over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // Create an instance of the class which we are testing with rings.
+    PktFilterLPF pkt_filter(true);
+    EXPECT_TRUE(pkt_filter.isRingEnabled());
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+    ASSERT_TRUE(pkt_filter.hasRxRing(sock_info_.sockfd_));
+
+    // Send DHCPv4 message to the local loopback address and server's port.
+    sendMessage();
+
+    // The kernel releases the block holding the frame after a timeout.
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(sock_info_.sockfd_, &readfds);
+
+    struct timeval timeout;
+    timeout.tv_sec = 5;
+    timeout.tv_usec = 0;
+    int result = select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL, &timeout);
+    ASSERT_GT(result, 0);
+
+    // Receive the packet using LPF packet filter.
+    Pkt4Ptr rcvd_pkt = pkt_filter.receive(iface, sock_info_);
+    // Check that the packet has been correctly received.
+    ASSERT_TRUE(rcvd_pkt);
+
+    // Parse the packet.
+    ASSERT_NO_THROW(rcvd_pkt->unpack());
+
+    // Check if the received message is correct.
+    testRcvdMessage(rcvd_pkt);
+    testRcvdMessageAddressPort(rcvd_pkt);
+
+    // The ring always time stamps the frames.
+    testReceivedPktEvents(rcvd_pkt, true);
+}
+
+// This test verifies that a batch of DHCP packets sent through the
+// memory-mapped TX ring is received from the RX ring.
+TEST_F(PktFilterLPFTest, ringSendReceiveBatch) {
+    SKIP_IF(notRoot());
+
+    // Packets will be sent over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // Create an instance of the class which we are testing with rings.
+    PktFilterLPF pkt_filter(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+    ASSERT_TRUE(pkt_filter.hasRxRing(sock_info_.sockfd_));
+
+    // Send two copies of the test message at once.
+    std::vector<Pkt4Ptr> pkts = { test_message_, test_message_ };
+    std::vector<std::string> errors;
+    size_t sent = 0;
+    ASSERT_NO_THROW(sent = pkt_filter.sendBatch(iface, sock_info_.sockfd_, pkts,
+                                                errors));
+    EXPECT_EQ(2, sent);
+
+    // Receive both of them, possibly in more than one batch.
+    std::vector<Pkt4Ptr> rcvd_pkts;
+    for (int i = 0; (i < 10) && (rcvd_pkts.size() < pkts.size()); ++i) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(sock_info_.sockfd_, &readfds);
+
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        ASSERT_GT(select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL, &timeout), 0);
+        ASSERT_NO_THROW(pkt_filter.receiveBatch(iface, sock_info_, 4, rcvd_pkts));
+    }
+    ASSERT_LE(pkts.size(), rcvd_pkts.size());
+
+    // Check that the received messages are correct.
+    for (auto const& rcvd_pkt : rcvd_pkts) {
+        ASSERT_TRUE(rcvd_pkt);
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+    }
+}
+
 } // anonymous namespace
@@ -24,6 +24,7 @@
 #include <dhcpsrv/srv_config.h>
 #include <hooks/callout_handle.h>
 #include <util/multi_threading_mgr.h>
+#include <util/packet_arena.h>
 #include <util/readwrite_mutex.h>
 
 #include <boost/shared_ptr.hpp>
@@ -215,7 +216,8 @@ public:
     /// that the big advantage of using the context structure to pass
     /// information to the allocation engine methods is that adding
     /// new information doesn't modify the API of the allocation engine.
-    struct ClientContext6 : public boost::noncopyable {
+    struct ClientContext6 : public boost::noncopyable,
+                            public util::PacketArenaObject {
 
         /// @name Parameters pertaining to DHCPv6 message
         //@{
@@ -1230,7 +1232,8 @@ public:
     /// that the big advantage of using the context structure to pass
     /// information to the allocation engine methods is that adding
     /// new information doesn't modify the API of the allocation engine.
-    struct ClientContext4 : public boost::noncopyable {
+    struct ClientContext4 : public boost::noncopyable,
+                            public util::PacketArenaObject {
         /// @brief Indicates if early global reservation is enabled.
         ///
         /// This caches the early-global-reservations-lookup value.
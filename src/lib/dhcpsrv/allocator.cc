@@ -8,6 +8,11 @@
 #include <dhcpsrv/allocator.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/dhcpsrv_log.h>
+#include <util/thread_pool.h>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+#include <exception>
+#include <functional>
 
 using namespace isc::util;
 
@@ -74,9 +79,73 @@ Allocator::initAfterConfigure() {
         .arg(getType())
         .arg(Lease::typeToText(pool_type_))
         .arg(subnet->toText());
+    initAfterConfigurePrepare();
     initAfterConfigureInternal();
+    initAfterConfigureFinish();
     inited_ = true;
 }
 
+void
+Allocator::initAllocatorsAfterConfigure(const std::vector<boost::shared_ptr<Allocator>>& allocators,
+                                        uint32_t thread_count) {
+    std::vector<boost::shared_ptr<Allocator>> pending;
+    for (auto const& allocator : allocators) {
+        if (allocator && !allocator->inited_) {
+            pending.push_back(allocator);
+        }
+    }
+    if ((thread_count <= 1) || (pending.size() <= 1)) {
+        for (auto const& allocator : pending) {
+            allocator->initAfterConfigure();
+        }
+        return;
+    }
+
+    // Fetch the leases in this thread: the lease manager is not meant
+    // to be used concurrently outside of the packet processing.
+    for (auto const& allocator : pending) {
+        auto subnet = allocator->subnet_.lock();
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_USE_ALLOCATOR)
+            .arg(allocator->getType())
+            .arg(Lease::typeToText(allocator->pool_type_))
+            .arg(subnet->toText());
+        allocator->initAfterConfigurePrepare();
+    }
+
+    // Run the allocator-specific initialization on a dedicated thread
+    // pool. The packet processing thread pool is stopped or paused
+    // during the reconfiguration.
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    {
+        ThreadPool<std::function<void()>> thread_pool;
+        thread_pool.start(std::min(thread_count,
+                                   static_cast<uint32_t>(pending.size())));
+        for (auto const& allocator : pending) {
+            auto work = [allocator, &error_mutex, &error]() {
+                try {
+                    allocator->initAfterConfigureInternal();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            };
+            thread_pool.add(boost::make_shared<std::function<void()>>(work));
+        }
+        thread_pool.wait();
+        thread_pool.stop();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (auto const& allocator : pending) {
+        allocator->initAfterConfigureFinish();
+        allocator->inited_ = true;
+    }
+}
+
 }
 }
@@ -18,6 +18,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 #include <mutex>
+#include <vector>
 
 namespace isc {
 namespace dhcp {
@@ -163,14 +164,64 @@ public:
     /// In this function, the allocators can also re-build their allocation states.
     void initAfterConfigure();
 
+    /// @brief Performs the initialization of several allocators after
+    /// server's reconfiguration.
+    ///
+    /// The @c initAfterConfigurePrepare and @c initAfterConfigureFinish
+    /// parts of the initialization, which use the lease manager, run in the
+    /// calling thread. The @c initAfterConfigureInternal parts, e.g. the
+    /// population of the free leases, run in parallel on a thread pool
+    /// started for the occasion.
+    ///
+    /// @param allocators the allocators to initialize. The allocators which
+    /// have already been initialized are skipped.
+    /// @param thread_count the number of threads. The allocators are
+    /// initialized in the calling thread when it is 0 or 1.
+    /// @throw the first exception thrown by the initialization of one of the
+    /// allocators.
+    static void initAllocatorsAfterConfigure(const std::vector<boost::shared_ptr<Allocator>>& allocators,
+                                             uint32_t thread_count);
+
+    /// @brief Reuses the allocation states of the allocator of the same
+    /// subnet and lease type in the previous configuration.
+    ///
+    /// It is called before the initialization of the allocator after
+    /// server's reconfiguration, so the allocator does not have to re-build
+    /// the states of the pools which did not change. The default
+    /// implementation does nothing.
+    ///
+    /// @param previous the allocator in the previous configuration.
+    virtual void reuseAllocationStates(const Allocator& previous) {
+        static_cast<void>(previous);
+    }
+
 protected:
 
+    /// @brief Allocator-specific initialization function run before
+    /// @c initAfterConfigureInternal.
+    ///
+    /// It is called in the thread performing the reconfiguration and it
+    /// can be overridden in the derived allocators, e.g. to fetch the
+    /// leases from the lease manager.
+    virtual void initAfterConfigurePrepare() {}
+
     /// @brief Allocator-specific initialization function.
     ///
     /// It is called by the @c initAfterConfigure and can be overridden in the
-    /// derived allocators.
+    /// derived allocators. When the allocators are initialized by
+    /// @c initAllocatorsAfterConfigure it runs in a thread pool, concurrently
+    /// with the initialization of other allocators, so it must not use the
+    /// lease manager.
     virtual void initAfterConfigureInternal() {}
 
+    /// @brief Allocator-specific initialization function run after
+    /// @c initAfterConfigureInternal.
+    ///
+    /// It is called in the thread performing the reconfiguration and it
+    /// can be overridden in the derived allocators, e.g. to install the
+    /// callbacks in the lease manager.
+    virtual void initAfterConfigureFinish() {}
+
 private:
 
     /// @brief Picks an address.
@@ -0,0 +1,880 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/cfg_hosts.h>
+#include <dhcpsrv/cfg_subnets4.h>
+#include <dhcpsrv/cfg_subnets6.h>
+#include <dhcpsrv/csv_lease_file4.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/ip_range.h>
+#include <dhcpsrv/ip_range_permutation.h>
+#include <dhcpsrv/lease_journal.h>
+#include <dhcpsrv/memfile_lease_mgr.h>
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <log/logger_support.h>
+#include <util/benchmarks/micro_benchmark.h>
+#include <util/benchmarks/worker_threads.h>
+#include <util/buffer.h>
+#include <util/encode/encode.h>
+
+#include <boost/make_shared.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::db;
+using namespace isc::dhcp;
+using namespace isc::util;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the microbenchmarks of the libkea-dhcpsrv data
+/// structures: the memfile lease storage indexes, the memfile lease
+/// lookups in large lease databases, the memfile lease file writes by
+/// concurrent threads, the host reservation lookups, the
+/// random address permutation, the CSV lease file reader and the transfer
+/// of a page of leases by the lease4-get-page command.
+
+namespace {
+
+/// @brief The number of leases in the lease storages.
+const size_t LEASES = 100000;
+
+/// @brief The number of subnets the leases are spread over.
+const size_t SUBNETS = 16;
+
+/// @brief The number of host reservations.
+const size_t HOSTS = 10000;
+
+/// @brief The number of leases in the lease file.
+const size_t FILE_LEASES = 10000;
+
+/// @brief The number of leases in a page of the lease4-get-page command.
+const size_t PAGE_LEASES = 1000;
+
+/// @brief The name of the lease file.
+const char* const LEASE_FILE = "dhcpsrv-benchmark-leases4.csv";
+
+/// @brief The name of the lease journal.
+const char* const JOURNAL_FILE = "dhcpsrv-benchmark-leases4.journal";
+
+/// @brief The name of the lease file written by concurrent threads.
+const char* const WRITE_FILE = "dhcpsrv-benchmark-write4.csv";
+
+/// @brief The number of threads adding leases.
+const size_t WRITE_THREADS = 8;
+
+/// @brief The number of leases added by each thread in an operation.
+const size_t WRITE_ROUND = 10;
+
+/// @brief The number of lookups of the large lease database cases, which
+/// cycle over the leases in a scattered order.
+const size_t LOOKUPS = 100000;
+
+/// @brief Returns the addresses of 10.0.0.0/8 in a random order.
+///
+/// @param gen the data generator.
+/// @param count the number of addresses.
+/// @return the addresses.
+vector<IOAddress>
+makeAddresses4(DataGenerator& gen, size_t count) {
+    vector<uint32_t> offsets(count);
+    for (size_t i = 0; i < count; ++i) {
+        offsets[i] = i + 1;
+    }
+    gen.shuffle(offsets);
+    vector<IOAddress> addresses;
+    addresses.reserve(count);
+    for (auto const& offset : offsets) {
+        addresses.push_back(IOAddress((10 << 24) + offset));
+    }
+    return (addresses);
+}
+
+/// @brief Returns DHCPv4 leases.
+///
+/// The leases have random hardware addresses and client identifiers.
+/// A tenth of the leases are expired.
+///
+/// @param gen the data generator.
+/// @param count the number of leases.
+/// @return the leases.
+vector<Lease4Ptr>
+makeLeases4(DataGenerator& gen, size_t count) {
+    vector<IOAddress> addresses = makeAddresses4(gen, count);
+    time_t now = time(0);
+    vector<Lease4Ptr> leases;
+    leases.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        HWAddrPtr hwaddr(new HWAddr(gen.bytes(6), HTYPE_ETHER));
+        vector<uint8_t> client_id = gen.bytes(7);
+        time_t cltt = now - (gen.uniform(0, 9) == 0 ? 8000 : gen.uniform(0, 3600));
+        Lease4Ptr lease(new Lease4(addresses[i], hwaddr, &client_id[0],
+                                   client_id.size(), 4000, cltt,
+                                   gen.uniform(1, SUBNETS)));
+        lease->hostname_ = gen.name(12) + ".example.org";
+        leases.push_back(lease);
+    }
+    return (leases);
+}
+
+/// @brief Returns DHCPv6 leases.
+///
+/// @param gen the data generator.
+/// @param count the number of leases.
+/// @return the leases.
+vector<Lease6Ptr>
+makeLeases6(DataGenerator& gen, size_t count) {
+    vector<Lease6Ptr> leases;
+    leases.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // The 64 low bits of the address are random, which makes the
+        // addresses unique for the benchmark sizes.
+        vector<uint8_t> bytes = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0 };
+        uint64_t subnet = gen.uniform(1, SUBNETS);
+        bytes[7] = static_cast<uint8_t>(subnet);
+        vector<uint8_t> host = gen.bytes(8);
+        bytes.insert(bytes.end(), host.begin(), host.end());
+        DuidPtr duid(new DUID(gen.bytes(14)));
+        leases.push_back(boost::make_shared<Lease6>(Lease::TYPE_NA,
+                                                    IOAddress::fromBytes(AF_INET6,
+                                                                         &bytes[0]),
+                                                    duid, gen.uniform(1, 1000),
+                                                    3000, 4000, subnet));
+    }
+    return (leases);
+}
+
+/// @brief Adds the cases of the lease storages.
+///
+/// @param bench the benchmark.
+void
+addLeaseStorageCases(MicroBenchmark& bench) {
+    // Builds the DHCPv4 storage and returns it with its leases in the
+    // order of the lookups.
+    auto storage4 = [](DataGenerator& gen) {
+        auto leases = boost::make_shared<vector<Lease4Ptr>>(makeLeases4(gen, LEASES));
+        auto storage = boost::make_shared<Lease4Storage>();
+        for (auto const& lease : *leases) {
+            storage->insert(lease);
+        }
+        gen.shuffle(*leases);
+        return (make_pair(storage, leases));
+    };
+
+    bench.add("Lease4Storage/address", [storage4](DataGenerator& gen) {
+        auto data = storage4(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<AddressIndexTag>();
+            MicroBenchmark::keep(index.count((*data.second)[i++ % LEASES]->addr_));
+        });
+    });
+
+    bench.add("Lease4Storage/hashed-address", [storage4](DataGenerator& gen) {
+        auto data = storage4(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<HashedAddressIndexTag>();
+            MicroBenchmark::keep(index.count((*data.second)[i++ % LEASES]->addr_));
+        });
+    });
+
+    bench.add("Lease4Storage/hwaddr-subnet-id", [storage4](DataGenerator& gen) {
+        auto data = storage4(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<HWAddressSubnetIdIndexTag>();
+            const Lease4Ptr& lease = (*data.second)[i++ % LEASES];
+            MicroBenchmark::keep(index.count(boost::make_tuple(lease->hwaddr_->hwaddr_,
+                                                               lease->subnet_id_)));
+        });
+    });
+
+    bench.add("Lease4Storage/client-id-subnet-id", [storage4](DataGenerator& gen) {
+        auto data = storage4(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<ClientIdSubnetIdIndexTag>();
+            const Lease4Ptr& lease = (*data.second)[i++ % LEASES];
+            MicroBenchmark::keep(index.count(boost::make_tuple(lease->getClientIdVector(),
+                                                               lease->subnet_id_)));
+        });
+    });
+
+    // Walks the first expired leases like the lease reclamation.
+    bench.add("Lease4Storage/expired", [storage4](DataGenerator& gen) {
+        auto data = storage4(gen);
+        return ([data]() {
+            auto const& index = data.first->get<ExpirationIndexTag>();
+            auto ub = index.upper_bound(boost::make_tuple(false, time(0)));
+            size_t count = 0;
+            for (auto it = index.begin(); (it != ub) && (count < 100); ++it) {
+                ++count;
+            }
+            MicroBenchmark::keep(count);
+        });
+    });
+
+    // Replaces a lease: the cost of a lease update in all the indexes.
+    bench.add("Lease4Storage/replace", [storage4](DataGenerator& gen) {
+        auto data = storage4(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto& index = data.first->get<HashedAddressIndexTag>();
+            const Lease4Ptr& lease = (*data.second)[i++ % LEASES];
+            auto it = index.find(lease->addr_);
+            Lease4Ptr copy(new Lease4(*lease));
+            ++copy->cltt_;
+            MicroBenchmark::keep(index.replace(it, copy));
+        });
+    });
+
+    auto storage6 = [](DataGenerator& gen) {
+        auto leases = boost::make_shared<vector<Lease6Ptr>>(makeLeases6(gen, LEASES));
+        auto storage = boost::make_shared<Lease6Storage>();
+        for (auto const& lease : *leases) {
+            storage->insert(lease);
+        }
+        gen.shuffle(*leases);
+        return (make_pair(storage, leases));
+    };
+
+    bench.add("Lease6Storage/address", [storage6](DataGenerator& gen) {
+        auto data = storage6(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<AddressIndexTag>();
+            MicroBenchmark::keep(index.count((*data.second)[i++ % LEASES]->addr_));
+        });
+    });
+
+    bench.add("Lease6Storage/hashed-address", [storage6](DataGenerator& gen) {
+        auto data = storage6(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<HashedAddressIndexTag>();
+            MicroBenchmark::keep(index.count((*data.second)[i++ % LEASES]->addr_));
+        });
+    });
+
+    bench.add("Lease6Storage/duid-iaid-type", [storage6](DataGenerator& gen) {
+        auto data = storage6(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            auto const& index = data.first->get<DuidIaidTypeIndexTag>();
+            const Lease6Ptr& lease = (*data.second)[i++ % LEASES];
+            MicroBenchmark::keep(index.count(boost::make_tuple(lease->getDuidVector(),
+                                                               lease->iaid_,
+                                                               lease->type_)));
+        });
+    });
+}
+
+/// @brief Returns the resident set size of the process in KiB.
+///
+/// @return the resident set size or 0 when it is not available.
+size_t
+getResidentSize() {
+    ifstream statm("/proc/self/statm");
+    size_t size = 0;
+    size_t resident = 0;
+    statm >> size >> resident;
+    return (resident * (sysconf(_SC_PAGESIZE) / 1024));
+}
+
+/// @brief Returns the identifier of the n-th lease of a large lease
+/// database, used as hardware address, client identifier and DUID.
+///
+/// @param n the number of the lease.
+/// @param size the size of the identifier.
+/// @return the identifier.
+vector<uint8_t>
+makeLeaseId(size_t n, size_t size) {
+    vector<uint8_t> id(size, 0);
+    for (size_t b = 0; b < 4; ++b) {
+        id[size - 1 - b] = (n >> (8 * b)) & 0xff;
+    }
+    return (id);
+}
+
+/// @brief Returns the address of the n-th lease of a large DHCPv6 lease
+/// database.
+///
+/// @param n the number of the lease.
+/// @return the address.
+IOAddress
+makeLeaseAddress6(size_t n) {
+    vector<uint8_t> bytes = makeLeaseId(n, 16);
+    bytes[0] = 0x20;
+    bytes[1] = 0x01;
+    return (IOAddress::fromBytes(AF_INET6, &bytes[0]));
+}
+
+/// @brief Returns a memfile lease manager holding a large lease database.
+///
+/// The lease databases take several gigabytes of memory for 10M leases,
+/// so only the database of the last call is kept: the cases using the
+/// same database share it, provided they are run in turn. The increase
+/// of the resident size of the process is printed on the standard error
+/// when a database is built, as it is not reported by the harness.
+///
+/// @param universe 4 or 6.
+/// @param count the number of leases.
+/// @param compact use the compact storage mode.
+/// @return the lease manager.
+boost::shared_ptr<Memfile_LeaseMgr>
+getLargeLeaseMgr(int universe, size_t count, bool compact) {
+    static boost::shared_ptr<Memfile_LeaseMgr> lease_mgr;
+    static string key;
+    ostringstream s;
+    s << universe << "/" << count << "/" << compact;
+    if (lease_mgr && (key == s.str())) {
+        return (lease_mgr);
+    }
+    lease_mgr.reset();
+    key = s.str();
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["universe"] = to_string(universe);
+    pmap["persist"] = "false";
+    pmap["compact"] = (compact ? "true" : "false");
+    size_t resident_size = getResidentSize();
+    lease_mgr.reset(new Memfile_LeaseMgr(pmap));
+    if (universe == 4) {
+        // Leases usually have the same small user context, e.g. the
+        // client classes used by the lease limits.
+        ConstElementPtr context =
+            Element::fromJSON("{ \"ISC\": { \"client-classes\": [ \"foo\" ] } }");
+        for (size_t i = 0; i < count; ++i) {
+            vector<uint8_t> id = makeLeaseId(i, 6);
+            HWAddrPtr hwaddr(new HWAddr(id, HTYPE_ETHER));
+            Lease4Ptr lease(new Lease4(IOAddress(0x0a000000 + i), hwaddr,
+                                       &id[0], id.size(), 3600, time(0),
+                                       1 + i % 100));
+            lease->setContext(copy(context));
+            lease_mgr->addLease(lease);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            DuidPtr duid(new DUID(makeLeaseId(i, 8)));
+            Lease6Ptr lease(new Lease6(Lease::TYPE_NA, makeLeaseAddress6(i),
+                                       duid, 1, 1800, 3600, 1 + i % 100));
+            lease_mgr->addLease(lease);
+        }
+    }
+    cerr << count << " DHCPv" << universe << " leases"
+         << (compact ? " (compact)" : "") << ", resident size increase: "
+         << ((getResidentSize() - resident_size) / 1024) << " MiB" << endl;
+    return (lease_mgr);
+}
+
+/// @brief Adds the cases of the memfile lease lookups in large lease
+/// databases.
+///
+/// The cases of the same database are added in turn so it is built once.
+///
+/// @param bench the benchmark.
+void
+addLargeLeaseMgrCases(MicroBenchmark& bench) {
+    struct Database4 {
+        string name_;
+        size_t count_;
+        bool compact_;
+    };
+    vector<Database4> databases4 = {
+        { "1M", 1000000, false },
+        { "1M-compact", 1000000, true },
+        { "5M", 5000000, false },
+        { "10M", 10000000, false },
+        { "10M-compact", 10000000, true }
+    };
+    for (auto const& db : databases4) {
+        string prefix = "Memfile_LeaseMgr4/" + db.name_ + "/";
+        size_t count = db.count_;
+        bool compact = db.compact_;
+
+        bench.add(prefix + "get-address", [count, compact](DataGenerator&) {
+            auto lease_mgr = getLargeLeaseMgr(4, count, compact);
+            size_t i = 0;
+            return ([lease_mgr, count, i]() mutable {
+                size_t n = (i++ % LOOKUPS) * 7919 % count;
+                MicroBenchmark::keep(static_cast<bool>(
+                    lease_mgr->getLease4(IOAddress(0x0a000000 + n))));
+            });
+        });
+
+        bench.add(prefix + "get-hwaddr-subnet-id", [count, compact](DataGenerator&) {
+            auto lease_mgr = getLargeLeaseMgr(4, count, compact);
+            size_t i = 0;
+            return ([lease_mgr, count, i]() mutable {
+                size_t n = (i++ % LOOKUPS) * 7919 % count;
+                HWAddr hwaddr(makeLeaseId(n, 6), HTYPE_ETHER);
+                MicroBenchmark::keep(static_cast<bool>(
+                    lease_mgr->getLease4(hwaddr, 1 + n % 100)));
+            });
+        });
+
+        bench.add(prefix + "get-client-id-subnet-id", [count, compact](DataGenerator&) {
+            auto lease_mgr = getLargeLeaseMgr(4, count, compact);
+            size_t i = 0;
+            return ([lease_mgr, count, i]() mutable {
+                size_t n = (i++ % LOOKUPS) * 7919 % count;
+                ClientId client_id(makeLeaseId(n, 6));
+                MicroBenchmark::keep(static_cast<bool>(
+                    lease_mgr->getLease4(client_id, 1 + n % 100)));
+            });
+        });
+    }
+
+    for (size_t count : { 1000000, 5000000 }) {
+        string prefix = "Memfile_LeaseMgr6/" + to_string(count / 1000000) + "M/";
+
+        bench.add(prefix + "get-address", [count](DataGenerator&) {
+            auto lease_mgr = getLargeLeaseMgr(6, count, false);
+            size_t i = 0;
+            return ([lease_mgr, count, i]() mutable {
+                size_t n = (i++ % LOOKUPS) * 7919 % count;
+                MicroBenchmark::keep(static_cast<bool>(
+                    lease_mgr->getLease6(Lease::TYPE_NA, makeLeaseAddress6(n))));
+            });
+        });
+
+        bench.add(prefix + "get-duid-iaid", [count](DataGenerator&) {
+            auto lease_mgr = getLargeLeaseMgr(6, count, false);
+            size_t i = 0;
+            return ([lease_mgr, count, i]() mutable {
+                size_t n = (i++ % LOOKUPS) * 7919 % count;
+                DUID duid(makeLeaseId(n, 8));
+                MicroBenchmark::keep(
+                    lease_mgr->getLeases6(Lease::TYPE_NA, duid, 1).size());
+            });
+        });
+    }
+}
+
+/// @brief Adds the cases of the memfile lease file writes.
+///
+/// An operation is a round of 10 lease additions by each of 8 threads
+/// with the lease file synchronized to disk, without and with the
+/// group-commit writer.
+///
+/// @param bench the benchmark.
+void
+addLeaseWriteCases(MicroBenchmark& bench) {
+    struct Writer {
+        string name_;
+        string parameters_;
+    };
+    vector<Writer> writers = {
+        { "sync", "" },
+        { "group-commit", "write-queue-size=64" },
+        { "group-commit-delay", "write-queue-size=64 write-max-delay=200" }
+    };
+    for (auto const& writer : writers) {
+        string parameters = writer.parameters_;
+        bench.add("Memfile_LeaseMgr4/add-" + writer.name_ + "-mt", [parameters](DataGenerator&) {
+            DatabaseConnection::ParameterMap pmap;
+            pmap["universe"] = "4";
+            pmap["lfc-interval"] = "0";
+            pmap["write-sync"] = "true";
+            pmap["name"] = WRITE_FILE;
+            istringstream is(parameters);
+            string param;
+            while (is >> param) {
+                size_t pos = param.find('=');
+                pmap[param.substr(0, pos)] = param.substr(pos + 1);
+            }
+            static_cast<void>(remove(WRITE_FILE));
+            auto lease_mgr = boost::make_shared<Memfile_LeaseMgr>(pmap);
+            auto next = boost::make_shared<atomic<uint32_t>>(0);
+            auto workers = boost::make_shared<WorkerThreads>(WRITE_THREADS,
+                                                             [lease_mgr, next](size_t) {
+                for (size_t i = 0; i < WRITE_ROUND; ++i) {
+                    uint32_t n = (*next)++;
+                    HWAddrPtr hwaddr(new HWAddr(makeLeaseId(n, 6), HTYPE_ETHER));
+                    Lease4Ptr lease(new Lease4(IOAddress(0x0a000000 + n), hwaddr,
+                                               ClientIdPtr(), 3600, time(0), 1));
+                    static_cast<void>(lease_mgr->addLease(lease));
+                }
+            });
+            return ([workers]() {
+                workers->run();
+            });
+        });
+    }
+}
+
+/// @brief Returns the configured subnets selected by the subnet
+/// selection cases.
+///
+/// @param count the number of /24 subnets.
+/// @param index build the selection index.
+/// @return the subnets.
+boost::shared_ptr<CfgSubnets4>
+makeCfgSubnets4(size_t count, bool index) {
+    auto cfg = boost::make_shared<CfgSubnets4>();
+    for (size_t i = 0; i < count; ++i) {
+        Subnet4Ptr subnet(new Subnet4(IOAddress(0x0a000000 + (i << 8)),
+                                      24, 1, 2, 3, SubnetID(i + 1)));
+        cfg->add(subnet);
+    }
+    if (index) {
+        cfg->buildSelectionIndex();
+    }
+    return (cfg);
+}
+
+/// @brief Returns the prefix of the n-th subnet of the DHCPv6 subnet
+/// selection cases.
+///
+/// @param n the number of the subnet.
+/// @param host the last byte of the address, 0 for the prefix.
+/// @return the prefix or the address.
+IOAddress
+makeSubnetAddress6(size_t n, uint8_t host) {
+    vector<uint8_t> bytes = IOAddress("2001:db8::").toBytes();
+    bytes[5] = (n >> 16) & 0xff;
+    bytes[6] = (n >> 8) & 0xff;
+    bytes[7] = n & 0xff;
+    bytes[15] = host;
+    return (IOAddress::fromBytes(AF_INET6, &bytes[0]));
+}
+
+/// @brief Returns the configured subnets selected by the subnet
+/// selection cases.
+///
+/// @param count the number of /64 subnets.
+/// @param index build the selection index.
+/// @return the subnets.
+boost::shared_ptr<CfgSubnets6>
+makeCfgSubnets6(size_t count, bool index) {
+    auto cfg = boost::make_shared<CfgSubnets6>();
+    for (size_t i = 0; i < count; ++i) {
+        Subnet6Ptr subnet(new Subnet6(makeSubnetAddress6(i, 0), 64, 1, 2, 3,
+                                      4, SubnetID(i + 1)));
+        cfg->add(subnet);
+    }
+    if (index) {
+        cfg->buildSelectionIndex();
+    }
+    return (cfg);
+}
+
+/// @brief Adds the cases of the subnet selection by address.
+///
+/// The subnets are selected by iterating over them and with the
+/// selection index, with 1k, 10k and 100k subnets.
+///
+/// @param bench the benchmark.
+void
+addSubnetSelectionCases(MicroBenchmark& bench) {
+    for (size_t count : { 1000, 10000, 100000 }) {
+        string prefix4 = "CfgSubnets4/" + to_string(count / 1000) + "k/";
+        string prefix6 = "CfgSubnets6/" + to_string(count / 1000) + "k/";
+        for (bool index : { false, true }) {
+            string name = (index ? "select-index" : "select-linear");
+
+            bench.add(prefix4 + name, [count, index](DataGenerator&) {
+                auto cfg = makeCfgSubnets4(count, index);
+                size_t i = 0;
+                return ([cfg, count, i]() mutable {
+                    size_t n = (i++ * 7919) % count;
+                    MicroBenchmark::keep(static_cast<bool>(
+                        cfg->selectSubnet(IOAddress(0x0a000001 + (n << 8)))));
+                });
+            });
+
+            bench.add(prefix6 + name, [count, index](DataGenerator&) {
+                auto cfg = makeCfgSubnets6(count, index);
+                vector<IOAddress> addresses;
+                for (size_t i = 0; i < count; ++i) {
+                    addresses.push_back(makeSubnetAddress6((i * 7919) % count, 1));
+                }
+                size_t i = 0;
+                return ([cfg, addresses, i]() mutable {
+                    MicroBenchmark::keep(static_cast<bool>(
+                        cfg->selectSubnet(addresses[i++ % addresses.size()])));
+                });
+            });
+        }
+
+        // The index is rebuilt for each commit of a configuration.
+        bench.add(prefix4 + "build-index", [count](DataGenerator&) {
+            auto cfg = makeCfgSubnets4(count, false);
+            return ([cfg]() {
+                cfg->buildSelectionIndex();
+            });
+        });
+
+        bench.add(prefix6 + "build-index", [count](DataGenerator&) {
+            auto cfg = makeCfgSubnets6(count, false);
+            return ([cfg]() {
+                cfg->buildSelectionIndex();
+            });
+        });
+    }
+}
+
+/// @brief Adds the cases of the host reservations.
+///
+/// @param bench the benchmark.
+void
+addCfgHostsCases(MicroBenchmark& bench) {
+    // The hosts are reserved in subnet 1 by hardware address with an
+    // IPv4 address and by DUID with an IPv6 address.
+    struct HostsData {
+        CfgHosts hosts_;
+        vector<vector<uint8_t>> hwaddrs_;
+        vector<vector<uint8_t>> duids_;
+        vector<IOAddress> addresses_;
+        vector<IOAddress> addresses6_;
+    };
+    auto hosts = [](DataGenerator& gen) {
+        auto data = boost::make_shared<HostsData>();
+        data->addresses_ = makeAddresses4(gen, HOSTS);
+        for (size_t i = 0; i < HOSTS; ++i) {
+            vector<uint8_t> hwaddr = gen.bytes(6);
+            HostPtr host(new Host(&hwaddr[0], hwaddr.size(), Host::IDENT_HWADDR,
+                                  SubnetID(1), SubnetID(SUBNET_ID_UNUSED),
+                                  data->addresses_[i], gen.name(12)));
+            data->hosts_.add(host);
+            data->hwaddrs_.push_back(hwaddr);
+
+            vector<uint8_t> duid = gen.bytes(14);
+            vector<uint8_t> bytes = gen.bytes(16);
+            bytes[0] = 0x20;
+            bytes[1] = 0x01;
+            IOAddress address6 = IOAddress::fromBytes(AF_INET6, &bytes[0]);
+            host.reset(new Host(&duid[0], duid.size(), Host::IDENT_DUID,
+                                SubnetID(SUBNET_ID_UNUSED), SubnetID(1),
+                                IOAddress::IPV4_ZERO_ADDRESS()));
+            host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA, address6));
+            data->hosts_.add(host);
+            data->duids_.push_back(duid);
+            data->addresses6_.push_back(address6);
+        }
+        return (data);
+    };
+
+    bench.add("CfgHosts/get4-hwaddr", [hosts](DataGenerator& gen) {
+        auto data = hosts(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            const vector<uint8_t>& hwaddr = data->hwaddrs_[i++ % HOSTS];
+            MicroBenchmark::keep(static_cast<bool>(
+                data->hosts_.get4(SubnetID(1), Host::IDENT_HWADDR,
+                                  &hwaddr[0], hwaddr.size())));
+        });
+    });
+
+    bench.add("CfgHosts/get4-address", [hosts](DataGenerator& gen) {
+        auto data = hosts(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            MicroBenchmark::keep(static_cast<bool>(
+                data->hosts_.get4(SubnetID(1), data->addresses_[i++ % HOSTS])));
+        });
+    });
+
+    bench.add("CfgHosts/get6-duid", [hosts](DataGenerator& gen) {
+        auto data = hosts(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            const vector<uint8_t>& duid = data->duids_[i++ % HOSTS];
+            MicroBenchmark::keep(static_cast<bool>(
+                data->hosts_.get6(SubnetID(1), Host::IDENT_DUID,
+                                  &duid[0], duid.size())));
+        });
+    });
+
+    bench.add("CfgHosts/get6-address", [hosts](DataGenerator& gen) {
+        auto data = hosts(gen);
+        size_t i = 0;
+        return ([data, i]() mutable {
+            MicroBenchmark::keep(static_cast<bool>(
+                data->hosts_.get6(SubnetID(1), data->addresses6_[i++ % HOSTS])));
+        });
+    });
+}
+
+/// @brief Adds the cases of the random address permutation.
+///
+/// @param bench the benchmark.
+void
+addPermutationCases(MicroBenchmark& bench) {
+    // A new permutation is started when the range is exhausted so the
+    // cost of the construction is included.
+    bench.add("IPRangePermutation/next-v4", [](DataGenerator&) {
+        AddressRange range(IOAddress("10.0.0.0"), IOAddress("10.0.255.255"));
+        auto perm = boost::make_shared<IPRangePermutation>(range);
+        return ([range, perm]() mutable {
+            bool done = false;
+            MicroBenchmark::keep(perm->next(done).toUint32());
+            if (done) {
+                perm.reset(new IPRangePermutation(range));
+            }
+        });
+    });
+
+    bench.add("IPRangePermutation/next-v6", [](DataGenerator&) {
+        AddressRange range(IOAddress("2001:db8::"), IOAddress("2001:db8::ffff"));
+        auto perm = boost::make_shared<IPRangePermutation>(range);
+        return ([range, perm]() mutable {
+            bool done = false;
+            MicroBenchmark::keep(perm->next(done).isV6());
+            if (done) {
+                perm.reset(new IPRangePermutation(range));
+            }
+        });
+    });
+}
+
+/// @brief Adds the cases of the CSV lease file and of the lease journal.
+///
+/// @param bench the benchmark.
+void
+addLeaseFileCases(MicroBenchmark& bench) {
+    // Reads the leases of a file, which is reopened at its end.
+    bench.add("CSVLeaseFile4/next", [](DataGenerator& gen) {
+        {
+            CSVLeaseFile4 file(LEASE_FILE);
+            file.recreate();
+            for (auto const& lease : makeLeases4(gen, FILE_LEASES)) {
+                file.append(*lease);
+            }
+            file.close();
+        }
+        auto file = boost::make_shared<CSVLeaseFile4>(LEASE_FILE);
+        file->open();
+        return ([file]() {
+            Lease4Ptr lease;
+            if (!file->next(lease)) {
+                isc_throw(Unexpected, "lease file error: " << file->getReadMsg());
+            }
+            if (!lease) {
+                file->close();
+                file->open();
+                static_cast<void>(file->next(lease));
+            }
+            MicroBenchmark::keep(static_cast<bool>(lease));
+        });
+    });
+
+    // Reads the leases of a journal, which is reopened at its end.
+    bench.add("LeaseJournal4/next", [](DataGenerator& gen) {
+        {
+            LeaseJournal4 journal(JOURNAL_FILE);
+            journal.recreate();
+            for (auto const& lease : makeLeases4(gen, FILE_LEASES)) {
+                journal.append(*lease);
+            }
+            journal.close();
+        }
+        auto journal = boost::make_shared<LeaseJournal4>(JOURNAL_FILE);
+        journal->open();
+        return ([journal]() {
+            Lease4Ptr lease;
+            if (!journal->next(lease)) {
+                isc_throw(Unexpected, "lease journal error: " << journal->getReadMsg());
+            }
+            if (!lease) {
+                journal->close();
+                journal->open();
+                static_cast<void>(journal->next(lease));
+            }
+            MicroBenchmark::keep(static_cast<bool>(lease));
+        });
+    });
+}
+
+/// @brief Adds the cases of the transfer of a page of leases.
+///
+/// An operation converts a page of leases to the text of the
+/// lease4-get-page response argument and back to leases, as the HA
+/// lease synchronization does, in the JSON list and in the lease stream.
+///
+/// @param bench the benchmark.
+void
+addLeasePageCases(MicroBenchmark& bench) {
+    bench.add("LeasePage4/json", [](DataGenerator& gen) {
+        auto leases = boost::make_shared<vector<Lease4Ptr>>(makeLeases4(gen, PAGE_LEASES));
+        return ([leases]() {
+            ElementPtr list = Element::createList();
+            for (auto const& lease : *leases) {
+                list->add(lease->toElement());
+            }
+            ConstElementPtr received = Element::fromJSON(list->str());
+            size_t count = 0;
+            for (auto const& lease : received->listValue()) {
+                count += Lease4::fromElement(lease) ? 1 : 0;
+            }
+            MicroBenchmark::keep(count);
+        });
+    });
+
+    bench.add("LeasePage4/binary", [](DataGenerator& gen) {
+        auto leases = boost::make_shared<vector<Lease4Ptr>>(makeLeases4(gen, PAGE_LEASES));
+        return ([leases]() {
+            OutputBuffer stream(0);
+            writeLeaseStreamHeader(stream);
+            for (auto const& lease : *leases) {
+                writeLeaseStreamRecord(stream, *lease);
+            }
+            vector<uint8_t> data(stream.getData(), stream.getData() + stream.getLength());
+            string text = Element::create(encode::encodeBase64(data))->str();
+            vector<uint8_t> binary;
+            encode::decodeBase64(Element::fromJSON(text)->stringValue(), binary);
+            InputBuffer buffer(&binary[0], binary.size());
+            readLeaseStreamHeader(buffer);
+            size_t count = 0;
+            Lease4Ptr lease;
+            while (readLeaseStreamRecord(buffer, lease)) {
+                ++count;
+            }
+            MicroBenchmark::keep(count);
+        });
+    });
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    // The memfile lease manager logs.
+    isc::log::initLogger("kea-dhcpsrv-benchmark", isc::log::ERROR,
+                         isc::log::MAX_DEBUG_LEVEL, NULL, false);
+    MicroBenchmark bench("libkea-dhcpsrv");
+    addLeaseStorageCases(bench);
+    addLargeLeaseMgrCases(bench);
+    addLeaseWriteCases(bench);
+    addCfgHostsCases(bench);
+    addSubnetSelectionCases(bench);
+    addPermutationCases(bench);
+    addLeaseFileCases(bench);
+    addLeasePageCases(bench);
+    int result = bench.run(argc, argv);
+    static_cast<void>(remove(LEASE_FILE));
+    static_cast<void>(remove(JOURNAL_FILE));
+    static_cast<void>(remove(WRITE_FILE));
+    return (result);
+}
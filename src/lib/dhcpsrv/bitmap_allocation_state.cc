@@ -0,0 +1,232 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/addr_utilities.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <exceptions/exceptions.h>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Returns the index of the lowest set bit of a non zero word.
+///
+/// @param word the word.
+/// @return the index of the lowest set bit.
+inline uint64_t
+lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+    return (__builtin_ctzll(word));
+#else
+    uint64_t index = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++index;
+    }
+    return (index);
+#endif
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const uint64_t PoolBitmapAllocationState::MAX_CAPACITY;
+const uint64_t PoolBitmapAllocationState::NOT_FOUND;
+
+PoolBitmapAllocationStatePtr
+PoolBitmapAllocationState::create(const PoolPtr& pool) {
+    return (boost::make_shared<PoolBitmapAllocationState>(pool));
+}
+
+PoolBitmapAllocationState::PoolBitmapAllocationState(const PoolPtr& pool)
+    : AllocationState(), type_(pool->getType()), first_(pool->getFirstAddress()),
+      first4_(0), shift_(0), capacity_(0), levels_(), free_count_(0), next_(0) {
+    uint128_t capacity = pool->getCapacity();
+    if (capacity > MAX_CAPACITY) {
+        isc_throw(BadValue, "pool " << pool->toText() << " is too large for the"
+                  " bitmap allocator: the maximum number of leases in a pool is "
+                  << MAX_CAPACITY);
+    }
+    capacity_ = static_cast<uint64_t>(capacity);
+    if (type_ == Lease::TYPE_V4) {
+        first4_ = first_.toUint32();
+    } else if (type_ == Lease::TYPE_PD) {
+        auto pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+        if (pool6) {
+            shift_ = 128 - pool6->getLength();
+        }
+    }
+    // Build the levels from the bottom up to the single word level.
+    uint64_t size = capacity_;
+    do {
+        size = (size + 63) / 64;
+        levels_.push_back(std::vector<uint64_t>(size, 0));
+    } while (size > 1);
+}
+
+bool
+PoolBitmapAllocationState::exhausted() const {
+    return (free_count_ == 0);
+}
+
+void
+PoolBitmapAllocationState::setAllFree() {
+    uint64_t bits = capacity_;
+    for (auto& level : levels_) {
+        std::fill(level.begin(), level.end(), ~0ULL);
+        // Clear the bits past the end of the level.
+        if (bits % 64) {
+            level.back() = (1ULL << (bits % 64)) - 1;
+        }
+        bits = level.size();
+    }
+    free_count_ = capacity_;
+}
+
+void
+PoolBitmapAllocationState::addFreeLease(const IOAddress& address) {
+    uint64_t offset;
+    if (getOffset(address, offset)) {
+        setBit(offset);
+    }
+}
+
+void
+PoolBitmapAllocationState::deleteFreeLease(const IOAddress& address) {
+    uint64_t offset;
+    if (getOffset(address, offset)) {
+        clearBit(offset);
+    }
+}
+
+IOAddress
+PoolBitmapAllocationState::offerFreeLease() {
+    if (free_count_ == 0) {
+        return (type_ == Lease::TYPE_V4 ? IOAddress::IPV4_ZERO_ADDRESS() :
+                IOAddress::IPV6_ZERO_ADDRESS());
+    }
+    uint64_t offset = findNext(0, next_);
+    if (offset == NOT_FOUND) {
+        offset = findNext(0, 0);
+    }
+    next_ = offset + 1;
+    if (next_ >= capacity_) {
+        next_ = 0;
+    }
+    return (getAddress(offset));
+}
+
+uint64_t
+PoolBitmapAllocationState::getFreeLeaseCount() const {
+    return (free_count_);
+}
+
+bool
+PoolBitmapAllocationState::getOffset(const IOAddress& address,
+                                     uint64_t& offset) const {
+    if (type_ == Lease::TYPE_V4) {
+        if (!address.isV4()) {
+            return (false);
+        }
+        // The subtraction wraps for addresses below the first one.
+        offset = address.toUint32() - first4_;
+        return (offset < capacity_);
+    }
+    if (!address.isV6() || (address < first_)) {
+        return (false);
+    }
+    uint128_t distance = addrsInRange(first_, address) - 1;
+    if (shift_ > 0) {
+        // Only the first address of a delegated prefix is a lease.
+        if ((distance & ((uint128_t(1) << shift_) - 1)) != 0) {
+            return (false);
+        }
+        distance >>= shift_;
+    }
+    if (distance >= capacity_) {
+        return (false);
+    }
+    offset = static_cast<uint64_t>(distance);
+    return (true);
+}
+
+IOAddress
+PoolBitmapAllocationState::getAddress(uint64_t offset) const {
+    if (type_ == Lease::TYPE_V4) {
+        return (IOAddress(static_cast<uint32_t>(first4_ + offset)));
+    }
+    return (offsetAddress(first_, uint128_t(offset) << shift_));
+}
+
+void
+PoolBitmapAllocationState::setBit(uint64_t offset) {
+    uint64_t& word = levels_[0][offset / 64];
+    uint64_t bit = 1ULL << (offset % 64);
+    if (word & bit) {
+        return;
+    }
+    ++free_count_;
+    for (auto& level : levels_) {
+        uint64_t& level_word = level[offset / 64];
+        bool was_empty = (level_word == 0);
+        level_word |= 1ULL << (offset % 64);
+        if (!was_empty) {
+            // The parents are already set.
+            break;
+        }
+        offset /= 64;
+    }
+}
+
+void
+PoolBitmapAllocationState::clearBit(uint64_t offset) {
+    uint64_t& word = levels_[0][offset / 64];
+    uint64_t bit = 1ULL << (offset % 64);
+    if ((word & bit) == 0) {
+        return;
+    }
+    --free_count_;
+    for (auto& level : levels_) {
+        uint64_t& level_word = level[offset / 64];
+        level_word &= ~(1ULL << (offset % 64));
+        if (level_word != 0) {
+            // The parents remain set.
+            break;
+        }
+        offset /= 64;
+    }
+}
+
+uint64_t
+PoolBitmapAllocationState::findNext(size_t level, uint64_t from) const {
+    auto const& words = levels_[level];
+    uint64_t index = from / 64;
+    if (index >= words.size()) {
+        return (NOT_FOUND);
+    }
+    uint64_t word = words[index] & (~0ULL << (from % 64));
+    if (word == 0) {
+        // Ask the level above for the next word with a set bit.
+        if (level + 1 >= levels_.size()) {
+            return (NOT_FOUND);
+        }
+        index = findNext(level + 1, index + 1);
+        if (index == NOT_FOUND) {
+            return (NOT_FOUND);
+        }
+        word = words[index];
+    }
+    return (index * 64 + lowestBit(word));
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
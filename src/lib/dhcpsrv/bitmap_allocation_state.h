@@ -0,0 +1,164 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BITMAP_ALLOCATION_STATE_H
+#define BITMAP_ALLOCATION_STATE_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/allocation_state.h>
+#include <dhcpsrv/pool.h>
+#include <boost/shared_ptr.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Forward declaration of the @c PoolBitmapAllocationState.
+class PoolBitmapAllocationState;
+
+/// @brief Type of the pointer to the @c PoolBitmapAllocationState.
+typedef boost::shared_ptr<PoolBitmapAllocationState> PoolBitmapAllocationStatePtr;
+
+/// @brief Pool allocation state used by the bitmap allocator.
+///
+/// The state holds one bit per lease of the pool, set when the lease is
+/// free. The bits are organized in a hierarchy of levels: a bit of a level
+/// is set when the corresponding 64 bit word of the level below has at
+/// least one bit set. The top level is a single word. Finding a free lease
+/// examines one word per level, i.e. it takes a few word reads even for
+/// pools with millions of leases, while the upper levels add less than
+/// 2% to the one bit per lease of the bottom level.
+///
+/// The free leases are offered in address order, starting after the last
+/// offered lease and wrapping around at the end of the pool, so successive
+/// offers spread over the pool before the offered leases are allocated.
+class PoolBitmapAllocationState : public AllocationState {
+public:
+
+    /// @brief Maximum number of leases in a pool.
+    ///
+    /// It bounds the bitmap size to 512MB.
+    static const uint64_t MAX_CAPACITY = 0x100000000ULL;
+
+    /// @brief Factory function creating the state instance from a pool.
+    ///
+    /// @param pool instance of the pool for which the allocation state
+    /// should be instantiated.
+    /// @return new allocation state instance.
+    /// @throw BadValue if the pool has more than @c MAX_CAPACITY leases.
+    static PoolBitmapAllocationStatePtr create(const PoolPtr& pool);
+
+    /// @brief Constructor.
+    ///
+    /// Instantiates the allocation state for the pool. All the leases
+    /// are initially in use.
+    ///
+    /// @param pool pool instance.
+    /// @throw BadValue if the pool has more than @c MAX_CAPACITY leases.
+    PoolBitmapAllocationState(const PoolPtr& pool);
+
+    /// @brief Checks if the pool has run out of free leases.
+    ///
+    /// @return true if the pool has no free leases, false otherwise.
+    bool exhausted() const;
+
+    /// @brief Marks all the leases of the pool free.
+    void setAllFree();
+
+    /// @brief Marks a lease free.
+    ///
+    /// Addresses outside the pool are ignored.
+    ///
+    /// @param address lease address.
+    void addFreeLease(const asiolink::IOAddress& address);
+
+    /// @brief Marks a lease in use.
+    ///
+    /// Addresses outside the pool are ignored.
+    ///
+    /// @param address lease address.
+    void deleteFreeLease(const asiolink::IOAddress& address);
+
+    /// @brief Returns next available lease.
+    ///
+    /// The lease remains free until it is allocated.
+    ///
+    /// @return next free lease address or IPv4/IPv6 zero address when
+    /// there are no free leases.
+    asiolink::IOAddress offerFreeLease();
+
+    /// @brief Returns the current number of free leases.
+    ///
+    /// @return the number of free leases.
+    uint64_t getFreeLeaseCount() const;
+
+private:
+
+    /// @brief Returns the offset of a lease in the pool.
+    ///
+    /// @param address lease address.
+    /// @param [out] offset the offset.
+    /// @return true if the address is in the pool, false otherwise.
+    bool getOffset(const asiolink::IOAddress& address, uint64_t& offset) const;
+
+    /// @brief Returns the lease address at an offset in the pool.
+    ///
+    /// @param offset the offset.
+    /// @return the lease address.
+    asiolink::IOAddress getAddress(uint64_t offset) const;
+
+    /// @brief Sets a bit and its parents.
+    ///
+    /// @param offset the offset of the bit in the bottom level.
+    void setBit(uint64_t offset);
+
+    /// @brief Clears a bit and its parents which no longer have any
+    /// bit set below them.
+    ///
+    /// @param offset the offset of the bit in the bottom level.
+    void clearBit(uint64_t offset);
+
+    /// @brief Finds the first set bit at or after an offset in a level.
+    ///
+    /// @param level the level.
+    /// @param from the offset to start from.
+    /// @return the offset of the set bit or @c NOT_FOUND.
+    uint64_t findNext(size_t level, uint64_t from) const;
+
+    /// @brief Value returned by @c findNext when there is no set bit.
+    static const uint64_t NOT_FOUND = ~0ULL;
+
+    /// @brief Lease type.
+    Lease::Type type_;
+
+    /// @brief First lease address of the pool.
+    asiolink::IOAddress first_;
+
+    /// @brief The first address of the pool as a number (IPv4 only).
+    uint32_t first4_;
+
+    /// @brief Number of bits to shift an offset to get the distance between
+    /// delegated prefixes.
+    uint8_t shift_;
+
+    /// @brief Number of leases in the pool.
+    uint64_t capacity_;
+
+    /// @brief Bitmap levels, the first is the one bit per lease level.
+    std::vector<std::vector<uint64_t>> levels_;
+
+    /// @brief Number of free leases.
+    uint64_t free_count_;
+
+    /// @brief Offset from which the next free lease is searched.
+    uint64_t next_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // BITMAP_ALLOCATION_STATE_H
@@ -0,0 +1,275 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/subnet.h>
+#include <util/stopwatch.h>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+/// @brief An owner string used in the callbacks installed in
+/// the lease manager.
+const string BITMAP_OWNER = "bitmap";
+}
+
+namespace isc {
+namespace dhcp {
+
+BitmapAllocator::BitmapAllocator(Lease::Type type, const WeakSubnetPtr& subnet)
+    : Allocator(type, subnet), generator_() {
+    random_device rd;
+    generator_.seed(rd());
+}
+
+IOAddress
+BitmapAllocator::pickAddressInternal(const ClientClasses& client_classes,
+                                     const IdentifierBaseTypePtr&,
+                                     const IOAddress&) {
+    auto subnet = subnet_.lock();
+    auto const& pools = subnet->getPools(pool_type_);
+    IOAddress zero = (pool_type_ == Lease::TYPE_V4 ? IOAddress::IPV4_ZERO_ADDRESS() :
+                      IOAddress::IPV6_ZERO_ADDRESS());
+    // Let's first iterate over the pools and identify the ones that
+    // meet client class criteria and are not exhausted.
+    std::vector<uint64_t> available;
+    for (auto i = 0; i < pools.size(); ++i) {
+        if (pools[i]->clientSupported(client_classes) &&
+            !getPoolState(pools[i])->exhausted()) {
+            available.push_back(i);
+        }
+    }
+    if (available.empty()) {
+        // No pool meets the client class criteria or all are exhausted.
+        return (zero);
+    }
+    // Get a random pool from the available ones.
+    auto const& pool = pools[available[getRandomNumber(available.size() - 1)]];
+    return (getPoolState(pool)->offerFreeLease());
+}
+
+IOAddress
+BitmapAllocator::pickPrefixInternal(const ClientClasses& client_classes,
+                                    Pool6Ptr& pool6,
+                                    const IdentifierBaseTypePtr&,
+                                    PrefixLenMatchType prefix_length_match,
+                                    const IOAddress&,
+                                    uint8_t hint_prefix_length) {
+    auto subnet = subnet_.lock();
+    auto const& pools = subnet->getPools(pool_type_);
+    // Let's first iterate over the pools and identify the ones that
+    // meet client class and prefix length criteria and are not exhausted.
+    std::vector<uint64_t> available;
+    for (auto i = 0; i < pools.size(); ++i) {
+        if (pools[i]->clientSupported(client_classes) &&
+            Allocator::isValidPrefixPool(prefix_length_match, pools[i],
+                                         hint_prefix_length) &&
+            !getPoolState(pools[i])->exhausted()) {
+            available.push_back(i);
+        }
+    }
+    if (available.empty()) {
+        // No pool meets the criteria or all are exhausted.
+        return (IOAddress::IPV6_ZERO_ADDRESS());
+    }
+    // Get a random pool from the available ones.
+    auto const& pool = pools[available[getRandomNumber(available.size() - 1)]];
+    pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+    if (!pool6) {
+        // Something is gravely wrong here
+        isc_throw(Unexpected, "Wrong type of pool: "
+                  << (pool)->toText()
+                  << " is not Pool6");
+    }
+    return (getPoolState(pool)->offerFreeLease());
+}
+
+void
+BitmapAllocator::initAfterConfigurePrepare() {
+    auto subnet = subnet_.lock();
+    if (subnet->getPools(pool_type_).empty()) {
+        // If there are no pools there is nothing to do.
+        return;
+    }
+    switch (pool_type_) {
+    case Lease::TYPE_V4:
+        leases4_ = LeaseMgrFactory::instance().getLeases4(subnet->getID());
+        break;
+    case Lease::TYPE_NA:
+    case Lease::TYPE_TA:
+    case Lease::TYPE_PD:
+        leases6_ = LeaseMgrFactory::instance().getLeases6(subnet->getID());
+        break;
+    default:
+        ;
+    }
+}
+
+void
+BitmapAllocator::initAfterConfigureInternal() {
+    auto subnet = subnet_.lock();
+    auto const& pools = subnet->getPools(pool_type_);
+    if (pools.empty()) {
+        // If there are no pools there is nothing to do.
+        return;
+    }
+    if (pool_type_ == Lease::TYPE_V4) {
+        populateFreeLeases(leases4_, pools);
+    } else {
+        populateFreeLeases(leases6_, pools);
+    }
+    // The leases are no longer needed.
+    Lease4Collection().swap(leases4_);
+    Lease6Collection().swap(leases6_);
+}
+
+void
+BitmapAllocator::initAfterConfigureFinish() {
+    auto subnet = subnet_.lock();
+    if (subnet->getPools(pool_type_).empty()) {
+        // If there are no pools there is nothing to track.
+        return;
+    }
+    // Install the callbacks for lease add, update and delete in the interface manager.
+    // These callbacks will ensure that we have up-to-date free lease bitmaps.
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_ADD_LEASE, BITMAP_OWNER, subnet->getID(), pool_type_,
+                               std::bind(&BitmapAllocator::addLeaseCallback, this,
+                                         std::placeholders::_1));
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_UPDATE_LEASE, BITMAP_OWNER, subnet->getID(), pool_type_,
+                               std::bind(&BitmapAllocator::updateLeaseCallback, this,
+                                         std::placeholders::_1));
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_DELETE_LEASE, BITMAP_OWNER, subnet->getID(), pool_type_,
+                               std::bind(&BitmapAllocator::deleteLeaseCallback, this,
+                                         std::placeholders::_1));
+}
+
+template<typename LeaseCollectionType>
+void
+BitmapAllocator::populateFreeLeases(const LeaseCollectionType& leases,
+                                    const PoolCollection& pools) {
+    auto subnet = subnet_.lock();
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_BITMAP_POPULATE_FREE_LEASES)
+        .arg(subnet->toText());
+
+    Stopwatch stopwatch;
+
+    // Start with all the leases free.
+    for (auto const& pool : pools) {
+        getPoolState(pool)->setAllFree();
+    }
+    // Mark the leases in use, eliminating the expired leases and those
+    // in the expired-reclaimed state.
+    for (auto const& lease : leases) {
+        if ((lease->getType() == pool_type_) && (!lease->expired()) && (!lease->stateExpiredReclaimed())) {
+            auto pool = getLeasePool(lease);
+            if (pool) {
+                getPoolState(pool)->deleteFreeLease(lease->addr_);
+            }
+        }
+    }
+    uint64_t free_lease_count = 0;
+    for (auto const& pool : pools) {
+        free_lease_count += getPoolState(pool)->getFreeLeaseCount();
+    }
+
+    stopwatch.stop();
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_BITMAP_POPULATE_FREE_LEASES_DONE)
+        .arg(free_lease_count)
+        .arg(subnet->toText())
+        .arg(stopwatch.logFormatLastDuration());
+}
+
+PoolBitmapAllocationStatePtr
+BitmapAllocator::getPoolState(const PoolPtr& pool) const {
+    if (!pool->getAllocationState()) {
+        pool->setAllocationState(PoolBitmapAllocationState::create(pool));
+    }
+    return (boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool->getAllocationState()));
+}
+
+PoolPtr
+BitmapAllocator::getLeasePool(const LeasePtr& lease) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (PoolPtr());
+    }
+    auto pool = subnet->getPool(pool_type_, lease->addr_, false);
+    return (pool);
+}
+
+void
+BitmapAllocator::addLeaseCallback(LeasePtr lease) {
+    MultiThreadingLock lock(mutex_);
+    addLeaseCallbackInternal(lease);
+}
+
+void
+BitmapAllocator::addLeaseCallbackInternal(LeasePtr lease) {
+    if (lease->expired()) {
+        return;
+    }
+    auto pool = getLeasePool(lease);
+    if (!pool) {
+        return;
+    }
+    getPoolState(pool)->deleteFreeLease(lease->addr_);
+}
+
+void
+BitmapAllocator::updateLeaseCallback(LeasePtr lease) {
+    MultiThreadingLock lock(mutex_);
+    updateLeaseCallbackInternal(lease);
+}
+
+void
+BitmapAllocator::updateLeaseCallbackInternal(LeasePtr lease) {
+    auto pool = getLeasePool(lease);
+    if (!pool) {
+        return;
+    }
+    auto pool_state = getPoolState(pool);
+    if (lease->stateExpiredReclaimed() || (lease->expired())) {
+        pool_state->addFreeLease(lease->addr_);
+    } else {
+        pool_state->deleteFreeLease(lease->addr_);
+    }
+}
+
+void
+BitmapAllocator::deleteLeaseCallback(LeasePtr lease) {
+    MultiThreadingLock lock(mutex_);
+    deleteLeaseCallbackInternal(lease);
+}
+
+void
+BitmapAllocator::deleteLeaseCallbackInternal(LeasePtr lease) {
+    auto pool = getLeasePool(lease);
+    if (!pool) {
+        return;
+    }
+    getPoolState(pool)->addFreeLease(lease->addr_);
+}
+
+uint64_t
+BitmapAllocator::getRandomNumber(uint64_t limit) {
+    // Take the short path if there is only one number to randomize from.
+    if (limit == 0) {
+        return (0);
+    }
+    std::uniform_int_distribution<uint64_t> dist(0, limit);
+    return (dist(generator_));
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
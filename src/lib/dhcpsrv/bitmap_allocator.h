@@ -0,0 +1,196 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BITMAP_ALLOCATOR_H
+#define BITMAP_ALLOCATOR_H
+
+#include <dhcpsrv/allocator.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <cstdint>
+#include <random>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief An allocator maintaining bitmaps of free leases.
+///
+/// This allocator is similar to the @c FreeLeaseQueueAllocator: it tracks
+/// the lease allocations with the callbacks it installs in the @c LeaseMgr
+/// and offers leases known to be free, minimizing the number of the
+/// allocation engine's attempts to check if some other client is using
+/// the offered lease. The free leases are held in a hierarchical bitmap
+/// (see @c PoolBitmapAllocationState) using about one bit per lease
+/// instead of a queue entry per free lease, and the bitmaps are populated
+/// by marking the whole pools free and then marking the leases found in
+/// the database in use.
+///
+/// It is suitable for large IPv4 pools (e.g., /8) and for IPv6 address and
+/// prefix delegation pools with up to 2^32 leases. It is not suitable for
+/// a typical IPv6 address pool (e.g., /64).
+class BitmapAllocator : public Allocator {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param type specifies the type of allocated leases.
+    /// @param subnet weak pointer to the subnet owning the allocator.
+    BitmapAllocator(Lease::Type type, const WeakSubnetPtr& subnet);
+
+    /// @brief Returns the allocator type string.
+    ///
+    /// @return bitmap string.
+    virtual std::string getType() const {
+        return ("bitmap");
+    }
+
+private:
+
+    /// @brief Fetches the leases of the subnet from the lease manager.
+    virtual void initAfterConfigurePrepare();
+
+    /// @brief Performs allocator initialization after server's reconfiguration.
+    ///
+    /// The allocator populates the free lease bitmaps using the leases
+    /// fetched by the @c initAfterConfigurePrepare.
+    virtual void initAfterConfigureInternal();
+
+    /// @brief Installs the callbacks in the lease manager to keep track of
+    /// the lease allocations.
+    virtual void initAfterConfigureFinish();
+
+    /// @brief Populates the free lease bitmaps.
+    ///
+    /// It marks all the leases of the subnet pools free and then marks
+    /// the leases in the list in use.
+    ///
+    /// @param lease collection of leases in the database for a subnet.
+    /// @param pools collection of pools in the subnet.
+    /// @tparam LeaseCollectionType Type of the lease collection returned from the
+    /// database (i.e., @c Lease4Collection or @c Lease6Collection).
+    template<typename LeaseCollectionType>
+    void populateFreeLeases(const LeaseCollectionType& leases,
+                            const PoolCollection& pools);
+
+    /// @brief Returns next available address.
+    ///
+    /// Internal thread-unsafe implementation of the @c pickAddress.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    /// @param duid client DUID (ignored).
+    /// @param hint client hint (ignored).
+    ///
+    /// @return next offered address.
+    virtual asiolink::IOAddress pickAddressInternal(const ClientClasses& client_classes,
+                                                    const IdentifierBaseTypePtr& duid,
+                                                    const asiolink::IOAddress& hint);
+
+    /// @brief Returns next available delegated prefix.
+    ///
+    /// Internal thread-unsafe implementation of the @c pickPrefix.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    /// @param pool the selected pool satisfying all required conditions.
+    /// @param duid Client's DUID.
+    /// @param prefix_length_match type which indicates the selection criteria
+    ///        for the pools relative to the provided hint prefix length
+    /// @param hint Client's hint.
+    /// @param hint_prefix_length the hint prefix length that the client
+    ///        provided. The 0 value means that there is no hint and that any
+    ///        pool will suffice.
+    ///
+    /// @return the next prefix.
+    virtual isc::asiolink::IOAddress
+    pickPrefixInternal(const ClientClasses& client_classes,
+                       Pool6Ptr& pool,
+                       const IdentifierBaseTypePtr& duid,
+                       PrefixLenMatchType prefix_length_match,
+                       const isc::asiolink::IOAddress& hint,
+                       uint8_t hint_prefix_length);
+
+    /// @brief Convenience function returning pool allocation state instance.
+    ///
+    /// It creates a new pool state instance and assigns it to the pool
+    /// if it hasn't been initialized.
+    ///
+    /// @param pool pool instance.
+    /// @return allocation state instance for the pool.
+    PoolBitmapAllocationStatePtr getPoolState(const PoolPtr& pool) const;
+
+    /// @brief Returns a pool in the subnet the lease belongs to.
+    ///
+    /// @param lease lease instance for which the pool should be returned.
+    /// @return A pool found for a lease or null pointer if such a pool does
+    /// not exist.
+    PoolPtr getLeasePool(const LeasePtr& lease) const;
+
+    /// @brief Thread safe callback for adding a lease.
+    ///
+    /// Marks the lease in use.
+    ///
+    /// @param lease added lease.
+    void addLeaseCallback(LeasePtr lease);
+
+    /// @brief Thread unsafe callback for adding a lease.
+    ///
+    /// Marks the lease in use.
+    ///
+    /// @param lease added lease.
+    void addLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Thread safe callback for updating a lease.
+    ///
+    /// If the lease is reclaimed or expired it is marked free, otherwise
+    /// it is marked in use.
+    ///
+    /// @param lease updated lease.
+    void updateLeaseCallback(LeasePtr lease);
+
+    /// @brief Thread unsafe callback for updating a lease.
+    ///
+    /// If the lease is reclaimed or expired it is marked free, otherwise
+    /// it is marked in use.
+    ///
+    /// @param lease updated lease.
+    void updateLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Thread safe callback for deleting a lease.
+    ///
+    /// Marks the lease free.
+    ///
+    /// @param lease deleted lease.
+    void deleteLeaseCallback(LeasePtr lease);
+
+    /// @brief Thread unsafe callback for deleting a lease.
+    ///
+    /// Marks the lease free.
+    ///
+    /// @param lease deleted lease.
+    void deleteLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Convenience function returning a random number.
+    ///
+    /// It is used internally by the @c pickAddressInternal and @c pickPrefixInternal
+    /// functions to select a random pool.
+    ///
+    /// @param limit upper bound of the range.
+    /// @returns random number between 0 and limit.
+    uint64_t getRandomNumber(uint64_t limit);
+
+    /// @brief Random generator used by this class.
+    std::mt19937 generator_;
+
+    /// @brief IPv4 leases fetched to populate the free lease bitmaps.
+    Lease4Collection leases4_;
+
+    /// @brief IPv6 leases fetched to populate the free lease bitmaps.
+    Lease6Collection leases6_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // BITMAP_ALLOCATOR_H
@@ -40,6 +40,8 @@ CfgSubnets4::add(const Subnet4Ptr& subnet) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_ADD_SUBNET4)
               .arg(subnet->toText());
     static_cast<void>(subnets_.insert(subnet));
+    index_.reset();
+    index4o6_.reset();
 }
 
 Subnet4Ptr
@@ -53,6 +55,8 @@ CfgSubnets4::replace(const Subnet4Ptr& subnet) {
     }
     Subnet4Ptr old = *subnet_it;
     bool ret = index.replace(subnet_it, subnet);
+    index_.reset();
+    index4o6_.reset();
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_UPDATE_SUBNET4)
         .arg(subnet_id).arg(ret);
@@ -80,6 +84,8 @@ CfgSubnets4::del(const SubnetID& subnet_id) {
     Subnet4Ptr subnet = *subnet_it;
 
     index.erase(subnet_it);
+    index_.reset();
+    index4o6_.reset();
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_DEL_SUBNET4)
         .arg(subnet->toText());
@@ -90,6 +96,8 @@ CfgSubnets4::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks4Ptr networks,
                    CfgSubnets4& other) {
     auto& index_id = subnets_.get<SubnetSubnetIdIndexTag>();
     auto& index_prefix = subnets_.get<SubnetPrefixIndexTag>();
+    index_.reset();
+    index4o6_.reset();
 
     // Iterate over the subnets to be merged. They will replace the existing
     // subnets with the same id. All new subnets will be inserted into the
@@ -260,6 +268,37 @@ CfgSubnets4::initSelector(const Pkt4Ptr& query) {
 
 ConstSubnet4Ptr
 CfgSubnets4::selectSubnet4o6(const SubnetSelector& selector) const {
+    if (index4o6_) {
+        // The subnet matching any of the criteria with the lowest
+        // position is the one the iteration would have returned.
+        auto any = [](const Subnet4Ptr&) {
+            return (true);
+        };
+        auto best = index4o6_->findByPrefix(selector.remote_address_, any);
+        if (selector.interface_id_) {
+            auto interface_id_match = [&selector](const Subnet4Ptr& subnet) {
+                return (subnet->get4o6().getInterfaceId()->equals(selector.interface_id_));
+            };
+            auto entry = index4o6_->findByKey(selector.interface_id_->getData(),
+                                              interface_id_match);
+            if (entry.position_ < best.position_) {
+                best = entry;
+            }
+        }
+        if (!selector.iface_name_.empty()) {
+            auto entry = index4o6_->findByIface(selector.iface_name_, any);
+            if (entry.position_ < best.position_) {
+                best = entry;
+            }
+        }
+        if (best.subnet_) {
+            return (best.subnet_);
+        }
+
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_SUBNET4O6_SELECT_FAILED);
+        return (ConstSubnet4Ptr());
+    }
+
     for (auto const& subnet : subnets_) {
         Cfg4o6& cfg4o6 = subnet->get4o6();
 
@@ -317,13 +356,12 @@ CfgSubnets4::selectSubnet(const SubnetSelector& selector) const {
     // addresses across all subnets, but we need to verify that for all subnets
     // before we can try to use the giaddr to match with the subnet prefix.
     if (!selector.giaddr_.isV4Zero()) {
-        for (auto const& subnet : subnets_) {
-
+        auto relay_match = [&selector](const Subnet4Ptr& subnet) {
             // If relay information is specified for this subnet, it must match.
             // Otherwise, we ignore this subnet.
             if (subnet->hasRelays()) {
                 if (!subnet->hasRelayAddress(selector.giaddr_)) {
-                    continue;
+                    return (false);
                 }
             } else {
                 // Relay information is not specified on the subnet level,
@@ -331,19 +369,32 @@ CfgSubnets4::selectSubnet(const SubnetSelector& selector) const {
                 SharedNetwork4Ptr network;
                 subnet->getSharedNetwork(network);
                 if (!network || !(network->hasRelayAddress(selector.giaddr_))) {
-                    continue;
+                    return (false);
                 }
             }
 
-            // If a subnet meets the client class criteria return it.
-            if (subnet->clientSupported(selector.client_classes_)) {
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                          DHCPSRV_CFGMGR_SUBNET4_RELAY)
-                    .arg(subnet->toText())
-                    .arg(selector.giaddr_.toText());
-                return (subnet);
+            // The subnet must meet the client class criteria.
+            return (subnet->clientSupported(selector.client_classes_));
+        };
+
+        Subnet4Ptr subnet;
+        if (index_) {
+            subnet = index_->selectByRelay(selector.giaddr_, relay_match);
+        } else {
+            for (auto const& candidate : subnets_) {
+                if (relay_match(candidate)) {
+                    subnet = candidate;
+                    break;
+                }
             }
         }
+        if (subnet) {
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                      DHCPSRV_CFGMGR_SUBNET4_RELAY)
+                .arg(subnet->toText())
+                .arg(selector.giaddr_.toText());
+            return (subnet);
+        }
         LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
                   DHCPSRV_SUBNET4_SELECT_BY_RELAY_ADDRESS_NO_MATCH)
             .arg(selector.giaddr_.toText());
@@ -415,13 +466,11 @@ CfgSubnets4::selectSubnet(const SubnetSelector& selector) const {
 ConstSubnet4Ptr
 CfgSubnets4::selectSubnet(const std::string& iface,
                           const ClientClasses& client_classes) const {
-    for (auto const& subnet : subnets_) {
-        ConstSubnet4Ptr subnet_selected;
-
+    auto iface_match = [&iface, &client_classes](const Subnet4Ptr& subnet) {
         // First, try subnet specific interface name.
         if (!subnet->getIface(Network4::Inheritance::NONE).empty()) {
-            if (subnet->getIface(Network4::Inheritance::NONE) == iface) {
-                subnet_selected = subnet;
+            if (subnet->getIface(Network4::Inheritance::NONE) != iface) {
+                return (false);
             }
 
         } else {
@@ -430,23 +479,34 @@ CfgSubnets4::selectSubnet(const std::string& iface,
             // the interface.
             SharedNetwork4Ptr network;
             subnet->getSharedNetwork(network);
-            if (network &&
-                (network->getIface(Network4::Inheritance::NONE) == iface)) {
-                subnet_selected = subnet;
+            if (!network ||
+                (network->getIface(Network4::Inheritance::NONE) != iface)) {
+                return (false);
             }
         }
 
-        if (subnet_selected) {
-            // If a subnet meets the client class criteria return it.
-            if (subnet_selected->clientSupported(client_classes)) {
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                          DHCPSRV_CFGMGR_SUBNET4_IFACE)
-                    .arg(subnet->toText())
-                    .arg(iface);
-                return (subnet_selected);
+        // The subnet must meet the client class criteria.
+        return (subnet->clientSupported(client_classes));
+    };
+
+    Subnet4Ptr subnet;
+    if (index_) {
+        subnet = index_->selectByIface(iface, iface_match);
+    } else {
+        for (auto const& candidate : subnets_) {
+            if (iface_match(candidate)) {
+                subnet = candidate;
+                break;
             }
         }
     }
+    if (subnet) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                  DHCPSRV_CFGMGR_SUBNET4_IFACE)
+            .arg(subnet->toText())
+            .arg(iface);
+        return (subnet);
+    }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
               DHCPSRV_SUBNET4_SELECT_BY_INTERFACE_NO_MATCH)
@@ -466,21 +526,30 @@ CfgSubnets4::getSubnet(const SubnetID subnet_id) const {
 ConstSubnet4Ptr
 CfgSubnets4::selectSubnet(const IOAddress& address,
                           const ClientClasses& client_classes) const {
-    for (auto const& subnet : subnets_) {
-
-        // Address is in range for the subnet prefix, so return it.
-        if (!subnet->inRange(address)) {
-            continue;
-        }
-
-        // If a subnet meets the client class criteria return it.
-        if (subnet->clientSupported(client_classes)) {
-            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_SUBNET4_ADDR)
-                .arg(subnet->toText())
-                .arg(address.toText());
-            return (subnet);
+    Subnet4Ptr subnet;
+    if (index_) {
+        // The index only returns the subnets with the address in range.
+        subnet = index_->selectByPrefix(address,
+                                        [&client_classes](const Subnet4Ptr& candidate) {
+            return (candidate->clientSupported(client_classes));
+        });
+    } else {
+        for (auto const& candidate : subnets_) {
+            // Address is in range for the subnet prefix and the subnet
+            // meets the client class criteria.
+            if (candidate->inRange(address) &&
+                candidate->clientSupported(client_classes)) {
+                subnet = candidate;
+                break;
+            }
         }
     }
+    if (subnet) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_SUBNET4_ADDR)
+            .arg(subnet->toText())
+            .arg(address.toText());
+        return (subnet);
+    }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
               DHCPSRV_SUBNET4_SELECT_BY_ADDRESS_NO_MATCH)
@@ -493,6 +562,12 @@ CfgSubnets4::selectSubnet(const IOAddress& address,
 SubnetIDSet
 CfgSubnets4::getLinks(const IOAddress& link_addr) const {
     SubnetIDSet links;
+    if (index_) {
+        for (auto const& entry : index_->getByPrefix(link_addr)) {
+            links.insert(entry.subnet_->getID());
+        }
+        return (links);
+    }
     for (auto const& subnet : subnets_) {
         if (!subnet->inRange(link_addr)) {
             continue;
@@ -611,15 +686,79 @@ CfgSubnets4::updateStatistics() {
 }
 
 void
-CfgSubnets4::initAllocatorsAfterConfigure() {
+CfgSubnets4::initAllocatorsAfterConfigure(uint32_t thread_count,
+                                           const boost::shared_ptr<const CfgSubnets4>& previous) {
+    std::vector<AllocatorPtr> allocators;
+    for (auto const& subnet : subnets_) {
+        if (previous && (previous.get() != this)) {
+            auto previous_subnet = previous->getBySubnetId(subnet->getID());
+            if (previous_subnet && (previous_subnet != subnet)) {
+                subnet->reuseAllocationStates(*previous_subnet);
+            }
+        }
+        auto subnet_allocators = subnet->getAllocators();
+        allocators.insert(allocators.end(), subnet_allocators.begin(),
+                          subnet_allocators.end());
+    }
+    Allocator::initAllocatorsAfterConfigure(allocators, thread_count);
+}
+
+void
+CfgSubnets4::buildSelectionIndex() {
+    boost::shared_ptr<SubnetSelectionIndex4> index(new SubnetSelectionIndex4());
+    boost::shared_ptr<SubnetSelectionIndex4> index4o6(new SubnetSelectionIndex4());
+    size_t position = 0;
     for (auto const& subnet : subnets_) {
-        subnet->initAllocatorsAfterConfigure();
+        auto const& prefix = subnet->get();
+        index->addPrefix(prefix.first, prefix.second, position, subnet);
+
+        SharedNetwork4Ptr network;
+        subnet->getSharedNetwork(network);
+
+        // Same relay and interface rules as the selection.
+        if (subnet->hasRelays()) {
+            for (auto const& address : subnet->getRelayAddresses()) {
+                index->addRelay(address, position, subnet);
+            }
+        } else if (network) {
+            for (auto const& address : network->getRelayAddresses()) {
+                index->addRelay(address, position, subnet);
+            }
+        }
+        std::string iface = subnet->getIface(Network4::Inheritance::NONE).get();
+        if (iface.empty() && network) {
+            iface = network->getIface(Network4::Inheritance::NONE).get();
+        }
+        if (!iface.empty() || network) {
+            index->addIface(iface, position, subnet);
+        }
+
+        // Same matching criteria as the 4o6 selection.
+        Cfg4o6& cfg4o6 = subnet->get4o6();
+        if (cfg4o6.enabled()) {
+            std::pair<IOAddress, uint8_t> pref = cfg4o6.getSubnet4o6();
+            if (!pref.first.isV6Zero()) {
+                index4o6->addPrefix(pref.first, pref.second, position, subnet);
+            }
+            if (cfg4o6.getInterfaceId()) {
+                index4o6->addKey(cfg4o6.getInterfaceId()->getData(), position,
+                                 subnet);
+            }
+            if (!cfg4o6.getIface4o6().empty()) {
+                index4o6->addIface(cfg4o6.getIface4o6(), position, subnet);
+            }
+        }
+        ++position;
     }
+    index_ = index;
+    index4o6_ = index4o6;
 }
 
 void
 CfgSubnets4::clear() {
     subnets_.clear();
+    index_.reset();
+    index4o6_.reset();
 }
 
 ElementPtr
@@ -13,6 +13,7 @@
 #include <dhcpsrv/cfg_shared_networks.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/subnet_id.h>
+#include <dhcpsrv/subnet_selection_index.h>
 #include <dhcpsrv/subnet_selector.h>
 #include <boost/shared_ptr.hpp>
 #include <string>
@@ -20,6 +21,9 @@
 namespace isc {
 namespace dhcp {
 
+/// @brief Index used to select an IPv4 subnet.
+typedef SubnetSelectionIndex<Subnet4Ptr> SubnetSelectionIndex4;
+
 /// @brief Holds subnets configured for the DHCPv4 server.
 ///
 /// This class holds a collection of subnets configured for the DHCPv4 server.
@@ -204,13 +208,9 @@ public:
     ///
     /// If the address matches with a subnet, the subnet is returned.
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets (possibly a couple of times)
-    /// to find the one which fulfills the search criteria. The subnet storage
-    /// is implemented as a simple STL vector which precludes fast searches
-    /// using specific keys. Hence, full scan is required. To improve the
-    /// search performance a different container type is required, e.g.
-    /// multi-index container, or something of a similar functionality.
+    /// When the selection index was built by @c buildSelectionIndex the
+    /// subnets are looked up in the index, else all the subnets are
+    /// iterated over. Both return the same subnet.
     ///
     /// @param selector Const reference to the selector structure which holds
     /// various information extracted from the client's packet which are used
@@ -235,13 +235,7 @@ public:
     /// testing. This method is also called by the
     /// @c selectSubnet(SubnetSelector).
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets to find the one which fulfills
-    /// the search criteria. The subnet storage is implemented as a simple
-    /// STL vector which precludes fast searches using specific keys.
-    /// Hence, full scan is required. To improve the search performance a
-    /// different container type is required, e.g. multi-index container,
-    /// or something of a similar functionality.
+    /// The subnets are looked up in the selection index when it was built.
     ///
     /// @param address Address for which the subnet is searched.
     /// @param client_classes Optional parameter specifying the classes that
@@ -260,13 +254,7 @@ public:
     /// not match a subnet definition. This method is also called by the
     /// @c selectSubnet(SubnetSelector).
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets to find the one which fulfills
-    /// the search criteria. The subnet storage is implemented as a simple
-    /// STL vector which precludes fast searches using specific keys.
-    /// Hence, full scan is required. To improve the search performance a
-    /// different container type is required, e.g. multi-index container,
-    /// or something of a similar functionality.
+    /// The subnets are looked up in the selection index when it was built.
     ///
     /// @param iface name of the interface to be matched.
     /// @param client_classes Optional parameter specifying the classes that
@@ -288,6 +276,9 @@ public:
     ///   with the name of the interface the incoming 4o6 packet was
     ///   received over.
     ///
+    /// The first subnet matching any of these criteria is returned. When
+    /// the selection index is built the candidates are looked up in it.
+    ///
     /// @todo: Add additional selection criteria. See
     ///  https://gitlab.isc.org/isc-projects/kea/wikis/designs/dhcpv4o6-design for details.
     ///
@@ -326,8 +317,42 @@ public:
     /// configuration and also subnet-ids may change.
     void removeStatistics();
 
-    /// @brief Calls @c initAllocatorsAfterConfigure for each subnet.
-    void initAllocatorsAfterConfigure();
+    /// @brief Initializes the allocators of the subnets after server's
+    /// reconfiguration.
+    ///
+    /// The allocators of the subnets which also exist in the previous
+    /// configuration first reuse the allocation states of the pools which
+    /// did not change (see @c Subnet::reuseAllocationStates). The
+    /// allocators are then initialized with
+    /// @c Allocator::initAllocatorsAfterConfigure, so the free leases of
+    /// different subnets can be populated in parallel.
+    ///
+    /// @param thread_count the number of threads used to initialize the
+    /// allocators. The allocators are initialized in the calling thread when
+    /// it is 0 or 1.
+    /// @param previous the subnets in the previous configuration, or null
+    /// when their allocation states must not be reused, e.g. because the
+    /// lease database changed.
+    void initAllocatorsAfterConfigure(uint32_t thread_count = 0,
+                                      const boost::shared_ptr<const CfgSubnets4>& previous =
+                                      boost::shared_ptr<const CfgSubnets4>());
+
+    /// @brief Builds the index used to select the subnets.
+    ///
+    /// The index is built when a configuration is committed and it is
+    /// dropped when a subnet is added, replaced or removed: the selection
+    /// then iterates over all the subnets until the index is rebuilt.
+    /// It must be rebuilt too when the relay addresses or the interface
+    /// of a subnet or of its shared network, or the 4o6 parameters of a
+    /// subnet are changed.
+    void buildSelectionIndex();
+
+    /// @brief Checks if the selection index is built.
+    ///
+    /// @return true if the selection index is built.
+    bool hasSelectionIndex() const {
+        return (static_cast<bool>(index_));
+    }
 
     /// @brief Clears all subnets from the configuration.
     void clear();
@@ -342,6 +367,17 @@ private:
     /// @brief A container for IPv4 subnets.
     Subnet4Collection subnets_;
 
+    /// @brief Index used to select the subnets.
+    ///
+    /// Null when it is not built.
+    boost::shared_ptr<SubnetSelectionIndex4> index_;
+
+    /// @brief Index used to select the 4o6 subnets.
+    ///
+    /// It holds the IPv6 prefixes, the interface identifiers and the
+    /// interface names of the 4o6 parameters. Null when it is not built.
+    boost::shared_ptr<SubnetSelectionIndex4> index4o6_;
+
 };
 
 /// @name Pointer to the @c CfgSubnets4 objects.
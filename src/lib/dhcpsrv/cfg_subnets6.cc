@@ -41,6 +41,7 @@ CfgSubnets6::add(const Subnet6Ptr& subnet) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_ADD_SUBNET6)
               .arg(subnet->toText());
     static_cast<void>(subnets_.insert(subnet));
+    index_.reset();
 }
 
 Subnet6Ptr
@@ -54,6 +55,7 @@ CfgSubnets6::replace(const Subnet6Ptr& subnet) {
     }
     Subnet6Ptr old = *subnet_it;
     bool ret = index.replace(subnet_it, subnet);
+    index_.reset();
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_UPDATE_SUBNET6)
         .arg(subnet_id).arg(ret);
@@ -81,6 +83,7 @@ CfgSubnets6::del(const SubnetID& subnet_id) {
     Subnet6Ptr subnet = *subnet_it;
 
     index.erase(subnet_it);
+    index_.reset();
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_DEL_SUBNET6)
         .arg(subnet->toText());
@@ -91,6 +94,7 @@ CfgSubnets6::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks6Ptr networks,
                    CfgSubnets6& other) {
     auto& index_id = subnets_.get<SubnetSubnetIdIndexTag>();
     auto& index_prefix = subnets_.get<SubnetPrefixIndexTag>();
+    index_.reset();
 
     // Iterate over the subnets to be merged. They will replace the existing
     // subnets with the same id. All new subnets will be inserted into the
@@ -269,43 +273,68 @@ CfgSubnets6::selectSubnet(const asiolink::IOAddress& address,
     // If the specified address is a relay address we first need to match
     // it with the relay addresses specified for all subnets.
     if (is_relay_address) {
-        for (auto const& subnet : subnets_) {
-
-            // If the specified address matches a relay address, return this
-            // subnet.
+        auto relay_match = [&address, &client_classes](const Subnet6Ptr& subnet) {
+            // The specified address must match a relay address.
             if (subnet->hasRelays()) {
                 if (!subnet->hasRelayAddress(address)) {
-                    continue;
+                    return (false);
                 }
 
             } else {
                 SharedNetwork6Ptr network;
                 subnet->getSharedNetwork(network);
                 if (!network || !network->hasRelayAddress(address)) {
-                    continue;
+                    return (false);
                 }
             }
 
-            if (subnet->clientSupported(client_classes)) {
-                // The relay address is matching the one specified for a subnet
-                // or its shared network.
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                          DHCPSRV_CFGMGR_SUBNET6_RELAY)
-                    .arg(subnet->toText()).arg(address.toText());
-                return (subnet);
+            return (subnet->clientSupported(client_classes));
+        };
+
+        Subnet6Ptr subnet;
+        if (index_) {
+            subnet = index_->selectByRelay(address, relay_match);
+        } else {
+            for (auto const& candidate : subnets_) {
+                if (relay_match(candidate)) {
+                    subnet = candidate;
+                    break;
+                }
             }
         }
+        if (subnet) {
+            // The relay address is matching the one specified for a subnet
+            // or its shared network.
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                      DHCPSRV_CFGMGR_SUBNET6_RELAY)
+                .arg(subnet->toText()).arg(address.toText());
+            return (subnet);
+        }
     }
 
     // No success so far. Check if the specified address is in range
     // with any subnet.
-    for (auto const& subnet : subnets_) {
-        if (subnet->inRange(address) && subnet->clientSupported(client_classes)) {
-            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_SUBNET6)
-                      .arg(subnet->toText()).arg(address.toText());
-            return (subnet);
+    Subnet6Ptr subnet;
+    if (index_) {
+        // The index only returns the subnets with the address in range.
+        subnet = index_->selectByPrefix(address,
+                                        [&client_classes](const Subnet6Ptr& candidate) {
+            return (candidate->clientSupported(client_classes));
+        });
+    } else {
+        for (auto const& candidate : subnets_) {
+            if (candidate->inRange(address) &&
+                candidate->clientSupported(client_classes)) {
+                subnet = candidate;
+                break;
+            }
         }
     }
+    if (subnet) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_SUBNET6)
+                  .arg(subnet->toText()).arg(address.toText());
+        return (subnet);
+    }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
               DHCPSRV_SUBNET6_SELECT_BY_ADDRESS_NO_MATCH)
@@ -320,19 +349,31 @@ CfgSubnets6::selectSubnet(const std::string& iface_name,
                           const ClientClasses& client_classes) const {
     // If empty interface specified, we can't select subnet by interface.
     if (!iface_name.empty()) {
-        for (auto const& subnet : subnets_) {
-
-            // If interface name matches with the one specified for the subnet
-            // and the client is not rejected based on the classification,
-            // return the subnet.
-            if ((subnet->getIface() == iface_name) &&
-                subnet->clientSupported(client_classes)) {
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                          DHCPSRV_CFGMGR_SUBNET6_IFACE)
-                    .arg(subnet->toText()).arg(iface_name);
-                return (subnet);
+        // If interface name matches with the one specified for the subnet
+        // and the client is not rejected based on the classification,
+        // return the subnet.
+        auto iface_match = [&iface_name, &client_classes](const Subnet6Ptr& subnet) {
+            return ((subnet->getIface() == iface_name) &&
+                    subnet->clientSupported(client_classes));
+        };
+
+        Subnet6Ptr subnet;
+        if (index_) {
+            subnet = index_->selectByIface(iface_name, iface_match);
+        } else {
+            for (auto const& candidate : subnets_) {
+                if (iface_match(candidate)) {
+                    subnet = candidate;
+                    break;
+                }
             }
         }
+        if (subnet) {
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                      DHCPSRV_CFGMGR_SUBNET6_IFACE)
+                .arg(subnet->toText()).arg(iface_name);
+            return (subnet);
+        }
     }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
@@ -349,20 +390,32 @@ CfgSubnets6::selectSubnet(const OptionPtr& interface_id,
     // We can only select subnet using an interface id, if the interface
     // id is known.
     if (interface_id) {
-        for (auto const& subnet : subnets_) {
-
-            // If interface id matches for the subnet and the subnet is not
-            // rejected based on the classification.
-            if (subnet->getInterfaceId() &&
-                subnet->getInterfaceId()->equals(interface_id) &&
-                subnet->clientSupported(client_classes)) {
-
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                      DHCPSRV_CFGMGR_SUBNET6_IFACE_ID)
-                    .arg(subnet->toText());
-                return (subnet);
+        // If interface id matches for the subnet and the subnet is not
+        // rejected based on the classification.
+        auto interface_id_match = [&interface_id, &client_classes](const Subnet6Ptr& subnet) {
+            return (subnet->getInterfaceId() &&
+                    subnet->getInterfaceId()->equals(interface_id) &&
+                    subnet->clientSupported(client_classes));
+        };
+
+        Subnet6Ptr subnet;
+        if (index_) {
+            subnet = index_->selectByKey(interface_id->getData(),
+                                         interface_id_match);
+        } else {
+            for (auto const& candidate : subnets_) {
+                if (interface_id_match(candidate)) {
+                    subnet = candidate;
+                    break;
+                }
             }
         }
+        if (subnet) {
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                  DHCPSRV_CFGMGR_SUBNET6_IFACE_ID)
+                .arg(subnet->toText());
+            return (subnet);
+        }
 
         LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
                   DHCPSRV_SUBNET6_SELECT_BY_INTERFACE_ID_NO_MATCH)
@@ -383,6 +436,12 @@ CfgSubnets6::getSubnet(const SubnetID subnet_id) const {
 SubnetIDSet
 CfgSubnets6::getLinks(const IOAddress& link_addr) const {
     SubnetIDSet links;
+    if (index_) {
+        for (auto const& entry : index_->getByPrefix(link_addr)) {
+            links.insert(entry.subnet_->getID());
+        }
+        return (links);
+    }
     for (auto const& subnet : subnets_) {
         if (!subnet->inRange(link_addr)) {
             continue;
@@ -558,15 +617,62 @@ CfgSubnets6::updateStatistics() {
 }
 
 void
-CfgSubnets6::initAllocatorsAfterConfigure() {
+CfgSubnets6::initAllocatorsAfterConfigure(uint32_t thread_count,
+                                           const boost::shared_ptr<const CfgSubnets6>& previous) {
+    std::vector<AllocatorPtr> allocators;
     for (auto const& subnet : subnets_) {
-        subnet->initAllocatorsAfterConfigure();
+        if (previous && (previous.get() != this)) {
+            auto previous_subnet = previous->getBySubnetId(subnet->getID());
+            if (previous_subnet && (previous_subnet != subnet)) {
+                subnet->reuseAllocationStates(*previous_subnet);
+            }
+        }
+        auto subnet_allocators = subnet->getAllocators();
+        allocators.insert(allocators.end(), subnet_allocators.begin(),
+                          subnet_allocators.end());
+    }
+    Allocator::initAllocatorsAfterConfigure(allocators, thread_count);
+}
+
+void
+CfgSubnets6::buildSelectionIndex() {
+    boost::shared_ptr<SubnetSelectionIndex6> index(new SubnetSelectionIndex6());
+    size_t position = 0;
+    for (auto const& subnet : subnets_) {
+        auto const& prefix = subnet->get();
+        index->addPrefix(prefix.first, prefix.second, position, subnet);
+
+        // Same relay and interface rules as the selection.
+        if (subnet->hasRelays()) {
+            for (auto const& address : subnet->getRelayAddresses()) {
+                index->addRelay(address, position, subnet);
+            }
+        } else {
+            SharedNetwork6Ptr network;
+            subnet->getSharedNetwork(network);
+            if (network) {
+                for (auto const& address : network->getRelayAddresses()) {
+                    index->addRelay(address, position, subnet);
+                }
+            }
+        }
+        std::string iface = subnet->getIface().get();
+        if (!iface.empty()) {
+            index->addIface(iface, position, subnet);
+        }
+        OptionPtr interface_id = subnet->getInterfaceId();
+        if (interface_id) {
+            index->addKey(interface_id->getData(), position, subnet);
+        }
+        ++position;
     }
+    index_ = index;
 }
 
 void
 CfgSubnets6::clear() {
     subnets_.clear();
+    index_.reset();
 }
 
 ElementPtr
@@ -14,6 +14,7 @@
 #include <dhcpsrv/cfg_shared_networks.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/subnet_id.h>
+#include <dhcpsrv/subnet_selection_index.h>
 #include <dhcpsrv/subnet_selector.h>
 #include <util/optional.h>
 #include <boost/shared_ptr.hpp>
@@ -22,6 +23,9 @@
 namespace isc {
 namespace dhcp {
 
+/// @brief Index used to select an IPv6 subnet.
+typedef SubnetSelectionIndex<Subnet6Ptr> SubnetSelectionIndex6;
+
 /// @brief Holds subnets configured for the DHCPv6 server.
 ///
 /// This class holds a collection of subnets configured for the DHCPv6 server.
@@ -188,13 +192,9 @@ public:
     /// associated with any subnet. If not, it is checked if the link address
     /// is in range with any of the subnets.
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets (possibly a couple of times)
-    /// to find the one which fulfills the search criteria. The subnet storage
-    /// is implemented as a simple STL vector which precludes fast searches
-    /// using specific keys. Hence, full scan is required. To improve the
-    /// search performance a different container type is required, e.g.
-    /// multi-index container, or something of a similar functionality.
+    /// When the selection index was built by @c buildSelectionIndex the
+    /// subnets are looked up in the index, else all the subnets are
+    /// iterated over. Both return the same subnet.
     ///
     /// @param selector Const reference to the selector structure which holds
     /// various information extracted from the client's packet which are used
@@ -228,13 +228,9 @@ public:
     /// address. For other purposes the @c selectSubnet(SubnetSelector) should
     /// rather be used instead.
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets (possibly a couple of times)
-    /// to find the one which fulfills the search criteria. The subnet storage
-    /// is implemented as a simple STL vector which precludes fast searches
-    /// using specific keys. Hence, full scan is required. To improve the
-    /// search performance a different container type is required, e.g.
-    /// multi-index container, or something of a similar functionality.
+    /// When the selection index was built by @c buildSelectionIndex the
+    /// subnets are looked up in the index, else all the subnets are
+    /// iterated over. Both return the same subnet.
     ///
     /// @param address Address for which the subnet is searched.
     /// @param client_classes Optional parameter specifying the classes that
@@ -276,8 +272,42 @@ public:
     /// configuration and also subnet-ids may change.
     void removeStatistics();
 
-    /// @brief Calls @c initAllocatorsAfterConfigure for each subnet.
-    void initAllocatorsAfterConfigure();
+    /// @brief Initializes the allocators of the subnets after server's
+    /// reconfiguration.
+    ///
+    /// The allocators of the subnets which also exist in the previous
+    /// configuration first reuse the allocation states of the pools which
+    /// did not change (see @c Subnet::reuseAllocationStates). The
+    /// allocators are then initialized with
+    /// @c Allocator::initAllocatorsAfterConfigure, so the free leases of
+    /// different subnets can be populated in parallel.
+    ///
+    /// @param thread_count the number of threads used to initialize the
+    /// allocators. The allocators are initialized in the calling thread when
+    /// it is 0 or 1.
+    /// @param previous the subnets in the previous configuration, or null
+    /// when their allocation states must not be reused, e.g. because the
+    /// lease database changed.
+    void initAllocatorsAfterConfigure(uint32_t thread_count = 0,
+                                      const boost::shared_ptr<const CfgSubnets6>& previous =
+                                      boost::shared_ptr<const CfgSubnets6>());
+
+    /// @brief Builds the index used to select the subnets.
+    ///
+    /// The index is built when a configuration is committed and it is
+    /// dropped when a subnet is added, replaced or removed: the selection
+    /// then iterates over all the subnets until the index is rebuilt.
+    /// It must be rebuilt too when the relay addresses, the interface or
+    /// the interface identifier of a subnet or of its shared network are
+    /// changed.
+    void buildSelectionIndex();
+
+    /// @brief Checks if the selection index is built.
+    ///
+    /// @return true if the selection index is built.
+    bool hasSelectionIndex() const {
+        return (static_cast<bool>(index_));
+    }
 
     /// @brief Clears all subnets from the configuration.
     void clear();
@@ -295,13 +325,7 @@ private:
     /// If any of the subnets is explicitly associated with the interface
     /// name, the subnet is returned.
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets to find the one which fulfills
-    /// the search criteria. The subnet storage is implemented as a
-    /// simple STL vector which precludes fast searches using specific
-    /// keys. Hence, full scan is required. To improve the search
-    /// performance a different container type is required, e.g.
-    /// multi-index container, or something of a similar functionality.
+    /// The subnets are looked up in the selection index when it was built.
     ///
     /// @param iface_name Interface name.
     /// @param client_classes Optional parameter specifying the classes that
@@ -319,13 +343,7 @@ private:
     /// of the subnets is explicitly associated with that interface id, the
     /// subnet is returned.
     ///
-    /// @todo This method requires performance improvement! It currently
-    /// iterates over all existing subnets to find the one which fulfills
-    /// the search criteria. The subnet storage is implemented as a
-    /// simple STL vector which precludes fast searches using specific
-    /// keys. Hence, full scan is required. To improve the search
-    /// performance a different container type is required, e.g.
-    /// multi-index container, or something of a similar functionality.
+    /// The subnets are looked up in the selection index when it was built.
     ///
     /// @param interface_id An instance of the Interface ID option received
     /// from the client.
@@ -340,6 +358,11 @@ private:
     /// @brief A container for IPv6 subnets.
     Subnet6Collection subnets_;
 
+    /// @brief Index used to select the subnets.
+    ///
+    /// Null when it is not built.
+    boost::shared_ptr<SubnetSelectionIndex6> index_;
+
 };
 
 /// @name Pointer to the @c CfgSubnets6 objects.
@@ -108,6 +108,10 @@ CfgMgr::commit() {
     // Now we need to set the statistics back.
     configuration_->updateStatistics();
 
+    // Build the subnet selection indexes.
+    configuration_->getCfgSubnets4()->buildSelectionIndex();
+    configuration_->getCfgSubnets6()->buildSelectionIndex();
+
     configuration_->configureLowerLevelLibraries();
 }
 
@@ -152,11 +156,18 @@ CfgMgr::mergeIntoCurrentCfg(const uint32_t seq) {
         LibDHCP::setRuntimeOptionDefs(getCurrentCfg()->getCfgOptionDef()->getContainer());
 
     } catch (...) {
-        // Make sure the statistics is updated even if the merge failed.
+        // Make sure the statistics and the subnet selection indexes are
+        // updated even if the merge failed.
         getCurrentCfg()->updateStatistics();
+        getCurrentCfg()->getCfgSubnets4()->buildSelectionIndex();
+        getCurrentCfg()->getCfgSubnets6()->buildSelectionIndex();
+        getCurrentCfg()->getOptionBlockCache()->clear();
         throw;
     }
     getCurrentCfg()->updateStatistics();
+    getCurrentCfg()->getCfgSubnets4()->buildSelectionIndex();
+    getCurrentCfg()->getCfgSubnets6()->buildSelectionIndex();
+    getCurrentCfg()->getOptionBlockCache()->clear();
 }
 
 void
@@ -9,11 +9,13 @@
 #include <eval/dependency.h>
 #include <eval/evaluate.h>
 #include <eval/eval_log.h>
+#include <eval/extraction_cache.h>
 #include <dhcpsrv/client_class_def.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/parsers/client_class_def_parser.h>
 
+#include <algorithm>
 #include <queue>
 
 using namespace isc::data;
@@ -27,7 +29,8 @@ ClientClassDef::ClientClassDef(const std::string& name,
                                const ExpressionPtr& match_expr,
                                const CfgOptionPtr& cfg_option)
     : UserContext(), CfgToElement(), StampedElement(), name_(name),
-      match_expr_(match_expr), additional_(false), depend_on_known_(false),
+      match_expr_(match_expr), compiled_expr_(), additional_(false),
+      depend_on_known_(false),
       cfg_option_(cfg_option), next_server_(asiolink::IOAddress::IPV4_ZERO_ADDRESS()),
       valid_(), preferred_() {
 
@@ -36,6 +39,16 @@ ClientClassDef::ClientClassDef(const std::string& name,
         isc_throw(BadValue, "Client Class name cannot be blank");
     }
 
+    // Intern the class name so the class membership of the packets is
+    // held in a bitset.
+    static_cast<void>(ClientClasses::internClass(name_));
+
+    // Compile the expression to evaluate it without the token by token
+    // interpretation.
+    if (match_expr_) {
+        compiled_expr_ = CompiledExpression::compile(*match_expr_);
+    }
+
     // We permit an empty expression for now.  This will likely be useful
     // for automatic classes such as vendor class.
     // For classes without options, make sure we have an empty collection
@@ -46,8 +59,8 @@ ClientClassDef::ClientClassDef(const std::string& name,
 
 ClientClassDef::ClientClassDef(const ClientClassDef& rhs)
     : UserContext(rhs), CfgToElement(rhs), StampedElement(rhs), name_(rhs.name_),
-      match_expr_(ExpressionPtr()), test_(rhs.test_), additional_(rhs.additional_),
-      depend_on_known_(rhs.depend_on_known_), cfg_option_(new CfgOption()),
+      match_expr_(ExpressionPtr()), compiled_expr_(), test_(rhs.test_),
+      additional_(rhs.additional_), depend_on_known_(rhs.depend_on_known_), cfg_option_(new CfgOption()),
       next_server_(rhs.next_server_), sname_(rhs.sname_),
       filename_(rhs.filename_), valid_(rhs.valid_), preferred_(rhs.preferred_),
       offer_lft_(rhs.offer_lft_) {
@@ -55,6 +68,7 @@ ClientClassDef::ClientClassDef(const ClientClassDef& rhs)
     if (rhs.match_expr_) {
         match_expr_.reset(new Expression());
         *match_expr_ = *rhs.match_expr_;
+        compiled_expr_ = CompiledExpression::compile(*match_expr_);
     }
 
     if (rhs.cfg_option_def_) {
@@ -78,6 +92,7 @@ ClientClassDef::getName() const {
 void
 ClientClassDef::setName(const std::string& name) {
     name_ = name;
+    static_cast<void>(ClientClasses::internClass(name_));
 }
 
 const ExpressionPtr&
@@ -88,6 +103,10 @@ ClientClassDef::getMatchExpr() const {
 void
 ClientClassDef::setMatchExpr(const ExpressionPtr& match_expr) {
     match_expr_ = match_expr;
+    compiled_expr_.reset();
+    if (match_expr_) {
+        compiled_expr_ = CompiledExpression::compile(*match_expr_);
+    }
 }
 
 std::string
@@ -145,7 +164,12 @@ ClientClassDef::test(PktPtr pkt, const ExpressionPtr& expr_ptr) {
     // Evaluate the expression which can return false (no match),
     // true (match) or raise an exception (error)
     try {
-        bool status = evaluateBool(*expr_ptr, *pkt);
+        bool status;
+        if (compiled_expr_ && (expr_ptr == match_expr_)) {
+            status = compiled_expr_->evaluateBool(*pkt);
+        } else {
+            status = evaluateBool(*expr_ptr, *pkt);
+        }
         LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_EVAL_RESULT)
             .arg(pkt->getLabel())
             .arg(getName())
@@ -175,7 +199,13 @@ TemplateClientClassDef::test(PktPtr pkt, const ExpressionPtr& expr_ptr) {
     // Evaluate the expression which can return false (no match),
     // true (match) or raise an exception (error)
     try {
-        std::string subclass = evaluateString(*expr_ptr, *pkt);
+        std::string subclass;
+        auto const& compiled_expr = getCompiledMatchExpr();
+        if (compiled_expr && (expr_ptr == getMatchExpr())) {
+            subclass = compiled_expr->evaluateString(*pkt);
+        } else {
+            subclass = evaluateString(*expr_ptr, *pkt);
+        }
         if (!subclass.empty()) {
             LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_TEMPLATE_EVAL_RESULT)
                 .arg(pkt->getLabel())
@@ -317,15 +347,35 @@ std::ostream& operator<<(std::ostream& os, const ClientClassDef& x) {
 
 //********** ClientClassDictionary ******************//
 
+namespace {
+
+/// @brief Copies a class definition keeping its type.
+///
+/// @param cclass pointer to the class definition to copy.
+/// @return pointer to the copy.
+ClientClassDefPtr
+copyClass(const ClientClassDefPtr& cclass) {
+    auto template_class = dynamic_cast<TemplateClientClassDef*>(cclass.get());
+    if (template_class) {
+        return (ClientClassDefPtr(new TemplateClientClassDef(*template_class)));
+    }
+    return (ClientClassDefPtr(new ClientClassDef(*cclass)));
+}
+
+}
+
 ClientClassDictionary::ClientClassDictionary()
-    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()) {
+    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()),
+      evaluated_(new ClientClassDefList()),
+      shared_tokens_() {
 }
 
 ClientClassDictionary::ClientClassDictionary(const ClientClassDictionary& rhs)
-    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()) {
+    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()),
+      evaluated_(new ClientClassDefList()),
+      shared_tokens_() {
     for (auto const& cclass : *rhs.list_) {
-        ClientClassDefPtr copy(new ClientClassDef(*cclass));
-        addClass(copy);
+        addClass(copyClass(cclass));
     }
 }
 
@@ -380,8 +430,44 @@ ClientClassDictionary::addClass(const ClientClassDefPtr& class_def) {
                   << class_def->getName() << " has already been defined");
     }
 
+    shareTokens(class_def);
     list_->push_back(class_def);
     (*map_)[class_def->getName()] = class_def;
+    if (class_def->getMatchExpr()) {
+        evaluated_->push_back(class_def);
+    }
+}
+
+void
+ClientClassDictionary::shareTokens(const ClientClassDefPtr& class_def) {
+    const ExpressionPtr& match_expr = class_def->getMatchExpr();
+    if (!match_expr) {
+        return;
+    }
+    ExpressionPtr shared;
+    for (size_t i = 0; i < match_expr->size(); ++i) {
+        const TokenPtr& token = (*match_expr)[i];
+        std::string key = ExtractionCache::getKey(token);
+        if (key.empty()) {
+            continue;
+        }
+        auto it = shared_tokens_.find(key);
+        if (it == shared_tokens_.end()) {
+            shared_tokens_[key] = token;
+            continue;
+        }
+        if (it->second == token) {
+            continue;
+        }
+        // The expression can be referenced elsewhere so it is copied.
+        if (!shared) {
+            shared.reset(new Expression(*match_expr));
+        }
+        (*shared)[i] = it->second;
+    }
+    if (shared) {
+        class_def->setMatchExpr(shared);
+    }
 }
 
 ClientClassDefPtr
@@ -399,6 +485,8 @@ ClientClassDictionary::removeClass(const std::string& name) {
     for (ClientClassDefList::iterator this_class = list_->begin();
          this_class != list_->end(); ++this_class) {
         if ((*this_class)->getName() == name) {
+            evaluated_->erase(std::remove(evaluated_->begin(), evaluated_->end(),
+                                          *this_class), evaluated_->end());
             list_->erase(this_class);
             break;
         }
@@ -415,6 +503,8 @@ ClientClassDictionary::removeClass(const uint64_t id) {
     for (ClientClassDefList::iterator this_class = list_->begin();
          this_class != list_->end(); ++this_class) {
         if ((*this_class)->getId() == id) {
+            evaluated_->erase(std::remove(evaluated_->begin(), evaluated_->end(),
+                                          *this_class), evaluated_->end());
             map_->erase((*this_class)->getName());
             list_->erase(this_class);
             break;
@@ -427,6 +517,11 @@ ClientClassDictionary::getClasses() const {
     return (list_);
 }
 
+const ClientClassDefListPtr&
+ClientClassDictionary::getEvaluatedClasses() const {
+    return (evaluated_);
+}
+
 bool
 ClientClassDictionary::empty() const {
     return (list_->empty());
@@ -496,6 +591,13 @@ ClientClassDictionary::initMatchExpr(uint16_t family) {
         if (!c->getTest().empty()) {
             c->setMatchExpr(expressions.front());
             expressions.pop();
+            shareTokens(c);
+        }
+    }
+    evaluated_->clear();
+    for (auto const& c : *list_) {
+        if (c->getMatchExpr()) {
+            evaluated_->push_back(c);
         }
     }
 }
@@ -565,9 +667,10 @@ ClientClassDictionary::operator=(const ClientClassDictionary& rhs) {
     if (this != &rhs) {
         list_->clear();
         map_->clear();
+        evaluated_->clear();
+        shared_tokens_.clear();
         for (auto const& cclass : *rhs.list_) {
-            ClientClassDefPtr copy(new ClientClassDef(*cclass));
-            addClass(copy);
+            addClass(copyClass(cclass));
         }
     }
     return (*this);
@@ -12,6 +12,7 @@
 #include <cc/user_context.h>
 #include <dhcpsrv/cfg_option.h>
 #include <dhcpsrv/cfg_option_def.h>
+#include <eval/compiled_expression.h>
 #include <eval/token.h>
 #include <exceptions/exceptions.h>
 #include <util/triplet.h>
@@ -77,9 +78,19 @@ public:
 
     /// @brief Sets the class's match expression
     ///
+    /// The expression is also compiled.
+    ///
     /// @param match_expr the expression to assign the class
     void setMatchExpr(const ExpressionPtr& match_expr);
 
+    /// @brief Fetches the class's compiled match expression
+    ///
+    /// @return the compiled match expression or null when there is no
+    /// match expression or it can't be compiled.
+    const CompiledExpressionPtr& getCompiledMatchExpr() const {
+        return (compiled_expr_);
+    }
+
     /// @brief Fetches the class's original match expression
     std::string getTest() const;
 
@@ -257,6 +268,9 @@ private:
     /// this class.
     ExpressionPtr match_expr_;
 
+    /// @brief The compiled match expression.
+    CompiledExpressionPtr compiled_expr_;
+
     /// @brief The original expression which determines membership in
     /// this class.
     std::string test_;
@@ -438,6 +452,18 @@ public:
     /// @return ClientClassDefListPtr to the list of classes
     const ClientClassDefListPtr& getClasses() const;
 
+    /// @brief Fetches the dictionary's list of classes with a match
+    /// expression
+    ///
+    /// The classes are in the dictionary order. The subclass definitions
+    /// of the template classes usually have no match expression so the
+    /// evaluation of the classes for a packet does not depend on their
+    /// number.
+    ///
+    /// @return ClientClassDefListPtr to the list of classes with a match
+    /// expression
+    const ClientClassDefListPtr& getEvaluatedClasses() const;
+
     /// @brief Checks if the class dictionary is empty.
     ///
     /// @return true if there are no classes, false otherwise.
@@ -506,11 +532,29 @@ public:
 
 private:
 
+    /// @brief Shares the extraction tokens of a class match expression.
+    ///
+    /// The extraction tokens of the match expression which are identical
+    /// to the extraction tokens of the match expressions of the classes
+    /// already in the dictionary are replaced by these tokens, so the
+    /// values they extract from a packet are cached once per packet
+    /// by the @c ExtractionCache and evaluated once for all the classes.
+    ///
+    /// @param class_def pointer to class definition.
+    void shareTokens(const ClientClassDefPtr& class_def);
+
     /// @brief Map of the class definitions
     ClientClassDefMapPtr map_;
 
     /// @brief List of the class definitions
     ClientClassDefListPtr list_;
+
+    /// @brief List of the class definitions with a match expression
+    ClientClassDefListPtr evaluated_;
+
+    /// @brief Extraction tokens shared by the match expressions, keyed
+    /// by @c ExtractionCache::getKey.
+    std::unordered_map<std::string, TokenPtr> shared_tokens_;
 };
 
 /// @brief Defines a pointer to a ClientClassDictionary
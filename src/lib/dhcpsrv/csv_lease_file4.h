@@ -26,6 +26,10 @@ namespace dhcp {
 /// and to the CSV file. It expects that the CSV file being parsed contains a
 /// set of columns with well known names (initialized in the class constructor).
 ///
+/// The @c open, @c append and @c next functions are virtual: the
+/// @c LeaseJournal4 derived class overrides them to store the leases in
+/// a binary format.
+///
 /// @todo This class doesn't validate the lease values read from the file.
 /// The @c Lease4 is a structure that should be itself responsible for this
 /// validation. However, the @c next function may need to be updated to use the
@@ -59,7 +63,7 @@ public:
     /// @param lease Structure representing a DHCPv4 lease.
     /// @throw BadValue if the lease has no hardware address, no client id and
     /// is not in STATE_DECLINED.
-    void append(const Lease4& lease);
+    virtual void append(const Lease4& lease);
 
     /// @brief Reads next lease from the CSV file.
     ///
@@ -81,7 +85,7 @@ public:
     ///
     /// @todo Make sure that the values read from the file are correct.
     /// The appropriate @c Lease4 validation mechanism should be used.
-    bool next(Lease4Ptr& lease);
+    virtual bool next(Lease4Ptr& lease);
 
 private:
 
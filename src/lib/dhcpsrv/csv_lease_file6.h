@@ -28,6 +28,10 @@ namespace dhcp {
 /// and to the CSV file. It expects that the CSV file being parsed contains a
 /// set of columns with well known names (initialized in the class constructor).
 ///
+/// The @c open, @c append and @c next functions are virtual: the
+/// @c LeaseJournal6 derived class overrides them to store the leases in
+/// a binary format.
+///
 /// @todo This class doesn't validate the lease values read from the file.
 /// The @c Lease6 is a structure that should be itself responsible for this
 /// validation. However, the @c next function may need to be updated to use the
@@ -61,7 +65,7 @@ public:
     /// @param lease Structure representing a DHCPv6 lease.
     /// @throw BadValue if the lease to be written has an empty DUID and is
     /// whose state is not STATE_DECLINED.
-    void append(const Lease6& lease);
+    virtual void append(const Lease6& lease);
 
     /// @brief Reads next lease from the CSV file.
     ///
@@ -80,7 +84,7 @@ public:
     ///
     /// @todo Make sure that the values read from the file are correct.
     /// The appropriate @c Lease6 validation mechanism should be used.
-    bool next(Lease6Ptr& lease);
+    virtual bool next(Lease6Ptr& lease);
 
 private:
 
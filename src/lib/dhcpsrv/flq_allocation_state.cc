@@ -19,7 +19,8 @@ PoolFreeLeaseQueueAllocationState::create(const PoolPtr& pool) {
 }
 
 PoolFreeLeaseQueueAllocationState::PoolFreeLeaseQueueAllocationState(Lease::Type type)
-    : AllocationState(), free_lease4_queue_(), free_lease6_queue_() {
+    : AllocationState(), free_lease4_queue_(), free_lease6_queue_(),
+      populated_(false) {
     if (type == Lease::TYPE_V4) {
         free_lease4_queue_ = boost::make_shared<FreeLeaseQueue<uint32_t>>();
     } else {
@@ -66,6 +66,21 @@ public:
     /// @return the number of free leases in the queue.
     size_t getFreeLeaseCount() const;
 
+    /// @brief Checks if the queue has been populated with the free leases.
+    ///
+    /// A populated state can be reused by the allocator of the same pool
+    /// after server's reconfiguration.
+    ///
+    /// @return true if the queue has been populated, false otherwise.
+    bool isPopulated() const {
+        return (populated_);
+    }
+
+    /// @brief Marks the queue as populated with the free leases.
+    void setPopulated() {
+        populated_ = true;
+    }
+
 private:
 
     /// @brief A multi-index container holding free leases.
@@ -99,6 +114,9 @@ private:
     /// @brief An instance of the multi-index container holding
     /// free IPv6 leases.
     FreeLease6QueuePtr free_lease6_queue_;
+
+    /// @brief Indicates if the queue has been populated with the free leases.
+    bool populated_;
 };
 
 
@@ -134,6 +134,78 @@ FreeLeaseQueueAllocator::pickPrefixInternal(const ClientClasses& client_classes,
     return (IOAddress::IPV6_ZERO_ADDRESS());
 }
 
+void
+FreeLeaseQueueAllocator::reuseAllocationStates(const Allocator& previous) {
+    auto previous_flq = dynamic_cast<const FreeLeaseQueueAllocator*>(&previous);
+    if (!previous_flq || (previous_flq == this)) {
+        return;
+    }
+    auto subnet = subnet_.lock();
+    auto previous_subnet = previous_flq->subnet_.lock();
+    if (!subnet || !previous_subnet) {
+        return;
+    }
+    auto const& previous_pools = previous_subnet->getPools(pool_type_);
+    for (auto const& pool : subnet->getPools(pool_type_)) {
+        // The pools of a parsed subnet have a fresh allocation state
+        // (see Subnet::createAllocators): only a populated one is kept.
+        auto state = boost::dynamic_pointer_cast<
+            PoolFreeLeaseQueueAllocationState>(pool->getAllocationState());
+        if (state && state->isPopulated()) {
+            continue;
+        }
+        for (auto const& previous_pool : previous_pools) {
+            if ((previous_pool->getFirstAddress() != pool->getFirstAddress()) ||
+                (previous_pool->getLastAddress() != pool->getLastAddress())) {
+                continue;
+            }
+            if (pool_type_ == Lease::TYPE_PD) {
+                auto pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+                auto previous_pool6 = boost::dynamic_pointer_cast<Pool6>(previous_pool);
+                if (!pool6 || !previous_pool6 ||
+                    (pool6->getLength() != previous_pool6->getLength())) {
+                    continue;
+                }
+            }
+            auto previous_state = boost::dynamic_pointer_cast<
+                PoolFreeLeaseQueueAllocationState>(previous_pool->getAllocationState());
+            if (previous_state && previous_state->isPopulated()) {
+                pool->setAllocationState(previous_state);
+            }
+            break;
+        }
+    }
+}
+
+void
+FreeLeaseQueueAllocator::initAfterConfigurePrepare() {
+    auto subnet = subnet_.lock();
+    auto const& pools = subnet->getPools(pool_type_);
+    // Only fetch the leases when some pools have to be populated.
+    bool populated = true;
+    for (auto const& pool : pools) {
+        if (!getPoolState(pool)->isPopulated()) {
+            populated = false;
+            break;
+        }
+    }
+    if (populated) {
+        return;
+    }
+    switch (pool_type_) {
+    case Lease::TYPE_V4:
+        leases4_ = LeaseMgrFactory::instance().getLeases4(subnet->getID());
+        break;
+    case Lease::TYPE_NA:
+    case Lease::TYPE_TA:
+    case Lease::TYPE_PD:
+        leases6_ = LeaseMgrFactory::instance().getLeases6(subnet->getID());
+        break;
+    default:
+        ;
+    }
+}
+
 void
 FreeLeaseQueueAllocator::initAfterConfigureInternal() {
     auto subnet = subnet_.lock();
@@ -142,25 +214,32 @@ FreeLeaseQueueAllocator::initAfterConfigureInternal() {
         // If there are no pools there is nothing to do.
         return;
     }
-    Lease4Collection leases4;
-    Lease6Collection leases6;
     switch (pool_type_) {
     case Lease::TYPE_V4:
-        leases4 = LeaseMgrFactory::instance().getLeases4(subnet->getID());
-        populateFreeAddressLeases(leases4, pools);
+        populateFreeAddressLeases(leases4_, pools);
         break;
     case Lease::TYPE_NA:
     case Lease::TYPE_TA:
-        leases6 = LeaseMgrFactory::instance().getLeases6(subnet->getID());
-        populateFreeAddressLeases(leases6, pools);
+        populateFreeAddressLeases(leases6_, pools);
         break;
     case Lease::TYPE_PD:
-        leases6 = LeaseMgrFactory::instance().getLeases6(subnet->getID());
-        populateFreePrefixDelegationLeases(leases6, pools);
+        populateFreePrefixDelegationLeases(leases6_, pools);
         break;
     default:
         ;
     }
+    // The leases are no longer needed.
+    Lease4Collection().swap(leases4_);
+    Lease6Collection().swap(leases6_);
+}
+
+void
+FreeLeaseQueueAllocator::initAfterConfigureFinish() {
+    auto subnet = subnet_.lock();
+    if (subnet->getPools(pool_type_).empty()) {
+        // If there are no pools there is nothing to track.
+        return;
+    }
     // Install the callbacks for lease add, update and delete in the interface manager.
     // These callbacks will ensure that we have up-to-date free lease queue.
     auto& lease_mgr = LeaseMgrFactory::instance();
@@ -197,10 +276,14 @@ FreeLeaseQueueAllocator::populateFreeAddressLeases(const LeaseCollectionType& le
     // For each pool, check if the address is in the leases list.
     size_t free_lease_count = 0;
     for (auto const& pool : pools) {
+        auto pool_state = getPoolState(pool);
+        if (pool_state->isPopulated()) {
+            free_lease_count += pool_state->getFreeLeaseCount();
+            continue;
+        }
         // Create the pool permutation so the resulting lease queue is no
         // particular order.
         IPRangePermutation perm(AddressRange(pool->getFirstAddress(), pool->getLastAddress()));
-        auto pool_state = getPoolState(pool);
         auto done = false;
         while (!done) {
             auto address = perm.next(done);
@@ -212,6 +295,7 @@ FreeLeaseQueueAllocator::populateFreeAddressLeases(const LeaseCollectionType& le
                 pool_state->addFreeLease(address);
             }
         }
+        pool_state->setPopulated();
         free_lease_count += pool_state->getFreeLeaseCount();
     }
 
@@ -248,12 +332,16 @@ FreeLeaseQueueAllocator::populateFreePrefixDelegationLeases(const Lease6Collecti
         if (!pool6) {
             continue;
         }
+        auto pool_state = getPoolState(pool);
+        if (pool_state->isPopulated()) {
+            free_lease_count += pool_state->getFreeLeaseCount();
+            continue;
+        }
         // Create the pool permutation so the resulting lease queue is no
         // particular order.
         IPRangePermutation perm(PrefixRange(pool->getFirstAddress(),
                                             pool->getLastAddress(),
                                             pool6->getLength()));
-        auto pool_state = getPoolState(pool);
         auto done = false;
         while (!done) {
             auto prefix = perm.next(done);
@@ -265,6 +353,7 @@ FreeLeaseQueueAllocator::populateFreePrefixDelegationLeases(const Lease6Collecti
                 pool_state->addFreeLease(prefix);
             }
         }
+        pool_state->setPopulated();
         free_lease_count += pool_state->getFreeLeaseCount();
     }
 
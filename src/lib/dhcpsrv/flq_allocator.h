@@ -51,19 +51,43 @@ public:
         return ("flq");
     }
 
+    /// @brief Reuses the free lease queues of the allocator in the previous
+    /// configuration.
+    ///
+    /// A pool which free lease queue has not been populated yet takes the
+    /// populated free lease queue of the pool with the same range (and the
+    /// same delegated length for the prefix delegation pools) in the
+    /// previous subnet, so it does not have to be populated again.
+    /// The caller must ensure that the previous free lease queues are up to
+    /// date, i.e. that the lease database did not change.
+    ///
+    /// @param previous the allocator in the previous configuration.
+    virtual void reuseAllocationStates(const Allocator& previous);
+
 private:
 
+    /// @brief Fetches the leases of the subnet from the lease manager.
+    ///
+    /// The leases are only fetched when some pools of the subnet have no
+    /// populated free lease queue.
+    virtual void initAfterConfigurePrepare();
+
     /// @brief Performs allocator initialization after server's reconfiguration.
     ///
-    /// The allocator installs the callbacks in the lease manager to keep track of
-    /// the lease allocations and maintain the free leases queue.
+    /// The allocator populates the free lease queues of the pools which
+    /// have not been populated yet using the leases fetched by the
+    /// @c initAfterConfigurePrepare.
     virtual void initAfterConfigureInternal();
 
+    /// @brief Installs the callbacks in the lease manager to keep track of
+    /// the lease allocations and maintain the free leases queue.
+    virtual void initAfterConfigureFinish();
+
     /// @brief Populates the queue of free addresses (IPv4 and IPv6).
     ///
     /// It adds each address in the subnet pools that does not exist in the
     /// list of leases to the free leases queue. The addresses are added
-    /// in a random order.
+    /// in a random order. The pools with a populated queue are skipped.
     ///
     /// @param lease collection of leases in the database for a subnet.
     /// @param pools collection of pools in the subnet.
@@ -76,7 +100,7 @@ private:
     ///
     /// It adds each delegated prefix in the subnet pools that does not exist in the
     /// list of leases to the free leases queue. The delegated prefixes are added
-    /// in a random order.
+    /// in a random order. The pools with a populated queue are skipped.
     ///
     /// @param lease collection of delegated prefixes in the database for a subnet.
     /// @param pools collection of prefix delegation pools in the subnet.
@@ -194,6 +218,12 @@ private:
 
     /// @brief Random generator used by this class.
     std::mt19937 generator_;
+
+    /// @brief IPv4 leases fetched to populate the free lease queues.
+    Lease4Collection leases4_;
+
+    /// @brief IPv6 leases fetched to populate the free lease queues.
+    Lease6Collection leases6_;
 };
 
 } // end of namespace isc::dhcp
@@ -145,11 +145,11 @@ public:
                 }
 
                 // Check if this lease exists.
-                typename StorageType::iterator lease_it =
-                    storage.find(lease->addr_);
+                auto& index = storage.template get<HashedAddressIndexTag>();
+                auto lease_it = index.find(lease->addr_);
                 // The lease doesn't exist yet. Insert the lease if
                 // it has a positive valid lifetime.
-                if (lease_it == storage.end()) {
+                if (lease_it == index.end()) {
                     if (lease->valid_lft_ > 0) {
                         storage.insert(lease);
                     }
@@ -158,11 +158,11 @@ public:
                     // lifetime of 0 it is an indication to remove the
                     // existing entry. Otherwise, we update the lease.
                     if (lease->valid_lft_ == 0) {
-                        storage.erase(lease_it);
+                        index.erase(lease_it);
 
                     } else {
                         // Use replace to re-index leases on update.
-                        storage.replace(lease_it, lease);
+                        index.replace(lease_it, lease);
                     }
                 }
 
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lease_file_writer.h>
+#include <exceptions/exceptions.h>
+#include <util/csv_file.h>
+
+#include <chrono>
+
+using namespace isc::util;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+LeaseFileWriter::LeaseFileWriter(const WriteFunc& write, size_t queue_size,
+                                 uint32_t max_delay)
+    : write_(write), queue_size_(queue_size), max_delay_(max_delay),
+      queue_(), in_progress_(0), groups_(0), stopping_(false) {
+    if (queue_size == 0) {
+        isc_throw(BadValue, "lease file writer queue size must not be 0");
+    }
+    thread_ = thread(&LeaseFileWriter::run, this);
+}
+
+LeaseFileWriter::~LeaseFileWriter() {
+    stop();
+}
+
+LeaseFileWriter::TicketPtr
+LeaseFileWriter::post(const string& row) {
+    Entry entry;
+    entry.row_ = row;
+    entry.ticket_.reset(new Ticket());
+    unique_lock<mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() {
+        return ((queue_.size() < queue_size_) || stopping_);
+    });
+    if (stopping_) {
+        isc_throw(CSVFileError, "lease file writer is stopped");
+    }
+    queue_.push_back(entry);
+    queue_cv_.notify_one();
+    return (entry.ticket_);
+}
+
+void
+LeaseFileWriter::wait(const Tickets& tickets) {
+    if (tickets.empty()) {
+        return;
+    }
+    unique_lock<mutex> lock(mutex_);
+    // The rows are written in order so the last ticket is done last.
+    done_cv_.wait(lock, [&tickets]() {
+        return (tickets.back()->done_);
+    });
+    for (auto const& ticket : tickets) {
+        if (!ticket->error_.empty()) {
+            isc_throw(CSVFileError, ticket->error_);
+        }
+    }
+}
+
+void
+LeaseFileWriter::drain() {
+    unique_lock<mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() {
+        return (queue_.empty() && (in_progress_ == 0));
+    });
+}
+
+void
+LeaseFileWriter::stop() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    done_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+uint64_t
+LeaseFileWriter::getGroupCount() const {
+    lock_guard<mutex> lock(mutex_);
+    return (groups_);
+}
+
+void
+LeaseFileWriter::run() {
+    unique_lock<mutex> lock(mutex_);
+    for (;;) {
+        queue_cv_.wait(lock, [this]() {
+            return (!queue_.empty() || stopping_);
+        });
+        if (queue_.empty()) {
+            // Stopping with nothing left to write.
+            return;
+        }
+        if (max_delay_ && !stopping_ && (queue_.size() < queue_size_)) {
+            // Give the other callers a chance to join the group.
+            queue_cv_.wait_for(lock, chrono::microseconds(max_delay_),
+                               [this]() {
+                return ((queue_.size() >= queue_size_) || stopping_);
+            });
+        }
+        deque<Entry> group;
+        group.swap(queue_);
+        in_progress_ = group.size();
+        // The queue has room again.
+        done_cv_.notify_all();
+        lock.unlock();
+
+        string rows;
+        for (auto const& entry : group) {
+            rows += entry.row_;
+        }
+        string error;
+        try {
+            write_(rows);
+        } catch (const exception& ex) {
+            error = ex.what();
+            if (error.empty()) {
+                error = "unknown error";
+            }
+        }
+
+        lock.lock();
+        for (auto const& entry : group) {
+            entry.ticket_->done_ = true;
+            entry.ticket_->error_ = error;
+        }
+        in_progress_ = 0;
+        ++groups_;
+        done_cv_.notify_all();
+    }
+}
+
+}  // namespace dhcp
+}  // namespace isc
@@ -0,0 +1,166 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_FILE_WRITER_H
+#define LEASE_FILE_WRITER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Group-commit writer of a lease file.
+///
+/// The rows appended to the lease file are rendered by the caller and
+/// posted to the writer, which writes them from a dedicated thread. All
+/// the rows queued when the thread wakes up are written, flushed and
+/// optionally synchronized to the disk by a single call of the write
+/// function, so the cost of the system calls is shared by the group.
+///
+/// The callers keep the durability of the synchronous writes by waiting
+/// for the tickets of their rows before they release the response, but
+/// they no longer serialize on the file: while a group is written the
+/// next one is queued.
+///
+/// The queue is bounded: @ref post blocks while it is full.
+class LeaseFileWriter : public boost::noncopyable {
+public:
+
+    /// @brief Function writing a group of rendered rows.
+    ///
+    /// It throws on write errors.
+    typedef std::function<void(const std::string&)> WriteFunc;
+
+    /// @brief Completion status of a posted row.
+    struct Ticket {
+        /// @brief Constructor.
+        Ticket() : done_(false), error_() {
+        }
+
+        /// @brief Indicates that the row has been written (or failed).
+        bool done_;
+
+        /// @brief Write error message, empty on success.
+        std::string error_;
+    };
+
+    /// @brief Pointer to a ticket.
+    typedef boost::shared_ptr<Ticket> TicketPtr;
+
+    /// @brief Collection of tickets.
+    typedef std::vector<TicketPtr> Tickets;
+
+    /// @brief Constructor.
+    ///
+    /// Starts the writer thread.
+    ///
+    /// @param write the function writing a group of rows.
+    /// @param queue_size maximum number of queued rows. It is also the
+    /// size of the group the thread waits for when @c max_delay is not 0.
+    /// @param max_delay maximum time in microseconds the thread waits for
+    /// more rows before it writes a group. With 0 the thread writes the
+    /// queued rows as soon as it is ready.
+    ///
+    /// @throw BadValue if the queue size is 0.
+    LeaseFileWriter(const WriteFunc& write, size_t queue_size,
+                    uint32_t max_delay);
+
+    /// @brief Destructor.
+    ///
+    /// Writes the queued rows and stops the thread.
+    ~LeaseFileWriter();
+
+    /// @brief Posts a rendered row.
+    ///
+    /// @param row the row text including its end of line.
+    /// @return the ticket of the row.
+    TicketPtr post(const std::string& row);
+
+    /// @brief Waits until rows have been written.
+    ///
+    /// @param tickets the tickets of the rows.
+    ///
+    /// @throw CSVFileError if the write of one of the rows failed.
+    void wait(const Tickets& tickets);
+
+    /// @brief Waits until all the posted rows have been written.
+    ///
+    /// Write errors are not reported: they are returned to the callers
+    /// waiting for the rows.
+    void drain();
+
+    /// @brief Writes the queued rows and stops the thread.
+    void stop();
+
+    /// @brief Returns the number of written groups.
+    uint64_t getGroupCount() const;
+
+private:
+
+    /// @brief The writer thread body.
+    void run();
+
+    /// @brief A posted row.
+    struct Entry {
+        /// @brief The row text.
+        std::string row_;
+
+        /// @brief The ticket of the row.
+        TicketPtr ticket_;
+    };
+
+    /// @brief The function writing a group of rows.
+    WriteFunc write_;
+
+    /// @brief Maximum number of queued rows.
+    size_t queue_size_;
+
+    /// @brief Maximum time in microseconds to wait for a group.
+    uint32_t max_delay_;
+
+    /// @brief Protects the queue and the tickets.
+    mutable std::mutex mutex_;
+
+    /// @brief Signals new rows or stop to the writer thread.
+    std::condition_variable queue_cv_;
+
+    /// @brief Signals free room in the queue and completed groups.
+    std::condition_variable done_cv_;
+
+    /// @brief The queued rows.
+    std::deque<Entry> queue_;
+
+    /// @brief Number of rows taken by the thread and not written yet.
+    size_t in_progress_;
+
+    /// @brief Number of written groups.
+    uint64_t groups_;
+
+    /// @brief Stop flag.
+    bool stopping_;
+
+    /// @brief The writer thread.
+    std::thread thread_;
+};
+
+/// @brief Pointer to a lease file writer.
+typedef boost::shared_ptr<LeaseFileWriter> LeaseFileWriterPtr;
+
+}  // namespace dhcp
+}  // namespace isc
+
+#endif // LEASE_FILE_WRITER_H
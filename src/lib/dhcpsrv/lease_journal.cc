@@ -0,0 +1,632 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_journal.h>
+
+#include <sys/stat.h>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Flags of a lease record.
+//@{
+const uint8_t FLAG_FQDN_FWD = 0x01;
+const uint8_t FLAG_FQDN_REV = 0x02;
+const uint8_t FLAG_HWADDR = 0x04;
+const uint8_t FLAG_CLIENT_ID = 0x08;
+const uint8_t FLAG_CONTEXT = 0x10;
+//@}
+
+/// @brief Writes a time value.
+///
+/// @param buffer the record.
+/// @param value the time value.
+void
+encodeTime(OutputBuffer& buffer, time_t value) {
+    uint64_t time64 = static_cast<uint64_t>(value);
+    buffer.writeUint32(static_cast<uint32_t>(time64 >> 32));
+    buffer.writeUint32(static_cast<uint32_t>(time64 & 0xffffffff));
+}
+
+/// @brief Reads a time value.
+///
+/// @param buffer the record.
+/// @return the time value.
+time_t
+decodeTime(InputBuffer& buffer) {
+    uint64_t time64 = static_cast<uint64_t>(buffer.readUint32()) << 32;
+    time64 |= buffer.readUint32();
+    return (static_cast<time_t>(time64));
+}
+
+/// @brief Writes a string with its length on 16 bits.
+///
+/// @param buffer the record.
+/// @param value the string.
+void
+encodeString(OutputBuffer& buffer, const string& value) {
+    if (value.size() > 0xffff) {
+        isc_throw(isc::BadValue, "too long string of " << value.size()
+                  << " bytes for a lease journal record");
+    }
+    buffer.writeUint16(static_cast<uint16_t>(value.size()));
+    buffer.writeData(value.c_str(), value.size());
+}
+
+/// @brief Reads a string of a given length.
+///
+/// @param buffer the record.
+/// @param length the length of the string.
+/// @return the string.
+string
+decodeString(InputBuffer& buffer, size_t length) {
+    string value(length, '\0');
+    if (length > 0) {
+        buffer.readData(&value[0], length);
+    }
+    return (value);
+}
+
+/// @brief Writes a hardware address.
+///
+/// @param buffer the record.
+/// @param hwaddr the hardware address.
+void
+encodeHWAddr(OutputBuffer& buffer, const isc::dhcp::HWAddr& hwaddr) {
+    if (hwaddr.hwaddr_.size() > 0xff) {
+        isc_throw(isc::BadValue, "too long hardware address of "
+                  << hwaddr.hwaddr_.size() << " bytes");
+    }
+    buffer.writeUint16(hwaddr.htype_);
+    buffer.writeUint32(hwaddr.source_);
+    buffer.writeUint8(static_cast<uint8_t>(hwaddr.hwaddr_.size()));
+    if (!hwaddr.hwaddr_.empty()) {
+        buffer.writeData(&hwaddr.hwaddr_[0], hwaddr.hwaddr_.size());
+    }
+}
+
+/// @brief Reads a hardware address.
+///
+/// @param buffer the record.
+/// @return the hardware address.
+isc::dhcp::HWAddrPtr
+decodeHWAddr(InputBuffer& buffer) {
+    uint16_t htype = buffer.readUint16();
+    uint32_t source = buffer.readUint32();
+    vector<uint8_t> data;
+    buffer.readVector(data, buffer.readUint8());
+    isc::dhcp::HWAddrPtr hwaddr(new isc::dhcp::HWAddr(data, htype));
+    hwaddr->source_ = source;
+    return (hwaddr);
+}
+
+/// @brief Writes a user context.
+///
+/// @param buffer the record.
+/// @param context the user context.
+void
+encodeContext(OutputBuffer& buffer, const ConstElementPtr& context) {
+    string text = context->str();
+    buffer.writeUint32(static_cast<uint32_t>(text.size()));
+    buffer.writeData(text.c_str(), text.size());
+}
+
+/// @brief Reads a user context.
+///
+/// @param buffer the record.
+/// @return the user context.
+ConstElementPtr
+decodeContext(InputBuffer& buffer) {
+    string text = decodeString(buffer, buffer.readUint32());
+    ConstElementPtr ctx = Element::fromJSON(text);
+    if (!ctx || (ctx->getType() != Element::map)) {
+        isc_throw(isc::BadValue, "user context '" << text
+                  << "' is not a JSON map");
+    }
+    return (ctx);
+}
+
+}  // namespace
+
+namespace isc {
+namespace dhcp {
+
+LeaseFileFormat
+leaseFileFormatFromText(const string& text) {
+    if (text == "csv") {
+        return (LEASE_FILE_CSV);
+    } else if (text == "binary") {
+        return (LEASE_FILE_BINARY);
+    }
+    isc_throw(BadValue, "unknown lease file format '" << text
+              << "', expected csv or binary");
+}
+
+string
+leaseFileFormatToText(const LeaseFileFormat& format) {
+    return (format == LEASE_FILE_BINARY ? "binary" : "csv");
+}
+
+LeaseFileFormat
+getLeaseFileFormat(const string& filename,
+                   const LeaseFileFormat& default_format) {
+    ifstream fs(filename.c_str(), ifstream::binary);
+    if (!fs.good()) {
+        return (default_format);
+    }
+    // Both journals have the same magic string.
+    const char* magic = LeaseJournal4::MAGIC();
+    vector<char> header(strlen(magic));
+    fs.read(&header[0], header.size());
+    streamsize got = fs.gcount();
+    if (got == 0) {
+        return (default_format);
+    }
+    if ((got == static_cast<streamsize>(header.size())) &&
+        (memcmp(&header[0], magic, header.size()) == 0)) {
+        return (LEASE_FILE_BINARY);
+    }
+    return (LEASE_FILE_CSV);
+}
+
+bool
+saveCorruptedLeaseJournal(const string& filename, uint64_t offset,
+                          const string& reason) {
+    // Do not overwrite the copy of a previous corruption.
+    string copy = filename + ".corrupted";
+    struct stat st;
+    for (unsigned i = 1; stat(copy.c_str(), &st) == 0; ++i) {
+        ostringstream s;
+        s << filename << ".corrupted." << i;
+        copy = s.str();
+    }
+    {
+        ifstream input(filename.c_str(), ifstream::binary);
+        ofstream output(copy.c_str(), ofstream::binary | ofstream::trunc);
+        if (input.good() && output.good()) {
+            output << input.rdbuf();
+            output.flush();
+        }
+        if (!input.good() || !output.good()) {
+            output.close();
+            static_cast<void>(remove(copy.c_str()));
+            LOG_ERROR(dhcpsrv_logger, DHCPSRV_LEASE_JOURNAL_CORRUPTED_NOT_SAVED)
+                .arg(filename)
+                .arg(offset)
+                .arg(reason)
+                .arg(copy);
+            return (false);
+        }
+    }
+    LOG_ERROR(dhcpsrv_logger, DHCPSRV_LEASE_JOURNAL_CORRUPTED)
+        .arg(filename)
+        .arg(offset)
+        .arg(reason)
+        .arg(copy);
+    return (true);
+}
+
+LeaseJournal4::LeaseJournal4(const string& filename)
+    : LeaseJournal<CSVLeaseFile4, 4>(filename) {
+}
+
+void
+LeaseJournal4::encode(const Lease4& lease, OutputBuffer& buffer) {
+    bool has_hwaddr = lease.hwaddr_ && !lease.hwaddr_->hwaddr_.empty();
+    bool has_client_id = lease.client_id_ &&
+        !lease.client_id_->getClientId().empty();
+    if (!has_hwaddr && !has_client_id &&
+        (lease.state_ != Lease::STATE_DECLINED)) {
+        isc_throw(BadValue, "Lease4: " << lease.addr_.toText() << ", state: "
+                  << Lease::basicStatesToText(lease.state_)
+                  << " has neither hardware address or client id");
+    }
+
+    uint8_t flags = 0;
+    if (lease.fqdn_fwd_) {
+        flags |= FLAG_FQDN_FWD;
+    }
+    if (lease.fqdn_rev_) {
+        flags |= FLAG_FQDN_REV;
+    }
+    if (lease.hwaddr_) {
+        flags |= FLAG_HWADDR;
+    }
+    if (lease.client_id_) {
+        flags |= FLAG_CLIENT_ID;
+    }
+    if (lease.getContext()) {
+        flags |= FLAG_CONTEXT;
+    }
+
+    buffer.writeUint32(lease.addr_.toUint32());
+    buffer.writeUint8(flags);
+    buffer.writeUint32(lease.valid_lft_);
+    encodeTime(buffer, lease.cltt_);
+    buffer.writeUint32(lease.subnet_id_);
+    buffer.writeUint32(lease.pool_id_);
+    buffer.writeUint32(lease.state_);
+    if (lease.hwaddr_) {
+        encodeHWAddr(buffer, *lease.hwaddr_);
+    }
+    if (lease.client_id_) {
+        const vector<uint8_t>& client_id = lease.client_id_->getClientId();
+        buffer.writeUint8(static_cast<uint8_t>(client_id.size()));
+        if (!client_id.empty()) {
+            buffer.writeData(&client_id[0], client_id.size());
+        }
+    }
+    encodeString(buffer, lease.hostname_);
+    if (lease.getContext()) {
+        encodeContext(buffer, lease.getContext());
+    }
+}
+
+Lease4Ptr
+LeaseJournal4::decode(InputBuffer& buffer) {
+    IOAddress addr(buffer.readUint32());
+    uint8_t flags = buffer.readUint8();
+    uint32_t valid_lft = buffer.readUint32();
+    time_t cltt = decodeTime(buffer);
+    SubnetID subnet_id = buffer.readUint32();
+    uint32_t pool_id = buffer.readUint32();
+    uint32_t state = buffer.readUint32();
+    HWAddrPtr hwaddr;
+    if (flags & FLAG_HWADDR) {
+        hwaddr = decodeHWAddr(buffer);
+    }
+    ClientIdPtr client_id;
+    if (flags & FLAG_CLIENT_ID) {
+        vector<uint8_t> data;
+        buffer.readVector(data, buffer.readUint8());
+        client_id.reset(new ClientId(data));
+    }
+    string hostname = decodeString(buffer, buffer.readUint16());
+    ConstElementPtr ctx;
+    if (flags & FLAG_CONTEXT) {
+        ctx = decodeContext(buffer);
+    }
+
+    if ((!hwaddr || hwaddr->hwaddr_.empty()) && !client_id &&
+        (state != Lease::STATE_DECLINED)) {
+        isc_throw(BadValue, "Lease4: " << addr.toText() << ", state: "
+                  << Lease::basicStatesToText(state)
+                  << " has neither hardware address or client id");
+    }
+
+    Lease4Ptr lease(new Lease4(addr, hwaddr, client_id, valid_lft, cltt,
+                               subnet_id, flags & FLAG_FQDN_FWD,
+                               flags & FLAG_FQDN_REV, hostname));
+    lease->state_ = state;
+    lease->pool_id_ = pool_id;
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+    lease->updateCurrentExpirationTime();
+    return (lease);
+}
+
+void
+LeaseJournal4::append(const Lease4& lease) {
+    // Bump the number of write attempts
+    ++writes_;
+
+    try {
+        OutputBuffer buffer(128);
+        encode(lease, buffer);
+        writeRecord(buffer);
+
+    } catch (const std::exception&) {
+        // Catch any errors so we can bump the error counter than rethrow it
+        ++write_errs_;
+        throw;
+    }
+
+    // Bump the number of leases written
+    ++write_leases_;
+}
+
+bool
+LeaseJournal4::next(Lease4Ptr& lease) {
+    // Bump the number of read attempts
+    ++reads_;
+
+    try {
+        vector<uint8_t> record;
+        if (!readRecord(record)) {
+            // End of the journal.
+            lease.reset();
+            return (true);
+        }
+        InputBuffer buffer(record.empty() ? 0 : &record[0], record.size());
+        lease = decode(buffer);
+
+    } catch (const std::exception& ex) {
+        // bump the read error count
+        ++read_errs_;
+
+        // The lease might have been created, so let's set it back to NULL to
+        // signal that lease hasn't been parsed.
+        lease.reset();
+        setReadMsg(ex.what());
+        return (false);
+    }
+
+    // bump the number of leases read
+    ++read_leases_;
+
+    return (true);
+}
+
+LeaseJournal6::LeaseJournal6(const string& filename)
+    : LeaseJournal<CSVLeaseFile6, 6>(filename) {
+}
+
+void
+LeaseJournal6::encode(const Lease6& lease, OutputBuffer& buffer) {
+    if (((!(lease.duid_)) || (*(lease.duid_) == DUID::EMPTY())) &&
+        (lease.state_ != Lease::STATE_DECLINED)) {
+        isc_throw(BadValue, "Lease6: " << lease.addr_.toText() << ", state: "
+                  << Lease::basicStatesToText(lease.state_) << ", has no DUID");
+    }
+
+    uint8_t flags = 0;
+    if (lease.fqdn_fwd_) {
+        flags |= FLAG_FQDN_FWD;
+    }
+    if (lease.fqdn_rev_) {
+        flags |= FLAG_FQDN_REV;
+    }
+    if (lease.hwaddr_) {
+        flags |= FLAG_HWADDR;
+    }
+    if (lease.getContext()) {
+        flags |= FLAG_CONTEXT;
+    }
+
+    const vector<uint8_t>& addr = lease.addr_.toBytes();
+    buffer.writeData(&addr[0], addr.size());
+    buffer.writeUint8(static_cast<uint8_t>(lease.type_));
+    buffer.writeUint8(lease.prefixlen_);
+    buffer.writeUint8(flags);
+    buffer.writeUint32(lease.iaid_);
+    buffer.writeUint32(lease.valid_lft_);
+    buffer.writeUint32(lease.preferred_lft_);
+    encodeTime(buffer, lease.cltt_);
+    buffer.writeUint32(lease.subnet_id_);
+    buffer.writeUint32(lease.pool_id_);
+    buffer.writeUint32(lease.state_);
+    const vector<uint8_t>& duid = (lease.duid_ ? lease.duid_->getDuid() :
+                                   DUID::EMPTY().getDuid());
+    buffer.writeUint16(static_cast<uint16_t>(duid.size()));
+    buffer.writeData(&duid[0], duid.size());
+    if (lease.hwaddr_) {
+        encodeHWAddr(buffer, *lease.hwaddr_);
+    }
+    encodeString(buffer, lease.hostname_);
+    if (lease.getContext()) {
+        encodeContext(buffer, lease.getContext());
+    }
+}
+
+Lease6Ptr
+LeaseJournal6::decode(InputBuffer& buffer) {
+    uint8_t addr_data[V6ADDRESS_LEN];
+    buffer.readData(addr_data, sizeof(addr_data));
+    IOAddress addr = IOAddress::fromBytes(AF_INET6, addr_data);
+    uint8_t type = buffer.readUint8();
+    if ((type != Lease::TYPE_NA) && (type != Lease::TYPE_TA) &&
+        (type != Lease::TYPE_PD)) {
+        isc_throw(BadValue, "invalid lease type " << static_cast<int>(type)
+                  << " for the lease " << addr.toText());
+    }
+    uint8_t prefixlen = buffer.readUint8();
+    uint8_t flags = buffer.readUint8();
+    uint32_t iaid = buffer.readUint32();
+    uint32_t valid_lft = buffer.readUint32();
+    uint32_t preferred_lft = buffer.readUint32();
+    time_t cltt = decodeTime(buffer);
+    SubnetID subnet_id = buffer.readUint32();
+    uint32_t pool_id = buffer.readUint32();
+    uint32_t state = buffer.readUint32();
+    vector<uint8_t> duid_data;
+    buffer.readVector(duid_data, buffer.readUint16());
+    DuidPtr duid(new DUID(duid_data));
+    HWAddrPtr hwaddr;
+    if (flags & FLAG_HWADDR) {
+        hwaddr = decodeHWAddr(buffer);
+    }
+    string hostname = decodeString(buffer, buffer.readUint16());
+    ConstElementPtr ctx;
+    if (flags & FLAG_CONTEXT) {
+        ctx = decodeContext(buffer);
+    }
+
+    if ((*duid == DUID::EMPTY()) && (state != Lease::STATE_DECLINED)) {
+        isc_throw(isc::BadValue,
+                  "The Empty DUID is only valid for declined leases");
+    }
+
+    Lease6Ptr lease(new Lease6(static_cast<Lease::Type>(type), addr, duid,
+                               iaid, preferred_lft, valid_lft, subnet_id,
+                               hwaddr, prefixlen));
+    lease->cltt_ = cltt;
+    lease->fqdn_fwd_ = flags & FLAG_FQDN_FWD;
+    lease->fqdn_rev_ = flags & FLAG_FQDN_REV;
+    lease->hostname_ = hostname;
+    lease->state_ = state;
+    lease->pool_id_ = pool_id;
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+    lease->updateCurrentExpirationTime();
+    return (lease);
+}
+
+void
+LeaseJournal6::append(const Lease6& lease) {
+    // Bump the number of write attempts
+    ++writes_;
+
+    try {
+        OutputBuffer buffer(160);
+        encode(lease, buffer);
+        writeRecord(buffer);
+
+    } catch (const std::exception&) {
+        // Catch any errors so we can bump the error counter than rethrow it
+        ++write_errs_;
+        throw;
+    }
+
+    // Bump the number of leases written
+    ++write_leases_;
+}
+
+bool
+LeaseJournal6::next(Lease6Ptr& lease) {
+    // Bump the number of read attempts
+    ++reads_;
+
+    try {
+        vector<uint8_t> record;
+        if (!readRecord(record)) {
+            // End of the journal.
+            lease.reset();
+            return (true);
+        }
+        InputBuffer buffer(record.empty() ? 0 : &record[0], record.size());
+        lease = decode(buffer);
+
+    } catch (const std::exception& ex) {
+        // bump the read error count
+        ++read_errs_;
+
+        // The lease might have been created, so let's set it back to NULL to
+        // signal that lease hasn't been parsed.
+        lease.reset();
+        setReadMsg(ex.what());
+        return (false);
+    }
+
+    // bump the number of leases read
+    ++read_leases_;
+
+    return (true);
+}
+
+namespace {
+
+/// @brief Appends a length prefixed record to a lease stream.
+///
+/// @tparam JournalType @c LeaseJournal4 or @c LeaseJournal6.
+/// @tparam LeaseType @c Lease4 or @c Lease6.
+/// @param buffer the stream.
+/// @param lease the lease.
+template<typename JournalType, typename LeaseType>
+void
+writeStreamRecord(OutputBuffer& buffer, const LeaseType& lease) {
+    // Reserve the room for the length and fill it once the record
+    // has been encoded.
+    size_t position = buffer.getLength();
+    buffer.skip(4);
+    size_t length = 0;
+    try {
+        JournalType::encode(lease, buffer);
+        length = buffer.getLength() - position - 4;
+        if (length > JournalType::MAX_RECORD_SIZE) {
+            isc_throw(BadValue, "too large record of " << length
+                      << " bytes for the lease " << lease.addr_.toText());
+        }
+    } catch (const std::exception&) {
+        // Remove the partial record so the stream remains valid.
+        buffer.trim(buffer.getLength() - position);
+        throw;
+    }
+    buffer.writeUint16At(static_cast<uint16_t>(length >> 16), position);
+    buffer.writeUint16At(static_cast<uint16_t>(length & 0xffff), position + 2);
+}
+
+/// @brief Reads a length prefixed record from a lease stream.
+///
+/// @tparam JournalType @c LeaseJournal4 or @c LeaseJournal6.
+/// @tparam LeasePtrType @c Lease4Ptr or @c Lease6Ptr.
+/// @param buffer the stream.
+/// @param [out] lease the lease or null at the end of the stream.
+/// @return false at the end of the stream, true otherwise.
+template<typename JournalType, typename LeasePtrType>
+bool
+readStreamRecord(InputBuffer& buffer, LeasePtrType& lease) {
+    lease.reset();
+    if (buffer.getPosition() >= buffer.getLength()) {
+        return (false);
+    }
+    uint32_t length = buffer.readUint32();
+    if (length > JournalType::MAX_RECORD_SIZE) {
+        isc_throw(BadValue, "too large record of " << length
+                  << " bytes in the lease stream");
+    }
+    if (length > buffer.getLength() - buffer.getPosition()) {
+        isc_throw(BadValue, "truncated record in the lease stream");
+    }
+    vector<uint8_t> record;
+    buffer.readVector(record, length);
+    InputBuffer record_buffer(record.empty() ? 0 : &record[0], record.size());
+    lease = JournalType::decode(record_buffer);
+    return (true);
+}
+
+}  // namespace
+
+void
+writeLeaseStreamHeader(OutputBuffer& buffer) {
+    buffer.writeUint8(LeaseJournal4::FORMAT_VERSION);
+}
+
+void
+readLeaseStreamHeader(InputBuffer& buffer) {
+    if (buffer.getPosition() >= buffer.getLength()) {
+        isc_throw(BadValue, "missing version of the lease stream");
+    }
+    uint8_t version = buffer.readUint8();
+    if (version != LeaseJournal4::FORMAT_VERSION) {
+        isc_throw(BadValue, "unsupported version "
+                  << static_cast<unsigned>(version)
+                  << " of the lease stream");
+    }
+}
+
+void
+writeLeaseStreamRecord(OutputBuffer& buffer, const Lease4& lease) {
+    writeStreamRecord<LeaseJournal4>(buffer, lease);
+}
+
+void
+writeLeaseStreamRecord(OutputBuffer& buffer, const Lease6& lease) {
+    writeStreamRecord<LeaseJournal6>(buffer, lease);
+}
+
+bool
+readLeaseStreamRecord(InputBuffer& buffer, Lease4Ptr& lease) {
+    return (readStreamRecord<LeaseJournal4>(buffer, lease));
+}
+
+bool
+readLeaseStreamRecord(InputBuffer& buffer, Lease6Ptr& lease) {
+    return (readStreamRecord<LeaseJournal6>(buffer, lease));
+}
+
+}  // namespace dhcp
+}  // namespace isc
@@ -0,0 +1,563 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_JOURNAL_H
+#define LEASE_JOURNAL_H
+
+#include <dhcpsrv/csv_lease_file4.h>
+#include <dhcpsrv/csv_lease_file6.h>
+#include <exceptions/exceptions.h>
+#include <util/buffer.h>
+#include <util/csv_file.h>
+#include <util/io.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Formats of the memfile lease files.
+enum LeaseFileFormat {
+    LEASE_FILE_CSV,     ///< CSV file (@c CSVLeaseFile4 or @c CSVLeaseFile6).
+    LEASE_FILE_BINARY   ///< Binary journal (@c LeaseJournal4 or @c LeaseJournal6).
+};
+
+/// @brief Converts the name of a lease file format to the format.
+///
+/// @param text "csv" or "binary".
+/// @return the lease file format.
+/// @throw BadValue if the name is not valid.
+LeaseFileFormat leaseFileFormatFromText(const std::string& text);
+
+/// @brief Returns the name of a lease file format.
+///
+/// @param format the lease file format.
+/// @return "csv" or "binary".
+std::string leaseFileFormatToText(const LeaseFileFormat& format);
+
+/// @brief Returns the format of a lease file.
+///
+/// The binary journals are recognized by their header. Other non empty
+/// files are CSV files.
+///
+/// @param filename the name of the lease file.
+/// @param default_format the format returned when the file does not exist
+/// or is empty.
+/// @return the format of the file.
+LeaseFileFormat getLeaseFileFormat(const std::string& filename,
+                                   const LeaseFileFormat& default_format);
+
+/// @brief Saves a copy of a corrupted lease journal.
+///
+/// The copy is named after the journal with a ".corrupted" suffix,
+/// followed by a number when a previous copy exists. The outcome is
+/// logged.
+///
+/// @param filename the name of the journal.
+/// @param offset the offset of the corrupted record.
+/// @param reason the description of the corruption.
+/// @return true if the copy was saved, false otherwise.
+bool saveCorruptedLeaseJournal(const std::string& filename, uint64_t offset,
+                               const std::string& reason);
+
+/// @brief Binary journal of leases.
+///
+/// This is the common part of @c LeaseJournal4 and @c LeaseJournal6. The
+/// journal is derived from the CSV lease file so it can be used in place
+/// of it by the memfile backend and the LFC, but its content is binary:
+/// - a header made of the @c MAGIC string, the universe (4 or 6) and the
+///   @c FORMAT_VERSION of the format,
+/// - one record per appended lease: the length of the record on 32 bits
+///   followed by the lease fields in network byte order. The addresses,
+///   identifiers and other fields are stored in their binary form, so
+///   they are neither formatted nor parsed as text.
+///
+/// A reader ignores the fields it does not know at the end of a record,
+/// so fields can be added in a new version of the format. A truncated
+/// record, e.g. after a crash, is reported as a read error and ends the
+/// journal. It is removed from the file so the records appended later
+/// are framed from the end of the last complete record. A record with
+/// an invalid length is not the result of a crash, and the records
+/// after it can't be framed: it is reported as a read error and ends
+/// the journal too, but the journal is truncated only once a copy of it
+/// has been saved. When the copy can't be saved the journal is left
+/// unchanged.
+///
+/// @tparam BaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+/// @tparam UNIVERSE 4 or 6.
+template<typename BaseFileType, uint8_t UNIVERSE>
+class LeaseJournal : public BaseFileType {
+public:
+
+    /// @brief Version of the format.
+    static const uint8_t FORMAT_VERSION = 1;
+
+    /// @brief Largest accepted record.
+    static const uint32_t MAX_RECORD_SIZE = 1024 * 1024;
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the lease file.
+    LeaseJournal(const std::string& filename) : BaseFileType(filename) {
+    }
+
+    /// @brief Returns the magic string beginning the header.
+    static const char* MAGIC() {
+        return ("KEA-LJ");
+    }
+
+    /// @brief Returns the size of the header.
+    static size_t getHeaderSize() {
+        return (std::strlen(MAGIC()) + 2);
+    }
+
+    /// @brief Opens the journal.
+    ///
+    /// An empty or missing journal is created. Otherwise the header is
+    /// checked.
+    ///
+    /// @param seek_to_end move the pointer to the end of the journal.
+    /// @throw CSVFileError if the journal can't be opened or its header is
+    /// invalid.
+    virtual void open(const bool seek_to_end = false) {
+        if (this->size() == static_cast<std::streampos>(0)) {
+            recreate();
+
+        } else {
+            this->fs_.reset(new std::fstream(this->getFilename().c_str(),
+                                             std::fstream::in |
+                                             std::fstream::out |
+                                             std::fstream::binary));
+            try {
+                if (!this->fs_->is_open()) {
+                    isc_throw(util::CSVFileError, "unable to open '"
+                              << this->getFilename() << "'");
+                }
+                std::vector<char> header(getHeaderSize());
+                this->fs_->read(&header[0], header.size());
+                if ((this->fs_->gcount() != static_cast<std::streamsize>(header.size())) ||
+                    (std::memcmp(&header[0], MAGIC(), std::strlen(MAGIC())) != 0) ||
+                    (static_cast<uint8_t>(header[header.size() - 2]) != UNIVERSE)) {
+                    isc_throw(util::CSVFileError, "invalid header of the"
+                              " lease journal '" << this->getFilename() << "'");
+                }
+                if (static_cast<uint8_t>(header.back()) != FORMAT_VERSION) {
+                    isc_throw(util::CSVFileError, "unsupported version "
+                              << static_cast<unsigned>(static_cast<uint8_t>(header.back()))
+                              << " of the lease journal '"
+                              << this->getFilename() << "'");
+                }
+                if (seek_to_end) {
+                    this->fs_->seekp(0, std::ios_base::end);
+                    this->fs_->seekg(0, std::ios_base::end);
+                    if (!this->fs_->good()) {
+                        isc_throw(util::CSVFileError, "unable to move to the"
+                                  " end of the lease journal '"
+                                  << this->getFilename() << "'");
+                    }
+                    this->fs_->clear();
+                }
+            } catch (const std::exception&) {
+                this->close();
+                throw;
+            }
+        }
+
+        this->clearStatistics();
+    }
+
+    /// @brief Creates a new journal holding only the header.
+    ///
+    /// @throw CSVFileError if the journal can't be created.
+    virtual void recreate() {
+        this->close();
+        this->fs_.reset(new std::fstream(this->getFilename().c_str(),
+                                         std::fstream::out |
+                                         std::fstream::binary));
+        if (!this->fs_->is_open()) {
+            this->close();
+            isc_throw(util::CSVFileError, "unable to open '"
+                      << this->getFilename() << "'");
+        }
+        std::string header(MAGIC());
+        header.push_back(static_cast<char>(UNIVERSE));
+        header.push_back(static_cast<char>(FORMAT_VERSION));
+        this->fs_->write(header.c_str(), header.size());
+        this->fs_->flush();
+        if (!this->fs_->good()) {
+            this->close();
+            isc_throw(util::CSVFileError, "unable to write the header of"
+                      " the lease journal '" << this->getFilename() << "'");
+        }
+    }
+
+protected:
+
+    /// @brief Reads the next record.
+    ///
+    /// @param [out] record the content of the record.
+    /// @return false at the end of the journal, true otherwise.
+    /// @throw CSVFileError if the record is truncated or too large. The
+    /// rest of the journal is discarded, after a copy of the journal was
+    /// saved when the record is too large.
+    bool readRecord(std::vector<uint8_t>& record) {
+        this->checkStreamStatusAndReset("get next record");
+        std::streampos start = this->fs_->tellg();
+        uint8_t length_data[4];
+        this->fs_->read(reinterpret_cast<char*>(length_data),
+                        sizeof(length_data));
+        std::streamsize got = this->fs_->gcount();
+        if ((got == 0) && this->fs_->eof()) {
+            return (false);
+        }
+        if (got != sizeof(length_data)) {
+            discardTail(start);
+            isc_throw(util::CSVFileError, "truncated record in the lease"
+                      " journal '" << this->getFilename() << "'");
+        }
+        uint32_t length = util::readUint32(length_data, sizeof(length_data));
+        if (length > MAX_RECORD_SIZE) {
+            std::ostringstream reason;
+            reason << "too large record of " << length << " bytes";
+            discardCorrupted(start, reason.str());
+            isc_throw(util::CSVFileError, reason.str() << " in the lease"
+                      " journal '" << this->getFilename() << "'");
+        }
+        record.resize(length);
+        if (length > 0) {
+            this->fs_->read(reinterpret_cast<char*>(&record[0]), length);
+            if (this->fs_->gcount() != static_cast<std::streamsize>(length)) {
+                discardTail(start);
+                isc_throw(util::CSVFileError, "truncated record in the lease"
+                          " journal '" << this->getFilename() << "'");
+            }
+        }
+        return (true);
+    }
+
+    /// @brief Appends a record.
+    ///
+    /// @param buffer the content of the record.
+    /// @throw CSVFileError When error occurred during IO operation.
+    void writeRecord(const util::OutputBuffer& buffer) const {
+        uint8_t length_data[4];
+        util::writeUint32(static_cast<uint32_t>(buffer.getLength()),
+                          length_data, sizeof(length_data));
+        std::string record(reinterpret_cast<const char*>(length_data),
+                           sizeof(length_data));
+        record.append(static_cast<const char*>(buffer.getDataAsVoidPtr()),
+                      buffer.getLength());
+        this->appendRecord(record);
+    }
+
+private:
+
+    /// @brief Removes the end of the journal from a position.
+    ///
+    /// The journal is truncated at the position, i.e. the end of the
+    /// last complete record, so the next appended record does not
+    /// follow a partial one. If the truncation fails the read pointer
+    /// is only moved to the end of the journal.
+    ///
+    /// @param position the position of the first byte to remove.
+    void discardTail(const std::streampos& position) {
+        this->fs_->clear();
+        if ((position >= static_cast<std::streampos>(getHeaderSize())) &&
+            (::truncate(this->getFilename().c_str(),
+                        static_cast<off_t>(position)) == 0)) {
+            this->fs_->seekp(position);
+            this->fs_->seekg(position);
+        } else {
+            this->fs_->seekg(0, std::ios_base::end);
+        }
+        this->fs_->clear();
+    }
+
+    /// @brief Stops reading the journal at a corrupted record.
+    ///
+    /// The journal is truncated at the position when a copy of it could
+    /// be saved. Otherwise it is left unchanged and the read pointer is
+    /// only moved to the end of the journal.
+    ///
+    /// @param position the position of the corrupted record.
+    /// @param reason the description of the corruption.
+    void discardCorrupted(const std::streampos& position,
+                          const std::string& reason) {
+        this->fs_->flush();
+        if (saveCorruptedLeaseJournal(this->getFilename(),
+                                      static_cast<uint64_t>(position),
+                                      reason)) {
+            discardTail(position);
+        } else {
+            this->fs_->clear();
+            this->fs_->seekg(0, std::ios_base::end);
+            this->fs_->clear();
+        }
+    }
+};
+
+// Explicit definition of class static constants.  Values are given in the
+// declaration so they're not needed here.
+template<typename BaseFileType, uint8_t UNIVERSE>
+const uint8_t LeaseJournal<BaseFileType, UNIVERSE>::FORMAT_VERSION;
+template<typename BaseFileType, uint8_t UNIVERSE>
+const uint32_t LeaseJournal<BaseFileType, UNIVERSE>::MAX_RECORD_SIZE;
+
+/// @brief Binary journal of DHCPv4 leases.
+///
+/// The record of a lease holds:
+/// - the address (4 bytes),
+/// - the flags (1 byte): FQDN forward and reverse updates, presence of
+///   the hardware address, of the client identifier and of the user
+///   context,
+/// - the valid lifetime (4 bytes), the cltt (8 bytes), the subnet
+///   identifier (4 bytes), the pool identifier (4 bytes), the state
+///   (4 bytes),
+/// - the hardware address type (2 bytes), source (4 bytes), length
+///   (1 byte) and value when present,
+/// - the client identifier length (1 byte) and value when present,
+/// - the hostname length (2 bytes) and value,
+/// - the user context length (4 bytes) and JSON text when present.
+class LeaseJournal4 : public LeaseJournal<CSVLeaseFile4, 4> {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the lease file.
+    LeaseJournal4(const std::string& filename);
+
+    /// @brief Encodes a lease into a record.
+    ///
+    /// @param lease Structure representing a DHCPv4 lease.
+    /// @param [out] buffer the buffer the record is appended to.
+    /// @throw BadValue if the lease has no hardware address, no client id and
+    /// is not in STATE_DECLINED.
+    static void encode(const Lease4& lease, util::OutputBuffer& buffer);
+
+    /// @brief Decodes a lease from a record.
+    ///
+    /// @param buffer the buffer holding the record.
+    /// @return the decoded lease.
+    /// @throw BadValue or OutOfRange if the record is invalid.
+    static Lease4Ptr decode(util::InputBuffer& buffer);
+
+    /// @brief Appends the lease record to the journal.
+    ///
+    /// @param lease Structure representing a DHCPv4 lease.
+    /// @throw BadValue if the lease has no hardware address, no client id and
+    /// is not in STATE_DECLINED.
+    virtual void append(const Lease4& lease);
+
+    /// @brief Reads next lease from the journal.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] lease Pointer to the lease read from the journal or
+    /// NULL pointer at the end of the journal.
+    /// @return false if an error occurred, true otherwise.
+    virtual bool next(Lease4Ptr& lease);
+};
+
+/// @brief Binary journal of DHCPv6 leases.
+///
+/// The record of a lease holds:
+/// - the address (16 bytes),
+/// - the lease type (1 byte), the prefix length (1 byte),
+/// - the flags (1 byte): FQDN forward and reverse updates, presence of
+///   the hardware address and of the user context,
+/// - the IAID (4 bytes), the valid and preferred lifetimes (4 bytes
+///   each), the cltt (8 bytes), the subnet identifier (4 bytes), the pool
+///   identifier (4 bytes), the state (4 bytes),
+/// - the DUID length (2 bytes) and value,
+/// - the hardware address type (2 bytes), source (4 bytes), length
+///   (1 byte) and value when present,
+/// - the hostname length (2 bytes) and value,
+/// - the user context length (4 bytes) and JSON text when present.
+class LeaseJournal6 : public LeaseJournal<CSVLeaseFile6, 6> {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the lease file.
+    LeaseJournal6(const std::string& filename);
+
+    /// @brief Encodes a lease into a record.
+    ///
+    /// @param lease Structure representing a DHCPv6 lease.
+    /// @param [out] buffer the buffer the record is appended to.
+    /// @throw BadValue if the lease has no DUID and is not in
+    /// STATE_DECLINED.
+    static void encode(const Lease6& lease, util::OutputBuffer& buffer);
+
+    /// @brief Decodes a lease from a record.
+    ///
+    /// @param buffer the buffer holding the record.
+    /// @return the decoded lease.
+    /// @throw BadValue or OutOfRange if the record is invalid.
+    static Lease6Ptr decode(util::InputBuffer& buffer);
+
+    /// @brief Appends the lease record to the journal.
+    ///
+    /// @param lease Structure representing a DHCPv6 lease.
+    /// @throw BadValue if the lease has no DUID and is not in
+    /// STATE_DECLINED.
+    virtual void append(const Lease6& lease);
+
+    /// @brief Reads next lease from the journal.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] lease Pointer to the lease read from the journal or
+    /// NULL pointer at the end of the journal.
+    /// @return false if an error occurred, true otherwise.
+    virtual bool next(Lease6Ptr& lease);
+};
+
+/// @brief Begins a lease stream.
+///
+/// A lease stream is the version of the format on one byte, i.e. the
+/// @c FORMAT_VERSION of the journals, followed by a sequence of records
+/// in the format of the lease journal, each preceded by its length on 32
+/// bits. It is used to transfer leases in a compact form, e.g. by the
+/// lease4-get-page and lease6-get-page commands.
+///
+/// @param buffer the stream. It must be empty.
+void writeLeaseStreamHeader(util::OutputBuffer& buffer);
+
+/// @brief Checks the version at the beginning of a lease stream.
+///
+/// @param buffer the stream.
+/// @throw BadValue if the stream is empty or its version is not
+/// supported, e.g. when it was written by a newer version.
+void readLeaseStreamHeader(util::InputBuffer& buffer);
+
+/// @brief Appends a lease to a lease stream.
+///
+/// @param buffer the stream.
+/// @param lease the lease.
+/// @throw BadValue if the lease can't be encoded. The stream is left
+/// unchanged.
+void writeLeaseStreamRecord(util::OutputBuffer& buffer, const Lease4& lease);
+
+/// @brief Appends a lease to a lease stream.
+///
+/// @param buffer the stream.
+/// @param lease the lease.
+/// @throw BadValue if the lease can't be encoded. The stream is left
+/// unchanged.
+void writeLeaseStreamRecord(util::OutputBuffer& buffer, const Lease6& lease);
+
+/// @brief Reads the next lease from a lease stream.
+///
+/// @param buffer the stream.
+/// @param [out] lease the lease or null pointer at the end of the stream.
+/// @return false at the end of the stream, true otherwise.
+/// @throw BadValue or OutOfRange if the record is truncated or invalid.
+bool readLeaseStreamRecord(util::InputBuffer& buffer, Lease4Ptr& lease);
+
+/// @brief Reads the next lease from a lease stream.
+///
+/// @param buffer the stream.
+/// @param [out] lease the lease or null pointer at the end of the stream.
+/// @return false at the end of the stream, true otherwise.
+/// @throw BadValue or OutOfRange if the record is truncated or invalid.
+bool readLeaseStreamRecord(util::InputBuffer& buffer, Lease6Ptr& lease);
+
+/// @brief Maps a CSV lease file type to the journal type.
+///
+/// @tparam LeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+template<typename LeaseFileType>
+struct LeaseJournalTraits;
+
+/// @brief Journal type of the DHCPv4 lease files.
+template<>
+struct LeaseJournalTraits<CSVLeaseFile4> {
+    /// @brief The journal type.
+    typedef LeaseJournal4 JournalType;
+};
+
+/// @brief Journal type of the DHCPv6 lease files.
+template<>
+struct LeaseJournalTraits<CSVLeaseFile6> {
+    /// @brief The journal type.
+    typedef LeaseJournal6 JournalType;
+};
+
+/// @brief Creates the object accessing a lease file in its format.
+///
+/// @tparam LeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+/// @param filename the name of the lease file.
+/// @param default_format the format of the file when it does not exist
+/// or is empty.
+/// @return a CSV lease file or a journal.
+template<typename LeaseFileType>
+boost::shared_ptr<LeaseFileType>
+createLeaseFile(const std::string& filename,
+                const LeaseFileFormat& default_format) {
+    if (getLeaseFileFormat(filename, default_format) == LEASE_FILE_BINARY) {
+        typedef typename LeaseJournalTraits<LeaseFileType>::JournalType JournalType;
+        return (boost::shared_ptr<LeaseFileType>(new JournalType(filename)));
+    }
+    return (boost::shared_ptr<LeaseFileType>(new LeaseFileType(filename)));
+}
+
+/// @brief Converts a lease file to another format.
+///
+/// All the records of the input file, including the updates and the
+/// removals, are appended to the output file in their order so the
+/// output replays to the same leases. The records which can't be read
+/// are skipped.
+///
+/// @tparam LeaseObjectType @c Lease4 or @c Lease6.
+/// @tparam LeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+/// @param input the name of the input file, in any format.
+/// @param output the name of the output file. It is overwritten.
+/// @param format the format of the output file.
+/// @return the number of records which could not be read.
+/// @throw CSVFileError if a file can't be opened or written.
+template<typename LeaseObjectType, typename LeaseFileType>
+uint32_t
+convertLeaseFile(const std::string& input, const std::string& output,
+                 const LeaseFileFormat& format) {
+    boost::shared_ptr<LeaseFileType> input_file =
+        createLeaseFile<LeaseFileType>(input, LEASE_FILE_CSV);
+    // Remove a previous output so the file is created in the format.
+    static_cast<void>(std::remove(output.c_str()));
+    boost::shared_ptr<LeaseFileType> output_file =
+        createLeaseFile<LeaseFileType>(output, format);
+    input_file->open();
+    output_file->open(true);
+    uint32_t errors = 0;
+    boost::shared_ptr<LeaseObjectType> lease;
+    for (;;) {
+        if (!input_file->next(lease)) {
+            ++errors;
+            continue;
+        }
+        if (!lease) {
+            break;
+        }
+        output_file->append(*lease);
+    }
+    output_file->close();
+    input_file->close();
+    return (errors);
+}
+
+}  // namespace dhcp
+}  // namespace isc
+
+#endif // LEASE_JOURNAL_H
@@ -0,0 +1,196 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/memfile_lease_arena.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <functional>
+#include <new>
+
+using namespace isc::data;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+// Explicit definition of class static constants.  Values are given in the
+// declaration so they're not needed here.
+const size_t LeaseBlockPool::BLOCK_ALIGNMENT;
+const size_t LeaseBlockPool::MAX_BLOCK_SIZE;
+const size_t LeaseBlockPool::SLAB_SIZE;
+
+LeaseBlockPool::LeaseBlockPool()
+    : free_lists_(MAX_BLOCK_SIZE / BLOCK_ALIGNMENT + 1, 0), slabs_(),
+      slab_pos_(SLAB_SIZE), block_count_(0) {
+}
+
+LeaseBlockPool::~LeaseBlockPool() {
+    for (auto const& slab : slabs_) {
+        ::operator delete(slab);
+    }
+}
+
+void*
+LeaseBlockPool::allocate(size_t size) {
+    size_t size_class = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT;
+    if (size_class == 0) {
+        size_class = 1;
+    }
+    size_t block_size = size_class * BLOCK_ALIGNMENT;
+    lock_guard<mutex> lock(mutex_);
+    if (block_size > MAX_BLOCK_SIZE) {
+        void* block = ::operator new(size);
+        ++block_count_;
+        return (block);
+    }
+    FreeBlock* block = free_lists_[size_class];
+    if (block) {
+        free_lists_[size_class] = block->next_;
+        ++block_count_;
+        return (block);
+    }
+    if (slab_pos_ + block_size > SLAB_SIZE) {
+        slabs_.push_back(static_cast<char*>(::operator new(SLAB_SIZE)));
+        slab_pos_ = 0;
+    }
+    void* new_block = slabs_.back() + slab_pos_;
+    slab_pos_ += block_size;
+    ++block_count_;
+    return (new_block);
+}
+
+void
+LeaseBlockPool::deallocate(void* block, size_t size) {
+    size_t size_class = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT;
+    if (size_class == 0) {
+        size_class = 1;
+    }
+    lock_guard<mutex> lock(mutex_);
+    --block_count_;
+    if (size_class * BLOCK_ALIGNMENT > MAX_BLOCK_SIZE) {
+        ::operator delete(block);
+        return;
+    }
+    FreeBlock* free_block = static_cast<FreeBlock*>(block);
+    free_block->next_ = free_lists_[size_class];
+    free_lists_[size_class] = free_block;
+}
+
+LeaseBlockPool&
+LeaseBlockPool::instance() {
+    static LeaseBlockPool* pool = new LeaseBlockPool();
+    return (*pool);
+}
+
+size_t
+LeaseBlockPool::getBlockCount() const {
+    lock_guard<mutex> lock(mutex_);
+    return (block_count_);
+}
+
+size_t
+LeaseBlockPool::getSlabBytes() const {
+    lock_guard<mutex> lock(mutex_);
+    return (slabs_.size() * SLAB_SIZE);
+}
+
+MemfileLeaseArena::MemfileLeaseArena()
+    : contexts_(), duids_(), hwaddrs_() {
+}
+
+template<typename T>
+boost::shared_ptr<T>
+MemfileLeaseArena::allocate(const T& value) {
+    LeaseBlockPool& pool = LeaseBlockPool::instance();
+    void* block = pool.allocate(sizeof(T));
+    T* object = 0;
+    try {
+        object = new (block) T(value);
+    } catch (...) {
+        pool.deallocate(block, sizeof(T));
+        throw;
+    }
+    // The reference counter is allocated from the pool too. Note that
+    // boost::allocate_shared would put the object and the counter in a
+    // single block but with a larger counter.
+    return (boost::shared_ptr<T>(object, LeaseBlockDeleter(),
+                                 LeaseBlockAllocator<T>()));
+}
+
+ConstElementPtr
+MemfileLeaseArena::internContext(const ConstElementPtr& context) {
+    if (!context) {
+        return (context);
+    }
+    size_t hash = std::hash<string>()(context->str());
+    ConstElementPtr interned =
+        contexts_.find(hash, [&context](const Element& value) {
+            return (value.equals(*context));
+        });
+    if (!interned) {
+        // Intern a copy so the value can't be changed by the caller.
+        interned = isc::data::copy(context);
+        contexts_.insert(hash, interned);
+    }
+    return (interned);
+}
+
+Lease4Ptr
+MemfileLeaseArena::copy(const Lease4& lease) {
+    Lease4Ptr lease_copy = allocate(lease);
+    if (lease.hwaddr_) {
+        lease_copy->hwaddr_ = allocate(*lease.hwaddr_);
+    }
+    if (lease.client_id_) {
+        lease_copy->client_id_ = allocate(*lease.client_id_);
+    }
+    lease_copy->setContext(internContext(lease.getContext()));
+    return (lease_copy);
+}
+
+Lease6Ptr
+MemfileLeaseArena::copy(const Lease6& lease) {
+    Lease6Ptr lease_copy = allocate(lease);
+    if (lease.duid_) {
+        const vector<uint8_t>& duid = lease.duid_->getDuid();
+        size_t hash = boost::hash_range(duid.begin(), duid.end());
+        DuidPtr interned = duids_.find(hash, [&duid](const DUID& value) {
+            return (value.getDuid() == duid);
+        });
+        if (!interned) {
+            interned = allocate(*lease.duid_);
+            duids_.insert(hash, interned);
+        }
+        lease_copy->duid_ = interned;
+    }
+    if (lease.hwaddr_) {
+        const HWAddr& hwaddr = *lease.hwaddr_;
+        size_t hash = boost::hash_range(hwaddr.hwaddr_.begin(),
+                                        hwaddr.hwaddr_.end());
+        boost::hash_combine(hash, hwaddr.htype_);
+        HWAddrPtr interned = hwaddrs_.find(hash, [&hwaddr](const HWAddr& value) {
+            return ((value == hwaddr) && (value.source_ == hwaddr.source_));
+        });
+        if (!interned) {
+            interned = allocate(hwaddr);
+            hwaddrs_.insert(hash, interned);
+        }
+        lease_copy->hwaddr_ = interned;
+    }
+    lease_copy->setContext(internContext(lease.getContext()));
+    return (lease_copy);
+}
+
+size_t
+MemfileLeaseArena::getInternedCount() const {
+    return (contexts_.size() + duids_.size() + hwaddrs_.size());
+}
+
+}  // namespace dhcp
+}  // namespace isc
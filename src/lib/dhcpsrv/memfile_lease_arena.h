@@ -0,0 +1,321 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MEMFILE_LEASE_ARENA_H
+#define MEMFILE_LEASE_ARENA_H
+
+#include <cc/data.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/lease.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Pool of fixed-size memory blocks.
+///
+/// The blocks are carved out of large slabs and are grouped in size
+/// classes rounded to @c BLOCK_ALIGNMENT. A released block is kept in the
+/// free list of its size class for the next allocation of that size:
+/// the slabs are never returned to the system. Blocks larger than
+/// @c MAX_BLOCK_SIZE are allocated on the heap.
+///
+/// Compared to the heap the blocks have no allocation header, which is
+/// significant for the small objects of a lease.
+class LeaseBlockPool : public boost::noncopyable {
+public:
+
+    /// @brief Alignment and granularity of the blocks.
+    static const size_t BLOCK_ALIGNMENT = 8;
+
+    /// @brief Size of the largest block taken from the slabs.
+    static const size_t MAX_BLOCK_SIZE = 1024;
+
+    /// @brief Size of a slab.
+    static const size_t SLAB_SIZE = 256 * 1024;
+
+    /// @brief Constructor.
+    LeaseBlockPool();
+
+    /// @brief Destructor.
+    ///
+    /// Releases the slabs.
+    ~LeaseBlockPool();
+
+    /// @brief Returns the pool used by the memfile lease arenas.
+    ///
+    /// The blocks can outlive the arena which allocated them (e.g. the
+    /// hardware address of a lease returned to a caller is shared with
+    /// the stored lease), so this pool is never destroyed.
+    static LeaseBlockPool& instance();
+
+    /// @brief Allocates a block.
+    ///
+    /// @param size size of the block.
+    /// @return pointer to the block.
+    void* allocate(size_t size);
+
+    /// @brief Releases a block.
+    ///
+    /// @param block pointer to the block.
+    /// @param size size of the block given to @ref allocate.
+    void deallocate(void* block, size_t size);
+
+    /// @brief Returns the number of blocks in use.
+    size_t getBlockCount() const;
+
+    /// @brief Returns the number of bytes allocated for the slabs.
+    size_t getSlabBytes() const;
+
+private:
+
+    /// @brief A free block, linked in the free list of its size class.
+    struct FreeBlock {
+        /// @brief Next free block.
+        FreeBlock* next_;
+    };
+
+    /// @brief Protects the free lists and the slabs.
+    mutable std::mutex mutex_;
+
+    /// @brief Free lists indexed by size class.
+    std::vector<FreeBlock*> free_lists_;
+
+    /// @brief The slabs.
+    std::vector<char*> slabs_;
+
+    /// @brief Position of the unused part of the last slab.
+    size_t slab_pos_;
+
+    /// @brief Number of blocks in use.
+    size_t block_count_;
+};
+
+/// @brief Standard allocator taking its memory from the lease block pool.
+///
+/// It is used for the reference counters of the objects allocated by
+/// @ref MemfileLeaseArena. It is stateless so it does not make the
+/// reference counters larger.
+///
+/// @tparam T type of the allocated objects.
+template<typename T>
+class LeaseBlockAllocator {
+public:
+
+    /// @brief Type of the allocated objects.
+    typedef T value_type;
+
+    /// @brief Rebinds the allocator to another type.
+    template<typename U>
+    struct rebind {
+        /// @brief The allocator for the other type.
+        typedef LeaseBlockAllocator<U> other;
+    };
+
+    /// @brief Constructor.
+    LeaseBlockAllocator() {
+    }
+
+    /// @brief Converting constructor.
+    template<typename U>
+    LeaseBlockAllocator(const LeaseBlockAllocator<U>&) {
+    }
+
+    /// @brief Allocates memory for objects.
+    ///
+    /// @param n number of objects.
+    T* allocate(size_t n) {
+        return (static_cast<T*>(LeaseBlockPool::instance().allocate(n * sizeof(T))));
+    }
+
+    /// @brief Releases memory of objects.
+    ///
+    /// @param p pointer to the objects.
+    /// @param n number of objects.
+    void deallocate(T* p, size_t n) {
+        LeaseBlockPool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    /// @brief Equality operator.
+    template<typename U>
+    bool operator==(const LeaseBlockAllocator<U>&) const {
+        return (true);
+    }
+
+    /// @brief Inequality operator.
+    template<typename U>
+    bool operator!=(const LeaseBlockAllocator<U>&) const {
+        return (false);
+    }
+};
+
+/// @brief Deleter of the objects allocated from the lease block pool.
+struct LeaseBlockDeleter {
+    /// @brief Destroys an object and releases its block.
+    ///
+    /// @tparam T type of the object.
+    /// @param object pointer to the object.
+    template<typename T>
+    void operator()(T* object) const {
+        object->~T();
+        LeaseBlockPool::instance().deallocate(object, sizeof(T));
+    }
+};
+
+/// @brief Arena holding the compact copies of the leases stored by the
+/// memfile backend.
+///
+/// In compact mode the memfile backend stores copies built by the arena
+/// instead of the lease objects it is given:
+/// - a lease, its hardware address, client identifier or DUID and their
+///   reference counters are allocated from the lease block pool, so they
+///   do not pay for a heap allocation header,
+/// - the user contexts, the DUIDs and the DHCPv6 hardware addresses,
+///   which are often shared by several leases (a client holding an
+///   address and a prefix, identical contexts), are interned: equal
+///   values are stored once.
+///
+/// Interned values which are no longer used by a lease are purged when
+/// an interning table has doubled in size since the last purge.
+///
+/// The arena is not thread safe: the memfile backend uses it under its
+/// mutex. Only the release of blocks, which happens when the last
+/// reference to a lease copy is dropped, is thread safe.
+class MemfileLeaseArena : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    MemfileLeaseArena();
+
+    /// @brief Returns a compact copy of a DHCPv4 lease.
+    ///
+    /// @param lease the lease to copy.
+    /// @return the compact copy.
+    Lease4Ptr copy(const Lease4& lease);
+
+    /// @brief Returns a compact copy of a DHCPv6 lease.
+    ///
+    /// @param lease the lease to copy.
+    /// @return the compact copy.
+    Lease6Ptr copy(const Lease6& lease);
+
+    /// @brief Returns the number of interned values.
+    size_t getInternedCount() const;
+
+private:
+
+    /// @brief Table of interned values.
+    ///
+    /// The values are indexed by a hash of their content only, so the
+    /// table does not keep a second copy of the content.
+    ///
+    /// @tparam T type of the interned values.
+    template<typename T>
+    class InternTable {
+    public:
+
+        /// @brief Pointer to an interned value.
+        typedef boost::shared_ptr<T> ValuePtr;
+
+        /// @brief Constructor.
+        InternTable() : values_(), purge_size_(MIN_PURGE_SIZE) {
+        }
+
+        /// @brief Looks for an interned value.
+        ///
+        /// @tparam Equal type of the value comparison function.
+        /// @param hash hash of the value.
+        /// @param equal function returning true for the searched value.
+        /// @return the interned value or null.
+        template<typename Equal>
+        ValuePtr find(size_t hash, Equal equal) const {
+            auto range = values_.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (equal(*it->second)) {
+                    return (it->second);
+                }
+            }
+            return (ValuePtr());
+        }
+
+        /// @brief Interns a value.
+        ///
+        /// @param hash hash of the value.
+        /// @param value the value.
+        void insert(size_t hash, const ValuePtr& value) {
+            if (values_.size() >= purge_size_) {
+                purge();
+            }
+            values_.emplace(hash, value);
+        }
+
+        /// @brief Returns the number of interned values.
+        size_t size() const {
+            return (values_.size());
+        }
+
+    private:
+
+        /// @brief Removes the values which are no longer used by a lease.
+        void purge() {
+            for (auto it = values_.begin(); it != values_.end(); ) {
+                if (it->second.use_count() == 1) {
+                    it = values_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            purge_size_ = 2 * values_.size();
+            if (purge_size_ < MIN_PURGE_SIZE) {
+                purge_size_ = MIN_PURGE_SIZE;
+            }
+        }
+
+        /// @brief Size of the table below which it is never purged.
+        static const size_t MIN_PURGE_SIZE = 1024;
+
+        /// @brief Interned values by hash.
+        std::unordered_multimap<size_t, ValuePtr> values_;
+
+        /// @brief Size of the table triggering the next purge.
+        size_t purge_size_;
+    };
+
+    /// @brief Returns a copy of a value allocated in the pool.
+    ///
+    /// @tparam T type of the value.
+    /// @param value the value.
+    /// @return the copy.
+    template<typename T>
+    boost::shared_ptr<T> allocate(const T& value);
+
+    /// @brief Returns the interned copy of a user context.
+    ///
+    /// @param context the user context.
+    /// @return the interned copy.
+    data::ConstElementPtr internContext(const data::ConstElementPtr& context);
+
+    /// @brief Interned user contexts.
+    InternTable<const data::Element> contexts_;
+
+    /// @brief Interned DUIDs.
+    InternTable<DUID> duids_;
+
+    /// @brief Interned hardware addresses.
+    InternTable<HWAddr> hwaddrs_;
+};
+
+}  // namespace dhcp
+}  // namespace isc
+
+#endif // MEMFILE_LEASE_ARENA_H
@@ -974,12 +974,36 @@ const int Memfile_LeaseMgr::MAJOR_VERSION_V6;
 const int Memfile_LeaseMgr::MINOR_VERSION_V6;
 
 Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& parameters)
-    : TrackingLeaseMgr(), lfc_setup_(), conn_(parameters), mutex_(new std::mutex) {
+    : TrackingLeaseMgr(), format_(LEASE_FILE_CSV), lfc_setup_(),
+      conn_(parameters), mutex_(new std::mutex) {
     bool conversion_needed = false;
 
     // Check if the extended info tables are enabled.
     setExtendedInfoTablesEnabled(parameters);
 
+    // Check if the compact storage mode is enabled.
+    std::string compact_val = "false";
+    try {
+        compact_val = conn_.getParameter("compact");
+    } catch (const std::exception&) {
+        // Ignore and default to false.
+    }
+    if (compact_val == "true") {
+        arena_.reset(new MemfileLeaseArena());
+    } else if (compact_val != "false") {
+        isc_throw(isc::BadValue, "invalid value 'compact="
+                  << compact_val << "'");
+    }
+
+    // Check the format of the lease file.
+    std::string format_val = "csv";
+    try {
+        format_val = conn_.getParameter("format");
+    } catch (const std::exception&) {
+        // Ignore and default to csv.
+    }
+    format_ = leaseFileFormatFromText(format_val);
+
     // Check the universe and use v4 file or v6 file.
     std::string universe = conn_.getParameter("universe");
     if (universe == "4") {
@@ -989,6 +1013,7 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
                                                  CSVLeaseFile4>(file4,
                                                                 lease_file4_,
                                                                 storage4_);
+            compactStorage(storage4_);
             static_cast<void>(extractExtendedInfo4(false, false));
         }
     } else {
@@ -998,6 +1023,7 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
                                                  CSVLeaseFile6>(file6,
                                                                 lease_file6_,
                                                                 storage6_);
+            compactStorage(storage6_);
             buildExtendedInfoTables6();
         }
     }
@@ -1014,11 +1040,16 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
             LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES)
                     .arg(version.first).arg(version.second);
         }
+        writerSetup();
         lfcSetup(conversion_needed);
     }
 }
 
 Memfile_LeaseMgr::~Memfile_LeaseMgr() {
+    if (writer_) {
+        writer_->stop();
+        writer_.reset();
+    }
     if (lease_file4_) {
         lease_file4_->close();
         lease_file4_.reset();
@@ -1065,12 +1096,16 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease4Ptr& lease) {
         lease_file4_->append(*lease);
     }
 
-    storage4_.insert(lease);
-
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
     lease->updateCurrentExpirationTime();
 
+    if (arena_) {
+        storage4_.insert(arena_->copy(*lease));
+    } else {
+        storage4_.insert(lease);
+    }
+
     // Increment class lease counters.
     class_lease_counter_.addLease(lease);
 
@@ -1087,12 +1122,18 @@ Memfile_LeaseMgr::addLease(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_ADD_ADDR4).arg(lease->addr_.toText());
 
+    LeaseFileWriter::Tickets writes;
+    bool added;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
-        return (addLeaseInternal(lease));
+        added = addLeaseInternal(lease);
+        writes.swap(pending_writes_);
     } else {
-        return (addLeaseInternal(lease));
+        added = addLeaseInternal(lease);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
+    return (added);
 }
 
 bool
@@ -1110,12 +1151,17 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease6Ptr& lease) {
     }
 
     lease->extended_info_action_ = Lease6::ACTION_IGNORE;
-    storage6_.insert(lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
     lease->updateCurrentExpirationTime();
 
+    if (arena_) {
+        storage6_.insert(arena_->copy(*lease));
+    } else {
+        storage6_.insert(lease);
+    }
+
     // Increment class lease counters.
     class_lease_counter_.addLease(lease);
 
@@ -1136,18 +1182,25 @@ Memfile_LeaseMgr::addLease(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_ADD_ADDR6).arg(lease->addr_.toText());
 
+    LeaseFileWriter::Tickets writes;
+    bool added;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
-        return (addLeaseInternal(lease));
+        added = addLeaseInternal(lease);
+        writes.swap(pending_writes_);
     } else {
-        return (addLeaseInternal(lease));
+        added = addLeaseInternal(lease);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
+    return (added);
 }
 
 Lease4Ptr
 Memfile_LeaseMgr::getLease4Internal(const isc::asiolink::IOAddress& addr) const {
-    const Lease4StorageAddressIndex& idx = storage4_.get<AddressIndexTag>();
-    Lease4StorageAddressIndex::iterator l = idx.find(addr);
+    const Lease4StorageHashedAddressIndex& idx =
+        storage4_.get<HashedAddressIndexTag>();
+    Lease4StorageHashedAddressIndex::iterator l = idx.find(addr);
     if (l == idx.end()) {
         return (Lease4Ptr());
     } else {
@@ -1171,13 +1224,11 @@ Memfile_LeaseMgr::getLease4(const isc::asiolink::IOAddress& addr) const {
 void
 Memfile_LeaseMgr::getLease4Internal(const HWAddr& hwaddr,
                                     Lease4Collection& collection) const {
-    // Using composite index by 'hw address' and 'subnet id'. It is
-    // ok to use it for searching by the 'hw address' only.
-    const Lease4StorageHWAddressSubnetIdIndex& idx =
-        storage4_.get<HWAddressSubnetIdIndexTag>();
-    std::pair<Lease4StorageHWAddressSubnetIdIndex::const_iterator,
-              Lease4StorageHWAddressSubnetIdIndex::const_iterator> l
-        = idx.equal_range(boost::make_tuple(hwaddr.hwaddr_));
+    // Get the index by HW Address.
+    const Lease4StorageHWAddressIndex& idx = storage4_.get<HWAddressIndexTag>();
+    std::pair<Lease4StorageHWAddressIndex::const_iterator,
+              Lease4StorageHWAddressIndex::const_iterator> l
+        = idx.equal_range(hwaddr.hwaddr_);
 
     BOOST_FOREACH(auto const& lease, l) {
         collection.push_back(Lease4Ptr(new Lease4(*lease)));
@@ -1236,13 +1287,11 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr,
 void
 Memfile_LeaseMgr::getLease4Internal(const ClientId& client_id,
                                     Lease4Collection& collection) const {
-    // Using composite index by 'client id' and 'subnet id'. It is ok
-    // to use it to search by 'client id' only.
-    const Lease4StorageClientIdSubnetIdIndex& idx =
-        storage4_.get<ClientIdSubnetIdIndexTag>();
-    std::pair<Lease4StorageClientIdSubnetIdIndex::const_iterator,
-              Lease4StorageClientIdSubnetIdIndex::const_iterator> l
-        = idx.equal_range(boost::make_tuple(client_id.getClientId()));
+    // Get the index by client id.
+    const Lease4StorageClientIdIndex& idx = storage4_.get<ClientIdIndexTag>();
+    std::pair<Lease4StorageClientIdIndex::const_iterator,
+              Lease4StorageClientIdIndex::const_iterator> l
+        = idx.equal_range(client_id.getClientId());
 
     BOOST_FOREACH(auto const& lease, l) {
         collection.push_back(Lease4Ptr(new Lease4(*lease)));
@@ -1425,8 +1474,10 @@ Memfile_LeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
 Lease6Ptr
 Memfile_LeaseMgr::getLease6Internal(Lease::Type type,
                                     const isc::asiolink::IOAddress& addr) const {
-    Lease6Storage::iterator l = storage6_.find(addr);
-    if (l == storage6_.end() || !(*l) || ((*l)->type_ != type)) {
+    const Lease6StorageHashedAddressIndex& idx =
+        storage6_.get<HashedAddressIndexTag>();
+    Lease6StorageHashedAddressIndex::iterator l = idx.find(addr);
+    if (l == idx.end() || !(*l) || ((*l)->type_ != type)) {
         return (Lease6Ptr());
     } else {
         return (Lease6Ptr(new Lease6(**l)));
@@ -1435,8 +1486,10 @@ Memfile_LeaseMgr::getLease6Internal(Lease::Type type,
 
 Lease6Ptr
 Memfile_LeaseMgr::getAnyLease6Internal(const isc::asiolink::IOAddress& addr) const {
-    Lease6Storage::iterator l = storage6_.find(addr);
-    if (l == storage6_.end() || !(*l)) {
+    const Lease6StorageHashedAddressIndex& idx =
+        storage6_.get<HashedAddressIndexTag>();
+    Lease6StorageHashedAddressIndex::iterator l = idx.find(addr);
+    if (l == idx.end() || !(*l)) {
         return (Lease6Ptr());
     } else {
         return (Lease6Ptr(new Lease6(**l)));
@@ -1829,12 +1882,14 @@ Memfile_LeaseMgr::getExpiredLeases6(Lease6Collection& expired_leases,
 void
 Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     // Obtain 'by address' index.
-    Lease4StorageAddressIndex& index = storage4_.get<AddressIndexTag>();
+    Lease4StorageHashedAddressIndex& index =
+        storage4_.get<HashedAddressIndexTag>();
 
     bool persist = persistLeases(V4);
 
     // Lease must exist if it is to be updated.
-    Lease4StorageAddressIndex::const_iterator lease_it = index.find(lease->addr_);
+    Lease4StorageHashedAddressIndex::const_iterator lease_it =
+        index.find(lease->addr_);
     if (lease_it == index.end()) {
         isc_throw(NoSuchLease, "failed to update the lease with address "
                   << lease->addr_ << " - no such lease");
@@ -1861,7 +1916,7 @@ Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     Lease4Ptr old_lease = *lease_it;
 
     // Use replace() to re-index leases.
-    index.replace(lease_it, Lease4Ptr(new Lease4(*lease)));
+    index.replace(lease_it, copyLease(*lease));
 
     // Adjust class lease counters.
     class_lease_counter_.updateLease(lease, old_lease);
@@ -1877,18 +1932,23 @@ Memfile_LeaseMgr::updateLease4(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_UPDATE_ADDR4).arg(lease->addr_.toText());
 
+    LeaseFileWriter::Tickets writes;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         updateLease4Internal(lease);
+        writes.swap(pending_writes_);
     } else {
         updateLease4Internal(lease);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
 }
 
 void
 Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     // Obtain 'by address' index.
-    Lease6StorageAddressIndex& index = storage6_.get<AddressIndexTag>();
+    Lease6StorageHashedAddressIndex& index =
+        storage6_.get<HashedAddressIndexTag>();
 
     bool persist = persistLeases(V6);
 
@@ -1897,7 +1957,8 @@ Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     lease->extended_info_action_ = Lease6::ACTION_IGNORE;
 
     // Lease must exist if it is to be updated.
-    Lease6StorageAddressIndex::const_iterator lease_it = index.find(lease->addr_);
+    Lease6StorageHashedAddressIndex::const_iterator lease_it =
+        index.find(lease->addr_);
     if (lease_it == index.end()) {
         isc_throw(NoSuchLease, "failed to update the lease with address "
                   << lease->addr_ << " - no such lease");
@@ -1924,7 +1985,7 @@ Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     Lease6Ptr old_lease = *lease_it;
 
     // Use replace() to re-index leases.
-    index.replace(lease_it, Lease6Ptr(new Lease6(*lease)));
+    index.replace(lease_it, copyLease(*lease));
 
     // Adjust class lease counters.
     class_lease_counter_.updateLease(lease, old_lease);
@@ -1957,19 +2018,25 @@ Memfile_LeaseMgr::updateLease6(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_UPDATE_ADDR6).arg(lease->addr_.toText());
 
+    LeaseFileWriter::Tickets writes;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         updateLease6Internal(lease);
+        writes.swap(pending_writes_);
     } else {
         updateLease6Internal(lease);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
 }
 
 bool
 Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
     const isc::asiolink::IOAddress& addr = lease->addr_;
-    Lease4Storage::iterator l = storage4_.find(addr);
-    if (l == storage4_.end()) {
+    Lease4StorageHashedAddressIndex& index =
+        storage4_.get<HashedAddressIndexTag>();
+    Lease4StorageHashedAddressIndex::iterator l = index.find(addr);
+    if (l == index.end()) {
         // No such lease
         return (false);
     } else {
@@ -1990,7 +2057,7 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
             }
         }
 
-        storage4_.erase(l);
+        index.erase(l);
 
         // Decrement class lease counters.
         class_lease_counter_.removeLease(lease);
@@ -2009,12 +2076,18 @@ Memfile_LeaseMgr::deleteLease(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_DELETE_ADDR4).arg(lease->addr_.toText());
 
+    LeaseFileWriter::Tickets writes;
+    bool deleted;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
-        return (deleteLeaseInternal(lease));
+        deleted = deleteLeaseInternal(lease);
+        writes.swap(pending_writes_);
     } else {
-        return (deleteLeaseInternal(lease));
+        deleted = deleteLeaseInternal(lease);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
+    return (deleted);
 }
 
 bool
@@ -2022,8 +2095,10 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease6Ptr& lease) {
     lease->extended_info_action_ = Lease6::ACTION_IGNORE;
 
     const isc::asiolink::IOAddress& addr = lease->addr_;
-    Lease6Storage::iterator l = storage6_.find(addr);
-    if (l == storage6_.end()) {
+    Lease6StorageHashedAddressIndex& index =
+        storage6_.get<HashedAddressIndexTag>();
+    Lease6StorageHashedAddressIndex::iterator l = index.find(addr);
+    if (l == index.end()) {
         // No such lease
         return (false);
     } else {
@@ -2044,7 +2119,7 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease6Ptr& lease) {
             }
         }
 
-        storage6_.erase(l);
+        index.erase(l);
 
         // Decrement class lease counters.
         class_lease_counter_.removeLease(lease);
@@ -2068,12 +2143,18 @@ Memfile_LeaseMgr::deleteLease(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_DELETE_ADDR6).arg(lease->addr_.toText());
 
+    LeaseFileWriter::Tickets writes;
+    bool deleted;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
-        return (deleteLeaseInternal(lease));
+        deleted = deleteLeaseInternal(lease);
+        writes.swap(pending_writes_);
     } else {
-        return (deleteLeaseInternal(lease));
+        deleted = deleteLeaseInternal(lease);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
+    return (deleted);
 }
 
 uint64_t
@@ -2082,16 +2163,22 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
               DHCPSRV_MEMFILE_DELETE_EXPIRED_RECLAIMED4)
         .arg(secs);
 
+    LeaseFileWriter::Tickets writes;
+    uint64_t deleted;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
-        return (deleteExpiredReclaimedLeases<
-                Lease4StorageExpirationIndex, Lease4
-                >(secs, V4, storage4_, lease_file4_));
+        deleted = deleteExpiredReclaimedLeases<
+            Lease4StorageExpirationIndex, Lease4
+            >(secs, V4, storage4_, lease_file4_);
+        writes.swap(pending_writes_);
     } else {
-        return (deleteExpiredReclaimedLeases<
-                Lease4StorageExpirationIndex, Lease4
-                >(secs, V4, storage4_, lease_file4_));
+        deleted = deleteExpiredReclaimedLeases<
+            Lease4StorageExpirationIndex, Lease4
+            >(secs, V4, storage4_, lease_file4_);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
+    return (deleted);
 }
 
 uint64_t
@@ -2100,16 +2187,22 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases6(const uint32_t secs) {
               DHCPSRV_MEMFILE_DELETE_EXPIRED_RECLAIMED6)
         .arg(secs);
 
+    LeaseFileWriter::Tickets writes;
+    uint64_t deleted;
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
-        return (deleteExpiredReclaimedLeases<
-                Lease6StorageExpirationIndex, Lease6
-                >(secs, V6, storage6_, lease_file6_));
+        deleted = deleteExpiredReclaimedLeases<
+            Lease6StorageExpirationIndex, Lease6
+            >(secs, V6, storage6_, lease_file6_);
+        writes.swap(pending_writes_);
     } else {
-        return (deleteExpiredReclaimedLeases<
-                Lease6StorageExpirationIndex, Lease6
-                >(secs, V6, storage6_, lease_file6_));
+        deleted = deleteExpiredReclaimedLeases<
+            Lease6StorageExpirationIndex, Lease6
+            >(secs, V6, storage6_, lease_file6_);
+        writes.swap(pending_writes_);
     }
+    waitForWrites(writes);
+    return (deleted);
 }
 
 template<typename IndexType, typename LeaseType, typename StorageType,
@@ -2331,7 +2424,8 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
 
     // Load the leasefile.completed, if exists.
     bool conversion_needed = false;
-    lease_file.reset(new LeaseFileType(std::string(filename + ".completed")));
+    lease_file = createLeaseFile<LeaseFileType>(filename + ".completed",
+                                                format_);
     if (lease_file->exists()) {
         LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
                                                max_row_errors);
@@ -2339,14 +2433,18 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
     } else {
         // If the leasefile.completed doesn't exist, let's load the leases
         // from leasefile.2 and leasefile.1, if they exist.
-        lease_file.reset(new LeaseFileType(appendSuffix(filename, FILE_PREVIOUS)));
+        lease_file = createLeaseFile<LeaseFileType>(appendSuffix(filename,
+                                                                 FILE_PREVIOUS),
+                                                    format_);
         if (lease_file->exists()) {
             LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
                                                    max_row_errors);
             conversion_needed = conversion_needed || lease_file->needsConversion();
         }
 
-        lease_file.reset(new LeaseFileType(appendSuffix(filename, FILE_INPUT)));
+        lease_file = createLeaseFile<LeaseFileType>(appendSuffix(filename,
+                                                                 FILE_INPUT),
+                                                    format_);
         if (lease_file->exists()) {
             LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
                                                    max_row_errors);
@@ -2359,8 +2457,21 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
     // that the false value passed as the last parameter to load
     // function causes the function to leave the file open after
     // it is parsed. This file will be used by the backend to record
-    // future lease updates.
-    lease_file.reset(new LeaseFileType(filename));
+    // future lease updates. The lease file in the other format is
+    // converted first.
+    if (getLeaseFileFormat(filename, format_) != format_) {
+        LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_CONVERTING_LEASE_FILE_FORMAT)
+            .arg(filename).arg(leaseFileFormatToText(format_));
+        std::string converted = filename + ".convert";
+        static_cast<void>(convertLeaseFile<LeaseObjectType,
+                                           LeaseFileType>(filename, converted,
+                                                          format_));
+        if (rename(converted.c_str(), filename.c_str()) != 0) {
+            isc_throw(DbOpenError, "unable to rename " << converted
+                      << " to " << filename << ": " << strerror(errno));
+        }
+    }
+    lease_file = createLeaseFile<LeaseFileType>(filename, format_);
     LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
                                            max_row_errors, false);
     conversion_needed = conversion_needed || lease_file->needsConversion();
@@ -2368,6 +2479,34 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
     return (conversion_needed);
 }
 
+template<typename StorageType>
+void
+Memfile_LeaseMgr::compactStorage(StorageType& storage) {
+    if (!arena_) {
+        return;
+    }
+    // The copies have the same address so replace() keeps their position.
+    auto& index = storage.template get<AddressIndexTag>();
+    for (auto lease_it = index.begin(); lease_it != index.end(); ++lease_it) {
+        index.replace(lease_it, arena_->copy(**lease_it));
+    }
+}
+
+Lease4Ptr
+Memfile_LeaseMgr::copyLease(const Lease4& lease) {
+    if (arena_) {
+        return (arena_->copy(lease));
+    }
+    return (Lease4Ptr(new Lease4(lease)));
+}
+
+Lease6Ptr
+Memfile_LeaseMgr::copyLease(const Lease6& lease) {
+    if (arena_) {
+        return (arena_->copy(lease));
+    }
+    return (Lease6Ptr(new Lease6(lease)));
+}
 
 bool
 Memfile_LeaseMgr::isLFCRunning() const {
@@ -2416,11 +2555,93 @@ Memfile_LeaseMgr::lfcSetup(bool conversion_needed) {
     }
 }
 
+void
+Memfile_LeaseMgr::writerSetup() {
+    uint32_t values[2] = { 0, 0 };
+    const char* names[2] = { "write-queue-size", "write-max-delay" };
+    for (size_t i = 0; i < 2; ++i) {
+        std::string value_str = "0";
+        try {
+            value_str = conn_.getParameter(names[i]);
+        } catch (const std::exception&) {
+            // Ignore and default to 0.
+        }
+        try {
+            values[i] = boost::lexical_cast<uint32_t>(value_str);
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(isc::BadValue, "invalid value of the " << names[i]
+                      << " " << value_str << " specified");
+        }
+    }
+
+    std::string sync_str = "false";
+    try {
+        sync_str = conn_.getParameter("write-sync");
+    } catch (const std::exception&) {
+        // Ignore and default to false.
+    }
+    if ((sync_str != "true") && (sync_str != "false")) {
+        isc_throw(isc::BadValue, "invalid value 'write-sync="
+                  << sync_str << "'");
+    }
+    bool sync = (sync_str == "true");
+
+    LeaseFileWriter::WriteFunc write = [this, sync](const std::string& rows) {
+        boost::shared_ptr<CSVFile> lease_file;
+        if (lease_file4_) {
+            lease_file = lease_file4_;
+        } else {
+            lease_file = lease_file6_;
+        }
+        if (!lease_file) {
+            isc_throw(CSVFileError, "no lease file to write to");
+        }
+        lease_file->appendRendered(rows);
+        if (sync) {
+            lease_file->sync();
+        }
+    };
+
+    CSVFile::RowHandler handler;
+    if (values[0] == 0) {
+        if (!sync) {
+            return;
+        }
+        // Synchronous writes followed by a synchronization.
+        handler = write;
+    } else {
+        // The writer is called from its thread while the lease file can be
+        // rotated by the LFC: this is why the LFC drains the writer first.
+        writer_.reset(new LeaseFileWriter(write, values[0], values[1]));
+        handler = [this](const std::string& row) {
+            pending_writes_.push_back(writer_->post(row));
+        };
+    }
+    if (lease_file4_) {
+        lease_file4_->setRowHandler(handler);
+    }
+    if (lease_file6_) {
+        lease_file6_->setRowHandler(handler);
+    }
+}
+
+void
+Memfile_LeaseMgr::waitForWrites(const LeaseFileWriter::Tickets& writes) {
+    if (writer_) {
+        writer_->wait(writes);
+    }
+}
+
 template<typename LeaseFileType>
 void
 Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
     bool do_lfc = true;
 
+    // Write the rows queued for the current lease file.
+    if (writer_) {
+        writer_->drain();
+    }
+
     // Check the status of the LFC instance.
     // If the finish file exists or the copy of the lease file exists it
     // is an indication that another LFC instance may be in progress or
@@ -3279,7 +3500,7 @@ Memfile_LeaseMgr::extractExtendedInfo4(bool update, bool current) {
             }
             // Work on a copy as the multi-index requires fields used
             // as indexes to be read-only.
-            Lease4Ptr copy(new Lease4(*lease));
+            Lease4Ptr copy = copyLease(*lease);
             extractLease4ExtendedInfo(copy, false);
             if (!copy->relay_id_.empty() || !copy->remote_id_.empty()) {
                 index.replace(lease_it, copy);
@@ -3293,6 +3514,16 @@ Memfile_LeaseMgr::extractExtendedInfo4(bool update, bool current) {
         }
     }
 
+    // Wait for the updated leases posted to the group-commit writer.
+    LeaseFileWriter::Tickets writes;
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        writes.swap(pending_writes_);
+    } else {
+        writes.swap(pending_writes_);
+    }
+    waitForWrites(writes);
+
     LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_EXTRACT_EXTENDED_INFO4)
         .arg(leases)
         .arg(modified)
@@ -13,7 +13,10 @@
 #include <dhcp/hwaddr.h>
 #include <dhcpsrv/csv_lease_file4.h>
 #include <dhcpsrv/csv_lease_file6.h>
+#include <dhcpsrv/lease_file_writer.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/memfile_lease_arena.h>
 #include <dhcpsrv/memfile_lease_limits.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/tracking_lease_mgr.h>
@@ -72,6 +75,29 @@ class LFCSetup;
 /// For example, database access string: "type=memfile persist=true"
 /// enables writes of leases to a disk.
 ///
+/// The "compact=true|false" parameter (false by default) selects the
+/// compact storage mode: the stored leases are copies built by a
+/// @ref MemfileLeaseArena, which allocates them from fixed-size blocks and
+/// shares the equal user contexts, DUIDs and DHCPv6 hardware addresses.
+/// It reduces the memory footprint of large lease databases at the cost
+/// of a copy when a lease is added.
+///
+/// The "write-queue-size=[rows]" parameter (0 by default) enables the
+/// group-commit of the lease file: the rows are written by a
+/// @ref LeaseFileWriter thread, which writes all the queued rows in a
+/// single operation, and the callers wait for their rows before they
+/// return. The "write-max-delay=[microseconds]" parameter (0 by default)
+/// is the time the writer waits for a group of "write-queue-size" rows.
+/// The "write-sync=true|false" parameter (false by default) synchronizes
+/// the lease file to the disk after each write, i.e. after each group
+/// when the writer is enabled.
+///
+/// The "format=csv|binary" parameter (csv by default) selects the format
+/// of the lease file: the binary format is a @ref LeaseJournal4 or
+/// @ref LeaseJournal6 which is faster to write and to load. A primary
+/// lease file in the other format is converted when the leases are
+/// loaded. The other lease files are read in their own format.
+///
 /// The lease file locations can be specified with the "name=[path]"
 /// parameter in the database access string. The [path] is the
 /// absolute path to the file (including file name). If this parameter
@@ -1090,19 +1116,49 @@ private:
     /// an older or newer schema.
     ///
     /// @throw CSVFileError when parsing any of the lease files fails.
-    /// @throw DbOpenError when it is found that the LFC is in progress.
+    /// @throw DbOpenError when it is found that the LFC is in progress
+    /// or when the primary lease file can't be converted to the format.
     template<typename LeaseObjectType, typename LeaseFileType,
              typename StorageType>
     bool loadLeasesFromFiles(const std::string& filename,
                              boost::shared_ptr<LeaseFileType>& lease_file,
                              StorageType& storage);
 
+    /// @brief Replaces the stored leases by their compact copies.
+    ///
+    /// Used in compact mode after the leases have been loaded from files.
+    ///
+    /// @tparam StorageType @c Lease4Storage or @c Lease6Storage.
+    /// @param storage the lease storage.
+    template<typename StorageType>
+    void compactStorage(StorageType& storage);
+
+    /// @brief Returns the copy of a DHCPv4 lease to store.
+    ///
+    /// @param lease the lease.
+    /// @return a compact copy in compact mode, a plain copy otherwise.
+    Lease4Ptr copyLease(const Lease4& lease);
+
+    /// @brief Returns the copy of a DHCPv6 lease to store.
+    ///
+    /// @param lease the lease.
+    /// @return a compact copy in compact mode, a plain copy otherwise.
+    Lease6Ptr copyLease(const Lease6& lease);
+
     /// @brief stores IPv4 leases
     Lease4Storage storage4_;
 
     /// @brief stores IPv6 leases
     Lease6Storage storage6_;
 
+    /// @brief Arena building the stored leases in compact mode.
+    ///
+    /// Null when the compact mode is disabled.
+    boost::scoped_ptr<MemfileLeaseArena> arena_;
+
+    /// @brief Format of the lease file.
+    LeaseFileFormat format_;
+
 protected:
 
     /// @brief stores IPv6 by-relay-id cross-reference table
@@ -1267,6 +1323,25 @@ private:
     /// run_once_now parameter.
     void lfcSetup(bool conversion_needed = false);
 
+    /// @brief Setup the group-commit writer of the lease file.
+    ///
+    /// This method checks the @c write-queue-size, @c write-max-delay
+    /// and @c write-sync parameters. When the queue size is not 0 it
+    /// starts the writer and sets the row handler of the lease file so
+    /// the appended rows are posted to the writer. Otherwise, with
+    /// @c write-sync, the row handler writes and synchronizes each row.
+    ///
+    /// @throw BadValue if a parameter value is invalid.
+    void writerSetup();
+
+    /// @brief Waits until rows posted to the writer have been written.
+    ///
+    /// It must be called without holding the manager mutex.
+    ///
+    /// @param writes the tickets of the rows.
+    /// @throw CSVFileError if the write of one of the rows failed.
+    void waitForWrites(const LeaseFileWriter::Tickets& writes);
+
     /// @brief Performs a lease file cleanup for DHCPv4 or DHCPv6.
     ///
     /// This method performs all the actions necessary to prepare for the
@@ -1295,6 +1370,17 @@ private:
     /// @brief A pointer to the Lease File Cleanup configuration.
     boost::scoped_ptr<LFCSetup> lfc_setup_;
 
+    /// @brief The group-commit writer of the lease file.
+    ///
+    /// Null when the rows are written synchronously.
+    LeaseFileWriterPtr writer_;
+
+    /// @brief Tickets of the rows posted under the manager mutex.
+    ///
+    /// The public methods take them before releasing the mutex and
+    /// wait for them after.
+    LeaseFileWriter::Tickets pending_writes_;
+
     /// @brief Parameters storage
     ///
     /// DatabaseConnection object is used only for storing, accessing and
@@ -1416,10 +1502,14 @@ public:
     /// For v4 relay and remote identifiers are stored inside leases vs.
     /// tables for v6.
     ///
+    /// When the lease file is written by the group-commit writer, it
+    /// returns after the updated leases have been written.
+    ///
     /// @param update Update extended info in database.
     /// @param current specify whether to use current (true) or staging
     /// (false) config.
     /// @return The number of updates in the database or 0.
+    /// @throw CSVFileError if the write of an updated lease failed.
     size_t extractExtendedInfo4(bool update, bool current);
 
     /// @brief Upgrade extended info (v6).
@@ -28,6 +28,9 @@ namespace dhcp {
 /// @brief Tag for indexes by address.
 struct AddressIndexTag { };
 
+/// @brief Tag for hashed indexes by address.
+struct HashedAddressIndexTag { };
+
 /// @brief Tag for indexes by DUID, IAID, lease type tuple.
 struct DuidIaidTypeIndexTag { };
 
@@ -37,9 +40,15 @@ struct ExpirationIndexTag { };
 /// @brief Tag for indexes by HW address, subnet-id tuple.
 struct HWAddressSubnetIdIndexTag { };
 
+/// @brief Tag for indexes by HW address.
+struct HWAddressIndexTag { };
+
 /// @brief Tag for indexes by client-id, subnet-id tuple.
 struct ClientIdSubnetIdIndexTag { };
 
+/// @brief Tag for indexes by client-id.
+struct ClientIdIndexTag { };
+
 /// @brief Tag for indexes by subnet-id (and address for v6).
 struct SubnetIdIndexTag { };
 
@@ -65,14 +74,19 @@ struct RelayIdIndexTag { };
 /// @brief A multi index container holding DHCPv6 leases.
 ///
 /// The leases in the container may be accessed using different indexes:
-/// - using an IPv6 address,
+/// - using an IPv6 address (ordered, for paging),
+/// - using an IPv6 address (hashed, for exact lookups),
 /// - using a composite index: DUID, IAID and lease type.
 /// - using a composite index: boolean flag indicating if the state is
 ///   "expired-reclaimed" and expiration time.
 /// - using subnet ID.
 /// - using hostname.
 ///
-/// Indexes can be accessed using the index number (from 0 to 5) or a
+/// The indexes used only to look up leases matching a whole key are
+/// hashed, the others are ordered because they are used for range
+/// scans (paging, expiration) or partial key lookups.
+///
+/// Indexes can be accessed using the index number (from 0 to 7) or a
 /// name tag. It is recommended to use the tags to access indexes as
 /// they do not depend on the order of indexes in the container.
 typedef boost::multi_index_container<
@@ -87,8 +101,15 @@ typedef boost::multi_index_container<
             boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
         >,
 
+        // This index is used to find leases by IPv6 address: a hash
+        // lookup is cheaper than walking the ordered index above.
+        boost::multi_index::hashed_unique<
+            boost::multi_index::tag<HashedAddressIndexTag>,
+            boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
+        >,
+
         // Specification of the second index starts here.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<DuidIaidTypeIndexTag>,
             // This is a composite index that will be used to search for
             // the lease using three attributes: DUID, IAID and lease type.
@@ -181,17 +202,25 @@ typedef boost::multi_index_container<
 /// @brief A multi index container holding DHCPv4 leases.
 ///
 /// The leases in the container may be accessed using different indexes:
-/// - IPv4 address,
+/// - IPv4 address (ordered, for paging),
+/// - IPv4 address (hashed, for exact lookups),
 /// - composite index: hardware address and subnet id,
+/// - hardware address,
 /// - composite index: client id and subnet id,
+/// - client id,
 /// - using a composite index: boolean flag indicating if the state is
 ///   "expired-reclaimed" and expiration time.
 /// - using subnet id.
 /// - using hostname.
 /// - using remote id.
-/// - using a composite index:
+/// - using a composite index: relay id and address.
+/// - using a composite index: subnet id and pool id.
 ///
-/// Indexes can be accessed using the index number (from 0 to 5) or a
+/// The indexes used only to look up leases matching a whole key are
+/// hashed, the others are ordered because they are used for range
+/// scans (paging, expiration) or partial key lookups.
+///
+/// Indexes can be accessed using the index number (from 0 to 11) or a
 /// name tag. It is recommended to use the tags to access indexes as
 /// they do not depend on the order of indexes in the container.
 typedef boost::multi_index_container<
@@ -209,8 +238,15 @@ typedef boost::multi_index_container<
             boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
         >,
 
+        // This index is used to find leases by IPv4 address: a hash
+        // lookup is cheaper than walking the ordered index above.
+        boost::multi_index::hashed_unique<
+            boost::multi_index::tag<HashedAddressIndexTag>,
+            boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
+        >,
+
         // Specification of the second index starts here.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<HWAddressSubnetIdIndexTag>,
             // This is a composite index that combines two attributes of the
             // Lease4 object: hardware address and subnet id.
@@ -230,8 +266,16 @@ typedef boost::multi_index_container<
             >
         >,
 
+        // This index is used to retrieve the leases of a hardware address
+        // in all subnets.
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<HWAddressIndexTag>,
+            boost::multi_index::const_mem_fun<Lease, const std::vector<uint8_t>&,
+                                              &Lease::getHWAddrVector>
+        >,
+
         // Specification of the third index starts here.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<ClientIdSubnetIdIndexTag>,
             // This is a composite index that uses two values to search for a
             // lease: client id and subnet id.
@@ -246,6 +290,14 @@ typedef boost::multi_index_container<
             >
         >,
 
+        // This index is used to retrieve the leases of a client id
+        // in all subnets.
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<ClientIdIndexTag>,
+            boost::multi_index::const_mem_fun<Lease4, const std::vector<uint8_t>&,
+                                              &Lease4::getClientIdVector>
+        >,
+
         // Specification of the fourth index starts here.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<ExpirationIndexTag>,
@@ -337,6 +389,9 @@ typedef boost::multi_index_container<
 /// @brief DHCPv6 lease storage index by address.
 typedef Lease6Storage::index<AddressIndexTag>::type Lease6StorageAddressIndex;
 
+/// @brief DHCPv6 lease storage hashed index by address.
+typedef Lease6Storage::index<HashedAddressIndexTag>::type Lease6StorageHashedAddressIndex;
+
 /// @brief DHCPv6 lease storage index by DUID, IAID, lease type.
 typedef Lease6Storage::index<DuidIaidTypeIndexTag>::type Lease6StorageDuidIaidTypeIndex;
 
@@ -358,6 +413,9 @@ typedef Lease6Storage::index<HostnameIndexTag>::type Lease6StorageHostnameIndex;
 /// @brief DHCPv4 lease storage index by address.
 typedef Lease4Storage::index<AddressIndexTag>::type Lease4StorageAddressIndex;
 
+/// @brief DHCPv4 lease storage hashed index by address.
+typedef Lease4Storage::index<HashedAddressIndexTag>::type Lease4StorageHashedAddressIndex;
+
 /// @brief DHCPv4 lease storage index by expiration time.
 typedef Lease4Storage::index<ExpirationIndexTag>::type Lease4StorageExpirationIndex;
 
@@ -365,10 +423,16 @@ typedef Lease4Storage::index<ExpirationIndexTag>::type Lease4StorageExpirationIn
 typedef Lease4Storage::index<HWAddressSubnetIdIndexTag>::type
 Lease4StorageHWAddressSubnetIdIndex;
 
+/// @brief DHCPv4 lease storage index by HW address.
+typedef Lease4Storage::index<HWAddressIndexTag>::type Lease4StorageHWAddressIndex;
+
 /// @brief DHCPv4 lease storage index by client-id and subnet-id.
 typedef Lease4Storage::index<ClientIdSubnetIdIndexTag>::type
 Lease4StorageClientIdSubnetIdIndex;
 
+/// @brief DHCPv4 lease storage index by client-id.
+typedef Lease4Storage::index<ClientIdIndexTag>::type Lease4StorageClientIdIndex;
+
 /// @brief DHCPv4 lease storage index subnet-id.
 typedef Lease4Storage::index<SubnetIdIndexTag>::type Lease4StorageSubnetIdIndex;
 
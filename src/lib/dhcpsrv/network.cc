@@ -77,6 +77,9 @@ Network::clientSupported(const isc::dhcp::ClientClasses& classes) const {
 
 void
 Network::allowClientClass(const isc::dhcp::ClientClass& class_name) {
+    // Intern the class name so the client class check is a bitset
+    // intersection.
+    static_cast<void>(ClientClasses::internClass(class_name));
     if (!client_classes_.contains(class_name)) {
         client_classes_.insert(class_name);
     }
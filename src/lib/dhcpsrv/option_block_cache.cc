@@ -0,0 +1,124 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/option_block_cache.h>
+#include <util/buffer.h>
+#include <util/multi_threading_mgr.h>
+
+#include <functional>
+
+using namespace isc::util;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+const size_t OptionBlockCache::MAX_ENTRIES;
+const size_t OptionBlockCache::SHARDS;
+
+OptionBlockCache::OptionBlockCache() : shards_() {
+}
+
+OptionBlockCache::Shard&
+OptionBlockCache::getShard(const string& key) const {
+    return (shards_[hash<string>()(key) % SHARDS]);
+}
+
+string
+OptionBlockCache::makeKey(const CfgOptionList& co_list,
+                          const ClientClasses& classes,
+                          const OptionBuffer& requested) {
+    string key;
+    key.reserve(co_list.size() * sizeof(const CfgOption*) + requested.size() + 64);
+    for (auto const& copts : co_list) {
+        const CfgOption* ptr = copts.get();
+        key.append(reinterpret_cast<const char*>(&ptr), sizeof(ptr));
+    }
+    // The class names can't contain a nul character.
+    key.push_back('\0');
+    for (auto const& cclass : classes) {
+        key.append(cclass);
+        key.push_back('\0');
+    }
+    key.push_back('\0');
+    if (!requested.empty()) {
+        key.append(reinterpret_cast<const char*>(&requested[0]), requested.size());
+    }
+    return (key);
+}
+
+PackedOption
+OptionBlockCache::makePackedOption(const OptionPtr& option) {
+    PackedOption packed;
+    packed.option_ = option;
+    try {
+        OutputBuffer buf(0);
+        option->pack(buf);
+        const uint8_t* data = buf.getData();
+        packed.wire_.assign(data, data + buf.getLength());
+    } catch (...) {
+        packed.wire_.clear();
+    }
+    return (packed);
+}
+
+ConstOptionBlockPtr
+OptionBlockCache::get(const string& key) const {
+    Shard& shard = getShard(key);
+    MultiThreadingLock lock(shard.mutex_);
+    auto& idx = shard.entries_.get<1>();
+    auto it = idx.find(key);
+    if (it == idx.end()) {
+        return (ConstOptionBlockPtr());
+    }
+    shard.entries_.relocate(shard.entries_.begin(), shard.entries_.project<0>(it));
+    return (it->block_);
+}
+
+void
+OptionBlockCache::add(const string& key, const CfgOptionList& co_list,
+                      const ConstOptionBlockPtr& block) {
+    Shard& shard = getShard(key);
+    MultiThreadingLock lock(shard.mutex_);
+    Entry entry;
+    entry.key_ = key;
+    entry.co_list_ = co_list;
+    entry.block_ = block;
+    auto& idx = shard.entries_.get<1>();
+    auto it = idx.find(key);
+    if (it != idx.end()) {
+        static_cast<void>(idx.replace(it, entry));
+        shard.entries_.relocate(shard.entries_.begin(), shard.entries_.project<0>(it));
+        return;
+    }
+    static_cast<void>(shard.entries_.push_front(entry));
+    if (shard.entries_.size() > MAX_ENTRIES / SHARDS) {
+        shard.entries_.pop_back();
+    }
+}
+
+void
+OptionBlockCache::clear() {
+    for (auto& shard : shards_) {
+        MultiThreadingLock lock(shard.mutex_);
+        shard.entries_.clear();
+    }
+}
+
+size_t
+OptionBlockCache::size() const {
+    size_t count = 0;
+    for (auto& shard : shards_) {
+        MultiThreadingLock lock(shard.mutex_);
+        count += shard.entries_.size();
+    }
+    return (count);
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,178 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPTION_BLOCK_CACHE_H
+#define OPTION_BLOCK_CACHE_H
+
+#include <dhcp/classify.h>
+#include <dhcp/option.h>
+#include <dhcpsrv/cfg_option.h>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <array>
+#include <bitset>
+#include <mutex>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Configured options selected for a response.
+///
+/// The options a server returns to a client depend on the configured
+/// options which apply to the client (host, pool, subnet, shared network,
+/// client classes and global options, in this order), on the client classes
+/// and on the options the client requested. The selection does not depend
+/// on anything else so it is the same for all the clients of a subnet
+/// which belong to the same classes and send the same parameter request
+/// list.
+struct OptionBlock {
+    /// @brief Constructor.
+    OptionBlock() : options_(), requested_() {
+    }
+
+    /// @brief The selected options with their on-wire format.
+    ConstPackedOptionCollectionPtr options_;
+
+    /// @brief The codes of the requested options which are not cancelled.
+    std::bitset<256> requested_;
+};
+
+/// @brief Pointer to a constant option block.
+typedef boost::shared_ptr<const OptionBlock> ConstOptionBlockPtr;
+
+/// @brief Cache of the options selected for the responses.
+///
+/// The entries are keyed by the list of configured options, the client
+/// classes and the parameter request list (see @ref makeKey). An entry
+/// holds the configured options of its key so they can't be destroyed,
+/// and their addresses reused, while the entry exists.
+///
+/// The entries are spread by key over shards, each with its own mutex and
+/// evicting its least recently used entry when it is full, so the threads
+/// processing packets rarely wait for each other and a full cache keeps
+/// the common keys.
+///
+/// The cache is a part of the server configuration: a new configuration
+/// has a new empty cache, and the cache of the current configuration is
+/// cleared when the configuration is updated in place (e.g. by the
+/// configuration backend).
+class OptionBlockCache : public boost::noncopyable {
+public:
+
+    /// @brief Maximum number of entries.
+    static const size_t MAX_ENTRIES = 4096;
+
+    /// @brief Number of shards.
+    ///
+    /// A shard holds at most @c MAX_ENTRIES / @c SHARDS entries.
+    static const size_t SHARDS = 16;
+
+    /// @brief Constructor.
+    OptionBlockCache();
+
+    /// @brief Returns the key of the options selected for a response.
+    ///
+    /// @param co_list The list of configured options.
+    /// @param classes The client classes.
+    /// @param requested The requested option codes.
+    /// @return the key.
+    static std::string makeKey(const CfgOptionList& co_list,
+                               const ClientClasses& classes,
+                               const OptionBuffer& requested);
+
+    /// @brief Returns an option with its on-wire format.
+    ///
+    /// The on-wire format is left empty when the option can't be packed:
+    /// the error is then reported when the response is packed.
+    ///
+    /// @param option The option.
+    /// @return the option with its on-wire format.
+    static PackedOption makePackedOption(const OptionPtr& option);
+
+    /// @brief Returns a cached option block.
+    ///
+    /// The entry becomes the most recently used one of its shard.
+    ///
+    /// @param key The key of the block.
+    /// @return the option block or null when the key is not in the cache.
+    ConstOptionBlockPtr get(const std::string& key) const;
+
+    /// @brief Caches an option block.
+    ///
+    /// The least recently used entry of the shard is removed when the
+    /// shard is full.
+    ///
+    /// @param key The key of the block.
+    /// @param co_list The list of configured options used in the key.
+    /// @param block The option block.
+    void add(const std::string& key, const CfgOptionList& co_list,
+             const ConstOptionBlockPtr& block);
+
+    /// @brief Removes all the entries.
+    void clear();
+
+    /// @brief Returns the number of entries.
+    ///
+    /// @return the number of entries.
+    size_t size() const;
+
+private:
+
+    /// @brief A cache entry.
+    struct Entry {
+        /// @brief The key.
+        std::string key_;
+
+        /// @brief The configured options of the key.
+        CfgOptionList co_list_;
+
+        /// @brief The option block.
+        ConstOptionBlockPtr block_;
+    };
+
+    /// @brief A container of entries, from the most recently used to the
+    /// least recently used one, and by key.
+    typedef boost::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::member<Entry, std::string, &Entry::key_>
+            >
+        >
+    > EntryContainer;
+
+    /// @brief A shard of the cache.
+    struct Shard {
+        /// @brief The entries.
+        EntryContainer entries_;
+
+        /// @brief Mutex protecting the entries.
+        std::mutex mutex_;
+    };
+
+    /// @brief Returns the shard of a key.
+    ///
+    /// @param key The key.
+    /// @return the shard.
+    Shard& getShard(const std::string& key) const;
+
+    /// @brief The shards.
+    mutable std::array<Shard, SHARDS> shards_;
+};
+
+/// @brief Pointer to an option block cache.
+typedef boost::shared_ptr<OptionBlockCache> OptionBlockCachePtr;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // OPTION_BLOCK_CACHE_H
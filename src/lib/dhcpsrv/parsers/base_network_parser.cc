@@ -214,9 +214,9 @@ BaseNetworkParser::parseAllocatorParams(const data::ConstElementPtr& network_dat
     if (network_data->contains("allocator")) {
         auto allocator_type = getString(network_data, "allocator");
         if ((allocator_type != "iterative") && (allocator_type != "random") &&
-            (allocator_type != "flq")) {
+            (allocator_type != "flq") && (allocator_type != "bitmap")) {
             // Unsupported allocator type used.
-            isc_throw(DhcpConfigError, "supported allocators are: iterative, random and flq");
+            isc_throw(DhcpConfigError, "supported allocators are: iterative, random, flq and bitmap");
         }
         network->setAllocatorType(allocator_type);
     }
@@ -228,9 +228,9 @@ BaseNetworkParser::parsePdAllocatorParams(const data::ConstElementPtr& network_d
     if (network_data->contains("pd-allocator")) {
         auto allocator_type = getString(network_data, "pd-allocator");
         if ((allocator_type != "iterative") && (allocator_type != "random") &&
-            (allocator_type != "flq")) {
+            (allocator_type != "flq") && (allocator_type != "bitmap")) {
             // Unsupported allocator type used.
-            isc_throw(DhcpConfigError, "supported allocators are: iterative, random and flq");
+            isc_throw(DhcpConfigError, "supported allocators are: iterative, random, flq and bitmap");
         }
         network->setPdAllocatorType(allocator_type);
     }
@@ -11,6 +11,7 @@
 #include <dhcpsrv/parsers/dhcp_queue_control_parser.h>
 #include <util/multi_threading_mgr.h>
 #include <string>
+#include <vector>
 #include <sys/types.h>
 
 using namespace isc::data;
@@ -43,16 +44,66 @@ DHCPQueueControlParser::parse(const ConstElementPtr& control_elem,
         }
     }
 
+    // receiver-per-socket is optional.
+    bool receiver_per_socket = false;
+    ConstElementPtr per_socket = control_elem->get("receiver-per-socket");
+    if (per_socket) {
+        if (per_socket->getType() != Element::boolean) {
+            isc_throw(DhcpConfigError, "receiver-per-socket must be a boolean");
+        }
+        receiver_per_socket = per_socket->boolValue();
+    }
+
+    // packet-mmap is optional.
+    ConstElementPtr packet_mmap = control_elem->get("packet-mmap");
+    if (packet_mmap && (packet_mmap->getType() != Element::boolean)) {
+        isc_throw(DhcpConfigError, "packet-mmap must be a boolean");
+    }
+
+    // lazy-option-unpack is optional.
+    ConstElementPtr lazy_unpack = control_elem->get("lazy-option-unpack");
+    if (lazy_unpack && (lazy_unpack->getType() != Element::boolean)) {
+        isc_throw(DhcpConfigError, "lazy-option-unpack must be a boolean");
+    }
+
+    // receive-batch-size and send-batch-size are optional.
+    std::vector<std::string> batched;
+    for (auto const& name : { "receive-batch-size", "send-batch-size" }) {
+        ConstElementPtr batch_size = control_elem->get(name);
+        if (batch_size) {
+            if ((batch_size->getType() != Element::integer) ||
+                (batch_size->intValue() <= 0)) {
+                isc_throw(DhcpConfigError, name << " must be a positive integer");
+            }
+            if (batch_size->intValue() > 1) {
+                batched.push_back(name);
+            }
+        }
+    }
+
     // Return a copy of it.
     ElementPtr result = data::copy(control_elem);
 
-    // Currently not compatible with multi-threading.
-    if (multi_threading_enabled) {
+    // The single receiver thread is not compatible with multi-threading.
+    // Per-socket receivers feed the thread pool so they are kept.
+    if (multi_threading_enabled && !receiver_per_socket) {
         // Silently disable it.
         result->set("enable-queue", Element::create(false));
         LOG_WARN(dhcpsrv_logger, DHCPSRV_MT_DISABLED_QUEUE_CONTROL);
     }
 
+    // The batches are only used with the queue: IfaceMgr ignores the
+    // batch sizes when it is disabled.
+    if (!getBoolean(result, "enable-queue")) {
+        for (auto const& name : batched) {
+            LOG_WARN(dhcpsrv_logger, DHCPSRV_QUEUE_CONTROL_BATCH_IGNORED)
+                .arg(name)
+                .arg(enable_queue ?
+                     "multi-threading requires receiver-per-socket" :
+                     "the queue is disabled");
+        }
+    }
+
     return (result);
 }
 
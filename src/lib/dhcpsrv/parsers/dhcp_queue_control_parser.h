@@ -22,8 +22,16 @@ namespace dhcp {
 /// 'dhcp-queue-control' is mostly treated as a map of arbitrary values.
 /// There is only mandatory value, 'enable-queue', which enables/disables
 /// DHCP packet queueing.  If this value is true, then the content must
-/// also include a value for 'queue-type'.  Beyond these values, the
-/// map may contain any combination of valid JSON elements.
+/// also include a value for 'queue-type'.  The optional boolean
+/// 'receiver-per-socket' selects one receiver thread and one queue per
+/// socket.  The optional 'receive-batch-size' and 'send-batch-size' must
+/// be positive integers; a warning is logged when they are greater than 1
+/// but the queue is disabled, either explicitly or because multi-threading
+/// is enabled without 'receiver-per-socket', as they have no effect then.
+/// The optional booleans 'packet-mmap' and 'lazy-option-unpack' apply
+/// even when the queue is disabled.
+/// Beyond these values, the map may contain any combination of valid JSON
+/// elements.
 ///
 /// Unlike most other parsers, this parser primarily serves to validate
 /// the aforementioned rules, and rather than instantiate an object as
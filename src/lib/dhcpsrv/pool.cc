@@ -36,6 +36,9 @@ Pool::clientSupported(const ClientClasses& classes) const {
 
 void 
 Pool::allowClientClass(const ClientClass& class_name) {
+    // Intern the class name so the client class check is a bitset
+    // intersection.
+    static_cast<void>(ClientClasses::internClass(class_name));
     if (!client_classes_.contains(class_name)) {
         client_classes_.insert(class_name);
     }
@@ -57,6 +57,7 @@ SrvConfig::SrvConfig()
       decline_timer_(0), echo_v4_client_id_(true), dhcp4o6_port_(0),
       d2_client_config_(new D2ClientConfig()),
       configured_globals_(new CfgGlobals()), cfg_consist_(new CfgConsistency()),
+      option_block_cache_(new OptionBlockCache()),
       lenient_option_parsing_(false), ignore_dhcp_server_identifier_(false),
       ignore_rai_link_selection_(false), exclude_first_last_24_(false),
       reservations_lookup_first_(false) {
@@ -77,6 +78,7 @@ SrvConfig::SrvConfig(const uint32_t sequence)
       decline_timer_(0), echo_v4_client_id_(true), dhcp4o6_port_(0),
       d2_client_config_(new D2ClientConfig()),
       configured_globals_(new CfgGlobals()), cfg_consist_(new CfgConsistency()),
+      option_block_cache_(new OptionBlockCache()),
       lenient_option_parsing_(false), ignore_dhcp_server_identifier_(false),
       ignore_rai_link_selection_(false), exclude_first_last_24_(false),
       reservations_lookup_first_(false) {
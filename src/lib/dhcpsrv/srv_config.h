@@ -25,6 +25,7 @@
 #include <dhcpsrv/cfg_consistency.h>
 #include <dhcpsrv/client_class_def.h>
 #include <dhcpsrv/d2_client_cfg.h>
+#include <dhcpsrv/option_block_cache.h>
 #include <process/config_base.h>
 #include <hooks/hooks_config.h>
 #include <cc/data.h>
@@ -513,6 +514,18 @@ public:
         return (cfg_consist_);
     }
 
+    /// @brief Returns pointer to the cache of the options selected for
+    /// the responses.
+    ///
+    /// The cache is not a part of the configuration: it is not copied,
+    /// merged or compared with the configuration, and it must be cleared
+    /// when the configuration is modified in place.
+    ///
+    /// @return Pointer to the option block cache.
+    OptionBlockCachePtr getOptionBlockCache() const {
+        return (option_block_cache_);
+    }
+
     //@}
 
     /// @brief Returns non-const reference to an array that stores
@@ -1233,6 +1246,9 @@ private:
     /// @brief Pointer to the configuration consistency settings
     CfgConsistencyPtr cfg_consist_;
 
+    /// @brief Pointer to the cache of the options selected for the responses
+    OptionBlockCachePtr option_block_cache_;
+
     /// @name Compatibility flags
     ///
     //@{
@@ -10,6 +10,8 @@
 #include <asiolink/addr_utilities.h>
 #include <dhcp/option_space.h>
 #include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/bitmap_allocator.h>
 #include <dhcpsrv/flq_allocation_state.h>
 #include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/iterative_allocation_state.h>
@@ -440,6 +442,28 @@ Subnet::initAllocatorsAfterConfigure() {
     }
 }
 
+std::vector<AllocatorPtr>
+Subnet::getAllocators() const {
+    std::vector<AllocatorPtr> allocators;
+    for (auto const& allocator : allocators_) {
+        allocators.push_back(allocator.second);
+    }
+    return (allocators);
+}
+
+void
+Subnet::reuseAllocationStates(const Subnet& previous) {
+    for (auto const& allocator : allocators_) {
+        auto previous_allocator = previous.allocators_.find(allocator.first);
+        if ((previous_allocator == previous.allocators_.end()) ||
+            !previous_allocator->second || !allocator.second ||
+            (previous_allocator->second->getType() != allocator.second->getType())) {
+            continue;
+        }
+        allocator.second->reuseAllocationStates(*previous_allocator->second);
+    }
+}
+
 const PoolPtr Subnet::getPool(Lease::Type type,
                               const ClientClasses& client_classes,
                               const isc::asiolink::IOAddress& hint) const {
@@ -777,6 +801,16 @@ Subnet4::createAllocators() {
             pool->setAllocationState(PoolFreeLeaseQueueAllocationState::create(pool));
         }
 
+    } else if (allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_V4,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_V4, shared_from_this()));
+        setAllocationState(Lease::TYPE_V4, SubnetAllocationStatePtr());
+
+        for (auto const& pool : pools_) {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
+        }
+
     } else {
         setAllocator(Lease::TYPE_V4,
                      boost::make_shared<IterativeAllocator>
@@ -843,6 +877,16 @@ Subnet6::createAllocators() {
     } else if (allocator_type == "flq") {
         isc_throw(BadValue, "Free Lease Queue allocator is not supported for IPv6 address pools");
 
+    } else if (allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_NA,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_NA, shared_from_this()));
+        setAllocator(Lease::TYPE_TA,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_TA, shared_from_this()));
+        setAllocationState(Lease::TYPE_NA, SubnetAllocationStatePtr());
+        setAllocationState(Lease::TYPE_TA, SubnetAllocationStatePtr());
+
     } else {
         setAllocator(Lease::TYPE_NA,
                      boost::make_shared<IterativeAllocator>
@@ -868,6 +912,12 @@ Subnet6::createAllocators() {
                      (Lease::TYPE_PD, shared_from_this()));
         setAllocationState(Lease::TYPE_PD, SubnetAllocationStatePtr());
 
+    } else if (pd_allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_PD,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_PD, shared_from_this()));
+        setAllocationState(Lease::TYPE_PD, SubnetAllocationStatePtr());
+
     } else {
         setAllocator(Lease::TYPE_PD,
                      boost::make_shared<IterativeAllocator>
@@ -878,6 +928,8 @@ Subnet6::createAllocators() {
     for (auto const& pool : pools_) {
         if (allocator_type == "random") {
             pool->setAllocationState(PoolRandomAllocationState::create(pool));
+        } else if (allocator_type == "bitmap") {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
         } else {
             pool->setAllocationState(PoolIterativeAllocationState::create(pool));
         }
@@ -886,6 +938,8 @@ Subnet6::createAllocators() {
     for (auto const& pool : pools_ta_) {
         if (allocator_type == "random") {
             pool->setAllocationState(PoolRandomAllocationState::create(pool));
+        } else if (allocator_type == "bitmap") {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
         } else {
             pool->setAllocationState(PoolIterativeAllocationState::create(pool));
         }
@@ -896,6 +950,8 @@ Subnet6::createAllocators() {
             pool->setAllocationState(PoolRandomAllocationState::create(pool));
         } else if (pd_allocator_type == "flq") {
             pool->setAllocationState(PoolFreeLeaseQueueAllocationState::create(pool));
+        } else if (pd_allocator_type == "bitmap") {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
         } else {
             pool->setAllocationState(PoolIterativeAllocationState::create(pool));
         }
@@ -322,6 +322,23 @@ public:
     /// @brief Calls @c initAfterConfigure for each allocator.
     void initAllocatorsAfterConfigure();
 
+    /// @brief Returns the allocators of the subnet.
+    ///
+    /// @return the allocators of the subnet, one per lease type.
+    std::vector<AllocatorPtr> getAllocators() const;
+
+    /// @brief Reuses the allocation states of the subnet in the previous
+    /// configuration.
+    ///
+    /// For each lease type the @c Allocator::reuseAllocationStates function
+    /// of this subnet's allocator is called with the allocator of the
+    /// previous subnet when both allocators have the same type. It must be
+    /// called before the allocators are initialized.
+    ///
+    /// @param previous the subnet with the same subnet identifier in the
+    /// previous configuration.
+    void reuseAllocationStates(const Subnet& previous);
+
 protected:
 
     /// @brief Protected constructor.
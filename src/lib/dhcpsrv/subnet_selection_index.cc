@@ -0,0 +1,53 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/subnet_selection_index.h>
+
+using namespace isc::asiolink;
+
+namespace {
+
+/// @brief Masks a 64 bit part of an address.
+///
+/// @param value the part of the address.
+/// @param prefix_len the number of prefix bits in the part.
+/// @return the masked part.
+uint64_t
+mask64(uint64_t value, int prefix_len) {
+    if (prefix_len <= 0) {
+        return (0);
+    } else if (prefix_len >= 64) {
+        return (value);
+    }
+    return (value & ~((static_cast<uint64_t>(1) << (64 - prefix_len)) - 1));
+}
+
+}  // namespace
+
+namespace isc {
+namespace dhcp {
+
+SubnetSelectionKey::SubnetSelectionKey(const IOAddress& address,
+                                       uint8_t prefix_len)
+    : v6_(address.isV6()), high_(0), low_(0) {
+    if (!v6_) {
+        low_ = mask64(static_cast<uint64_t>(address.toUint32()) << 32,
+                      prefix_len) >> 32;
+        return;
+    }
+    auto const& bytes = address.toBytes();
+    for (size_t i = 0; i < 8; ++i) {
+        high_ = (high_ << 8) | bytes[i];
+        low_ = (low_ << 8) | bytes[i + 8];
+    }
+    high_ = mask64(high_, prefix_len);
+    low_ = mask64(low_, static_cast<int>(prefix_len) - 64);
+}
+
+}  // namespace dhcp
+}  // namespace isc
@@ -0,0 +1,355 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SUBNET_SELECTION_INDEX_H
+#define SUBNET_SELECTION_INDEX_H
+
+#include <asiolink/io_address.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Key of a masked address in the prefix tables of the
+/// @c SubnetSelectionIndex.
+///
+/// IPv4 addresses are held in the low part.
+struct SubnetSelectionKey {
+    /// @brief Constructor.
+    ///
+    /// @param address the address.
+    /// @param prefix_len the prefix length used to mask the address.
+    SubnetSelectionKey(const asiolink::IOAddress& address, uint8_t prefix_len);
+
+    /// @brief Equality operator.
+    bool operator==(const SubnetSelectionKey& other) const {
+        return ((v6_ == other.v6_) && (high_ == other.high_) &&
+                (low_ == other.low_));
+    }
+
+    /// @brief IPv6 flag.
+    bool v6_;
+
+    /// @brief High 64 bits of an IPv6 address.
+    uint64_t high_;
+
+    /// @brief Low 64 bits of an IPv6 address or the IPv4 address.
+    uint64_t low_;
+};
+
+/// @brief Hash of a @c SubnetSelectionKey.
+struct SubnetSelectionKeyHash {
+    /// @brief Returns the hash of a key.
+    ///
+    /// @param key the key.
+    size_t operator()(const SubnetSelectionKey& key) const {
+        size_t seed = key.v6_ ? 1 : 0;
+        boost::hash_combine(seed, key.high_);
+        boost::hash_combine(seed, key.low_);
+        return (seed);
+    }
+};
+
+/// @brief Index used to select a subnet without iterating over all the
+/// configured subnets.
+///
+/// The index maps the prefixes, the relay addresses, the interface names
+/// and the interface identifiers to the subnets. Each subnet is added
+/// with its position in the configuration and the selection returns the
+/// matching subnet with the lowest position: it is the subnet the
+/// iteration over the configured subnets would have returned.
+///
+/// The prefixes are held in one hash table per prefix length so an
+/// address is looked up in at most one table per configured prefix
+/// length, i.e. in O(prefix length).
+///
+/// The index is immutable once built: it must be rebuilt when the
+/// subnets or their relay, interface or shared network parameters change.
+///
+/// @tparam SubnetPtrType @c Subnet4Ptr or @c Subnet6Ptr.
+template<typename SubnetPtrType>
+class SubnetSelectionIndex {
+public:
+
+    /// @brief Subnet with its position in the configuration.
+    struct Entry {
+        /// @brief Position of the subnet.
+        size_t position_;
+
+        /// @brief The subnet.
+        SubnetPtrType subnet_;
+    };
+
+    /// @brief Entries in ascending position order.
+    typedef std::vector<Entry> Entries;
+
+    /// @brief Constructor.
+    SubnetSelectionIndex() : prefixes_(), relays_(), ifaces_(), keys_() {
+    }
+
+    /// @brief Adds the prefix of a subnet.
+    ///
+    /// The subnets must be added in ascending position order.
+    ///
+    /// @param prefix the prefix.
+    /// @param prefix_len the prefix length.
+    /// @param position the position of the subnet.
+    /// @param subnet the subnet.
+    void addPrefix(const asiolink::IOAddress& prefix, uint8_t prefix_len,
+                   size_t position, const SubnetPtrType& subnet) {
+        auto table = prefixes_.begin();
+        // The tables are in descending prefix length order.
+        for (; table != prefixes_.end(); ++table) {
+            if (table->prefix_len_ <= prefix_len) {
+                break;
+            }
+        }
+        if ((table == prefixes_.end()) || (table->prefix_len_ != prefix_len)) {
+            PrefixTable new_table;
+            new_table.prefix_len_ = prefix_len;
+            table = prefixes_.insert(table, new_table);
+        }
+        table->entries_[SubnetSelectionKey(prefix, prefix_len)].push_back(
+            Entry { position, subnet });
+    }
+
+    /// @brief Adds a relay address of a subnet.
+    ///
+    /// @param address the relay address.
+    /// @param position the position of the subnet.
+    /// @param subnet the subnet.
+    void addRelay(const asiolink::IOAddress& address, size_t position,
+                  const SubnetPtrType& subnet) {
+        relays_[address].push_back(Entry { position, subnet });
+    }
+
+    /// @brief Adds an interface name of a subnet.
+    ///
+    /// @param iface the interface name.
+    /// @param position the position of the subnet.
+    /// @param subnet the subnet.
+    void addIface(const std::string& iface, size_t position,
+                  const SubnetPtrType& subnet) {
+        ifaces_[iface].push_back(Entry { position, subnet });
+    }
+
+    /// @brief Adds an opaque key, e.g. an interface identifier, of
+    /// a subnet.
+    ///
+    /// @param key the key.
+    /// @param position the position of the subnet.
+    /// @param subnet the subnet.
+    void addKey(const std::vector<uint8_t>& key, size_t position,
+                const SubnetPtrType& subnet) {
+        keys_[std::string(key.begin(), key.end())].push_back(
+            Entry { position, subnet });
+    }
+
+    /// @brief Finds the first subnet with a prefix including an address.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param address the address.
+    /// @param predicate the predicate the subnet must satisfy, e.g. the
+    /// client class check.
+    /// @return the matching entry with the lowest position or an entry
+    /// with a null subnet and the largest position.
+    template<typename Predicate>
+    Entry findByPrefix(const asiolink::IOAddress& address,
+                       Predicate predicate) const {
+        Entry best = notFound();
+        for (auto const& table : prefixes_) {
+            auto entries = table.entries_.find(SubnetSelectionKey(address,
+                                                                  table.prefix_len_));
+            if (entries == table.entries_.end()) {
+                continue;
+            }
+            for (auto const& entry : entries->second) {
+                if (entry.position_ >= best.position_) {
+                    break;
+                }
+                if (predicate(entry.subnet_)) {
+                    best = entry;
+                    break;
+                }
+            }
+        }
+        return (best);
+    }
+
+    /// @brief Selects the first subnet with a prefix including an address.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param address the address.
+    /// @param predicate the predicate the subnet must satisfy, e.g. the
+    /// client class check.
+    /// @return the matching subnet with the lowest position or null.
+    template<typename Predicate>
+    SubnetPtrType selectByPrefix(const asiolink::IOAddress& address,
+                                 Predicate predicate) const {
+        return (findByPrefix(address, predicate).subnet_);
+    }
+
+    /// @brief Returns all the subnets with a prefix including an address.
+    ///
+    /// @param address the address.
+    /// @return the matching subnets in ascending position order.
+    Entries getByPrefix(const asiolink::IOAddress& address) const {
+        Entries result;
+        for (auto const& table : prefixes_) {
+            auto entries = table.entries_.find(SubnetSelectionKey(address,
+                                                                  table.prefix_len_));
+            if (entries != table.entries_.end()) {
+                result.insert(result.end(), entries->second.begin(),
+                              entries->second.end());
+            }
+        }
+        std::sort(result.begin(), result.end(),
+                  [](const Entry& a, const Entry& b) {
+            return (a.position_ < b.position_);
+        });
+        return (result);
+    }
+
+    /// @brief Selects the first subnet with a relay address.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param address the relay address.
+    /// @param predicate the predicate the subnet must satisfy.
+    /// @return the matching subnet with the lowest position or null.
+    template<typename Predicate>
+    SubnetPtrType selectByRelay(const asiolink::IOAddress& address,
+                                Predicate predicate) const {
+        auto entries = relays_.find(address);
+        if (entries == relays_.end()) {
+            return (SubnetPtrType());
+        }
+        return (findFirst(entries->second, predicate).subnet_);
+    }
+
+    /// @brief Finds the first subnet with an interface name.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param iface the interface name.
+    /// @param predicate the predicate the subnet must satisfy.
+    /// @return the matching entry with the lowest position or an entry
+    /// with a null subnet and the largest position.
+    template<typename Predicate>
+    Entry findByIface(const std::string& iface, Predicate predicate) const {
+        auto entries = ifaces_.find(iface);
+        if (entries == ifaces_.end()) {
+            return (notFound());
+        }
+        return (findFirst(entries->second, predicate));
+    }
+
+    /// @brief Selects the first subnet with an interface name.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param iface the interface name.
+    /// @param predicate the predicate the subnet must satisfy.
+    /// @return the matching subnet with the lowest position or null.
+    template<typename Predicate>
+    SubnetPtrType selectByIface(const std::string& iface,
+                                Predicate predicate) const {
+        return (findByIface(iface, predicate).subnet_);
+    }
+
+    /// @brief Finds the first subnet with an opaque key.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param key the key.
+    /// @param predicate the predicate the subnet must satisfy.
+    /// @return the matching entry with the lowest position or an entry
+    /// with a null subnet and the largest position.
+    template<typename Predicate>
+    Entry findByKey(const std::vector<uint8_t>& key,
+                    Predicate predicate) const {
+        auto entries = keys_.find(std::string(key.begin(), key.end()));
+        if (entries == keys_.end()) {
+            return (notFound());
+        }
+        return (findFirst(entries->second, predicate));
+    }
+
+    /// @brief Selects the first subnet with an opaque key.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param key the key.
+    /// @param predicate the predicate the subnet must satisfy.
+    /// @return the matching subnet with the lowest position or null.
+    template<typename Predicate>
+    SubnetPtrType selectByKey(const std::vector<uint8_t>& key,
+                              Predicate predicate) const {
+        return (findByKey(key, predicate).subnet_);
+    }
+
+    /// @brief Returns the number of prefix tables, i.e. of distinct
+    /// prefix lengths.
+    size_t getPrefixTableCount() const {
+        return (prefixes_.size());
+    }
+
+private:
+
+    /// @brief Returns the entry of a failed search.
+    ///
+    /// @return an entry with a null subnet and the largest position.
+    static Entry notFound() {
+        return (Entry { std::numeric_limits<size_t>::max(), SubnetPtrType() });
+    }
+
+    /// @brief Finds the first entry satisfying a predicate.
+    ///
+    /// @tparam Predicate type of the predicate.
+    /// @param entries the entries in ascending position order.
+    /// @param predicate the predicate.
+    /// @return the first matching entry or the entry of a failed search.
+    template<typename Predicate>
+    static Entry findFirst(const Entries& entries, Predicate predicate) {
+        for (auto const& entry : entries) {
+            if (predicate(entry.subnet_)) {
+                return (entry);
+            }
+        }
+        return (notFound());
+    }
+
+    /// @brief Subnets with a given prefix length.
+    struct PrefixTable {
+        /// @brief The prefix length.
+        uint8_t prefix_len_;
+
+        /// @brief The subnets by masked prefix.
+        std::unordered_map<SubnetSelectionKey, Entries,
+                           SubnetSelectionKeyHash> entries_;
+    };
+
+    /// @brief The prefix tables in descending prefix length order.
+    std::vector<PrefixTable> prefixes_;
+
+    /// @brief The subnets by relay address.
+    std::unordered_map<asiolink::IOAddress, Entries,
+                       boost::hash<asiolink::IOAddress> > relays_;
+
+    /// @brief The subnets by interface name.
+    std::unordered_map<std::string, Entries> ifaces_;
+
+    /// @brief The subnets by opaque key.
+    std::unordered_map<std::string, Entries> keys_;
+};
+
+}  // namespace dhcp
+}  // namespace isc
+
+#endif // SUBNET_SELECTION_INDEX_H
@@ -0,0 +1,175 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/pool.h>
+#include <boost/make_shared.hpp>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+// Test creating a new bitmap allocation state for an IPv4 address pool.
+TEST(PoolBitmapAllocationStateTest, createV4) {
+    auto pool = boost::make_shared<Pool4>(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    // A new state has no free leases until they are populated.
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_EQ(0, state->getFreeLeaseCount());
+    EXPECT_TRUE(state->offerFreeLease().isV4Zero());
+
+    state->setAllFree();
+    EXPECT_FALSE(state->exhausted());
+    EXPECT_EQ(10, state->getFreeLeaseCount());
+}
+
+// Test adding and deleting free IPv4 leases.
+TEST(PoolBitmapAllocationStateTest, addDeleteFreeLeaseV4) {
+    auto pool = boost::make_shared<Pool4>(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+
+    // Add the first free lease. It is always offered.
+    state->addFreeLease(IOAddress("192.0.2.5"));
+    EXPECT_FALSE(state->exhausted());
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+
+    // Adding it again does not change anything.
+    state->addFreeLease(IOAddress("192.0.2.5"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+
+    // Addresses outside the pool are ignored.
+    state->addFreeLease(IOAddress("192.0.2.11"));
+    state->addFreeLease(IOAddress("192.0.2.0"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+
+    // The free leases are offered in the address order, wrapping
+    // around at the end of the pool.
+    state->addFreeLease(IOAddress("192.0.2.1"));
+    state->addFreeLease(IOAddress("192.0.2.10"));
+    EXPECT_EQ(3, state->getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.10", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.1", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+
+    // Deleting a non free lease does not change anything.
+    state->deleteFreeLease(IOAddress("192.0.2.2"));
+    EXPECT_EQ(3, state->getFreeLeaseCount());
+
+    state->deleteFreeLease(IOAddress("192.0.2.10"));
+    state->deleteFreeLease(IOAddress("192.0.2.1"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+
+    // Delete the remaining lease. The pool is now exhausted.
+    state->deleteFreeLease(IOAddress("192.0.2.5"));
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_TRUE(state->offerFreeLease().isV4Zero());
+}
+
+// Test the bitmap against a set of free leases in a pool spanning
+// several bitmap levels.
+TEST(PoolBitmapAllocationStateTest, randomV4) {
+    // A pool of 300000 addresses has four levels.
+    auto pool = boost::make_shared<Pool4>(IOAddress("10.0.0.0"),
+                                          IOAddress(0x0A000000 + 299999));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+
+    std::set<uint32_t> free_leases;
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<uint32_t> dist(0, 299999);
+    for (auto i = 0; i < 20000; ++i) {
+        uint32_t address = 0x0A000000 + dist(generator);
+        if (i % 3) {
+            state->addFreeLease(IOAddress(address));
+            free_leases.insert(address);
+        } else {
+            state->deleteFreeLease(IOAddress(address));
+            free_leases.erase(address);
+        }
+    }
+    ASSERT_EQ(free_leases.size(), state->getFreeLeaseCount());
+
+    // The offers walk the free leases in order.
+    for (auto const& address : free_leases) {
+        ASSERT_EQ(address, state->offerFreeLease().toUint32());
+    }
+    EXPECT_EQ(*free_leases.begin(), state->offerFreeLease().toUint32());
+
+    // Delete all the free leases.
+    for (auto const& address : free_leases) {
+        state->deleteFreeLease(IOAddress(address));
+    }
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_TRUE(state->offerFreeLease().isV4Zero());
+}
+
+// Test the IPv6 address pools.
+TEST(PoolBitmapAllocationStateTest, addDeleteFreeLeaseNA) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"),
+                                          IOAddress("2001:db8:1::ff:ffff"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_TRUE(state->offerFreeLease().isV6Zero());
+
+    state->setAllFree();
+    EXPECT_EQ(0x1000000, state->getFreeLeaseCount());
+    EXPECT_EQ("2001:db8:1::", state->offerFreeLease().toText());
+
+    state->deleteFreeLease(IOAddress("2001:db8:1::1"));
+    state->deleteFreeLease(IOAddress("2001:db8:1::2"));
+    // Addresses outside the pool are ignored.
+    state->deleteFreeLease(IOAddress("2001:db8:2::"));
+    state->deleteFreeLease(IOAddress("2001:db8::1"));
+    EXPECT_EQ(0xfffffe, state->getFreeLeaseCount());
+    EXPECT_EQ("2001:db8:1::3", state->offerFreeLease().toText());
+}
+
+// Test the prefix delegation pools.
+TEST(PoolBitmapAllocationStateTest, addDeleteFreeLeasePD) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 112, 120);
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+
+    state->addFreeLease(IOAddress("3000::100"));
+    state->addFreeLease(IOAddress("3000::ff00"));
+    // Not a delegated prefix of the pool.
+    state->addFreeLease(IOAddress("3000::101"));
+    EXPECT_EQ(2, state->getFreeLeaseCount());
+    EXPECT_EQ("3000::100", state->offerFreeLease().toText());
+    EXPECT_EQ("3000::ff00", state->offerFreeLease().toText());
+
+    state->deleteFreeLease(IOAddress("3000::100"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+    EXPECT_EQ("3000::ff00", state->offerFreeLease().toText());
+}
+
+// Test that too large pools are rejected.
+TEST(PoolBitmapAllocationStateTest, tooLarge) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"), 64);
+    EXPECT_THROW(PoolBitmapAllocationState::create(pool), BadValue);
+
+    pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 24, 64);
+    EXPECT_THROW(PoolBitmapAllocationState::create(pool), BadValue);
+
+    pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 40, 64);
+    EXPECT_NO_THROW(PoolBitmapAllocationState::create(pool));
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,427 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/testutils/alloc_engine_utils.h>
+#include <boost/make_shared.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc::asiolink;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+namespace test {
+
+/// @brief Test fixture class for the DHCPv4 bitmap allocator.
+class BitmapAllocatorTest4 : public AllocEngine4Test {
+public:
+
+    /// @brief Creates a DHCPv4 lease for an address and MAC address.
+    ///
+    /// @param address Lease address.
+    /// @param hw_address_seed a seed from which the hardware address is generated.
+    /// @return Created lease pointer.
+    Lease4Ptr
+    createLease4(const IOAddress& address, uint64_t hw_address_seed) const {
+        vector<uint8_t> hw_address_vec(sizeof(hw_address_seed));
+        for (auto i = 0; i < sizeof(hw_address_seed); ++i) {
+            hw_address_vec[i] = (hw_address_seed >> (i * 8)) & 0xFF;
+        }
+        auto hw_address = boost::make_shared<HWAddr>(hw_address_vec, HTYPE_ETHER);
+        auto lease = boost::make_shared<Lease4>(address, hw_address, ClientIdPtr(),
+                                                3600, time(0), subnet_->getID());
+        return (lease);
+    }
+};
+
+// Test that the allocator returns the correct type.
+TEST_F(BitmapAllocatorTest4, getType) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+    EXPECT_EQ("bitmap", alloc.getType());
+}
+
+// Test populating free DHCPv4 leases to the bitmaps.
+TEST_F(BitmapAllocatorTest4, populateFreeLeases) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.100"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.102"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.104"), 2))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.106"), 3))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.108"), 4))));
+    // An expired lease is free.
+    auto expired = createLease4(IOAddress("192.0.2.109"), 5);
+    expired->cltt_ = time(0) - 7200;
+    expired->updateCurrentExpirationTime();
+    EXPECT_TRUE(lease_mgr.addLease(expired));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool_->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_FALSE(pool_state->exhausted());
+    EXPECT_EQ(5, pool_state->getFreeLeaseCount());
+
+    // The free leases are offered in the address order.
+    EXPECT_EQ("192.0.2.101", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.103", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.105", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.107", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.109", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.101", pool_state->offerFreeLease().toText());
+}
+
+// Test allocating IPv4 addresses and re-allocating these that are
+// deleted (released).
+TEST_F(BitmapAllocatorTest4, singlePoolWithAllocations) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::map<IOAddress, Lease4Ptr> leases;
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        auto lease = createLease4(candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    // The pool comprises 10 addresses. All should be returned.
+    EXPECT_EQ(10, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    auto i = 0;
+    for (auto const& address_lease : leases) {
+        if (i % 2) {
+            EXPECT_TRUE(lease_mgr.deleteLease(address_lease.second));
+        }
+        ++i;
+    }
+
+    for (auto j = 0; j < 5; ++j) {
+        candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        auto lease = createLease4(candidate, j);
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test allocating IPv4 addresses and re-allocating these that are
+// reclaimed.
+TEST_F(BitmapAllocatorTest4, singlePoolWithReclamations) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    std::map<IOAddress, Lease4Ptr> leases;
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        auto lease = createLease4(candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    EXPECT_EQ(10, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    auto i = 0;
+    for (auto const& address_lease : leases) {
+        if (i % 2) {
+            auto lease = address_lease.second;
+            lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+            EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+        }
+        ++i;
+    }
+    for (auto j = 0; j < 5; ++j) {
+        candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        auto lease = lease_mgr.getLease4(candidate);
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(lease->stateExpiredReclaimed());
+        lease->state_ = Lease::STATE_DEFAULT;
+        EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test allocating from a large, mostly used pool.
+TEST_F(BitmapAllocatorTest4, largePool) {
+    subnet_ = Subnet4::create(IOAddress("10.0.0.0"), 12, 1, 2, 3, SubnetID(10));
+    auto pool = boost::make_shared<Pool4>(IOAddress("10.0.0.0"), 12);
+    subnet_->addPool(pool);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    // Use the first 5000 addresses of the pool but two.
+    const uint32_t first = IOAddress("10.0.0.0").toUint32();
+    for (uint32_t i = 0; i < 5000; ++i) {
+        if ((i != 17) && (i != 4096)) {
+            EXPECT_TRUE(lease_mgr.addLease(createLease4(IOAddress(first + i), i)));
+        }
+    }
+
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_EQ((1 << 20) - 5000 + 2, pool_state->getFreeLeaseCount());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_EQ("10.0.0.17", candidate.toText());
+    EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, 5000)));
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_EQ("10.0.16.0", candidate.toText());
+}
+
+// Test that the allocator returns a zero address when there are no pools
+// in a subnet.
+TEST_F(BitmapAllocatorTest4, noPools) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    subnet_->delPools(Lease::TYPE_V4);
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test that the allocator respects client class guards.
+TEST_F(BitmapAllocatorTest4, clientClasses) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    // First pool only allows the client class foo.
+    pool_->allowClientClass("foo");
+
+    // Second pool. It only allows client class bar.
+    auto pool1 = boost::make_shared<Pool4>(IOAddress("192.0.2.120"),
+                                           IOAddress("192.0.2.129"));
+    pool1->allowClientClass("bar");
+    subnet_->addPool(pool1);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    cc_.insert("bar");
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(pool1->inRange(candidate));
+        EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, i + 50)));
+    }
+    // The bar pool is exhausted.
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    cc_.insert("foo");
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(pool_->inRange(candidate));
+}
+
+/// @brief Test fixture class for the DHCPv6 bitmap allocator.
+class BitmapAllocatorTest6 : public AllocEngine6Test {
+public:
+
+    /// @brief Creates a DHCPv6 lease for an address and DUID.
+    ///
+    /// @param type lease type.
+    /// @param address Lease address.
+    /// @param duid_seed a seed from which the DUID is generated.
+    /// @return Created lease pointer.
+    Lease6Ptr
+    createLease6(Lease::Type type, const IOAddress& address, uint64_t duid_seed) const {
+        vector<uint8_t> duid_vec(sizeof(duid_seed));
+        for (auto i = 0; i < sizeof(duid_seed); ++i) {
+            duid_vec[i] = (duid_seed >> (i * 8)) & 0xFF;
+        }
+        auto duid = boost::make_shared<DUID>(duid_vec);
+        auto lease = boost::make_shared<Lease6>(type, address, duid, 1, 1800,
+                                                3600, subnet_->getID());
+        return (lease);
+    }
+};
+
+// Test that the allocator returns the correct type.
+TEST_F(BitmapAllocatorTest6, getType) {
+    BitmapAllocator allocNA(Lease::TYPE_NA, subnet_);
+    EXPECT_EQ("bitmap", allocNA.getType());
+
+    BitmapAllocator allocPD(Lease::TYPE_PD, subnet_);
+    EXPECT_EQ("bitmap", allocPD.getType());
+}
+
+// Test populating free DHCPv6 address leases to the bitmaps.
+TEST_F(BitmapAllocatorTest6, populateFreeAddressLeases) {
+    BitmapAllocator alloc(Lease::TYPE_NA, subnet_);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::10"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::12"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::14"), 2))));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool_->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_EQ(14, pool_state->getFreeLeaseCount());
+
+    EXPECT_EQ("2001:db8:1::11", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("2001:db8:1::13", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("2001:db8:1::15", pool_state->offerFreeLease().toText());
+}
+
+// Test allocating IPv6 addresses and re-allocating these that are
+// deleted (released).
+TEST_F(BitmapAllocatorTest6, singlePoolWithAllocations) {
+    BitmapAllocator alloc(Lease::TYPE_NA, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    std::map<IOAddress, Lease6Ptr> leases;
+    for (auto i = 0; i < 17; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, duid_, IOAddress("::"));
+        EXPECT_FALSE(candidate.isV6Zero());
+        auto lease = createLease6(Lease::TYPE_NA, candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_NA, candidate));
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    // The pool comprises 17 addresses. All should be returned.
+    EXPECT_EQ(17, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, duid_, IOAddress("::"));
+    EXPECT_TRUE(candidate.isV6Zero());
+
+    auto i = 0;
+    for (auto const& address_lease : leases) {
+        if (i % 2) {
+            EXPECT_TRUE(lease_mgr.deleteLease(address_lease.second));
+        }
+        ++i;
+    }
+
+    for (auto j = 0; j < 8; ++j) {
+        candidate = alloc.pickAddress(cc_, duid_, IOAddress("::"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_NA, candidate));
+        auto lease = createLease6(Lease::TYPE_NA, candidate, i + j);
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, duid_, IOAddress("::"));
+    EXPECT_TRUE(candidate.isV6Zero());
+}
+
+// Test populating free DHCPv6 prefix leases to the bitmaps.
+TEST_F(BitmapAllocatorTest6, populateFreePrefixDelegationLeases) {
+    subnet_->delPools(Lease::TYPE_PD);
+
+    BitmapAllocator alloc(Lease::TYPE_PD, subnet_);
+
+    auto pool = Pool6::create(Lease::TYPE_PD, IOAddress("2001:db8:2::"), 112, 120);
+    subnet_->addPool(pool);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::200"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::ff00"), 2))));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_EQ(253, pool_state->getFreeLeaseCount());
+
+    EXPECT_EQ("2001:db8:2::100", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("2001:db8:2::300", pool_state->offerFreeLease().toText());
+
+    std::set<IOAddress> prefixes;
+    for (auto i = 0; i < 256; ++i) {
+        prefixes.insert(pool_state->offerFreeLease());
+    }
+    EXPECT_EQ(253, prefixes.size());
+    EXPECT_EQ(0, prefixes.count(IOAddress("2001:db8:2::")));
+    EXPECT_EQ(0, prefixes.count(IOAddress("2001:db8:2::200")));
+    EXPECT_EQ(0, prefixes.count(IOAddress("2001:db8:2::ff00")));
+}
+
+// Test allocating delegated prefixes and re-allocating these that are
+// deleted (released).
+TEST_F(BitmapAllocatorTest6, singlePdPoolWithAllocations) {
+    // Remove the default pool because it is too large for this test case.
+    subnet_->delPools(Lease::TYPE_PD);
+    // Add a smaller pool.
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_PD,
+                                          IOAddress("3000::"),
+                                          120,
+                                          128);
+    subnet_->addPool(pool);
+
+    BitmapAllocator alloc(Lease::TYPE_PD, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    std::map<IOAddress, Lease6Ptr> leases;
+    for (auto i = 0; i < 256; ++i) {
+        IOAddress candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 0);
+        EXPECT_FALSE(candidate.isV6Zero());
+        auto lease = createLease6(Lease::TYPE_PD, candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_PD, candidate));
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    // The pool comprises 256 delegated prefixes. All should be returned.
+    EXPECT_EQ(256, leases.size());
+
+    IOAddress candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 0);
+    EXPECT_TRUE(candidate.isV6Zero());
+
+    auto i = 0;
+    for (auto const& address_lease : leases) {
+        if (i % 2) {
+            EXPECT_TRUE(lease_mgr.deleteLease(address_lease.second));
+        }
+        ++i;
+    }
+
+    for (auto j = 0; j < 128; ++j) {
+        candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 0);
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_PD, candidate));
+        auto lease = createLease6(Lease::TYPE_PD, candidate, j);
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+
+    candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 0);
+    EXPECT_TRUE(candidate.isV6Zero());
+}
+
+} // end of isc::dhcp::test namespace
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -1072,6 +1072,79 @@ TEST(CfgSubnets4Test, 4o6subnetMatchByInterfaceName) {
     EXPECT_EQ(subnet2, cfg.selectSubnet4o6(selector));
 }
 
+// This test checks that the selection index returns the same 4o6 subnets
+// as the iteration over the subnets.
+TEST(CfgSubnets4Test, 4o6subnetSelectionIndex) {
+    CfgSubnets4 cfg;
+
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("192.0.2.0"), 26, 1, 2, 3, 123));
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("192.0.2.64"), 26, 1, 2, 3, 124));
+    Subnet4Ptr subnet3(new Subnet4(IOAddress("192.0.2.128"), 26, 1, 2, 3, 125));
+    Subnet4Ptr subnet4(new Subnet4(IOAddress("192.0.2.192"), 26, 1, 2, 3, 126));
+    Subnet4Ptr subnet5(new Subnet4(IOAddress("192.0.3.0"), 26, 1, 2, 3, 127));
+
+    const uint8_t dummyPayload1[] = { 1, 2, 3, 4};
+    const uint8_t dummyPayload2[] = { 1, 2, 3, 5};
+    std::vector<uint8_t> data1(dummyPayload1, dummyPayload1 + sizeof(dummyPayload1));
+    std::vector<uint8_t> data2(dummyPayload2, dummyPayload2 + sizeof(dummyPayload2));
+
+    OptionPtr interfaceId1(new Option(Option::V6, D6O_INTERFACE_ID, data1));
+    OptionPtr interfaceId2(new Option(Option::V6, D6O_INTERFACE_ID, data2));
+    // Same data with another option code.
+    OptionPtr otherId(new Option(Option::V6, D6O_REMOTE_ID, data1));
+
+    subnet2->get4o6().setIface4o6("eth7");
+    subnet3->get4o6().setSubnet4o6(IOAddress("2001:db8:1::"), 48);
+    subnet4->get4o6().setInterfaceId(interfaceId1);
+    subnet5->get4o6().setSubnet4o6(IOAddress("2001:db8::"), 32);
+    subnet5->get4o6().setInterfaceId(interfaceId2);
+    subnet5->get4o6().setIface4o6("eth8");
+
+    cfg.add(subnet1);
+    cfg.add(subnet2);
+    cfg.add(subnet3);
+    cfg.add(subnet4);
+    cfg.add(subnet5);
+
+    std::vector<SubnetSelector> selectors;
+    for (auto const& address : { "::", "2001:db8:1::1", "2001:db8:2::1",
+                                 "2001:db9::1" }) {
+        for (auto const& interface_id : { OptionPtr(), interfaceId1,
+                                          interfaceId2, otherId }) {
+            for (auto const& iface : { "", "eth7", "eth8", "eth9" }) {
+                SubnetSelector selector;
+                selector.dhcp4o6_ = true;
+                selector.remote_address_ = IOAddress(address);
+                selector.interface_id_ = interface_id;
+                selector.iface_name_ = iface;
+                selectors.push_back(selector);
+            }
+        }
+    }
+
+    std::vector<ConstSubnet4Ptr> expected;
+    for (auto const& selector : selectors) {
+        expected.push_back(cfg.selectSubnet4o6(selector));
+    }
+    // A few checks of the iteration results.
+    EXPECT_FALSE(expected[0]);
+    EXPECT_EQ(subnet2, expected[1]);
+    EXPECT_EQ(subnet5, expected[2]);
+    EXPECT_EQ(subnet4, expected[4]);
+    EXPECT_EQ(subnet5, expected[8]);
+    EXPECT_FALSE(expected[12]);
+    EXPECT_EQ(subnet3, expected[16 + 2]);
+    EXPECT_EQ(subnet4, expected[32 + 4]);
+    EXPECT_EQ(subnet5, expected[32]);
+    EXPECT_FALSE(expected[48]);
+
+    cfg.buildSelectionIndex();
+    ASSERT_TRUE(cfg.hasSelectionIndex());
+    for (size_t i = 0; i < selectors.size(); ++i) {
+        EXPECT_EQ(expected[i], cfg.selectSubnet4o6(selectors[i])) << i;
+    }
+}
+
 // This test check if IPv4 subnets can be unparsed in a predictable way,
 TEST(CfgSubnets4Test, unparseSubnet) {
     CfgSubnets4 cfg;
@@ -2464,6 +2537,111 @@ TEST(CfgSubnets4Test, getLinks) {
     EXPECT_EQ(expected, links);
 }
 
+// This test verifies that the selection index returns the same subnets
+// as the iteration over the subnets.
+TEST(CfgSubnets4Test, selectionIndex) {
+    IfaceMgrTestConfig config(true);
+
+    CfgSubnets4 cfg;
+
+    // Nested subnets: the first added including subnet is selected.
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("10.1.2.0"),
+                                   24, 1, 2, 3, SubnetID(1)));
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("10.0.0.0"),
+                                   8, 1, 2, 3, SubnetID(2)));
+    Subnet4Ptr subnet3(new Subnet4(IOAddress("10.1.0.0"),
+                                   16, 1, 2, 3, SubnetID(3)));
+    Subnet4Ptr subnet4(new Subnet4(IOAddress("192.0.2.0"),
+                                   24, 1, 2, 3, SubnetID(4)));
+    Subnet4Ptr subnet5(new Subnet4(IOAddress("192.0.3.0"),
+                                   24, 1, 2, 3, SubnetID(5)));
+    Subnet4Ptr subnet6(new Subnet4(IOAddress("192.0.4.0"),
+                                   24, 1, 2, 3, SubnetID(6)));
+    subnet1->allowClientClass("foo");
+    subnet4->allowClientClass("foo");
+    subnet4->addRelayAddress(IOAddress("10.2.0.1"));
+    subnet4->setIface("eth1");
+    subnet5->addRelayAddress(IOAddress("10.2.0.1"));
+    SharedNetwork4Ptr network(new SharedNetwork4("network"));
+    network->addRelayAddress(IOAddress("10.2.0.2"));
+    network->setIface("eth0");
+    network->add(subnet6);
+    subnet5->allowClientClass("bar");
+
+    for (auto const& subnet : { subnet1, subnet2, subnet3, subnet4,
+                                subnet5, subnet6 }) {
+        ASSERT_NO_THROW(cfg.add(subnet));
+    }
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+
+    std::vector<SubnetSelector> selectors;
+    for (auto const& address : { "10.1.2.3", "10.1.3.3", "10.2.3.4",
+                                 "192.0.2.1", "192.0.4.1", "172.16.0.1" }) {
+        SubnetSelector selector;
+        selector.ciaddr_ = IOAddress(address);
+        selector.local_address_ = IOAddress("10.0.0.10");
+        selectors.push_back(selector);
+    }
+    for (auto const& relay : { "10.2.0.1", "10.2.0.2", "10.2.0.3" }) {
+        SubnetSelector selector;
+        selector.giaddr_ = IOAddress(relay);
+        selectors.push_back(selector);
+    }
+    for (auto const& iface : { "eth0", "eth1" }) {
+        SubnetSelector selector;
+        selector.iface_name_ = iface;
+        selector.local_address_ = IOAddress("255.255.255.255");
+        selectors.push_back(selector);
+    }
+    std::vector<ClientClasses> classes(3);
+    classes[1].insert("foo");
+    classes[2].insert("bar");
+
+    std::vector<ConstSubnet4Ptr> expected;
+    for (auto& selector : selectors) {
+        for (auto const& client_classes : classes) {
+            selector.client_classes_ = client_classes;
+            expected.push_back(cfg.selectSubnet(selector));
+        }
+    }
+    // A few checks of the iteration results.
+    EXPECT_EQ(subnet2, expected[0]);
+    EXPECT_EQ(subnet1, expected[1]);
+    EXPECT_EQ(subnet2, expected[6 * 3]);
+    EXPECT_EQ(subnet4, expected[6 * 3 + 1]);
+    EXPECT_EQ(subnet5, expected[6 * 3 + 2]);
+    EXPECT_EQ(subnet6, expected[7 * 3]);
+    EXPECT_EQ(subnet6, expected[9 * 3]);
+    EXPECT_EQ(subnet4, expected[10 * 3 + 1]);
+
+    cfg.buildSelectionIndex();
+    ASSERT_TRUE(cfg.hasSelectionIndex());
+    size_t i = 0;
+    for (auto& selector : selectors) {
+        for (auto const& client_classes : classes) {
+            selector.client_classes_ = client_classes;
+            EXPECT_EQ(expected[i], cfg.selectSubnet(selector)) << i;
+            ++i;
+        }
+    }
+    SubnetIDSet links = { 1, 2, 3 };
+    EXPECT_EQ(links, cfg.getLinks(IOAddress("10.1.2.3")));
+
+    // Adding a subnet drops the index.
+    Subnet4Ptr subnet7(new Subnet4(IOAddress("10.1.2.128"),
+                                   25, 1, 2, 3, SubnetID(7)));
+    ASSERT_NO_THROW(cfg.add(subnet7));
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+    cfg.buildSelectionIndex();
+    EXPECT_EQ(subnet2, cfg.selectSubnet(IOAddress("10.1.2.200")));
+    ASSERT_NO_THROW(cfg.del(subnet2));
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+    cfg.buildSelectionIndex();
+    EXPECT_EQ(subnet3, cfg.selectSubnet(IOAddress("10.1.2.200")));
+    cfg.clear();
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+}
+
 // This test verifies that for each subnet in the configuration it calls
 // the initAllocatorAfterConfigure function.
 TEST(CfgSubnets4Test, initAllocatorsAfterConfigure) {
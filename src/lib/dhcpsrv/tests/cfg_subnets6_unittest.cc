@@ -32,6 +32,7 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 using namespace isc;
 using namespace isc::asiolink;
@@ -2495,6 +2496,100 @@ TEST(CfgSubnets6Test, getLinks) {
     EXPECT_EQ(expected, links);
 }
 
+// This test verifies that the selection index returns the same subnets
+// as the iteration over the subnets.
+TEST(CfgSubnets6Test, selectionIndex) {
+    CfgSubnets6 cfg;
+
+    // Nested subnets: the first added including subnet is selected.
+    Subnet6Ptr subnet1(new Subnet6(IOAddress("2001:db8:1:2::"),
+                                   64, 1, 2, 3, 4, SubnetID(1)));
+    Subnet6Ptr subnet2(new Subnet6(IOAddress("2001:db8::"),
+                                   32, 1, 2, 3, 4, SubnetID(2)));
+    Subnet6Ptr subnet3(new Subnet6(IOAddress("2001:db8:1::"),
+                                   48, 1, 2, 3, 4, SubnetID(3)));
+    Subnet6Ptr subnet4(new Subnet6(IOAddress("3000::"),
+                                   48, 1, 2, 3, 4, SubnetID(4)));
+    Subnet6Ptr subnet5(new Subnet6(IOAddress("4000::"),
+                                   48, 1, 2, 3, 4, SubnetID(5)));
+    OptionPtr ifaceid = generateInterfaceId("relay1.eth0");
+    subnet1->allowClientClass("foo");
+    subnet4->allowClientClass("foo");
+    subnet4->addRelayAddress(IOAddress("2001:db8:ff::1"));
+    subnet4->setInterfaceId(ifaceid);
+    subnet4->setIface("eth1");
+    SharedNetwork6Ptr network(new SharedNetwork6("network"));
+    network->addRelayAddress(IOAddress("2001:db8:ff::2"));
+    network->setIface("eth0");
+    network->add(subnet5);
+
+    for (auto const& subnet : { subnet1, subnet2, subnet3, subnet4,
+                                subnet5 }) {
+        ASSERT_NO_THROW(cfg.add(subnet));
+    }
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+
+    std::vector<SubnetSelector> selectors;
+    for (auto const& address : { "2001:db8:1:2::3", "2001:db8:1:3::3",
+                                 "2001:db8:2::1", "5000::1" }) {
+        SubnetSelector selector;
+        selector.remote_address_ = IOAddress(address);
+        selectors.push_back(selector);
+    }
+    for (auto const& iface : { "eth0", "eth1" }) {
+        SubnetSelector selector;
+        selector.iface_name_ = iface;
+        selector.remote_address_ = IOAddress("5000::1");
+        selectors.push_back(selector);
+    }
+    SubnetSelector relayed;
+    relayed.first_relay_linkaddr_ = IOAddress("2001:db8:ff::1");
+    relayed.interface_id_ = ifaceid;
+    selectors.push_back(relayed);
+    relayed.first_relay_linkaddr_ = IOAddress("2001:db8:ff::2");
+    relayed.interface_id_.reset();
+    selectors.push_back(relayed);
+    std::vector<ClientClasses> classes(2);
+    classes[1].insert("foo");
+
+    std::vector<ConstSubnet6Ptr> expected;
+    for (auto& selector : selectors) {
+        for (auto const& client_classes : classes) {
+            selector.client_classes_ = client_classes;
+            expected.push_back(cfg.selectSubnet(selector));
+        }
+    }
+    // A few checks of the iteration results.
+    EXPECT_EQ(subnet2, expected[0]);
+    EXPECT_EQ(subnet1, expected[1]);
+    EXPECT_EQ(subnet5, expected[4 * 2]);
+    EXPECT_EQ(subnet4, expected[5 * 2 + 1]);
+    EXPECT_EQ(subnet2, expected[6 * 2]);
+    EXPECT_EQ(subnet4, expected[6 * 2 + 1]);
+    EXPECT_EQ(subnet5, expected[7 * 2]);
+
+    cfg.buildSelectionIndex();
+    ASSERT_TRUE(cfg.hasSelectionIndex());
+    size_t i = 0;
+    for (auto& selector : selectors) {
+        for (auto const& client_classes : classes) {
+            selector.client_classes_ = client_classes;
+            EXPECT_EQ(expected[i], cfg.selectSubnet(selector)) << i;
+            ++i;
+        }
+    }
+    SubnetIDSet links = { 1, 2, 3 };
+    EXPECT_EQ(links, cfg.getLinks(IOAddress("2001:db8:1:2::3")));
+
+    // Removing a subnet drops the index.
+    ASSERT_NO_THROW(cfg.del(subnet2));
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+    cfg.buildSelectionIndex();
+    EXPECT_EQ(subnet3, cfg.selectSubnet(IOAddress("2001:db8:1:3::3")));
+    cfg.clear();
+    EXPECT_FALSE(cfg.hasSelectionIndex());
+}
+
 // This test verifies that for each subnet in the configuration it calls
 // the registerLeaseMgrCallback function.
 TEST(CfgSubnets6Test, initAllocatorsAfterConfigure) {
@@ -581,6 +581,43 @@ TEST(ClientClassDictionary, initMatchExpr) {
     EXPECT_EQ(6, classes[2]->getMatchExpr()->size());
 }
 
+// Tests that the identical extraction tokens are shared by the match
+// expressions of the classes in the dictionary.
+TEST(ClientClassDictionary, shareTokens) {
+    ClientClassDictionaryPtr dictionary(new ClientClassDictionary());
+    ExpressionPtr expr;
+    CfgOptionPtr cfg_option;
+
+    ASSERT_NO_THROW(dictionary->addClass("foo", expr, "substring(option[61].hex,0,3) == 'foo'",
+                                         false, false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("bar", expr, "option[61].hex == 'bar'",
+                                         false, false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("baz", expr, "option[61].text == 'baz'",
+                                         false, false, cfg_option));
+    ASSERT_NO_THROW(dictionary->initMatchExpr(AF_INET));
+
+    auto classes = *(dictionary->getClasses());
+    ASSERT_EQ(3, classes.size());
+    for (auto const& c : classes) {
+        ASSERT_TRUE(c->getMatchExpr());
+    }
+    // option[61].hex is shared, option[61].text is not.
+    EXPECT_EQ((*classes[0]->getMatchExpr())[0], (*classes[1]->getMatchExpr())[0]);
+    EXPECT_NE((*classes[0]->getMatchExpr())[0], (*classes[2]->getMatchExpr())[0]);
+
+    // The shared expressions are compiled again.
+    EXPECT_TRUE(classes[1]->getCompiledMatchExpr());
+
+    // Classes added later share the tokens too.
+    ExpressionPtr parsed(new Expression());
+    parsed->push_back(TokenPtr(new TokenOption(61, TokenOption::HEXADECIMAL)));
+    ClientClassDefPtr qux(new ClientClassDef("qux", parsed));
+    ASSERT_NO_THROW(dictionary->addClass(qux));
+    EXPECT_EQ((*classes[0]->getMatchExpr())[0], (*qux->getMatchExpr())[0]);
+    // The original expression was not modified.
+    EXPECT_NE((*classes[0]->getMatchExpr())[0], (*parsed)[0]);
+}
+
 // Tests that an error is returned when any of the test expressions is
 // invalid, and that no expressions are initialized if there is an error
 // for a single expression.
@@ -1418,6 +1455,50 @@ TEST(ClientClassDictionary, templateInitMatchExpr) {
     EXPECT_EQ(3, classes[2]->getMatchExpr()->size());
 }
 
+// Tests the list of evaluated classes with template subclass definitions.
+TEST(ClientClassDictionary, templateSubClasses) {
+    ClientClassDictionaryPtr dictionary(new ClientClassDictionary());
+    ExpressionPtr expr;
+    CfgOptionPtr cfg_option;
+
+    // A subclass defined before its template.
+    ASSERT_NO_THROW(dictionary->addClass("SPAWN_my_template_foo", expr, "", false,
+                                         false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("my_template", expr, "option[61].hex", false,
+                                         false, cfg_option, CfgOptionDefPtr(),
+                                         ConstElementPtr(), IOAddress("0.0.0.0"),
+                                         "", "", Triplet<uint32_t>(),
+                                         Triplet<uint32_t>(), true));
+    // A subclass defined after its template.
+    ASSERT_NO_THROW(dictionary->addClass("SPAWN_my_template_bar", expr, "", false,
+                                         false, cfg_option));
+    // Not a subclass.
+    ASSERT_NO_THROW(dictionary->addClass("SPAWN_other_foo", expr, "", false,
+                                         false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("regular", expr, "member('foo')", false,
+                                         false, cfg_option));
+    ASSERT_NO_THROW(dictionary->initMatchExpr(AF_INET));
+
+    // Only the classes with a match expression are evaluated.
+    auto evaluated = *(dictionary->getEvaluatedClasses());
+    ASSERT_EQ(2, evaluated.size());
+    EXPECT_EQ("my_template", evaluated[0]->getName());
+    EXPECT_EQ("regular", evaluated[1]->getName());
+
+    // The copies keep the template classes and the list.
+    ClientClassDictionary copy(*dictionary);
+    EXPECT_TRUE(dynamic_cast<TemplateClientClassDef*>(copy.findClass("my_template").get()));
+    EXPECT_EQ(2, copy.getEvaluatedClasses()->size());
+
+    // Removed classes are removed from the list.
+    dictionary->removeClass("SPAWN_my_template_foo");
+    EXPECT_EQ(2, dictionary->getEvaluatedClasses()->size());
+    dictionary->removeClass("regular");
+    EXPECT_EQ(1, dictionary->getEvaluatedClasses()->size());
+    dictionary->removeClass("my_template");
+    EXPECT_TRUE(dictionary->getEvaluatedClasses()->empty());
+}
+
 // Tests that an error is returned when any of the test expressions is
 // invalid, and that no expressions are initialized if there is an error
 // for a single expression.
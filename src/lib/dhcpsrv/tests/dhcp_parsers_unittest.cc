@@ -3457,7 +3457,7 @@ TEST_F(ParseConfigTest, invalidSubnetAllocator4) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
@@ -3541,7 +3541,7 @@ TEST_F(ParseConfigTest, invalidSubnetAllocator6) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
@@ -3639,7 +3639,7 @@ TEST_F(ParseConfigTest, invalidSubnetPdAllocator6) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
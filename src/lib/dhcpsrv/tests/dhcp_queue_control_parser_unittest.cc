@@ -9,6 +9,7 @@
 #include <cc/data.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/parsers/dhcp_queue_control_parser.h>
+#include <testutils/log_utils.h>
 #include <testutils/multi_threading_utils.h>
 #include <testutils/test_to_element.h>
 #include <util/multi_threading_mgr.h>
@@ -16,13 +17,14 @@
 
 using namespace isc::data;
 using namespace isc::dhcp;
+using namespace isc::dhcp::test;
 using namespace isc::test;
 using namespace isc::util;
 
 namespace {
 
 /// @brief Test fixture class for @c DHCPQueueControlParser
-class DHCPQueueControlParserTest : public ::testing::Test {
+class DHCPQueueControlParserTest : public LogContentTest {
 public:
     /// @brief Constructor
     DHCPQueueControlParserTest() = default;
@@ -90,6 +92,13 @@ TEST_F(DHCPQueueControlParserTest, validContent) {
         "   \"foo\": \"bogus\", \n"
         "   \"random-int\" : 1234 \n"
         "} \n"
+        },
+        {
+        "queue disabled, lazy option unpacking",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"lazy-option-unpack\": true \n"
+        "} \n"
         }
     };
 
@@ -155,6 +164,44 @@ TEST_F(DHCPQueueControlParserTest, invalidContent) {
         "   \"enable-queue\": true, \n"
         "   \"queue-type\": 7777 \n"
         "} \n"
+        },
+        {
+        "receiver-per-socket not boolean",
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"receiver-per-socket\": \"yes\" \n"
+        "} \n"
+        },
+        {
+        "receive-batch-size not an integer",
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"receive-batch-size\": \"many\" \n"
+        "} \n"
+        },
+        {
+        "send-batch-size not positive",
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"send-batch-size\": 0 \n"
+        "} \n"
+        },
+        {
+        "packet-mmap not boolean",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"packet-mmap\": \"on\" \n"
+        "} \n"
+        },
+        {
+        "lazy-option-unpack not boolean",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"lazy-option-unpack\": 1 \n"
+        "} \n"
         }
     };
 
@@ -208,4 +255,108 @@ TEST_F(DHCPQueueControlParserTest, multiThreading) {
     EXPECT_EQ("false", queue_control->get("enable-queue")->str());
 }
 
+// Verifies that DHCPQueueControlParser keeps the queue enabled with
+// multi-threading when per-socket receivers are configured.
+TEST_F(DHCPQueueControlParserTest, multiThreadingPerSocket) {
+    // Enable config with some queue type and per-socket receivers.
+    std::string config =
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"receiver-per-socket\": true \n"
+        "} \n";
+
+    // Construct the config JSON.
+    ConstElementPtr config_elems;
+    ASSERT_NO_THROW(config_elems = Element::fromJSON(config))
+        << "invalid JSON, test is broken";
+
+    // Parse config with multi-threading.
+    DHCPQueueControlParser parser;
+    ConstElementPtr queue_control;
+    ASSERT_NO_THROW(queue_control = parser.parse(config_elems, true));
+
+    // Verify that queue is still enabled.
+    ASSERT_TRUE(queue_control);
+    ASSERT_TRUE(queue_control->get("enable-queue"));
+    EXPECT_EQ("true", queue_control->get("enable-queue")->str());
+    EXPECT_TRUE(queue_control->equals(*config_elems));
+}
+
+// Verifies that DHCPQueueControlParser warns about the batch sizes which
+// have no effect because the queue is disabled.
+TEST_F(DHCPQueueControlParserTest, batchSizeIgnored) {
+    struct Scenario {
+        std::string description_;
+        std::string json_;
+        bool multi_threading_;
+        size_t exp_log_count_;
+    };
+
+    std::vector<Scenario> scenarios = {
+    {
+        "queue enabled",
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"receive-batch-size\": 8, \n"
+        "   \"send-batch-size\": 8 \n"
+        "} \n",
+        false, 0
+    },
+    {
+        "queue enabled with per-socket receivers and multi-threading",
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"receiver-per-socket\": true, \n"
+        "   \"send-batch-size\": 8 \n"
+        "} \n",
+        true, 0
+    },
+    {
+        "queue disabled without batching",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"receive-batch-size\": 1, \n"
+        "   \"send-batch-size\": 1 \n"
+        "} \n",
+        false, 0
+    },
+    {
+        "queue disabled",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"receive-batch-size\": 8, \n"
+        "   \"send-batch-size\": 8 \n"
+        "} \n",
+        false, 2
+    },
+    {
+        "queue disabled by multi-threading",
+        "{ \n"
+        "   \"enable-queue\": true, \n"
+        "   \"queue-type\": \"some-type\", \n"
+        "   \"send-batch-size\": 8 \n"
+        "} \n",
+        true, 1
+    }
+    };
+
+    size_t exp_log_count = 0;
+    for (auto const& scenario : scenarios) {
+        SCOPED_TRACE(scenario.description_);
+        ConstElementPtr config_elems;
+        ASSERT_NO_THROW(config_elems = Element::fromJSON(scenario.json_))
+                        << "invalid JSON, test is broken";
+
+        DHCPQueueControlParser parser;
+        ASSERT_NO_THROW(parser.parse(config_elems, scenario.multi_threading_));
+
+        // The log file accumulates the messages of all the scenarios.
+        exp_log_count += scenario.exp_log_count_;
+        EXPECT_EQ(exp_log_count, countFile("DHCPSRV_QUEUE_CONTROL_BATCH_IGNORED"));
+    }
+}
+
 }  // anonymous namespace
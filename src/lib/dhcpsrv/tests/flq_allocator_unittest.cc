@@ -7,12 +7,15 @@
 #include <config.h>
 #include <asiolink/io_address.h>
 #include <dhcp/hwaddr.h>
+#include <dhcpsrv/cfg_subnets4.h>
 #include <dhcpsrv/flq_allocator.h>
+#include <dhcpsrv/parsers/dhcp_parsers.h>
 #include <dhcpsrv/testutils/alloc_engine_utils.h>
 #include <boost/make_shared.hpp>
 #include <gtest/gtest.h>
 
 using namespace isc::asiolink;
+using namespace isc::data;
 using namespace std;
 
 namespace isc {
@@ -39,6 +42,45 @@ public:
                                                 3600, time(0), subnet_->getID());
         return (lease);
     }
+
+    /// @brief Creates a DHCPv4 lease in the subnet returned by
+    /// @c parseSubnets4.
+    ///
+    /// @param address Lease address.
+    /// @param hw_address_seed a seed from which the hardware address is generated.
+    /// @return Created lease pointer.
+    Lease4Ptr
+    createSubnetLease4(const IOAddress& address, uint64_t hw_address_seed) const {
+        auto lease = createLease4(address, hw_address_seed);
+        lease->subnet_id_ = 10;
+        return (lease);
+    }
+
+    /// @brief Parses the configuration of a subnet with the identifier 10.
+    ///
+    /// @param pools the pools of the subnet, in the form used in the
+    /// "pool" parameter.
+    /// @param allocator the allocator of the subnet.
+    /// @return the subnets holding the parsed subnet.
+    CfgSubnets4Ptr
+    parseSubnets4(const vector<string>& pools,
+                  const string& allocator = "flq") const {
+        ElementPtr config = Element::fromJSON("{ \"id\": 10, "
+                                              "\"subnet\": \"192.0.3.0/24\" }");
+        config->set("allocator", Element::create(allocator));
+        ElementPtr pool_list = Element::createList();
+        for (auto const& pool : pools) {
+            ElementPtr pool_map = Element::createMap();
+            pool_map->set("pool", Element::create(pool));
+            pool_list->add(pool_map);
+        }
+        config->set("pools", pool_list);
+        Subnet4ConfigParser parser(false);
+        Subnet4Ptr subnet = parser.parse(config);
+        CfgSubnets4Ptr subnets = boost::make_shared<CfgSubnets4>();
+        subnets->add(subnet);
+        return (subnets);
+    }
 };
 
 // Test that the allocator returns the correct type.
@@ -335,6 +377,134 @@ TEST_F(FreeLeaseQueueAllocatorTest4, clientClasses) {
    EXPECT_TRUE(candidate.isV4Zero());
 }
 
+// Test populating the free leases of several subnets in parallel.
+TEST_F(FreeLeaseQueueAllocatorTest4, initAllocatorsAfterConfigure) {
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    std::vector<Subnet4Ptr> subnets;
+    std::vector<AllocatorPtr> allocators;
+    for (auto i = 0; i < 8; ++i) {
+        stringstream prefix, min, max;
+        prefix << "10.0." << i << ".0";
+        min << "10.0." << i << ".1";
+        max << "10.0." << i << ".200";
+        auto subnet = Subnet4::create(IOAddress(prefix.str()), 24, 1, 2, 3,
+                                      SubnetID(100 + i));
+        subnet->addPool(boost::make_shared<Pool4>(IOAddress(min.str()),
+                                                  IOAddress(max.str())));
+        auto allocator = boost::make_shared<FreeLeaseQueueAllocator>(Lease::TYPE_V4, subnet);
+        subnet->setAllocator(Lease::TYPE_V4, allocator);
+        subnets.push_back(subnet);
+        allocators.push_back(allocator);
+
+        // Allocate i leases in the subnet.
+        for (auto j = 0; j < i; ++j) {
+            auto lease = createLease4(IOAddress(min.str()).toUint32() + j, 8 * i + j);
+            lease->subnet_id_ = subnet->getID();
+            EXPECT_TRUE(lease_mgr.addLease(lease));
+        }
+    }
+
+    ASSERT_NO_THROW(Allocator::initAllocatorsAfterConfigure(allocators, 4));
+
+    for (auto i = 0; i < subnets.size(); ++i) {
+        auto const& pool = subnets[i]->getPools(Lease::TYPE_V4)[0];
+        auto pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(pool->getAllocationState());
+        ASSERT_TRUE(pool_state);
+        EXPECT_TRUE(pool_state->isPopulated());
+        EXPECT_EQ(200 - i, pool_state->getFreeLeaseCount());
+    }
+
+    // The callbacks have been installed.
+    auto lease = createLease4(IOAddress("10.0.7.100"), 1000);
+    lease->subnet_id_ = subnets[7]->getID();
+    EXPECT_TRUE(lease_mgr.addLease(lease));
+    auto pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(
+        subnets[7]->getPools(Lease::TYPE_V4)[0]->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_EQ(192, pool_state->getFreeLeaseCount());
+
+    // Initializing the allocators again is a no-op.
+    EXPECT_NO_THROW(Allocator::initAllocatorsAfterConfigure(allocators, 4));
+}
+
+// Test that the populated free leases of the unchanged pools are reused
+// after reconfiguration.
+TEST_F(FreeLeaseQueueAllocatorTest4, reuseAllocationStates) {
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    CfgSubnets4Ptr previous = parseSubnets4({ "192.0.3.100 - 192.0.3.109" });
+    auto const& previous_pool = previous->getSubnet(10)->getPools(Lease::TYPE_V4)[0];
+    ASSERT_NO_THROW(previous->initAllocatorsAfterConfigure(0));
+    auto pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(
+        previous_pool->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_TRUE(pool_state->isPopulated());
+    EXPECT_TRUE(lease_mgr.addLease(createSubnetLease4(IOAddress("192.0.3.100"), 0)));
+    EXPECT_EQ(9, pool_state->getFreeLeaseCount());
+
+    // Simulate the reconfiguration: the lease manager no longer tracks
+    // the leases for the previous allocator.
+    lease_mgr.unregisterCallbacks(10, Lease::TYPE_V4);
+
+    // This lease is not seen by the reused queue because the pool is
+    // not populated again.
+    EXPECT_TRUE(lease_mgr.addLease(createSubnetLease4(IOAddress("192.0.3.101"), 1)));
+
+    // The new configuration has the same pool and a new one. The parser
+    // gives them fresh allocation states.
+    CfgSubnets4Ptr current = parseSubnets4({ "192.0.3.100 - 192.0.3.109",
+                                             "192.0.3.200 - 192.0.3.209" });
+    auto const& pools = current->getSubnet(10)->getPools(Lease::TYPE_V4);
+    ASSERT_EQ(2, pools.size());
+    ASSERT_TRUE(pools[0]->getAllocationState());
+    EXPECT_NE(pool_state, pools[0]->getAllocationState());
+
+    ASSERT_NO_THROW(current->initAllocatorsAfterConfigure(0, previous));
+    EXPECT_EQ(pool_state, pools[0]->getAllocationState());
+    EXPECT_EQ(9, pool_state->getFreeLeaseCount());
+    auto new_pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(
+        pools[1]->getAllocationState());
+    ASSERT_TRUE(new_pool_state);
+    EXPECT_TRUE(new_pool_state->isPopulated());
+    EXPECT_EQ(10, new_pool_state->getFreeLeaseCount());
+
+    // The new allocator tracks the leases in the reused queue.
+    EXPECT_TRUE(lease_mgr.addLease(createSubnetLease4(IOAddress("192.0.3.102"), 2)));
+    EXPECT_EQ(8, pool_state->getFreeLeaseCount());
+}
+
+// Test that the allocation states are not reused when the pool changed.
+TEST_F(FreeLeaseQueueAllocatorTest4, reuseAllocationStatesChangedPool) {
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    CfgSubnets4Ptr previous = parseSubnets4({ "192.0.3.100 - 192.0.3.109" });
+    ASSERT_NO_THROW(previous->initAllocatorsAfterConfigure(0));
+    auto pool_state = previous->getSubnet(10)->getPools(Lease::TYPE_V4)[0]->getAllocationState();
+    lease_mgr.unregisterCallbacks(10, Lease::TYPE_V4);
+    EXPECT_TRUE(lease_mgr.addLease(createSubnetLease4(IOAddress("192.0.3.100"), 0)));
+
+    // The changed pool is populated again.
+    CfgSubnets4Ptr current = parseSubnets4({ "192.0.3.100 - 192.0.3.110" });
+    ASSERT_NO_THROW(current->initAllocatorsAfterConfigure(0, previous));
+    auto const& pool = current->getSubnet(10)->getPools(Lease::TYPE_V4)[0];
+    EXPECT_NE(pool_state, pool->getAllocationState());
+    auto new_pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(
+        pool->getAllocationState());
+    ASSERT_TRUE(new_pool_state);
+    EXPECT_EQ(10, new_pool_state->getFreeLeaseCount());
+    lease_mgr.unregisterCallbacks(10, Lease::TYPE_V4);
+
+    // The state is not reused by a different allocator type either.
+    CfgSubnets4Ptr iterative = parseSubnets4({ "192.0.3.100 - 192.0.3.109" },
+                                             "iterative");
+    ASSERT_NO_THROW(iterative->initAllocatorsAfterConfigure(0, previous));
+    auto const& iterative_pool = iterative->getSubnet(10)->getPools(Lease::TYPE_V4)[0];
+    EXPECT_NE(pool_state, iterative_pool->getAllocationState());
+    EXPECT_FALSE(boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(
+        iterative_pool->getAllocationState()));
+}
+
 /// @brief Test fixture class for the DHCPv6 Free Lease Queue allocator.
 class FreeLeaseQueueAllocatorTest6 : public AllocEngine6Test {
 public:
@@ -0,0 +1,161 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lease_file_writer.h>
+#include <exceptions/exceptions.h>
+#include <util/csv_file.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Test fixture collecting the written groups.
+class LeaseFileWriterTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    LeaseFileWriterTest() : fail_(false) {
+    }
+
+    /// @brief Returns the write function of the writer.
+    LeaseFileWriter::WriteFunc writeFunc() {
+        return ([this](const string& rows) {
+            if (fail_) {
+                isc_throw(CSVFileError, "write failed");
+            }
+            lock_guard<mutex> lock(mutex_);
+            groups_.push_back(rows);
+            written_ += rows;
+        });
+    }
+
+    /// @brief Returns the written text.
+    string getWritten() {
+        lock_guard<mutex> lock(mutex_);
+        return (written_);
+    }
+
+    /// @brief Make the write function fail.
+    atomic<bool> fail_;
+
+    /// @brief Protects the written groups.
+    mutex mutex_;
+
+    /// @brief The written groups.
+    vector<string> groups_;
+
+    /// @brief The written text.
+    string written_;
+};
+
+// Checks that the queue size must not be 0.
+TEST_F(LeaseFileWriterTest, constructor) {
+    EXPECT_THROW(LeaseFileWriter(writeFunc(), 0, 0), BadValue);
+    EXPECT_NO_THROW(LeaseFileWriter(writeFunc(), 1, 0));
+}
+
+// Checks that the rows are written in order.
+TEST_F(LeaseFileWriterTest, post) {
+    LeaseFileWriter writer(writeFunc(), 16, 0);
+    LeaseFileWriter::Tickets tickets;
+    tickets.push_back(writer.post("a\n"));
+    tickets.push_back(writer.post("b\n"));
+    tickets.push_back(writer.post("c\n"));
+    ASSERT_NO_THROW(writer.wait(tickets));
+    for (auto const& ticket : tickets) {
+        EXPECT_TRUE(ticket->done_);
+        EXPECT_TRUE(ticket->error_.empty());
+    }
+    EXPECT_EQ("a\nb\nc\n", getWritten());
+    EXPECT_LE(writer.getGroupCount(), 3);
+
+    // Waiting for no rows returns at once.
+    EXPECT_NO_THROW(writer.wait(LeaseFileWriter::Tickets()));
+}
+
+// Checks that the rows posted within the maximum delay are written as
+// a single group.
+TEST_F(LeaseFileWriterTest, group) {
+    LeaseFileWriter writer(writeFunc(), 4, 10000000);
+    LeaseFileWriter::Tickets tickets;
+    for (auto row : { "a\n", "b\n", "c\n", "d\n" }) {
+        tickets.push_back(writer.post(row));
+    }
+    ASSERT_NO_THROW(writer.wait(tickets));
+    EXPECT_EQ(1, writer.getGroupCount());
+    ASSERT_EQ(1, groups_.size());
+    EXPECT_EQ("a\nb\nc\nd\n", groups_[0]);
+}
+
+// Checks that write errors are reported to the waiting callers.
+TEST_F(LeaseFileWriterTest, error) {
+    LeaseFileWriter writer(writeFunc(), 16, 0);
+    fail_ = true;
+    LeaseFileWriter::Tickets tickets;
+    tickets.push_back(writer.post("a\n"));
+    EXPECT_THROW(writer.wait(tickets), CSVFileError);
+    EXPECT_EQ("write failed", tickets[0]->error_);
+
+    // The writer still works after an error.
+    fail_ = false;
+    tickets.clear();
+    tickets.push_back(writer.post("b\n"));
+    EXPECT_NO_THROW(writer.wait(tickets));
+    EXPECT_EQ("b\n", getWritten());
+}
+
+// Checks that drain and stop write the queued rows.
+TEST_F(LeaseFileWriterTest, drainAndStop) {
+    LeaseFileWriter writer(writeFunc(), 16, 100000);
+    writer.post("a\n");
+    writer.drain();
+    EXPECT_EQ("a\n", getWritten());
+
+    writer.post("b\n");
+    writer.stop();
+    EXPECT_EQ("a\nb\n", getWritten());
+    EXPECT_THROW(writer.post("c\n"), CSVFileError);
+}
+
+// Checks that the rows posted by concurrent threads with a bounded queue
+// are all written.
+TEST_F(LeaseFileWriterTest, concurrent) {
+    LeaseFileWriter writer(writeFunc(), 8, 0);
+    const size_t threads_num = 8;
+    const size_t rows_num = 1000;
+    vector<thread> threads;
+    for (size_t i = 0; i < threads_num; ++i) {
+        threads.push_back(thread([&writer, i]() {
+            for (size_t j = 0; j < rows_num; ++j) {
+                LeaseFileWriter::Tickets tickets;
+                tickets.push_back(writer.post(to_string(i) + "\n"));
+                writer.wait(tickets);
+            }
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    string written = getWritten();
+    EXPECT_EQ(threads_num * rows_num, count(written.begin(), written.end(), '\n'));
+    EXPECT_LE(writer.getGroupCount(), threads_num * rows_num);
+}
+
+}  // namespace
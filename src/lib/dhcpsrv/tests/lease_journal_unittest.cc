@@ -0,0 +1,506 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcp/duid.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_journal.h>
+#include <dhcpsrv/testutils/lease_file_io.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+using namespace isc::util;
+
+namespace {
+
+// HWADDR value used by unit tests.
+const uint8_t HWADDR[] = { 0, 1, 2, 3, 4, 5 };
+
+const uint8_t CLIENTID[] = { 1, 2, 3, 4 };
+
+/// @brief Test fixture class for the lease journals.
+class LeaseJournalTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Initializes IO for lease files used by unit tests.
+    LeaseJournalTest()
+        : filename_(absolutePath("leases.journal")), io_(filename_),
+          csv_filename_(absolutePath("leases.csv")), csv_io_(csv_filename_) {
+        hwaddr_.reset(new HWAddr(HWADDR, sizeof(HWADDR), HTYPE_ETHER));
+    }
+
+    /// @brief Prepends the absolute path to the file specified
+    /// as an argument.
+    ///
+    /// @param filename Name of the file.
+    /// @return Absolute path to the test file.
+    static std::string absolutePath(const std::string& filename) {
+        std::ostringstream s;
+        s << DHCP_DATA_DIR << "/" << filename;
+        return (s.str());
+    }
+
+    /// @brief Returns sample DHCPv4 leases.
+    std::vector<Lease4Ptr> getLeases4() const {
+        std::vector<Lease4Ptr> leases;
+        Lease4Ptr lease(new Lease4(IOAddress("192.0.2.1"), hwaddr_,
+                                   CLIENTID, sizeof(CLIENTID), 200, 1000, 8,
+                                   true, false, "host.example.com"));
+        lease->setContext(Element::fromJSON("{ \"foo\": \"bar\" }"));
+        lease->pool_id_ = 7;
+        leases.push_back(lease);
+        lease.reset(new Lease4(IOAddress("192.0.2.2"), hwaddr_,
+                               ClientIdPtr(), 100, 2000, 9));
+        lease->hwaddr_->source_ = HWAddr::HWADDR_SOURCE_RAW;
+        leases.push_back(lease);
+        lease.reset(new Lease4(IOAddress("192.0.2.3"), HWAddrPtr(),
+                               ClientIdPtr(), 0, 3000, 9));
+        lease->state_ = Lease::STATE_DECLINED;
+        leases.push_back(lease);
+        return (leases);
+    }
+
+    /// @brief Returns sample DHCPv6 leases.
+    std::vector<Lease6Ptr> getLeases6() const {
+        std::vector<Lease6Ptr> leases;
+        DuidPtr duid(new DUID(std::vector<uint8_t>(8, 0x42)));
+        Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8::1"),
+                                   duid, 1, 100, 200, 8, hwaddr_));
+        lease->cltt_ = 1000;
+        lease->updateCurrentExpirationTime();
+        lease->hostname_ = "host.example.com";
+        lease->fqdn_rev_ = true;
+        lease->setContext(Element::fromJSON("{ \"foo\": \"bar\" }"));
+        leases.push_back(lease);
+        lease.reset(new Lease6(Lease::TYPE_PD, IOAddress("3000::"), duid, 2,
+                               100, 200, 8, HWAddrPtr(), 64));
+        lease->cltt_ = 2000;
+        lease->updateCurrentExpirationTime();
+        lease->pool_id_ = 3;
+        leases.push_back(lease);
+        lease.reset(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8::2"),
+                               DuidPtr(new DUID(DUID::EMPTY())), 0, 0, 0, 8));
+        lease->cltt_ = 3000;
+        lease->updateCurrentExpirationTime();
+        lease->state_ = Lease::STATE_DECLINED;
+        leases.push_back(lease);
+        return (leases);
+    }
+
+    /// @brief Name of the test journal.
+    std::string filename_;
+
+    /// @brief Object providing access to the journal IO.
+    LeaseFileIO io_;
+
+    /// @brief Name of the test CSV file.
+    std::string csv_filename_;
+
+    /// @brief Object providing access to the CSV file IO.
+    LeaseFileIO csv_io_;
+
+    /// @brief Hardware address of the leases.
+    HWAddrPtr hwaddr_;
+};
+
+// Checks that the DHCPv4 leases are read back from the journal.
+TEST_F(LeaseJournalTest, appendAndRead4) {
+    std::vector<Lease4Ptr> leases = getLeases4();
+    {
+        LeaseJournal4 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        for (auto const& lease : leases) {
+            ASSERT_NO_THROW(journal.append(*lease));
+        }
+        EXPECT_EQ(3, journal.getWriteLeases());
+
+        // A lease without identifier is rejected.
+        Lease4 bad(IOAddress("192.0.2.4"), HWAddrPtr(), ClientIdPtr(), 100,
+                   1000, 8);
+        EXPECT_THROW(journal.append(bad), BadValue);
+        EXPECT_EQ(1, journal.getWriteErrs());
+    }
+
+    // The journal is not a CSV file.
+    EXPECT_EQ(LEASE_FILE_BINARY, getLeaseFileFormat(filename_, LEASE_FILE_CSV));
+    EXPECT_EQ(0, io_.readFile().find(LeaseJournal4::MAGIC()));
+
+    LeaseJournal4 journal(filename_);
+    ASSERT_NO_THROW(journal.open());
+    for (auto const& lease : leases) {
+        Lease4Ptr read;
+        ASSERT_TRUE(journal.next(read)) << journal.getReadMsg();
+        ASSERT_TRUE(read);
+        EXPECT_TRUE(*read == *lease) << read->toText();
+        EXPECT_EQ(lease->cltt_, read->cltt_);
+    }
+    Lease4Ptr read;
+    EXPECT_TRUE(journal.next(read));
+    EXPECT_FALSE(read);
+    EXPECT_EQ(3, journal.getReadLeases());
+    EXPECT_EQ(0, journal.getReadErrs());
+}
+
+// Checks that the DHCPv6 leases are read back from the journal.
+TEST_F(LeaseJournalTest, appendAndRead6) {
+    std::vector<Lease6Ptr> leases = getLeases6();
+    {
+        LeaseJournal6 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        for (auto const& lease : leases) {
+            ASSERT_NO_THROW(journal.append(*lease));
+        }
+    }
+
+    // Reopen at the end and append an update.
+    {
+        LeaseJournal6 journal(filename_);
+        ASSERT_NO_THROW(journal.open(true));
+        Lease6Ptr update(new Lease6(*leases[0]));
+        update->valid_lft_ = 0;
+        update->updateCurrentExpirationTime();
+        ASSERT_NO_THROW(journal.append(*update));
+        leases.push_back(update);
+    }
+
+    LeaseJournal6 journal(filename_);
+    ASSERT_NO_THROW(journal.open());
+    for (auto const& lease : leases) {
+        Lease6Ptr read;
+        ASSERT_TRUE(journal.next(read)) << journal.getReadMsg();
+        ASSERT_TRUE(read);
+        EXPECT_TRUE(*read == *lease) << read->toText();
+    }
+    Lease6Ptr read;
+    EXPECT_TRUE(journal.next(read));
+    EXPECT_FALSE(read);
+
+    // The DHCPv4 journal refuses a DHCPv6 journal.
+    LeaseJournal4 journal4(filename_);
+    EXPECT_THROW(journal4.open(), CSVFileError);
+}
+
+// Checks that invalid headers are rejected.
+TEST_F(LeaseJournalTest, invalidHeader) {
+    io_.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                  "fqdn_fwd,fqdn_rev,hostname,state,user_context,pool_id\n");
+    EXPECT_EQ(LEASE_FILE_CSV, getLeaseFileFormat(filename_, LEASE_FILE_BINARY));
+    LeaseJournal4 journal(filename_);
+    EXPECT_THROW(journal.open(), CSVFileError);
+
+    // Unsupported version.
+    std::string header(LeaseJournal4::MAGIC());
+    header.push_back(4);
+    header.push_back(LeaseJournal4::FORMAT_VERSION + 1);
+    io_.writeFile(header);
+    EXPECT_THROW(journal.open(), CSVFileError);
+}
+
+// Checks that a truncated record is reported and ends the journal.
+TEST_F(LeaseJournalTest, truncated) {
+    std::vector<Lease4Ptr> leases = getLeases4();
+    {
+        LeaseJournal4 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        ASSERT_NO_THROW(journal.append(*leases[0]));
+        ASSERT_NO_THROW(journal.append(*leases[1]));
+    }
+    std::string content = io_.readFile();
+    io_.writeFile(content.substr(0, content.size() - 3));
+
+    LeaseJournal4 journal(filename_);
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr read;
+    EXPECT_TRUE(journal.next(read));
+    EXPECT_TRUE(read);
+    EXPECT_FALSE(journal.next(read));
+    EXPECT_FALSE(read);
+    EXPECT_TRUE(journal.next(read));
+    EXPECT_FALSE(read);
+    EXPECT_EQ(1, journal.getReadErrs());
+}
+
+// Checks that the truncated record left by a crash is removed when the
+// journal is loaded so the leases appended after a restart are read back.
+TEST_F(LeaseJournalTest, truncatedAppend) {
+    std::vector<Lease4Ptr> leases = getLeases4();
+    {
+        LeaseJournal4 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        ASSERT_NO_THROW(journal.append(*leases[0]));
+        ASSERT_NO_THROW(journal.append(*leases[1]));
+    }
+    // Crash in the middle of the second record.
+    std::string content = io_.readFile();
+    io_.writeFile(content.substr(0, content.size() - 3));
+
+    // Restart: load the journal and append to it as the server does.
+    {
+        LeaseJournal4 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        Lease4Ptr read;
+        EXPECT_TRUE(journal.next(read));
+        EXPECT_TRUE(read);
+        EXPECT_FALSE(journal.next(read));
+        EXPECT_TRUE(journal.next(read));
+        EXPECT_FALSE(read);
+        ASSERT_NO_THROW(journal.append(*leases[2]));
+    }
+
+    // Reload: the appended lease follows the first one.
+    LeaseJournal4 journal(filename_);
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr read;
+    ASSERT_TRUE(journal.next(read));
+    ASSERT_TRUE(read);
+    EXPECT_TRUE(*read == *leases[0]);
+    ASSERT_TRUE(journal.next(read));
+    ASSERT_TRUE(read);
+    EXPECT_TRUE(*read == *leases[2]);
+    EXPECT_TRUE(journal.next(read));
+    EXPECT_FALSE(read);
+    EXPECT_EQ(0, journal.getReadErrs());
+}
+
+// Checks that a corrupted record length in the middle of the journal
+// ends the journal without losing the records after it: they are kept
+// in a copy of the journal.
+TEST_F(LeaseJournalTest, corruptedLength) {
+    std::vector<Lease4Ptr> leases = getLeases4();
+    {
+        LeaseJournal4 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        for (auto const& lease : leases) {
+            ASSERT_NO_THROW(journal.append(*lease));
+        }
+    }
+    // Corrupt the length of the second record.
+    OutputBuffer first(0);
+    LeaseJournal4::encode(*leases[0], first);
+    size_t position = LeaseJournal4::getHeaderSize() + 4 + first.getLength();
+    std::string content = io_.readFile();
+    ASSERT_GT(content.size(), position + 4);
+    content.replace(position, 4, std::string(4, '\xff'));
+    io_.writeFile(content);
+
+    LeaseFileIO copy_io(filename_ + ".corrupted");
+    {
+        LeaseJournal4 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+        Lease4Ptr read;
+        EXPECT_TRUE(journal.next(read));
+        EXPECT_TRUE(read);
+        EXPECT_FALSE(journal.next(read));
+        EXPECT_FALSE(read);
+        EXPECT_TRUE(journal.next(read));
+        EXPECT_FALSE(read);
+        EXPECT_EQ(1, journal.getReadErrs());
+        ASSERT_NO_THROW(journal.append(*leases[2]));
+    }
+
+    // The copy holds the corrupted journal with the records after the
+    // corrupted one.
+    ASSERT_TRUE(copy_io.exists());
+    EXPECT_EQ(content, copy_io.readFile());
+
+    // The journal was truncated at the corrupted record so the lease
+    // appended after it is read back.
+    LeaseJournal4 journal(filename_);
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr read;
+    ASSERT_TRUE(journal.next(read));
+    ASSERT_TRUE(read);
+    EXPECT_TRUE(*read == *leases[0]);
+    ASSERT_TRUE(journal.next(read));
+    ASSERT_TRUE(read);
+    EXPECT_TRUE(*read == *leases[2]);
+    EXPECT_TRUE(journal.next(read));
+    EXPECT_FALSE(read);
+    EXPECT_EQ(0, journal.getReadErrs());
+}
+
+// Checks the lease file format names and the creation of lease files in
+// their format.
+TEST_F(LeaseJournalTest, format) {
+    EXPECT_EQ(LEASE_FILE_CSV, leaseFileFormatFromText("csv"));
+    EXPECT_EQ(LEASE_FILE_BINARY, leaseFileFormatFromText("binary"));
+    EXPECT_THROW(leaseFileFormatFromText("json"), BadValue);
+    EXPECT_EQ("csv", leaseFileFormatToText(LEASE_FILE_CSV));
+    EXPECT_EQ("binary", leaseFileFormatToText(LEASE_FILE_BINARY));
+
+    // A missing file has the default format.
+    io_.removeFile();
+    EXPECT_EQ(LEASE_FILE_BINARY, getLeaseFileFormat(filename_, LEASE_FILE_BINARY));
+    boost::shared_ptr<CSVLeaseFile4> file =
+        createLeaseFile<CSVLeaseFile4>(filename_, LEASE_FILE_BINARY);
+    EXPECT_TRUE(boost::dynamic_pointer_cast<LeaseJournal4>(file));
+    file = createLeaseFile<CSVLeaseFile4>(filename_, LEASE_FILE_CSV);
+    EXPECT_FALSE(boost::dynamic_pointer_cast<LeaseJournal4>(file));
+
+    // An existing file keeps its format.
+    {
+        LeaseJournal6 journal(filename_);
+        ASSERT_NO_THROW(journal.open());
+    }
+    boost::shared_ptr<CSVLeaseFile6> file6 =
+        createLeaseFile<CSVLeaseFile6>(filename_, LEASE_FILE_CSV);
+    EXPECT_TRUE(boost::dynamic_pointer_cast<LeaseJournal6>(file6));
+}
+
+// Checks the conversions between the CSV files and the journals.
+TEST_F(LeaseJournalTest, convert) {
+    csv_io_.writeFile("address,hwaddr,client_id,valid_lifetime,expire,"
+                      "subnet_id,fqdn_fwd,fqdn_rev,hostname,state,"
+                      "user_context,pool_id\n"
+                      "192.0.2.1,06:07:08:09:0a:bc,,200,200,8,1,1,"
+                      "host.example.com,0,,0\n"
+                      "192.0.2.2,bogus,,200,200,8,1,1,,0,,0\n"
+                      "192.0.2.3,,0a:00:01:04,100,100,7,0,0,,1,"
+                      "{ \"foobar\": true },5\n"
+                      "192.0.2.1,06:07:08:09:0a:bc,,0,200,8,1,1,"
+                      "host.example.com,0,,0\n");
+
+    // The invalid row is skipped.
+    EXPECT_EQ(1, (convertLeaseFile<Lease4, CSVLeaseFile4>(csv_filename_,
+                                                          filename_,
+                                                          LEASE_FILE_BINARY)));
+    EXPECT_EQ(LEASE_FILE_BINARY, getLeaseFileFormat(filename_, LEASE_FILE_CSV));
+
+    // Convert back to CSV: all the rows are kept.
+    std::string csv_copy = absolutePath("leases-copy.csv");
+    LeaseFileIO copy_io(csv_copy);
+    EXPECT_EQ(0, (convertLeaseFile<Lease4, CSVLeaseFile4>(filename_, csv_copy,
+                                                          LEASE_FILE_CSV)));
+    CSVLeaseFile4 original(csv_filename_);
+    CSVLeaseFile4 copy(csv_copy);
+    ASSERT_NO_THROW(original.open());
+    ASSERT_NO_THROW(copy.open());
+    Lease4Ptr lease;
+    Lease4Ptr copied;
+    for (;;) {
+        if (!original.next(lease)) {
+            continue;
+        }
+        ASSERT_TRUE(copy.next(copied)) << copy.getReadMsg();
+        if (!lease) {
+            EXPECT_FALSE(copied);
+            break;
+        }
+        ASSERT_TRUE(copied);
+        EXPECT_TRUE(*lease == *copied) << copied->toText();
+    }
+}
+
+// Checks that the DHCPv4 leases are read back from a lease stream.
+TEST_F(LeaseJournalTest, stream4) {
+    std::vector<Lease4Ptr> leases = getLeases4();
+    OutputBuffer stream(0);
+    writeLeaseStreamHeader(stream);
+    for (auto const& lease : leases) {
+        ASSERT_NO_THROW(writeLeaseStreamRecord(stream, *lease));
+    }
+
+    // A lease without identifier is rejected and the stream is left
+    // unchanged.
+    size_t length = stream.getLength();
+    Lease4 bad(IOAddress("192.0.2.4"), HWAddrPtr(), ClientIdPtr(), 100,
+               1000, 8);
+    EXPECT_THROW(writeLeaseStreamRecord(stream, bad), BadValue);
+    EXPECT_EQ(length, stream.getLength());
+
+    InputBuffer buffer(stream.getData(), stream.getLength());
+    ASSERT_NO_THROW(readLeaseStreamHeader(buffer));
+    for (auto const& lease : leases) {
+        Lease4Ptr read;
+        ASSERT_TRUE(readLeaseStreamRecord(buffer, read));
+        ASSERT_TRUE(read);
+        EXPECT_TRUE(*read == *lease) << read->toText();
+        EXPECT_EQ(lease->cltt_, read->cltt_);
+    }
+    Lease4Ptr read;
+    EXPECT_FALSE(readLeaseStreamRecord(buffer, read));
+    EXPECT_FALSE(read);
+}
+
+// Checks that the DHCPv6 leases are read back from a lease stream.
+TEST_F(LeaseJournalTest, stream6) {
+    std::vector<Lease6Ptr> leases = getLeases6();
+    OutputBuffer stream(0);
+    writeLeaseStreamHeader(stream);
+    for (auto const& lease : leases) {
+        ASSERT_NO_THROW(writeLeaseStreamRecord(stream, *lease));
+    }
+
+    InputBuffer buffer(stream.getData(), stream.getLength());
+    ASSERT_NO_THROW(readLeaseStreamHeader(buffer));
+    for (auto const& lease : leases) {
+        Lease6Ptr read;
+        ASSERT_TRUE(readLeaseStreamRecord(buffer, read));
+        ASSERT_TRUE(read);
+        EXPECT_TRUE(*read == *lease) << read->toText();
+    }
+    Lease6Ptr read;
+    EXPECT_FALSE(readLeaseStreamRecord(buffer, read));
+
+    // An empty stream has no leases.
+    OutputBuffer empty_stream(0);
+    writeLeaseStreamHeader(empty_stream);
+    InputBuffer empty(empty_stream.getData(), empty_stream.getLength());
+    ASSERT_NO_THROW(readLeaseStreamHeader(empty));
+    EXPECT_FALSE(readLeaseStreamRecord(empty, read));
+}
+
+// Checks that the lease streams of another version are rejected.
+TEST_F(LeaseJournalTest, streamVersion) {
+    // Missing version.
+    InputBuffer empty(0, 0);
+    EXPECT_THROW(readLeaseStreamHeader(empty), BadValue);
+
+    // Unsupported version.
+    OutputBuffer stream(0);
+    stream.writeUint8(LeaseJournal4::FORMAT_VERSION + 1);
+    ASSERT_NO_THROW(writeLeaseStreamRecord(stream, *getLeases4()[0]));
+    InputBuffer buffer(stream.getData(), stream.getLength());
+    EXPECT_THROW(readLeaseStreamHeader(buffer), BadValue);
+}
+
+// Checks that truncated lease streams are rejected.
+TEST_F(LeaseJournalTest, truncatedStream) {
+    std::vector<Lease4Ptr> leases = getLeases4();
+    OutputBuffer stream(0);
+    ASSERT_NO_THROW(writeLeaseStreamRecord(stream, *leases[0]));
+
+    // Truncated record.
+    InputBuffer buffer(stream.getData(), stream.getLength() - 1);
+    Lease4Ptr read;
+    EXPECT_THROW(readLeaseStreamRecord(buffer, read), BadValue);
+    EXPECT_FALSE(read);
+
+    // Truncated length.
+    InputBuffer length(stream.getData(), 2);
+    EXPECT_THROW(readLeaseStreamRecord(length, read), OutOfRange);
+
+    // Invalid record.
+    OutputBuffer invalid(0);
+    invalid.writeUint32(3);
+    invalid.writeUint8(192);
+    invalid.writeUint8(0);
+    invalid.writeUint8(2);
+    InputBuffer invalid_buffer(invalid.getData(), invalid.getLength());
+    EXPECT_THROW(readLeaseStreamRecord(invalid_buffer, read), OutOfRange);
+}
+
+}  // namespace
@@ -0,0 +1,127 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcpsrv/memfile_lease_arena.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+// Checks that released blocks are reused and large blocks are supported.
+TEST(LeaseBlockPoolTest, allocate) {
+    LeaseBlockPool pool;
+    EXPECT_EQ(0, pool.getBlockCount());
+    EXPECT_EQ(0, pool.getSlabBytes());
+
+    void* block1 = pool.allocate(36);
+    void* block2 = pool.allocate(36);
+    ASSERT_TRUE(block1);
+    ASSERT_TRUE(block2);
+    EXPECT_NE(block1, block2);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(block1) %
+              LeaseBlockPool::BLOCK_ALIGNMENT);
+    EXPECT_EQ(2, pool.getBlockCount());
+    EXPECT_EQ(LeaseBlockPool::SLAB_SIZE, pool.getSlabBytes());
+
+    // A released block is given back for the same size class.
+    pool.deallocate(block1, 36);
+    EXPECT_EQ(1, pool.getBlockCount());
+    EXPECT_EQ(block1, pool.allocate(33));
+
+    // Large blocks are taken from the heap.
+    void* large = pool.allocate(LeaseBlockPool::MAX_BLOCK_SIZE + 1);
+    ASSERT_TRUE(large);
+    EXPECT_EQ(3, pool.getBlockCount());
+    pool.deallocate(large, LeaseBlockPool::MAX_BLOCK_SIZE + 1);
+    pool.deallocate(block1, 33);
+    pool.deallocate(block2, 36);
+    EXPECT_EQ(0, pool.getBlockCount());
+    EXPECT_EQ(LeaseBlockPool::SLAB_SIZE, pool.getSlabBytes());
+}
+
+// Checks the compact copy of a DHCPv4 lease.
+TEST(MemfileLeaseArenaTest, copy4) {
+    LeaseBlockPool& pool = LeaseBlockPool::instance();
+    size_t blocks = pool.getBlockCount();
+    MemfileLeaseArena arena;
+    uint8_t id[] = { 1, 2, 3, 4, 5, 6 };
+    HWAddrPtr hwaddr(new HWAddr(id, sizeof(id), HTYPE_ETHER));
+    Lease4 lease(IOAddress("192.0.2.1"), hwaddr, id, sizeof(id), 3600,
+                 time(0), 1, true, false, "host.example.org");
+    lease.setContext(Element::fromJSON("{ \"foo\": \"bar\" }"));
+
+    Lease4Ptr lease_copy = arena.copy(lease);
+    ASSERT_TRUE(lease_copy);
+    EXPECT_TRUE(*lease_copy == lease);
+
+    // The identifiers are copied.
+    EXPECT_NE(lease.hwaddr_, lease_copy->hwaddr_);
+    EXPECT_NE(lease.client_id_, lease_copy->client_id_);
+
+    // The lease, the hardware address and the client identifier and their
+    // reference counters are allocated from the pool.
+    EXPECT_EQ(blocks + 6, pool.getBlockCount());
+
+    // The equal user contexts are shared.
+    Lease4 other(IOAddress("192.0.2.2"), HWAddrPtr(), ClientIdPtr(), 3600,
+                 time(0), 1);
+    other.setContext(Element::fromJSON("{ \"foo\": \"bar\" }"));
+    Lease4Ptr other_copy = arena.copy(other);
+    EXPECT_EQ(lease_copy->getContext(), other_copy->getContext());
+    EXPECT_EQ(1, arena.getInternedCount());
+
+    // The blocks are released with the copies.
+    lease_copy.reset();
+    other_copy.reset();
+    EXPECT_EQ(blocks, pool.getBlockCount());
+}
+
+// Checks the compact copy of DHCPv6 leases.
+TEST(MemfileLeaseArenaTest, copy6) {
+    MemfileLeaseArena arena;
+    DuidPtr duid(new DUID(vector<uint8_t>(8, 0x42)));
+    uint8_t mac[] = { 1, 2, 3, 4, 5, 6 };
+    HWAddrPtr hwaddr(new HWAddr(mac, sizeof(mac), HTYPE_ETHER));
+    Lease6 na(Lease::TYPE_NA, IOAddress("2001:db8::1"), duid, 1, 1800, 3600,
+              1, hwaddr);
+    Lease6 pd(Lease::TYPE_PD, IOAddress("3000::"), duid, 2, 1800, 3600,
+              1, hwaddr, 64);
+
+    Lease6Ptr na_copy = arena.copy(na);
+    Lease6Ptr pd_copy = arena.copy(pd);
+    ASSERT_TRUE(na_copy);
+    ASSERT_TRUE(pd_copy);
+    EXPECT_TRUE(*na_copy == na);
+    EXPECT_TRUE(*pd_copy == pd);
+
+    // The DUID and the hardware address of the client are shared.
+    EXPECT_NE(duid, na_copy->duid_);
+    EXPECT_EQ(na_copy->duid_, pd_copy->duid_);
+    EXPECT_EQ(na_copy->hwaddr_, pd_copy->hwaddr_);
+    EXPECT_EQ(2, arena.getInternedCount());
+
+    // A different DUID is not shared.
+    Lease6 other(Lease::TYPE_NA, IOAddress("2001:db8::2"),
+                 DuidPtr(new DUID(vector<uint8_t>(8, 0x43))), 1, 1800, 3600,
+                 1);
+    Lease6Ptr other_copy = arena.copy(other);
+    EXPECT_NE(na_copy->duid_, other_copy->duid_);
+    EXPECT_EQ(3, arena.getInternedCount());
+}
+
+}  // namespace
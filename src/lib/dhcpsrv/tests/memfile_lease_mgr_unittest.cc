@@ -34,6 +34,7 @@
 #include <fstream>
 #include <queue>
 #include <sstream>
+#include <thread>
 
 #include <unistd.h>
 
@@ -241,6 +242,30 @@ public:
         lmptr_ = &(LeaseMgrFactory::instance());
     }
 
+    /// @brief Creates instance of the backend in compact mode.
+    ///
+    /// @param u Universe (v4 or V6).
+    void startCompactBackend(Universe u) {
+        LeaseMgrFactory::create(getConfigString(u) + " compact=true");
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+
+    /// @brief Creates instance of the backend with the group-commit writer.
+    ///
+    /// @param u Universe (v4 or V6).
+    void startWriterBackend(Universe u) {
+        LeaseMgrFactory::create(getConfigString(u) + " write-queue-size=16");
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+
+    /// @brief Creates instance of the backend with the binary lease file.
+    ///
+    /// @param u Universe (v4 or V6).
+    void startBinaryBackend(Universe u) {
+        LeaseMgrFactory::create(getConfigString(u) + " format=binary");
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+
     /// @brief Runs IOService and stops after a specified time.
     ///
     /// @param ms Duration in milliseconds.
@@ -443,8 +468,18 @@ TEST_F(MemfileLeaseMgrTest, constructor) {
     pmap["max-row-errors"] = "-1";
     EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), isc::BadValue);
 
-    // Moved to the end as it can leave the timer registered.
+    // The compact parameter must be a boolean.
     pmap["max-row-errors"] = "5";
+    pmap["compact"] = "bogus";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), isc::BadValue);
+    pmap["compact"] = "true";
+
+    // The format parameter must be csv or binary.
+    pmap["format"] = "bogus";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), isc::BadValue);
+    pmap["format"] = "binary";
+
+    // Moved to the end as it can leave the timer registered.
     EXPECT_NO_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)));
 }
 
@@ -930,6 +965,104 @@ TEST_F(MemfileLeaseMgrTest, basicLease4MultiThread) {
     testBasicLease4();
 }
 
+/// @brief Basic Lease4 Checks in compact mode.
+TEST_F(MemfileLeaseMgrTest, basicLease4Compact) {
+    startCompactBackend(V4);
+    testBasicLease4();
+}
+
+/// @brief Basic Lease4 Checks with the binary lease file.
+TEST_F(MemfileLeaseMgrTest, basicLease4Binary) {
+    startBinaryBackend(V4);
+    testBasicLease4();
+}
+
+/// @brief Basic Lease4 Checks with the group-commit writer.
+TEST_F(MemfileLeaseMgrTest, basicLease4Writer) {
+    startWriterBackend(V4);
+    testBasicLease4();
+}
+
+/// @brief Basic Lease4 Checks with the group-commit writer in MT mode.
+TEST_F(MemfileLeaseMgrTest, basicLease4WriterMultiThread) {
+    startWriterBackend(V4);
+    MultiThreadingMgr::instance().setMode(true);
+    testBasicLease4();
+}
+
+/// @brief Checks that the leases written by the group-commit writer are
+/// in the lease file when the backend returns.
+TEST_F(MemfileLeaseMgrTest, writer4) {
+    LeaseMgrFactory::create(getConfigString(V4) +
+                            " write-queue-size=4 write-max-delay=1000"
+                            " write-sync=true");
+    lmptr_ = &(LeaseMgrFactory::instance());
+    MultiThreadingMgr::instance().setMode(true);
+
+    // Add leases from concurrent threads so they are grouped.
+    const size_t threads_num = 4;
+    const size_t leases_num = 25;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_num; ++i) {
+        threads.push_back(std::thread([this, i]() {
+            for (size_t j = 0; j < leases_num; ++j) {
+                uint32_t n = i * leases_num + j;
+                std::vector<uint8_t> id(6, 0);
+                id[4] = (n >> 8) & 0xff;
+                id[5] = n & 0xff;
+                HWAddrPtr hwaddr(new HWAddr(id, HTYPE_ETHER));
+                Lease4Ptr lease(new Lease4(IOAddress(0xc0000200 + n), hwaddr,
+                                           ClientIdPtr(), 3600, time(0), 1));
+                EXPECT_TRUE(lmptr_->addLease(lease));
+            }
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    // All the rows are in the file: count them.
+    std::ifstream fs(getLeaseFilePath("leasefile4_0.csv").c_str());
+    ASSERT_TRUE(fs.is_open());
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(fs, line)) {
+        ++lines;
+    }
+    EXPECT_EQ(threads_num * leases_num + 1, lines);
+
+    // Deletes and updates are written too and the leases are reloaded.
+    Lease4Ptr lease = lmptr_->getLease4(IOAddress("192.0.2.0"));
+    ASSERT_TRUE(lease);
+    lease->hostname_ = "myhost.example.org";
+    EXPECT_NO_THROW(lmptr_->updateLease4(lease));
+    lease = lmptr_->getLease4(IOAddress("192.0.2.1"));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(lmptr_->deleteLease(lease));
+    MultiThreadingMgr::instance().setMode(false);
+
+    startBackend(V4);
+    lease = lmptr_->getLease4(IOAddress("192.0.2.0"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("myhost.example.org", lease->hostname_);
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.1")));
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.99")));
+}
+
+/// @brief Checks that invalid parameters of the group-commit writer are
+/// rejected.
+TEST_F(MemfileLeaseMgrTest, writerInvalidParameters) {
+    EXPECT_THROW(LeaseMgrFactory::create(getConfigString(V4) +
+                                         " write-queue-size=bogus"),
+                 isc::BadValue);
+    EXPECT_THROW(LeaseMgrFactory::create(getConfigString(V4) +
+                                         " write-max-delay=1ms"),
+                 isc::BadValue);
+    EXPECT_THROW(LeaseMgrFactory::create(getConfigString(V4) +
+                                         " write-sync=bogus"),
+                 isc::BadValue);
+}
+
 /// @todo Write more memfile tests
 
 /// @brief Simple test about lease4 retrieval through client id method
@@ -1218,6 +1351,18 @@ TEST_F(MemfileLeaseMgrTest, basicLease6MultiThread) {
     testBasicLease6();
 }
 
+/// @brief Basic Lease6 Checks in compact mode.
+TEST_F(MemfileLeaseMgrTest, basicLease6Compact) {
+    startCompactBackend(V6);
+    testBasicLease6();
+}
+
+/// @brief Basic Lease6 Checks with the binary lease file.
+TEST_F(MemfileLeaseMgrTest, basicLease6Binary) {
+    startBinaryBackend(V6);
+    testBasicLease6();
+}
+
 /// @brief Check GetLease6 methods - access by DUID/IAID
 ///
 /// Adds leases to the database and checks that they can be accessed via
@@ -1236,6 +1381,12 @@ TEST_F(MemfileLeaseMgrTest, getLeases6DuidIaidMultiThread) {
     testGetLeases6DuidIaid();
 }
 
+/// @brief Check GetLease6 methods - access by DUID/IAID in compact mode
+TEST_F(MemfileLeaseMgrTest, getLeases6DuidIaidCompact) {
+    startCompactBackend(V6);
+    testGetLeases6DuidIaid();
+}
+
 /// @brief Check that the system can cope with a DUID of allowed size.
 TEST_F(MemfileLeaseMgrTest, getLeases6DuidSize) {
     startBackend(V6);
@@ -1622,6 +1773,84 @@ TEST_F(MemfileLeaseMgrTest, load4CompletedFile) {
     EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.1")));
 }
 
+/// @brief This test checks that the backend in compact mode stores compact
+/// copies of the leases loaded from the lease file.
+TEST_F(MemfileLeaseMgrTest, load4Compact) {
+    LeaseFileIO io(getLeaseFilePath("leasefile4_0.csv"));
+    io.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                 "fqdn_fwd,fqdn_rev,hostname,state,user_context,pool_id\n"
+                 "192.0.2.10,0a:0a:0a:0a:0a:0a,01:02,200,200,8,1,1,,1,"
+                 "{ \"foo\": true },0\n"
+                 "192.0.2.12,cc:cc:cc:cc:cc:cc,,200,400,8,1,1,,1,"
+                 "{ \"foo\": true },0\n");
+
+    size_t blocks = LeaseBlockPool::instance().getBlockCount();
+    startCompactBackend(V4);
+
+    // The leases, their hardware addresses and client identifier are in
+    // the pool.
+    EXPECT_LT(blocks, LeaseBlockPool::instance().getBlockCount());
+
+    Lease4Ptr lease10 = lmptr_->getLease4(IOAddress("192.0.2.10"));
+    ASSERT_TRUE(lease10);
+    EXPECT_EQ(0, lease10->cltt_);
+    ASSERT_TRUE(lease10->client_id_);
+    EXPECT_EQ("01:02", lease10->client_id_->toText());
+
+    Lease4Ptr lease12 = lmptr_->getLease4(IOAddress("192.0.2.12"));
+    ASSERT_TRUE(lease12);
+    EXPECT_EQ(200, lease12->cltt_);
+
+    // The equal user contexts are shared.
+    ASSERT_TRUE(lease10->getContext());
+    EXPECT_EQ(lease10->getContext(), lease12->getContext());
+
+    // Updates are stored as compact copies too.
+    lease10->hostname_ = "myhost.example.org";
+    EXPECT_NO_THROW(lmptr_->updateLease4(lease10));
+    Lease4Ptr updated = lmptr_->getLease4(IOAddress("192.0.2.10"));
+    ASSERT_TRUE(updated);
+    EXPECT_EQ("myhost.example.org", updated->hostname_);
+    EXPECT_EQ(lease12->getContext(), updated->getContext());
+}
+
+/// @brief Checks that the lease file is converted to the selected format
+/// when the leases are loaded.
+TEST_F(MemfileLeaseMgrTest, load4ConvertFormat) {
+    std::string lease_file = getLeaseFilePath("leasefile4_0.csv");
+    LeaseFileIO io(lease_file);
+    io.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                 "fqdn_fwd,fqdn_rev,hostname,state,user_context,pool_id\n"
+                 "192.0.2.10,0a:0a:0a:0a:0a:0a,01:02,200,200,8,1,1,,1,"
+                 "{ \"foo\": true },0\n"
+                 "192.0.2.12,cc:cc:cc:cc:cc:cc,,200,400,8,1,1,,1,,0\n"
+                 "192.0.2.12,cc:cc:cc:cc:cc:cc,,0,400,8,1,1,,1,,0\n");
+
+    // The CSV file is converted to the binary format.
+    startBinaryBackend(V4);
+    EXPECT_EQ(LEASE_FILE_BINARY,
+              getLeaseFileFormat(lease_file, LEASE_FILE_CSV));
+    Lease4Ptr lease = lmptr_->getLease4(IOAddress("192.0.2.10"));
+    ASSERT_TRUE(lease);
+    ASSERT_TRUE(lease->getContext());
+    EXPECT_EQ("{ \"foo\": true }", lease->getContext()->str());
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.12")));
+
+    // The new leases are appended in the binary format.
+    HWAddrPtr hwaddr(new HWAddr(HWAddr::fromText("aa:bb:cc:dd:ee:ff")));
+    lease.reset(new Lease4(IOAddress("192.0.2.11"), hwaddr, ClientIdPtr(),
+                           300, time(0), 8));
+    EXPECT_TRUE(lmptr_->addLease(lease));
+
+    // Back to the CSV format.
+    startBackend(V4);
+    EXPECT_EQ(LEASE_FILE_CSV,
+              getLeaseFileFormat(lease_file, LEASE_FILE_BINARY));
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.10")));
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.11")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.12")));
+}
+
 /// @brief This test checks that backend constructor refuses to load leases from the
 /// lease files if the LFC is in progress.
 TEST_F(MemfileLeaseMgrTest, load4LFCInProgress) {
@@ -0,0 +1,135 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_space.h>
+#include <dhcp/option_string.h>
+#include <dhcpsrv/option_block_cache.h>
+
+#include <boost/weak_ptr.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::dhcp;
+using namespace std;
+
+namespace {
+
+/// @brief Returns a configured option list with a string option.
+///
+/// @param code the option code.
+/// @param value the option value.
+/// @return the configured option list.
+CfgOptionList makeCfgOptionList(uint16_t code, const string& value) {
+    CfgOptionPtr cfg(new CfgOption());
+    OptionPtr option(new OptionString(Option::V4, code, value));
+    cfg->add(option, false, false, DHCP4_OPTION_SPACE);
+    CfgOptionList co_list;
+    co_list.push_back(cfg);
+    return (co_list);
+}
+
+// Checks the keys of the option blocks.
+TEST(OptionBlockCacheTest, makeKey) {
+    CfgOptionList co_list1 = makeCfgOptionList(DHO_DOMAIN_NAME, "example.org");
+    CfgOptionList co_list2 = makeCfgOptionList(DHO_DOMAIN_NAME, "example.org");
+    ClientClasses classes1("foo, bar");
+    ClientClasses classes2("foo");
+    ClientClasses classes3("foobar");
+    OptionBuffer requested1 = { DHO_ROUTERS, DHO_DOMAIN_NAME };
+    OptionBuffer requested2 = { DHO_DOMAIN_NAME, DHO_ROUTERS };
+
+    string key = OptionBlockCache::makeKey(co_list1, classes1, requested1);
+    EXPECT_EQ(key, OptionBlockCache::makeKey(co_list1, classes1, requested1));
+
+    // All the parts of the key matter.
+    EXPECT_NE(key, OptionBlockCache::makeKey(co_list2, classes1, requested1));
+    EXPECT_NE(key, OptionBlockCache::makeKey(co_list1, classes2, requested1));
+    EXPECT_NE(key, OptionBlockCache::makeKey(co_list1, classes1, requested2));
+    EXPECT_NE(key, OptionBlockCache::makeKey(co_list1, classes1, OptionBuffer()));
+
+    // The class names are delimited.
+    EXPECT_NE(OptionBlockCache::makeKey(co_list1, classes3, requested1),
+              OptionBlockCache::makeKey(co_list1, ClientClasses("foo, bar"),
+                                        requested1));
+}
+
+// Checks the on-wire format of the options.
+TEST(OptionBlockCacheTest, makePackedOption) {
+    OptionPtr option(new OptionString(Option::V4, DHO_DOMAIN_NAME, "foo"));
+    PackedOption packed = OptionBlockCache::makePackedOption(option);
+    EXPECT_EQ(option, packed.option_);
+    OptionBuffer expected = { DHO_DOMAIN_NAME, 3, 'f', 'o', 'o' };
+    EXPECT_EQ(expected, packed.wire_);
+
+    // Options which can't be packed have no on-wire format.
+    option.reset(new OptionString(Option::V4, DHO_DOMAIN_NAME, string(300, 'x')));
+    packed = OptionBlockCache::makePackedOption(option);
+    EXPECT_EQ(option, packed.option_);
+    EXPECT_TRUE(packed.wire_.empty());
+}
+
+// Checks the cache operations.
+TEST(OptionBlockCacheTest, cache) {
+    OptionBlockCache cache;
+    CfgOptionList co_list = makeCfgOptionList(DHO_DOMAIN_NAME, "example.org");
+    string key = OptionBlockCache::makeKey(co_list, ClientClasses(), OptionBuffer());
+    EXPECT_FALSE(cache.get(key));
+    EXPECT_EQ(0, cache.size());
+
+    boost::shared_ptr<OptionBlock> block(new OptionBlock());
+    block->requested_.set(DHO_DOMAIN_NAME);
+    cache.add(key, co_list, block);
+    EXPECT_EQ(1, cache.size());
+    ConstOptionBlockPtr cached = cache.get(key);
+    EXPECT_EQ(block, cached);
+
+    // The entry keeps the configured options.
+    boost::weak_ptr<const CfgOption> cfg(co_list.front());
+    co_list.clear();
+    EXPECT_FALSE(cfg.expired());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_FALSE(cache.get(key));
+    EXPECT_TRUE(cfg.expired());
+}
+
+// Checks that an added key replaces the entry.
+TEST(OptionBlockCacheTest, replace) {
+    OptionBlockCache cache;
+    CfgOptionList co_list = makeCfgOptionList(DHO_DOMAIN_NAME, "example.org");
+    ConstOptionBlockPtr block1(new OptionBlock());
+    ConstOptionBlockPtr block2(new OptionBlock());
+    cache.add("key", co_list, block1);
+    cache.add("key", co_list, block2);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(block2, cache.get("key"));
+}
+
+// Checks that the least recently used entries are removed when the cache
+// is full.
+TEST(OptionBlockCacheTest, maxEntries) {
+    OptionBlockCache cache;
+    CfgOptionList co_list;
+    ConstOptionBlockPtr block(new OptionBlock());
+    cache.add("hot", co_list, block);
+    cache.add("cold", co_list, block);
+    for (size_t i = 0; i < 4 * OptionBlockCache::MAX_ENTRIES; ++i) {
+        ASSERT_TRUE(cache.get("hot"));
+        cache.add(to_string(i), co_list, block);
+        ASSERT_LE(cache.size(), OptionBlockCache::MAX_ENTRIES);
+    }
+    EXPECT_TRUE(cache.get("hot"));
+    EXPECT_FALSE(cache.get("cold"));
+    EXPECT_FALSE(cache.get("0"));
+    EXPECT_TRUE(cache.get(to_string(4 * OptionBlockCache::MAX_ENTRIES - 1)));
+    // The shards are full.
+    EXPECT_GT(cache.size(), OptionBlockCache::MAX_ENTRIES / 2);
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,148 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/subnet_selection_index.h>
+
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Subnets of the tests are named.
+typedef boost::shared_ptr<std::string> NamePtr;
+
+/// @brief Index of named subnets.
+typedef SubnetSelectionIndex<NamePtr> NameIndex;
+
+/// @brief Predicate accepting all the subnets.
+bool
+any(const NamePtr&) {
+    return (true);
+}
+
+// Checks the masking of the addresses.
+TEST(SubnetSelectionKeyTest, mask) {
+    EXPECT_TRUE(SubnetSelectionKey(IOAddress("192.0.2.1"), 24) ==
+                SubnetSelectionKey(IOAddress("192.0.2.255"), 24));
+    EXPECT_FALSE(SubnetSelectionKey(IOAddress("192.0.2.1"), 24) ==
+                 SubnetSelectionKey(IOAddress("192.0.3.1"), 24));
+    EXPECT_TRUE(SubnetSelectionKey(IOAddress("192.0.2.1"), 0) ==
+                SubnetSelectionKey(IOAddress("10.0.0.1"), 0));
+    EXPECT_FALSE(SubnetSelectionKey(IOAddress("192.0.2.1"), 32) ==
+                 SubnetSelectionKey(IOAddress("192.0.2.2"), 32));
+    EXPECT_TRUE(SubnetSelectionKey(IOAddress("2001:db8:1::1"), 48) ==
+                SubnetSelectionKey(IOAddress("2001:db8:1:ffff::1"), 48));
+    EXPECT_FALSE(SubnetSelectionKey(IOAddress("2001:db8:1::1"), 48) ==
+                 SubnetSelectionKey(IOAddress("2001:db8:2::1"), 48));
+    EXPECT_TRUE(SubnetSelectionKey(IOAddress("2001:db8::1:0"), 112) ==
+                SubnetSelectionKey(IOAddress("2001:db8::1:ff"), 112));
+    EXPECT_FALSE(SubnetSelectionKey(IOAddress("2001:db8::1:0"), 112) ==
+                 SubnetSelectionKey(IOAddress("2001:db8::2:0"), 112));
+    EXPECT_FALSE(SubnetSelectionKey(IOAddress("2001:db8::1"), 128) ==
+                 SubnetSelectionKey(IOAddress("2001:db8::2"), 128));
+    // An IPv4 address does not match an IPv6 address.
+    EXPECT_FALSE(SubnetSelectionKey(IOAddress("0.0.0.0"), 0) ==
+                 SubnetSelectionKey(IOAddress("::"), 0));
+}
+
+// Checks that the subnet with the lowest position including an address
+// is selected.
+TEST(SubnetSelectionIndexTest, prefix) {
+    NameIndex index;
+    NamePtr s8(new std::string("10/8"));
+    NamePtr s16(new std::string("10.1/16"));
+    NamePtr s24(new std::string("10.1.2/24"));
+    index.addPrefix(IOAddress("10.1.2.0"), 24, 0, s24);
+    index.addPrefix(IOAddress("10.0.0.0"), 8, 1, s8);
+    index.addPrefix(IOAddress("10.1.0.0"), 16, 2, s16);
+    EXPECT_EQ(3, index.getPrefixTableCount());
+
+    EXPECT_EQ(s24, index.selectByPrefix(IOAddress("10.1.2.3"), any));
+    EXPECT_EQ(s8, index.selectByPrefix(IOAddress("10.1.3.3"), any));
+    EXPECT_EQ(s8, index.selectByPrefix(IOAddress("10.2.3.3"), any));
+    EXPECT_FALSE(index.selectByPrefix(IOAddress("11.0.0.1"), any));
+    EXPECT_FALSE(index.selectByPrefix(IOAddress("2001:db8::1"), any));
+
+    // The predicate is checked.
+    auto not24 = [&s24](const NamePtr& subnet) {
+        return (subnet != s24);
+    };
+    EXPECT_EQ(s8, index.selectByPrefix(IOAddress("10.1.2.3"), not24));
+
+    // All the including subnets in position order.
+    NameIndex::Entries entries = index.getByPrefix(IOAddress("10.1.2.3"));
+    ASSERT_EQ(3, entries.size());
+    EXPECT_EQ(s24, entries[0].subnet_);
+    EXPECT_EQ(s8, entries[1].subnet_);
+    EXPECT_EQ(s16, entries[2].subnet_);
+}
+
+// Checks the selection by relay address, interface name and key.
+TEST(SubnetSelectionIndexTest, others) {
+    NameIndex index;
+    NamePtr s1(new std::string("s1"));
+    NamePtr s2(new std::string("s2"));
+    index.addRelay(IOAddress("2001:db8::1"), 0, s1);
+    index.addRelay(IOAddress("2001:db8::1"), 1, s2);
+    index.addIface("eth0", 1, s2);
+    index.addKey({ 1, 2, 3 }, 0, s1);
+
+    auto not1 = [&s1](const NamePtr& subnet) {
+        return (subnet != s1);
+    };
+    EXPECT_EQ(s1, index.selectByRelay(IOAddress("2001:db8::1"), any));
+    EXPECT_EQ(s2, index.selectByRelay(IOAddress("2001:db8::1"), not1));
+    EXPECT_FALSE(index.selectByRelay(IOAddress("2001:db8::2"), any));
+    EXPECT_EQ(s2, index.selectByIface("eth0", any));
+    EXPECT_FALSE(index.selectByIface("eth1", any));
+    EXPECT_EQ(s1, index.selectByKey({ 1, 2, 3 }, any));
+    EXPECT_FALSE(index.selectByKey({ 1, 2, 3 }, not1));
+    EXPECT_FALSE(index.selectByKey({ 1, 2 }, any));
+}
+
+// Checks that the found entries hold the position of the subnets.
+TEST(SubnetSelectionIndexTest, find) {
+    NameIndex index;
+    NamePtr s1(new std::string("s1"));
+    NamePtr s2(new std::string("s2"));
+    index.addPrefix(IOAddress("2001:db8::"), 32, 3, s1);
+    index.addPrefix(IOAddress("2001:db8:1::"), 48, 5, s2);
+    index.addIface("eth0", 4, s2);
+    index.addKey({ 1, 2, 3 }, 2, s1);
+
+    auto entry = index.findByPrefix(IOAddress("2001:db8:1::1"), any);
+    EXPECT_EQ(3, entry.position_);
+    EXPECT_EQ(s1, entry.subnet_);
+    entry = index.findByIface("eth0", any);
+    EXPECT_EQ(4, entry.position_);
+    EXPECT_EQ(s2, entry.subnet_);
+    entry = index.findByKey({ 1, 2, 3 }, any);
+    EXPECT_EQ(2, entry.position_);
+    EXPECT_EQ(s1, entry.subnet_);
+
+    // Failed searches return the largest position.
+    entry = index.findByPrefix(IOAddress("2001:db9::1"), any);
+    EXPECT_EQ(std::numeric_limits<size_t>::max(), entry.position_);
+    EXPECT_FALSE(entry.subnet_);
+    entry = index.findByIface("eth1", any);
+    EXPECT_EQ(std::numeric_limits<size_t>::max(), entry.position_);
+    EXPECT_FALSE(entry.subnet_);
+    entry = index.findByKey({ 1, 2 }, any);
+    EXPECT_EQ(std::numeric_limits<size_t>::max(), entry.position_);
+    EXPECT_FALSE(entry.subnet_);
+}
+
+}  // namespace
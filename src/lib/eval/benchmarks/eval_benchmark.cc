@@ -0,0 +1,132 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/hwaddr.h>
+#include <dhcp/option_string.h>
+#include <dhcp/pkt4.h>
+#include <eval/compiled_expression.h>
+#include <eval/eval_context.h>
+#include <eval/evaluate.h>
+#include <util/benchmarks/micro_benchmark.h>
+
+#include <boost/make_shared.hpp>
+
+#include <vector>
+
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the microbenchmarks of the libkea-eval expression
+/// evaluation, interpreted by @c evaluateBool and compiled by
+/// @c CompiledExpression.
+
+namespace {
+
+/// @brief The number of generated packets.
+const size_t PACKETS = 1000;
+
+/// @brief The benchmarked expressions with their names.
+const pair<const char*, const char*> EXPRESSIONS[] = {
+    { "option-exists", "option[60].exists" },
+    { "substring", "substring(option[60].text, 0, 4) == 'MSFT'" },
+    { "mac-byte", "substring(pkt4.mac, 5, 1) == 0x2a" },
+    { "relay-circuit-id", "relay4[1].hex == 0x000102030405" },
+    { "member", "member('KNOWN') and not member('foo')" },
+    { "msgtype", "pkt4.msgtype == 1 or pkt4.msgtype == 3" },
+    { "boolean", "(option[60].text == 'MSFT 5.0' or option[12].exists)"
+      " and pkt4.giaddr == 10.0.0.1" }
+};
+
+/// @brief Returns relayed DHCPv4 queries.
+///
+/// Half of the queries are sent by a Windows client and half of them
+/// are in the KNOWN class.
+///
+/// @param gen the data generator.
+/// @return the queries.
+vector<Pkt4Ptr>
+makePackets(DataGenerator& gen) {
+    vector<Pkt4Ptr> packets;
+    for (size_t i = 0; i < PACKETS; ++i) {
+        Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, i + 1));
+        pkt->setHWAddr(HWAddrPtr(new HWAddr(gen.bytes(6), HTYPE_ETHER)));
+        pkt->setGiaddr(asiolink::IOAddress("10.0.0.1"));
+        pkt->setHops(1);
+        if (gen.uniform(0, 1)) {
+            pkt->addClass("KNOWN");
+        }
+        pkt->addOption(OptionPtr(new OptionString(Option::V4,
+                                                  DHO_VENDOR_CLASS_IDENTIFIER,
+                                                  gen.uniform(0, 1) ? "MSFT 5.0" :
+                                                  "udhcp 1.36.1")));
+        pkt->addOption(OptionPtr(new OptionString(Option::V4, DHO_HOST_NAME,
+                                                  gen.name(12))));
+        OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+        rai->addOption(OptionPtr(new Option(Option::V4, RAI_OPTION_AGENT_CIRCUIT_ID,
+                                            gen.bytes(6))));
+        pkt->addOption(rai);
+        packets.push_back(pkt);
+    }
+    return (packets);
+}
+
+/// @brief Parses an expression.
+///
+/// @param text the expression.
+/// @return the expression.
+Expression
+parse(const string& text) {
+    EvalContext eval(Option::V4);
+    eval.parseString(text, EvalContext::PARSER_BOOL);
+    return (eval.expression_);
+}
+
+/// @brief Adds the cases of the expression evaluation.
+///
+/// @param bench the benchmark.
+void
+addEvaluateCases(MicroBenchmark& bench) {
+    for (auto const& expression : EXPRESSIONS) {
+        string text = expression.second;
+        bench.add(string("evaluateBool/") + expression.first,
+                  [text](DataGenerator& gen) {
+            auto packets = boost::make_shared<vector<Pkt4Ptr>>(makePackets(gen));
+            auto expr = boost::make_shared<Expression>(parse(text));
+            size_t i = 0;
+            return ([packets, expr, i]() mutable {
+                MicroBenchmark::keep(evaluateBool(*expr, *(*packets)[i++ % PACKETS]));
+            });
+        });
+
+        bench.add(string("CompiledExpression/") + expression.first,
+                  [text](DataGenerator& gen) {
+            auto packets = boost::make_shared<vector<Pkt4Ptr>>(makePackets(gen));
+            CompiledExpressionPtr compiled = CompiledExpression::compile(parse(text));
+            if (!compiled) {
+                isc_throw(Unexpected, "can't compile '" << text << "'");
+            }
+            size_t i = 0;
+            return ([packets, compiled, i]() mutable {
+                MicroBenchmark::keep(compiled->evaluateBool(*(*packets)[i++ % PACKETS]));
+            });
+        });
+    }
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    MicroBenchmark bench("libkea-eval");
+    addEvaluateCases(bench);
+    return (bench.run(argc, argv));
+}
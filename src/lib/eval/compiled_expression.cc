@@ -0,0 +1,619 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <eval/compiled_expression.h>
+#include <eval/eval_log.h>
+#include <eval/evaluate.h>
+#include <eval/extraction_cache.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/pkt6.h>
+
+#include <cstring>
+#include <map>
+#include <typeinfo>
+
+using namespace std;
+
+namespace {
+
+using namespace isc::dhcp;
+
+/// @brief Returns the number of values a token called through the
+/// @c Token::evaluate method pops from the stack.
+///
+/// All these tokens push exactly one value.
+///
+/// @param token the token.
+/// @return the number of popped values or -1 for an unknown token.
+int
+getCallPops(const Token* token) {
+    if (dynamic_cast<const TokenOption*>(token) ||
+        dynamic_cast<const TokenPkt*>(token) ||
+        dynamic_cast<const TokenPkt4*>(token) ||
+        dynamic_cast<const TokenPkt6*>(token) ||
+        dynamic_cast<const TokenRelay6Field*>(token)) {
+        return (0);
+    }
+    if (dynamic_cast<const TokenLowerCase*>(token) ||
+        dynamic_cast<const TokenUpperCase*>(token) ||
+        dynamic_cast<const TokenIpAddressToText*>(token) ||
+        dynamic_cast<const TokenInt8ToText*>(token) ||
+        dynamic_cast<const TokenInt16ToText*>(token) ||
+        dynamic_cast<const TokenInt32ToText*>(token) ||
+        dynamic_cast<const TokenUInt8ToText*>(token) ||
+        dynamic_cast<const TokenUInt16ToText*>(token) ||
+        dynamic_cast<const TokenUInt32ToText*>(token) ||
+        dynamic_cast<const TokenMatch*>(token)) {
+        return (1);
+    }
+    if (dynamic_cast<const TokenConcat*>(token) ||
+        dynamic_cast<const TokenToHexString*>(token)) {
+        return (2);
+    }
+    if (dynamic_cast<const TokenSubstring*>(token) ||
+        dynamic_cast<const TokenSplit*>(token) ||
+        dynamic_cast<const TokenIfElse*>(token)) {
+        return (3);
+    }
+    return (-1);
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const size_t CompiledExpression::MAX_DEPTH;
+
+/// @brief A typed value on the stack.
+///
+/// The constant strings are referenced, not copied. The integers are
+/// 4 octet strings in network order and the booleans are the "true" and
+/// "false" strings when they are converted to strings.
+struct CompiledExpression::Slot {
+    /// @brief Value types.
+    enum Type : uint8_t {
+        STRING,
+        CONSTANT,
+        INTEGER,
+        BOOLEAN
+    };
+
+    /// @brief Constructor.
+    Slot() : type_(BOOLEAN), boolean_(false), integer_(0), constant_(0),
+             string_() {
+    }
+
+    /// @brief Sets a string.
+    ///
+    /// @param value the string.
+    void setString(string&& value) {
+        type_ = STRING;
+        string_ = std::move(value);
+    }
+
+    /// @brief Sets a constant string.
+    ///
+    /// @param value the constant string.
+    void setConstant(const string* value) {
+        type_ = CONSTANT;
+        constant_ = value;
+    }
+
+    /// @brief Sets an integer.
+    ///
+    /// @param value the integer.
+    void setInteger(uint32_t value) {
+        type_ = INTEGER;
+        integer_ = value;
+    }
+
+    /// @brief Sets a boolean.
+    ///
+    /// @param value the boolean.
+    void setBoolean(bool value) {
+        type_ = BOOLEAN;
+        boolean_ = value;
+    }
+
+    /// @brief Returns the value as a string.
+    ///
+    /// @param buffer a 4 octet buffer used for integers.
+    /// @param [out] size the size of the string.
+    /// @return the string data.
+    const char* getData(char* buffer, size_t& size) const {
+        switch (type_) {
+        case STRING:
+            size = string_.size();
+            return (string_.data());
+        case CONSTANT:
+            size = constant_->size();
+            return (constant_->data());
+        case INTEGER:
+            buffer[0] = (integer_ >> 24) & 0xff;
+            buffer[1] = (integer_ >> 16) & 0xff;
+            buffer[2] = (integer_ >> 8) & 0xff;
+            buffer[3] = integer_ & 0xff;
+            size = 4;
+            return (buffer);
+        default:
+            if (boolean_) {
+                size = 4;
+                return ("true");
+            }
+            size = 5;
+            return ("false");
+        }
+    }
+
+    /// @brief Returns the value as a string.
+    ///
+    /// @return the string.
+    string toString() const {
+        char buffer[4];
+        size_t size;
+        const char* data = getData(buffer, size);
+        return (string(data, size));
+    }
+
+    /// @brief Returns the value as a boolean.
+    ///
+    /// @return the boolean.
+    /// @throw EvalTypeError when the value is not "true" or "false".
+    bool toBool() const {
+        if (type_ == BOOLEAN) {
+            return (boolean_);
+        }
+        return (Token::toBool(toString()));
+    }
+
+    /// @brief Compares two values.
+    ///
+    /// @param other the other value.
+    /// @return true if the string representations are equal.
+    bool equals(const Slot& other) const {
+        if ((type_ == INTEGER) && (other.type_ == INTEGER)) {
+            return (integer_ == other.integer_);
+        }
+        if ((type_ == BOOLEAN) && (other.type_ == BOOLEAN)) {
+            return (boolean_ == other.boolean_);
+        }
+        char buffer[4];
+        size_t size;
+        const char* data = getData(buffer, size);
+        char other_buffer[4];
+        size_t other_size;
+        const char* other_data = other.getData(other_buffer, other_size);
+        return ((size == other_size) &&
+                ((size == 0) || (memcmp(data, other_data, size) == 0)));
+    }
+
+    /// @brief The value type.
+    Type type_;
+
+    /// @brief The boolean value.
+    bool boolean_;
+
+    /// @brief The integer value.
+    uint32_t integer_;
+
+    /// @brief The constant string value.
+    const string* constant_;
+
+    /// @brief The string value.
+    string string_;
+};
+
+CompiledExpression::CompiledExpression(const Expression& expr)
+    : code_(), strings_(), calls_(), expr_(expr) {
+}
+
+CompiledExpressionPtr
+CompiledExpression::compile(const Expression& expr) {
+    CompiledExpressionPtr compiled(new CompiledExpression(expr));
+    auto& code = compiled->code_;
+    auto& strings = compiled->strings_;
+    // Indexes of the branches waiting for their label.
+    map<unsigned, vector<size_t>> pending;
+    // Depth of the stack at the label.
+    map<unsigned, size_t> depths;
+    size_t depth = 0;
+    size_t max_depth = 0;
+    bool reachable = true;
+    size_t barrier = 0;
+    for (auto const& token : expr) {
+        Token* raw = token.get();
+        if (!raw) {
+            return (CompiledExpressionPtr());
+        }
+
+        // Labels are resolved and removed.
+        auto label = dynamic_cast<TokenLabel*>(raw);
+        if (label) {
+            auto it = pending.find(label->getLabel());
+            if (it == pending.end()) {
+                // No branch to this label.
+                if (!reachable) {
+                    return (CompiledExpressionPtr());
+                }
+                continue;
+            }
+            size_t target = code.size();
+            for (auto index : it->second) {
+                code[index].arg_ = static_cast<uint32_t>(target);
+            }
+            pending.erase(it);
+            auto const& label_depth = depths[label->getLabel()];
+            if (!reachable) {
+                depth = label_depth;
+                reachable = true;
+            } else if (depth != label_depth) {
+                return (CompiledExpressionPtr());
+            }
+            depths.erase(label->getLabel());
+            // Do not fold instructions across a jump target.
+            barrier = target;
+            continue;
+        }
+        if (!reachable) {
+            return (CompiledExpressionPtr());
+        }
+
+        // Branches.
+        auto branch = dynamic_cast<TokenBranch*>(raw);
+        if (branch) {
+            Opcode op;
+            size_t target_depth = depth;
+            if (dynamic_cast<TokenPopOrBranchTrue*>(raw)) {
+                op = POP_OR_BRANCH_TRUE;
+            } else if (dynamic_cast<TokenPopOrBranchFalse*>(raw)) {
+                op = POP_OR_BRANCH_FALSE;
+            } else if (dynamic_cast<TokenPopAndBranchFalse*>(raw)) {
+                op = POP_AND_BRANCH_FALSE;
+                --target_depth;
+            } else {
+                op = BRANCH;
+                reachable = false;
+            }
+            if (op != BRANCH) {
+                if (depth < 1) {
+                    return (CompiledExpressionPtr());
+                }
+                --depth;
+                // A constant boolean which does not branch is simply popped.
+                if ((op != POP_AND_BRANCH_FALSE) && (code.size() > barrier) &&
+                    (code.back().op_ == PUSH_BOOLEAN) &&
+                    ((code.back().arg_ != 0) == (op == POP_OR_BRANCH_FALSE))) {
+                    code.pop_back();
+                    continue;
+                }
+            }
+            auto d = depths.find(branch->getTarget());
+            if ((d != depths.end()) && (d->second != target_depth)) {
+                return (CompiledExpressionPtr());
+            }
+            depths[branch->getTarget()] = target_depth;
+            pending[branch->getTarget()].push_back(code.size());
+            code.push_back(Instruction(op));
+            continue;
+        }
+
+        // Other tokens push exactly one value.
+        Instruction instruction(CALL);
+        size_t pops = 0;
+        if (auto integer = dynamic_cast<TokenInteger*>(raw)) {
+            instruction = Instruction(PUSH_INTEGER, integer->getInteger());
+        } else if (auto str = dynamic_cast<TokenString*>(raw)) {
+            strings.push_back(str->getValue());
+            instruction = Instruction(PUSH_STRING, strings.size() - 1);
+        } else if (auto hex = dynamic_cast<TokenHexString*>(raw)) {
+            strings.push_back(hex->getValue());
+            instruction = Instruction(PUSH_STRING, strings.size() - 1);
+        } else if (auto addr = dynamic_cast<TokenIpAddress*>(raw)) {
+            strings.push_back(addr->getValue());
+            instruction = Instruction(PUSH_STRING, strings.size() - 1);
+        } else if (typeid(*raw) == typeid(TokenOption)) {
+            // Only the base option token: the derived tokens look for
+            // the option elsewhere.
+            auto option = dynamic_cast<TokenOption*>(raw);
+            Opcode op = OPTION_EXISTS;
+            if (option->getRepresentation() == TokenOption::TEXTUAL) {
+                op = OPTION_TEXT;
+            } else if (option->getRepresentation() == TokenOption::HEXADECIMAL) {
+                op = OPTION_HEX;
+            }
+            instruction = Instruction(op, option->getCode());
+        } else if (auto member = dynamic_cast<TokenMember*>(raw)) {
+            strings.push_back(member->getClientClass());
+            instruction = Instruction(MEMBER, strings.size() - 1);
+        } else if (auto pkt4 = dynamic_cast<TokenPkt4*>(raw)) {
+            if (pkt4->getType() == TokenPkt4::MSGTYPE) {
+                instruction = Instruction(PKT4_MSGTYPE);
+            } else if (pkt4->getType() == TokenPkt4::TRANSID) {
+                instruction = Instruction(PKT4_TRANSID);
+            }
+        } else if (auto pkt6 = dynamic_cast<TokenPkt6*>(raw)) {
+            if (pkt6->getType() == TokenPkt6::MSGTYPE) {
+                instruction = Instruction(PKT6_MSGTYPE);
+            } else if (pkt6->getType() == TokenPkt6::TRANSID) {
+                instruction = Instruction(PKT6_TRANSID);
+            }
+        } else if (dynamic_cast<TokenEqual*>(raw)) {
+            instruction = Instruction(EQUAL);
+            pops = 2;
+        } else if (dynamic_cast<TokenNot*>(raw)) {
+            instruction = Instruction(NOT);
+            pops = 1;
+        } else if (dynamic_cast<TokenAnd*>(raw)) {
+            instruction = Instruction(AND);
+            pops = 2;
+        } else if (dynamic_cast<TokenOr*>(raw)) {
+            instruction = Instruction(OR);
+            pops = 2;
+        }
+        if (instruction.op_ == CALL) {
+            int call_pops = getCallPops(raw);
+            if (call_pops < 0) {
+                return (CompiledExpressionPtr());
+            }
+            pops = static_cast<size_t>(call_pops);
+            compiled->calls_.push_back(Call{token, pops, token->isCacheable()});
+            instruction.arg_ = compiled->calls_.size() - 1;
+        }
+        if (depth < pops) {
+            return (CompiledExpressionPtr());
+        }
+        compiled->emit(instruction, barrier);
+        depth = depth - pops + 1;
+        if (depth > max_depth) {
+            max_depth = depth;
+        }
+        if (max_depth > MAX_DEPTH) {
+            return (CompiledExpressionPtr());
+        }
+    }
+    // A branch to a missing label raises an error at evaluation.
+    if (!pending.empty()) {
+        return (CompiledExpressionPtr());
+    }
+    return (compiled);
+}
+
+void
+CompiledExpression::emit(const Instruction& instruction, size_t barrier) {
+    size_t operands = 0;
+    switch (instruction.op_) {
+    case EQUAL:
+    case AND:
+    case OR:
+        operands = 2;
+        break;
+    case NOT:
+        operands = 1;
+        break;
+    default:
+        break;
+    }
+    if ((operands == 0) || (code_.size() < barrier + operands)) {
+        code_.push_back(instruction);
+        return;
+    }
+    // Fold the instruction when its operands are constants.
+    Slot values[2];
+    for (size_t i = 0; i < operands; ++i) {
+        auto const& operand = code_[code_.size() - operands + i];
+        switch (operand.op_) {
+        case PUSH_STRING:
+            values[i].setConstant(&strings_[operand.arg_]);
+            break;
+        case PUSH_INTEGER:
+            values[i].setInteger(operand.arg_);
+            break;
+        case PUSH_BOOLEAN:
+            values[i].setBoolean(operand.arg_ != 0);
+            break;
+        default:
+            code_.push_back(instruction);
+            return;
+        }
+    }
+    bool result;
+    try {
+        switch (instruction.op_) {
+        case EQUAL:
+            result = values[0].equals(values[1]);
+            break;
+        case NOT:
+            result = !values[0].toBool();
+            break;
+        case AND:
+            result = values[1].toBool() && values[0].toBool();
+            break;
+        default:
+            result = values[1].toBool() || values[0].toBool();
+            break;
+        }
+    } catch (const EvalTypeError&) {
+        // Leave the error to the evaluation.
+        code_.push_back(instruction);
+        return;
+    }
+    code_.erase(code_.end() - operands, code_.end());
+    code_.push_back(Instruction(PUSH_BOOLEAN, result ? 1 : 0));
+}
+
+size_t
+CompiledExpression::run(Pkt& pkt, Slot* stack) const {
+    ExtractionCache* cache = ExtractionCache::current();
+    size_t top = 0;
+    size_t pc = 0;
+    const size_t end = code_.size();
+    while (pc < end) {
+        auto const& instruction = code_[pc++];
+        switch (instruction.op_) {
+        case PUSH_STRING:
+            stack[top++].setConstant(&strings_[instruction.arg_]);
+            break;
+        case PUSH_INTEGER:
+            stack[top++].setInteger(instruction.arg_);
+            break;
+        case PUSH_BOOLEAN:
+            stack[top++].setBoolean(instruction.arg_ != 0);
+            break;
+        case OPTION_EXISTS:
+            stack[top++].setBoolean(static_cast<bool>(pkt.getOption(instruction.arg_)));
+            break;
+        case OPTION_TEXT: {
+            OptionPtr opt = pkt.getOption(instruction.arg_);
+            stack[top++].setString(opt ? opt->toString() : string());
+            break;
+        }
+        case OPTION_HEX: {
+            OptionPtr opt = pkt.getOption(instruction.arg_);
+            string value;
+            if (opt) {
+                std::vector<uint8_t> binary = opt->toBinary();
+                value.assign(binary.begin(), binary.end());
+            }
+            stack[top++].setString(std::move(value));
+            break;
+        }
+        case MEMBER:
+            stack[top++].setBoolean(pkt.inClass(strings_[instruction.arg_]));
+            break;
+        case PKT4_MSGTYPE:
+        case PKT4_TRANSID: {
+            auto pkt4 = dynamic_cast<Pkt4*>(&pkt);
+            if (!pkt4) {
+                isc_throw(EvalTypeError, "Specified packet is not a Pkt4");
+            }
+            stack[top++].setInteger(instruction.op_ == PKT4_MSGTYPE ?
+                                    pkt4->getType() : pkt4->getTransid());
+            break;
+        }
+        case PKT6_MSGTYPE:
+        case PKT6_TRANSID: {
+            auto pkt6 = dynamic_cast<Pkt6*>(&pkt);
+            if (!pkt6) {
+                isc_throw(EvalTypeError, "Specified packet is not Pkt6");
+            }
+            stack[top++].setInteger(instruction.op_ == PKT6_MSGTYPE ?
+                                    pkt6->getType() : pkt6->getTransid());
+            break;
+        }
+        case EQUAL: {
+            --top;
+            bool result = stack[top - 1].equals(stack[top]);
+            stack[top - 1].setBoolean(result);
+            break;
+        }
+        case NOT:
+            stack[top - 1].setBoolean(!stack[top - 1].toBool());
+            break;
+        case AND: {
+            // Both operands are checked as the token does.
+            bool op1 = stack[top - 1].toBool();
+            bool op2 = stack[top - 2].toBool();
+            --top;
+            stack[top - 1].setBoolean(op1 && op2);
+            break;
+        }
+        case OR: {
+            bool op1 = stack[top - 1].toBool();
+            bool op2 = stack[top - 2].toBool();
+            --top;
+            stack[top - 1].setBoolean(op1 || op2);
+            break;
+        }
+        case BRANCH:
+            pc = instruction.arg_;
+            break;
+        case POP_OR_BRANCH_TRUE:
+            if (stack[top - 1].toBool()) {
+                pc = instruction.arg_;
+            } else {
+                --top;
+            }
+            break;
+        case POP_OR_BRANCH_FALSE:
+            if (!stack[top - 1].toBool()) {
+                pc = instruction.arg_;
+            } else {
+                --top;
+            }
+            break;
+        case POP_AND_BRANCH_FALSE:
+            if (!stack[--top].toBool()) {
+                pc = instruction.arg_;
+            }
+            break;
+        case CALL: {
+            auto const& call = calls_[instruction.arg_];
+            if (call.cacheable_ && cache) {
+                const string* value = cache->get(call.token_.get());
+                if (value) {
+                    stack[top++].setConstant(value);
+                    break;
+                }
+            }
+            ValueStack values;
+            for (size_t i = top - call.pops_; i < top; ++i) {
+                values.push(stack[i].toString());
+            }
+            top -= call.pops_;
+            static_cast<void>(call.token_->evaluate(pkt, values));
+            if (values.size() != 1) {
+                isc_throw(EvalBadStack, "Incorrect stack order. Expected exactly "
+                          "1 value after a token evaluation, got " << values.size());
+            }
+            if (call.cacheable_ && cache) {
+                cache->set(call.token_.get(), values.top());
+            }
+            stack[top++].setString(std::move(values.top()));
+            break;
+        }
+        }
+    }
+    return (top);
+}
+
+bool
+CompiledExpression::interpret() const {
+    return (eval_logger.isDebugEnabled(EVAL_DBG_STACK));
+}
+
+bool
+CompiledExpression::evaluateBool(Pkt& pkt) const {
+    if (interpret()) {
+        return (isc::dhcp::evaluateBool(expr_, pkt));
+    }
+    Slot stack[MAX_DEPTH];
+    size_t size = run(pkt, stack);
+    if (size != 1) {
+        isc_throw(EvalBadStack, "Incorrect stack order. Expected exactly "
+                  "1 value at the end of evaluation, got " << size);
+    }
+    return (stack[0].toBool());
+}
+
+std::string
+CompiledExpression::evaluateString(Pkt& pkt) const {
+    if (interpret()) {
+        return (isc::dhcp::evaluateString(expr_, pkt));
+    }
+    Slot stack[MAX_DEPTH];
+    size_t size = run(pkt, stack);
+    if (size != 1) {
+        isc_throw(EvalBadStack, "Incorrect stack order. Expected exactly "
+                  "1 value at the end of evaluation, got " << size);
+    }
+    return (stack[0].toString());
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
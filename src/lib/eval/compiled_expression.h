@@ -0,0 +1,200 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef COMPILED_EXPRESSION_H
+#define COMPILED_EXPRESSION_H
+
+#include <eval/token.h>
+#include <boost/shared_ptr.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+class CompiledExpression;
+
+/// @brief Pointer to a compiled expression.
+typedef boost::shared_ptr<CompiledExpression> CompiledExpressionPtr;
+
+/// @brief An expression compiled to a bytecode.
+///
+/// The tokens of a parsed expression are translated into a compact
+/// sequence of instructions executed by a non-virtual interpreter:
+///
+/// - the values are held in typed slots (strings, integers and booleans)
+///   in a fixed size stack allocated on the call stack, so the booleans
+///   and the integers are not converted to strings and the constants
+///   are not copied,
+/// - the labels are resolved at compilation time so the short-circuit
+///   branches are direct jumps,
+/// - the equality and logical operators with constant operands are
+///   folded at compilation time,
+/// - the most common tokens (constants, options, client class membership,
+///   message type and transaction id, equality and logical operators)
+///   are executed natively and the other tokens are called through the
+///   @c Token::evaluate method,
+/// - the values of the extraction tokens called through the
+///   @c Token::evaluate method are cached in the active
+///   @c ExtractionCache.
+///
+/// The evaluation gives the same results and raises the same exceptions as
+/// @c evaluateBool and @c evaluateString applied to the expression. When
+/// the eval logger is enabled at the stack debug level the expression is
+/// interpreted token by token so the values are logged as before.
+class CompiledExpression {
+public:
+
+    /// @brief Maximum depth of the value stack.
+    static const size_t MAX_DEPTH = 16;
+
+    /// @brief Compiles an expression.
+    ///
+    /// @param expr the expression to compile.
+    /// @return the compiled expression or null when the expression can't
+    /// be compiled (e.g., it uses an unknown token or it is malformed),
+    /// in which case it should be evaluated by @c evaluateBool or
+    /// @c evaluateString.
+    static CompiledExpressionPtr compile(const Expression& expr);
+
+    /// @brief Evaluates the expression and returns a boolean decision.
+    ///
+    /// @param pkt The v4 or v6 packet.
+    /// @return the boolean decision.
+    /// @throw EvalBadStack if there is not exactly one value on the stack
+    /// at the end of the evaluation.
+    /// @throw EvalTypeError if the value at the top of the stack at the
+    /// end of the evaluation is not a boolean.
+    bool evaluateBool(Pkt& pkt) const;
+
+    /// @brief Evaluates the expression and returns a string value.
+    ///
+    /// @param pkt The v4 or v6 packet.
+    /// @return the string value.
+    /// @throw EvalBadStack if there is not exactly one value on the stack
+    /// at the end of the evaluation.
+    std::string evaluateString(Pkt& pkt) const;
+
+    /// @brief Returns the number of instructions.
+    ///
+    /// Used in tests only.
+    ///
+    /// @return the number of instructions.
+    size_t getSize() const {
+        return (code_.size());
+    }
+
+    /// @brief Returns the number of tokens called through the
+    /// @c Token::evaluate method.
+    ///
+    /// Used in tests only.
+    ///
+    /// @return the number of tokens which are not executed natively.
+    size_t getCallCount() const {
+        return (calls_.size());
+    }
+
+private:
+
+    /// @brief Instruction codes.
+    enum Opcode : uint8_t {
+        PUSH_STRING,          ///< push the constant string strings_[arg_]
+        PUSH_INTEGER,         ///< push the integer arg_
+        PUSH_BOOLEAN,         ///< push the boolean arg_
+        OPTION_EXISTS,        ///< push if the option arg_ exists
+        OPTION_TEXT,          ///< push the textual value of the option arg_
+        OPTION_HEX,           ///< push the binary value of the option arg_
+        MEMBER,               ///< push if the packet is in the class strings_[arg_]
+        PKT4_MSGTYPE,         ///< push the DHCPv4 message type
+        PKT4_TRANSID,         ///< push the DHCPv4 transaction id
+        PKT6_MSGTYPE,         ///< push the DHCPv6 message type
+        PKT6_TRANSID,         ///< push the DHCPv6 transaction id
+        EQUAL,                ///< pop two values, push if they are equal
+        NOT,                  ///< pop a boolean, push its negation
+        AND,                  ///< pop two booleans, push their conjunction
+        OR,                   ///< pop two booleans, push their disjunction
+        BRANCH,               ///< jump to arg_
+        POP_OR_BRANCH_TRUE,   ///< jump to arg_ if the top is true else pop it
+        POP_OR_BRANCH_FALSE,  ///< jump to arg_ if the top is false else pop it
+        POP_AND_BRANCH_FALSE, ///< pop the top, jump to arg_ if it is false
+        CALL                  ///< call calls_[arg_]
+    };
+
+    /// @brief An instruction.
+    struct Instruction {
+        /// @brief Constructor.
+        ///
+        /// @param op the instruction code.
+        /// @param arg the instruction argument.
+        Instruction(Opcode op, uint32_t arg = 0) : op_(op), arg_(arg) {
+        }
+
+        /// @brief The instruction code.
+        Opcode op_;
+
+        /// @brief The instruction argument (a constant, an index or
+        /// a jump target).
+        uint32_t arg_;
+    };
+
+    /// @brief A token called through the @c Token::evaluate method.
+    struct Call {
+        /// @brief The token.
+        TokenPtr token_;
+
+        /// @brief The number of values the token pops from the stack.
+        size_t pops_;
+
+        /// @brief True when the token value can be cached.
+        bool cacheable_;
+    };
+
+    /// @brief A typed value on the stack.
+    struct Slot;
+
+    /// @brief Constructor.
+    ///
+    /// @param expr the compiled expression.
+    CompiledExpression(const Expression& expr);
+
+    /// @brief Appends an instruction, folding it with the previous
+    /// instructions when its operands are constants.
+    ///
+    /// @param instruction the instruction.
+    /// @param barrier the index of the first instruction which can be
+    /// folded, i.e. following the last jump target.
+    void emit(const Instruction& instruction, size_t barrier);
+
+    /// @brief Executes the instructions.
+    ///
+    /// @param pkt The v4 or v6 packet.
+    /// @param stack The value stack.
+    /// @return the number of values on the stack at the end of the
+    /// execution.
+    size_t run(Pkt& pkt, Slot* stack) const;
+
+    /// @brief Returns true when the expression must be interpreted token
+    /// by token to log the values.
+    bool interpret() const;
+
+    /// @brief The instructions.
+    std::vector<Instruction> code_;
+
+    /// @brief The constant strings.
+    std::vector<std::string> strings_;
+
+    /// @brief The tokens called through the @c Token::evaluate method.
+    std::vector<Call> calls_;
+
+    /// @brief The compiled expression.
+    Expression expr_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // COMPILED_EXPRESSION_H
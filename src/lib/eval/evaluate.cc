@@ -7,14 +7,27 @@
 #include <config.h>
 
 #include <eval/evaluate.h>
+#include <eval/extraction_cache.h>
 
 namespace isc {
 namespace dhcp {
 
 void
 evaluateRaw(const Expression& expr, Pkt& pkt, ValueStack& values) {
+    ExtractionCache* cache = ExtractionCache::current();
     for (auto it = expr.cbegin(); it != expr.cend(); ) {
-        unsigned label = (*it++)->evaluate(pkt, values);
+        const TokenPtr& token = *it++;
+        if (cache && token->isCacheable()) {
+            const std::string* value = cache->get(token.get());
+            if (value) {
+                values.push(*value);
+            } else {
+                static_cast<void>(token->evaluate(pkt, values));
+                cache->set(token.get(), values.top());
+            }
+            continue;
+        }
+        unsigned label = token->evaluate(pkt, values);
         if (label == 0) {
             continue;
         }
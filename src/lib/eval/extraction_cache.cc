@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <eval/extraction_cache.h>
+
+#include <sstream>
+#include <typeinfo>
+
+using namespace std;
+
+namespace {
+
+/// @brief The active cache of the current thread.
+thread_local isc::dhcp::ExtractionCache* active_cache = 0;
+
+}
+
+namespace isc {
+namespace dhcp {
+
+ExtractionCache::ExtractionCache() : values_(), previous_(active_cache) {
+    active_cache = this;
+}
+
+ExtractionCache::~ExtractionCache() {
+    active_cache = previous_;
+}
+
+ExtractionCache*
+ExtractionCache::current() {
+    return (active_cache);
+}
+
+string
+ExtractionCache::getKey(const TokenPtr& token) {
+    Token* raw = token.get();
+    if (!raw || !raw->isCacheable()) {
+        return (string());
+    }
+    // Only the known token types: a derived type (e.g., defined by
+    // a hook library) can depend on more than the parameters below.
+    const type_info& type = typeid(*raw);
+    ostringstream key;
+    key << type.name();
+    if ((type == typeid(TokenOption)) ||
+        (type == typeid(TokenRelay4Option)) ||
+        (type == typeid(TokenRelay6Option)) ||
+        (type == typeid(TokenVendor)) ||
+        (type == typeid(TokenVendorClass)) ||
+        (type == typeid(TokenSubOption))) {
+        auto option = dynamic_cast<TokenOption*>(raw);
+        key << ":" << option->getCode() << ":" << option->getRepresentation();
+        if (auto relay6 = dynamic_cast<TokenRelay6Option*>(raw)) {
+            key << ":" << static_cast<int>(relay6->getNest());
+        }
+        if (auto vendor = dynamic_cast<TokenVendor*>(raw)) {
+            key << ":" << vendor->getVendorId() << ":" << vendor->getField();
+        }
+        if (auto vendor_class = dynamic_cast<TokenVendorClass*>(raw)) {
+            key << ":" << vendor_class->getDataIndex();
+        }
+        if (auto sub_option = dynamic_cast<TokenSubOption*>(raw)) {
+            key << ":" << sub_option->getSubCode();
+        }
+    } else if (type == typeid(TokenPkt)) {
+        key << ":" << dynamic_cast<TokenPkt*>(raw)->getType();
+    } else if (type == typeid(TokenPkt4)) {
+        key << ":" << dynamic_cast<TokenPkt4*>(raw)->getType();
+    } else if (type == typeid(TokenPkt6)) {
+        key << ":" << dynamic_cast<TokenPkt6*>(raw)->getType();
+    } else if (type == typeid(TokenRelay6Field)) {
+        auto field = dynamic_cast<TokenRelay6Field*>(raw);
+        key << ":" << static_cast<int>(field->getNest()) << ":" << field->getType();
+    } else {
+        return (string());
+    }
+    return (key.str());
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
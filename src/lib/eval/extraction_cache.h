@@ -0,0 +1,106 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EXTRACTION_CACHE_H
+#define EXTRACTION_CACHE_H
+
+#include <eval/token.h>
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <unordered_map>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Per-packet cache of the values extracted from a packet.
+///
+/// The client classification evaluates the expressions of all the client
+/// classes against the same packet, and these expressions often extract
+/// the same data (e.g., the same relay agent sub-option or the client
+/// hardware address). The extraction tokens (the tokens which put on the
+/// stack a value taken from the packet without popping any value, see
+/// @c Token::isCacheable) look for their value in this cache when
+/// evaluated through @c evaluateRaw or a @c CompiledExpression.
+///
+/// The values are keyed by the token identity, so the identical tokens
+/// of the client class expressions are shared by the
+/// @c ClientClassDictionary (see @c ExtractionCache::getKey).
+///
+/// A cache is active for the current thread from its construction to its
+/// destruction, so it is declared on the stack around the evaluation of
+/// the client classes of a packet. The packet must not be modified while
+/// the cache is active. The caches can be nested: the destructor restores
+/// the previously active cache.
+class ExtractionCache : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Makes the new cache the active cache of the current thread.
+    ExtractionCache();
+
+    /// @brief Destructor.
+    ///
+    /// Restores the previously active cache of the current thread.
+    ~ExtractionCache();
+
+    /// @brief Returns the active cache of the current thread.
+    ///
+    /// @return the active cache or null when no cache is active.
+    static ExtractionCache* current();
+
+    /// @brief Returns a cached value.
+    ///
+    /// @param token the extraction token.
+    /// @return pointer to the value or null when the value is not cached.
+    const std::string* get(const Token* token) const {
+        auto it = values_.find(token);
+        if (it == values_.end()) {
+            return (0);
+        }
+        return (&it->second);
+    }
+
+    /// @brief Caches a value.
+    ///
+    /// @param token the extraction token.
+    /// @param value the value the token extracted from the packet.
+    void set(const Token* token, const std::string& value) {
+        values_[token] = value;
+    }
+
+    /// @brief Returns the number of cached values.
+    ///
+    /// Used in tests only.
+    ///
+    /// @return the number of cached values.
+    size_t size() const {
+        return (values_.size());
+    }
+
+    /// @brief Returns a key identifying the data extracted by a token.
+    ///
+    /// Two extraction tokens with the same key extract the same data
+    /// from a packet so one can be used in place of the other.
+    ///
+    /// @param token the token.
+    /// @return the key or an empty string when the token is not an
+    /// extraction token.
+    static std::string getKey(const TokenPtr& token);
+
+private:
+
+    /// @brief The cached values.
+    std::unordered_map<const Token*, std::string> values_;
+
+    /// @brief The previously active cache.
+    ExtractionCache* previous_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // EXTRACTION_CACHE_H
@@ -0,0 +1,219 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <eval/compiled_expression.h>
+#include <eval/evaluate.h>
+#include <eval/eval_context.h>
+#include <eval/token.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/pkt6.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/option_string.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for testing the compiled expressions.
+class CompiledExpressionTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates a DHCPv4 and a DHCPv6 packet with a string option.
+    CompiledExpressionTest() {
+        pkt4_.reset(new Pkt4(DHCPDISCOVER, 12345));
+        pkt6_.reset(new Pkt6(DHCPV6_SOLICIT, 12345));
+        pkt4_->addOption(OptionPtr(new OptionString(Option::V4, 100, "hundred4")));
+        pkt6_->addOption(OptionPtr(new OptionString(Option::V6, 100, "hundred6")));
+    }
+
+    /// @brief Parses and compiles an expression.
+    ///
+    /// @param u universe (V4 or V6).
+    /// @param expr expression to be parsed.
+    /// @param type the expected type of the expression.
+    /// @return the compiled expression.
+    CompiledExpressionPtr compile(const Option::Universe& u, const string& expr,
+                                  EvalContext::ParserType type = EvalContext::PARSER_BOOL) {
+        EvalContext eval(u);
+        EXPECT_NO_THROW(eval.parseString(expr, type)) << " while parsing " << expr;
+        expr_ = eval.expression_;
+        return (CompiledExpression::compile(expr_));
+    }
+
+    /// @brief Checks that a compiled expression gives the same boolean
+    /// decision as the interpreted one.
+    ///
+    /// @param u universe (V4 or V6).
+    /// @param expr expression to be parsed.
+    /// @param exp_result expected result.
+    void testBool(const Option::Universe& u, const string& expr, bool exp_result) {
+        auto compiled = compile(u, expr);
+        ASSERT_TRUE(compiled) << " for expression " << expr;
+        Pkt& pkt = (u == Option::V4 ? static_cast<Pkt&>(*pkt4_) :
+                    static_cast<Pkt&>(*pkt6_));
+        EXPECT_EQ(exp_result, evaluateBool(expr_, pkt)) << " for expression " << expr;
+        EXPECT_EQ(exp_result, compiled->evaluateBool(pkt)) << " for expression " << expr;
+    }
+
+    /// @brief The last parsed expression.
+    Expression expr_;
+
+    /// @brief A DHCPv4 packet.
+    Pkt4Ptr pkt4_;
+
+    /// @brief A DHCPv6 packet.
+    Pkt6Ptr pkt6_;
+};
+
+// Checks that the equality and logical operators on constants are folded.
+TEST_F(CompiledExpressionTest, constantFolding) {
+    auto compiled = compile(Option::V4, "'foo' == 'foo'");
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ(1, compiled->getSize());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    compiled = compile(Option::V4, "not ('foo' == 'bar') and (1 == 0x00000001)");
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ(1, compiled->getSize());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    // The left operand is not constant.
+    compiled = compile(Option::V4, "option[100].text == 'foo' sor ('a' == 'a')");
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ(5, compiled->getSize());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+}
+
+// Checks the natively executed tokens.
+TEST_F(CompiledExpressionTest, native) {
+    auto compiled = compile(Option::V4, "option[100].text == 'hundred4' and "
+                            "option[100].hex == 0x68756e6472656434 and "
+                            "option[100].exists and not option[101].exists and "
+                            "pkt4.msgtype == 1 and pkt4.transid == 12345");
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ(0, compiled->getCallCount());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    // Integers are compared with strings.
+    testBool(Option::V6, "pkt6.msgtype == 0x00000001", true);
+    testBool(Option::V6, "pkt6.transid == 12345", true);
+    testBool(Option::V6, "pkt6.transid == 12346", false);
+
+    // Client class membership.
+    testBool(Option::V4, "member('foo')", false);
+    pkt4_->addClass("foo");
+    testBool(Option::V4, "member('foo')", true);
+}
+
+// Checks the tokens called through Token::evaluate.
+TEST_F(CompiledExpressionTest, call) {
+    auto compiled = compile(Option::V4, "substring(option[100].text, 0, 3) == 'hun'");
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ(1, compiled->getCallCount());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    // The booleans are passed as strings.
+    compiled = compile(Option::V4, "sifelse(option[100].exists, 'yes', 'no')",
+                       EvalContext::PARSER_STRING);
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ("yes", compiled->evaluateString(*pkt4_));
+
+    // The integers are passed as 4 octet strings.
+    compiled = compile(Option::V4, "uint32totext(pkt4.transid)",
+                       EvalContext::PARSER_STRING);
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ("12345", compiled->evaluateString(*pkt4_));
+
+    testBool(Option::V6, "concat(option[100].text, 'x') == 'hundred6x'", true);
+    testBool(Option::V6, "match('^hun.*', option[100].text)", true);
+}
+
+// Checks the short-circuit branches.
+TEST_F(CompiledExpressionTest, branches) {
+    testBool(Option::V4, "option[101].exists or option[100].exists", true);
+    testBool(Option::V4, "option[100].exists or option[101].exists", true);
+    testBool(Option::V4, "option[101].exists or option[102].exists", false);
+    testBool(Option::V4, "option[100].exists and option[101].exists", false);
+    testBool(Option::V4, "option[101].exists and option[100].exists", false);
+    testBool(Option::V4, "(option[101].exists or option[100].exists) and "
+             "(option[102].exists or not option[103].exists)", true);
+
+    auto compiled = compile(Option::V4, "ifelse(option[100].exists, "
+                            "ifelse(option[101].exists, 'a', 'b'), 'c')",
+                            EvalContext::PARSER_STRING);
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ("b", compiled->evaluateString(*pkt4_));
+    compiled = compile(Option::V4, "ifelse(option[101].exists, 'a', 'c')",
+                       EvalContext::PARSER_STRING);
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ("c", compiled->evaluateString(*pkt4_));
+}
+
+// Checks that malformed expressions are not compiled.
+TEST_F(CompiledExpressionTest, malformed) {
+    // A branch to a missing label.
+    Expression expr;
+    expr.push_back(TokenPtr(new TokenBranch(123)));
+    EXPECT_FALSE(CompiledExpression::compile(expr));
+
+    // A backward label.
+    expr.clear();
+    expr.push_back(TokenPtr(new TokenLabel(123)));
+    expr.push_back(TokenPtr(new TokenBranch(123)));
+    EXPECT_FALSE(CompiledExpression::compile(expr));
+
+    // Not enough values on the stack.
+    expr.clear();
+    expr.push_back(TokenPtr(new TokenString("foo")));
+    expr.push_back(TokenPtr(new TokenEqual()));
+    EXPECT_FALSE(CompiledExpression::compile(expr));
+
+    // Too deep stack.
+    expr.clear();
+    for (size_t i = 0; i <= CompiledExpression::MAX_DEPTH; ++i) {
+        expr.push_back(TokenPtr(new TokenString("foo")));
+    }
+    EXPECT_FALSE(CompiledExpression::compile(expr));
+}
+
+// Checks that the evaluation errors are the same.
+TEST_F(CompiledExpressionTest, errors) {
+    // Not a boolean.
+    Expression expr;
+    expr.push_back(TokenPtr(new TokenString("foo")));
+    expr.push_back(TokenPtr(new TokenNot()));
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT_TRUE(compiled);
+    EXPECT_THROW(compiled->evaluateBool(*pkt4_), EvalTypeError);
+    EXPECT_THROW(compiled->evaluateString(*pkt4_), EvalTypeError);
+
+    // Two values on the stack.
+    expr.clear();
+    expr.push_back(TokenPtr(new TokenString("true")));
+    expr.push_back(TokenPtr(new TokenString("true")));
+    compiled = CompiledExpression::compile(expr);
+    ASSERT_TRUE(compiled);
+    EXPECT_THROW(compiled->evaluateBool(*pkt4_), EvalBadStack);
+
+    // Wrong packet.
+    compiled = compile(Option::V4, "pkt4.msgtype == 1");
+    ASSERT_TRUE(compiled);
+    EXPECT_THROW(compiled->evaluateBool(*pkt6_), EvalTypeError);
+    compiled = compile(Option::V6, "pkt6.msgtype == 1");
+    ASSERT_TRUE(compiled);
+    EXPECT_THROW(compiled->evaluateBool(*pkt4_), EvalTypeError);
+}
+
+} // end of anonymous namespace
@@ -5,6 +5,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <config.h>
+#include <eval/compiled_expression.h>
 #include <eval/evaluate.h>
 #include <eval/eval_context.h>
 #include <eval/token.h>
@@ -325,6 +326,22 @@ public:
         }
 
         EXPECT_EQ(exp_result, result) << " for expression " << expr;
+
+        // The compiled expression gives the same result.
+        CompiledExpressionPtr compiled = CompiledExpression::compile(eval.expression_);
+        ASSERT_TRUE(compiled) << " for expression " << expr;
+        switch (u) {
+        case Option::V4:
+            ASSERT_NO_THROW(result = compiled->evaluateBool(*pkt4_))
+                << " for compiled expression " << expr;
+            break;
+        case Option::V6:
+            ASSERT_NO_THROW(result = compiled->evaluateBool(*pkt6_))
+                << " for compiled expression " << expr;
+            break;
+        }
+
+        EXPECT_EQ(exp_result, result) << " for compiled expression " << expr;
     }
 
     /// @brief Checks if expression can be parsed and evaluated to string
@@ -358,6 +375,22 @@ public:
         }
 
         EXPECT_EQ(exp_result, result) << " for expression " << expr;
+
+        // The compiled expression gives the same result.
+        CompiledExpressionPtr compiled = CompiledExpression::compile(eval.expression_);
+        ASSERT_TRUE(compiled) << " for expression " << expr;
+        switch (u) {
+        case Option::V4:
+            ASSERT_NO_THROW(result = compiled->evaluateString(*pkt4_))
+                << " for compiled expression " << expr;
+            break;
+        case Option::V6:
+            ASSERT_NO_THROW(result = compiled->evaluateString(*pkt6_))
+                << " for compiled expression " << expr;
+            break;
+        }
+
+        EXPECT_EQ(exp_result, result) << " for compiled expression " << expr;
     }
 
     /// @brief Checks that specified expression throws expected exception.
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <eval/compiled_expression.h>
+#include <eval/eval_context.h>
+#include <eval/evaluate.h>
+#include <eval/extraction_cache.h>
+#include <eval/token.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_string.h>
+#include <dhcp/pkt4.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for testing the extraction cache.
+class ExtractionCacheTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates a DHCPv4 packet with a string option.
+    ExtractionCacheTest() {
+        pkt4_.reset(new Pkt4(DHCPDISCOVER, 12345));
+        setOption("foo");
+    }
+
+    /// @brief Sets the value of the option 100.
+    ///
+    /// @param value the new value.
+    void setOption(const string& value) {
+        pkt4_->delOption(100);
+        pkt4_->addOption(OptionPtr(new OptionString(Option::V4, 100, value)));
+    }
+
+    /// @brief Parses an expression.
+    ///
+    /// @param expr expression to be parsed.
+    /// @return the parsed expression.
+    Expression parse(const string& expr) {
+        EvalContext eval(Option::V4);
+        EXPECT_NO_THROW(eval.parseString(expr)) << " while parsing " << expr;
+        return (eval.expression_);
+    }
+
+    /// @brief A DHCPv4 packet.
+    Pkt4Ptr pkt4_;
+};
+
+// Checks which tokens can be cached.
+TEST_F(ExtractionCacheTest, isCacheable) {
+    EXPECT_TRUE(TokenOption(100, TokenOption::TEXTUAL).isCacheable());
+    EXPECT_TRUE(TokenRelay4Option(1, TokenOption::HEXADECIMAL).isCacheable());
+    EXPECT_TRUE(TokenSubOption(82, 1, TokenOption::HEXADECIMAL).isCacheable());
+    EXPECT_TRUE(TokenPkt4(TokenPkt4::CHADDR).isCacheable());
+    EXPECT_TRUE(TokenPkt(TokenPkt::IFACE).isCacheable());
+    EXPECT_FALSE(TokenString("foo").isCacheable());
+    EXPECT_FALSE(TokenMember("foo").isCacheable());
+    EXPECT_FALSE(TokenEqual().isCacheable());
+}
+
+// Checks the keys of the tokens.
+TEST_F(ExtractionCacheTest, getKey) {
+    TokenPtr text1(new TokenOption(100, TokenOption::TEXTUAL));
+    TokenPtr text2(new TokenOption(100, TokenOption::TEXTUAL));
+    TokenPtr hex(new TokenOption(100, TokenOption::HEXADECIMAL));
+    TokenPtr other(new TokenOption(101, TokenOption::TEXTUAL));
+    TokenPtr relay(new TokenRelay4Option(100, TokenOption::TEXTUAL));
+    TokenPtr sub1(new TokenSubOption(82, 1, TokenOption::HEXADECIMAL));
+    TokenPtr sub2(new TokenSubOption(82, 2, TokenOption::HEXADECIMAL));
+    TokenPtr chaddr(new TokenPkt4(TokenPkt4::CHADDR));
+    TokenPtr giaddr(new TokenPkt4(TokenPkt4::GIADDR));
+    TokenPtr str(new TokenString("foo"));
+
+    EXPECT_FALSE(ExtractionCache::getKey(text1).empty());
+    EXPECT_EQ(ExtractionCache::getKey(text1), ExtractionCache::getKey(text2));
+    EXPECT_NE(ExtractionCache::getKey(text1), ExtractionCache::getKey(hex));
+    EXPECT_NE(ExtractionCache::getKey(text1), ExtractionCache::getKey(other));
+    EXPECT_NE(ExtractionCache::getKey(text1), ExtractionCache::getKey(relay));
+    EXPECT_NE(ExtractionCache::getKey(sub1), ExtractionCache::getKey(sub2));
+    EXPECT_NE(ExtractionCache::getKey(chaddr), ExtractionCache::getKey(giaddr));
+    EXPECT_TRUE(ExtractionCache::getKey(str).empty());
+    EXPECT_TRUE(ExtractionCache::getKey(TokenPtr()).empty());
+}
+
+// Checks the active cache.
+TEST_F(ExtractionCacheTest, current) {
+    EXPECT_FALSE(ExtractionCache::current());
+    {
+        ExtractionCache cache;
+        EXPECT_EQ(&cache, ExtractionCache::current());
+        {
+            ExtractionCache nested;
+            EXPECT_EQ(&nested, ExtractionCache::current());
+        }
+        EXPECT_EQ(&cache, ExtractionCache::current());
+    }
+    EXPECT_FALSE(ExtractionCache::current());
+}
+
+// Checks that the interpreted expressions use the cache.
+TEST_F(ExtractionCacheTest, evaluate) {
+    Expression expr = parse("option[100].text == 'foo'");
+    ExtractionCache cache;
+    EXPECT_TRUE(evaluateBool(expr, *pkt4_));
+    EXPECT_EQ(1, cache.size());
+
+    // The packet must not be modified while the cache is active: this
+    // shows the cached value is used.
+    setOption("bar");
+    EXPECT_TRUE(evaluateBool(expr, *pkt4_));
+    EXPECT_EQ(1, cache.size());
+    {
+        ExtractionCache nested;
+        EXPECT_FALSE(evaluateBool(expr, *pkt4_));
+    }
+}
+
+// Checks that the compiled expressions use the cache.
+TEST_F(ExtractionCacheTest, compiled) {
+    // The option is executed natively, the pkt4.giaddr field is called
+    // through Token::evaluate.
+    Expression expr = parse("substring(option[100].hex, 0, 2) == 'fo' and "
+                            "pkt4.giaddr == 0.0.0.0");
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT_TRUE(compiled);
+    ExtractionCache cache;
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+    EXPECT_EQ(1, cache.size());
+    pkt4_->setGiaddr(isc::asiolink::IOAddress("192.0.2.1"));
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+    EXPECT_EQ(1, cache.size());
+    {
+        ExtractionCache nested;
+        EXPECT_FALSE(compiled->evaluateBool(*pkt4_));
+    }
+}
+
+} // end of anonymous namespace
@@ -95,6 +95,17 @@ public:
         return (0U);
     }
 
+    /// @brief Returns true when the token is an extraction token.
+    ///
+    /// An extraction token puts on the stack a value extracted from the
+    /// packet without popping any value, so its value can be cached
+    /// while the packet is not modified (see @c ExtractionCache).
+    ///
+    /// @return true for an extraction token, false otherwise.
+    virtual bool isCacheable() const {
+        return (false);
+    }
+
     /// @brief Coverts a (string) value to a boolean
     ///
     /// Only "true" and "false" are expected.
@@ -140,6 +151,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns the constant value.
+    ///
+    /// @return the constant value.
+    const std::string& getValue() const {
+        return (value_);
+    }
+
 protected:
     std::string value_; ///< Constant value
 };
@@ -166,6 +184,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns the constant value.
+    ///
+    /// @return the constant value.
+    const std::string& getValue() const {
+        return (value_);
+    }
+
 protected:
     std::string value_; ///< Constant value
 };
@@ -254,6 +279,14 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns the constant value.
+    ///
+    /// @return the constant value (empty string if the IP address cannot
+    /// be converted).
+    const std::string& getValue() const {
+        return (value_);
+    }
+
 protected:
     ///< Constant value (empty string if the IP address cannot be converted)
     std::string value_;
@@ -437,6 +470,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns true: this is an extraction token.
+    ///
+    /// @return true.
+    virtual bool isCacheable() const {
+        return (true);
+    }
+
     /// @brief Returns option-code
     ///
     /// This method is used in testing to determine if the parser had
@@ -590,6 +630,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns true: this is an extraction token.
+    ///
+    /// @return true.
+    virtual bool isCacheable() const {
+        return (true);
+    }
+
     /// @brief Returns metadata type
     ///
     /// This method is used only in tests.
@@ -648,6 +695,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns true: this is an extraction token.
+    ///
+    /// @return true.
+    virtual bool isCacheable() const {
+        return (true);
+    }
+
     /// @brief Returns field type
     ///
     /// This method is used only in tests.
@@ -695,6 +749,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns true: this is an extraction token.
+    ///
+    /// @return true.
+    virtual bool isCacheable() const {
+        return (true);
+    }
+
     /// @brief Returns field type
     ///
     /// This method is used only in tests.
@@ -750,6 +811,13 @@ public:
     /// @return 0 which means evaluate next token if any.
     virtual unsigned evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns true: this is an extraction token.
+    ///
+    /// @return true.
+    virtual bool isCacheable() const {
+        return (true);
+    }
+
     /// @brief Returns nest-level
     ///
     /// This method is used in testing to determine if the parser has
@@ -0,0 +1,113 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <hooks/callout_handle.h>
+#include <hooks/callout_manager.h>
+#include <hooks/parking_lots.h>
+#include <hooks/server_hooks.h>
+#include <util/benchmarks/micro_benchmark.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::hooks;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the microbenchmarks of the libkea-hooks callout
+/// arguments and parking lots.
+
+namespace {
+
+/// @brief The number of objects parked beside the benchmarked one.
+const size_t PARKED = 100;
+
+/// @brief Adds the cases of the callout arguments.
+///
+/// An operation sets the arguments of a hook point as the servers do
+/// before calling the callouts, reads one of them back and resets the
+/// handle state.
+///
+/// @param bench the benchmark.
+void
+addCalloutHandleCases(MicroBenchmark& bench) {
+    bench.add("CalloutHandle/arguments-by-name", [](DataGenerator&) {
+        auto handle = boost::make_shared<CalloutHandle>(boost::make_shared<CalloutManager>());
+        auto query = boost::make_shared<int>(1);
+        auto response = boost::make_shared<int>(2);
+        auto subnet = boost::make_shared<int>(3);
+        return ([handle, query, response, subnet]() {
+            handle->setArgument("query", query);
+            handle->setArgument("response", response);
+            handle->setArgument("subnet", subnet);
+            boost::shared_ptr<int> value;
+            handle->getArgument("response", value);
+            handle->deleteAllArguments();
+            MicroBenchmark::keep(*value);
+        });
+    });
+
+    bench.add("CalloutHandle/arguments-by-index", [](DataGenerator&) {
+        ServerHooks& hooks = ServerHooks::getServerHooks();
+        int query_index = hooks.registerArgument("query");
+        int response_index = hooks.registerArgument("response");
+        int subnet_index = hooks.registerArgument("subnet");
+        auto handle = boost::make_shared<CalloutHandle>(boost::make_shared<CalloutManager>());
+        auto query = boost::make_shared<int>(1);
+        auto response = boost::make_shared<int>(2);
+        auto subnet = boost::make_shared<int>(3);
+        return ([=]() {
+            handle->setArgument(query_index, query);
+            handle->setArgument(response_index, response);
+            handle->setArgument(subnet_index, subnet);
+            boost::shared_ptr<int> value;
+            handle->getArgument(response_index, value);
+            handle->deleteAllArguments();
+            MicroBenchmark::keep(*value);
+        });
+    });
+}
+
+/// @brief Adds the cases of the parking lot.
+///
+/// @param bench the benchmark.
+void
+addParkingLotCases(MicroBenchmark& bench) {
+    // Parks, references and unparks an object while other objects are
+    // parked.
+    bench.add("ParkingLot/park-reference-unpark", [](DataGenerator&) {
+        auto parking_lot = boost::make_shared<ParkingLot>();
+        auto parked = boost::make_shared<vector<boost::shared_ptr<string>>>();
+        for (size_t i = 0; i < PARKED; ++i) {
+            parked->push_back(boost::make_shared<string>("parked"));
+            parking_lot->park(parked->back(), [] { });
+        }
+        auto object = boost::make_shared<string>("object");
+        auto unparked = boost::make_shared<size_t>(0);
+        return ([parking_lot, parked, object, unparked]() {
+            parking_lot->park(object, [unparked] { ++(*unparked); });
+            parking_lot->reference(object);
+            static_cast<void>(parking_lot->unpark(object));
+            MicroBenchmark::keep(*unparked);
+        });
+    });
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    MicroBenchmark bench("libkea-hooks");
+    addCalloutHandleCases(bench);
+    addParkingLotCases(bench);
+    return (bench.run(argc, argv));
+}
@@ -11,6 +11,7 @@
 #include <hooks/library_handle.h>
 #include <hooks/server_hooks.h>
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,7 +24,9 @@ namespace hooks {
 // Constructor.
 CalloutHandle::CalloutHandle(const boost::shared_ptr<CalloutManager>& manager,
                     const boost::shared_ptr<LibraryManagerCollection>& lmcoll)
-    : lm_collection_(lmcoll), arguments_(), context_collection_(),
+    : lm_collection_(lmcoll),
+      arguments_(ServerHooks::getServerHooks().getArgumentCount()),
+      argument_indexes_(), context_collection_(),
       manager_(manager), server_hooks_(ServerHooks::getServerHooks()),
       current_library_(-1), current_hook_(-1), next_step_(NEXT_STEP_CONTINUE) {
 
@@ -43,6 +46,7 @@ CalloutHandle::~CalloutHandle() {
     // Explicitly clear the argument and context objects.  This should free up
     // all memory that could have been allocated by libraries that were loaded.
     arguments_.clear();
+    argument_indexes_.clear();
     context_collection_.clear();
 
     // Normal destruction of the remaining variables will include the
@@ -64,13 +68,63 @@ CalloutHandle::~CalloutHandle() {
 vector<string>
 CalloutHandle::getArgumentNames() const {
     vector<string> names;
-    for (auto const& i : arguments_) {
-        names.push_back(i.first);
+    for (auto const& index : argument_indexes_) {
+        names.push_back(server_hooks_.getArgumentName(index));
     }
+    sort(names.begin(), names.end());
 
     return (names);
 }
 
+// Delete an argument.
+
+void
+CalloutHandle::deleteArgument(int index) {
+    if (!findArgumentValue(index)) {
+        return;
+    }
+    arguments_[index] = boost::any();
+    argument_indexes_.erase(find(argument_indexes_.begin(),
+                                 argument_indexes_.end(), index));
+}
+
+// Delete all arguments.  Only the set entries are cleared so the cost
+// does not depend on the number of registered arguments.
+
+void
+CalloutHandle::deleteAllArguments() {
+    for (auto const& index : argument_indexes_) {
+        arguments_[index] = boost::any();
+    }
+    argument_indexes_.clear();
+}
+
+int
+CalloutHandle::registerArgument(const string& name) {
+    return (server_hooks_.registerArgument(name));
+}
+
+int
+CalloutHandle::findArgument(const string& name) const {
+    return (server_hooks_.findArgument(name));
+}
+
+boost::any&
+CalloutHandle::getArgumentSlot(int index) {
+    if (index < 0) {
+        isc_throw(OutOfRange, "invalid argument index " << index);
+    }
+    if (index >= static_cast<int>(arguments_.size())) {
+        arguments_.resize(index + 1);
+    }
+    boost::any& argument = arguments_[index];
+    if (argument.empty()) {
+        argument_indexes_.push_back(index);
+    }
+
+    return (argument);
+}
+
 ParkingLotHandlePtr
 CalloutHandle::getParkingLotHandlePtr() const {
     return (boost::make_shared<ParkingLotHandle>(server_hooks_.getParkingLotPtr(current_hook_)));
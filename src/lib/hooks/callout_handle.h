@@ -11,6 +11,7 @@
 #include <hooks/library_handle.h>
 #include <hooks/parking_lots.h>
 #include <util/dhcp_space.h>
+#include <util/packet_arena.h>
 
 #include <boost/any.hpp>
 #include <boost/shared_ptr.hpp>
@@ -75,7 +76,7 @@ class LibraryManagerCollection;
 ///   "context_destroy" callout.  The information is accessed through the
 ///   {get,set}Context() methods.
 
-class CalloutHandle {
+class CalloutHandle : public util::PacketArenaObject {
 public:
 
     /// @brief Specifies allowed next steps
@@ -145,7 +146,23 @@ public:
     /// @param value Value to set.  That can be of any data type.
     template <typename T>
     void setArgument(const std::string& name, T value) {
-        arguments_[name] = value;
+        setArgument(registerArgument(name), value);
+    }
+
+    /// @brief Set argument by index
+    ///
+    /// Sets the value of an argument identified by the index returned by
+    /// @ref ServerHooks::registerArgument (or its shell
+    /// HooksManager::registerArgument).  This avoids the resolution of the
+    /// argument name on each call.
+    ///
+    /// @param index Index of the argument.
+    /// @param value Value to set.  That can be of any data type.
+    ///
+    /// @throw OutOfRange The index is negative.
+    template <typename T>
+    void setArgument(int index, T value) {
+        getArgumentSlot(index) = value;
     }
 
     /// @brief Get argument
@@ -162,13 +179,36 @@ public:
     ///        the variable provided to receive the value.
     template <typename T>
     void getArgument(const std::string& name, T& value) const {
-        ElementCollection::const_iterator element_ptr = arguments_.find(name);
-        if (element_ptr == arguments_.end()) {
+        const boost::any* argument = findArgumentValue(findArgument(name));
+        if (!argument) {
             isc_throw(NoSuchArgument, "unable to find argument with name " <<
                       name);
         }
 
-        value = boost::any_cast<T>(element_ptr->second);
+        value = boost::any_cast<T>(*argument);
+    }
+
+    /// @brief Get argument by index
+    ///
+    /// Gets the value of an argument identified by its index.
+    ///
+    /// @param index Index of the argument.
+    /// @param value [out] Value to set.  The type of "value" is important:
+    ///        it must match the type of the value set.
+    ///
+    /// @throw NoSuchArgument No argument with the given index is present.
+    /// @throw boost::bad_any_cast An argument with the given index is present,
+    ///        but the data type of the value is not the same as the type of
+    ///        the variable provided to receive the value.
+    template <typename T>
+    void getArgument(int index, T& value) const {
+        const boost::any* argument = findArgumentValue(index);
+        if (!argument) {
+            isc_throw(NoSuchArgument, "unable to find argument with index " <<
+                      index);
+        }
+
+        value = boost::any_cast<T>(*argument);
     }
 
     /// @brief Get argument names
@@ -176,7 +216,8 @@ public:
     /// Returns a vector holding the names of arguments in the argument
     /// vector.
     ///
-    /// @return Vector of strings reflecting argument names.
+    /// @return Vector of strings reflecting argument names, in alphabetical
+    ///         order.
     std::vector<std::string> getArgumentNames() const;
 
     /// @brief Delete argument
@@ -189,18 +230,28 @@ public:
     ///
     /// @param name Name of the element in the argument list to set.
     void deleteArgument(const std::string& name) {
-        static_cast<void>(arguments_.erase(name));
+        deleteArgument(findArgument(name));
     }
 
+    /// @brief Delete argument by index
+    ///
+    /// Deletes an argument identified by its index.  If the argument does
+    /// not exist, the method is a no-op.
+    ///
+    /// N.B. If the element is a raw pointer, the pointed-to data is NOT deleted
+    /// by this method.
+    ///
+    /// @param index Index of the argument.
+    void deleteArgument(int index);
+
     /// @brief Delete all arguments
     ///
-    /// Deletes all arguments associated with this context.
+    /// Deletes all arguments associated with this context.  The argument
+    /// table is kept so it is reused at the next hook point.
     ///
     /// N.B. If any elements are raw pointers, the pointed-to data is NOT
     /// deleted by this method.
-    void deleteAllArguments() {
-        arguments_.clear();
-    }
+    void deleteAllArguments();
 
     /// @brief Sets the next processing step.
     ///
@@ -402,6 +453,42 @@ private:
     ///        handle collection.
     int getLibraryIndex() const;
 
+    /// @brief Register an argument name
+    ///
+    /// @param name Name of the argument.
+    /// @return Index of the argument, see @ref ServerHooks::registerArgument.
+    int registerArgument(const std::string& name);
+
+    /// @brief Find an argument index
+    ///
+    /// @param name Name of the argument.
+    /// @return Index of the argument or -1 if the name is not registered.
+    int findArgument(const std::string& name) const;
+
+    /// @brief Return the table entry of an argument
+    ///
+    /// Grows the argument table if the argument was registered after the
+    /// construction of the handle and records the argument as set.
+    ///
+    /// @param index Index of the argument.
+    /// @return Reference to the value of the argument.
+    ///
+    /// @throw OutOfRange The index is negative.
+    boost::any& getArgumentSlot(int index);
+
+    /// @brief Return the value of an argument
+    ///
+    /// @param index Index of the argument.
+    /// @return Pointer to the value of the argument or null if the argument
+    ///         is not set.
+    const boost::any* findArgumentValue(int index) const {
+        if ((index < 0) || (index >= static_cast<int>(arguments_.size())) ||
+            arguments_[index].empty()) {
+            return (0);
+        }
+        return (&arguments_[index]);
+    }
+
     /// @brief Return reference to context for current library
     ///
     /// Called by all context-setting functions, this returns a reference to
@@ -434,8 +521,13 @@ private:
     /// created.
     boost::shared_ptr<LibraryManagerCollection> lm_collection_;
 
-    /// Collection of arguments passed to the callouts
-    ElementCollection arguments_;
+    /// Arguments passed to the callouts, indexed by the argument index.
+    /// The table is sized for the registered arguments at construction and
+    /// an empty value means that the argument is not set.
+    std::vector<boost::any> arguments_;
+
+    /// Indexes of the arguments which are set.
+    std::vector<int> argument_indexes_;
 
     /// Context collection - there is one entry per library context.
     ContextCollection context_collection_;
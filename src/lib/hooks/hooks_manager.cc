@@ -196,7 +196,10 @@ HooksManager::prepareUnloadLibraries() {
 
 boost::shared_ptr<CalloutHandle>
 HooksManager::createCalloutHandleInternal() {
-    return (boost::make_shared<CalloutHandle>(callout_manager_, lm_collection_));
+    // Not created by make_shared so the handle of a packet can be allocated
+    // from the packet arena.
+    return (boost::shared_ptr<CalloutHandle>(new CalloutHandle(callout_manager_,
+                                                               lm_collection_)));
 }
 
 boost::shared_ptr<CalloutHandle>
@@ -233,6 +236,13 @@ HooksManager::registerHook(const std::string& name) {
     return (ServerHooks::getServerHooks().registerHook(name));
 }
 
+// Shell around ServerHooks::registerArgument()
+
+int
+HooksManager::registerArgument(const std::string& name) {
+    return (ServerHooks::getServerHooks().registerArgument(name));
+}
+
 // Return pre- and post- library handles.
 
 isc::hooks::LibraryHandle&
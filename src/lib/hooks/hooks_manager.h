@@ -225,6 +225,19 @@ public:
     ///         registered.
     static int registerHook(const std::string& name);
 
+    /// @brief Register Argument
+    ///
+    /// This is just a convenience shell around the
+    /// ServerHooks::registerArgument() method.  The servers use it along
+    /// with registerHook() so the names of the arguments they pass to the
+    /// callouts are resolved once.
+    ///
+    /// @param name Name of the argument
+    ///
+    /// @return Index of the argument, to be used in subsequent calls to
+    ///         CalloutHandle::setArgument() and CalloutHandle::getArgument().
+    static int registerArgument(const std::string& name);
+
     /// @brief Return list of loaded libraries
     ///
     /// Returns the names of the loaded libraries.
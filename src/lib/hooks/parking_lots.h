@@ -16,6 +16,7 @@
 #include <iostream>
 #include <sstream>
 #include <list>
+#include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <thread>
@@ -82,14 +83,13 @@ public:
     template<typename T>
     void park(T parked_object, std::function<void()> unpark_callback) {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = find(parked_object);
-        if (it != parking_.end()) {
+        const void* key = makeKey(parked_object);
+        if (parking_.count(key)) {
             isc_throw(InvalidOperation, "object is already parked!");
         }
 
         // Add the object to the parking lot. At this point refcount = 0.
-        ParkingInfo pinfo(parked_object, unpark_callback);
-        parking_[makeKey(parked_object)] = pinfo;
+        parking_.emplace(key, ParkingInfo(parked_object, unpark_callback));
     }
 
     /// @brief Increases reference counter for the parked object.
@@ -252,7 +252,10 @@ public:
 private:
 
     /// @brief Map which stores parked objects.
-    typedef std::unordered_map<std::string, ParkingInfo> ParkingInfoList;
+    ///
+    /// The objects are keyed by the address of the pointed-to object, so
+    /// no memory is allocated to build the key.
+    typedef std::unordered_map<const void*, ParkingInfo> ParkingInfoList;
 
     /// @brief Type of the iterator in the list of parked objects.
     typedef ParkingInfoList::iterator ParkingInfoListIterator;
@@ -262,14 +265,35 @@ private:
 
     /// @brief Construct the key for a given parked object.
     ///
-    /// @tparam T parked object type.
+    /// The parked objects are pointers so the key is the identity of the
+    /// pointed-to object.
+    ///
+    /// @tparam T pointed-to object type.
+    /// @param parked_object object from which the key should be constructed.
+    /// @return the address of the pointed-to object.
+    template<typename T>
+    static const void* makeKey(const boost::shared_ptr<T>& parked_object) {
+        return (parked_object.get());
+    }
+
+    /// @brief Construct the key for a given parked object.
+    ///
+    /// @tparam T pointed-to object type.
+    /// @param parked_object object from which the key should be constructed.
+    /// @return the address of the pointed-to object.
+    template<typename T>
+    static const void* makeKey(const std::shared_ptr<T>& parked_object) {
+        return (parked_object.get());
+    }
+
+    /// @brief Construct the key for a given parked object.
+    ///
+    /// @tparam T pointed-to object type.
     /// @param parked_object object from which the key should be constructed.
-    /// @return string containing the object's key.
+    /// @return the address of the pointed-to object.
     template<typename T>
-    std::string makeKey(T parked_object) {
-        std::stringstream ss;
-        ss << boost::any_cast<T>(parked_object);
-        return (ss.str());
+    static const void* makeKey(T* parked_object) {
+        return (parked_object);
     }
 
     /// @brief Search for the information about the parked object.
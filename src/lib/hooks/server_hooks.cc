@@ -9,6 +9,7 @@
 #include <exceptions/exceptions.h>
 #include <hooks/hooks_log.h>
 #include <hooks/server_hooks.h>
+#include <util/multi_threading_mgr.h>
 
 #include <algorithm>
 #include <utility>
@@ -16,6 +17,7 @@
 
 using namespace std;
 using namespace isc;
+using namespace isc::util;
 
 namespace isc {
 namespace hooks {
@@ -32,7 +34,10 @@ namespace hooks {
 // point, the logging system is not initialized, so messages are unable to
 // be output.
 
-ServerHooks::ServerHooks() {
+ServerHooks::ServerHooks() : arguments_(0) {
+    ArgumentCollectionPtr arguments(new ArgumentCollection());
+    argument_collections_.push_back(arguments);
+    arguments_.store(arguments.get());
     initialize();
 }
 
@@ -166,6 +171,58 @@ ServerHooks::getHookNames() const {
     return (names);
 }
 
+// Register an argument name.  As for the hooks, the index assigned to the
+// argument is the current number of entries in the collection.  A known
+// name is found without locking; a new one is added to a copy of the
+// collection which is then published.
+
+int
+ServerHooks::registerArgument(const string& name) {
+    int index = findArgument(name);
+    if (index >= 0) {
+        return (index);
+    }
+
+    MultiThreadingLock lock(arguments_mutex_);
+    const ArgumentCollection& current = *arguments_.load();
+    auto i = current.indexes_.find(name);
+    if (i != current.indexes_.end()) {
+        // Registered by another thread in the meantime.
+        return (i->second);
+    }
+    boost::shared_ptr<ArgumentCollection> arguments(new ArgumentCollection(current));
+    index = arguments->names_.size();
+    arguments->indexes_.insert(make_pair(name, index));
+    arguments->names_.push_back(name);
+    argument_collections_.push_back(arguments);
+    arguments_.store(arguments.get());
+
+    return (index);
+}
+
+int
+ServerHooks::findArgument(const string& name) const {
+    const ArgumentCollection& arguments = *arguments_.load();
+    auto i = arguments.indexes_.find(name);
+    return ((i == arguments.indexes_.end()) ? -1 : i->second);
+}
+
+string
+ServerHooks::getArgumentName(int index) const {
+    const ArgumentCollection& arguments = *arguments_.load();
+    if ((index < 0) || (index >= static_cast<int>(arguments.names_.size()))) {
+        isc_throw(OutOfRange, "argument index " << index
+                  << " is not recognized");
+    }
+
+    return (arguments.names_[index]);
+}
+
+int
+ServerHooks::getArgumentCount() const {
+    return (arguments_.load()->names_.size());
+}
+
 // Return global ServerHooks object
 
 ServerHooks&
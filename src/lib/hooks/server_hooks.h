@@ -13,8 +13,11 @@
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace isc {
@@ -141,6 +144,54 @@ public:
     /// @return Vector of strings holding hook names.
     std::vector<std::string> getHookNames() const;
 
+    /// @brief Register an argument name
+    ///
+    /// The arguments passed to the callouts are stored by the
+    /// @ref CalloutHandle in a table addressed by an argument index.  The
+    /// servers register the names of the arguments of their hook points
+    /// along with the hook points and then use the indexes, so the names
+    /// are resolved once instead of on every call.  Registering a name
+    /// which is already registered returns its index.
+    ///
+    /// Unlike the hooks, the argument names are not cleared by @ref reset()
+    /// so the indexes remain valid for the lifetime of the program.
+    ///
+    /// A new name is added to a copy of the argument collection which then
+    /// replaces the current one, so the lookups (@ref findArgument,
+    /// @ref getArgumentName and @ref getArgumentCount) take no lock.
+    ///
+    /// @param name Name of the argument.
+    ///
+    /// @return Index of the argument.
+    int registerArgument(const std::string& name);
+
+    /// @brief Find argument index
+    ///
+    /// Returns the index of a registered argument name.
+    ///
+    /// @param name Name of the argument.
+    ///
+    /// @return Index of the argument or -1 if the name is not registered.
+    int findArgument(const std::string& name) const;
+
+    /// @brief Get argument name
+    ///
+    /// Returns the name of a registered argument.
+    ///
+    /// @param index Index of the argument.
+    ///
+    /// @return Name of the argument.
+    ///
+    /// @throw OutOfRange The index does not correspond to a registered
+    ///        argument.
+    std::string getArgumentName(int index) const;
+
+    /// @brief Return number of registered arguments
+    ///
+    /// @return Number of registered argument names.  The indexes of the
+    ///         arguments are in the range 0 to this number minus one.
+    int getArgumentCount() const;
+
     /// @brief Return ServerHooks object
     ///
     /// Returns the global ServerHooks object.
@@ -238,6 +289,29 @@ private:
     InverseHookCollection inverse_hooks_;   ///< Hook index/name collection
 
     ParkingLotsPtr parking_lots_;
+
+    /// @brief Argument name/index collection and index/name collection.
+    struct ArgumentCollection {
+        std::unordered_map<std::string, int> indexes_;
+        std::vector<std::string> names_;
+    };
+
+    /// @brief Pointer to an argument collection.
+    typedef boost::shared_ptr<const ArgumentCollection> ArgumentCollectionPtr;
+
+    /// Current argument collection.  It is never modified: the registration
+    /// of a new name replaces it with an updated copy.
+    std::atomic<const ArgumentCollection*> arguments_;
+
+    /// All the argument collections, as the lookups running in other
+    /// threads may still use a replaced one.  The argument names are few
+    /// and mostly registered at startup, so keeping them costs little.
+    std::vector<ArgumentCollectionPtr> argument_collections_;
+
+    /// Mutex serializing the argument name registrations when
+    /// multi-threading is enabled, as the callouts may register new
+    /// argument names when processing packets.
+    std::mutex arguments_mutex_;
 };
 
 } // namespace util
@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 
+
 using namespace isc::hooks;
 using namespace std;
 
@@ -301,6 +302,49 @@ TEST_F(CalloutHandleTest, DeleteAllArguments) {
     EXPECT_THROW(handle.getArgument("four", value), NoSuchArgument);
 }
 
+// Test that the arguments can be accessed by index.
+
+TEST_F(CalloutHandleTest, ArgumentIndexes) {
+    int one = ServerHooks::getServerHooks().registerArgument("index-one");
+    CalloutHandle handle(getCalloutManager());
+
+    // An argument registered after the construction of the handle.
+    int two = ServerHooks::getServerHooks().registerArgument("index-two");
+
+    int value = 0;
+    handle.setArgument(one, 1);
+    handle.setArgument("index-two", 2);
+    handle.getArgument("index-one", value);
+    EXPECT_EQ(1, value);
+    handle.getArgument(two, value);
+    EXPECT_EQ(2, value);
+
+    vector<string> expected_names = { "index-one", "index-two" };
+    EXPECT_TRUE(expected_names == handle.getArgumentNames());
+
+    // Delete by index.
+    handle.deleteArgument(one);
+    EXPECT_THROW(handle.getArgument(one, value), NoSuchArgument);
+    EXPECT_THROW(handle.getArgument("index-one", value), NoSuchArgument);
+    handle.getArgument(two, value);
+    EXPECT_EQ(2, value);
+    EXPECT_NO_THROW(handle.deleteArgument(one));
+
+    // Invalid indexes.
+    EXPECT_THROW(handle.getArgument(-1, value), NoSuchArgument);
+    EXPECT_THROW(handle.getArgument(1000000, value), NoSuchArgument);
+    EXPECT_THROW(handle.setArgument(-1, value), isc::OutOfRange);
+    EXPECT_NO_THROW(handle.deleteArgument(-1));
+
+    // The table is reused after all the arguments were deleted.
+    handle.deleteAllArguments();
+    EXPECT_TRUE(handle.getArgumentNames().empty());
+    EXPECT_THROW(handle.getArgument(two, value), NoSuchArgument);
+    handle.setArgument(two, 3);
+    handle.getArgument("index-two", value);
+    EXPECT_EQ(3, value);
+}
+
 // Test the "status" field.
 TEST_F(CalloutHandleTest, StatusField) {
     CalloutHandle handle(getCalloutManager());
@@ -7,15 +7,18 @@
 #include <config.h>
 
 #include <hooks/server_hooks.h>
+#include <util/multi_threading_mgr.h>
 
 #include <gtest/gtest.h>
 
 #include <algorithm>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace isc;
 using namespace isc::hooks;
+using namespace isc::util;
 using namespace std;
 
 namespace {
@@ -219,6 +222,75 @@ TEST(ServerHooksTest, HookToCommandName) {
     EXPECT_TRUE(ServerHooks::hookToCommandName("abc").empty());
 }
 
+// Check that the argument names are registered once and are not cleared
+// by a reset.
+
+TEST(ServerHooksTest, RegisterArguments) {
+    ServerHooks& hooks = ServerHooks::getServerHooks();
+
+    int alpha = hooks.registerArgument("argument-alpha");
+    int beta = hooks.registerArgument("argument-beta");
+    EXPECT_NE(alpha, beta);
+    EXPECT_EQ(alpha, hooks.registerArgument("argument-alpha"));
+    EXPECT_EQ(alpha, hooks.findArgument("argument-alpha"));
+    EXPECT_EQ(beta, hooks.findArgument("argument-beta"));
+    EXPECT_EQ(-1, hooks.findArgument("argument-unknown"));
+    EXPECT_EQ("argument-alpha", hooks.getArgumentName(alpha));
+    EXPECT_EQ("argument-beta", hooks.getArgumentName(beta));
+    EXPECT_GT(hooks.getArgumentCount(), beta);
+    EXPECT_THROW(hooks.getArgumentName(-1), isc::OutOfRange);
+    EXPECT_THROW(hooks.getArgumentName(hooks.getArgumentCount()),
+                 isc::OutOfRange);
+
+    hooks.reset();
+    EXPECT_EQ(alpha, hooks.findArgument("argument-alpha"));
+    EXPECT_EQ("argument-beta", hooks.getArgumentName(beta));
+}
+
+// Check that the argument names registered by concurrent threads are
+// found by the lookups running meanwhile.
+
+TEST(ServerHooksTest, RegisterArgumentsMultiThreading) {
+    ServerHooks& hooks = ServerHooks::getServerHooks();
+    MultiThreadingMgr::instance().setMode(true);
+
+    int known = hooks.registerArgument("argument-known");
+    const size_t threads_count = 4;
+    const size_t names_count = 100;
+    vector<vector<int>> indexes(threads_count);
+    vector<bool> lookups(threads_count, true);
+    vector<thread> threads;
+    for (size_t t = 0; t < threads_count; ++t) {
+        threads.push_back(thread([&, t]() {
+            for (size_t i = 0; i < names_count; ++i) {
+                string name = "argument-" + to_string(t) + "-" + to_string(i);
+                indexes[t].push_back(hooks.registerArgument(name));
+                if ((hooks.findArgument("argument-known") != known) ||
+                    (hooks.findArgument(name) != indexes[t].back())) {
+                    lookups[t] = false;
+                }
+            }
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    MultiThreadingMgr::instance().setMode(false);
+
+    vector<int> all;
+    for (size_t t = 0; t < threads_count; ++t) {
+        EXPECT_TRUE(lookups[t]);
+        for (size_t i = 0; i < names_count; ++i) {
+            EXPECT_EQ("argument-" + to_string(t) + "-" + to_string(i),
+                      hooks.getArgumentName(indexes[t][i]));
+            all.push_back(indexes[t][i]);
+        }
+    }
+    // The indexes are distinct.
+    sort(all.begin(), all.end());
+    EXPECT_TRUE(adjacent_find(all.begin(), all.end()) == all.end());
+}
+
 TEST(ServerHooksTest, getParkingLots) {
     ServerHooks& hooks = ServerHooks::getServerHooks();
     hooks.reset();
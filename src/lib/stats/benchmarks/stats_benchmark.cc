@@ -0,0 +1,111 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stats_mgr.h>
+#include <util/benchmarks/micro_benchmark.h>
+#include <util/benchmarks/worker_threads.h>
+
+#include <boost/make_shared.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::stats;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+/// This file contains the microbenchmarks of the libkea-stats statistics
+/// updates by concurrent threads, as the packet processing threads do.
+
+namespace {
+
+/// @brief The number of threads updating the statistics.
+const size_t THREADS = 16;
+
+/// @brief The number of updates by each thread in an operation.
+const size_t ROUND = 1000;
+
+/// @brief The number of per-subnet statistics.
+const size_t STATS = 1000;
+
+/// @brief Returns the names of per-subnet statistics set to 0.
+///
+/// @return the names.
+boost::shared_ptr<vector<string>>
+makeSubnetStats() {
+    StatsMgr::instance().removeAll();
+    auto names = boost::make_shared<vector<string>>();
+    for (size_t i = 0; i < STATS; ++i) {
+        names->push_back(StatsMgr::generateName("subnet", i + 1,
+                                                "assigned-addresses"));
+        StatsMgr::instance().setValue(names->back(), static_cast<int64_t>(0));
+    }
+    return (names);
+}
+
+/// @brief Adds the cases of the statistics updates.
+///
+/// An operation is a round of 1000 updates by each of 16 threads, with
+/// the default limit of 20 samples per statistic.
+///
+/// @param bench the benchmark.
+void
+addStatsMgrCases(MicroBenchmark& bench) {
+    // The threads increment 1000 per-subnet statistics in turn, as the
+    // packet processing does.
+    bench.add("StatsMgr/add-value-subnets-mt", [](DataGenerator&) {
+        auto names = makeSubnetStats();
+        auto workers = boost::make_shared<WorkerThreads>(THREADS, [names](size_t index) {
+            for (size_t i = 0; i < ROUND; ++i) {
+                StatsMgr::instance().addValue((*names)[(i + index) % STATS],
+                                              static_cast<int64_t>(1));
+            }
+        });
+        return ([workers]() {
+            workers->run();
+        });
+    });
+
+    // The threads increment the same global statistic.
+    bench.add("StatsMgr/add-value-global-mt", [](DataGenerator&) {
+        StatsMgr::instance().removeAll();
+        auto workers = boost::make_shared<WorkerThreads>(THREADS, [](size_t) {
+            for (size_t i = 0; i < ROUND; ++i) {
+                StatsMgr::instance().addValue("pkt4-received",
+                                              static_cast<int64_t>(1));
+            }
+        });
+        return ([workers]() {
+            workers->run();
+        });
+    });
+
+    // The threads increment the same global statistic with a counter.
+    bench.add("StatCounter/add-global-mt", [](DataGenerator&) {
+        StatsMgr::instance().removeAll();
+        StatCounterPtr counter = StatsMgr::instance().getCounter("pkt4-sent");
+        auto workers = boost::make_shared<WorkerThreads>(THREADS, [counter](size_t) {
+            for (size_t i = 0; i < ROUND; ++i) {
+                counter->add();
+            }
+        });
+        return ([workers]() {
+            workers->run();
+        });
+    });
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    MicroBenchmark bench("libkea-stats");
+    addStatsMgrCases(bench);
+    return (bench.run(argc, argv));
+}
@@ -10,7 +10,9 @@
 #include <util/chrono_time_utils.h>
 #include <cc/data.h>
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <utility>
 
 using namespace std;
@@ -223,28 +225,35 @@ void Observation::setValueInternal(SampleType value, StorageType& storage,
                   << typeToText(type_));
     }
 
-    if (storage.empty()) {
-        storage.push_back(make_pair(value, SampleClock::now()));
+    // The ring keeps at least one sample.
+    size_t limit = numeric_limits<size_t>::max();
+    if (max_sample_count_.first) {
+        limit = max(static_cast<size_t>(max_sample_count_.second),
+                    static_cast<size_t>(1));
+    }
+
+    // Grow the ring when it is full and the count limit is not reached:
+    // otherwise pushing a sample overwrites the oldest one.
+    if (storage.full() && (storage.capacity() < limit)) {
+        size_t capacity = max(storage.capacity() * 2, static_cast<size_t>(1));
+        storage.set_capacity(min(capacity, limit));
+    }
+    storage.push_front(make_pair(value, SampleClock::now()));
+
+    if (max_sample_count_.first) {
+        // The count limit may have been lowered without shrinking the ring.
+        while (storage.size() > limit) {
+            storage.pop_back(); // removing the last element
+        }
     } else {
-        // Storing of more than one sample
-        storage.push_front(make_pair(value, SampleClock::now()));
-
-        if (max_sample_count_.first) {
-            // if max_sample_count_ is set to true
-            // and size of storage is equal to max_sample_count_
-            if (storage.size() > max_sample_count_.second) {
-                storage.pop_back(); // removing the last element
-            }
-        } else {
-            StatsDuration range_of_storage =
+        StatsDuration range_of_storage =
+            storage.front().second - storage.back().second;
+        // removing samples until the range_of_storage
+        // stops exceeding the duration limit
+        while (range_of_storage > max_sample_age_.second) {
+            storage.pop_back();
+            range_of_storage =
                 storage.front().second - storage.back().second;
-            // removing samples until the range_of_storage
-            // stops exceeding the duration limit
-            while (range_of_storage > max_sample_age_.second) {
-                storage.pop_back();
-                range_of_storage =
-                    storage.front().second - storage.back().second;
-            }
         }
     }
 }
@@ -321,7 +330,7 @@ std::list<SampleType> Observation::getValuesInternal(Storage& storage,
         // still be there.
         isc_throw(Unexpected, "Observation storage container empty");
     }
-    return (storage);
+    return (std::list<SampleType>(storage.begin(), storage.end()));
 }
 
 template<typename StorageType>
@@ -369,6 +378,13 @@ void Observation::setMaxSampleCountInternal(StorageType& storage,
         // deleting elements which are exceeding the max_samples limit
         storage.pop_back();
     }
+
+    // Release the memory above the new limit.
+    size_t capacity = max(static_cast<size_t>(max_samples),
+                          static_cast<size_t>(1));
+    if (storage.capacity() > capacity) {
+        storage.set_capacity(capacity);
+    }
 }
 
 void Observation::setMaxSampleAgeDefault(const StatsDuration& duration) {
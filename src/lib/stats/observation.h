@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2024 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,7 @@
 #include <exceptions/exceptions.h>
 #include <util/bigints.h>
 
+#include <boost/circular_buffer.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include <chrono>
@@ -88,6 +89,10 @@ typedef std::pair<std::string, SampleClock::time_point> StringSample;
 /// @ref getJSON, which is generic and can be used for all types.
 ///
 /// Since Kea 1.6 multiple samples are stored for the same observation.
+/// The samples are kept newest first in a ring buffer which only grows
+/// until the sample count limit is reached (or until it holds the samples
+/// within the age limit): once it has, recording a sample overwrites the
+/// oldest one and allocates nothing.
 class Observation {
 public:
 
@@ -349,7 +354,7 @@ private:
     /// This method returns size of observed storage.
     /// It is used by public methods to return size of
     /// available storages.
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param storage storage which size will be returned
     /// @param exp_type expected observation type (used for sanity checking)
     /// @return size of storage
@@ -363,7 +368,7 @@ private:
     /// available storages.
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param value observation to be recorded
     /// @param storage observation will be stored here
     /// @param exp_type expected observation type (used for sanity checking)
@@ -375,7 +380,7 @@ private:
     /// @brief Returns a sample (internal version)
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -386,7 +391,7 @@ private:
     /// @brief Returns samples (internal version)
     ///
     /// @tparam SampleType type of samples (e.g. IntegerSample)
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -397,7 +402,7 @@ private:
 
     /// @brief Determines maximum age of samples.
     ///
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param storage storage on which limit will be set
     /// @param duration determines maximum age of samples
     /// @param exp_type expected observation type (used for sanity checking)
@@ -407,7 +412,7 @@ private:
 
     /// @brief Determines how many samples of a given statistic should be kept.
     ///
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param storage storage on which limit will be set
     /// @param max_samples determines maximum number of samples
     /// @param exp_type expected observation type (used for sanity checking)
@@ -459,19 +464,19 @@ private:
     /// @{
 
     /// @brief Storage for integer samples
-    std::list<IntegerSample> integer_samples_;
+    boost::circular_buffer<IntegerSample> integer_samples_;
 
     /// @brief Storage for big integer samples
-    std::list<BigIntegerSample> big_integer_samples_;
+    boost::circular_buffer<BigIntegerSample> big_integer_samples_;
 
     /// @brief Storage for floating point samples
-    std::list<FloatSample> float_samples_;
+    boost::circular_buffer<FloatSample> float_samples_;
 
     /// @brief Storage for time duration samples
-    std::list<DurationSample> duration_samples_;
+    boost::circular_buffer<DurationSample> duration_samples_;
 
     /// @brief Storage for string samples
-    std::list<StringSample> string_samples_;
+    boost::circular_buffer<StringSample> string_samples_;
     /// @}
 };
 
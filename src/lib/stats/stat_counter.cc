@@ -0,0 +1,43 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stat_counter.h>
+
+using namespace std;
+
+namespace isc {
+namespace stats {
+
+StatCounter::StatCounter(const string& name) : name_(name) {
+    for (auto& shard : shards_) {
+        shard.value_.store(0, memory_order_relaxed);
+    }
+}
+
+int64_t
+StatCounter::getPending() const {
+    int64_t value = 0;
+    for (auto const& shard : shards_) {
+        value += shard.value_.load(memory_order_relaxed);
+    }
+    return (value);
+}
+
+int64_t
+StatCounter::take() {
+    int64_t value = 0;
+    for (auto& shard : shards_) {
+        if (shard.value_.load(memory_order_relaxed) != 0) {
+            value += shard.value_.exchange(0, memory_order_relaxed);
+        }
+    }
+    return (value);
+}
+
+}  // namespace stats
+}  // namespace isc
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef STAT_COUNTER_H
+#define STAT_COUNTER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <string>
+
+#include <stdint.h>
+
+namespace isc {
+namespace stats {
+
+/// @brief Sharded integer counter feeding an integer statistic.
+///
+/// A counter is a handle on an integer statistic which is resolved once
+/// (see @ref StatsMgr::getCounter) and then incremented without looking
+/// the statistic up by name and without taking the Statistics Manager
+/// mutex: each thread adds to its own shard with a relaxed atomic
+/// operation. The shards are padded to a cache line so threads updating
+/// the same counter do not compete for it.
+///
+/// The pending value is moved into the statistic by the Statistics
+/// Manager when the statistic is read, reset or removed, so all the
+/// increments done between two reads are recorded as a single sample.
+class StatCounter : public boost::noncopyable {
+public:
+
+    /// @brief Number of shards.
+    ///
+    /// Threads are assigned a shard in turn, so two threads share a shard
+    /// only when there are more threads than shards.
+    static const size_t SHARD_COUNT = 32;
+
+    /// @brief Constructor.
+    ///
+    /// @param name name of the statistic the counter feeds.
+    explicit StatCounter(const std::string& name);
+
+    /// @brief Returns the name of the statistic the counter feeds.
+    const std::string& getName() const {
+        return (name_);
+    }
+
+    /// @brief Increments the counter.
+    ///
+    /// @param value the value to add.
+    void add(int64_t value = 1) {
+        shards_[getShardIndex()].value_.fetch_add(value,
+                                                  std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the value added since the last call to @ref take.
+    int64_t getPending() const;
+
+    /// @brief Returns the value added since the last call and resets it.
+    ///
+    /// Increments done concurrently are either included in the returned
+    /// value or left for the next call, never lost.
+    int64_t take();
+
+private:
+
+    /// @brief Returns the index of the shard of the current thread.
+    static size_t getShardIndex() {
+        static std::atomic<size_t> next_index(0);
+        static thread_local const size_t index =
+            next_index.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+        return (index);
+    }
+
+    /// @brief Counter shard, padded to its own cache line.
+    struct Shard {
+        /// @brief Value added by the threads using the shard.
+        std::atomic<int64_t> value_;
+
+        /// @brief Padding.
+        char padding_[64 - sizeof(std::atomic<int64_t>)];
+    };
+
+    /// @brief Name of the statistic.
+    std::string name_;
+
+    /// @brief The shards.
+    Shard shards_[SHARD_COUNT];
+};
+
+/// @brief Pointer to a counter.
+typedef boost::shared_ptr<StatCounter> StatCounterPtr;
+
+}  // namespace stats
+}  // namespace isc
+
+#endif // STAT_COUNTER_H
@@ -39,30 +39,35 @@ StatsMgr::StatsMgr() :
 void
 StatsMgr::setValue(const string& name, const int64_t value) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     setValueInternal(name, value);
 }
 
 void
 StatsMgr::setValue(const string& name, const int128_t& value) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     setValueInternal(name, value);
 }
 
 void
 StatsMgr::setValue(const string& name, const double value) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     setValueInternal(name, value);
 }
 
 void
 StatsMgr::setValue(const string& name, const StatsDuration& value) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     setValueInternal(name, value);
 }
 
 void
 StatsMgr::setValue(const string& name, const string& value) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     setValueInternal(name, value);
 }
 
@@ -96,9 +101,59 @@ StatsMgr::addValue(const string& name, const string& value) {
     addValueInternal(name, value);
 }
 
+StatCounterPtr
+StatsMgr::getCounter(const string& name) {
+    MultiThreadingLock lock(*mutex_);
+    auto it = counters_.find(name);
+    if (it != counters_.end()) {
+        return (it->second);
+    }
+    StatCounterPtr counter(new StatCounter(name));
+    counters_[name] = counter;
+    return (counter);
+}
+
+void
+StatsMgr::flushCounterInternal(const StatCounterPtr& counter) const {
+    int64_t value = counter->take();
+    if (value == 0) {
+        return;
+    }
+    ObservationPtr obs = getObservationInternal(counter->getName());
+    if (!obs) {
+        global_->add(boost::make_shared<Observation>(counter->getName(), value));
+        return;
+    }
+    try {
+        obs->addValue(value);
+    } catch (const InvalidStatType&) {
+        // The statistic was set to another type by name: the value
+        // can't be recorded, as addValue() would have thrown.
+    }
+}
+
+void
+StatsMgr::flushCounterInternal(const string& name) const {
+    if (counters_.empty()) {
+        return;
+    }
+    auto it = counters_.find(name);
+    if (it != counters_.end()) {
+        flushCounterInternal(it->second);
+    }
+}
+
+void
+StatsMgr::flushCountersInternal() const {
+    for (auto const& it : counters_) {
+        flushCounterInternal(it.second);
+    }
+}
+
 ObservationPtr
 StatsMgr::getObservation(const string& name) const {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     return (getObservationInternal(name));
 }
 
@@ -238,6 +293,7 @@ StatsMgr::getMaxSampleCountDefaultInternal() const {
 bool
 StatsMgr::reset(const string& name) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     return (resetInternal(name));
 }
 
@@ -254,6 +310,7 @@ StatsMgr::resetInternal(const string& name) {
 bool
 StatsMgr::del(const string& name) {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     return (delInternal(name));
 }
 
@@ -265,6 +322,7 @@ StatsMgr::delInternal(const string& name) {
 void
 StatsMgr::removeAll() {
     MultiThreadingLock lock(*mutex_);
+    flushCountersInternal();
     removeAllInternal();
 }
 
@@ -276,6 +334,7 @@ StatsMgr::removeAllInternal() {
 ConstElementPtr
 StatsMgr::get(const string& name) const {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     return (getInternal(name));
 }
 
@@ -292,6 +351,7 @@ StatsMgr::getInternal(const string& name) const {
 ConstElementPtr
 StatsMgr::getAll() const {
     MultiThreadingLock lock(*mutex_);
+    flushCountersInternal();
     return (getAllInternal());
 }
 
@@ -303,6 +363,7 @@ StatsMgr::getAllInternal() const {
 void
 StatsMgr::resetAll() {
     MultiThreadingLock lock(*mutex_);
+    flushCountersInternal();
     resetAllInternal();
 }
 
@@ -314,6 +375,7 @@ StatsMgr::resetAllInternal() {
 size_t
 StatsMgr::getSize(const string& name) const {
     MultiThreadingLock lock(*mutex_);
+    flushCounterInternal(name);
     return (getSizeInternal(name));
 }
 
@@ -329,6 +391,7 @@ StatsMgr::getSizeInternal(const string& name) const {
 size_t
 StatsMgr::count() const {
     MultiThreadingLock lock(*mutex_);
+    flushCountersInternal();
     return (countInternal());
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2024 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,7 @@
 
 #include <stats/observation.h>
 #include <stats/context.h>
+#include <stats/stat_counter.h>
 #include <util/bigints.h>
 
 #include <boost/noncopyable.hpp>
@@ -17,6 +18,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 
@@ -144,6 +146,21 @@ public:
     /// @throw InvalidStatType if statistic is not a string
     void addValue(const std::string& name, const std::string& value);
 
+    /// @brief Returns the counter feeding an integer statistic.
+    ///
+    /// The counter is created on the first call for a given name and the
+    /// same counter is returned by the next calls. Incrementing it has the
+    /// same effect as calling @ref addValue with an integer value, but
+    /// does not take the Statistics Manager mutex: the increments are
+    /// moved into the statistic, as a single sample, when the statistic
+    /// is read, reset or removed. This is intended for the statistics
+    /// updated for every packet, whose counter is resolved once and kept
+    /// by the caller.
+    ///
+    /// @param name name of the statistic
+    /// @return Pointer to the counter
+    StatCounterPtr getCounter(const std::string& name);
+
     /// @brief Determines maximum age of samples.
     ///
     /// Specifies that statistic name should be stored not as a single value,
@@ -792,11 +809,35 @@ private:
                                   uint32_t& max_samples,
                                   std::string& reason);
 
+    /// @brief Moves the pending value of a counter into its statistic.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param counter the counter
+    void flushCounterInternal(const StatCounterPtr& counter) const;
+
+    /// @brief Moves the pending value of the counter of a statistic, if
+    /// any, into the statistic.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the statistic
+    void flushCounterInternal(const std::string& name) const;
+
+    /// @brief Moves the pending values of all counters into their
+    /// statistics.
+    ///
+    /// Should be called in a thread safe context.
+    void flushCountersInternal() const;
+
     /// @brief This is a global context. All statistics will initially be stored here.
     StatContextPtr global_;
 
     /// @brief The mutex used to protect internal state.
     const boost::scoped_ptr<std::mutex> mutex_;
+
+    /// @brief Counters by statistic name.
+    std::unordered_map<std::string, StatCounterPtr> counters_;
 };
 
 }  // namespace stats
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stat_counter.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::stats;
+
+namespace {
+
+// Checks the basic operations of a counter.
+TEST(StatCounterTest, basic) {
+    StatCounter counter("alpha");
+    EXPECT_EQ("alpha", counter.getName());
+    EXPECT_EQ(0, counter.getPending());
+    EXPECT_EQ(0, counter.take());
+
+    counter.add();
+    counter.add(10);
+    counter.add(-3);
+    EXPECT_EQ(8, counter.getPending());
+
+    // Taking the value resets the counter.
+    EXPECT_EQ(8, counter.take());
+    EXPECT_EQ(0, counter.getPending());
+    EXPECT_EQ(0, counter.take());
+}
+
+// Checks that no increment is lost when several threads increment the
+// same counter while its value is taken.
+TEST(StatCounterTest, concurrent) {
+    const int threads_count = 40;
+    const int increments = 10000;
+    StatCounter counter("alpha");
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threads_count; ++i) {
+        threads.emplace_back([&counter, increments]() {
+            for (int j = 0; j < increments; ++j) {
+                counter.add();
+            }
+        });
+    }
+    int64_t total = 0;
+    for (int i = 0; i < 100; ++i) {
+        total += counter.take();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    total += counter.take();
+    EXPECT_EQ(threads_count * increments, total);
+}
+
+}  // namespace
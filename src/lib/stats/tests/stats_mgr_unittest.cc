@@ -521,6 +521,73 @@ TEST_F(StatsMgrTest, removeAll) {
     EXPECT_FALSE(StatsMgr::instance().getObservation("delta"));
 }
 
+// This test checks that counters feed their statistic.
+TEST_F(StatsMgrTest, counter) {
+    StatCounterPtr counter = StatsMgr::instance().getCounter("alpha");
+    ASSERT_TRUE(counter);
+    EXPECT_EQ("alpha", counter->getName());
+
+    // The same counter is returned for the same name.
+    EXPECT_EQ(counter, StatsMgr::instance().getCounter("alpha"));
+
+    // The statistic is created when it is read.
+    counter->add();
+    counter->add(2);
+    EXPECT_EQ(3, counter->getPending());
+    EXPECT_FALSE(StatsMgr::instance().getObservationInternal("alpha"));
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    EXPECT_EQ(3, alpha->getInteger().first);
+    EXPECT_EQ(0, counter->getPending());
+
+    // Counters and addValue() both add to the statistic.
+    counter->add(4);
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(10));
+    std::string exp = "{ \"alpha\": [ [ 17, \"";
+    EXPECT_EQ(0, StatsMgr::instance().get("alpha")->str().find(exp));
+    EXPECT_EQ(0, StatsMgr::instance().getAll()->get("alpha")->str().find("[ [ 17, "));
+
+    // Setting the statistic overrides the previous increments.
+    counter->add(5);
+    StatsMgr::instance().setValue("alpha", static_cast<int64_t>(100));
+    counter->add(1);
+    EXPECT_EQ(101, alpha->getInteger().first + counter->getPending());
+    EXPECT_EQ(101,
+              StatsMgr::instance().getObservation("alpha")->getInteger().first);
+
+    // Resetting the statistic drops the pending increments.
+    counter->add(5);
+    EXPECT_TRUE(StatsMgr::instance().reset("alpha"));
+    EXPECT_EQ(0,
+              StatsMgr::instance().getObservation("alpha")->getInteger().first);
+    counter->add(5);
+    StatsMgr::instance().resetAll();
+    EXPECT_EQ(0,
+              StatsMgr::instance().getObservation("alpha")->getInteger().first);
+
+    // So does removing it.
+    counter->add(5);
+    EXPECT_TRUE(StatsMgr::instance().del("alpha"));
+    EXPECT_FALSE(StatsMgr::instance().getObservation("alpha"));
+    counter->add(5);
+    StatsMgr::instance().removeAll();
+    EXPECT_EQ(0, StatsMgr::instance().count());
+
+    // The counter is still usable.
+    counter->add(6);
+    EXPECT_EQ(1, StatsMgr::instance().count());
+    EXPECT_EQ(6,
+              StatsMgr::instance().getObservation("alpha")->getInteger().first);
+
+    // A value which does not fit the statistic type is dropped.
+    EXPECT_TRUE(StatsMgr::instance().del("alpha"));
+    StatsMgr::instance().setValue("alpha", "Lorem ipsum");
+    counter->add(6);
+    EXPECT_NO_THROW(StatsMgr::instance().getAll());
+    EXPECT_EQ("Lorem ipsum",
+              StatsMgr::instance().getObservation("alpha")->getString().first);
+}
+
 // This is a performance benchmark that checks how long does it take
 // to increment a single statistic million times.
 //
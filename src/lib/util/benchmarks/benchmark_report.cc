@@ -0,0 +1,184 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/benchmarks/benchmark_report.h>
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+namespace {
+
+/// @brief The percentiles of the report.
+const double PERCENTILES[] = { 50, 90, 99, 99.9 };
+
+/// @brief Returns the name of a percentile.
+///
+/// @param percentile the percentile.
+/// @return the name, e.g. "p99.9".
+string
+percentileName(double percentile) {
+    ostringstream s;
+    s << "p" << percentile;
+    return (s.str());
+}
+
+/// @brief Prints a latency.
+///
+/// @param os the output stream.
+/// @param nanoseconds the latency in nanoseconds.
+/// @param unit the unit of the printed latency.
+void
+printLatency(ostream& os, uint64_t nanoseconds, BenchmarkReport::Unit unit) {
+    if (unit == BenchmarkReport::NANOSECONDS) {
+        os << " " << setw(10) << nanoseconds;
+    } else {
+        os << " " << setw(10) << fixed << setprecision(1)
+           << (static_cast<double>(nanoseconds) / 1000);
+    }
+}
+
+}
+
+BenchmarkReport::BenchmarkReport(const string& name)
+    : name_(name), parameters_(), results_(), unit_(MICROSECONDS) {
+}
+
+void
+BenchmarkReport::addParameter(const string& name, const string& value) {
+    parameters_.push_back(make_pair(name, value));
+}
+
+void
+BenchmarkReport::addResult(const string& name, const LatencyStats& latency,
+                           double rate) {
+    Result result;
+    result.name_ = name;
+    result.latency_ = latency;
+    result.rate_ = rate;
+    results_.push_back(result);
+}
+
+void
+BenchmarkReport::print(ostream& os, Format format) const {
+    if (format == JSON) {
+        printJson(os);
+    } else {
+        printText(os);
+    }
+}
+
+string
+BenchmarkReport::quote(const string& text) {
+    ostringstream s;
+    s << "\"";
+    for (auto const& c : text) {
+        switch (c) {
+        case '"':
+            s << "\\\"";
+            break;
+        case '\\':
+            s << "\\\\";
+            break;
+        case '\n':
+            s << "\\n";
+            break;
+        case '\t':
+            s << "\\t";
+            break;
+        default:
+            if ((c >= 0) && (c < 0x20)) {
+                s << "\\u" << hex << setw(4) << setfill('0')
+                  << static_cast<unsigned>(c) << dec << setfill(' ');
+            } else {
+                s << c;
+            }
+        }
+    }
+    s << "\"";
+    return (s.str());
+}
+
+void
+BenchmarkReport::printText(ostream& os) const {
+    os << name_ << endl;
+    for (auto const& parameter : parameters_) {
+        os << "  " << parameter.first << ": " << parameter.second << endl;
+    }
+    size_t width = 12;
+    for (auto const& result : results_) {
+        width = max(width, result.name_.size() + 2);
+    }
+    os << left << setw(width) << "name" << right
+       << " " << setw(9) << "count"
+       << " " << setw(12) << "ops/s"
+       << " " << setw(10) << "mean"
+       << " " << setw(10) << "min";
+    for (auto const& percentile : PERCENTILES) {
+        os << " " << setw(10) << percentileName(percentile);
+    }
+    os << " " << setw(10) << "max"
+       << (unit_ == NANOSECONDS ? "  (ns)" : "  (us)") << endl;
+    for (auto const& result : results_) {
+        const LatencyStats& latency = result.latency_;
+        os << left << setw(width) << result.name_ << right
+           << " " << setw(9) << latency.getCount() << " " << setw(12);
+        if (result.rate_ > 0) {
+            os << fixed << setprecision(0) << result.rate_;
+        } else {
+            os << "-";
+        }
+        printLatency(os, latency.getMean(), unit_);
+        printLatency(os, latency.getMin(), unit_);
+        for (auto const& percentile : PERCENTILES) {
+            printLatency(os, latency.getPercentile(percentile), unit_);
+        }
+        printLatency(os, latency.getMax(), unit_);
+        os << endl;
+    }
+}
+
+void
+BenchmarkReport::printJson(ostream& os) const {
+    os << "{ \"benchmark\": " << quote(name_) << ", \"parameters\": {";
+    bool first = true;
+    for (auto const& parameter : parameters_) {
+        os << (first ? " " : ", ") << quote(parameter.first) << ": "
+           << quote(parameter.second);
+        first = false;
+    }
+    os << " }, \"results\": [";
+    first = true;
+    for (auto const& result : results_) {
+        const LatencyStats& latency = result.latency_;
+        os << (first ? "" : ",") << endl
+           << "  { \"name\": " << quote(result.name_)
+           << ", \"count\": " << latency.getCount();
+        if (result.rate_ > 0) {
+            os << ", \"rate\": " << fixed << setprecision(1) << result.rate_;
+        }
+        os << ", \"mean-ns\": " << latency.getMean()
+           << ", \"min-ns\": " << latency.getMin();
+        for (auto const& percentile : PERCENTILES) {
+            os << ", " << quote(percentileName(percentile) + "-ns") << ": "
+               << latency.getPercentile(percentile);
+        }
+        os << ", \"max-ns\": " << latency.getMax() << " }";
+        first = false;
+    }
+    os << endl << "] }" << endl;
+}
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
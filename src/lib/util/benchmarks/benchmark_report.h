@@ -0,0 +1,124 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <util/benchmarks/latency_stats.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+/// @brief Results of a benchmark run.
+///
+/// A result is the latency of an operation (e.g. a processing stage of a
+/// packet) with an optional rate of operations per second. The report is
+/// printed as a text table for humans or as JSON for the tools comparing
+/// the runs.
+class BenchmarkReport {
+public:
+
+    /// @brief Output formats.
+    enum Format {
+        TEXT,
+        JSON
+    };
+
+    /// @brief Units of the latencies in the text format.
+    enum Unit {
+        MICROSECONDS,
+        NANOSECONDS
+    };
+
+    /// @brief Constructor.
+    ///
+    /// @param name the name of the benchmark.
+    explicit BenchmarkReport(const std::string& name);
+
+    /// @brief Adds a parameter of the run, e.g. the number of clients.
+    ///
+    /// @param name the name of the parameter.
+    /// @param value the value of the parameter.
+    void addParameter(const std::string& name, const std::string& value);
+
+    /// @brief Adds a result.
+    ///
+    /// @param name the name of the result.
+    /// @param latency the latency of the operations.
+    /// @param rate the number of operations per second or 0 when not
+    /// applicable.
+    void addResult(const std::string& name, const LatencyStats& latency,
+                   double rate = 0);
+
+    /// @brief Sets the unit of the latencies in the text format.
+    ///
+    /// @param unit the unit (microseconds by default).
+    void setUnit(Unit unit) {
+        unit_ = unit;
+    }
+
+    /// @brief Prints the report.
+    ///
+    /// The latencies are printed in the unit set by @c setUnit in the
+    /// text format and in nanoseconds in the JSON format.
+    ///
+    /// @param os the output stream.
+    /// @param format the output format.
+    void print(std::ostream& os, Format format = TEXT) const;
+
+    /// @brief Returns a string quoted for JSON.
+    ///
+    /// @param text the string.
+    /// @return the quoted string.
+    static std::string quote(const std::string& text);
+
+private:
+
+    /// @brief A result.
+    struct Result {
+        /// @brief The name of the result.
+        std::string name_;
+
+        /// @brief The latency of the operations.
+        LatencyStats latency_;
+
+        /// @brief The number of operations per second.
+        double rate_;
+    };
+
+    /// @brief Prints the report as a text table.
+    ///
+    /// @param os the output stream.
+    void printText(std::ostream& os) const;
+
+    /// @brief Prints the report as JSON.
+    ///
+    /// @param os the output stream.
+    void printJson(std::ostream& os) const;
+
+    /// @brief The name of the benchmark.
+    std::string name_;
+
+    /// @brief The parameters of the run.
+    std::vector<std::pair<std::string, std::string>> parameters_;
+
+    /// @brief The results.
+    std::vector<Result> results_;
+
+    /// @brief The unit of the latencies in the text format.
+    Unit unit_;
+};
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // BENCHMARK_REPORT_H
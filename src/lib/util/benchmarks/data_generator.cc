@@ -0,0 +1,74 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/benchmarks/data_generator.h>
+
+#include <limits>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+const uint64_t DataGenerator::DEFAULT_SEED;
+
+DataGenerator::DataGenerator(uint64_t seed) : engine_(seed) {
+}
+
+uint64_t
+DataGenerator::uniform(uint64_t min, uint64_t max) {
+    if (min > max) {
+        isc_throw(BadValue, "empty range [" << min << ", " << max << "]");
+    }
+    uint64_t span = max - min;
+    if (span == numeric_limits<uint64_t>::max()) {
+        return (next());
+    }
+    // Reject the values of the last incomplete span so the result is
+    // not biased.
+    ++span;
+    uint64_t limit = numeric_limits<uint64_t>::max() -
+        numeric_limits<uint64_t>::max() % span;
+    uint64_t value;
+    do {
+        value = next();
+    } while (value >= limit);
+    return (min + value % span);
+}
+
+vector<uint8_t>
+DataGenerator::bytes(size_t length) {
+    vector<uint8_t> result;
+    result.reserve(length);
+    while (result.size() < length) {
+        uint64_t value = next();
+        for (size_t i = 0; (i < sizeof(value)) && (result.size() < length); ++i) {
+            result.push_back(static_cast<uint8_t>(value));
+            value >>= 8;
+        }
+    }
+    return (result);
+}
+
+string
+DataGenerator::name(size_t length) {
+    static const char CHARS[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    string result;
+    result.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        // Letters only for the first character.
+        result.push_back(CHARS[uniform(0, (i == 0 ? 25 : sizeof(CHARS) - 2))]);
+    }
+    return (result);
+}
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
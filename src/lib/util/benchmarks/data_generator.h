@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+/// @brief Fixed-seed generator of benchmark data.
+///
+/// The benchmarks of two releases must run on the same data so the
+/// generated values depend only on the seed. The engine is
+/// @c std::mt19937_64, which sequence is specified by the standard, and
+/// the values are derived from it without the standard distributions,
+/// which differ between the C++ library implementations.
+class DataGenerator {
+public:
+
+    /// @brief The default seed.
+    static const uint64_t DEFAULT_SEED = 1;
+
+    /// @brief Constructor.
+    ///
+    /// @param seed the seed.
+    explicit DataGenerator(uint64_t seed = DEFAULT_SEED);
+
+    /// @brief Returns the next 64 bit random value.
+    uint64_t next() {
+        return (engine_());
+    }
+
+    /// @brief Returns a value in a range.
+    ///
+    /// @param min the smallest value.
+    /// @param max the largest value.
+    /// @return a value between min and max included.
+    /// @throw BadValue when min is larger than max.
+    uint64_t uniform(uint64_t min, uint64_t max);
+
+    /// @brief Returns random bytes.
+    ///
+    /// @param length the number of bytes.
+    /// @return the bytes.
+    std::vector<uint8_t> bytes(size_t length);
+
+    /// @brief Returns a random name of lowercase letters and digits.
+    ///
+    /// The name starts with a letter so it is a valid DNS label.
+    ///
+    /// @param length the length of the name.
+    /// @return the name.
+    std::string name(size_t length);
+
+    /// @brief Shuffles a vector.
+    ///
+    /// @tparam T the type of the elements.
+    /// @param values the vector.
+    template<typename T>
+    void shuffle(std::vector<T>& values) {
+        for (size_t i = values.size(); i > 1; --i) {
+            std::swap(values[i - 1], values[uniform(0, i - 1)]);
+        }
+    }
+
+private:
+
+    /// @brief The engine.
+    std::mt19937_64 engine_;
+};
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // DATA_GENERATOR_H
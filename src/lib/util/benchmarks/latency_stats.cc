@@ -0,0 +1,91 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/benchmarks/latency_stats.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+LatencyStats::LatencyStats() : samples_(), sorted_(true), total_(0) {
+}
+
+void
+LatencyStats::add(uint64_t nanoseconds) {
+    if (sorted_ && !samples_.empty() && (nanoseconds < samples_.back())) {
+        sorted_ = false;
+    }
+    samples_.push_back(nanoseconds);
+    total_ += nanoseconds;
+}
+
+uint64_t
+LatencyStats::getMean() const {
+    if (samples_.empty()) {
+        return (0);
+    }
+    return (total_ / samples_.size());
+}
+
+uint64_t
+LatencyStats::getMin() const {
+    if (samples_.empty()) {
+        return (0);
+    }
+    sort();
+    return (samples_.front());
+}
+
+uint64_t
+LatencyStats::getMax() const {
+    if (samples_.empty()) {
+        return (0);
+    }
+    sort();
+    return (samples_.back());
+}
+
+uint64_t
+LatencyStats::getPercentile(double percentile) const {
+    if ((percentile < 0) || (percentile > 100)) {
+        isc_throw(BadValue, "percentile " << percentile
+                  << " is not between 0 and 100");
+    }
+    if (samples_.empty()) {
+        return (0);
+    }
+    sort();
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * samples_.size()));
+    if (rank == 0) {
+        rank = 1;
+    }
+    return (samples_[rank - 1]);
+}
+
+void
+LatencyStats::clear() {
+    samples_.clear();
+    sorted_ = true;
+    total_ = 0;
+}
+
+void
+LatencyStats::sort() const {
+    if (!sorted_) {
+        std::sort(samples_.begin(), samples_.end());
+        sorted_ = true;
+    }
+}
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
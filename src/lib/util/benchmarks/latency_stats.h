@@ -0,0 +1,97 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+/// @brief Latency samples of a benchmarked operation.
+///
+/// The samples are kept so the percentiles are exact. A benchmark records
+/// one sample per operation, i.e. up to a few millions of samples.
+class LatencyStats {
+public:
+
+    /// @brief Constructor.
+    LatencyStats();
+
+    /// @brief Adds a sample.
+    ///
+    /// @param nanoseconds the latency in nanoseconds.
+    void add(uint64_t nanoseconds);
+
+    /// @brief Adds a sample.
+    ///
+    /// @param duration the latency.
+    void add(std::chrono::steady_clock::duration duration) {
+        add(static_cast<uint64_t>(std::chrono::duration_cast<
+                                  std::chrono::nanoseconds>(duration).count()));
+    }
+
+    /// @brief Returns the number of samples.
+    size_t getCount() const {
+        return (samples_.size());
+    }
+
+    /// @brief Returns the sum of the samples in nanoseconds.
+    uint64_t getTotal() const {
+        return (total_);
+    }
+
+    /// @brief Returns the mean of the samples in nanoseconds.
+    ///
+    /// @return the mean or 0 when there is no sample.
+    uint64_t getMean() const;
+
+    /// @brief Returns the smallest sample in nanoseconds.
+    ///
+    /// @return the smallest sample or 0 when there is no sample.
+    uint64_t getMin() const;
+
+    /// @brief Returns the largest sample in nanoseconds.
+    ///
+    /// @return the largest sample or 0 when there is no sample.
+    uint64_t getMax() const;
+
+    /// @brief Returns a percentile of the samples in nanoseconds.
+    ///
+    /// Uses the nearest-rank method.
+    ///
+    /// @param percentile the percentile between 0 and 100.
+    /// @return the percentile or 0 when there is no sample.
+    /// @throw BadValue when the percentile is out of range.
+    uint64_t getPercentile(double percentile) const;
+
+    /// @brief Removes all the samples.
+    void clear();
+
+private:
+
+    /// @brief Sorts the samples if needed.
+    void sort() const;
+
+    /// @brief The samples.
+    mutable std::vector<uint64_t> samples_;
+
+    /// @brief Whether the samples are sorted.
+    mutable bool sorted_;
+
+    /// @brief The sum of the samples.
+    uint64_t total_;
+};
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,227 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/benchmarks/micro_benchmark.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+namespace {
+
+/// @brief The sink of the values kept by the bodies.
+volatile uint64_t sink;
+
+/// @brief The target duration of a batch in nanoseconds.
+const uint64_t BATCH_NS = 10000;
+
+/// @brief The largest automatic batch.
+const size_t MAX_BATCH = 1000;
+
+}
+
+const size_t MicroBenchmark::DEFAULT_SAMPLES;
+const size_t MicroBenchmark::AUTO_BATCH;
+constexpr double MicroBenchmark::DEFAULT_DURATION;
+
+MicroBenchmark::MicroBenchmark(const string& name)
+    : name_(name), cases_(), samples_(DEFAULT_SAMPLES), batch_(AUTO_BATCH),
+      duration_(DEFAULT_DURATION), seed_(DataGenerator::DEFAULT_SEED),
+      filter_() {
+}
+
+void
+MicroBenchmark::add(const string& name, const Setup& setup) {
+    Case c;
+    c.name_ = name;
+    c.setup_ = setup;
+    cases_.push_back(c);
+}
+
+vector<string>
+MicroBenchmark::getCaseNames() const {
+    vector<string> names;
+    for (auto const& c : cases_) {
+        if (c.name_.find(filter_) != string::npos) {
+            names.push_back(c.name_);
+        }
+    }
+    return (names);
+}
+
+size_t
+MicroBenchmark::getBatch(Body& body) const {
+    if (batch_ != AUTO_BATCH) {
+        return (batch_);
+    }
+    auto start = chrono::steady_clock::now();
+    body();
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - start).count();
+    if (ns >= BATCH_NS) {
+        return (1);
+    }
+    return (min(MAX_BATCH, static_cast<size_t>(BATCH_NS / (ns ? ns : 1))));
+}
+
+void
+MicroBenchmark::run(BenchmarkReport& report) const {
+    if (samples_ == 0) {
+        isc_throw(BadValue, "the number of samples must not be 0");
+    }
+    report.addParameter("seed", to_string(seed_));
+    report.addParameter("samples", to_string(samples_));
+    report.addParameter("batch", batch_ == AUTO_BATCH ? "auto" : to_string(batch_));
+    ostringstream duration;
+    duration << duration_;
+    report.addParameter("duration", duration.str());
+    auto max_duration = chrono::duration_cast<chrono::steady_clock::duration>(
+        chrono::duration<double>(duration_));
+    for (auto const& c : cases_) {
+        if (c.name_.find(filter_) == string::npos) {
+            continue;
+        }
+        // Each case gets its own generator so its data does not depend
+        // on the other selected cases.
+        DataGenerator generator(seed_);
+        Body body = c.setup_(generator);
+        size_t batch = getBatch(body);
+        for (size_t i = 0; i < batch; ++i) {
+            body();
+        }
+        LatencyStats latency;
+        chrono::steady_clock::duration elapsed(0);
+        auto case_start = chrono::steady_clock::now();
+        for (size_t sample = 0; sample < samples_; ++sample) {
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < batch; ++i) {
+                body();
+            }
+            auto end = chrono::steady_clock::now();
+            elapsed += end - start;
+            latency.add((end - start) / batch);
+            if ((duration_ > 0) && (end - case_start >= max_duration)) {
+                break;
+            }
+        }
+        double seconds = chrono::duration<double>(elapsed).count();
+        report.addResult(c.name_, latency, seconds > 0 ?
+                         (latency.getCount() * batch) / seconds : 0);
+    }
+}
+
+int
+MicroBenchmark::run(int argc, char* argv[]) {
+    bool json = false;
+    bool list = false;
+    int ch;
+    try {
+        while ((ch = getopt(argc, argv, "n:b:t:s:f:lj")) != -1) {
+            switch (ch) {
+            case 'n':
+                samples_ = boost::lexical_cast<size_t>(optarg);
+                break;
+
+            case 'b':
+                batch_ = boost::lexical_cast<size_t>(optarg);
+                break;
+
+            case 't':
+                duration_ = boost::lexical_cast<double>(optarg);
+                break;
+
+            case 's':
+                seed_ = boost::lexical_cast<uint64_t>(optarg);
+                break;
+
+            case 'f':
+                filter_ = optarg;
+                break;
+
+            case 'l':
+                list = true;
+                break;
+
+            case 'j':
+                json = true;
+                break;
+
+            default:
+                usage(argv[0]);
+                return (EXIT_FAILURE);
+            }
+        }
+    } catch (const boost::bad_lexical_cast&) {
+        cerr << "invalid number: " << optarg << endl;
+        usage(argv[0]);
+        return (EXIT_FAILURE);
+    }
+    if (argc > optind) {
+        usage(argv[0]);
+        return (EXIT_FAILURE);
+    }
+
+    if (list) {
+        for (auto const& name : getCaseNames()) {
+            cout << name << endl;
+        }
+        return (EXIT_SUCCESS);
+    }
+
+    try {
+        BenchmarkReport report(name_);
+        report.setUnit(BenchmarkReport::NANOSECONDS);
+        run(report);
+        report.print(cout, json ? BenchmarkReport::JSON : BenchmarkReport::TEXT);
+    } catch (const std::exception& ex) {
+        cerr << argv[0] << ": " << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+    return (EXIT_SUCCESS);
+}
+
+void
+MicroBenchmark::keep(uint64_t value) {
+    sink = sink + value;
+}
+
+void
+MicroBenchmark::usage(const string& program) const {
+    cerr << "Usage: " << program
+         << " [-n samples] [-b batch] [-t seconds] [-s seed] [-f filter]"
+         << " [-l] [-j]" << endl;
+    cerr << "  -n number: largest number of samples per case (default "
+         << DEFAULT_SAMPLES << ")" << endl;
+    cerr << "  -b number: number of operations per sample (default 0 for"
+         << " a sample of about 10us)" << endl;
+    cerr << "  -t seconds: largest time spent sampling a case, 0 for no"
+         << " limit (default " << DEFAULT_DURATION << ")" << endl;
+    cerr << "  -s number: seed of the generated data (default "
+         << DataGenerator::DEFAULT_SEED << ")" << endl;
+    cerr << "  -f text: run only the cases which name contains the text"
+         << endl;
+    cerr << "  -l: list the cases instead of running them" << endl;
+    cerr << "  -j: print the report in JSON" << endl;
+}
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
@@ -0,0 +1,175 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MICRO_BENCHMARK_H
+#define MICRO_BENCHMARK_H
+
+#include <util/benchmarks/benchmark_report.h>
+#include <util/benchmarks/data_generator.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+/// @brief Harness of the microbenchmarks of the library data structures.
+///
+/// A benchmark program registers cases and calls @c run from its main
+/// function. A case is made of a setup, which builds the data of the case
+/// from a @c DataGenerator seeded with the seed of the run, and of the
+/// body it returns, which performs one operation. The body is timed in
+/// batches of operations: a batch is run once to warm up and the latency
+/// of an operation in each sample is the duration of a batch divided by
+/// its size. By default the size of the batches is chosen so a batch lasts
+/// about 10 microseconds, and the sampling of a case stops after a second
+/// so the slow operations (e.g. the parsing of a large configuration) do
+/// not make the run last for hours.
+class MicroBenchmark {
+public:
+
+    /// @brief The body of a case performing one operation.
+    typedef std::function<void()> Body;
+
+    /// @brief The setup of a case returning the body.
+    typedef std::function<Body(DataGenerator&)> Setup;
+
+    /// @brief The default number of samples.
+    static const size_t DEFAULT_SAMPLES = 1000;
+
+    /// @brief The batch size value selecting the automatic size.
+    static const size_t AUTO_BATCH = 0;
+
+    /// @brief The default time spent sampling a case in seconds.
+    static constexpr double DEFAULT_DURATION = 1.0;
+
+    /// @brief Constructor.
+    ///
+    /// @param name the name of the benchmark, e.g. the library name.
+    explicit MicroBenchmark(const std::string& name);
+
+    /// @brief Adds a case.
+    ///
+    /// @param name the name of the case.
+    /// @param setup the setup of the case.
+    void add(const std::string& name, const Setup& setup);
+
+    /// @brief Sets the number of samples.
+    ///
+    /// @param samples the number of samples.
+    void setSamples(size_t samples) {
+        samples_ = samples;
+    }
+
+    /// @brief Sets the number of operations in a sample.
+    ///
+    /// @param batch the number of operations or @c AUTO_BATCH.
+    void setBatch(size_t batch) {
+        batch_ = batch;
+    }
+
+    /// @brief Sets the time spent sampling a case.
+    ///
+    /// The sampling of a case stops when the number of samples is reached
+    /// or after this time, whichever comes first.
+    ///
+    /// @param seconds the time in seconds or 0 for no limit.
+    void setDuration(double seconds) {
+        duration_ = seconds;
+    }
+
+    /// @brief Sets the seed of the data generators.
+    ///
+    /// @param seed the seed.
+    void setSeed(uint64_t seed) {
+        seed_ = seed;
+    }
+
+    /// @brief Sets the filter of the cases.
+    ///
+    /// @param filter only the cases which name contains the filter are run.
+    void setFilter(const std::string& filter) {
+        filter_ = filter;
+    }
+
+    /// @brief Returns the names of the selected cases.
+    std::vector<std::string> getCaseNames() const;
+
+    /// @brief Runs the selected cases.
+    ///
+    /// @param report the report receiving the parameters of the run and
+    /// a result per case.
+    /// @throw BadValue when the number of samples is 0.
+    void run(BenchmarkReport& report) const;
+
+    /// @brief Parses the command line, runs the selected cases and prints
+    /// the report.
+    ///
+    /// @param argc the number of arguments.
+    /// @param argv the arguments.
+    /// @return the exit code of the program.
+    int run(int argc, char* argv[]);
+
+    /// @brief Keeps a value computed by a body.
+    ///
+    /// Prevents the compiler from optimizing away an operation which
+    /// result is not used.
+    ///
+    /// @param value the value.
+    static void keep(uint64_t value);
+
+private:
+
+    /// @brief Returns the size of the batches of a case.
+    ///
+    /// @param body the body of the case.
+    /// @return the size set by @c setBatch or the number of operations
+    /// lasting about 10 microseconds.
+    size_t getBatch(Body& body) const;
+
+    /// @brief Prints the usage.
+    ///
+    /// @param program the name of the program.
+    void usage(const std::string& program) const;
+
+    /// @brief A case.
+    struct Case {
+        /// @brief The name of the case.
+        std::string name_;
+
+        /// @brief The setup of the case.
+        Setup setup_;
+    };
+
+    /// @brief The name of the benchmark.
+    std::string name_;
+
+    /// @brief The cases.
+    std::vector<Case> cases_;
+
+    /// @brief The number of samples.
+    size_t samples_;
+
+    /// @brief The number of operations in a sample.
+    size_t batch_;
+
+    /// @brief The time spent sampling a case in seconds.
+    double duration_;
+
+    /// @brief The seed of the data generators.
+    uint64_t seed_;
+
+    /// @brief The filter of the cases.
+    std::string filter_;
+};
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // MICRO_BENCHMARK_H
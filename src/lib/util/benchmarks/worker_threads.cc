@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/benchmarks/worker_threads.h>
+#include <util/multi_threading_mgr.h>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+WorkerThreads::WorkerThreads(size_t count, const Work& work)
+    : work_(work), round_(0), pending_(0), stopping_(false) {
+    MultiThreadingMgr::instance().setMode(true);
+    for (size_t i = 0; i < count; ++i) {
+        threads_.emplace_back([this, i]() { loop(i); });
+    }
+}
+
+WorkerThreads::~WorkerThreads() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    MultiThreadingMgr::instance().setMode(false);
+}
+
+void
+WorkerThreads::run() {
+    unique_lock<mutex> lock(mutex_);
+    pending_ = threads_.size();
+    ++round_;
+    start_cv_.notify_all();
+    done_cv_.wait(lock, [this]() { return (pending_ == 0); });
+}
+
+void
+WorkerThreads::loop(size_t index) {
+    uint64_t done = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(mutex_);
+            start_cv_.wait(lock, [this, done]() {
+                return (stopping_ || (round_ != done));
+            });
+            if (stopping_) {
+                return;
+            }
+            done = round_;
+        }
+        work_(index);
+        lock_guard<mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
@@ -0,0 +1,88 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef WORKER_THREADS_H
+#define WORKER_THREADS_H
+
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace isc {
+namespace util {
+namespace benchmarks {
+
+/// @brief Threads running a function in rounds.
+///
+/// The body of a multi-threaded microbenchmark case runs a round: each
+/// thread calls the function once and the round ends when all the threads
+/// returned. The threads are created with the case so their creation is
+/// not timed. The multi-threading mode is enabled while the threads exist.
+class WorkerThreads : public boost::noncopyable {
+public:
+
+    /// @brief The function run by the threads, called with the index of
+    /// the thread.
+    typedef std::function<void(size_t)> Work;
+
+    /// @brief Constructor.
+    ///
+    /// Enables the multi-threading mode and starts the threads.
+    ///
+    /// @param count the number of threads.
+    /// @param work the function run by the threads.
+    WorkerThreads(size_t count, const Work& work);
+
+    /// @brief Destructor.
+    ///
+    /// Stops the threads and disables the multi-threading mode.
+    ~WorkerThreads();
+
+    /// @brief Runs a round and waits for its end.
+    void run();
+
+private:
+
+    /// @brief The loop of a thread.
+    ///
+    /// @param index the index of the thread.
+    void loop(size_t index);
+
+    /// @brief The function run by the threads.
+    Work work_;
+
+    /// @brief The threads.
+    std::vector<std::thread> threads_;
+
+    /// @brief The mutex protecting the round state.
+    std::mutex mutex_;
+
+    /// @brief The condition variable starting a round.
+    std::condition_variable start_cv_;
+
+    /// @brief The condition variable signaling the end of a round.
+    std::condition_variable done_cv_;
+
+    /// @brief The number of the current round.
+    uint64_t round_;
+
+    /// @brief The number of threads which did not finish the round.
+    size_t pending_;
+
+    /// @brief Indicates the threads must exit.
+    bool stopping_;
+};
+
+} // end of isc::util::benchmarks namespace
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // WORKER_THREADS_H
@@ -8,11 +8,16 @@
 #include <util/csv_file.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace isc {
 namespace util {
 
@@ -112,7 +117,7 @@ CSVRow::checkIndex(const size_t at) const {
 }
 
 CSVFile::CSVFile(const std::string& filename)
-    : filename_(filename), fs_(), cols_(0), read_msg_() {
+    : fs_(), filename_(filename), cols_(0), read_msg_() {
 }
 
 CSVFile::~CSVFile() {
@@ -181,6 +186,11 @@ CSVFile::append(const CSVRow& row) const {
     /// needed at the same time, we may revisit this: perhaps remember the
     /// old pointer. Also, for safety, we call both functions so as we are
     /// sure that both pointers are moved.
+    if (row_handler_) {
+        row_handler_(row.render() + "\n");
+        return;
+    }
+
     fs_->seekp(0, std::ios_base::end);
     fs_->seekg(0, std::ios_base::end);
     fs_->clear();
@@ -194,6 +204,57 @@ CSVFile::append(const CSVRow& row) const {
     }
 }
 
+void
+CSVFile::appendRecord(const std::string& record) const {
+    checkStreamStatusAndReset("append");
+
+    if (row_handler_) {
+        row_handler_(record);
+        return;
+    }
+
+    appendRendered(record);
+}
+
+void
+CSVFile::appendRendered(const std::string& rows) const {
+    checkStreamStatusAndReset("append");
+
+    fs_->seekp(0, std::ios_base::end);
+    fs_->seekg(0, std::ios_base::end);
+    fs_->clear();
+
+    fs_->write(rows.c_str(), rows.size());
+    fs_->flush();
+    if (!fs_->good()) {
+        fs_->clear();
+        isc_throw(CSVFileError, "failed to write CSV rows to the file '"
+                  << filename_ << "'");
+    }
+}
+
+void
+CSVFile::sync() const {
+    flush();
+    int fd = ::open(filename_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        isc_throw(CSVFileError, "failed to open the file '" << filename_
+                  << "' for synchronization: " << strerror(errno));
+    }
+#ifdef __APPLE__
+    // There is no fdatasync on macOS.
+    int ret = ::fsync(fd);
+#else
+    int ret = ::fdatasync(fd);
+#endif
+    int sync_errno = errno;
+    static_cast<void>(::close(fd));
+    if (ret != 0) {
+        isc_throw(CSVFileError, "failed to synchronize the file '"
+                  << filename_ << "': " << strerror(sync_errno));
+    }
+}
+
 void
 CSVFile::checkStreamStatusAndReset(const std::string& operation) const {
     if (!fs_) {
@@ -11,6 +11,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/shared_ptr.hpp>
 #include <fstream>
+#include <functional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -358,6 +359,9 @@ std::ostream& operator<<(std::ostream& os, const CSVRow& row);
 class CSVFile {
 public:
 
+    /// @brief Function receiving the rendered rows.
+    typedef std::function<void(const std::string&)> RowHandler;
+
     /// @brief Constructor.
     ///
     /// @param filename CSV file name.
@@ -385,6 +389,35 @@ public:
     /// size of the row doesn't match the number of columns.
     void append(const CSVRow& row) const;
 
+    /// @brief Writes rendered rows into the file.
+    ///
+    /// The text is written and flushed as is, so it must hold complete
+    /// rows, each terminated by an end of line. This is used to write a
+    /// group of rows collected by a row handler in a single operation.
+    ///
+    /// @param rows the rendered rows.
+    ///
+    /// @throw CSVFileError When error occurred during IO operation.
+    void appendRendered(const std::string& rows) const;
+
+    /// @brief Sets the row handler.
+    ///
+    /// When a row handler is set, @c append checks and renders the row
+    /// and passes the text, terminated by an end of line, to the handler
+    /// instead of writing it. The handler is expected to write it later
+    /// with @c appendRendered. An empty handler restores the direct
+    /// writes.
+    ///
+    /// @param handler the row handler.
+    void setRowHandler(const RowHandler& handler) {
+        row_handler_ = handler;
+    }
+
+    /// @brief Flushes the file and synchronizes its data to the disk.
+    ///
+    /// @throw CSVFileError if the synchronization failed.
+    void sync() const;
+
     /// @brief Closes the CSV file.
     void close();
 
@@ -541,7 +574,17 @@ protected:
     /// @return true if header matches the columns; false otherwise.
     virtual bool validateHeader(const CSVRow& header);
 
-private:
+    /// @brief Appends a record in the format of a derived class.
+    ///
+    /// Derived classes which store their data in another format than
+    /// CSV rows use this to append an encoded record. It is written
+    /// and flushed as is, or passed to the row handler when one is set.
+    ///
+    /// @param record the encoded record.
+    ///
+    /// @throw CSVFileError When error occurred during IO operation.
+    void appendRecord(const std::string& record) const;
+
     /// @brief Sanity check if stream is open.
     ///
     /// Checks if the file stream is open so as IO operations can be performed
@@ -556,17 +599,25 @@ private:
     /// @brief Returns size of the CSV file.
     std::streampos size() const;
 
-    /// @brief CSV file name.
-    std::string filename_;
-
     /// @brief Holds a pointer to the file stream.
+    ///
+    /// It is accessible to the derived classes which implement their
+    /// own file format and open the stream themselves.
     boost::shared_ptr<std::fstream> fs_;
 
+private:
+
+    /// @brief CSV file name.
+    std::string filename_;
+
     /// @brief Holds CSV file columns.
     std::vector<std::string> cols_;
 
     /// @brief Holds last error during row reading or validation.
     std::string read_msg_;
+
+    /// @brief Function receiving the rendered rows instead of the file.
+    RowHandler row_handler_;
 };
 
 } // namespace isc::util
@@ -0,0 +1,184 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPMC_RING_H
+#define MPMC_RING_H
+
+/// @file mpmc_ring.h
+///
+/// Bounded lock-free multi-producer multi-consumer ring buffer.
+
+#include <exceptions/exceptions.h>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <atomic>
+#include <cstdint>
+
+namespace isc {
+namespace util {
+
+/// @brief Bounded lock-free multi-producer multi-consumer ring buffer.
+///
+/// The code is based on Dmitry Vyukov's bounded MPMC queue: each cell
+/// holds a sequence number telling whether it is ready to be written or
+/// read at the current lap of the ring, so producers and consumers only
+/// compete on an atomic position counter and never lock.
+///
+/// @tparam T Type of the elements, e.g. a shared pointer.
+template <typename T>
+class MpmcRing : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param capacity maximum number of elements in the ring.
+    ///
+    /// @throw InvalidParameter if the capacity is 0.
+    explicit MpmcRing(size_t capacity)
+        : capacity_(capacity), cells_(), enqueue_pos_(0), dequeue_pos_(0) {
+        if (capacity == 0) {
+            isc_throw(InvalidParameter, "ring capacity is 0");
+        }
+        cells_.reset(new Cell[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Returns the maximum number of elements in the ring.
+    size_t capacity() const {
+        return (capacity_);
+    }
+
+    /// @brief Returns the number of elements in the ring.
+    ///
+    /// The value is exact only when no other thread uses the ring.
+    size_t size() const {
+        size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+        size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+        if (enqueue_pos <= dequeue_pos) {
+            return (0);
+        }
+        size_t size = enqueue_pos - dequeue_pos;
+        return (size < capacity_ ? size : capacity_);
+    }
+
+    /// @brief Checks if the ring is empty.
+    bool empty() const {
+        return (size() == 0);
+    }
+
+    /// @brief Adds an element at the back of the ring.
+    ///
+    /// @param value the element to add.
+    ///
+    /// @return false if the ring is full, true otherwise.
+    bool tryPush(const T& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos % capacity_];
+            size_t seq = cell.sequence_.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    cell.value_ = value;
+                    cell.sequence_.store(pos + 1, std::memory_order_release);
+                    return (true);
+                }
+            } else if (diff < 0) {
+                // The cell still holds the element of the previous lap.
+                return (false);
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Removes the element at the front of the ring.
+    ///
+    /// @param [out] value the removed element.
+    ///
+    /// @return false if the ring is empty, true otherwise.
+    bool tryPop(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos % capacity_];
+            size_t seq = cell.sequence_.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    value = cell.value_;
+                    // Do not keep a reference to the element in the cell.
+                    cell.value_ = T();
+                    cell.sequence_.store(pos + capacity_, std::memory_order_release);
+                    return (true);
+                }
+            } else if (diff < 0) {
+                // The cell has not been written at this lap yet.
+                return (false);
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Adds an element at the back of the ring, dropping the oldest
+    /// elements when the ring is full.
+    ///
+    /// @param value the element to add.
+    ///
+    /// @return false if element(s) were dropped, true otherwise.
+    bool pushDropOldest(const T& value) {
+        bool ret = true;
+        while (!tryPush(value)) {
+            T oldest;
+            if (tryPop(oldest)) {
+                ret = false;
+            }
+        }
+        return (ret);
+    }
+
+    /// @brief Removes all elements.
+    void clear() {
+        T value;
+        while (tryPop(value)) {
+        }
+    }
+
+private:
+
+    /// @brief Cache line size used to keep the counters apart.
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    /// @brief Ring cell.
+    struct Cell {
+        /// @brief Sequence number telling the lap the cell is ready for.
+        std::atomic<size_t> sequence_;
+
+        /// @brief The element.
+        T value_;
+    };
+
+    /// @brief Maximum number of elements.
+    const size_t capacity_;
+
+    /// @brief The cells.
+    boost::scoped_array<Cell> cells_;
+
+    /// @brief Position of the next element to write.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_;
+
+    /// @brief Position of the next element to read.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_;
+};
+
+}  // namespace util
+}  // namespace isc
+
+#endif  // MPMC_RING_H
@@ -0,0 +1,200 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/packet_arena.h>
+
+#include <new>
+
+namespace isc {
+namespace util {
+
+namespace {
+
+/// @brief Header of an allocation.
+///
+/// The size of the header keeps the memory which follows it aligned.
+struct alignas(16) Header {
+    /// @brief The arena or null for a heap allocation.
+    PacketArena* arena_;
+};
+
+static_assert(sizeof(Header) % alignof(std::max_align_t) == 0,
+              "the header breaks the alignment of the allocations");
+
+/// @brief The active arena of the current thread.
+thread_local PacketArena* active_arena = 0;
+
+/// @brief The number of allocations served by the arenas in the current
+/// thread.
+thread_local uint64_t arena_allocation_count = 0;
+
+/// @brief The number of heap allocations in the current thread.
+thread_local uint64_t heap_allocation_count = 0;
+
+/// @brief Flag set when the free arenas of the current thread are
+/// destroyed, i.e. when the thread exits.
+thread_local bool free_arenas_destroyed = false;
+
+}
+
+/// @brief Free arenas of a thread.
+///
+/// The arenas are destroyed when the thread exits.
+struct PacketArena::FreeArenas {
+    /// @brief Constructor.
+    FreeArenas() : arenas_() {
+        // Keeping an arena must not allocate.
+        arenas_.reserve(MAX_FREE_ARENAS);
+    }
+
+    /// @brief Destructor.
+    ~FreeArenas() {
+        for (auto const& arena : arenas_) {
+            delete arena;
+        }
+        free_arenas_destroyed = true;
+    }
+
+    /// @brief The free arenas.
+    std::vector<PacketArena*> arenas_;
+};
+
+// Explicit definition of class static constants.  Values are given in the
+// declaration so they're not needed here.
+const size_t PacketArena::CHUNK_SIZE;
+const size_t PacketArena::MAX_ALLOCATION_SIZE;
+const size_t PacketArena::MAX_FREE_ARENAS;
+
+PacketArena::PacketArena() : chunks_(), chunk_(0), pos_(0), references_(0) {
+    chunks_.push_back(static_cast<char*>(::operator new(CHUNK_SIZE)));
+}
+
+PacketArena::~PacketArena() {
+    for (auto const& chunk : chunks_) {
+        ::operator delete(chunk);
+    }
+}
+
+void*
+PacketArena::allocate(size_t size) {
+    PacketArena* arena = active_arena;
+    Header* header;
+    if (arena && (size <= MAX_ALLOCATION_SIZE)) {
+        // Round up the size to keep the next allocation aligned.
+        size_t total = sizeof(Header) +
+            (size + sizeof(Header) - 1) / sizeof(Header) * sizeof(Header);
+        header = static_cast<Header*>(arena->allocateHere(total));
+        arena->addReference();
+        ++arena_allocation_count;
+    } else {
+        header = static_cast<Header*>(::operator new(sizeof(Header) + size));
+        arena = 0;
+        ++heap_allocation_count;
+    }
+    header->arena_ = arena;
+    return (header + 1);
+}
+
+void
+PacketArena::deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    Header* header = static_cast<Header*>(ptr) - 1;
+    if (header->arena_) {
+        header->arena_->removeReference();
+    } else {
+        ::operator delete(header);
+    }
+}
+
+PacketArena*
+PacketArena::current() {
+    return (active_arena);
+}
+
+uint64_t
+PacketArena::getArenaAllocationCount() {
+    return (arena_allocation_count);
+}
+
+uint64_t
+PacketArena::getHeapAllocationCount() {
+    return (heap_allocation_count);
+}
+
+void*
+PacketArena::allocateHere(size_t size) {
+    if (pos_ + size > CHUNK_SIZE) {
+        ++chunk_;
+        if (chunk_ == chunks_.size()) {
+            try {
+                chunks_.push_back(static_cast<char*>(::operator new(CHUNK_SIZE)));
+            } catch (...) {
+                --chunk_;
+                throw;
+            }
+        }
+        pos_ = 0;
+    }
+    void* ptr = chunks_[chunk_] + pos_;
+    pos_ += size;
+    return (ptr);
+}
+
+void
+PacketArena::removeReference() noexcept {
+    if (references_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    // The arena is no longer used: reset it and keep it for the next
+    // scope of the current thread.
+    chunk_ = 0;
+    pos_ = 0;
+    if (!free_arenas_destroyed) {
+        FreeArenas& free_arenas = getFreeArenas();
+        if (free_arenas.arenas_.size() < MAX_FREE_ARENAS) {
+            free_arenas.arenas_.push_back(this);
+            return;
+        }
+    }
+    delete this;
+}
+
+PacketArena*
+PacketArena::acquire() {
+    if (!free_arenas_destroyed) {
+        FreeArenas& free_arenas = getFreeArenas();
+        if (!free_arenas.arenas_.empty()) {
+            PacketArena* arena = free_arenas.arenas_.back();
+            free_arenas.arenas_.pop_back();
+            return (arena);
+        }
+    }
+    return (new PacketArena());
+}
+
+PacketArena::FreeArenas&
+PacketArena::getFreeArenas() {
+    static thread_local FreeArenas free_arenas;
+    return (free_arenas);
+}
+
+PacketArenaScope::PacketArenaScope()
+    : arena_(PacketArena::acquire()), previous_(active_arena) {
+    arena_->references_.store(1, std::memory_order_relaxed);
+    active_arena = arena_;
+}
+
+PacketArenaScope::~PacketArenaScope() {
+    active_arena = previous_;
+    arena_->removeReference();
+}
+
+} // end of isc::util namespace
+} // end of isc namespace
@@ -0,0 +1,216 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_ARENA_H
+#define PACKET_ARENA_H
+
+/// @file packet_arena.h
+///
+/// Per-packet memory arena for the objects created by the packet processing.
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace isc {
+namespace util {
+
+/// @brief Memory arena for the objects created by the processing of a packet.
+///
+/// The processing of a packet allocates many small objects (the packets,
+/// the options, the allocation engine context...) which are released
+/// together when the processing ends. An arena serves these allocations
+/// by bumping a pointer in large chunks, without locking nor using the
+/// heap, and the chunks are reused once all the objects are released.
+///
+/// An arena is active for the current thread from the construction to the
+/// destruction of a @ref PacketArenaScope. The objects can outlive the
+/// scope, e.g. a packet parked by a hook library or released by another
+/// thread: the arena counts its live objects and is reused only when the
+/// scope is destroyed and all the objects are released. The objects which
+/// are kept for a long time (e.g. the leases) must not be allocated from
+/// an arena as they would retain its chunks.
+///
+/// Each allocation is preceded by a header which points to the arena or
+/// is null for a heap allocation, so @ref deallocate handles both.
+class PacketArena : public boost::noncopyable {
+public:
+
+    /// @brief Size of a chunk.
+    static const size_t CHUNK_SIZE = 16 * 1024;
+
+    /// @brief Size of the largest allocation served by an arena.
+    ///
+    /// Larger objects are allocated on the heap.
+    static const size_t MAX_ALLOCATION_SIZE = 1024;
+
+    /// @brief Maximum number of free arenas kept by a thread for reuse.
+    static const size_t MAX_FREE_ARENAS = 4;
+
+    /// @brief Allocates memory from the active arena of the current thread.
+    ///
+    /// The memory is allocated on the heap when no arena is active or
+    /// the size is larger than @ref MAX_ALLOCATION_SIZE.
+    ///
+    /// @param size size of the memory.
+    /// @return pointer to the memory, aligned for any object.
+    /// @throw std::bad_alloc when the memory can't be allocated.
+    static void* allocate(size_t size);
+
+    /// @brief Releases memory returned by @ref allocate.
+    ///
+    /// Can be called by any thread.
+    ///
+    /// @param ptr pointer to the memory (can be null).
+    static void deallocate(void* ptr) noexcept;
+
+    /// @brief Returns the active arena of the current thread.
+    ///
+    /// @return the active arena or null when no arena is active.
+    static PacketArena* current();
+
+    /// @brief Returns the number of allocations served by the arenas
+    /// in the current thread.
+    static uint64_t getArenaAllocationCount();
+
+    /// @brief Returns the number of allocations done on the heap by
+    /// @ref allocate in the current thread.
+    static uint64_t getHeapAllocationCount();
+
+    /// @brief Returns the number of references to this arena.
+    ///
+    /// @return the number of objects allocated from this arena which are
+    /// not released, plus one while the scope exists.
+    size_t getReferenceCount() const {
+        return (references_.load(std::memory_order_relaxed));
+    }
+
+    /// @brief Returns the number of chunks of this arena.
+    ///
+    /// The chunks are kept when the arena is reused, so this is the
+    /// largest number of chunks used by a scope.
+    size_t getChunkCount() const {
+        return (chunks_.size());
+    }
+
+private:
+
+    /// @brief Constructor.
+    PacketArena();
+
+    /// @brief Destructor.
+    ///
+    /// Releases the chunks.
+    ~PacketArena();
+
+    /// @brief Allocates memory from this arena.
+    ///
+    /// @param size size of the memory including the header.
+    /// @return pointer to the memory.
+    void* allocateHere(size_t size);
+
+    /// @brief Adds a reference to this arena.
+    void addReference() {
+        references_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Removes a reference to this arena.
+    ///
+    /// The arena is reset and kept for reuse by the current thread, or
+    /// destroyed, when the last reference is removed.
+    void removeReference() noexcept;
+
+    /// @brief Gets an arena for a new scope.
+    ///
+    /// @return a free arena of the current thread or a new arena.
+    static PacketArena* acquire();
+
+    /// @brief Free arenas of a thread.
+    struct FreeArenas;
+
+    /// @brief Returns the free arenas of the current thread.
+    static FreeArenas& getFreeArenas();
+
+    /// @brief The scope uses the private methods.
+    friend class PacketArenaScope;
+
+    /// @brief The chunks.
+    std::vector<char*> chunks_;
+
+    /// @brief Index of the chunk in use.
+    size_t chunk_;
+
+    /// @brief Position of the unused part of the chunk in use.
+    size_t pos_;
+
+    /// @brief Number of references: the live objects and the scope.
+    std::atomic<size_t> references_;
+};
+
+/// @brief Makes an arena active for the current thread.
+///
+/// The arena is active from the construction to the destruction of the
+/// object, which is declared on the stack around the processing of a
+/// packet. The scopes can be nested: the destructor restores the
+/// previously active arena.
+class PacketArenaScope : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Makes a free arena active for the current thread.
+    PacketArenaScope();
+
+    /// @brief Destructor.
+    ///
+    /// Restores the previously active arena of the current thread.
+    ~PacketArenaScope();
+
+    /// @brief Returns the arena.
+    PacketArena& getArena() {
+        return (*arena_);
+    }
+
+private:
+
+    /// @brief The arena.
+    PacketArena* arena_;
+
+    /// @brief The previously active arena.
+    PacketArena* previous_;
+};
+
+/// @brief Base class of the objects allocated from the packet arena.
+///
+/// When Kea is configured with --enable-packet-arena the objects of the
+/// derived classes which are created while a @ref PacketArenaScope is
+/// active are allocated from its arena. Otherwise this class does nothing.
+class PacketArenaObject {
+public:
+#ifdef ENABLE_PACKET_ARENA
+    /// @brief Allocates an object.
+    ///
+    /// @param size size of the object.
+    /// @return pointer to the memory of the object.
+    static void* operator new(size_t size) {
+        return (PacketArena::allocate(size));
+    }
+
+    /// @brief Releases an object.
+    ///
+    /// @param ptr pointer to the memory of the object.
+    static void operator delete(void* ptr) noexcept {
+        PacketArena::deallocate(ptr);
+    }
+#endif
+};
+
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // PACKET_ARENA_H
@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <util/benchmarks/benchmark_report.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace isc::util::benchmarks;
+using namespace std;
+
+namespace {
+
+// Checks the quoting of the JSON strings.
+TEST(BenchmarkReportTest, quote) {
+    EXPECT_EQ("\"foo\"", BenchmarkReport::quote("foo"));
+    EXPECT_EQ("\"a\\\"b\\\\c\\n\"", BenchmarkReport::quote("a\"b\\c\n"));
+    EXPECT_EQ("\"\\u0001\"", BenchmarkReport::quote(string(1, '\x01')));
+}
+
+/// @brief Returns a report with one result.
+BenchmarkReport
+makeReport() {
+    BenchmarkReport report("test");
+    report.addParameter("clients", "10");
+    LatencyStats latency;
+    latency.add(1000);
+    latency.add(3000);
+    report.addResult("discover/total", latency, 2500);
+    report.addResult("discover/pkt4_receive", latency);
+    return (report);
+}
+
+// Checks the text format.
+TEST(BenchmarkReportTest, text) {
+    ostringstream s;
+    makeReport().print(s);
+    string text = s.str();
+    EXPECT_EQ(0, text.find("test\n  clients: 10\nname "));
+    EXPECT_NE(string::npos, text.find("discover/total"));
+    EXPECT_NE(string::npos, text.find(" 2500 "));
+    EXPECT_NE(string::npos, text.find(" 2.0 "));
+    EXPECT_NE(string::npos, text.find(" 3.0"));
+}
+
+// Checks the text format in nanoseconds.
+TEST(BenchmarkReportTest, textNanoseconds) {
+    BenchmarkReport report = makeReport();
+    report.setUnit(BenchmarkReport::NANOSECONDS);
+    ostringstream s;
+    report.print(s);
+    string text = s.str();
+    EXPECT_NE(string::npos, text.find("(ns)"));
+    EXPECT_NE(string::npos, text.find(" 2000 "));
+    EXPECT_NE(string::npos, text.find(" 3000\n"));
+}
+
+// Checks the JSON format.
+TEST(BenchmarkReportTest, json) {
+    ostringstream s;
+    makeReport().print(s, BenchmarkReport::JSON);
+    string expected =
+        "{ \"benchmark\": \"test\", \"parameters\": { \"clients\": \"10\" },"
+        " \"results\": [\n"
+        "  { \"name\": \"discover/total\", \"count\": 2, \"rate\": 2500.0,"
+        " \"mean-ns\": 2000, \"min-ns\": 1000, \"p50-ns\": 1000,"
+        " \"p90-ns\": 3000, \"p99-ns\": 3000, \"p99.9-ns\": 3000,"
+        " \"max-ns\": 3000 },\n"
+        "  { \"name\": \"discover/pkt4_receive\", \"count\": 2,"
+        " \"mean-ns\": 2000, \"min-ns\": 1000, \"p50-ns\": 1000,"
+        " \"p90-ns\": 3000, \"p99-ns\": 3000, \"p99.9-ns\": 3000,"
+        " \"max-ns\": 3000 }\n"
+        "] }\n";
+    EXPECT_EQ(expected, s.str());
+}
+
+} // end of anonymous namespace
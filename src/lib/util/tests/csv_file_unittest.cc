@@ -487,6 +487,55 @@ TEST_F(CSVFileTest, recreate) {
               readFile());
 }
 
+// This test checks that the rows can be rendered by a row handler and
+// written later in a group.
+TEST_F(CSVFileTest, rowHandler) {
+    boost::scoped_ptr<CSVFile> csv(new CSVFile(testfile_));
+    csv->addColumn("animal");
+    csv->addColumn("color");
+    ASSERT_NO_THROW(csv->recreate());
+
+    std::string rows;
+    csv->setRowHandler([&rows](const std::string& row) {
+        rows += row;
+    });
+
+    CSVRow row0(2);
+    row0.writeAt(0, "dog");
+    row0.writeAt(1, "grey");
+    ASSERT_NO_THROW(csv->append(row0));
+
+    CSVRow row1(2);
+    row1.writeAt(0, "cat");
+    row1.writeAt(1, "black");
+    ASSERT_NO_THROW(csv->append(row1));
+
+    // A row with a wrong number of columns is still rejected.
+    CSVRow row2(3);
+    EXPECT_THROW(csv->append(row2), CSVFileError);
+
+    // Nothing has been written yet.
+    EXPECT_EQ("dog,grey\ncat,black\n", rows);
+    EXPECT_EQ("animal,color\n", readFile());
+
+    ASSERT_NO_THROW(csv->appendRendered(rows));
+    ASSERT_NO_THROW(csv->sync());
+
+    // Direct writes are restored with an empty handler.
+    csv->setRowHandler(CSVFile::RowHandler());
+    ASSERT_NO_THROW(csv->append(row0));
+    csv->close();
+
+    EXPECT_EQ("animal,color\n"
+              "dog,grey\n"
+              "cat,black\n"
+              "dog,grey\n",
+              readFile());
+
+    // Closed files can't be written.
+    EXPECT_THROW(csv->appendRendered(rows), CSVFileError);
+}
+
 // This test checks that the error is reported when the size of the row being
 // read doesn't match the number of columns of the CSV file.
 TEST_F(CSVFileTest, validate) {
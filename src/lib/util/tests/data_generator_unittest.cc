@@ -0,0 +1,79 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <exceptions/exceptions.h>
+#include <util/benchmarks/data_generator.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+using namespace isc;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+namespace {
+
+// Checks the values depend only on the seed.
+TEST(DataGeneratorTest, seed) {
+    DataGenerator gen1(5489);
+    DataGenerator gen2(5489);
+    DataGenerator gen3(2);
+    // The 10000th value of mt19937_64 with the seed 5489 is specified
+    // by the standard.
+    uint64_t value = 0;
+    for (size_t i = 0; i < 10000; ++i) {
+        value = gen1.next();
+        EXPECT_EQ(value, gen2.next());
+    }
+    EXPECT_EQ(9981545732273789042ULL, value);
+    EXPECT_NE(DataGenerator(5489).next(), gen3.next());
+}
+
+// Checks the values in a range.
+TEST(DataGeneratorTest, uniform) {
+    DataGenerator gen;
+    vector<size_t> counts(10, 0);
+    for (size_t i = 0; i < 10000; ++i) {
+        uint64_t value = gen.uniform(10, 19);
+        ASSERT_LE(10, value);
+        ASSERT_GE(19, value);
+        ++counts[value - 10];
+    }
+    for (auto const& count : counts) {
+        EXPECT_LT(800, count);
+    }
+    EXPECT_EQ(5, gen.uniform(5, 5));
+    EXPECT_NO_THROW(gen.uniform(0, UINT64_MAX));
+    EXPECT_THROW(gen.uniform(2, 1), BadValue);
+}
+
+// Checks the bytes and the names.
+TEST(DataGeneratorTest, bytesAndNames) {
+    DataGenerator gen;
+    EXPECT_EQ(13, gen.bytes(13).size());
+    EXPECT_TRUE(gen.bytes(0).empty());
+    string name = gen.name(20);
+    ASSERT_EQ(20, name.size());
+    EXPECT_TRUE(isalpha(name[0]));
+    for (auto const& c : name) {
+        EXPECT_TRUE(islower(c) || isdigit(c));
+    }
+}
+
+// Checks the shuffle keeps the values.
+TEST(DataGeneratorTest, shuffle) {
+    DataGenerator gen;
+    vector<int> values(100);
+    iota(values.begin(), values.end(), 0);
+    vector<int> shuffled(values);
+    gen.shuffle(shuffled);
+    EXPECT_NE(values, shuffled);
+    sort(shuffled.begin(), shuffled.end());
+    EXPECT_EQ(values, shuffled);
+}
+
+} // end of anonymous namespace
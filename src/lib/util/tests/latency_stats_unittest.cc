@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <exceptions/exceptions.h>
+#include <util/benchmarks/latency_stats.h>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::util::benchmarks;
+
+namespace {
+
+// Checks the statistics without samples.
+TEST(LatencyStatsTest, empty) {
+    LatencyStats stats;
+    EXPECT_EQ(0, stats.getCount());
+    EXPECT_EQ(0, stats.getTotal());
+    EXPECT_EQ(0, stats.getMean());
+    EXPECT_EQ(0, stats.getMin());
+    EXPECT_EQ(0, stats.getMax());
+    EXPECT_EQ(0, stats.getPercentile(50));
+}
+
+// Checks the statistics of samples.
+TEST(LatencyStatsTest, samples) {
+    LatencyStats stats;
+    // Add 1 to 100 in an unsorted order.
+    for (uint64_t i = 0; i < 100; ++i) {
+        stats.add((i * 37) % 100 + 1);
+    }
+    EXPECT_EQ(100, stats.getCount());
+    EXPECT_EQ(5050, stats.getTotal());
+    EXPECT_EQ(50, stats.getMean());
+    EXPECT_EQ(1, stats.getMin());
+    EXPECT_EQ(100, stats.getMax());
+    EXPECT_EQ(1, stats.getPercentile(0));
+    EXPECT_EQ(50, stats.getPercentile(50));
+    EXPECT_EQ(90, stats.getPercentile(90));
+    EXPECT_EQ(99, stats.getPercentile(99));
+    EXPECT_EQ(100, stats.getPercentile(99.9));
+    EXPECT_EQ(100, stats.getPercentile(100));
+    EXPECT_THROW(stats.getPercentile(-1), BadValue);
+    EXPECT_THROW(stats.getPercentile(101), BadValue);
+
+    // Samples can be added after a percentile was computed.
+    stats.add(1000);
+    EXPECT_EQ(1000, stats.getMax());
+
+    stats.clear();
+    EXPECT_EQ(0, stats.getCount());
+    EXPECT_EQ(0, stats.getTotal());
+}
+
+// Checks the durations are recorded in nanoseconds.
+TEST(LatencyStatsTest, duration) {
+    LatencyStats stats;
+    stats.add(std::chrono::microseconds(3));
+    EXPECT_EQ(3000, stats.getMax());
+}
+
+} // end of anonymous namespace
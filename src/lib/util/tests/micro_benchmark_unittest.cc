@@ -0,0 +1,126 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <exceptions/exceptions.h>
+#include <util/benchmarks/micro_benchmark.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::util::benchmarks;
+using namespace std;
+
+namespace {
+
+/// @brief Returns a benchmark with two counting cases.
+///
+/// @param setups the number of setups of each case.
+/// @param calls the number of calls of the body of each case.
+/// @param seeds the first value of the generator of each case.
+MicroBenchmark
+makeBenchmark(vector<size_t>& setups, vector<size_t>& calls,
+              vector<uint64_t>& seeds) {
+    setups.assign(2, 0);
+    calls.assign(2, 0);
+    seeds.assign(2, 0);
+    MicroBenchmark bench("test");
+    for (size_t i = 0; i < 2; ++i) {
+        bench.add(i ? "bar" : "foo", [&setups, &calls, &seeds, i]
+                  (DataGenerator& gen) {
+            ++setups[i];
+            seeds[i] = gen.next();
+            return ([&calls, i]() { ++calls[i]; });
+        });
+    }
+    return (bench);
+}
+
+// Checks the cases are run in batches.
+TEST(MicroBenchmarkTest, run) {
+    vector<size_t> setups;
+    vector<size_t> calls;
+    vector<uint64_t> seeds;
+    MicroBenchmark bench = makeBenchmark(setups, calls, seeds);
+    bench.setSamples(10);
+    bench.setBatch(5);
+    BenchmarkReport report("test");
+    bench.run(report);
+    // One setup per case and a warm up batch.
+    EXPECT_EQ(1, setups[0]);
+    EXPECT_EQ(1, setups[1]);
+    EXPECT_EQ(55, calls[0]);
+    EXPECT_EQ(55, calls[1]);
+    // Each case gets its own generator.
+    EXPECT_EQ(seeds[0], seeds[1]);
+    EXPECT_EQ(DataGenerator().next(), seeds[0]);
+
+    ostringstream s;
+    report.print(s, BenchmarkReport::JSON);
+    EXPECT_EQ(0, s.str().find("{ \"benchmark\": \"test\", \"parameters\":"
+                              " { \"seed\": \"1\", \"samples\": \"10\","
+                              " \"batch\": \"5\", \"duration\": \"1\" },"
+                              " \"results\": [\n"
+                              "  { \"name\": \"foo\", \"count\": 10"));
+    EXPECT_NE(string::npos, s.str().find("{ \"name\": \"bar\", \"count\": 10"));
+}
+
+// Checks the filter and the seed.
+TEST(MicroBenchmarkTest, filter) {
+    vector<size_t> setups;
+    vector<size_t> calls;
+    vector<uint64_t> seeds;
+    MicroBenchmark bench = makeBenchmark(setups, calls, seeds);
+    bench.setSamples(1);
+    bench.setBatch(1);
+    bench.setSeed(2);
+    bench.setFilter("ba");
+    ASSERT_EQ(1, bench.getCaseNames().size());
+    EXPECT_EQ("bar", bench.getCaseNames()[0]);
+    BenchmarkReport report("test");
+    bench.run(report);
+    EXPECT_EQ(0, setups[0]);
+    EXPECT_EQ(1, setups[1]);
+    EXPECT_EQ(DataGenerator(2).next(), seeds[1]);
+}
+
+// Checks the automatic batch size and the time limit.
+TEST(MicroBenchmarkTest, autoBatchAndDuration) {
+    MicroBenchmark bench("test");
+    size_t calls = 0;
+    // An operation of 2ms gets batches of one operation.
+    bench.add("slow", [&calls](DataGenerator&) {
+        return ([&calls]() {
+            ++calls;
+            usleep(2000);
+        });
+    });
+    bench.setSamples(1000);
+    bench.setDuration(0.02);
+    BenchmarkReport report("test");
+    bench.run(report);
+    // One call for the batch size, one for the warm up and about ten
+    // samples.
+    EXPECT_LE(3, calls);
+    EXPECT_GT(50, calls);
+    ostringstream s;
+    report.print(s, BenchmarkReport::JSON);
+    EXPECT_NE(string::npos, s.str().find("\"batch\": \"auto\""));
+    EXPECT_NE(string::npos, s.str().find("\"count\": " + to_string(calls - 2)));
+}
+
+// Checks the parameters are checked.
+TEST(MicroBenchmarkTest, badParameters) {
+    MicroBenchmark bench("test");
+    BenchmarkReport report("test");
+    bench.setSamples(0);
+    EXPECT_THROW(bench.run(report), BadValue);
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,126 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/mpmc_ring.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Type of the ring elements.
+typedef boost::shared_ptr<int> IntPtr;
+
+/// @brief Verifies that a zero capacity is rejected.
+TEST(MpmcRingTest, zeroCapacity) {
+    EXPECT_THROW(MpmcRing<IntPtr> ring(0), InvalidParameter);
+}
+
+/// @brief Verifies that elements are popped in the order they were pushed.
+TEST(MpmcRingTest, fifo) {
+    MpmcRing<IntPtr> ring(3);
+    EXPECT_EQ(3, ring.capacity());
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(0, ring.size());
+
+    IntPtr value;
+    EXPECT_FALSE(ring.tryPop(value));
+
+    // Several laps of the ring.
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_TRUE(ring.tryPush(boost::make_shared<int>(i)));
+        }
+        EXPECT_EQ(3, ring.size());
+        EXPECT_FALSE(ring.tryPush(boost::make_shared<int>(3)));
+
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(ring.tryPop(value));
+            ASSERT_TRUE(value);
+            EXPECT_EQ(i, *value);
+        }
+        EXPECT_TRUE(ring.empty());
+    }
+}
+
+/// @brief Verifies that the oldest elements are dropped when the ring is
+/// full and that clear removes everything.
+TEST(MpmcRingTest, pushDropOldest) {
+    MpmcRing<IntPtr> ring(3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(ring.pushDropOldest(boost::make_shared<int>(i)));
+    }
+    EXPECT_FALSE(ring.pushDropOldest(boost::make_shared<int>(3)));
+    EXPECT_EQ(3, ring.size());
+
+    IntPtr value;
+    ASSERT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(1, *value);
+
+    // The popped element is not referenced by the ring anymore.
+    EXPECT_EQ(1, value.use_count());
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+/// @brief Verifies that no element is lost or duplicated with concurrent
+/// producers and consumers.
+TEST(MpmcRingTest, concurrent) {
+    const int producers = 4;
+    const int consumers = 4;
+    const int count = 10000;
+    MpmcRing<IntPtr> ring(16);
+    std::atomic<int> consumed(0);
+    std::atomic<long> sum(0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p, count]() {
+            for (int i = 0; i < count; ++i) {
+                IntPtr value = boost::make_shared<int>(p * count + i);
+                while (!ring.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            IntPtr value;
+            while (consumed < producers * count) {
+                if (ring.tryPop(value)) {
+                    sum += *value;
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const long total = static_cast<long>(producers) * count;
+    EXPECT_EQ(total, consumed);
+    EXPECT_EQ(total * (total - 1) / 2, sum);
+    EXPECT_TRUE(ring.empty());
+}
+
+}  // namespace
@@ -0,0 +1,169 @@
+// Copyright (C) 2024 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <util/packet_arena.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace isc::util;
+
+namespace {
+
+/// @brief Returns true when the pointer is aligned for any object.
+bool isAligned(void* ptr) {
+    return (reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t) == 0);
+}
+
+// Checks the allocations without an active arena.
+TEST(PacketArenaTest, noArena) {
+    EXPECT_FALSE(PacketArena::current());
+    uint64_t heap_count = PacketArena::getHeapAllocationCount();
+    uint64_t arena_count = PacketArena::getArenaAllocationCount();
+    void* ptr = PacketArena::allocate(10);
+    ASSERT_TRUE(ptr);
+    EXPECT_TRUE(isAligned(ptr));
+    memset(ptr, 0, 10);
+    EXPECT_EQ(heap_count + 1, PacketArena::getHeapAllocationCount());
+    EXPECT_EQ(arena_count, PacketArena::getArenaAllocationCount());
+    PacketArena::deallocate(ptr);
+
+    // Releasing a null pointer does nothing.
+    EXPECT_NO_THROW(PacketArena::deallocate(0));
+}
+
+// Checks the allocations from an arena.
+TEST(PacketArenaTest, scope) {
+    uint64_t heap_count = PacketArena::getHeapAllocationCount();
+    uint64_t arena_count = PacketArena::getArenaAllocationCount();
+    {
+        PacketArenaScope scope;
+        PacketArena& arena = scope.getArena();
+        EXPECT_EQ(&arena, PacketArena::current());
+        EXPECT_EQ(1, arena.getReferenceCount());
+        EXPECT_EQ(1, arena.getChunkCount());
+
+        void* ptr1 = PacketArena::allocate(1);
+        void* ptr2 = PacketArena::allocate(100);
+        ASSERT_TRUE(ptr1);
+        ASSERT_TRUE(ptr2);
+        EXPECT_TRUE(isAligned(ptr1));
+        EXPECT_TRUE(isAligned(ptr2));
+        EXPECT_NE(ptr1, ptr2);
+        memset(ptr2, 0, 100);
+        EXPECT_EQ(3, arena.getReferenceCount());
+        EXPECT_EQ(arena_count + 2, PacketArena::getArenaAllocationCount());
+
+        // Large allocations are done on the heap.
+        void* ptr3 = PacketArena::allocate(PacketArena::MAX_ALLOCATION_SIZE + 1);
+        ASSERT_TRUE(ptr3);
+        EXPECT_EQ(3, arena.getReferenceCount());
+        EXPECT_EQ(heap_count + 1, PacketArena::getHeapAllocationCount());
+
+        PacketArena::deallocate(ptr1);
+        PacketArena::deallocate(ptr2);
+        PacketArena::deallocate(ptr3);
+        EXPECT_EQ(1, arena.getReferenceCount());
+    }
+    EXPECT_FALSE(PacketArena::current());
+}
+
+// Checks an arena uses more chunks when needed and keeps them.
+TEST(PacketArenaTest, chunks) {
+    size_t count = 2 * PacketArena::CHUNK_SIZE / PacketArena::MAX_ALLOCATION_SIZE;
+    PacketArena* arena = 0;
+    {
+        PacketArenaScope scope;
+        arena = &scope.getArena();
+        std::vector<void*> ptrs;
+        for (size_t i = 0; i < count; ++i) {
+            void* ptr = PacketArena::allocate(PacketArena::MAX_ALLOCATION_SIZE);
+            memset(ptr, 0xff, PacketArena::MAX_ALLOCATION_SIZE);
+            ptrs.push_back(ptr);
+        }
+        EXPECT_LE(3, arena->getChunkCount());
+        for (auto const& ptr : ptrs) {
+            PacketArena::deallocate(ptr);
+        }
+    }
+
+    // The arena is reused by the next scope of the thread.
+    PacketArenaScope scope;
+    EXPECT_EQ(arena, &scope.getArena());
+    EXPECT_LE(3, arena->getChunkCount());
+    EXPECT_EQ(1, arena->getReferenceCount());
+}
+
+// Checks the scopes can be nested.
+TEST(PacketArenaTest, nested) {
+    PacketArenaScope outer;
+    EXPECT_EQ(&outer.getArena(), PacketArena::current());
+    {
+        PacketArenaScope inner;
+        EXPECT_NE(&outer.getArena(), &inner.getArena());
+        EXPECT_EQ(&inner.getArena(), PacketArena::current());
+    }
+    EXPECT_EQ(&outer.getArena(), PacketArena::current());
+}
+
+// Checks the objects can outlive the scope and be released by another
+// thread.
+TEST(PacketArenaTest, outliveScope) {
+    void* ptr = 0;
+    PacketArena* arena = 0;
+    {
+        PacketArenaScope scope;
+        arena = &scope.getArena();
+        ptr = PacketArena::allocate(16);
+    }
+    EXPECT_FALSE(PacketArena::current());
+    EXPECT_EQ(1, arena->getReferenceCount());
+
+    // The arena is not reused while the object exists.
+    {
+        PacketArenaScope scope;
+        EXPECT_NE(arena, &scope.getArena());
+    }
+
+    std::thread thread([ptr]() {
+        PacketArena::deallocate(ptr);
+    });
+    thread.join();
+}
+
+/// @brief Class of objects allocated from the packet arena.
+class ArenaObject : public PacketArenaObject {
+public:
+    /// @brief Constructor.
+    ArenaObject() : value_(0) {
+    }
+
+    /// @brief A value.
+    uint64_t value_;
+};
+
+// Checks the objects deriving from PacketArenaObject.
+TEST(PacketArenaTest, object) {
+    uint64_t arena_count = PacketArena::getArenaAllocationCount();
+    PacketArenaScope scope;
+    std::unique_ptr<ArenaObject> object(new ArenaObject());
+    EXPECT_EQ(0, object->value_);
+#ifdef ENABLE_PACKET_ARENA
+    EXPECT_EQ(2, scope.getArena().getReferenceCount());
+    EXPECT_EQ(arena_count + 1, PacketArena::getArenaAllocationCount());
+#else
+    EXPECT_EQ(1, scope.getArena().getReferenceCount());
+    EXPECT_EQ(arena_count, PacketArena::getArenaAllocationCount());
+#endif
+    object.reset();
+    EXPECT_EQ(1, scope.getArena().getReferenceCount());
+}
+
+} // end of anonymous namespace
@@ -789,6 +789,98 @@ TEST_F(ThreadPoolTest, addFront) {
     EXPECT_EQ(thread_pool.count(), items_count);
 }
 
+/// @brief test ThreadPool with a bounded queue using the lock-free ring
+TEST_F(ThreadPoolTest, boundedQueue) {
+    uint32_t items_count = 1000;
+    uint32_t thread_count = 8;
+    size_t max_queue_size = 64;
+    CallBack call_back = std::bind(&ThreadPoolTest::run, this);
+    ThreadPool<CallBack> thread_pool;
+
+    // the ring is created when the thread pool is started
+    thread_pool.setMaxQueueSize(max_queue_size);
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    checkState(thread_pool, 0, thread_count);
+
+    // pause the threads and fill the queue: oldest items are dropped
+    EXPECT_NO_THROW(thread_pool.pause());
+    uint32_t dropped = 0;
+    for (uint32_t i = 0; i < max_queue_size + 10; ++i) {
+        if (!thread_pool.add(boost::make_shared<CallBack>(call_back))) {
+            ++dropped;
+        }
+    }
+    EXPECT_EQ(10, dropped);
+    checkState(thread_pool, max_queue_size, thread_count);
+    // no item was processed while paused
+    EXPECT_EQ(0, count());
+
+    // resume and add the remaining items while the threads are working
+    EXPECT_NO_THROW(thread_pool.resume());
+    for (uint32_t i = max_queue_size + 10; i < items_count; ++i) {
+        if (!thread_pool.add(boost::make_shared<CallBack>(call_back))) {
+            ++dropped;
+        }
+    }
+
+    // wait for all items to be processed
+    EXPECT_NO_THROW(thread_pool.wait());
+    checkState(thread_pool, 0, thread_count);
+    ASSERT_EQ(count(), items_count - dropped);
+    checkRunHistory(items_count - dropped);
+
+    // items added at the front are processed first
+    EXPECT_NO_THROW(thread_pool.pause());
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_TRUE(thread_pool.addFront(boost::make_shared<CallBack>(call_back)));
+    checkState(thread_pool, 2, thread_count);
+    EXPECT_NO_THROW(thread_pool.resume());
+    EXPECT_NO_THROW(thread_pool.wait());
+    checkState(thread_pool, 0, thread_count);
+    ASSERT_EQ(count(), items_count - dropped + 2);
+
+    // stop keeps the queued items
+    EXPECT_NO_THROW(thread_pool.pause());
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_NO_THROW(thread_pool.stop());
+    checkState(thread_pool, 1, 0);
+    EXPECT_NO_THROW(thread_pool.reset());
+    checkState(thread_pool, 0, 0);
+}
+
+/// @brief test ThreadPool releases the rings of the previous queue sizes
+TEST_F(ThreadPoolTest, boundedQueueResize) {
+    uint32_t thread_count = 4;
+    CallBack call_back = std::bind(&ThreadPoolTest::run, this);
+    ThreadPool<CallBack> thread_pool;
+    EXPECT_EQ(0, thread_pool.getRingCount());
+
+    // each restart with a new size replaces the ring
+    for (size_t max_queue_size = 16; max_queue_size <= 1024; max_queue_size *= 2) {
+        thread_pool.setMaxQueueSize(max_queue_size);
+        EXPECT_NO_THROW(thread_pool.start(thread_count));
+        EXPECT_EQ(1, thread_pool.getRingCount());
+        EXPECT_NO_THROW(thread_pool.stop());
+    }
+
+    // the items of the previous ring are kept
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    thread_pool.setMaxQueueSize(64);
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    EXPECT_EQ(1, thread_pool.getRingCount());
+    EXPECT_NO_THROW(thread_pool.wait());
+    ASSERT_EQ(2, count());
+    checkState(thread_pool, 0, thread_count);
+    EXPECT_NO_THROW(thread_pool.stop());
+
+    // an unbounded queue has no ring
+    thread_pool.setMaxQueueSize(0);
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    EXPECT_EQ(0, thread_pool.getRingCount());
+    EXPECT_NO_THROW(thread_pool.reset());
+}
+
 /// @brief test ThreadPool get queue statistics.
 TEST_F(ThreadPoolTest, getQueueStat) {
     ThreadPool<CallBack> thread_pool;
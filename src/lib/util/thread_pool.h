@@ -8,6 +8,7 @@
 #define THREAD_POOL_H
 
 #include <exceptions/exceptions.h>
+#include <util/mpmc_ring.h>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -178,6 +179,10 @@ struct ThreadPool {
 
     /// @brief set maximum number of work items in the queue
     ///
+    /// When the maximum size is not 0, the work items added at the back
+    /// of the queue go through a lock-free ring of this size, created when
+    /// the thread pool is started.
+    ///
     /// @param max_queue_size the maximum size (0 means unlimited)
     void setMaxQueueSize(size_t max_queue_size) {
         queue_.setMaxQueueSize(max_queue_size);
@@ -190,6 +195,14 @@ struct ThreadPool {
         return (queue_.getMaxQueueSize());
     }
 
+    /// @brief get the number of lock-free rings held by the queue
+    ///
+    /// @return the number of rings, including the retired ones which
+    /// were not released yet
+    size_t getRingCount() {
+        return (queue_.getRingCount());
+    }
+
     /// @brief size number of thread pool threads
     ///
     /// @return the number of threads
@@ -269,6 +282,13 @@ private:
     /// In 'disabled' state, all threads waiting on the queue are unlocked and all
     /// operations are non blocking.
     ///
+    /// When the queue is bounded, a lock-free ring is created when the queue
+    /// is enabled and the items added at the back are kept in it: producers
+    /// and working threads exchange items without locking the mutex, which
+    /// is only taken when a thread runs out of work and has to wait. The
+    /// items added at the front and the items added before the ring was
+    /// created are kept in the container and are processed first.
+    ///
     /// @tparam Item a 'smart pointer' to a functor
     /// @tparam QueueContainer a 'queue like' container
     template <typename Item, typename QueueContainer = std::queue<Item>>
@@ -277,8 +297,10 @@ private:
         ///
         /// Creates the thread pool queue in 'disabled' state
         ThreadPoolQueue()
-            : enabled_(false), paused_(false), max_queue_size_(0), working_(0),
-              unavailable_(0), stat10(0.), stat100(0.), stat1000(0.) {
+            : ring_(0), ring_pushers_(0), queue_size_(0), waiting_(0),
+              enabled_(false), paused_(false), max_queue_size_(0),
+              working_(0), unavailable_(0), stat10(0.), stat100(0.),
+              stat1000(0.) {
         }
 
         /// @brief Destructor
@@ -305,6 +327,9 @@ private:
 
         /// @brief set maximum number of work items in the queue
         ///
+        /// The size of the lock-free ring is updated when the queue is
+        /// enabled.
+        ///
         /// @return the maximum size (0 means unlimited)
         void setMaxQueueSize(size_t max_queue_size) {
             std::lock_guard<std::mutex> lock(mutex_);
@@ -335,6 +360,27 @@ private:
             if (!item) {
                 return (ret);
             }
+            // Announce the use of the ring so it is not released while
+            // the item is pushed in it.
+            ++ring_pushers_;
+            MpmcRing<Item>* ring = ring_.load();
+            if (ring) {
+                ret = ring->pushDropOldest(item);
+                --ring_pushers_;
+                // Pairs with the fence in pop: either the waiting thread
+                // sees the item or it is seen waiting here.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiting_ > 0) {
+                    {
+                        // Make sure the waiting thread is blocked on the
+                        // condition variable before notifying it.
+                        std::lock_guard<std::mutex> lock(mutex_);
+                    }
+                    cv_.notify_one();
+                }
+                return (ret);
+            }
+            --ring_pushers_;
             {
                 std::lock_guard<std::mutex> lock(mutex_);
                 if (max_queue_size_ != 0) {
@@ -344,6 +390,7 @@ private:
                     }
                 }
                 queue_.push_back(item);
+                queue_size_ = queue_.size();
             }
             // Notify pop function so that it can effectively remove a work item.
             cv_.notify_one();
@@ -364,10 +411,11 @@ private:
             {
                 std::lock_guard<std::mutex> lock(mutex_);
                 if ((max_queue_size_ != 0) &&
-                    (queue_.size() >= max_queue_size_)) {
+                    (size() >= max_queue_size_)) {
                     return (false);
                 }
                 queue_.push_front(item);
+                queue_size_ = queue_.size();
             }
             // Notify pop function so that it can effectively remove a work item.
             cv_.notify_one();
@@ -386,31 +434,58 @@ private:
         /// the queue is 'resumed'.
         /// Before a work item is returned statistics are updated.
         ///
+        /// A thread which finished a work item takes the next one from the
+        /// lock-free ring without locking when nothing else is pending.
+        ///
         /// @return the first work item from the queue or an empty element.
         Item pop() {
+            if (enabled_ && !paused_ && (queue_size_ == 0)) {
+                MpmcRing<Item>* ring = ring_.load();
+                Item item;
+                if (ring && ring->tryPop(item)) {
+                    updateStats(ring->size() + 1);
+                    return (item);
+                }
+            }
             std::unique_lock<std::mutex> lock(mutex_);
             --working_;
-            // Signal thread waiting for threads to pause.
-            if (paused_ && working_ == 0 && unavailable_ == 0) {
-                wait_threads_cv_.notify_all();
-            }
-            // Signal thread waiting for tasks to finish.
-            if (working_ == 0 && queue_.empty()) {
-                wait_cv_.notify_all();
-            }
-            // Wait for push or disable functions.
-            cv_.wait(lock, [&]() {return (!enabled_ || (!queue_.empty() && !paused_));});
-            ++working_;
-            if (!enabled_) {
-                return (Item());
+            for (;;) {
+                // Signal thread waiting for threads to pause.
+                if (paused_ && working_ == 0 && unavailable_ == 0) {
+                    wait_threads_cv_.notify_all();
+                }
+                // Signal thread waiting for tasks to finish.
+                if (working_ == 0 && empty()) {
+                    wait_cv_.notify_all();
+                }
+                // Wait for push or disable functions.
+                ++waiting_;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (enabled_ && (empty() || paused_)) {
+                    cv_.wait(lock);
+                }
+                --waiting_;
+                ++working_;
+                if (!enabled_) {
+                    return (Item());
+                }
+                size_t length = size();
+                Item item;
+                if (!queue_.empty()) {
+                    item = queue_.front();
+                    queue_.pop_front();
+                    queue_size_ = queue_.size();
+                } else {
+                    MpmcRing<Item>* ring = ring_.load();
+                    if (!ring || !ring->tryPop(item)) {
+                        // Another thread took the item from the ring.
+                        --working_;
+                        continue;
+                    }
+                }
+                updateStats(length);
+                return (item);
             }
-            size_t length = queue_.size();
-            stat10 = stat10 * CEXP10 + (1 - CEXP10) * length;
-            stat100 = stat100 * CEXP100 + (1 - CEXP100) * length;
-            stat1000 = stat1000 * CEXP1000 + (1 - CEXP1000) * length;
-            Item item = queue_.front();
-            queue_.pop_front();
-            return (item);
         }
 
         /// @brief count number of work items in the queue
@@ -420,7 +495,7 @@ private:
         /// @return the number of work items
         size_t count() {
             std::lock_guard<std::mutex> lock(mutex_);
-            return (queue_.size());
+            return (size());
         }
 
         /// @brief wait for current items to be processed
@@ -430,7 +505,7 @@ private:
         void wait() {
             std::unique_lock<std::mutex> lock(mutex_);
             // Wait for any item or for working threads to finish.
-            wait_cv_.wait(lock, [&]() {return (working_ == 0 && queue_.empty());});
+            wait_cv_.wait(lock, [&]() {return (working_ == 0 && empty());});
         }
 
         /// @brief wait for items to be processed or return after timeout
@@ -444,7 +519,7 @@ private:
             std::unique_lock<std::mutex> lock(mutex_);
             // Wait for any item or for working threads to finish.
             bool ret = wait_cv_.wait_for(lock, std::chrono::seconds(seconds),
-                                         [&]() {return (working_ == 0 && queue_.empty());});
+                                         [&]() {return (working_ == 0 && empty());});
             return (ret);
         }
 
@@ -477,7 +552,7 @@ private:
         /// @return the queue length statistic
         /// @throw InvalidParameter if which is not 10 and 100 and 1000.
         double getQueueStat(size_t which) {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<std::mutex> lock(stat_mutex_);
             switch (which) {
             case 10:
                 return (stat10);
@@ -497,6 +572,11 @@ private:
         void clear() {
             std::lock_guard<std::mutex> lock(mutex_);
             queue_ = QueueContainer();
+            queue_size_ = 0;
+            MpmcRing<Item>* ring = ring_.load();
+            if (ring) {
+                ring->clear();
+            }
         }
 
         /// @brief enable the queue
@@ -506,6 +586,7 @@ private:
         /// @param thread_count number of working threads
         void enable(uint32_t thread_count) {
             std::lock_guard<std::mutex> lock(mutex_);
+            setupRing();
             enabled_ = true;
             unavailable_ = thread_count;
         }
@@ -543,10 +624,121 @@ private:
             return (paused_);
         }
 
+        /// @brief get the number of lock-free rings held by the queue
+        ///
+        /// @return the number of rings, including the retired ones which
+        /// were not released yet
+        size_t getRingCount() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return (rings_.size());
+        }
+
     private:
+        /// @brief return the number of work items in the queue
+        ///
+        /// Must be called with the mutex locked.
+        ///
+        /// @return the number of work items
+        size_t size() const {
+            MpmcRing<Item>* ring = ring_.load();
+            return (queue_.size() + (ring ? ring->size() : 0));
+        }
+
+        /// @brief check if the queue is empty
+        ///
+        /// Must be called with the mutex locked.
+        ///
+        /// @return true if there is no work item in the queue
+        bool empty() const {
+            MpmcRing<Item>* ring = ring_.load();
+            return (queue_.empty() && (!ring || ring->empty()));
+        }
+
+        /// @brief create the lock-free ring matching the maximum queue size
+        ///
+        /// Must be called with the mutex locked, when no working thread
+        /// runs. A retired ring of the same size is reused, otherwise a
+        /// new ring is created. The items of the retired rings are moved
+        /// to the container. A retired ring is released when no producer
+        /// is pushing an item, otherwise it is kept until the next call
+        /// as the producer may still hold a pointer to it.
+        void setupRing() {
+            MpmcRing<Item>* ring = ring_.load();
+            if (!ring || (ring->capacity() != max_queue_size_)) {
+                ring = 0;
+                if (max_queue_size_ != 0) {
+                    for (auto const& retired : rings_) {
+                        if (retired->capacity() == max_queue_size_) {
+                            ring = retired.get();
+                            break;
+                        }
+                    }
+                    if (!ring) {
+                        rings_.push_back(boost::make_shared<MpmcRing<Item>>(max_queue_size_));
+                        ring = rings_.back().get();
+                    }
+                }
+                ring_ = ring;
+            }
+            // The producers which did not announce themselves yet will
+            // see the new ring.
+            bool release = (ring_pushers_ == 0);
+            for (auto it = rings_.begin(); it != rings_.end(); ) {
+                if (it->get() == ring) {
+                    ++it;
+                    continue;
+                }
+                Item item;
+                while ((*it)->tryPop(item)) {
+                    queue_.push_back(item);
+                }
+                if (release) {
+                    it = rings_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            queue_size_ = queue_.size();
+        }
+
+        /// @brief update queue length statistics
+        ///
+        /// The update is skipped when another thread is doing it so the
+        /// statistics never block the working threads.
+        ///
+        /// @param length the queue length before the item was removed
+        void updateStats(size_t length) {
+            std::unique_lock<std::mutex> lock(stat_mutex_, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                return;
+            }
+            stat10 = stat10 * CEXP10 + (1 - CEXP10) * length;
+            stat100 = stat100 * CEXP100 + (1 - CEXP100) * length;
+            stat1000 = stat1000 * CEXP1000 + (1 - CEXP1000) * length;
+        }
+
         /// @brief underlying queue container
         QueueContainer queue_;
 
+        /// @brief lock-free ring holding the items added at the back
+        /// (null when the queue is not bounded)
+        std::atomic<MpmcRing<Item>*> ring_;
+
+        /// @brief number of producers pushing an item in the ring
+        std::atomic<uint32_t> ring_pushers_;
+
+        /// @brief the current ring and the retired rings not released yet
+        std::list<boost::shared_ptr<MpmcRing<Item>>> rings_;
+
+        /// @brief number of items in the container, readable without lock
+        std::atomic<size_t> queue_size_;
+
+        /// @brief number of threads waiting for work items
+        std::atomic<uint32_t> waiting_;
+
+        /// @brief mutex used to update the statistics
+        std::mutex stat_mutex_;
+
         /// @brief mutex used for critical sections
         std::mutex mutex_;
 
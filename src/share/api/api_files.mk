@@ -44,6 +44,7 @@ api_files += $(top_srcdir)/src/share/api/ha-scopes.json
 api_files += $(top_srcdir)/src/share/api/ha-sync-complete-notify.json
 api_files += $(top_srcdir)/src/share/api/ha-sync.json
 api_files += $(top_srcdir)/src/share/api/lease4-add.json
+api_files += $(top_srcdir)/src/share/api/lease4-bulk-apply.json
 api_files += $(top_srcdir)/src/share/api/lease4-del.json
 api_files += $(top_srcdir)/src/share/api/lease4-get-all.json
 api_files += $(top_srcdir)/src/share/api/lease4-get-by-client-id.json